@@ -167,6 +167,13 @@ public:
      */
     bool isEnabled() const;
 
+    /**
+     * @brief Checks whether the I2S channel is active, i.e. a sound is playing or has just finished.
+     * The channel stays active for a short idle timeout after the last sound.
+     * @return True while the channel is active.
+     */
+    bool isPlaybackActive() const { return _isChannelCurrentlyActive.load(); }
+
     /**
      * @brief Sets the callback function to be called when audio playback finishes.
      * @param cb The callback function.
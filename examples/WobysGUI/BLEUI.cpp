@@ -77,6 +77,7 @@ BLEUI::BLEUI(LGFX* lcd,
     _btManager(btManager),
     _statusbarPtr(statusbar),
     _settingsManager(settingsManager), // Inicializáljuk a tagváltozót
+    _wifiEventBridge(nullptr),
     _backBtn(lcd, "", 0, 0, 0, 0, &iconic_all2x),
     _btToggle(lcd, "", "", 0, 0, 0, 0, &helvB12, false),
     _scanBtn(lcd, "", 0, 0, 0, 0, &helvB12),
@@ -84,6 +85,7 @@ BLEUI::BLEUI(LGFX* lcd,
     _titleText(lcd, "", 0, 0),
     _statusText(lcd, "", 0, 0),
     _deviceList(lcd, 0, 0, 0, 0, 1),
+    _scanStreamer(btManager),
     _pinKeyboard(lcd, "", KEYBOARD_DEFAULT_KEY_WIDTH_PIXELS, KEYBOARD_DEFAULT_KEY_HEIGHT_PIXELS, 0, 0, KEYBOARD_DEFAULT_TEXT_BOX_HEIGHT_PIXELS),
     _nameKeyboard(lcd, "", KEYBOARD_DEFAULT_KEY_WIDTH_PIXELS, KEYBOARD_DEFAULT_KEY_HEIGHT_PIXELS, 0, 0, KEYBOARD_DEFAULT_TEXT_BOX_HEIGHT_PIXELS),
     _confirmBackground(lcd, "", 0, 0),
@@ -137,6 +139,19 @@ void BLEUI::init() {
     DEBUG_ERROR_PRINTLN("BLE UI: Failed to create layer.");
     return;
   }
+  // The streamed scan is advanced from the layer loop, so it only runs while the panel is shown.
+  layer->setOnLoopCallback([this]() {
+    WifiEventBridge::ScopedLock wifiLock(_wifiEventBridge); // The scan start reaches the WifiManager for coexistence
+    this->_scanStreamer.loop();
+  });
+  _scanStreamer.setOnBatchCallback(
+    [this](const std::vector<BleAdvertUpdate>& batch) {
+      this->_handleScanBatch(batch);
+    });
+  _scanStreamer.setOnScanCompleteCallback(
+    [this](bool success, const std::vector<BleAdvertUpdate>& devices) {
+      this->_handleStreamScanComplete(success, devices);
+    });
   int layerW = TFT_HEIGHT;
   int layerH = TFT_WIDTH - STATUSBAR_HEIGHT;
 
@@ -208,36 +223,40 @@ void BLEUI::init() {
   _deviceList.setDrawBorder(true);
   _deviceList.setDrawDividers(true);
   _deviceList.setDrawScrollBar(true);
-  _deviceList.setNumColumns(4);
+  _deviceList.setNumColumns(5);
 
   const int actionColW = 35; // Column for "X" (delete) or similar actions
   const int statusColW = 35; // Column for connection status icon (chain)
+  const int signalColW = 30; // Column for the signal strength icon
   const int macColW = 130;   // Column for MAC address
   const int BORDER_THICKNESS = 1;
   const int scrollBarWidthToConsider = _deviceList.getDrawScrollBar() ? LISTUI_SCROLL_BAR_WIDTH_PIXELS : 0;
   const int totalBorderWidthContribution = _deviceList.getDrawBorder() ? (2 * BORDER_THICKNESS) : 0;
 
   int availableWidthForColumns = _deviceList.getWidth() - scrollBarWidthToConsider - totalBorderWidthContribution;
-  int nameColW = availableWidthForColumns - macColW - statusColW - actionColW;
+  int nameColW = availableWidthForColumns - macColW - signalColW - statusColW - actionColW;
 
   if (nameColW < 50) nameColW = 50; // Ensure a minimum width for the name column
 
   _deviceList.setColumnWidth(0, nameColW);
   _deviceList.setColumnWidth(1, macColW);
-  _deviceList.setColumnWidth(2, statusColW);
-  _deviceList.setColumnWidth(3, actionColW);
+  _deviceList.setColumnWidth(2, signalColW);
+  _deviceList.setColumnWidth(3, statusColW);
+  _deviceList.setColumnWidth(4, actionColW);
 
   _deviceList.setColumnDefaultAlignment(0, ML_DATUM); // Name (left-aligned)
   _deviceList.setColumnDefaultAlignment(1, MC_DATUM); // MAC address (center-aligned)
-  _deviceList.setColumnDefaultAlignment(2, MC_DATUM); // Status icon (center-aligned)
-  _deviceList.setColumnDefaultAlignment(3, MC_DATUM); // Action (center-aligned)
+  _deviceList.setColumnDefaultAlignment(2, MC_DATUM); // Signal icon (center-aligned)
+  _deviceList.setColumnDefaultAlignment(3, MC_DATUM); // Status icon (center-aligned)
+  _deviceList.setColumnDefaultAlignment(4, MC_DATUM); // Action (center-aligned)
 
   _deviceList.setColumnDefaultFont(0, &helvR14);    // Name font
   _deviceList.setColumnDefaultFont(1, &helvR10);    // MAC address font
-  _deviceList.setColumnDefaultFont(2, &iconic_all2x); // Status icon font
-  _deviceList.setColumnDefaultFont(3, &helvB14);    // Action font
+  _deviceList.setColumnDefaultFont(2, &battery);    // Signal icon font (same glyphs as the Wi-Fi list)
+  _deviceList.setColumnDefaultFont(3, &iconic_all2x); // Status icon font
+  _deviceList.setColumnDefaultFont(4, &helvB14);    // Action font
 
-  _deviceList.setColumnDefaultTextColor(3, LISTUI_ITEM_DELETE_ACTION_COLOR); // Default color for delete action (red)
+  _deviceList.setColumnDefaultTextColor(4, LISTUI_ITEM_DELETE_ACTION_COLOR); // Default color for delete action (red)
 
   _deviceList.setOnItemSelectedCallback(
     [this](int idx, const ListItem& d, int16_t tx) {
@@ -426,6 +445,7 @@ void BLEUI::openPanel() {
  */
 void BLEUI::proceedToOpenPanel() {
   DEBUG_INFO_PRINTLN("BLEUI: proceedToOpenPanel() executed (opening panel now).");
+  WifiEventBridge::ScopedLock wifiLock(_wifiEventBridge); // The scan start reaches the WifiManager for coexistence
 
   bool isCurrentlyEnabled = _btManager->isEnabled();
   setToggleState(isCurrentlyEnabled, false);
@@ -461,10 +481,7 @@ void BLEUI::proceedToOpenPanel() {
 
   if (isCurrentlyEnabled) {
     DEBUG_INFO_PRINTLN("BLEUI: BT enabled, starting scan when panel opens.");
-    // autoConnect parameter set to TRUE.
-    // This ensures that an auto-connect attempt is made after a manual scan as well,
-    // if there are paired devices in the manager's list.
-    if (!_btManager->startScan(DEFAULT_BLE_SCAN_DURATION_SEC, false, true)) { // <-- autoConnect = true
+    if (!_startDeviceScan()) {
       if (_languageManager) {
         _statusText.setText(_languageManager->getString("BLE_STATUS_SCAN_NOT_POSSIBLE", "Scan cannot be started (already running?)."));
       } else {
@@ -479,6 +496,7 @@ void BLEUI::proceedToOpenPanel() {
  * Pops the BLE UI layer from the screen manager stack.
  */
 void BLEUI::closePanel() {
+  _scanStreamer.cancel(); // Release the radio; a new scan starts when the panel is reopened.
   _screenManager->popLayer();
 }
 
@@ -497,6 +515,7 @@ void BLEUI::onToggleChanged(bool newState) {
     DEBUG_ERROR_PRINTLN("BLEUI: SettingsManager or BLEManager is null. Cannot change Bluetooth state.");
     return;
   }
+  WifiEventBridge::ScopedLock wifiLock(_wifiEventBridge);
 
   // Save state via SettingsManager (UI is responsible for saving)
   _settingsManager->setBluetoothEnabledLastState(newState);
@@ -579,7 +598,8 @@ void BLEUI::onDeviceSelected(
   int index,
   const ListItem& data,
   int16_t touchX) {
-  if (data.columns.size() < 4) return;
+  if (data.columns.size() < 5) return;
+  WifiEventBridge::ScopedLock wifiLock(_wifiEventBridge);
 
   int clickedColumnIndex = _deviceList.getClickedColumnIndex(touchX);
   const std::string& deviceName = data.columns[0].text;
@@ -587,7 +607,7 @@ void BLEUI::onDeviceSelected(
 
   // --- Deletion ("X") logic ---
   // Only removable if the column contains "X", meaning it's paired.
-  if (clickedColumnIndex == 3 && data.isPaired) {
+  if (clickedColumnIndex == 4 && data.isPaired) {
     DEBUG_INFO_PRINTF("BLEUI: Delete button clicked for: %s\n", deviceName.c_str());
     showConfirmDialog(devicePrimaryConnectId, deviceName);
     return;
@@ -605,8 +625,8 @@ void BLEUI::onDeviceSelected(
   }
 
   // --- Online device interactions ---
-  // Column 2 (index 2): Connection management ("chain" icon) OR any other column (0 or 1) click
-  if (clickedColumnIndex == 2 || clickedColumnIndex == 0 || clickedColumnIndex == 1) {
+  // Column 3 (index 3): Connection management ("chain" icon) OR any other column (0, 1 or 2) click
+  if (clickedColumnIndex >= 0 && clickedColumnIndex <= 3) {
     DEBUG_INFO_PRINTF("BLEUI: Connect/Disconnect action for: %s (Address: %s, Primary ID: %s)\n", deviceName.c_str(), data.address.c_str(), devicePrimaryConnectId.c_str());
 
     bool isConnectedToThisDevice = (_btManager->getCurrentState() == BLEMgr_State_t::BLE_CONNECTED && _btManager->getConnectedAddress() == data.address);
@@ -641,8 +661,8 @@ void BLEUI::onDeviceSelected(
  */
 void BLEUI::handleScanComplete(
   bool success,
-  const std::vector<ManagedBLEDevice>& scannedDevices) {
-  DEBUG_INFO_PRINTF("BLE UI: handleScanComplete START. Success: %d, Devices: %d\n", success, (int)scannedDevices.size());
+  const std::vector<ManagedBLEDevice>& managerDevices) {
+  DEBUG_INFO_PRINTF("BLE UI: handleScanComplete START. Success: %d, Devices: %d\n", success, (int)managerDevices.size());
 
   if (!success) {
     if (_languageManager != nullptr) {
@@ -653,6 +673,17 @@ void BLEUI::handleScanComplete(
     return;
   }
 
+  // Devices found by a streamed scan are not known to the manager; show them as well.
+  _showDeviceList(_mergeStreamedDevices(managerDevices));
+
+  DEBUG_INFO_PRINTLN("BLE UI: handleScanComplete END.");
+}
+
+/**
+ * @brief Replaces the list rows with the given devices and selects the connected one.
+ * @param scannedDevices The devices to show (already merged with the streamed scan).
+ */
+void BLEUI::_showDeviceList(const std::vector<ManagedBLEDevice>& scannedDevices) {
   // Get the current connected device's address directly from BLEManager.
   // This ensures we use the most up-to-date connection information for list rendering.
   std::string currentConnectedAddress = _btManager->getConnectedAddress();
@@ -663,60 +694,11 @@ void BLEUI::handleScanComplete(
   int connectedDeviceIndex = -1; // To store the index of the connected device in the new list.
 
   for (const auto& dev : scannedDevices) {
-    ListItem item;
-    // Store primaryConnectId and address in ListItem for later actions.
-    item.primaryConnectId = dev.primaryConnectId;
-    item.address = dev.address;
-    item.isPaired = dev.isPaired;
-    item.isOnline = dev.isOnline;
-
-    // Populate columns:
-    // Column 0: Name
-    // Column 1: MAC Address
-    if (_languageManager != nullptr) {
-      item.columns.push_back(ColumnData(dev.name.empty() ? _languageManager->getString("BLE_DEVICE_NO_NAME", "<no name>") : dev.name));
-      item.columns.push_back(ColumnData(dev.address));
-    } else {
-      item.columns.push_back(ColumnData(dev.name.empty() ? "<no name>" : dev.name));
-      item.columns.push_back(ColumnData(dev.address));
-    }
-
-    // Column 2: Connection Icon
     // Set the "connected" icon if this device is *the* currently connected one
     // AND the BLEManager's state is actually CONNECTED.
     bool isActuallyConnectedToThisDevice = (bleMgrState == BLEMgr_State_t::BLE_CONNECTED &&
                                            (dev.address == currentConnectedAddress || dev.primaryConnectId == currentConnectedServiceUUID));
-
-    if (isActuallyConnectedToThisDevice) {
-      item.columns.push_back(ColumnData((_languageManager != nullptr) ? _languageManager->getString("ICON_BLE_CONNECTED", "\u00C6") : "\u00C6"));
-    } else {
-      item.columns.push_back(ColumnData((_languageManager != nullptr) ? _languageManager->getString("ICON_BLE_DISCONNECTED", "\u00C5") : "L"));
-    }
-
-    // Column 3: Delete "X" button
-    // Display "X" if the device is paired.
-    item.columns.push_back(ColumnData(dev.isPaired ? ((_languageManager != nullptr) ? _languageManager->getString("TEXT_DELETE_ACTION", "X") : "X") : ""));
-
-    // --- Coloring ---
-    // Apply grey color if the device is offline; otherwise, use normal color.
-    if (dev.isOnline) {
-      item.columns[0].textColor = 0; // Normal color (or ColumnData default)
-      item.columns[1].textColor = 0;
-      item.columns[2].textColor = 0; // Icon also normal color
-    } else {
-      item.columns[0].textColor = UI_COLOR_BACKGROUND_MEDIUM; // Grey
-      item.columns[1].textColor = UI_COLOR_BACKGROUND_MEDIUM;
-      item.columns[2].textColor = UI_COLOR_BACKGROUND_MEDIUM; // Icon also grey
-    }
-
-    // Set delete "X" color to red if it exists and the device is paired.
-    if (dev.isPaired) {
-      item.columns[3].textColor = LISTUI_ITEM_DELETE_ACTION_COLOR;
-    } else {
-      item.columns[3].textColor = 0; // Use default color (often transparent/background-matching)
-    }
-
-    uiListItems.push_back(item);
+    uiListItems.push_back(_buildDeviceListItem(dev, isActuallyConnectedToThisDevice));
 
     // If this is the connected device, store its index
     if (isActuallyConnectedToThisDevice) {
@@ -733,8 +715,6 @@ void BLEUI::handleScanComplete(
     // Clear selection if no device is currently connected or found in the list.
     _deviceList.setSelectedItemIndex(-1, true); 
   }
-  
-  DEBUG_INFO_PRINTLN("BLE UI: handleScanComplete END.");
 }
 
 /**
@@ -789,6 +769,9 @@ void BLEUI::handleStateChange(BLEMgr_State_t newState,
 
       case BLEMgr_State_t::BLE_SCANNING:
         statusMsg = _languageManager->getString("BLE_STATUS_SCANNING", "Scanning in progress...");
+        // A manager scan refreshes the online flags itself; drop the streamed results.
+        _scanStreamer.cancel();
+        _scanStreamer.clearResults();
         break;
 
       case BLEMgr_State_t::BLE_CONNECTING:
@@ -861,6 +844,7 @@ void BLEUI::handlePairedDeviceChanged(const PairedDevice& device, bool added) {
     // The UI is responsible for saving the paired device.
     _settingsManager->addOrUpdatePairedDevice(device.name, device.address, device.serviceUUID);
     DEBUG_INFO_PRINTF("BLEUI: Paired device '%s' saved/updated in SettingsManager.\n", device.name.c_str());
+    if (_scanStreamer.isScanning()) _takeKnownDeviceSnapshot(); // Paired state changed mid-scan.
     handleScanComplete(true, _btManager->getDisplayDevices()); // Refresh the UI list.
 }
 
@@ -888,6 +872,7 @@ void BLEUI::onConfirmYes() {
     DEBUG_ERROR_PRINTLN("BLEUI: SettingsManager, BLEManager or LanguageManager is null. Cannot confirm deletion.");
     return;
   }
+  WifiEventBridge::ScopedLock wifiLock(_wifiEventBridge);
 
   std::string primaryIdToForget = _primaryConnectIdForAction;
   std::string nameToForget = _nameForAction;
@@ -924,6 +909,7 @@ void BLEUI::onConfirmYes() {
         _forgetActionState = ForgetActionState::FORGET_OFFLINE;
         _statusText.setText(_languageManager->getString("BLE_STATUS_DEVICE_DELETED", "Device deleted") + ": " + nameToForget);
         _btManager->removePairedDevice(primaryIdToForget); // Update internal BLEManager list.
+        if (_scanStreamer.isScanning()) _takeKnownDeviceSnapshot(); // Paired state changed mid-scan.
         handleScanComplete(true, _btManager->getDisplayDevices()); // Refresh display.
       }
   } else {
@@ -954,10 +940,10 @@ void BLEUI::onConfirmNo() {
  */
 void BLEUI::onScanPressed() {
   DEBUG_INFO_PRINTLN("BLE UI: onScanPressed");
+  WifiEventBridge::ScopedLock wifiLock(_wifiEventBridge);
   if (_btManager->isEnabled()) {
     _lastScanDurationRequested = DEFAULT_BLE_SCAN_DURATION_SEC;
-    // autoConnect=true is set here to allow auto-connection after a manual scan.
-    if (!_btManager->startScan(_lastScanDurationRequested, false, true)) { // autoConnect=true
+    if (!_startDeviceScan()) {
       if (_languageManager) {
         _statusText.setText(_languageManager->getString("BLE_STATUS_SCAN_NOT_POSSIBLE", "Scan cannot be started."));
       } else {
@@ -971,4 +957,261 @@ void BLEUI::onScanPressed() {
       _statusText.setText("Bluetooth disabled.");
     }
   }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Starts a device scan, preferring the streamed scanner and falling back
+ * to a regular `BLEManager` scan if the radio is busy.
+ * @return True if either scan could be started.
+ */
+bool BLEUI::_startDeviceScan() {
+  if (!_btManager) {
+    DEBUG_ERROR_PRINTLN("BLEUI: BLEManager is null. Cannot start device scan.");
+    return false;
+  }
+
+  if (_scanStreamer.start(DEFAULT_BLE_SCAN_DURATION_SEC)) {
+    _takeKnownDeviceSnapshot();
+    if (_languageManager) {
+      _statusText.setText(_languageManager->getString("BLE_STATUS_SCANNING", "Scanning in progress..."));
+    } else {
+      _statusText.setText("Scanning...");
+    }
+    return true;
+  }
+  // Streamer unavailable (manager busy or demo limit); let the manager run its regular scan.
+  // autoConnect=true so that paired devices found by the scan are reconnected.
+  return _btManager->startScan(DEFAULT_BLE_SCAN_DURATION_SEC, false, true);
+}
+
+/**
+ * @brief Applies a batch of discovered, updated or lost devices from the streamed scan
+ * to the list, one row at a time. Lost devices are greyed out; devices evicted from the
+ * registry are removed, unless they are connected.
+ * @param batch The devices reported since the previous batch.
+ */
+void BLEUI::_handleScanBatch(const std::vector<BleAdvertUpdate>& batch) {
+  if (!_btManager) return;
+
+  const bool isConnected = _btManager->getCurrentState() == BLEMgr_State_t::BLE_CONNECTED;
+  const uint64_t connectedKey = isConnected ? _addressKey(_btManager->getConnectedAddress()) : 0;
+
+  // Index the current rows once per batch instead of searching them for every update.
+  std::unordered_map<uint64_t, int> rowByAddress;
+  const auto& items = _deviceList.getItems();
+  rowByAddress.reserve(items.size() + batch.size());
+  for (int i = 0; i < static_cast<int>(items.size()); ++i) {
+    rowByAddress.emplace(_addressKey(items[i].address), i);
+  }
+
+  for (const auto& update : batch) {
+    const uint64_t key = _addressKey(update.address);
+    if (update.event == BleDeviceEvent::REMOVED) {
+      auto row = rowByAddress.find(key);
+      if (row == rowByAddress.end() || (isConnected && key == connectedKey)) continue;
+      const int removed = row->second;
+      _deviceList.removeItem(removed);
+      rowByAddress.erase(row);
+      for (auto& entry : rowByAddress) {
+        if (entry.second > removed) entry.second--;
+      }
+      continue;
+    }
+    ManagedBLEDevice dev(update.address, update.name, update.address, update.serviceUUID,
+                         update.rssi, update.event != BleDeviceEvent::LOST, false, update.addressType);
+    auto known = _scanKnownIndex.find(key);
+    if (known != _scanKnownIndex.end()) {
+      const ManagedBLEDevice& info = _scanKnownDevices[known->second];
+      dev.primaryConnectId = info.primaryConnectId;
+      dev.isPaired = info.isPaired;
+      if (!info.name.empty()) dev.name = info.name;
+      if (!info.serviceUUID.empty()) dev.serviceUUID = info.serviceUUID;
+    }
+    // A connected peripheral usually stops advertising; it is not lost.
+    bool isConnectedDevice = isConnected && key == connectedKey;
+    if (isConnectedDevice) dev.isOnline = true;
+
+    auto row = rowByAddress.find(key);
+    int rowIndex = row != rowByAddress.end() ? row->second : -1;
+    if (rowIndex >= 0) {
+      _deviceList.updateItem(rowIndex, _buildDeviceListItem(dev, isConnectedDevice));
+    } else if (update.event != BleDeviceEvent::LOST) {
+      _deviceList.addItem(_buildDeviceListItem(dev, isConnectedDevice));
+      rowIndex = static_cast<int>(_deviceList.getItems().size()) - 1;
+      rowByAddress.emplace(key, rowIndex);
+    }
+    if (isConnectedDevice && rowIndex >= 0) {
+      _deviceList.setSelectedItemIndex(rowIndex, true);
+    }
+  }
+
+  const size_t found = _scanStreamer.getRegistry().size();
+  if (_languageManager) {
+    _statusText.setText(_languageManager->getString("BLE_STATUS_SCANNING", "Scanning in progress...") + " " +
+                        std::to_string(found) + " " +
+                        _languageManager->getString("BLE_STATUS_DEVICES_FOUND", "devices found"));
+  } else {
+    _statusText.setText("Scanning... " + std::to_string(found) + " devices found");
+  }
+  DEBUG_TRACE_PRINTF("BLEUI: Scan batch applied (%u changes, %u rows).\n",
+                     (unsigned)batch.size(), (unsigned)_deviceList.getItems().size());
+}
+
+/**
+ * @brief Handles the end of a streamed scan and replicates the manager's auto-connect.
+ * The list and the auto-connect both use the device snapshot taken when the scan started.
+ * @param success True if the scan ran.
+ * @param devices All devices seen during the scan, strongest first.
+ */
+void BLEUI::_handleStreamScanComplete(bool success, const std::vector<BleAdvertUpdate>& devices) {
+  DEBUG_INFO_PRINTF("BLEUI: Streamed scan complete. Success: %d, Devices: %d\n", success, (int)devices.size());
+  if (!success) {
+    handleScanComplete(false, _scanKnownDevices);
+    return;
+  }
+  BLEMgr_State_t state = _btManager->getCurrentState();
+  if (_languageManager) {
+    if (state == BLEMgr_State_t::BLE_CONNECTED) {
+      _statusText.setText(_languageManager->getString("BLE_STATUS_CONNECTED", "Connected") + ": " + _btManager->getConnectedName());
+    } else {
+      _statusText.setText(_languageManager->getString("GENERAL_ON", "ON") + ", " + _languageManager->getString("BLE_STATUS_DISCONNECTED", "not connected") + ".");
+    }
+  }
+
+  const std::vector<ManagedBLEDevice> merged = _mergeStreamedDevices(_scanKnownDevices);
+  _showDeviceList(merged);
+
+  // Same behaviour as a manager scan with autoConnect: reconnect the strongest paired device in range.
+  if (state != BLEMgr_State_t::BLE_DISCONNECTED || !_btManager->isAutoReconnectEnabled()) return;
+  const ManagedBLEDevice* best = nullptr;
+  for (const auto& dev : merged) {
+    if (dev.isPaired && dev.isOnline && (!best || dev.rssi > best->rssi)) best = &dev;
+  }
+  if (best) {
+    DEBUG_INFO_PRINTF("BLEUI: Auto-connecting to paired device '%s' after streamed scan.\n", best->name.c_str());
+    _btManager->connectToDevice(best->primaryConnectId);
+  }
+}
+
+/**
+ * @brief Merges the streamed devices into the manager's device list.
+ * Known devices are marked online with the streamed RSSI; unknown ones are appended.
+ * @param devices The manager's device list.
+ * @return The merged list.
+ */
+std::vector<ManagedBLEDevice> BLEUI::_mergeStreamedDevices(const std::vector<ManagedBLEDevice>& devices) const {
+  std::vector<ManagedBLEDevice> merged = devices;
+  const BleDeviceRegistry& registry = _scanStreamer.getRegistry();
+  if (registry.size() == 0) return merged;
+
+  std::unordered_map<uint64_t, size_t> indexByAddress;
+  indexByAddress.reserve(merged.size() + registry.size());
+  for (size_t i = 0; i < merged.size(); ++i) {
+    indexByAddress.emplace(_addressKey(merged[i].address), i);
+  }
+  merged.reserve(merged.size() + registry.size());
+
+  // Snapshot reads: the scan callback keeps running while the list is built.
+  registry.forEach([&merged, &indexByAddress](const BleDeviceSnapshot& snap) {
+    auto known = indexByAddress.find(_addressKey(snap.address));
+    if (known != indexByAddress.end()) {
+      ManagedBLEDevice& dev = merged[known->second];
+      if (!snap.isLost) {
+        dev.isOnline = true;
+        dev.rssi = snap.rssi;
+      }
+      if (dev.name.empty()) dev.name = snap.name;
+      return;
+    }
+    char address[18];
+    BleDeviceRegistry::formatAddress(snap.address, address);
+    merged.emplace_back(address, snap.name, address, snap.serviceUUID,
+                        snap.rssi, !snap.isLost, false, snap.addressType);
+  });
+  return merged;
+}
+
+/**
+ * @brief Takes the manager's device list once for the streamed scan and indexes it by address.
+ * Taken again when the paired devices change.
+ */
+void BLEUI::_takeKnownDeviceSnapshot() {
+  _scanKnownDevices = _btManager->getDisplayDevices();
+  _scanKnownIndex.clear();
+  _scanKnownIndex.reserve(_scanKnownDevices.size());
+  for (size_t i = 0; i < _scanKnownDevices.size(); ++i) {
+    _scanKnownIndex.emplace(_addressKey(_scanKnownDevices[i].address), i);
+  }
+}
+
+/**
+ * @brief Packs a "aa:bb:cc:dd:ee:ff" address into an integer key (case-insensitive).
+ * @param address The address text.
+ * @return The key, or 0 if the text is not an address.
+ */
+uint64_t BLEUI::_addressKey(const std::string& address) {
+  uint8_t bytes[6];
+  if (!BleDeviceRegistry::parseAddress(address.c_str(), bytes)) return 0;
+  return _addressKey(bytes);
+}
+
+/**
+ * @brief Packs a 6-byte address into an integer key.
+ * @param address Device address, most significant byte first.
+ * @return The key.
+ */
+uint64_t BLEUI::_addressKey(const uint8_t address[6]) {
+  uint64_t key = 0;
+  for (int i = 0; i < 6; ++i) key = (key << 8) | address[i];
+  return key;
+}
+
+/**
+ * @brief Builds the list row for a device.
+ * @param dev The device.
+ * @param isConnected True if this is the currently connected device.
+ * @return The populated ListItem.
+ */
+ListItem BLEUI::_buildDeviceListItem(const ManagedBLEDevice& dev, bool isConnected) {
+  ListItem item;
+  // Store primaryConnectId and address in ListItem for later actions.
+  item.primaryConnectId = dev.primaryConnectId;
+  item.address = dev.address;
+  item.isPaired = dev.isPaired;
+  item.isOnline = dev.isOnline;
+
+  // Populate columns:
+  // Column 0: Name
+  // Column 1: MAC Address
+  if (_languageManager != nullptr) {
+    item.columns.push_back(ColumnData(dev.name.empty() ? _languageManager->getString("BLE_DEVICE_NO_NAME", "<no name>") : dev.name));
+  } else {
+    item.columns.push_back(ColumnData(dev.name.empty() ? "<no name>" : dev.name));
+  }
+  item.columns.push_back(ColumnData(dev.address));
+
+  // Column 2: Signal strength (only meaningful while the device is in range)
+  item.columns.push_back(ColumnData(dev.isOnline && dev.rssi != 0 ? std::string(1, mapRssiToSignalIcon(dev.rssi)) : ""));
+
+  // Column 3: Connection Icon
+  if (isConnected) {
+    item.columns.push_back(ColumnData((_languageManager != nullptr) ? _languageManager->getString("ICON_BLE_CONNECTED", "\u00C6") : "\u00C6"));
+  } else {
+    item.columns.push_back(ColumnData((_languageManager != nullptr) ? _languageManager->getString("ICON_BLE_DISCONNECTED", "\u00C5") : "L"));
+  }
+
+  // Column 4: Delete "X" button
+  // Display "X" if the device is paired.
+  item.columns.push_back(ColumnData(dev.isPaired ? ((_languageManager != nullptr) ? _languageManager->getString("TEXT_DELETE_ACTION", "X") : "X") : ""));
+
+  // --- Coloring ---
+  // Apply grey color if the device is offline; otherwise, use normal color.
+  uint32_t contentColor = dev.isOnline ? 0 : UI_COLOR_BACKGROUND_MEDIUM;
+  for (int col = 0; col <= 3; ++col) {
+    item.columns[col].textColor = contentColor;
+  }
+
+  // Set delete "X" color to red if it exists and the device is paired.
+  item.columns[4].textColor = dev.isPaired ? LISTUI_ITEM_DELETE_ACTION_COLOR : 0;
+  return item;
+}
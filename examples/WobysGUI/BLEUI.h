@@ -41,6 +41,7 @@
 #include <LovyanGFX.hpp>
 #include <vector>
 #include <string>
+#include <unordered_map>
 #include <functional>
 #include "ScreenManager.h"
 #include "BLEManager.h"
@@ -53,6 +54,8 @@
 #include "KeyboardUI.h"
 #include "ListItem.h"
 #include "SettingsManager.h"
+#include "BleScanStreamer.h"
+#include "WifiEventBridge.h"
 
 /**
  * @brief User Interface (UI) panel for managing Bluetooth Low Energy (BLE) settings and devices.
@@ -156,6 +159,19 @@ public:
    */
   void handlePairedDeviceChanged(const PairedDevice& device, bool added);
 
+  /**
+   * @brief Routes the panel's device scans through the radio scheduler.
+   * @param scheduler Pointer to the RadioScheduler, or nullptr to scan immediately.
+   */
+  void setRadioScheduler(RadioScheduler* scheduler) { _scanStreamer.setRadioScheduler(scheduler); }
+
+  /**
+   * @brief Sets the bridge whose lock serializes WifiManager access. BLEManager reaches the
+   * WifiManager for radio coexistence, so the touch handlers that drive it hold the lock.
+   * @param bridge Pointer to the WifiEventBridge instance (nullptr = the manager runs on the UI task).
+   */
+  void setWifiEventBridge(WifiEventBridge* bridge) { _wifiEventBridge = bridge; }
+
 private:
   // --- Member Variables ---
   // Dependencies
@@ -165,6 +181,7 @@ private:
   BLEManager*       _btManager;             ///< Pointer to the BLEManager for Bluetooth logic.
   StatusbarUI*      _statusbarPtr;          ///< Pointer to the StatusbarUI for displaying status.
   SettingsManager*  _settingsManager;       ///< Pointer to the SettingsManager for persistent settings.
+  WifiEventBridge*  _wifiEventBridge;       ///< Optional bridge whose lock covers BLEManager's WifiManager use.
 
   /**
    * @brief Enumerates the state of a "forget device" action.
@@ -183,6 +200,9 @@ private:
   TextUI            _titleText;             ///< Title text for the BLE settings panel.
   TextUI            _statusText;            ///< Text display for current BLE status messages.
   ClickableListUI   _deviceList;            ///< List UI to display found and paired BLE devices.
+  BleScanStreamer   _scanStreamer;          ///< De-duplicating scanner that feeds the list while the panel is open.
+  std::vector<ManagedBLEDevice> _scanKnownDevices;        ///< Manager's device list (paired state, names), taken once per streamed scan.
+  std::unordered_map<uint64_t, size_t> _scanKnownIndex;   ///< Packed address -> index in `_scanKnownDevices`.
 
   KeyboardUI        _pinKeyboard;           ///< Keyboard UI for PIN input (if needed).
   KeyboardUI        _nameKeyboard;          ///< Keyboard UI for device name input.
@@ -269,6 +289,69 @@ private:
    */
   void showConfirmDialog(const std::string& primaryConnectId, const std::string& name);
 
+  /**
+   * @brief Starts a device scan, preferring the streamed scanner and falling back
+   * to a regular `BLEManager` scan if the radio is busy.
+   * @return True if either scan could be started.
+   */
+  bool _startDeviceScan();
+
+  /**
+   * @brief Applies a batch of discovered, updated or lost devices from the streamed scan
+   * to the list, one row at a time.
+   * @param batch The devices reported since the previous batch.
+   */
+  void _handleScanBatch(const std::vector<BleAdvertUpdate>& batch);
+
+  /**
+   * @brief Handles the end of a streamed scan and replicates the manager's auto-connect.
+   * @param success True if the scan ran.
+   * @param devices All devices seen during the scan, strongest first.
+   */
+  void _handleStreamScanComplete(bool success, const std::vector<BleAdvertUpdate>& devices);
+
+  /**
+   * @brief Builds the list row for a device.
+   * @param dev The device.
+   * @param isConnected True if this is the currently connected device.
+   * @return The populated ListItem.
+   */
+  ListItem _buildDeviceListItem(const ManagedBLEDevice& dev, bool isConnected);
+
+  /**
+   * @brief Takes the manager's device list once for the streamed scan and indexes it by address.
+   * Taken again when the paired devices change.
+   */
+  void _takeKnownDeviceSnapshot();
+
+  /**
+   * @brief Packs a "aa:bb:cc:dd:ee:ff" address into an integer key (case-insensitive).
+   * @param address The address text.
+   * @return The key, or 0 if the text is not an address.
+   */
+  static uint64_t _addressKey(const std::string& address);
+
+  /**
+   * @brief Packs a 6-byte address into an integer key.
+   * @param address Device address, most significant byte first.
+   * @return The key.
+   */
+  static uint64_t _addressKey(const uint8_t address[6]);
+
+  /**
+   * @brief Replaces the list rows with the given devices and selects the connected one.
+   * @param devices The devices to show (already merged with the streamed scan).
+   */
+  void _showDeviceList(const std::vector<ManagedBLEDevice>& devices);
+
+  /**
+   * @brief Merges the streamed devices into the manager's device list.
+   * Known devices are marked online with the streamed RSSI; unknown ones are appended.
+   * @param devices The manager's device list.
+   * @return The merged list.
+   */
+  std::vector<ManagedBLEDevice> _mergeStreamedDevices(const std::vector<ManagedBLEDevice>& devices) const;
+
   /**
    * @brief Retranslates all text elements of the UI based on the current language setting.
    * This method is typically called after language changes or during initialization.
@@ -0,0 +1,232 @@
+/**
+ * @file BatteryAdcSampler.cpp
+ * @brief Implements the BatteryAdcSampler class.
+ *
+ * @version 1.0.0
+ * @date 2025-09-05
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "BatteryAdcSampler.h"
+#include <esp_adc/adc_cali_scheme.h>
+#include <algorithm>
+
+namespace {
+constexpr adc_atten_t BATTERY_ADC_ATTEN = ADC_ATTEN_DB_12; // Full range (~0-3.1 V) for the divided battery voltage.
+
+// Channel and code of one DMA result; the layout depends on the chip.
+inline uint32_t resultChannel(const adc_digi_output_data_t* result) {
+#if SOC_ADC_DIGI_RESULT_BYTES == 4
+  return result->type2.channel;
+#else
+  return result->type1.channel;
+#endif
+}
+
+inline uint32_t resultCode(const adc_digi_output_data_t* result) {
+#if SOC_ADC_DIGI_RESULT_BYTES == 4
+  return result->type2.data;
+#else
+  return result->type1.data;
+#endif
+}
+} // namespace
+
+/**
+ * @brief Constructor for BatteryAdcSampler.
+ */
+BatteryAdcSampler::BatteryAdcSampler()
+  : _handle(nullptr),
+    _cali(nullptr),
+    _channel(ADC_CHANNEL_0),
+    _filterQ8(0),
+    _filteredMilliVolts(0),
+    _batchCount(0) {}
+
+/**
+ * @brief Destructor. Stops the ADC and releases the driver.
+ */
+BatteryAdcSampler::~BatteryAdcSampler() {
+  end();
+}
+
+/**
+ * @brief Configures the continuous ADC on a pin and starts converting.
+ * @param gpio The ADC1-capable GPIO connected to the voltage divider.
+ * @return True if the ADC is running, false otherwise.
+ */
+bool BatteryAdcSampler::begin(int gpio) {
+  if (_handle) return true;
+
+  adc_unit_t unit;
+  adc_channel_t channel;
+  if (adc_continuous_io_to_channel(gpio, &unit, &channel) != ESP_OK || unit != ADC_UNIT_1) {
+    // ADC2 is shared with Wi-Fi and cannot run continuously next to it.
+    DEBUG_WARN_PRINTF("BatteryAdcSampler: GPIO %d is not an ADC1 pin, continuous sampling not available.\n", gpio);
+    return false;
+  }
+  _channel = channel;
+
+  adc_continuous_handle_cfg_t handleConfig = {};
+  handleConfig.max_store_buf_size = BATTERY_ADC_POOL_BYTES;
+  handleConfig.conv_frame_size = BATTERY_ADC_FRAME_BYTES;
+  if (adc_continuous_new_handle(&handleConfig, &_handle) != ESP_OK) {
+    DEBUG_ERROR_PRINTLN("BatteryAdcSampler: Failed to create the continuous ADC driver.");
+    _handle = nullptr;
+    return false;
+  }
+
+  adc_digi_pattern_config_t pattern = {};
+  pattern.atten = BATTERY_ADC_ATTEN;
+  pattern.channel = channel;
+  pattern.unit = unit;
+  pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+  adc_continuous_config_t adcConfig = {};
+  adcConfig.pattern_num = 1;
+  adcConfig.adc_pattern = &pattern;
+  adcConfig.sample_freq_hz = BATTERY_ADC_SAMPLE_FREQ_HZ;
+  adcConfig.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+#if SOC_ADC_DIGI_RESULT_BYTES == 4
+  adcConfig.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+#else
+  adcConfig.format = ADC_DIGI_OUTPUT_FORMAT_TYPE1;
+#endif
+
+  if (adc_continuous_config(_handle, &adcConfig) != ESP_OK) {
+    DEBUG_ERROR_PRINTLN("BatteryAdcSampler: Failed to configure the continuous ADC.");
+    end();
+    return false;
+  }
+
+  _createCalibration(unit, BATTERY_ADC_ATTEN);
+  _batchCount.store(0, std::memory_order_relaxed);
+
+  if (adc_continuous_start(_handle) != ESP_OK) {
+    DEBUG_ERROR_PRINTLN("BatteryAdcSampler: Failed to start the continuous ADC.");
+    end();
+    return false;
+  }
+
+  DEBUG_INFO_PRINTF("BatteryAdcSampler: Sampling GPIO %d (ADC1 channel %d) at %u Hz, calibration: %s.\n",
+                    gpio, (int)channel, (unsigned)BATTERY_ADC_SAMPLE_FREQ_HZ, _cali ? "yes" : "no");
+  return true;
+}
+
+/**
+ * @brief Stops the ADC and releases the driver and the calibration.
+ */
+void BatteryAdcSampler::end() {
+  if (_handle) {
+    adc_continuous_stop(_handle); // Fails harmlessly if it was never started.
+    adc_continuous_deinit(_handle);
+    _handle = nullptr;
+  }
+  if (_cali) {
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+    adc_cali_delete_scheme_curve_fitting(_cali);
+#elif ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
+    adc_cali_delete_scheme_line_fitting(_cali);
+#endif
+    _cali = nullptr;
+  }
+}
+
+/**
+ * @brief Drains the DMA buffer and updates the filtered value.
+ *
+ * The median of the latest BATTERY_ADC_MEDIAN_WINDOW codes of the batch rejects spikes (e.g. from
+ * radio bursts on the supply), and the IIR filter y += (x - y) / 2^BATTERY_ADC_IIR_SHIFT smooths the
+ * batch medians. Only integer arithmetic is used.
+ * @return Milliseconds until the next call.
+ */
+uint32_t BatteryAdcSampler::process() {
+  if (!_handle) return BATTERY_ADC_PROCESS_INTERVAL_MS;
+
+  size_t count = 0; // Codes seen in this batch; the window keeps the latest ones.
+  uint32_t length = 0;
+  while (adc_continuous_read(_handle, _readBuffer, sizeof(_readBuffer), &length, 0) == ESP_OK) {
+    for (uint32_t offset = 0; offset + SOC_ADC_DIGI_RESULT_BYTES <= length; offset += SOC_ADC_DIGI_RESULT_BYTES) {
+      const adc_digi_output_data_t* result = reinterpret_cast<const adc_digi_output_data_t*>(&_readBuffer[offset]);
+      if (resultChannel(result) != (uint32_t)_channel) continue;
+      _window[count % BATTERY_ADC_MEDIAN_WINDOW] = resultCode(result);
+      count++;
+    }
+  }
+  if (count == 0) return BATTERY_ADC_PROCESS_INTERVAL_MS;
+
+  const size_t n = std::min<size_t>(count, BATTERY_ADC_MEDIAN_WINDOW);
+  std::nth_element(_window, _window + n / 2, _window + n);
+  const int32_t milliVolts = _rawToMilliVolts(_window[n / 2]);
+
+  if (_batchCount.load(std::memory_order_relaxed) == 0) {
+    _filterQ8 = milliVolts << 8; // Start at the first median instead of ramping up from 0.
+  } else {
+    _filterQ8 += ((milliVolts << 8) - _filterQ8) >> BATTERY_ADC_IIR_SHIFT;
+  }
+  _filteredMilliVolts.store((uint32_t)((_filterQ8 + 128) >> 8), std::memory_order_relaxed);
+  _batchCount.fetch_add(1, std::memory_order_release);
+
+  return BATTERY_ADC_PROCESS_INTERVAL_MS;
+}
+
+/**
+ * @brief Creates the calibration scheme supported by the chip (curve fitting on the ESP32-S3).
+ * @param unit The ADC unit.
+ * @param atten The attenuation used for the channel.
+ */
+void BatteryAdcSampler::_createCalibration(adc_unit_t unit, adc_atten_t atten) {
+  esp_err_t err = ESP_ERR_NOT_SUPPORTED;
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+  adc_cali_curve_fitting_config_t caliConfig = {};
+  caliConfig.unit_id = unit;
+  caliConfig.chan = _channel;
+  caliConfig.atten = atten;
+  caliConfig.bitwidth = ADC_BITWIDTH_DEFAULT;
+  err = adc_cali_create_scheme_curve_fitting(&caliConfig, &_cali);
+#elif ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
+  adc_cali_line_fitting_config_t caliConfig = {};
+  caliConfig.unit_id = unit;
+  caliConfig.atten = atten;
+  caliConfig.bitwidth = ADC_BITWIDTH_DEFAULT;
+  err = adc_cali_create_scheme_line_fitting(&caliConfig, &_cali);
+#endif
+  if (err != ESP_OK) {
+    _cali = nullptr;
+    DEBUG_WARN_PRINTLN("BatteryAdcSampler: ADC calibration not available, using the nominal range.");
+  }
+}
+
+/**
+ * @brief Converts a raw code to millivolts at the pin.
+ * @param raw The raw ADC code.
+ * @return The voltage in millivolts.
+ */
+int BatteryAdcSampler::_rawToMilliVolts(int raw) const {
+  int milliVolts = 0;
+  if (_cali && adc_cali_raw_to_voltage(_cali, raw, &milliVolts) == ESP_OK) {
+    return milliVolts;
+  }
+  // Uncalibrated: nominal full scale of the 12 dB attenuation.
+  return raw * 3100 / ((1 << SOC_ADC_DIGI_MAX_BITWIDTH) - 1);
+}
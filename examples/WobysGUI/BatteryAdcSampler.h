@@ -0,0 +1,137 @@
+/**
+ * @file BatteryAdcSampler.h
+ * @brief Defines the BatteryAdcSampler class, which samples the battery voltage divider with the
+ * continuous (DMA) ADC driver and filters it off the UI task.
+ *
+ * The ADC converts the battery pin continuously at a low rate and the DMA collects the results
+ * without CPU involvement. `process()` runs on a worker task (the battery ManagerTask): it drains the
+ * DMA buffer, takes the median of the drained samples to reject spikes, and smooths the result with
+ * a fixed-point IIR filter. The filtered pin voltage is published through an atomic, so the UI task
+ * reads the latest value with a single load and never waits on the ADC.
+ *
+ * @version 1.0.0
+ * @date 2025-09-05
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef BATTERY_ADC_SAMPLER_H
+#define BATTERY_ADC_SAMPLER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <esp_adc/adc_continuous.h>
+#include <esp_adc/adc_cali.h>
+
+#include "Config.h"
+
+/**
+ * @brief Continuous ADC sampling of one pin with median + IIR filtering and a lock-free result.
+ *
+ * `begin()`/`end()` and `process()` belong to the sampling side (init code and the worker task);
+ * `hasSample()` and `getFilteredMilliVolts()` may be called from any task.
+ */
+class BatteryAdcSampler {
+public:
+    /**
+     * @brief Constructor for BatteryAdcSampler.
+     */
+    BatteryAdcSampler();
+
+    /**
+     * @brief Destructor. Stops the ADC and releases the driver.
+     */
+    ~BatteryAdcSampler();
+
+    BatteryAdcSampler(const BatteryAdcSampler&) = delete;
+    BatteryAdcSampler& operator=(const BatteryAdcSampler&) = delete;
+
+    /**
+     * @brief Configures the continuous ADC on a pin and starts converting.
+     * The pin must not be read with `analogRead()` while the sampler runs.
+     * @param gpio The ADC1-capable GPIO connected to the voltage divider.
+     * @return True if the ADC is running, false if the pin or the driver could not be set up.
+     */
+    bool begin(int gpio);
+
+    /**
+     * @brief Stops the ADC and releases the driver.
+     */
+    void end();
+
+    /**
+     * @brief Checks whether the continuous ADC is running.
+     * @return True if running.
+     */
+    bool isRunning() const { return _handle != nullptr; }
+
+    /**
+     * @brief Drains the DMA buffer and updates the filtered value. Called on the worker task.
+     * @return Milliseconds until the next call.
+     */
+    uint32_t process();
+
+    /**
+     * @brief Checks whether at least one filtered value is available.
+     * @return True once the first batch has been processed.
+     */
+    bool hasSample() const { return _batchCount.load(std::memory_order_acquire) > 0; }
+
+    /**
+     * @brief Returns the latest filtered pin voltage. Lock-free, callable from any task.
+     * @return The filtered voltage at the ADC pin in millivolts.
+     */
+    uint32_t getFilteredMilliVolts() const { return _filteredMilliVolts.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the number of processed batches.
+     * @return The batch count since `begin()`.
+     */
+    uint32_t getBatchCount() const { return _batchCount.load(std::memory_order_relaxed); }
+
+private:
+    adc_continuous_handle_t _handle;                 ///< Continuous ADC driver handle (nullptr when stopped).
+    adc_cali_handle_t _cali;                         ///< Calibration handle (nullptr if unsupported).
+    adc_channel_t _channel;                          ///< ADC channel of the pin.
+    int32_t _filterQ8;                               ///< IIR filter state in millivolts, Q24.8 (worker task only).
+    std::atomic<uint32_t> _filteredMilliVolts;       ///< Published filtered pin voltage.
+    std::atomic<uint32_t> _batchCount;               ///< Processed batches.
+    uint8_t _readBuffer[BATTERY_ADC_FRAME_BYTES];    ///< DMA read buffer (worker task only).
+    uint16_t _window[BATTERY_ADC_MEDIAN_WINDOW];     ///< Latest raw codes of the current batch.
+
+    /**
+     * @brief Creates the calibration scheme supported by the chip.
+     * @param unit The ADC unit.
+     * @param atten The attenuation used for the channel.
+     */
+    void _createCalibration(adc_unit_t unit, adc_atten_t atten);
+
+    /**
+     * @brief Converts a raw code to millivolts at the pin.
+     * @param raw The raw ADC code.
+     * @return The voltage in millivolts.
+     */
+    int _rawToMilliVolts(int raw) const;
+};
+
+#endif // BATTERY_ADC_SAMPLER_H
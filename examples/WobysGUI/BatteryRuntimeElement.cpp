@@ -0,0 +1,145 @@
+/**
+ * @file BatteryRuntimeElement.cpp
+ * @brief Implements the BatteryRuntimeElement class, a specialized StatusbarElement for displaying
+ * the battery state of charge and the predicted remaining runtime.
+ *
+ * @version 1.0.0
+ * @date 2025-09-06
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "BatteryRuntimeElement.h"
+#include "Config.h" // Required for debug macros and UI color constants
+#include <stdio.h>
+
+/**
+ * @brief Constructor for the BatteryRuntimeElement.
+ * @param lcd Pointer to the LGFX display instance.
+ * @param width The fixed width of the element in the status bar.
+ * @param powerManager Pointer to the PowerManager instance.
+ * @param elementName Optional debug name for the element.
+ * @param font The font to use for rendering the text.
+ */
+BatteryRuntimeElement::BatteryRuntimeElement(LGFX* lcd, int32_t width, PowerManager* powerManager,
+                                             const std::string& elementName,
+                                             const lgfx::IFont* font)
+    : StatusbarElement(lcd, width, elementName),
+      _powerManager(powerManager),
+      _lastPercent(-1),
+      _lastRuntimeMinutes(-1),
+      _lastCharging(false),
+      _verticalAdjustmentPixels(TIMEELEMENT_VERTICAL_ADJUSTMENT_PIXELS), // Same baseline as the time.
+      _textColor(UI_COLOR_TEXT_DEFAULT),
+      _backgroundColor(PANEL_BACKGROUND_COLOR),
+      _font(font)
+{
+    DEBUG_INFO_PRINTLN("BatteryRuntimeElement: Constructor executed.");
+}
+
+/**
+ * @brief Polls the PowerManager and requests a redraw if the displayed values changed.
+ * Only integers are compared, so polling every loop iteration is cheap.
+ */
+void BatteryRuntimeElement::update() {
+    if (!_powerManager) return;
+
+    const int percent = _powerManager->getStateOfChargePercent();
+    const bool charging = _powerManager->isCharging();
+    const int runtimeMinutes = _displayedRuntime(charging ? _powerManager->getMinutesToFull()
+                                                          : _powerManager->getRemainingRuntimeMinutes());
+    if (percent != _lastPercent || runtimeMinutes != _lastRuntimeMinutes || charging != _lastCharging) {
+        _lastPercent = percent;
+        _lastRuntimeMinutes = runtimeMinutes;
+        _lastCharging = charging;
+        requestRedraw();
+    }
+}
+
+/**
+ * @brief Sets the color of the text.
+ * Requests a redraw if the color changes.
+ * @param color The new color for the text.
+ */
+void BatteryRuntimeElement::setTextColor(uint32_t color) {
+    if (_textColor != color) {
+        _textColor = color;
+        requestRedraw();
+    }
+}
+
+/**
+ * @brief Sets the background color of the element area.
+ * Requests a redraw if the color changes.
+ * @param color The new background color.
+ */
+void BatteryRuntimeElement::setBackgroundColor(uint32_t color) {
+    if (_backgroundColor != color) {
+        _backgroundColor = color;
+        requestRedraw();
+    }
+}
+
+/**
+ * @brief Rounds a runtime to the precision it is displayed with, so a change that is not visible
+ * does not cause a redraw.
+ * @param minutes The remaining runtime in minutes, or -1 if unknown.
+ * @return The displayed runtime in minutes, or -1 if it is not displayed.
+ */
+int BatteryRuntimeElement::_displayedRuntime(int minutes) {
+    if (minutes < 0 || minutes >= BATTERY_RUNTIME_MAX_DISPLAY_HOURS * 60) return -1;
+    return minutes;
+}
+
+/**
+ * @brief Draws the state of charge and the remaining runtime, right-aligned towards the battery icon.
+ * @param x The absolute X coordinate on the screen where the element should be drawn.
+ * @param y The absolute Y coordinate on the screen where the element should be drawn.
+ * @param actualWidth The actual width allocated for the element in the status bar.
+ */
+void BatteryRuntimeElement::draw(int32_t x, int32_t y, int32_t actualWidth) {
+    if (!needsRedraw()) {
+        return;
+    }
+
+    char text[16];
+    const char* sign = _lastCharging ? "+" : "";
+    if (_lastPercent < 0) {
+        snprintf(text, sizeof(text), "--%%");
+    } else if (_lastRuntimeMinutes < 0) {
+        snprintf(text, sizeof(text), "%s%d%%", sign, _lastPercent);
+    } else if (_lastRuntimeMinutes >= 60) {
+        snprintf(text, sizeof(text), "%s%d%% %dh%02d", sign, _lastPercent, _lastRuntimeMinutes / 60, _lastRuntimeMinutes % 60);
+    } else {
+        snprintf(text, sizeof(text), "%s%d%% %dm", sign, _lastPercent, _lastRuntimeMinutes);
+    }
+
+    _lcd->fillRect(x, y, actualWidth, _statusBarHeightRef, _backgroundColor);
+    _lcd->setFont(_font);
+    _lcd->setTextDatum(TR_DATUM);
+    _lcd->setTextColor(_textColor, _backgroundColor);
+    const int textY = y + (_statusBarHeightRef + _verticalAdjustmentPixels - _lcd->fontHeight()) / 2;
+    _lcd->drawString(text, x + actualWidth - 1, textY);
+    _lcd->setTextDatum(TL_DATUM); // Restore the default datum for the other elements.
+
+    clearRedrawRequest();
+}
@@ -0,0 +1,108 @@
+/**
+ * @file BatteryRuntimeElement.h
+ * @brief Defines the BatteryRuntimeElement class, a specialized StatusbarElement for displaying the
+ * battery state of charge and the predicted remaining runtime.
+ *
+ * This class polls the estimates of a PowerManager and renders them next to the battery icon,
+ * e.g. "87% 5h12". It redraws only when the displayed values change.
+ *
+ * @version 1.0.0
+ * @date 2025-09-06
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef BATTERYRUNTIMEELEMENT_H
+#define BATTERYRUNTIMEELEMENT_H
+
+#include "StatusbarElement.h"
+#include "PowerManager.h"
+
+/**
+ * @brief A specialized StatusbarElement for displaying the state of charge and remaining runtime.
+ *
+ * The runtime is shown in whole hours and minutes above one hour ("5h12"), in minutes below
+ * ("45m"), and omitted while it is not known yet or beyond BATTERY_RUNTIME_MAX_DISPLAY_HOURS.
+ * While charging, the percentage gets a leading "+" and the time is the time to full ("+64% 1h05").
+ */
+class BatteryRuntimeElement : public StatusbarElement {
+private:
+    PowerManager* _powerManager;                ///< Pointer to the PowerManager providing the estimates.
+    int _lastPercent;                           ///< Last displayed state of charge (-1 if unknown).
+    int _lastRuntimeMinutes;                    ///< Last displayed runtime (or time to full), rounded to the displayed precision.
+    bool _lastCharging;                         ///< Last displayed charging state.
+    int16_t _verticalAdjustmentPixels;          ///< Vertical adjustment for centering the text.
+    uint32_t _textColor;                        ///< Color of the text.
+    uint32_t _backgroundColor;                  ///< Background color of the element area.
+    const lgfx::IFont* _font;                   ///< The font used for rendering the text.
+
+public:
+    /**
+     * @brief Constructor for the BatteryRuntimeElement.
+     * @param lcd Pointer to the LGFX display instance.
+     * @param width The fixed width of the element in the status bar.
+     * @param powerManager Pointer to the PowerManager instance.
+     * @param elementName Optional debug name for the element.
+     * @param font The font to use for rendering the text (default: helvR10).
+     */
+    BatteryRuntimeElement(LGFX* lcd, int32_t width, PowerManager* powerManager,
+                          const std::string& elementName = "BatteryRuntime",
+                          const lgfx::IFont* font = &helvR10);
+
+    /**
+     * @brief Draws the state of charge and the remaining runtime (or the time to full).
+     * @param x The absolute X coordinate on the screen where the element should be drawn.
+     * @param y The absolute Y coordinate on the screen where the element should be drawn.
+     * @param actualWidth The actual width allocated for the element in the status bar.
+     */
+    virtual void draw(int32_t x, int32_t y, int32_t actualWidth) override;
+
+    /**
+     * @brief Polls the PowerManager and requests a redraw if the displayed values changed.
+     */
+    void update() override;
+
+    /**
+     * @brief Sets the color of the text.
+     * Requests a redraw if the color changes.
+     * @param color The new color for the text.
+     */
+    void setTextColor(uint32_t color);
+
+    /**
+     * @brief Sets the background color of the element area.
+     * Requests a redraw if the color changes.
+     * @param color The new background color.
+     */
+    void setBackgroundColor(uint32_t color);
+
+private:
+    /**
+     * @brief Rounds a runtime to the precision it is displayed with.
+     * @param minutes The remaining runtime or time to full in minutes, or -1 if unknown.
+     * @return The displayed runtime in minutes, or -1 if it is not displayed.
+     */
+    static int _displayedRuntime(int minutes);
+};
+
+#endif // BATTERYRUNTIMEELEMENT_H
@@ -0,0 +1,376 @@
+/**
+ * @file BatterySocEstimator.cpp
+ * @brief Implements the BatterySocEstimator class.
+ *
+ * @version 1.0.0
+ * @date 2025-09-06
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "BatterySocEstimator.h"
+#include "SystemInitializer.h" // For BatterySocConfig struct definition
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Constructor for BatterySocEstimator.
+ */
+BatterySocEstimator::BatterySocEstimator()
+  : _ocvTable(nullptr),
+    _ocvTableSize(0),
+    _internalResistanceOhm(0.0f),
+    _nominalCapacityMah(0.0f),
+    _loadBaseMilliAmps(0.0f),
+    _loadBacklightMaxMilliAmps(0.0f),
+    _loadWifiMilliAmps(0.0f),
+    _loadBluetoothMilliAmps(0.0f),
+    _loadAudioMilliAmps(0.0f),
+    _chargeCurrentMilliAmps(0.0f),
+    _chargeMilliVolts(0.0f),
+    _chargeTerminationMilliAmps(0.0f),
+    _hasSample(false),
+    _lastSampleMs(0),
+    _compensatedVoltage(0.0f),
+    _socPercent(0.0f),
+    _averageLoadMilliAmps(0.0f),
+    _learnedCapacityMah(0.0f),
+    _windowStartPercent(0.0f),
+    _windowConsumedMah(0.0f),
+    _charging(false),
+    _referenceMilliVolts(0.0f),
+    _cvStartPercent(-1.0f) {}
+
+/**
+ * @brief Sets the OCV table, the battery model and the load model.
+ * @param config The estimator configuration.
+ */
+void BatterySocEstimator::init(const BatterySocConfig& config) {
+  _ocvTable = config.ocvTable;
+  _ocvTableSize = config.ocvTableSize;
+  _internalResistanceOhm = config.internalResistanceOhm;
+  _nominalCapacityMah = config.nominalCapacityMah;
+  _loadBaseMilliAmps = config.loadBaseMilliAmps;
+  _loadBacklightMaxMilliAmps = config.loadBacklightMaxMilliAmps;
+  _loadWifiMilliAmps = config.loadWifiMilliAmps;
+  _loadBluetoothMilliAmps = config.loadBluetoothMilliAmps;
+  _loadAudioMilliAmps = config.loadAudioMilliAmps;
+  _chargeCurrentMilliAmps = config.chargeCurrentMilliAmps;
+  _chargeMilliVolts = config.chargeVoltage * 1000.0f;
+  _chargeTerminationMilliAmps = config.chargeTerminationMilliAmps;
+  _learnedCapacityMah = _nominalCapacityMah;
+  _hasSample = false;
+  _charging = false;
+  _cvStartPercent = -1.0f;
+
+  if (!_ocvTable || _ocvTableSize < 2) {
+    DEBUG_WARN_PRINTLN("BatterySocEstimator: OCV table missing or too short, state of charge not available.");
+    _ocvTableSize = 0;
+  }
+}
+
+/**
+ * @brief Estimates the battery current from the subsystem states.
+ * @param load The current subsystem states.
+ * @return The estimated current in mA.
+ */
+float BatterySocEstimator::estimateLoadMilliAmps(const BatteryLoadState& load) const {
+  float milliAmps = _loadBaseMilliAmps + _loadBacklightMaxMilliAmps * load.backlight / 255.0f;
+  if (load.wifiEnabled) milliAmps += _loadWifiMilliAmps;
+  if (load.bluetoothEnabled) milliAmps += _loadBluetoothMilliAmps;
+  if (load.audioEnabled) milliAmps += _loadAudioMilliAmps;
+  return milliAmps;
+}
+
+/**
+ * @brief Feeds a voltage sample: detects the charger, compensates the sag (or the charge current),
+ * updates the state of charge, the averaged load and the learning window.
+ * @param voltage The measured battery voltage in Volts.
+ * @param loadMilliAmps The estimated current at the time of the sample.
+ * @param nowMs The time of the sample (`millis()`).
+ */
+void BatterySocEstimator::update(float voltage, float loadMilliAmps, uint32_t nowMs) {
+  if (_ocvTableSize == 0 || voltage < 0.5f) return; // No table, or no battery connected.
+
+  const float measuredMilliVolts = voltage * 1000.0f;
+  // mA * Ohm = mV
+  const float dischargeMilliVolts = measuredMilliVolts + loadMilliAmps * _internalResistanceOhm;
+
+  if (!_hasSample) {
+    const float percent = _lookupPercent(dischargeMilliVolts);
+    _hasSample = true;
+    _lastSampleMs = nowMs;
+    _compensatedVoltage = dischargeMilliVolts / 1000.0f;
+    _referenceMilliVolts = dischargeMilliVolts;
+    _socPercent = percent;
+    _averageLoadMilliAmps = loadMilliAmps;
+    _windowStartPercent = percent;
+    _windowConsumedMah = 0.0f;
+    DEBUG_INFO_PRINTF("BatterySocEstimator: Initial state of charge %.0f%% (OCV %.3fV, load %.0fmA).\n",
+                      percent, _compensatedVoltage, loadMilliAmps);
+    return;
+  }
+
+  const uint32_t elapsedMs = nowMs - _lastSampleMs;
+  _lastSampleMs = nowMs;
+
+  // Connecting the charger steps the compensated voltage up; a charger too weak for a step, or one
+  // connected before boot, shows as a rise of the state of charge instead.
+  bool stateChanged = false;
+  if (!_charging && (dischargeMilliVolts - _referenceMilliVolts >= BATTERY_SOC_CHARGE_DETECT_MV ||
+                     _socPercent > _windowStartPercent + BATTERY_SOC_CHARGE_DETECT_PERCENT)) {
+    _setCharging(true);
+    stateChanged = true;
+  }
+
+  float ocvMilliVolts = dischargeMilliVolts;
+  if (_charging) {
+    ocvMilliVolts = _updateCharging(measuredMilliVolts, loadMilliAmps, 0);
+    // Disconnecting it takes the charge current away: the estimate drops by the same step. After
+    // the charger has ended the charge there is no current left to take away, but a full cell
+    // only rests this far below the charge voltage once it is being discharged.
+    const bool ended = _cvStartPercent >= 0.0f && measuredMilliVolts <= _chargeMilliVolts - BATTERY_SOC_CHARGE_DETECT_MV;
+    if (!stateChanged && (_referenceMilliVolts - ocvMilliVolts >= BATTERY_SOC_CHARGE_DETECT_MV || ended)) {
+      _setCharging(false);
+      stateChanged = true;
+      ocvMilliVolts = dischargeMilliVolts;
+    } else {
+      _updateCharging(measuredMilliVolts, loadMilliAmps, elapsedMs);
+    }
+  }
+  _compensatedVoltage = ocvMilliVolts / 1000.0f;
+  // Restarted on a change, so the step that caused it cannot switch the state back.
+  _referenceMilliVolts = stateChanged ? ocvMilliVolts
+                                      : _referenceMilliVolts + BATTERY_SOC_FILTER_WEIGHT * (ocvMilliVolts - _referenceMilliVolts);
+
+  if (!_charging) {
+    // The learned capacity is in mAh of the load model, like the load.
+    _track(_lookupPercent(ocvMilliVolts), -loadMilliAmps * elapsedMs / 3600000.0f * 100.0f / _learnedCapacityMah);
+  }
+
+  // Time-weighted average, so the runtime does not jump each time the backlight or a radio toggles.
+  const float weight = (float)elapsedMs / (float)(BATTERY_SOC_LOAD_AVERAGE_MS + elapsedMs);
+  _averageLoadMilliAmps += weight * (loadMilliAmps - _averageLoadMilliAmps);
+
+  if (!_charging) {
+    _windowConsumedMah += loadMilliAmps * elapsedMs / 3600000.0f;
+    _learn();
+  }
+}
+
+/**
+ * @brief Returns the smoothed state of charge.
+ * @return The state of charge in percent (0-100), or UNKNOWN.
+ */
+int BatterySocEstimator::getPercent() const {
+  if (!_hasSample) return UNKNOWN;
+  return (int)(_socPercent + 0.5f);
+}
+
+/**
+ * @brief Returns the predicted remaining runtime at the averaged load.
+ * @return The remaining runtime in minutes, or UNKNOWN.
+ */
+int BatterySocEstimator::getRemainingMinutes() const {
+  if (!_hasSample || _charging || _averageLoadMilliAmps <= 0.0f) return UNKNOWN;
+  const float remainingMah = _learnedCapacityMah * _socPercent / 100.0f;
+  return (int)(remainingMah / _averageLoadMilliAmps * 60.0f);
+}
+
+/**
+ * @brief Returns the predicted time until the charger ends the charge: the constant-current phase
+ * up to the state of charge where the voltage reaches the charge voltage, then the taper down to
+ * the termination current, both at the averaged load.
+ * @return The time to full in minutes, or UNKNOWN while not charging.
+ */
+int BatterySocEstimator::getMinutesToFull() const {
+  if (!_hasSample || !_charging || _nominalCapacityMah <= 0.0f) return UNKNOWN;
+  const float cellMilliAmps = _chargeCurrentMilliAmps - _averageLoadMilliAmps;
+  if (cellMilliAmps <= _chargeTerminationMilliAmps) return UNKNOWN; // The load takes (nearly) all of it.
+
+  const float cvStartPercent = _cvStartPercent >= 0.0f
+    ? _cvStartPercent
+    : std::min(_lookupPercent(_chargeMilliVolts - BATTERY_SOC_CHARGE_CV_MARGIN_MV - cellMilliAmps * _internalResistanceOhm), 99.0f);
+  const float hoursPerPercent = _nominalCapacityMah / 100.0f / cellMilliAmps;
+  float hours = std::max(cvStartPercent - _socPercent, 0.0f) * hoursPerPercent;
+
+  // The taper is exponential with the time constant of the charge left at its start.
+  const float remainingFraction = (100.0f - std::max(_socPercent, cvStartPercent)) / (100.0f - cvStartPercent);
+  const float terminationFraction = _chargeTerminationMilliAmps / cellMilliAmps;
+  if (remainingFraction > terminationFraction) {
+    hours += (100.0f - cvStartPercent) * hoursPerPercent * logf(remainingFraction / terminationFraction);
+  }
+  return (int)(hours * 60.0f + 0.5f);
+}
+
+/**
+ * @brief Returns the learned discharge rate at the averaged load.
+ * @return The discharge rate in percent per hour, or 0 before the first sample.
+ */
+float BatterySocEstimator::getDischargeRatePercentPerHour() const {
+  if (!_hasSample || _learnedCapacityMah <= 0.0f) return 0.0f;
+  return _averageLoadMilliAmps / _learnedCapacityMah * 100.0f;
+}
+
+/**
+ * @brief Maps an open-circuit voltage to a state of charge by linear interpolation between the
+ * rows of the OCV table. Values outside the table are clamped to its end points.
+ * @param milliVolts The open-circuit voltage in mV.
+ * @return The state of charge in percent.
+ */
+float BatterySocEstimator::_lookupPercent(float milliVolts) const {
+  if (milliVolts >= _ocvTable[0][0]) return _ocvTable[0][1];
+  for (size_t i = 1; i < _ocvTableSize; ++i) {
+    const float upperMv = _ocvTable[i - 1][0];
+    const float lowerMv = _ocvTable[i][0];
+    if (milliVolts >= lowerMv) {
+      const float fraction = (milliVolts - lowerMv) / (upperMv - lowerMv);
+      return _ocvTable[i][1] + fraction * (_ocvTable[i - 1][1] - _ocvTable[i][1]);
+    }
+  }
+  return _ocvTable[_ocvTableSize - 1][1];
+}
+
+/**
+ * @brief Advances the state of charge by the counted change, then pulls it towards the table
+ * lookup: by BATTERY_SOC_FILTER_WEIGHT where the table is steep, by BATTERY_SOC_FLAT_FILTER_WEIGHT
+ * where it is flatter than BATTERY_SOC_FLAT_SLOPE_MV and a few mV of compensation error (a load
+ * model that is 20 % off, a cell that differs from the table) would move the lookup by several
+ * percent. Counting carries the estimate through the flat region instead.
+ * @param tablePercent The table lookup of the compensated voltage.
+ * @param countedPercent The change counted from the current since the previous sample.
+ */
+void BatterySocEstimator::_track(float tablePercent, float countedPercent) {
+  _socPercent = constrain(_socPercent + countedPercent, 0.0f, 100.0f);
+  const float weight = _tableSlope(tablePercent) < BATTERY_SOC_FLAT_SLOPE_MV ? BATTERY_SOC_FLAT_FILTER_WEIGHT
+                                                                           : BATTERY_SOC_FILTER_WEIGHT;
+  _socPercent += weight * (tablePercent - _socPercent);
+}
+
+/**
+ * @brief Returns the slope of the OCV table around a state of charge.
+ * @param percent The state of charge in percent.
+ * @return The slope in mV per percent.
+ */
+float BatterySocEstimator::_tableSlope(float percent) const {
+  return _lookupMilliVolts(percent + 0.5f) - _lookupMilliVolts(percent - 0.5f);
+}
+
+/**
+ * @brief Maps a state of charge to an open-circuit voltage, the inverse of `_lookupPercent()`.
+ * @param percent The state of charge in percent.
+ * @return The open-circuit voltage in mV.
+ */
+float BatterySocEstimator::_lookupMilliVolts(float percent) const {
+  if (percent >= _ocvTable[0][1]) return _ocvTable[0][0];
+  for (size_t i = 1; i < _ocvTableSize; ++i) {
+    const float upperPercent = _ocvTable[i - 1][1];
+    const float lowerPercent = _ocvTable[i][1];
+    if (percent >= lowerPercent) {
+      const float fraction = (percent - lowerPercent) / (upperPercent - lowerPercent);
+      return _ocvTable[i][0] + fraction * (_ocvTable[i - 1][0] - _ocvTable[i][0]);
+    }
+  }
+  return _ocvTable[_ocvTableSize - 1][0];
+}
+
+/**
+ * @brief Estimates the open-circuit voltage of a sample while charging and advances the state of
+ * charge. In the constant-current phase the cell takes the charger current less the load, counted
+ * and corrected by the table as when discharging; in the constant-voltage phase the cell current is taken to
+ * fall with the charge still missing, from its value at the start of the phase down to the
+ * termination current, and is integrated over the rated capacity (a real current, unlike the load
+ * model the learned capacity is in).
+ * @param measuredMilliVolts The measured voltage in mV.
+ * @param loadMilliAmps The estimated load current.
+ * @param elapsedMs Time since the previous sample; 0 only estimates the voltage.
+ * @return The open-circuit voltage estimate in mV.
+ */
+float BatterySocEstimator::_updateCharging(float measuredMilliVolts, float loadMilliAmps, uint32_t elapsedMs) {
+  const float cellMilliAmps = _chargeCurrentMilliAmps - loadMilliAmps;
+  // Once reached, the charger holds the charge voltage until it ends the charge; noise or the
+  // cell resting just below it afterwards is not a return to constant current.
+  const bool constantVoltage = _cvStartPercent >= 0.0f ||
+                               measuredMilliVolts >= _chargeMilliVolts - BATTERY_SOC_CHARGE_CV_MARGIN_MV;
+
+  if (!constantVoltage || cellMilliAmps <= 0.0f) {
+    const float ocvMilliVolts = measuredMilliVolts - cellMilliAmps * _internalResistanceOhm;
+    if (elapsedMs) {
+      _track(_lookupPercent(ocvMilliVolts), cellMilliAmps * elapsedMs / 3600000.0f * 100.0f / _nominalCapacityMah);
+    }
+    return ocvMilliVolts;
+  }
+
+  const float startPercent = _cvStartPercent >= 0.0f ? _cvStartPercent : std::min(_socPercent, 99.0f);
+  float taperMilliAmps = cellMilliAmps * (100.0f - _socPercent) / (100.0f - startPercent);
+  if (taperMilliAmps < _chargeTerminationMilliAmps) taperMilliAmps = 0.0f; // The charger has ended the charge.
+  if (elapsedMs) {
+    if (_cvStartPercent < 0.0f) {
+      _cvStartPercent = startPercent;
+      DEBUG_INFO_PRINTF("BatterySocEstimator: Constant-voltage phase from %.0f%%.\n", startPercent);
+    }
+    _socPercent = std::min(_socPercent + taperMilliAmps * elapsedMs / 3600000.0f * 100.0f / _nominalCapacityMah, 100.0f);
+  }
+  return measuredMilliVolts - taperMilliAmps * _internalResistanceOhm;
+}
+
+/**
+ * @brief Switches between charging and discharging. Neither the charge nor the step belongs to a
+ * learning window, so the window restarts.
+ * @param charging The new state.
+ */
+void BatterySocEstimator::_setCharging(bool charging) {
+  _charging = charging;
+  _cvStartPercent = -1.0f;
+  _windowStartPercent = _socPercent;
+  _windowConsumedMah = 0.0f;
+  DEBUG_INFO_PRINTF("BatterySocEstimator: Charger %s at %.0f%%.\n", charging ? "connected" : "disconnected", _socPercent);
+}
+
+/**
+ * @brief Advances the learning window. Once the state of charge has dropped by
+ * BATTERY_SOC_LEARN_MIN_DROP_PERCENT, the charge consumed per percent is blended into the learned
+ * capacity and a new window starts. Windows in the flat part of the table are skipped, and
+ * charging restarts the window (see `_setCharging()`).
+ */
+void BatterySocEstimator::_learn() {
+  const float drop = _windowStartPercent - _socPercent;
+  if (drop < BATTERY_SOC_LEARN_MIN_DROP_PERCENT) return;
+
+  // Where the table is flat, the state of charge is mostly counted with the learned capacity, so
+  // the window would only confirm it: skip it.
+  if (_tableSlope(_windowStartPercent) < BATTERY_SOC_FLAT_SLOPE_MV || _tableSlope(_socPercent) < BATTERY_SOC_FLAT_SLOPE_MV) {
+    _windowStartPercent = _socPercent;
+    _windowConsumedMah = 0.0f;
+    return;
+  }
+
+  float capacity = _windowConsumedMah * 100.0f / drop;
+  // A window spoilt by a wrong table region or a load change should not drag the estimate far.
+  capacity = constrain(capacity, _nominalCapacityMah * 0.25f, _nominalCapacityMah * 2.0f);
+  _learnedCapacityMah += BATTERY_SOC_LEARN_WEIGHT * (capacity - _learnedCapacityMah);
+  DEBUG_INFO_PRINTF("BatterySocEstimator: %.1f%% used %.0fmAh, learned capacity %.0fmAh (%.1f%%/h at %.0fmA).\n",
+                    drop, _windowConsumedMah, _learnedCapacityMah, getDischargeRatePercentPerHour(), _averageLoadMilliAmps);
+
+  _windowStartPercent = _socPercent;
+  _windowConsumedMah = 0.0f;
+}
@@ -0,0 +1,226 @@
+/**
+ * @file BatterySocEstimator.h
+ * @brief Defines the BatterySocEstimator class, which estimates the battery state of charge and
+ * predicts the remaining runtime from the voltage samples of the PowerManager.
+ *
+ * The measured voltage sags under load (backlight, radio transmit bursts), so it is first corrected
+ * to an open-circuit voltage with a simple internal resistance model, V_ocv = V + I_load * R_int,
+ * where I_load is estimated from the known states of the subsystems. The open-circuit voltage is
+ * mapped to a percentage with a configurable OCV table and smoothed.
+ *
+ * For the runtime prediction the estimator learns how much charge (in mAh of the load model) one
+ * percent of the battery really delivers: whenever the state of charge has dropped by a few percent,
+ * the charge consumed by the modelled load over that window is divided by the drop. Because the same
+ * load model is used for learning and for the prediction, a constant scale error of the model cancels
+ * out. Remaining runtime = remaining learned charge / averaged load.
+ *
+ * @version 1.0.0
+ * @date 2025-09-06
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef BATTERY_SOC_ESTIMATOR_H
+#define BATTERY_SOC_ESTIMATOR_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+// Forward declaration. The BatterySocConfig struct is defined in SystemInitializer.h.
+struct BatterySocConfig;
+
+/**
+ * @brief States of the subsystems that dominate the battery current.
+ * Filled in by the load state provider of the PowerManager.
+ */
+struct BatteryLoadState {
+    uint8_t backlight = 0;          ///< Current backlight level (0-255).
+    bool wifiEnabled = false;       ///< Wi-Fi radio on.
+    bool bluetoothEnabled = false;  ///< Bluetooth radio on.
+    bool audioEnabled = false;      ///< Audio amplifier enabled.
+};
+
+/**
+ * @brief OCV table lookup with load compensation, and a learned charge per percent for the
+ * remaining runtime. Called from the UI task only.
+ *
+ * Between samples the state of charge is counted from the load with the learned capacity and then
+ * corrected towards the table; where the table is flat the correction is weak, as a small
+ * compensation error there would move the lookup by several percent.
+ *
+ * The charger is detected from the voltage: connecting it lifts the load-compensated voltage by
+ * about the charge current times the internal resistance, disconnecting it drops it again. While
+ * charging, the constant-current phase is compensated for the charge current instead of the load,
+ * and the constant-voltage phase (where the voltage no longer tells the state of charge) is
+ * integrated with a current that tapers towards the termination current. The remaining runtime
+ * is not known while charging; the time to full is.
+ */
+class BatterySocEstimator {
+public:
+    static constexpr int UNKNOWN = -1; ///< Returned by the getters until the first sample.
+
+    /**
+     * @brief Constructor for BatterySocEstimator.
+     */
+    BatterySocEstimator();
+
+    /**
+     * @brief Sets the OCV table, the battery model and the load model.
+     * @param config The estimator configuration. The OCV table must outlive the estimator.
+     */
+    void init(const BatterySocConfig& config);
+
+    /**
+     * @brief Estimates the battery current from the subsystem states.
+     * @param load The current subsystem states.
+     * @return The estimated current in mA.
+     */
+    float estimateLoadMilliAmps(const BatteryLoadState& load) const;
+
+    /**
+     * @brief Feeds a voltage sample.
+     * @param voltage The measured battery voltage in Volts.
+     * @param loadMilliAmps The estimated current at the time of the sample.
+     * @param nowMs The time of the sample (`millis()`).
+     */
+    void update(float voltage, float loadMilliAmps, uint32_t nowMs);
+
+    /**
+     * @brief Returns the load-compensated (open-circuit) voltage of the latest sample.
+     * @return The voltage in Volts, or 0 before the first sample.
+     */
+    float getCompensatedVoltage() const { return _compensatedVoltage; }
+
+    /**
+     * @brief Returns the smoothed state of charge.
+     * @return The state of charge in percent (0-100), or UNKNOWN.
+     */
+    int getPercent() const;
+
+    /**
+     * @brief Returns the predicted remaining runtime at the averaged load.
+     * @return The remaining runtime in minutes, or UNKNOWN (also while charging).
+     */
+    int getRemainingMinutes() const;
+
+    /**
+     * @brief Returns the learned discharge rate at the averaged load.
+     * @return The discharge rate in percent per hour, or 0 before the first sample.
+     */
+    float getDischargeRatePercentPerHour() const;
+
+    /**
+     * @brief Returns the learned usable capacity (in mAh of the load model).
+     * @return The capacity; the nominal capacity until the first learning window completes.
+     */
+    float getLearnedCapacityMah() const { return _learnedCapacityMah; }
+
+    /**
+     * @brief Returns whether a charger is connected and charging the cell.
+     * @return True while charging.
+     */
+    bool isCharging() const { return _charging; }
+
+    /**
+     * @brief Returns the predicted time until the charger ends the charge.
+     * @return The time to full in minutes, or UNKNOWN while not charging.
+     */
+    int getMinutesToFull() const;
+
+private:
+    const uint16_t (*_ocvTable)[2];   ///< OCV table rows {mV, percent}, descending voltage.
+    size_t _ocvTableSize;             ///< Number of rows.
+    float _internalResistanceOhm;     ///< Cell + protection + wiring resistance.
+    float _nominalCapacityMah;        ///< Starting point of the learned capacity.
+    float _loadBaseMilliAmps;         ///< Current with the display dark and the radios off.
+    float _loadBacklightMaxMilliAmps; ///< Additional current at full backlight.
+    float _loadWifiMilliAmps;         ///< Average additional current with Wi-Fi on.
+    float _loadBluetoothMilliAmps;    ///< Average additional current with Bluetooth on.
+    float _loadAudioMilliAmps;        ///< Additional current with the amplifier enabled.
+    float _chargeCurrentMilliAmps;    ///< Charger current in the constant-current phase.
+    float _chargeMilliVolts;          ///< Charger voltage in the constant-voltage phase.
+    float _chargeTerminationMilliAmps;///< Cell current at which the charger ends the charge.
+
+    bool _hasSample;                  ///< True after the first sample.
+    uint32_t _lastSampleMs;           ///< Time of the latest sample.
+    float _compensatedVoltage;        ///< Open-circuit voltage of the latest sample.
+    float _socPercent;                ///< Smoothed state of charge.
+    float _averageLoadMilliAmps;      ///< Load averaged over BATTERY_SOC_LOAD_AVERAGE_MS.
+    float _learnedCapacityMah;        ///< Learned charge for 0-100 %.
+    float _windowStartPercent;        ///< State of charge at the start of the learning window.
+    float _windowConsumedMah;         ///< Charge consumed since the start of the window.
+    bool _charging;                   ///< True while a charger is detected.
+    float _referenceMilliVolts;       ///< Smoothed compensated voltage the charger steps are measured against.
+    float _cvStartPercent;            ///< State of charge at the start of the constant-voltage phase, or < 0 before it.
+
+    /**
+     * @brief Maps an open-circuit voltage to a state of charge by linear interpolation.
+     * @param milliVolts The open-circuit voltage in mV.
+     * @return The state of charge in percent.
+     */
+    float _lookupPercent(float milliVolts) const;
+
+    /**
+     * @brief Returns the slope of the OCV table around a state of charge.
+     * @param percent The state of charge in percent.
+     * @return The slope in mV per percent.
+     */
+    float _tableSlope(float percent) const;
+
+    /**
+     * @brief Advances the state of charge by a counted change and corrects it towards the table.
+     * @param tablePercent The table lookup of the compensated voltage.
+     * @param countedPercent The change counted from the current since the previous sample.
+     */
+    void _track(float tablePercent, float countedPercent);
+
+    /**
+     * @brief Maps a state of charge to an open-circuit voltage by linear interpolation.
+     * @param percent The state of charge in percent.
+     * @return The open-circuit voltage in mV.
+     */
+    float _lookupMilliVolts(float percent) const;
+
+    /**
+     * @brief Estimates the open-circuit voltage of a sample while charging and advances the state of
+     * charge through the constant-current or the constant-voltage phase.
+     * @param measuredMilliVolts The measured voltage in mV.
+     * @param loadMilliAmps The estimated load current.
+     * @param elapsedMs Time since the previous sample.
+     * @return The open-circuit voltage estimate in mV.
+     */
+    float _updateCharging(float measuredMilliVolts, float loadMilliAmps, uint32_t elapsedMs);
+
+    /**
+     * @brief Switches between charging and discharging.
+     * @param charging The new state.
+     */
+    void _setCharging(bool charging);
+
+    /**
+     * @brief Advances the learning window and updates the learned capacity when it completes.
+     */
+    void _learn();
+};
+
+#endif // BATTERY_SOC_ESTIMATOR_H
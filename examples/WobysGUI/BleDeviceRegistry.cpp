@@ -0,0 +1,538 @@
+/**
+ * @file BleDeviceRegistry.cpp
+ * @brief Implements the BleDeviceRegistry, a fixed-capacity store of the BLE devices seen by scans.
+ *
+ * @version 1.0.0
+ * @date 2025-08-25
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "BleDeviceRegistry.h"
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+
+namespace {
+/**
+ * @brief Lock-free read attempts before a reader falls back to the spinlock.
+ */
+constexpr int SEQLOCK_READ_RETRIES = 8;
+}
+
+/**
+ * @brief Constructor. Creates an empty registry.
+ */
+BleDeviceRegistry::BleDeviceRegistry()
+  : _activePool(0),
+    _poolUsed(0),
+    _compactRequested(false),
+    _count(0),
+    _evictionCount(0),
+    _evictedHead(0),
+    _evictedCount(0),
+    _mux(portMUX_INITIALIZER_UNLOCKED),
+    _globalSeq(0) {
+  memset(_records, 0, sizeof(_records));
+  memset(_index, 0, sizeof(_index));
+  for (auto& seq : _recordSeq) seq.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Removes all devices and strings.
+ */
+void BleDeviceRegistry::clear() {
+  taskENTER_CRITICAL(&_mux);
+  _beginGlobalWrite();
+  memset(_records, 0, sizeof(_records));
+  memset(_index, 0, sizeof(_index));
+  _poolUsed = 0;
+  _compactRequested = false;
+  _count = 0;
+  _evictedHead = 0;
+  _evictedCount = 0;
+  _endGlobalWrite();
+  taskEXIT_CRITICAL(&_mux);
+}
+
+/**
+ * @brief Records an advert: adds the device or refreshes its RSSI, name and last-seen time.
+ * @param address Device address, most significant byte first.
+ * @param addressType BLE address type.
+ * @param rssi Received signal strength in dBm.
+ * @param name Advertised name, or nullptr.
+ * @param serviceUUID First advertised service UUID, or nullptr.
+ * @param nowMs Current millis().
+ * @return True if the device is reportable (new, renamed or RSSI moved noticeably). False
+ * also if the device is new and no record could be freed for it.
+ */
+bool BleDeviceRegistry::update(const uint8_t address[6], uint8_t addressType, int rssi,
+                               const char* name, const char* serviceUUID, uint32_t nowMs) {
+  taskENTER_CRITICAL(&_mux);
+
+  int slot = _findSlot(address);
+  size_t recNo;
+  Record* r;
+  if (slot >= 0) {
+    recNo = _index[slot] - 1;
+    _beginWrite(recNo);
+    r = &_records[recNo];
+    r->rssiQ4 += (int16_t)(((rssi * 16) - r->rssiQ4) / (1 << BLE_ADVERT_RSSI_EWMA_SHIFT));
+    if (abs(r->rssiQ4 / 16 - r->reportedRssi) >= BLE_ADVERT_RSSI_REPORT_DELTA_DBM) r->flags |= FLAG_DIRTY;
+  } else {
+    int freed = _allocRecord(); // Begins the write of the record.
+    if (freed < 0) {
+      taskEXIT_CRITICAL(&_mux);
+      return false;
+    }
+    recNo = (size_t)freed;
+    r = &_records[recNo];
+    memcpy(r->address, address, 6);
+    r->addressType = addressType;
+    r->flags = FLAG_USED | FLAG_NEW | FLAG_DIRTY;
+    r->rssiQ4 = (int16_t)(rssi * 16);
+    r->reportedRssi = (int16_t)rssi;
+    r->nameRef = 0;
+    r->uuidRef = 0;
+
+    size_t i = _homeSlot(address);
+    while (_index[i]) i = (i + 1) & (INDEX_SIZE - 1);
+    _index[i] = (uint8_t)(recNo + 1);
+    _count++;
+  }
+  r->lastSeenMs = nowMs;
+  if (r->flags & FLAG_LOST) r->flags = (r->flags & ~FLAG_LOST) | FLAG_DIRTY; // Back in range.
+
+  // Names are often only in scan responses; pick them up whenever they first appear.
+  if (name && *name && !r->nameRef) {
+    r->nameRef = _intern(name, sizeof(BleDeviceSnapshot::name) - 1);
+    if (r->nameRef) r->flags |= FLAG_DIRTY;
+  }
+  if (serviceUUID && *serviceUUID && !r->uuidRef) {
+    r->uuidRef = _intern(serviceUUID, sizeof(BleDeviceSnapshot::serviceUUID) - 1);
+    if (r->uuidRef) r->flags |= FLAG_DIRTY;
+  }
+  bool reportable = (r->flags & FLAG_DIRTY) != 0;
+
+  _endWrite(recNo);
+  taskEXIT_CRITICAL(&_mux);
+  return reportable;
+}
+
+/**
+ * @brief Flags devices that have not advertised for `timeoutMs` as lost and reportable.
+ * @param nowMs Current millis().
+ * @param timeoutMs Silence after which a device counts as lost.
+ * @return The number of devices newly flagged as lost.
+ */
+size_t BleDeviceRegistry::markLost(uint32_t nowMs, uint32_t timeoutMs) {
+  size_t n = 0;
+  for (size_t i = 0; i < BLE_DEVICE_REGISTRY_CAPACITY; ++i) {
+    taskENTER_CRITICAL(&_mux);
+    Record& r = _records[i];
+    if ((r.flags & (FLAG_USED | FLAG_LOST)) == FLAG_USED && (int32_t)(nowMs - r.lastSeenMs) > (int32_t)timeoutMs) {
+      _beginWrite(i);
+      r.flags |= FLAG_LOST | FLAG_DIRTY;
+      _endWrite(i);
+      n++;
+    }
+    taskEXIT_CRITICAL(&_mux);
+  }
+  return n;
+}
+
+/**
+ * @brief Copies reportable devices into `out` and marks them as reported. Evicted devices
+ * come first, so a device that was evicted and re-added is removed before it is rediscovered.
+ * @param out Destination array.
+ * @param maxCount Capacity of `out`.
+ * @return The number of devices copied.
+ */
+size_t BleDeviceRegistry::collectChanges(BleDeviceSnapshot* out, size_t maxCount) {
+  size_t n = 0;
+  taskENTER_CRITICAL(&_mux);
+  while (_evictedCount > 0 && n < maxCount) {
+    const Evicted& e = _evicted[_evictedHead];
+    BleDeviceSnapshot& snap = out[n++];
+    memset(&snap, 0, sizeof(snap));
+    memcpy(snap.address, e.address, 6);
+    snap.addressType = e.addressType;
+    snap.isRemoved = true;
+    _evictedHead = (uint8_t)((_evictedHead + 1) % BLE_DEVICE_REGISTRY_EVICTED_QUEUE);
+    _evictedCount--;
+  }
+  taskEXIT_CRITICAL(&_mux);
+
+  for (size_t i = 0; i < BLE_DEVICE_REGISTRY_CAPACITY && n < maxCount; ++i) {
+    // One record per critical section keeps the BLE host task responsive.
+    taskENTER_CRITICAL(&_mux);
+    Record& r = _records[i];
+    if ((r.flags & (FLAG_USED | FLAG_DIRTY)) == (FLAG_USED | FLAG_DIRTY)) {
+      _beginWrite(i);
+      r.reportedRssi = r.rssiQ4 / 16;
+      _toSnapshot(r, out[n++]);
+      r.flags &= ~(FLAG_DIRTY | FLAG_NEW);
+      _endWrite(i);
+    }
+    taskEXIT_CRITICAL(&_mux);
+  }
+  return n;
+}
+
+/**
+ * @brief Compacts the string pool if an update found it full or nearly full. The live entries
+ * are copied into the spare buffer outside the spinlock: until the swap, writers only append
+ * behind the extent seen at the start, so the copied entries cannot change underneath. The
+ * critical section at the end only carries over the appended entries, remaps the references
+ * and swaps the buffers.
+ * @return True if a compaction ran.
+ */
+bool BleDeviceRegistry::compactPool() {
+  if (!_compactRequested.exchange(false)) return false;
+
+  constexpr size_t MAX_REFS = BLE_DEVICE_REGISTRY_CAPACITY * 2;
+  uint16_t oldRefs[MAX_REFS];
+  uint16_t newRefs[MAX_REFS];
+
+  taskENTER_CRITICAL(&_mux);
+  const uint8_t active = _activePool.load(std::memory_order_relaxed);
+  const uint16_t usedAtStart = _poolUsed;
+  size_t refCount = 0;
+  for (const Record& r : _records) {
+    if (!(r.flags & FLAG_USED)) continue;
+    if (r.nameRef) oldRefs[refCount++] = r.nameRef;
+    if (r.uuidRef) oldRefs[refCount++] = r.uuidRef;
+  }
+  taskEXIT_CRITICAL(&_mux);
+
+  // Copy the live entries, in pool order, into the spare buffer.
+  std::sort(oldRefs, oldRefs + refCount);
+  refCount = std::unique(oldRefs, oldRefs + refCount) - oldRefs;
+  const char* from = _pools[active];
+  char* to = _pools[active ^ 1];
+  uint16_t newUsed = 0;
+  for (size_t k = 0; k < refCount; ++k) {
+    newRefs[k] = _copyEntry(from, oldRefs[k], to, newUsed);
+  }
+
+  taskENTER_CRITICAL(&_mux);
+  _beginGlobalWrite();
+  // Entries appended meanwhile move as one block behind the copied ones.
+  const uint16_t appended = _poolUsed - usedAtStart;
+  const bool appendedFits = newUsed + appended <= BLE_DEVICE_REGISTRY_POOL_BYTES;
+  if (appendedFits) memcpy(&to[newUsed], &from[usedAtStart], appended);
+  const int32_t appendedShift = (int32_t)newUsed - (int32_t)usedAtStart;
+  newUsed = appendedFits ? newUsed + appended : newUsed;
+
+  auto remap = [&](uint16_t ref) -> uint16_t {
+    if (ref == 0) return 0;
+    if (ref > usedAtStart) return appendedFits ? (uint16_t)(ref + appendedShift) : 0;
+    const uint16_t* it = std::lower_bound(oldRefs, oldRefs + refCount, ref);
+    if (it != oldRefs + refCount && *it == ref) return newRefs[it - oldRefs];
+    // Interned after the snapshot by matching an entry that was unreferenced then.
+    return _copyEntry(from, ref, to, newUsed);
+  };
+  for (Record& r : _records) {
+    if (!(r.flags & FLAG_USED)) continue;
+    r.nameRef = remap(r.nameRef);
+    r.uuidRef = remap(r.uuidRef);
+  }
+  _poolUsed = newUsed;
+  _activePool.store(active ^ 1, std::memory_order_release);
+  _endGlobalWrite();
+  taskEXIT_CRITICAL(&_mux);
+
+  DEBUG_TRACE_PRINTF("BleDeviceRegistry: Pool compacted from %u to %u bytes.\n",
+                     (unsigned)(usedAtStart + appended), (unsigned)newUsed);
+  return true;
+}
+
+/**
+ * @brief Checks whether a device is known without copying it.
+ * @param address Device address, most significant byte first.
+ * @return True if the device is in the registry.
+ */
+bool BleDeviceRegistry::contains(const uint8_t address[6]) const {
+  taskENTER_CRITICAL(&_mux);
+  bool found = _findSlot(address) >= 0;
+  taskEXIT_CRITICAL(&_mux);
+  return found;
+}
+
+/**
+ * @brief Formats an address as "aa:bb:cc:dd:ee:ff".
+ * @param address Device address, most significant byte first.
+ * @param out Destination buffer of at least 18 bytes.
+ */
+void BleDeviceRegistry::formatAddress(const uint8_t address[6], char* out) {
+  snprintf(out, 18, "%02x:%02x:%02x:%02x:%02x:%02x",
+           address[0], address[1], address[2], address[3], address[4], address[5]);
+}
+
+/**
+ * @brief Parses an address in "aa:bb:cc:dd:ee:ff" form (case-insensitive).
+ * @param text The address text.
+ * @param out Destination for the 6 address bytes.
+ * @return True if the text was a valid address.
+ */
+bool BleDeviceRegistry::parseAddress(const char* text, uint8_t out[6]) {
+  if (!text || strlen(text) != 17) return false;
+  for (int i = 0; i < 6; ++i) {
+    const char* p = text + i * 3;
+    if (!isxdigit((unsigned char)p[0]) || !isxdigit((unsigned char)p[1])) return false;
+    if (i < 5 && p[2] != ':') return false;
+    char hex[3] = { p[0], p[1], 0 };
+    out[i] = (uint8_t)strtoul(hex, nullptr, 16);
+  }
+  return true;
+}
+
+/**
+ * @brief Marks the start of a write to one record. Must be called inside the critical section.
+ * @param i Record number.
+ */
+void BleDeviceRegistry::_beginWrite(size_t i) {
+  _recordSeq[i].fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+/**
+ * @brief Marks the end of a write to one record. Must be called inside the critical section.
+ * @param i Record number.
+ */
+void BleDeviceRegistry::_endWrite(size_t i) {
+  _recordSeq[i].fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * @brief Marks the start of a write to all records. Must be called inside the critical section.
+ */
+void BleDeviceRegistry::_beginGlobalWrite() {
+  _globalSeq.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+/**
+ * @brief Marks the end of a write to all records. Must be called inside the critical section.
+ */
+void BleDeviceRegistry::_endGlobalWrite() {
+  _globalSeq.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * @brief Reads one record consistently. Retries while a writer changes this record (or all
+ * records) and falls back to the spinlock if it keeps changing.
+ * @param i Record number.
+ * @param out Destination snapshot.
+ * @return True if the record holds a device.
+ */
+bool BleDeviceRegistry::_readRecord(size_t i, BleDeviceSnapshot& out) const {
+  for (int attempt = 0; attempt < SEQLOCK_READ_RETRIES; ++attempt) {
+    uint32_t global = _globalSeq.load(std::memory_order_acquire);
+    uint32_t begin = _recordSeq[i].load(std::memory_order_acquire);
+    if ((global | begin) & 1) continue; // A writer on the other core is mid-update.
+    Record r = _records[i];
+    if (r.flags & FLAG_USED) _toSnapshot(r, out);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (_recordSeq[i].load(std::memory_order_relaxed) == begin &&
+        _globalSeq.load(std::memory_order_relaxed) == global) {
+      return (r.flags & FLAG_USED) != 0;
+    }
+  }
+
+  taskENTER_CRITICAL(&_mux);
+  bool used = (_records[i].flags & FLAG_USED) != 0;
+  if (used) _toSnapshot(_records[i], out);
+  taskEXIT_CRITICAL(&_mux);
+  return used;
+}
+
+/**
+ * @brief Fills a snapshot from a record copy.
+ * @param r The record.
+ * @param out Destination snapshot.
+ */
+void BleDeviceRegistry::_toSnapshot(const Record& r, BleDeviceSnapshot& out) const {
+  memcpy(out.address, r.address, 6);
+  out.addressType = r.addressType;
+  out.rssi = r.rssiQ4 / 16;
+  out.lastSeenMs = r.lastSeenMs;
+  out.isNew = (r.flags & FLAG_NEW) != 0;
+  out.isLost = (r.flags & FLAG_LOST) != 0;
+  out.isRemoved = false;
+  _copyString(r.nameRef, out.name, sizeof(out.name));
+  _copyString(r.uuidRef, out.serviceUUID, sizeof(out.serviceUUID));
+}
+
+/**
+ * @brief Copies a pooled string. A reference read during a concurrent write may be stale,
+ * so all offsets are bounds-checked; the seqlock discards such copies afterwards.
+ * @param ref Pool reference.
+ * @param out Destination buffer.
+ * @param outSize Size of `out`.
+ */
+void BleDeviceRegistry::_copyString(uint16_t ref, char* out, size_t outSize) const {
+  out[0] = '\0';
+  if (ref == 0 || ref >= BLE_DEVICE_REGISTRY_POOL_BYTES) return;
+  const char* pool = _pool();
+  size_t offset = ref - 1;
+  size_t len = (uint8_t)pool[offset];
+  if (offset + 1 + len > BLE_DEVICE_REGISTRY_POOL_BYTES) return;
+  if (len >= outSize) len = outSize - 1;
+  memcpy(out, &pool[offset + 1], len);
+  out[len] = '\0';
+}
+
+/**
+ * @brief Returns the home index slot of an address (Fibonacci hashing).
+ * @param address Device address.
+ * @return The index slot.
+ */
+size_t BleDeviceRegistry::_homeSlot(const uint8_t address[6]) {
+  uint64_t key = 0;
+  for (int i = 0; i < 6; ++i) key = (key << 8) | address[i];
+  return (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & (INDEX_SIZE - 1);
+}
+
+/**
+ * @brief Finds the index slot that refers to an address.
+ * @param address Device address.
+ * @return The index slot, or -1 if the device is unknown.
+ */
+int BleDeviceRegistry::_findSlot(const uint8_t address[6]) const {
+  size_t i = _homeSlot(address);
+  for (size_t probe = 0; probe < INDEX_SIZE; ++probe, i = (i + 1) & (INDEX_SIZE - 1)) {
+    uint8_t ref = _index[i];
+    if (!ref) return -1;
+    if (memcmp(_records[ref - 1].address, address, 6) == 0) return (int)i;
+  }
+  return -1;
+}
+
+/**
+ * @brief Removes an index slot, shifting back the entries of its probe chain so that
+ * lookups never need tombstones.
+ * @param slot The index slot to remove.
+ */
+void BleDeviceRegistry::_eraseSlot(size_t slot) {
+  const size_t mask = INDEX_SIZE - 1;
+  size_t hole = slot;
+  _index[hole] = 0;
+  for (size_t j = (hole + 1) & mask; _index[j]; j = (j + 1) & mask) {
+    size_t home = _homeSlot(_records[_index[j] - 1].address);
+    if (((j - home) & mask) >= ((j - hole) & mask)) {
+      _index[hole] = _index[j];
+      _index[j] = 0;
+      hole = j;
+    }
+  }
+}
+
+/**
+ * @brief Picks a free record, evicting the least recently seen device if necessary, and
+ * begins the write of that record. A victim that was already reported has a row in the UI,
+ * so it is queued for a removal event; if that queue is full, nothing is evicted.
+ * @return The record number, or -1 if the victim's removal cannot be queued.
+ */
+int BleDeviceRegistry::_allocRecord() {
+  size_t oldest = 0;
+  uint32_t oldestAge = 0;
+  uint32_t now = _records[0].lastSeenMs;
+  for (size_t i = 0; i < BLE_DEVICE_REGISTRY_CAPACITY; ++i) {
+    if (!(_records[i].flags & FLAG_USED)) {
+      _beginWrite(i);
+      return (int)i;
+    }
+    if ((int32_t)(_records[i].lastSeenMs - now) > 0) now = _records[i].lastSeenMs;
+  }
+  for (size_t i = 0; i < BLE_DEVICE_REGISTRY_CAPACITY; ++i) {
+    uint32_t age = now - _records[i].lastSeenMs;
+    if (age >= oldestAge) {
+      oldestAge = age;
+      oldest = i;
+    }
+  }
+
+  Record& victim = _records[oldest];
+  if (!(victim.flags & FLAG_NEW)) {
+    if (_evictedCount >= BLE_DEVICE_REGISTRY_EVICTED_QUEUE) return -1;
+    Evicted& e = _evicted[(_evictedHead + _evictedCount++) % BLE_DEVICE_REGISTRY_EVICTED_QUEUE];
+    memcpy(e.address, victim.address, 6);
+    e.addressType = victim.addressType;
+  }
+
+  _beginWrite(oldest);
+  int slot = _findSlot(victim.address);
+  if (slot >= 0) _eraseSlot((size_t)slot);
+  victim.flags = 0;
+  _count--;
+  _evictionCount++;
+  return (int)oldest;
+}
+
+/**
+ * @brief Interns a string in the pool. Identical strings share one entry. A full (or nearly
+ * full) pool is only flagged here; `compactPool()` runs later outside the critical section.
+ * @param text The string.
+ * @param maxLen Maximum stored length; longer strings are truncated.
+ * @return The pool reference, or 0 if the pool is full (a compaction is then requested).
+ */
+uint16_t BleDeviceRegistry::_intern(const char* text, size_t maxLen) {
+  size_t len = strnlen(text, maxLen);
+  if (len > 255) len = 255;
+
+  char* pool = _pool();
+  for (size_t offset = 0; offset < _poolUsed; offset += 2 + (uint8_t)pool[offset]) {
+    if ((uint8_t)pool[offset] == len && memcmp(&pool[offset + 1], text, len) == 0) {
+      return (uint16_t)(offset + 1);
+    }
+  }
+
+  if (_poolUsed + len + 2 > BLE_DEVICE_REGISTRY_POOL_BYTES) {
+    _compactRequested = true; // The record picks the string up on a later advert.
+    return 0;
+  }
+  size_t offset = _poolUsed;
+  pool[offset] = (char)len;
+  memcpy(&pool[offset + 1], text, len);
+  pool[offset + 1 + len] = '\0';
+  _poolUsed += len + 2;
+  if (_poolUsed > BLE_DEVICE_REGISTRY_POOL_BYTES * 3 / 4) _compactRequested = true;
+  return (uint16_t)(offset + 1);
+}
+
+/**
+ * @brief Copies one pool entry to the end of another buffer.
+ * @param from Source buffer.
+ * @param ref Pool reference of the entry in `from`.
+ * @param to Destination buffer.
+ * @param toUsed Bytes used in `to`; advanced by the entry size.
+ * @return The reference of the copy in `to`, or 0 if it does not fit.
+ */
+uint16_t BleDeviceRegistry::_copyEntry(const char* from, uint16_t ref, char* to, uint16_t& toUsed) {
+  const size_t entrySize = 2 + (uint8_t)from[ref - 1];
+  if (toUsed + entrySize > BLE_DEVICE_REGISTRY_POOL_BYTES) return 0;
+  memcpy(&to[toUsed], &from[ref - 1], entrySize);
+  uint16_t newRef = (uint16_t)(toUsed + 1);
+  toUsed += entrySize;
+  return newRef;
+}
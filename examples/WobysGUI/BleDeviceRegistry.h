@@ -0,0 +1,329 @@
+/**
+ * @file BleDeviceRegistry.h
+ * @brief Defines the BleDeviceRegistry, a fixed-capacity store of the BLE devices seen by scans.
+ *
+ * Devices are stored as packed records (6-byte address, smoothed RSSI, last-seen time and
+ * references into an interned string pool for names and service UUIDs), so the memory use
+ * is fixed at compile time. Writers serialize on a spinlock; readers take lock-free
+ * snapshots of single records under per-record sequence locks and never hold off the writer.
+ *
+ * @version 1.0.0
+ * @date 2025-08-25
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef BLE_DEVICE_REGISTRY_H
+#define BLE_DEVICE_REGISTRY_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+
+#include "Config.h"
+
+static_assert((BLE_DEVICE_REGISTRY_CAPACITY & (BLE_DEVICE_REGISTRY_CAPACITY - 1)) == 0 &&
+              BLE_DEVICE_REGISTRY_CAPACITY <= 128,
+              "BLE_DEVICE_REGISTRY_CAPACITY must be a power of two, at most 128");
+static_assert(BLE_DEVICE_REGISTRY_EVICTED_QUEUE > 0 && BLE_DEVICE_REGISTRY_EVICTED_QUEUE <= 255,
+              "BLE_DEVICE_REGISTRY_EVICTED_QUEUE must be between 1 and 255");
+
+/**
+ * @brief A consistent copy of one registry record, with its strings resolved.
+ */
+struct BleDeviceSnapshot {
+  uint8_t address[6];       ///< Device address, most significant byte first.
+  uint8_t addressType;      ///< BLE address type.
+  int16_t rssi;             ///< Smoothed RSSI in dBm.
+  uint32_t lastSeenMs;      ///< millis() of the last advert.
+  bool isNew;               ///< Not yet reported since it was added.
+  bool isLost;              ///< Not heard from for longer than the lost timeout.
+  bool isRemoved;           ///< Evicted from the registry; only the address fields are valid.
+  char name[32];            ///< Advertised name (empty if none, truncated).
+  char serviceUUID[40];     ///< First advertised service UUID (empty if none).
+};
+
+/**
+ * @brief Fixed-capacity registry of advertising BLE devices with LRU eviction.
+ *
+ * `update()` is called for every advert and is safe to call from the BLE host task. When the
+ * registry is full, the least recently seen device is evicted. An evicted device that was
+ * already reported is queued and reported as removed by the next `collectChanges()`; while
+ * that queue is full, new devices are not added (they are picked up by a later advert). Names and UUIDs are interned:
+ * identical strings (e.g. many devices of the same model) are stored once. When the pool
+ * fills up, `update()` only flags it; the reader task compacts it with `compactPool()` into a
+ * second buffer outside the spinlock and swaps the buffers in a short critical section.
+ *
+ * Readers (`forEach()`) copy one record at a time and retry only if a writer changed that
+ * record (or swapped the string pool) meanwhile, so reading the device list never blocks the
+ * scan callback and adverts for other devices do not force retries.
+ */
+class BleDeviceRegistry {
+public:
+  /**
+   * @brief Constructor. Creates an empty registry.
+   */
+  BleDeviceRegistry();
+
+  /**
+   * @brief Removes all devices and strings.
+   */
+  void clear();
+
+  /**
+   * @brief Records an advert: adds the device or refreshes its RSSI, name and last-seen time.
+   * @param address Device address, most significant byte first.
+   * @param addressType BLE address type.
+   * @param rssi Received signal strength in dBm.
+   * @param name Advertised name, or nullptr.
+   * @param serviceUUID First advertised service UUID, or nullptr.
+   * @param nowMs Current millis().
+   * @return True if the device is reportable (new, renamed or RSSI moved noticeably). False
+   * also if the device is new and no record could be freed for it.
+   */
+  bool update(const uint8_t address[6], uint8_t addressType, int rssi,
+              const char* name, const char* serviceUUID, uint32_t nowMs);
+
+  /**
+   * @brief Flags devices that have not advertised for `timeoutMs` as lost and reportable.
+   * A lost device that advertises again is reported as updated.
+   * @param nowMs Current millis().
+   * @param timeoutMs Silence after which a device counts as lost.
+   * @return The number of devices newly flagged as lost.
+   */
+  size_t markLost(uint32_t nowMs, uint32_t timeoutMs);
+
+  /**
+   * @brief Copies reportable devices into `out` and marks them as reported. Evicted devices
+   * come first, as snapshots with `isRemoved` set.
+   * @param out Destination array.
+   * @param maxCount Capacity of `out`.
+   * @return The number of devices copied.
+   */
+  size_t collectChanges(BleDeviceSnapshot* out, size_t maxCount);
+
+  /**
+   * @brief Compacts the string pool if an update found it full or nearly full. The live strings
+   * are copied into the spare buffer outside the spinlock; only the reference remapping and the
+   * buffer swap run in a critical section. Call from the task that reads the registry (not
+   * concurrently with `clear()`).
+   * @return True if a compaction ran.
+   */
+  bool compactPool();
+
+  /**
+   * @brief Checks whether a device is known without copying it.
+   * @param address Device address, most significant byte first.
+   * @return True if the device is in the registry.
+   */
+  bool contains(const uint8_t address[6]) const;
+
+  /**
+   * @brief Calls `fn` with a snapshot of every device. Lock-free; devices added during
+   * the iteration may or may not be visited.
+   * @param fn Callable taking `const BleDeviceSnapshot&`.
+   */
+  template <typename Fn>
+  void forEach(Fn&& fn) const {
+    BleDeviceSnapshot snap;
+    for (size_t i = 0; i < BLE_DEVICE_REGISTRY_CAPACITY; ++i) {
+      if (_readRecord(i, snap)) fn(snap);
+    }
+  }
+
+  /**
+   * @brief Returns the number of devices in the registry.
+   * @return The device count.
+   */
+  size_t size() const { return _count; }
+
+  /**
+   * @brief Returns the number of devices evicted to make room for new ones.
+   * @return The eviction count.
+   */
+  uint32_t getEvictionCount() const { return _evictionCount; }
+
+  /**
+   * @brief Formats an address as "aa:bb:cc:dd:ee:ff".
+   * @param address Device address, most significant byte first.
+   * @param out Destination buffer of at least 18 bytes.
+   */
+  static void formatAddress(const uint8_t address[6], char* out);
+
+  /**
+   * @brief Parses an address in "aa:bb:cc:dd:ee:ff" form (case-insensitive).
+   * @param text The address text.
+   * @param out Destination for the 6 address bytes.
+   * @return True if the text was a valid address.
+   */
+  static bool parseAddress(const char* text, uint8_t out[6]);
+
+private:
+  /**
+   * @brief One packed device record (20 bytes).
+   */
+  struct Record {
+    uint8_t address[6];     ///< Device address, most significant byte first.
+    uint8_t addressType;    ///< BLE address type.
+    uint8_t flags;          ///< FLAG_* bits.
+    int16_t rssiQ4;         ///< Smoothed RSSI in 1/16 dBm.
+    int16_t reportedRssi;   ///< RSSI at the last report.
+    uint16_t nameRef;       ///< Pool reference of the name (0 = none).
+    uint16_t uuidRef;       ///< Pool reference of the service UUID (0 = none).
+    uint32_t lastSeenMs;    ///< millis() of the last advert.
+  };
+
+  static constexpr uint8_t FLAG_USED = 0x01;    ///< Record holds a device.
+  static constexpr uint8_t FLAG_NEW = 0x02;     ///< Not reported since it was added.
+  static constexpr uint8_t FLAG_DIRTY = 0x04;   ///< Changed since the last report.
+  static constexpr uint8_t FLAG_LOST = 0x08;    ///< Silent for longer than the lost timeout.
+  static constexpr size_t INDEX_SIZE = BLE_DEVICE_REGISTRY_CAPACITY * 2; ///< Hash index slots (load <= 50%).
+
+  /**
+   * @brief A reported device that was evicted and still has to be reported as removed.
+   */
+  struct Evicted {
+    uint8_t address[6];     ///< Device address, most significant byte first.
+    uint8_t addressType;    ///< BLE address type.
+  };
+
+  Record _records[BLE_DEVICE_REGISTRY_CAPACITY]; ///< Device records.
+  uint8_t _index[INDEX_SIZE];                    ///< Open-addressed hash index: record number + 1 (0 = empty).
+  char _pools[2][BLE_DEVICE_REGISTRY_POOL_BYTES]; ///< Interned strings ([length][chars][NUL] entries); one active, one for compaction.
+  std::atomic<uint8_t> _activePool;              ///< Index of the active buffer in `_pools`.
+  uint16_t _poolUsed;                            ///< Bytes used in the active pool.
+  std::atomic<bool> _compactRequested;           ///< Set by a writer when the pool is (nearly) full.
+  size_t _count;                                 ///< Devices in the registry.
+  uint32_t _evictionCount;                       ///< Devices evicted because the registry was full.
+  Evicted _evicted[BLE_DEVICE_REGISTRY_EVICTED_QUEUE]; ///< Ring of evicted devices not yet reported as removed.
+  uint8_t _evictedHead;                          ///< Oldest entry of `_evicted`.
+  uint8_t _evictedCount;                         ///< Entries in `_evicted`.
+
+  mutable portMUX_TYPE _mux;                     ///< Serializes writers (and the reader fallback).
+  std::atomic<uint32_t> _recordSeq[BLE_DEVICE_REGISTRY_CAPACITY]; ///< Per-record sequence locks: odd while the record is written.
+  std::atomic<uint32_t> _globalSeq;              ///< Sequence lock of writes that touch every record (clear, pool swap).
+
+  /**
+   * @brief Marks the start of a write to one record. Must be called inside the critical section.
+   * @param i Record number.
+   */
+  void _beginWrite(size_t i);
+
+  /**
+   * @brief Marks the end of a write to one record. Must be called inside the critical section.
+   * @param i Record number.
+   */
+  void _endWrite(size_t i);
+
+  /**
+   * @brief Marks the start of a write to all records. Must be called inside the critical section.
+   */
+  void _beginGlobalWrite();
+
+  /**
+   * @brief Marks the end of a write to all records. Must be called inside the critical section.
+   */
+  void _endGlobalWrite();
+
+  /**
+   * @brief Returns the active string pool.
+   * @return The active buffer of `_pools`.
+   */
+  char* _pool() { return _pools[_activePool.load(std::memory_order_acquire)]; }
+
+  /**
+   * @brief Returns the active string pool.
+   * @return The active buffer of `_pools`.
+   */
+  const char* _pool() const { return _pools[_activePool.load(std::memory_order_acquire)]; }
+
+  /**
+   * @brief Reads one record consistently.
+   * @param i Record number.
+   * @param out Destination snapshot.
+   * @return True if the record holds a device.
+   */
+  bool _readRecord(size_t i, BleDeviceSnapshot& out) const;
+
+  /**
+   * @brief Fills a snapshot from a record copy.
+   * @param r The record.
+   * @param out Destination snapshot.
+   */
+  void _toSnapshot(const Record& r, BleDeviceSnapshot& out) const;
+
+  /**
+   * @brief Copies a pooled string, tolerating a torn reference.
+   * @param ref Pool reference.
+   * @param out Destination buffer.
+   * @param outSize Size of `out`.
+   */
+  void _copyString(uint16_t ref, char* out, size_t outSize) const;
+
+  /**
+   * @brief Returns the home index slot of an address.
+   * @param address Device address.
+   * @return The index slot.
+   */
+  static size_t _homeSlot(const uint8_t address[6]);
+
+  /**
+   * @brief Finds the index slot that refers to an address.
+   * @param address Device address.
+   * @return The index slot, or -1 if the device is unknown.
+   */
+  int _findSlot(const uint8_t address[6]) const;
+
+  /**
+   * @brief Removes an index slot, shifting back the entries of its probe chain.
+   * @param slot The index slot to remove.
+   */
+  void _eraseSlot(size_t slot);
+
+  /**
+   * @brief Picks a free record, evicting the least recently seen device if necessary, and
+   * begins the write of that record. A reported victim is queued for its removal event.
+   * @return The record number, or -1 if the victim's removal cannot be queued.
+   */
+  int _allocRecord();
+
+  /**
+   * @brief Interns a string in the pool.
+   * @param text The string.
+   * @param maxLen Maximum stored length; longer strings are truncated.
+   * @return The pool reference, or 0 if the pool is full (a compaction is then requested).
+   */
+  uint16_t _intern(const char* text, size_t maxLen);
+
+  /**
+   * @brief Copies one pool entry to the end of another buffer.
+   * @param from Source buffer.
+   * @param ref Pool reference of the entry in `from`.
+   * @param to Destination buffer.
+   * @param toUsed Bytes used in `to`; advanced by the entry size.
+   * @return The reference of the copy in `to`, or 0 if it does not fit.
+   */
+  static uint16_t _copyEntry(const char* from, uint16_t ref, char* to, uint16_t& toUsed);
+};
+
+#endif // BLE_DEVICE_REGISTRY_H
@@ -0,0 +1,407 @@
+/**
+ * @file BleNotifyPipeline.cpp
+ * @brief Implements the BleNotifyPipeline class, which streams GATT notifications of the connected device.
+ *
+ * @version 1.0.0
+ * @date 2025-08-26
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "BleNotifyPipeline.h"
+#include "SystemInitializer.h" // For BleNotifyPipelineConfig
+#include <esp_gap_ble_api.h>
+#include <esp_timer.h>
+
+/**
+ * @brief Constructor for the BleNotifyPipeline class.
+ * @param btManager Pointer to the BLEManager that owns the connection.
+ */
+BleNotifyPipeline::BleNotifyPipeline(BLEManager* btManager)
+  : _btManager(btManager),
+    _config(nullptr),
+    _head(0),
+    _tail(0),
+    _receivedCount(0),
+    _overflowCount(0),
+    _truncatedCount(0),
+    _deliveredCount(0),
+    _mtu(0),
+    _wasConnected(false),
+    _setupPending(false),
+    _setupTask(nullptr),
+    _setupDone(false),
+    _lastDeliveryMs(0) {
+  for (auto& sub : _subs) {
+    sub.characteristic = nullptr;
+    sub.inUse = false;
+    sub.generation = 0;
+    sub.active = false;
+  }
+  _subsMutex = xSemaphoreCreateMutex();
+  if (!_subsMutex) {
+    DEBUG_ERROR_PRINTLN("BleNotifyPipeline: ERROR - Failed to create subscription mutex!");
+  }
+}
+
+/**
+ * @brief Destructor. Waits for a running setup task and releases FreeRTOS resources.
+ */
+BleNotifyPipeline::~BleNotifyPipeline() {
+  if (_setupTask) {
+    unsigned long start = millis();
+    while (!_setupDone.load() && millis() - start < 2000) {
+      vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    if (!_setupDone.load()) {
+      DEBUG_WARN_PRINTLN("BleNotifyPipeline: Timeout waiting for setup task termination. Forcibly deleting.");
+      vTaskDelete(_setupTask);
+    }
+    _setupTask = nullptr;
+  }
+  if (_subsMutex) vSemaphoreDelete(_subsMutex);
+}
+
+/**
+ * @brief Initializes the pipeline with its configuration.
+ * @param config Connection parameters, delivery interval and setup task parameters.
+ * @return True if the pipeline is ready.
+ */
+bool BleNotifyPipeline::init(const BleNotifyPipelineConfig& config) {
+  DEBUG_INFO_PRINTLN("BleNotifyPipeline: init() starting...");
+  _config = &config;
+  if (!_btManager) {
+    DEBUG_ERROR_PRINTLN("BleNotifyPipeline: BLEManager pointer is null. Initialization aborted.");
+    return false;
+  }
+  if (!_subsMutex) {
+    DEBUG_ERROR_PRINTLN("BleNotifyPipeline: Subscription mutex missing. Initialization aborted.");
+    return false;
+  }
+  _lastDeliveryMs = millis();
+  DEBUG_INFO_PRINTLN("BleNotifyPipeline: Initialized.");
+  return true;
+}
+
+/**
+ * @brief Detects connects/disconnects and delivers queued notifications. Call from the main loop.
+ */
+void BleNotifyPipeline::loop() {
+  if (!_config || !_btManager) return;
+
+  if (_setupTask && _setupDone.load()) {
+    _setupTask = nullptr;
+  }
+
+  bool connected = _btManager->getCurrentState() == BLEMgr_State_t::BLE_CONNECTED;
+  if (connected && !_wasConnected) {
+    _setupPending = true;
+  } else if (!connected && _wasConnected) {
+    _onDisconnected();
+  }
+  _wasConnected = connected;
+
+  if (connected) {
+    if (_setupPending && !_setupTask) _startSetup();
+    BLEClient* client = _btManager->getBLEClient();
+    if (client) _mtu = client->getMTU();
+  }
+
+  uint32_t queued = _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_relaxed);
+  unsigned long now = millis();
+  if (queued > 0 && (now - _lastDeliveryMs >= _config->deliveryIntervalMs || queued >= BLE_NOTIFY_RING_SLOTS / 2)) {
+    _lastDeliveryMs = now;
+    _deliver();
+  }
+}
+
+/**
+ * @brief Subscribes to notifications of a characteristic.
+ * @param serviceUUID UUID of the service that contains the characteristic.
+ * @param characteristicUUID UUID of the characteristic.
+ * @param callback Callback invoked on the UI task with the received notifications.
+ * @return The subscription handle, or 0 if all subscription slots are in use.
+ */
+BleSubscriptionId BleNotifyPipeline::subscribe(const std::string& serviceUUID,
+                                               const std::string& characteristicUUID,
+                                               NotifyCallback callback) {
+  if (!_subsMutex) return 0;
+
+  BleSubscriptionId id = 0;
+  xSemaphoreTake(_subsMutex, portMAX_DELAY);
+  for (size_t i = 0; i < BLE_NOTIFY_MAX_SUBSCRIPTIONS; ++i) {
+    Subscription& sub = _subs[i];
+    if (sub.inUse) continue;
+    sub.serviceUUID = BLEUUID(serviceUUID.c_str());
+    sub.characteristicUUID = BLEUUID(characteristicUUID.c_str());
+    sub.callback = callback;
+    sub.characteristic = nullptr;
+    sub.active = false;
+    sub.inUse = true;
+    sub.generation++;
+    id = (BleSubscriptionId)(i + 1);
+    break;
+  }
+  xSemaphoreGive(_subsMutex);
+
+  if (!id) {
+    DEBUG_WARN_PRINTLN("BleNotifyPipeline: No free subscription slot.");
+    return 0;
+  }
+  DEBUG_INFO_PRINTF("BleNotifyPipeline: Subscription %u added for %s.\n", id, characteristicUUID.c_str());
+  _setupPending = true; // Applied by loop() once (or while) connected.
+  return id;
+}
+
+/**
+ * @brief Removes a subscription and disables its notifications on the peer if connected.
+ * @param id The subscription handle.
+ * @return True if the subscription existed.
+ */
+bool BleNotifyPipeline::unsubscribe(BleSubscriptionId id) {
+  if (!_subsMutex || id == 0 || id > BLE_NOTIFY_MAX_SUBSCRIPTIONS) return false;
+
+  BLERemoteCharacteristic* characteristic = nullptr;
+  xSemaphoreTake(_subsMutex, portMAX_DELAY);
+  Subscription& sub = _subs[id - 1];
+  bool existed = sub.inUse;
+  if (existed) {
+    bool wasActive = sub.active.exchange(false); // The notify callback drops packets from now on.
+    if (wasActive) characteristic = sub.characteristic;
+    sub.characteristic = nullptr;
+    sub.callback = nullptr;
+    sub.inUse = false;
+    sub.generation++; // A setup task resolving this slot must not publish it.
+  }
+  xSemaphoreGive(_subsMutex);
+
+  if (characteristic && _btManager->getCurrentState() == BLEMgr_State_t::BLE_CONNECTED) {
+    characteristic->registerForNotify(nullptr); // Writes 0 to the CCCD of the peer, outside the lock.
+  }
+  return existed;
+}
+
+/**
+ * @brief Checks whether a subscription is currently receiving notifications.
+ * @param id The subscription handle.
+ * @return True if notifications are enabled on the connected peer.
+ */
+bool BleNotifyPipeline::isActive(BleSubscriptionId id) const {
+  if (id == 0 || id > BLE_NOTIFY_MAX_SUBSCRIPTIONS) return false;
+  return _subs[id - 1].active.load();
+}
+
+/**
+ * @brief Copies one notification into the ring. Runs on the Bluetooth host task and never
+ * allocates or blocks; if the ring is full the notification is counted and dropped.
+ * @param id Subscription handle.
+ * @param data Payload.
+ * @param length Payload length.
+ */
+void BleNotifyPipeline::_onNotify(BleSubscriptionId id, const uint8_t* data, size_t length) {
+  if (id == 0 || id > BLE_NOTIFY_MAX_SUBSCRIPTIONS || !_subs[id - 1].active.load(std::memory_order_relaxed)) return;
+  _receivedCount++;
+
+  uint32_t head = _head.load(std::memory_order_relaxed);
+  if (head - _tail.load(std::memory_order_acquire) >= BLE_NOTIFY_RING_SLOTS) {
+    _overflowCount++;
+    return;
+  }
+
+  BleNotifyPacket& packet = _ring[head & (BLE_NOTIFY_RING_SLOTS - 1)];
+  packet.timestampUs = (uint32_t)esp_timer_get_time();
+  packet.subscriptionId = id;
+  packet.truncated = length > BLE_NOTIFY_MAX_PAYLOAD;
+  packet.length = (uint8_t)(packet.truncated ? BLE_NOTIFY_MAX_PAYLOAD : length);
+  if (packet.truncated) _truncatedCount++;
+  if (data && packet.length) memcpy(packet.data, data, packet.length);
+
+  _head.store(head + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Delivers all queued packets. Consecutive packets of one subscription are handed
+ * over as a single run pointing into the ring; slots are released after each run.
+ */
+void BleNotifyPipeline::_deliver() {
+  uint32_t tail = _tail.load(std::memory_order_relaxed);
+  const uint32_t head = _head.load(std::memory_order_acquire);
+
+  while (tail != head) {
+    const size_t index = tail & (BLE_NOTIFY_RING_SLOTS - 1);
+    const BleSubscriptionId id = _ring[index].subscriptionId;
+    size_t run = 1;
+    // A run stops at the end of the array so that it stays contiguous.
+    while (tail + run != head && index + run < BLE_NOTIFY_RING_SLOTS &&
+           _ring[index + run].subscriptionId == id) {
+      run++;
+    }
+
+    Subscription& sub = _subs[id - 1];
+    if (sub.inUse && sub.callback) {
+      sub.callback(&_ring[index], run);
+    }
+    _deliveredCount += run;
+    tail += run;
+    _tail.store(tail, std::memory_order_release);
+  }
+}
+
+/**
+ * @brief Starts the setup task if none is running.
+ */
+void BleNotifyPipeline::_startSetup() {
+  if (_setupTask) return;
+  _setupPending = false;
+  _setupDone = false;
+  BaseType_t rc = xTaskCreatePinnedToCore(
+    _setupTaskFn,
+    "BleNotifySetup",
+    _config->setupTaskStackSize,
+    this,
+    _config->setupTaskPriority,
+    &_setupTask,
+    _config->setupTaskCore);
+  if (rc != pdPASS) {
+    _setupTask = nullptr;
+    _setupPending = true; // Retry on the next loop().
+    DEBUG_WARN_PRINTLN("BleNotifyPipeline: Failed to create setup task.");
+  }
+}
+
+/**
+ * @brief Forgets the remote characteristics after a disconnect. Queued packets are still
+ * delivered; the subscriptions are re-applied on the next connection.
+ */
+void BleNotifyPipeline::_onDisconnected() {
+  DEBUG_INFO_PRINTLN("BleNotifyPipeline: Disconnected, subscriptions suspended.");
+  xSemaphoreTake(_subsMutex, portMAX_DELAY);
+  for (auto& sub : _subs) {
+    sub.active = false;
+    sub.characteristic = nullptr; // Owned by the BLEClient, invalid after disconnect.
+    sub.generation++;
+  }
+  xSemaphoreGive(_subsMutex);
+  _mtu = 0;
+  _setupPending = false;
+}
+
+/**
+ * @brief Requests MTU and connection parameters, then enables the pending subscriptions.
+ * Runs on the setup task.
+ */
+void BleNotifyPipeline::_applySubscriptions() {
+  BLEClient* client = _btManager->getBLEClient();
+  if (!client || !client->isConnected()) {
+    DEBUG_WARN_PRINTLN("BleNotifyPipeline: Setup skipped, client not connected.");
+    return;
+  }
+
+  // Larger notifications and a short connection interval raise the achievable notify rate.
+  if (client->getMTU() < _config->preferredMtu && !client->setMTU(_config->preferredMtu)) {
+    DEBUG_WARN_PRINTF("BleNotifyPipeline: MTU request (%u) failed.\n", _config->preferredMtu);
+  }
+  esp_ble_conn_update_params_t params = {};
+  memcpy(params.bda, *client->getPeerAddress().getNative(), sizeof(esp_bd_addr_t));
+  params.min_int = _config->connIntervalMin;
+  params.max_int = _config->connIntervalMax;
+  params.latency = _config->slaveLatency;
+  params.timeout = _config->supervisionTimeout;
+  esp_err_t err = esp_ble_gap_update_conn_params(&params);
+  if (err != ESP_OK) {
+    DEBUG_WARN_PRINTF("BleNotifyPipeline: Connection parameter update failed (%d).\n", (int)err);
+  }
+
+  // Snapshot the pending slots; the GATT calls below block on the peer and run without the lock
+  // so that unsubscribe() and the disconnect handling on the UI task never wait for them.
+  struct Pending {
+    size_t index;
+    uint32_t generation;
+    BLEUUID serviceUUID;
+    BLEUUID characteristicUUID;
+  };
+  Pending pending[BLE_NOTIFY_MAX_SUBSCRIPTIONS];
+  size_t pendingCount = 0;
+  xSemaphoreTake(_subsMutex, portMAX_DELAY);
+  for (size_t i = 0; i < BLE_NOTIFY_MAX_SUBSCRIPTIONS; ++i) {
+    const Subscription& sub = _subs[i];
+    if (!sub.inUse || sub.active.load()) continue;
+    pending[pendingCount++] = {i, sub.generation, sub.serviceUUID, sub.characteristicUUID};
+  }
+  xSemaphoreGive(_subsMutex);
+
+  for (size_t p = 0; p < pendingCount; ++p) {
+    Pending& entry = pending[p];
+    if (!client->isConnected()) return;
+
+    BLERemoteService* service = client->getService(entry.serviceUUID);
+    if (!service) {
+      DEBUG_WARN_PRINTF("BleNotifyPipeline: Service %s not found.\n", entry.serviceUUID.toString().c_str());
+      continue;
+    }
+    BLERemoteCharacteristic* characteristic = service->getCharacteristic(entry.characteristicUUID);
+    if (!characteristic || !characteristic->canNotify()) {
+      DEBUG_WARN_PRINTF("BleNotifyPipeline: Characteristic %s not found or cannot notify.\n",
+                        entry.characteristicUUID.toString().c_str());
+      continue;
+    }
+
+    // Publish before enabling, so the first notification is not dropped.
+    const BleSubscriptionId id = (BleSubscriptionId)(entry.index + 1);
+    Subscription& sub = _subs[entry.index];
+    bool published = false;
+    xSemaphoreTake(_subsMutex, portMAX_DELAY);
+    if (sub.inUse && sub.generation == entry.generation && !sub.active.load()) {
+      sub.characteristic = characteristic;
+      sub.active = true;
+      published = true;
+    }
+    xSemaphoreGive(_subsMutex);
+    if (!published) continue; // Unsubscribed or disconnected while resolving.
+
+    characteristic->registerForNotify(
+      [this, id](BLERemoteCharacteristic*, uint8_t* data, size_t length, bool) {
+        this->_onNotify(id, data, length);
+      });
+
+    // An unsubscribe that ran during the CCCD write may have been overtaken by it; undo it here.
+    xSemaphoreTake(_subsMutex, portMAX_DELAY);
+    bool stale = sub.generation != entry.generation;
+    xSemaphoreGive(_subsMutex);
+    if (stale) {
+      if (client->isConnected()) characteristic->registerForNotify(nullptr);
+      continue;
+    }
+    DEBUG_INFO_PRINTF("BleNotifyPipeline: Subscription %u active.\n", id);
+  }
+}
+
+/**
+ * @brief Entry point of the setup task. Applies the subscriptions once and exits.
+ * @param pvParameters Pointer to the BleNotifyPipeline instance.
+ */
+void BleNotifyPipeline::_setupTaskFn(void* pvParameters) {
+  BleNotifyPipeline* self = static_cast<BleNotifyPipeline*>(pvParameters);
+  self->_applySubscriptions();
+  self->_setupDone = true;
+  vTaskDelete(NULL);
+}
@@ -0,0 +1,252 @@
+/**
+ * @file BleNotifyPipeline.h
+ * @brief Defines the BleNotifyPipeline class, which streams GATT notifications of the connected device.
+ *
+ * Application code subscribes to characteristics by service and characteristic UUID. When the
+ * BLEManager connects, the pipeline negotiates a larger MTU and a short connection interval and
+ * enables the notifications. Notifications are copied into a lock-free single-producer /
+ * single-consumer ring buffer on the Bluetooth host task and delivered in batches on the UI task.
+ *
+ * @version 1.0.0
+ * @date 2025-08-26
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef BLE_NOTIFY_PIPELINE_H
+#define BLE_NOTIFY_PIPELINE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <functional>
+#include <string>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+
+#include <BLEClient.h>
+#include <BLERemoteService.h>
+#include <BLERemoteCharacteristic.h>
+
+#include "Config.h"
+#include "BLEManager.h"
+
+static_assert((BLE_NOTIFY_RING_SLOTS & (BLE_NOTIFY_RING_SLOTS - 1)) == 0,
+              "BLE_NOTIFY_RING_SLOTS must be a power of two");
+static_assert(BLE_NOTIFY_MAX_PAYLOAD <= 255, "BLE_NOTIFY_MAX_PAYLOAD must fit in one byte");
+
+// Forward declaration for configuration struct (defined in SystemInitializer.h)
+struct BleNotifyPipelineConfig;
+
+/**
+ * @brief Handle of a characteristic subscription (0 = invalid).
+ */
+using BleSubscriptionId = uint8_t;
+
+/**
+ * @brief One received notification, stored in place in the ring buffer.
+ */
+struct BleNotifyPacket {
+  uint32_t timestampUs;                  ///< Receive time (esp_timer microseconds, truncated).
+  BleSubscriptionId subscriptionId;      ///< Subscription the notification belongs to.
+  uint8_t length;                        ///< Stored payload length.
+  bool truncated;                        ///< True if the payload was longer than `BLE_NOTIFY_MAX_PAYLOAD`.
+  uint8_t data[BLE_NOTIFY_MAX_PAYLOAD];  ///< Payload bytes.
+};
+
+/**
+ * @brief Streams GATT notifications from the device connected by the BLEManager.
+ *
+ * Subscriptions persist across connections: whenever the BLEManager reaches the connected state,
+ * a short-lived setup task requests the MTU and connection parameters, discovers the subscribed
+ * characteristics and enables their notifications. The setup runs off the UI task because GATT
+ * discovery blocks until the peer answers.
+ *
+ * The notification callback runs on the Bluetooth host task and only copies the payload into the
+ * next free ring slot; it never allocates or blocks. If the ring is full the notification is
+ * dropped and counted. `loop()` delivers the queued packets to the subscription callbacks as
+ * contiguous runs that point directly into the ring, at most every `deliveryIntervalMs` (or
+ * earlier when the ring is half full).
+ */
+class BleNotifyPipeline {
+public:
+  /**
+   * @brief Callback type for delivered notifications.
+   * @param packets Pointer to the first packet of the run (valid only during the call).
+   * @param count Number of consecutive packets of the same subscription.
+   */
+  using NotifyCallback = std::function<void(const BleNotifyPacket* packets, size_t count)>;
+
+  /**
+   * @brief Constructor for the BleNotifyPipeline class.
+   * @param btManager Pointer to the BLEManager that owns the connection.
+   */
+  BleNotifyPipeline(BLEManager* btManager);
+
+  /**
+   * @brief Destructor. Waits for a running setup task and releases FreeRTOS resources.
+   */
+  ~BleNotifyPipeline();
+
+  /**
+   * @brief Initializes the pipeline with its configuration.
+   * @param config Connection parameters, delivery interval and setup task parameters.
+   * @return True if the pipeline is ready.
+   */
+  bool init(const BleNotifyPipelineConfig& config);
+
+  /**
+   * @brief Detects connects/disconnects and delivers queued notifications. Call from the main loop.
+   */
+  void loop();
+
+  /**
+   * @brief Subscribes to notifications of a characteristic. If a device is connected, the
+   * subscription is applied right away; otherwise on the next connection.
+   * @param serviceUUID UUID of the service that contains the characteristic.
+   * @param characteristicUUID UUID of the characteristic.
+   * @param callback Callback invoked on the UI task with the received notifications.
+   * @return The subscription handle, or 0 if all subscription slots are in use.
+   */
+  BleSubscriptionId subscribe(const std::string& serviceUUID,
+                              const std::string& characteristicUUID,
+                              NotifyCallback callback);
+
+  /**
+   * @brief Removes a subscription and disables its notifications on the peer if connected.
+   * @param id The subscription handle.
+   * @return True if the subscription existed.
+   */
+  bool unsubscribe(BleSubscriptionId id);
+
+  /**
+   * @brief Checks whether a subscription is currently receiving notifications.
+   * @param id The subscription handle.
+   * @return True if notifications are enabled on the connected peer.
+   */
+  bool isActive(BleSubscriptionId id) const;
+
+  /**
+   * @brief Returns the ATT MTU negotiated for the current connection.
+   * @return The MTU, or 0 if not connected.
+   */
+  uint16_t getMtu() const { return _mtu.load(); }
+
+  /**
+   * @brief Returns the number of notifications received since init.
+   * @return The received count.
+   */
+  uint32_t getReceivedCount() const { return _receivedCount.load(); }
+
+  /**
+   * @brief Returns the number of notifications dropped because the ring was full.
+   * @return The overflow count.
+   */
+  uint32_t getOverflowCount() const { return _overflowCount.load(); }
+
+  /**
+   * @brief Returns the number of notifications whose payload was truncated.
+   * @return The truncation count.
+   */
+  uint32_t getTruncatedCount() const { return _truncatedCount.load(); }
+
+  /**
+   * @brief Returns the number of notifications delivered to callbacks since init.
+   * @return The delivered count.
+   */
+  uint32_t getDeliveredCount() const { return _deliveredCount; }
+
+private:
+  /**
+   * @brief One characteristic subscription.
+   */
+  struct Subscription {
+    BLEUUID serviceUUID;                       ///< Service UUID.
+    BLEUUID characteristicUUID;                ///< Characteristic UUID.
+    NotifyCallback callback;                   ///< UI-task callback.
+    BLERemoteCharacteristic* characteristic;   ///< Remote characteristic while subscribed (owned by BLEClient).
+    bool inUse;                                ///< Slot holds a subscription.
+    uint32_t generation;                       ///< Bumped on subscribe, unsubscribe and disconnect.
+    std::atomic<bool> active;                  ///< Notifications enabled on the connected peer.
+  };
+
+  BLEManager* _btManager;                            ///< Pointer to the BLEManager (not owned).
+  const BleNotifyPipelineConfig* _config;            ///< Pointer to the configuration (owned by SystemInitializer).
+
+  Subscription _subs[BLE_NOTIFY_MAX_SUBSCRIPTIONS];  ///< Subscription slots (id = index + 1).
+  SemaphoreHandle_t _subsMutex;                      ///< Guards `_subs`; never held across GATT operations.
+
+  BleNotifyPacket _ring[BLE_NOTIFY_RING_SLOTS];      ///< Notification ring buffer.
+  std::atomic<uint32_t> _head;                       ///< Next slot written by the Bluetooth host task.
+  std::atomic<uint32_t> _tail;                       ///< Next slot read by the UI task.
+
+  std::atomic<uint32_t> _receivedCount;              ///< Notifications received.
+  std::atomic<uint32_t> _overflowCount;              ///< Notifications dropped because the ring was full.
+  std::atomic<uint32_t> _truncatedCount;             ///< Notifications truncated to `BLE_NOTIFY_MAX_PAYLOAD`.
+  uint32_t _deliveredCount;                          ///< Notifications delivered to callbacks.
+  std::atomic<uint16_t> _mtu;                        ///< Negotiated MTU (0 if not connected).
+
+  bool _wasConnected;                                ///< Connection state seen by the previous `loop()`.
+  bool _setupPending;                                ///< Subscriptions need to be applied on the connected peer.
+  TaskHandle_t _setupTask;                           ///< Handle of the running setup task (nullptr if none).
+  std::atomic<bool> _setupDone;                      ///< Set by the setup task when it finishes.
+  unsigned long _lastDeliveryMs;                     ///< millis() of the last delivery.
+
+  /**
+   * @brief Copies one notification into the ring. Runs on the Bluetooth host task.
+   * @param id Subscription handle.
+   * @param data Payload.
+   * @param length Payload length.
+   */
+  void _onNotify(BleSubscriptionId id, const uint8_t* data, size_t length);
+
+  /**
+   * @brief Delivers all queued packets as per-subscription runs.
+   */
+  void _deliver();
+
+  /**
+   * @brief Starts the setup task if none is running.
+   */
+  void _startSetup();
+
+  /**
+   * @brief Forgets the remote characteristics after a disconnect.
+   */
+  void _onDisconnected();
+
+  /**
+   * @brief Requests MTU and connection parameters, then enables the pending subscriptions.
+   * Runs on the setup task.
+   */
+  void _applySubscriptions();
+
+  /**
+   * @brief Entry point of the setup task.
+   * @param pvParameters Pointer to the BleNotifyPipeline instance.
+   */
+  static void _setupTaskFn(void* pvParameters);
+};
+
+#endif // BLE_NOTIFY_PIPELINE_H
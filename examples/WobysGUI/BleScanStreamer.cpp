@@ -0,0 +1,393 @@
+/**
+ * @file BleScanStreamer.cpp
+ * @brief Implements the BleScanStreamer class for de-duplicated, rate-limited BLE scanning.
+ *
+ * @version 1.0.0
+ * @date 2025-08-24
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "BleScanStreamer.h"
+#include "GlobalSystemEvents.h" // For g_displayLocalizedMessage (demo limit)
+#include <algorithm>
+#include <cstring>
+
+BleScanStreamer* BleScanStreamer::_activeInstance = nullptr;
+
+namespace {
+
+// AD types (Bluetooth Core Supplement, part A, 1.1 - 1.3).
+constexpr uint8_t AD_TYPE_UUID16_INCOMPLETE = 0x02;
+constexpr uint8_t AD_TYPE_UUID16_COMPLETE = 0x03;
+constexpr uint8_t AD_TYPE_UUID32_INCOMPLETE = 0x04;
+constexpr uint8_t AD_TYPE_UUID32_COMPLETE = 0x05;
+constexpr uint8_t AD_TYPE_UUID128_INCOMPLETE = 0x06;
+constexpr uint8_t AD_TYPE_UUID128_COMPLETE = 0x07;
+constexpr uint8_t AD_TYPE_NAME_SHORT = 0x08;
+constexpr uint8_t AD_TYPE_NAME_COMPLETE = 0x09;
+
+/**
+ * @brief Formats a little-endian UUID from an advert the way `BLEUUID::toString()` does
+ * (16- and 32-bit UUIDs expanded onto the Bluetooth base UUID).
+ * @param data The UUID bytes as advertised (least significant byte first).
+ * @param size 2, 4 or 16.
+ * @param out Buffer of at least 37 characters.
+ */
+void formatAdvertUuid(const uint8_t* data, size_t size, char* out) {
+  static const char* const HEX = "0123456789abcdef";
+  uint8_t be[16] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00,
+                     0x80, 0x00, 0x00, 0x80, 0x5f, 0x9b, 0x34, 0xfb };
+  if (size == 16) {
+    for (size_t i = 0; i < 16; ++i) be[i] = data[15 - i];
+  } else {
+    for (size_t i = 0; i < size; ++i) be[3 - i] = data[i];
+  }
+  size_t pos = 0;
+  for (size_t i = 0; i < 16; ++i) {
+    if (i == 4 || i == 6 || i == 8 || i == 10) out[pos++] = '-';
+    out[pos++] = HEX[be[i] >> 4];
+    out[pos++] = HEX[be[i] & 0x0F];
+  }
+  out[pos] = '\0';
+}
+
+} // namespace
+
+/**
+ * @brief Called by the BLE stack for every received advert. The scanner is set up not to parse
+ * adverts, so the name and first service UUID are read from the raw AD structures straight into
+ * stack buffers, so this parsing builds no String, std::string or vector. The BLE stack has
+ * already allocated the advertised-device object (and its payload) before this callback runs.
+ * @param advertisedDevice The advertised device.
+ */
+void BleScanStreamer::AdvertCallbacks::onResult(BLEAdvertisedDevice advertisedDevice) {
+  if (!_owner) return;
+
+  const uint8_t* address = *advertisedDevice.getAddress().getNative();
+  const uint8_t* payload = advertisedDevice.getPayload();
+  const size_t length = advertisedDevice.getPayloadLength();
+
+  char name[sizeof(BleDeviceSnapshot::name)] = "";
+  char uuid[sizeof(BleDeviceSnapshot::serviceUUID)] = "";
+  bool completeName = false;
+
+  // Each AD structure is [length][type][data...]; a zero length ends the significant part.
+  for (size_t pos = 0; payload && pos + 1 < length;) {
+    const uint8_t fieldLength = payload[pos];
+    if (fieldLength == 0 || pos + 1 + fieldLength > length) break;
+    const uint8_t type = payload[pos + 1];
+    const uint8_t* data = &payload[pos + 2];
+    const size_t dataLength = fieldLength - 1;
+
+    if ((type == AD_TYPE_NAME_COMPLETE || (type == AD_TYPE_NAME_SHORT && !completeName)) && dataLength) {
+      const size_t n = std::min(dataLength, sizeof(name) - 1);
+      memcpy(name, data, n);
+      name[n] = '\0';
+      completeName = (type == AD_TYPE_NAME_COMPLETE);
+    } else if (!uuid[0]) {
+      if ((type == AD_TYPE_UUID16_INCOMPLETE || type == AD_TYPE_UUID16_COMPLETE) && dataLength >= 2) {
+        formatAdvertUuid(data, 2, uuid);
+      } else if ((type == AD_TYPE_UUID32_INCOMPLETE || type == AD_TYPE_UUID32_COMPLETE) && dataLength >= 4) {
+        formatAdvertUuid(data, 4, uuid);
+      } else if ((type == AD_TYPE_UUID128_INCOMPLETE || type == AD_TYPE_UUID128_COMPLETE) && dataLength >= 16) {
+        formatAdvertUuid(data, 16, uuid);
+      }
+    }
+    pos += 1 + fieldLength;
+  }
+
+  _owner->_onAdvert(address, advertisedDevice.getRSSI(), (uint8_t)advertisedDevice.getAddressType(),
+                    name[0] ? name : nullptr,
+                    uuid[0] ? uuid : nullptr);
+}
+
+/**
+ * @brief Constructor for the BleScanStreamer class.
+ * @param btManager Pointer to the BLEManager, used to check whether the radio is free.
+ */
+BleScanStreamer::BleScanStreamer(BLEManager* btManager)
+  : _btManager(btManager),
+    _callbacks(this),
+    _advertCount(0),
+    _scanEnded(false),
+    _isScanning(false),
+    _durationSec(DEFAULT_BLE_SCAN_DURATION_SEC),
+    _scanEndMs(0),
+    _lastNotifyMs(0),
+    _radioScheduler(nullptr),
+    _radioRequestId(0),
+    _awaitingRadio(false) {
+  _batch.reserve(BLE_ADVERT_MAX_BATCH);
+}
+
+/**
+ * @brief Starts a new scan, discarding the results of the previous one.
+ * @param durationSec Scan duration in seconds.
+ * @return True if the scan was started (or queued on the radio scheduler).
+ */
+bool BleScanStreamer::start(uint32_t durationSec) {
+  if (!_isRadioAvailable()) {
+    DEBUG_WARN_PRINTLN("BleScanStreamer: Radio not available (Bluetooth disabled or manager busy).");
+    return false;
+  }
+
+#ifdef DEMO_MODE
+  if (_demoScanCount >= MAX_BLE_SCANS_DEMO) {
+    DEBUG_WARN_PRINTLN("BleScanStreamer: Demo scan limit reached.");
+    if (g_displayLocalizedMessage) {
+      g_displayLocalizedMessage("DEMO_BLE_SCAN_LIMIT_REACHED", 3000, true);
+    }
+    return false;
+  }
+  _demoScanCount++;
+#endif
+
+  cancel();
+  clearResults();
+  _durationSec = durationSec > 0 ? durationSec : DEFAULT_BLE_SCAN_DURATION_SEC;
+  _isScanning = true;
+
+  if (_radioScheduler) {
+    RadioRequest request;
+    request.owner = RadioOwner::BLE;
+    request.kind = RadioOpKind::SCAN;
+    request.priority = RadioPriority::INTERACTIVE;
+    request.onStart = [this](RadioRequestId) {
+      _awaitingRadio = false;
+      if (!_isRadioAvailable() || !_beginScan()) {
+        _finish(false);
+      }
+    };
+    request.onExpired = [this](RadioRequestId) {
+      _radioRequestId = 0;
+      _awaitingRadio = false;
+      _finish(false);
+    };
+    _awaitingRadio = true;
+    _radioRequestId = _radioScheduler->submit(request);
+    return true;
+  }
+
+  if (!_beginScan()) {
+    _finish(false);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Stops an ongoing scan. No further callbacks are invoked for it.
+ */
+void BleScanStreamer::cancel() {
+  if (!_isScanning) return;
+  if (!_awaitingRadio) {
+    BLEScan* scan = BLEDevice::getScan();
+    scan->stop();
+    scan->clearResults();
+  }
+  if (_activeInstance == this) _activeInstance = nullptr;
+  if (_radioScheduler && _radioRequestId) _radioScheduler->cancel(_radioRequestId);
+  _radioRequestId = 0;
+  _awaitingRadio = false;
+  _isScanning = false;
+  DEBUG_INFO_PRINTLN("BleScanStreamer: Scan cancelled.");
+}
+
+/**
+ * @brief Delivers pending batches and detects the end of the scan. Call regularly.
+ */
+void BleScanStreamer::loop() {
+  if (!_isScanning || _awaitingRadio) return;
+
+  // Give the radio back as soon as the manager starts its own scan or connection.
+  if (!_isRadioAvailable()) {
+    BLEDevice::getScan()->stop();
+    _finish(_advertCount.load() > 0);
+    return;
+  }
+
+  unsigned long now = millis();
+  bool ended = _scanEnded.load() || (long)(now - _scanEndMs) > (long)BLE_ADVERT_SCAN_END_GUARD_MS;
+
+  if (ended || now - _lastNotifyMs >= BLE_ADVERT_NOTIFY_INTERVAL_MS) {
+    _lastNotifyMs = now;
+    _registry.compactPool(); // Deferred by the advert callback when the string pool filled up
+    _registry.markLost(now, BLE_DEVICE_LOST_TIMEOUT_MS);
+    _collectBatch();
+    if (!_batch.empty() && _onBatch) {
+      _onBatch(_batch);
+    }
+  }
+
+  if (ended) {
+    BLEDevice::getScan()->stop();
+    _finish(true);
+  }
+}
+
+/**
+ * @brief Returns the devices seen during the current (or last) scan, strongest first.
+ * @return The device list.
+ */
+std::vector<BleAdvertUpdate> BleScanStreamer::getDevices() const {
+  std::vector<BleAdvertUpdate> devices;
+  devices.reserve(_registry.size());
+  _registry.forEach([&devices](const BleDeviceSnapshot& snap) {
+    devices.push_back(_toUpdate(snap));
+  });
+  std::sort(devices.begin(), devices.end(),
+            [](const BleAdvertUpdate& a, const BleAdvertUpdate& b) { return a.rssi > b.rssi; });
+  return devices;
+}
+
+/**
+ * @brief Forgets the devices of the last scan.
+ */
+void BleScanStreamer::clearResults() {
+  _registry.clear();
+  _advertCount = 0;
+}
+
+/**
+ * @brief Checks whether the BLEManager state allows the streamer to use the radio.
+ * @return True if Bluetooth is enabled and the manager is idle.
+ */
+bool BleScanStreamer::_isRadioAvailable() const {
+  if (!_btManager || !_btManager->isEnabled()) return false;
+  switch (_btManager->getCurrentState()) {
+    case BLEMgr_State_t::BLE_DISCONNECTED:
+    case BLEMgr_State_t::BLE_CONNECTED:
+    case BLEMgr_State_t::BLE_FAILED:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/**
+ * @brief Installs the callback and starts the non-blocking scan.
+ * The BLEManager installs its own callbacks again before each of its scans.
+ * @return True if the BLE scanner accepted the scan.
+ */
+bool BleScanStreamer::_beginScan() {
+  BLEScan* scan = BLEDevice::getScan();
+  if (!scan) {
+    DEBUG_ERROR_PRINTLN("BleScanStreamer: BLE scanner not available.");
+    return false;
+  }
+
+  // Duplicates are wanted: repeated adverts only refresh the RSSI of an existing registry slot.
+  // Parsing is left to onResult(), so the scanner neither stores results nor builds strings.
+  scan->setAdvertisedDeviceCallbacks(&_callbacks, true, false);
+  scan->setActiveScan(true);
+  scan->clearResults();
+
+  _scanEnded = false;
+  _activeInstance = this;
+  _lastNotifyMs = millis();
+  _scanEndMs = _lastNotifyMs + _durationSec * 1000UL;
+
+  if (!scan->start(_durationSec, _onScanEnded, false)) {
+    _activeInstance = nullptr;
+    DEBUG_WARN_PRINTLN("BleScanStreamer: BLE scanner refused to start.");
+    return false;
+  }
+  DEBUG_INFO_PRINTF("BleScanStreamer: Scan started (%lu s).\n", (unsigned long)_durationSec);
+  return true;
+}
+
+/**
+ * @brief Scan-end callback handed to `BLEScan::start()`. Runs on the BLE host task.
+ * @param results The scanner's own result list (unused).
+ */
+void BleScanStreamer::_onScanEnded(BLEScanResults results) {
+  (void)results;
+  BleScanStreamer* self = _activeInstance;
+  if (self) self->_scanEnded = true;
+}
+
+/**
+ * @brief Records one advert in the registry. Runs on the BLE host task.
+ * @param address Device address, most significant byte first.
+ * @param rssi Received signal strength in dBm.
+ * @param addressType BLE address type.
+ * @param name Advertised name, or nullptr.
+ * @param serviceUUID First advertised service UUID, or nullptr.
+ */
+void BleScanStreamer::_onAdvert(const uint8_t address[6], int rssi, uint8_t addressType, const char* name, const char* serviceUUID) {
+  _advertCount++;
+  _registry.update(address, addressType, rssi, name, serviceUUID, millis());
+}
+
+/**
+ * @brief Collects reportable devices into `_batch` (up to `BLE_ADVERT_MAX_BATCH`).
+ * The registry copies them into a stack buffer; strings are only built afterwards.
+ */
+void BleScanStreamer::_collectBatch() {
+  _batch.clear();
+  BleDeviceSnapshot pending[BLE_ADVERT_MAX_BATCH];
+  size_t count = _registry.collectChanges(pending, BLE_ADVERT_MAX_BATCH);
+  for (size_t i = 0; i < count; ++i) {
+    _batch.push_back(_toUpdate(pending[i]));
+  }
+}
+
+/**
+ * @brief Converts a registry snapshot into a UI update.
+ * @param snap The snapshot.
+ * @return The update.
+ */
+BleAdvertUpdate BleScanStreamer::_toUpdate(const BleDeviceSnapshot& snap) {
+  char address[18];
+  BleDeviceRegistry::formatAddress(snap.address, address);
+
+  BleAdvertUpdate update;
+  update.address = address;
+  update.name = snap.name;
+  update.serviceUUID = snap.serviceUUID;
+  update.rssi = snap.rssi;
+  update.addressType = snap.addressType;
+  update.event = snap.isRemoved ? BleDeviceEvent::REMOVED
+               : snap.isLost    ? BleDeviceEvent::LOST
+               : snap.isNew     ? BleDeviceEvent::DISCOVERED
+                                : BleDeviceEvent::UPDATED;
+  return update;
+}
+
+/**
+ * @brief Ends the scan and invokes the scan-complete callback.
+ * @param success True if the scan ran.
+ */
+void BleScanStreamer::_finish(bool success) {
+  _isScanning = false;
+  if (_activeInstance == this) _activeInstance = nullptr;
+  BLEDevice::getScan()->clearResults();
+  if (_radioScheduler && _radioRequestId) _radioScheduler->complete(_radioRequestId);
+  _radioRequestId = 0;
+  DEBUG_INFO_PRINTF("BleScanStreamer: Scan finished (%s, %lu adverts, %u devices, %lu evicted).\n",
+                    success ? "ok" : "failed", (unsigned long)_advertCount.load(),
+                    (unsigned)_registry.size(), (unsigned long)_registry.getEvictionCount());
+  if (_onScanComplete) {
+    _onScanComplete(success, getDevices());
+  }
+}
@@ -0,0 +1,274 @@
+/**
+ * @file BleScanStreamer.h
+ * @brief Defines the BleScanStreamer class for de-duplicated, rate-limited BLE scanning.
+ *
+ * This class runs BLE scans for the Bluetooth settings screen with its own advertisement
+ * callback. Adverts are de-duplicated directly in the callback in a `BleDeviceRegistry`
+ * keyed by the device address, their RSSI is smoothed, and changes are handed to the UI
+ * in batches at a limited rate instead of one queue entry per advert.
+ *
+ * @version 1.0.0
+ * @date 2025-08-24
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef BLE_SCAN_STREAMER_H
+#define BLE_SCAN_STREAMER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <freertos/FreeRTOS.h>
+#include <BLEDevice.h>
+#include <BLEScan.h>
+#include <BLEAdvertisedDevice.h>
+
+#include "Config.h"
+#include "BLEManager.h"      // For BLEManager, BLEMgr_State_t and ManagedBLEDevice
+#include "RadioScheduler.h"
+#include "BleDeviceRegistry.h"
+
+/**
+ * @brief Kind of change reported for a device during a streamed scan.
+ */
+enum class BleDeviceEvent : uint8_t {
+  DISCOVERED, ///< First advert of the device in this scan.
+  UPDATED,    ///< Name, UUID or smoothed RSSI changed, or the device is back in range.
+  LOST,       ///< No advert for `BLE_DEVICE_LOST_TIMEOUT_MS`.
+  REMOVED     ///< Evicted from the full device registry; only the address is valid.
+};
+
+/**
+ * @brief A device reported to the UI by the streamer.
+ */
+struct BleAdvertUpdate {
+  std::string address;      ///< MAC address ("aa:bb:cc:dd:ee:ff").
+  std::string name;         ///< Advertised name (empty if none seen yet).
+  std::string serviceUUID;  ///< First advertised service UUID (empty if none).
+  int16_t rssi;             ///< Smoothed RSSI in dBm.
+  uint8_t addressType;      ///< BLE address type.
+  BleDeviceEvent event;     ///< What changed since the device was last reported.
+};
+
+/**
+ * @brief Runs BLE scans with callback-level de-duplication and batched UI notifications.
+ *
+ * A scan is started with `start()` and advanced from the main loop via `loop()`. The
+ * advertisement callback runs on the Bluetooth host task and only updates the fixed-size
+ * device registry; its own parsing neither allocates nor queues per advert (the BLE stack still
+ * allocates the advertised-device object before the callback runs). `loop()` collects
+ * the devices that are new, whose smoothed RSSI moved noticeably, that went silent or that
+ * were evicted from the full registry, and delivers them through the batch callback, at most
+ * once per `BLE_ADVERT_NOTIFY_INTERVAL_MS`.
+ *
+ * The streamer only uses the radio while the `BLEManager` is idle (disconnected or connected)
+ * and stops as soon as the manager starts its own scan or connection.
+ */
+class BleScanStreamer {
+public:
+  /**
+   * @brief Callback type for a batch of discovered, updated or lost devices.
+   * @param batch The devices reported since the previous batch.
+   */
+  using BatchCallback = std::function<void(const std::vector<BleAdvertUpdate>& batch)>;
+
+  /**
+   * @brief Callback type for the end of a scan.
+   * @param success True if the scan ran (even if stopped early), false if it could not run.
+   * @param devices All devices seen during the scan, strongest first.
+   */
+  using ScanCompleteCallback = std::function<void(bool success, const std::vector<BleAdvertUpdate>& devices)>;
+
+  /**
+   * @brief Constructor for the BleScanStreamer class.
+   * @param btManager Pointer to the BLEManager, used to check whether the radio is free.
+   */
+  BleScanStreamer(BLEManager* btManager);
+
+  /**
+   * @brief Starts a new scan, discarding the results of the previous one.
+   * @param durationSec Scan duration in seconds.
+   * @return True if the scan was started (or queued on the radio scheduler).
+   */
+  bool start(uint32_t durationSec = DEFAULT_BLE_SCAN_DURATION_SEC);
+
+  /**
+   * @brief Stops an ongoing scan. No further callbacks are invoked for it.
+   */
+  void cancel();
+
+  /**
+   * @brief Delivers pending batches and detects the end of the scan. Call regularly.
+   */
+  void loop();
+
+  /**
+   * @brief Checks if a scan is in progress.
+   * @return True while scanning (or waiting for the radio).
+   */
+  bool isScanning() const { return _isScanning; }
+
+  /**
+   * @brief Returns the devices seen during the current (or last) scan, strongest first.
+   * @return The device list.
+   */
+  std::vector<BleAdvertUpdate> getDevices() const;
+
+  /**
+   * @brief Forgets the devices of the last scan (e.g. when a manager scan supersedes them).
+   */
+  void clearResults();
+
+  /**
+   * @brief Returns the number of adverts received in the current (or last) scan.
+   * @return The advert count.
+   */
+  uint32_t getAdvertCount() const { return _advertCount.load(); }
+
+  /**
+   * @brief Returns the number of devices evicted from the registry to make room for new ones.
+   * @return The eviction count.
+   */
+  uint32_t getEvictedCount() const { return _registry.getEvictionCount(); }
+
+  /**
+   * @brief Gives lock-free read access to the devices of the current (or last) scan.
+   * @return The device registry.
+   */
+  const BleDeviceRegistry& getRegistry() const { return _registry; }
+
+  /**
+   * @brief Sets the callback invoked with each batch.
+   * @param cb The callback function.
+   */
+  void setOnBatchCallback(BatchCallback cb) { _onBatch = cb; }
+
+  /**
+   * @brief Sets the callback invoked when a scan ends.
+   * @param cb The callback function.
+   */
+  void setOnScanCompleteCallback(ScanCompleteCallback cb) { _onScanComplete = cb; }
+
+  /**
+   * @brief Routes scans through the radio scheduler.
+   * @param scheduler Pointer to the RadioScheduler, or nullptr to scan immediately.
+   */
+  void setRadioScheduler(RadioScheduler* scheduler) { _radioScheduler = scheduler; }
+
+private:
+  /**
+   * @brief Advertisement callback installed on the BLE scanner while the streamer scans.
+   */
+  class AdvertCallbacks : public BLEAdvertisedDeviceCallbacks {
+  public:
+    /**
+     * @brief Constructor.
+     * @param owner The streamer that receives the adverts.
+     */
+    AdvertCallbacks(BleScanStreamer* owner) : _owner(owner) {}
+    /**
+     * @brief Called by the BLE stack for every received advert. Parses the raw payload into
+     * fixed buffers; this parsing does not allocate.
+     * @param advertisedDevice The advertised device (unparsed).
+     */
+    void onResult(BLEAdvertisedDevice advertisedDevice) override;
+  private:
+    BleScanStreamer* _owner; ///< The owning streamer.
+  };
+
+  BLEManager* _btManager;                  ///< Pointer to the BLEManager (not owned).
+  AdvertCallbacks _callbacks;              ///< Callback object handed to the BLE scanner.
+
+  BleDeviceRegistry _registry;             ///< Devices seen in this scan.
+  std::atomic<uint32_t> _advertCount;      ///< Adverts received in this scan.
+  std::atomic<bool> _scanEnded;            ///< Set by the BLE stack when the scan duration elapsed.
+  static BleScanStreamer* _activeInstance; ///< Streamer that owns the running scan (for the C-style end callback).
+
+  bool _isScanning;                        ///< True while a scan is in progress.
+  uint32_t _durationSec;                   ///< Duration of the current scan.
+  unsigned long _scanEndMs;                ///< millis() when the current scan is expected to end.
+  unsigned long _lastNotifyMs;             ///< millis() of the last delivered batch.
+  std::vector<BleAdvertUpdate> _batch;     ///< Scratch buffer for the batch being delivered.
+
+  RadioScheduler* _radioScheduler;         ///< Optional radio scheduler (not owned).
+  RadioRequestId _radioRequestId;          ///< Scheduler request of the current scan (0 if none).
+  bool _awaitingRadio;                     ///< True while the scan waits for the scheduler to grant the radio.
+#ifdef DEMO_MODE
+  int _demoScanCount = 0;                  ///< Number of scans started in demo mode.
+#endif
+
+  BatchCallback _onBatch;                  ///< Callback for batches.
+  ScanCompleteCallback _onScanComplete;    ///< Callback for scan completion.
+
+  /**
+   * @brief Checks whether the BLEManager state allows the streamer to use the radio.
+   * @return True if Bluetooth is enabled and the manager is idle.
+   */
+  bool _isRadioAvailable() const;
+
+  /**
+   * @brief Installs the callback and starts the non-blocking scan.
+   * @return True if the BLE scanner accepted the scan.
+   */
+  bool _beginScan();
+
+  /**
+   * @brief Records one advert in the registry. Runs on the BLE host task.
+   * @param address Device address, most significant byte first.
+   * @param rssi Received signal strength in dBm.
+   * @param addressType BLE address type.
+   * @param name Advertised name, or nullptr.
+   * @param serviceUUID First advertised service UUID, or nullptr.
+   */
+  void _onAdvert(const uint8_t address[6], int rssi, uint8_t addressType, const char* name, const char* serviceUUID);
+
+  /**
+   * @brief Scan-end callback handed to `BLEScan::start()`. Runs on the BLE host task.
+   * @param results The scanner's own result list (unused; the streamer keeps its own table).
+   */
+  static void _onScanEnded(BLEScanResults results);
+
+  /**
+   * @brief Collects reportable devices into `_batch` (up to `BLE_ADVERT_MAX_BATCH`).
+   */
+  void _collectBatch();
+
+  /**
+   * @brief Converts a registry snapshot into a UI update.
+   * @param snap The snapshot.
+   * @return The update.
+   */
+  static BleAdvertUpdate _toUpdate(const BleDeviceSnapshot& snap);
+
+  /**
+   * @brief Ends the scan and invokes the scan-complete callback.
+   * @param success True if the scan ran.
+   */
+  void _finish(bool success);
+};
+
+#endif // BLE_SCAN_STREAMER_H
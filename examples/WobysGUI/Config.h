@@ -189,12 +189,184 @@
 // Wi-Fi Manager Defaults
 #define DEFAULT_WIFI_SCAN_DURATION_SEC 10     ///< Default duration for Wi-Fi scans in seconds.
 #define DEFAULT_WIFI_CONNECT_TIMEOUT_MS 15000 ///< Default timeout for Wi-Fi connection attempts in milliseconds.
+#define WIFI_STREAM_SCAN_MS_PER_CHANNEL 120   ///< Active scan dwell time per channel for the incremental (streamed) Wi-Fi scan.
+#define WIFI_STREAM_SCAN_CHANNEL_GUARD_MS 500 ///< Extra grace period before a single-channel scan is considered stuck.
+#define WIFI_SCAN_CACHE_TTL_MS 30000          ///< Age up to which the last scan results are reused when the Wi-Fi panel opens.
+#define WIFI_FAST_RECONNECT_TIMEOUT_MS 2500    ///< Time allowed for a directed (cached BSSID/channel) reconnect before falling back to a scan.
+#define WIFI_AP_HINT_RSSI_HISTORY 4            ///< Number of connect-time RSSI samples kept per saved network.
+#define WIFI_EVENT_TASK_STACK_SIZE 6144       ///< Stack size (bytes) of the event-driven Wi-Fi manager task.
+#define WIFI_EVENT_TASK_PRIORITY 2            ///< FreeRTOS priority of the Wi-Fi manager task.
+#define WIFI_EVENT_TASK_CORE 0                ///< Core the Wi-Fi manager task is pinned to (same core as the Wi-Fi driver).
+#define WIFI_EVENT_IDLE_POLL_MS 50            ///< Manager tick interval when no driver event arrives (timeouts, RSSI).
+#define WIFI_EVENT_QUEUE_LENGTH 16            ///< Depth of the driver event queue feeding the Wi-Fi manager task.
 #define DEFAULT_NTP_SERVER "pool.ntp.org"     ///< Default NTP server address for time synchronization.
 #define DEFAULT_GMT_OFFSET_SEC 3600           ///< Default GMT offset in seconds (e.g., +1 hour for CET).
 #define DEFAULT_DAYLIGHT_OFFSET_SEC 3600      ///< Default daylight saving offset in seconds (e.g., +1 hour for CEST).
 
 // Bluetooth Manager Defaults
 #define DEFAULT_BLE_SCAN_DURATION_SEC 5       ///< Default duration for Bluetooth Low Energy scans in seconds.
+#define BLE_DEVICE_REGISTRY_CAPACITY 128      ///< Distinct advertisers tracked by the BLE device registry (power of two, max. 128).
+#define BLE_DEVICE_REGISTRY_POOL_BYTES 2048   ///< Size of the interned name/UUID string pool of the BLE device registry.
+#define BLE_DEVICE_REGISTRY_EVICTED_QUEUE 16  ///< Evicted devices queued for removal from the UI list before new devices must wait.
+#define BLE_ADVERT_RSSI_EWMA_SHIFT 2          ///< RSSI smoothing factor as a shift (2 = each advert moves the average by 1/4).
+#define BLE_ADVERT_RSSI_REPORT_DELTA_DBM 4    ///< Smoothed RSSI change needed before a device is reported again.
+#define BLE_ADVERT_NOTIFY_INTERVAL_MS 500     ///< Minimum interval between advert batches delivered to the UI.
+#define BLE_ADVERT_MAX_BATCH 16               ///< Maximum number of devices in one advert batch.
+#define BLE_ADVERT_SCAN_END_GUARD_MS 1000     ///< Extra time after the scan duration before a streamed BLE scan is force-finished.
+#define BLE_DEVICE_LOST_TIMEOUT_MS 3000       ///< Advert silence after which a device in a streamed BLE scan is reported as lost.
+
+// BLE GATT Notification Pipeline Defaults
+#define BLE_NOTIFY_MAX_SUBSCRIPTIONS 4        ///< Maximum number of characteristics subscribed at the same time.
+#define BLE_NOTIFY_RING_SLOTS 64              ///< Notification ring buffer slots (power of two).
+#define BLE_NOTIFY_MAX_PAYLOAD 64             ///< Payload bytes stored per notification; longer ones are truncated and counted.
+#define BLE_NOTIFY_DELIVERY_INTERVAL_MS 20    ///< Interval between batched deliveries to the UI task.
+#define BLE_NOTIFY_PREFERRED_MTU 247          ///< ATT MTU requested after connecting (247 = 244-byte notifications).
+#define BLE_NOTIFY_CONN_INTERVAL_MIN 6        ///< Requested minimum connection interval (units of 1.25 ms; 6 = 7.5 ms).
+#define BLE_NOTIFY_CONN_INTERVAL_MAX 12       ///< Requested maximum connection interval (units of 1.25 ms; 12 = 15 ms).
+#define BLE_NOTIFY_SLAVE_LATENCY 0            ///< Requested peripheral latency (connection events the peer may skip).
+#define BLE_NOTIFY_SUPERVISION_TIMEOUT 400    ///< Requested supervision timeout (units of 10 ms; 400 = 4 s).
+#define BLE_NOTIFY_SETUP_TASK_STACK_SIZE 4096 ///< Stack size of the task that discovers and subscribes characteristics.
+#define BLE_NOTIFY_SETUP_TASK_PRIORITY 1      ///< FreeRTOS priority of the subscription setup task.
+#define BLE_NOTIFY_SETUP_TASK_CORE 0          ///< Core the subscription setup task is pinned to.
+
+// Radio Coexistence Scheduler Defaults (shared 2.4 GHz radio between Wi-Fi and BLE)
+#define RADIO_COEX_SLICE_PERIOD_MS 100        ///< Length of one Wi-Fi/BLE time-slice period when both radios are busy.
+#define RADIO_COEX_MIN_SLICE_MS 20            ///< Minimum share of a slice period granted to the lower-priority radio.
+#define RADIO_DEFAULT_DEADLINE_MS 3000        ///< Default time a queued radio request may wait before it expires.
+#define RADIO_TIMELINE_CAPACITY 32            ///< Number of finished radio occupancy entries kept for diagnostics.
+
+// Wi-Fi Modem Power-Save Policy Defaults
+#define WIFI_PS_TRAFFIC_HOLD_MS 3000          ///< Time the modem stays awake after reported network traffic.
+#define WIFI_PS_DEEP_IDLE_AFTER_MS 300000     ///< Screensaver time after which the modem only listens every few beacons (5 min).
+#define WIFI_PS_MIN_DWELL_MS 5000             ///< Minimum time in a mode before switching to a more economical one.
+#define WIFI_PS_BATTERY_CHECK_INTERVAL_MS 5000 ///< Interval for re-evaluating the battery voltage.
+#define WIFI_PS_LOW_BATTERY_VOLTS 3.55f       ///< Battery voltage below which an unattended modem listens every few beacons.
+#define WIFI_PS_BATTERY_HYSTERESIS_VOLTS 0.05f ///< Hysteresis for leaving the low-battery state.
+#define WIFI_PS_CURRENT_NONE_MA 95.0f         ///< Nominal average current with the modem always awake (for the statistics).
+#define WIFI_PS_CURRENT_MIN_MODEM_MA 30.0f    ///< Nominal average current in min-modem power save.
+#define WIFI_PS_CURRENT_MAX_MODEM_MA 18.0f    ///< Nominal average current in max-modem power save.
+
+// Remote UI Mirror Defaults (WebSocket screen streaming and touch injection)
+#define REMOTE_UI_ACCESS_TOKEN ""             ///< Token clients must pass as `?token=`. Empty disables the remote UI.
+#define REMOTE_UI_PORT 8081                   ///< TCP port of the remote UI server (endpoint `/mirror`).
+#define REMOTE_UI_FRAME_INTERVAL_MS 66        ///< Minimum time between two frames (~15 fps).
+#define REMOTE_UI_FRAME_BUFFER_BYTES 32768    ///< Maximum size of one encoded frame (allocated in PSRAM).
+#define REMOTE_UI_MIN_FRAME_BYTES 4096        ///< Lower bound of the throughput-based frame budget.
+#define REMOTE_UI_ACK_TIMEOUT_MS 2000         ///< Unacknowledged frames are given up (and the budget halved) after this time.
+#define REMOTE_UI_SERVER_TASK_STACK_SIZE 4096 ///< Stack size for the remote UI server task.
+#define REMOTE_UI_SERVER_TASK_PRIORITY 3      ///< FreeRTOS priority of the remote UI server task.
+#define REMOTE_UI_SERVER_TASK_CORE 0          ///< Core the remote UI server task is pinned to.
+
+// Firmware Update (OTA) Defaults
+#define OTA_CHUNK_BYTES 4096                  ///< Download/flash write chunk size (internal RAM).
+#define OTA_CHECKPOINT_BYTES 65536            ///< Download progress between two NVS checkpoints (rounded to 4 KB sectors).
+#define OTA_MANIFEST_URL ""                   ///< Update manifest ("<image url> <sha256 hex>"). Empty disables automatic updates.
+#define OTA_CHECK_INTERVAL_MS 21600000UL      ///< Interval of the manifest checks after the first one (6 h).
+#define OTA_HTTP_TIMEOUT_MS 10000             ///< Network timeout of the image download.
+#define OTA_PROGRESS_INTERVAL_MS 500          ///< Minimum time between two progress messages.
+#define OTA_CONFIRM_AFTER_MS 30000            ///< Uptime in the operational state before a new image is confirmed.
+#define OTA_RESTART_DELAY_MS 3000             ///< Time the "installed" message is shown before restarting.
+#define OTA_AUTO_RESUME true                  ///< Resume an interrupted download once Wi-Fi is connected.
+#define OTA_TASK_STACK_SIZE 8192              ///< Stack size for the download task (TLS needs the headroom).
+#define OTA_TASK_PRIORITY 1                   ///< FreeRTOS priority of the download task.
+#define OTA_TASK_CORE 0                       ///< Core the download task is pinned to.
+
+// Telemetry Publisher Defaults (MQTT, store-and-forward)
+#define TELEMETRY_BROKER_URI ""               ///< Broker URI, e.g. "mqtt://192.168.1.10:1883". Empty disables telemetry.
+#define TELEMETRY_USERNAME ""                 ///< Broker user name (empty for none).
+#define TELEMETRY_PASSWORD ""                 ///< Broker password (empty for none).
+#define TELEMETRY_TOPIC_PREFIX "wobys"        ///< Topic prefix; batches go to <prefix>/<device id>/telemetry.
+#define TELEMETRY_SAMPLE_INTERVAL_MS 10000    ///< Interval of the periodic samples (battery, RSSI, UI health).
+#define TELEMETRY_BATCH_MAX_SAMPLES 64        ///< Maximum number of samples in one batch.
+#define TELEMETRY_BATCH_INTERVAL_MS 60000     ///< Maximum age of the oldest sample before a batch is closed.
+#define TELEMETRY_RING_CAPACITY 128           ///< Samples buffered in RAM before the oldest are dropped.
+#define TELEMETRY_QUEUE_DIR "/tlm"            ///< LittleFS directory of the offline queue.
+#define TELEMETRY_MAX_QUEUED_BATCHES 256      ///< Offline queue limit; the oldest batch is discarded beyond it.
+#define TELEMETRY_DRAIN_INTERVAL_MS 250       ///< Minimum time between two queued batches when draining.
+#define TELEMETRY_ACK_TIMEOUT_MS 10000        ///< Time to wait for the broker's acknowledgement of a batch.
+#define TELEMETRY_SERVICE_INTERVAL_MS 100     ///< Period of the publisher task.
+#define TELEMETRY_TASK_STACK_SIZE 6144        ///< Stack size for the publisher task.
+#define TELEMETRY_TASK_PRIORITY 1             ///< FreeRTOS priority of the publisher task.
+#define TELEMETRY_TASK_CORE 0                 ///< Core the publisher task is pinned to.
+
+// Main Loop Scheduling
+#define MAIN_LOOP_MIN_SLEEP_MS 1              ///< Shortest sleep at the end of loop(); lets same-priority tasks run.
+#define MAIN_LOOP_MAX_SLEEP_MS 10             ///< Longest sleep at the end of loop(); bounds touch and polling latency.
+
+// Manager Task Defaults (peripheral work off the UI task; loop() runs on core 1)
+#define MANAGER_TASK_POWER_ON_TASK true       ///< Sample the battery ADC on its own task.
+#define MANAGER_TASK_POWER_STACK_SIZE 3072    ///< Stack size for the battery sampling task.
+#define MANAGER_TASK_POWER_PRIORITY 1         ///< FreeRTOS priority of the battery sampling task.
+#define MANAGER_TASK_POWER_CORE 0             ///< Core the battery sampling task is pinned to.
+#define MANAGER_TASK_RFID_ON_TASK true        ///< Poll the RFID reader on its own task.
+#define MANAGER_TASK_RFID_STACK_SIZE 4096     ///< Stack size for the RFID polling task.
+#define MANAGER_TASK_RFID_PRIORITY 2          ///< FreeRTOS priority of the RFID polling task.
+#define MANAGER_TASK_RFID_CORE 0              ///< Core the RFID polling task is pinned to.
+#define MANAGER_TASK_MAILBOX_LENGTH 4         ///< Pending results per manager before new ones are dropped.
+#define MANAGER_TASK_STATS_INTERVAL_MS 60000  ///< Interval of the per-task CPU usage report (0 disables it).
+
+// Battery ADC Defaults (continuous DMA sampling, filtered on the battery sampling task)
+#define BATTERY_ADC_CONTINUOUS_ENABLED true   ///< Sample the battery with the continuous ADC instead of bursts of analogReadMilliVolts().
+#define BATTERY_ADC_SAMPLE_FREQ_HZ 1000       ///< Conversion rate of the continuous ADC (the ESP32-S3 minimum is 611 Hz).
+#define BATTERY_ADC_FRAME_BYTES 256           ///< Size of one DMA conversion frame (multiple of 4 bytes per result).
+#define BATTERY_ADC_POOL_BYTES 1024           ///< DMA result buffer; older results are dropped when it is full.
+#define BATTERY_ADC_MEDIAN_WINDOW 64          ///< Latest samples of a batch the median is taken over.
+#define BATTERY_ADC_IIR_SHIFT 3               ///< IIR filter weight 1/2^n per batch (n=3: ~0.8 s time constant at 100 ms batches).
+#define BATTERY_ADC_PROCESS_INTERVAL_MS 100   ///< Interval at which the sampling task drains and filters the DMA results.
+
+// Battery State of Charge Defaults (see BatterySocEstimator; the battery model is in ConfigHardwareUser.h)
+#define BATTERY_SOC_FILTER_WEIGHT 0.2f        ///< Weight of a new table lookup in the smoothed state of charge (per battery check).
+#define BATTERY_SOC_LOAD_AVERAGE_MS 1200000   ///< Time constant of the load average the runtime is predicted from (spans screensaver cycles).
+#define BATTERY_SOC_LEARN_MIN_DROP_PERCENT 2.0f ///< Drop in state of charge that completes a learning window.
+#define BATTERY_SOC_LEARN_WEIGHT 0.25f        ///< Weight of a completed window in the learned capacity.
+#define BATTERY_SOC_FLAT_SLOPE_MV 5.0f        ///< OCV table slope (mV per percent) below which the table is flat: no learning, weak correction.
+#define BATTERY_SOC_FLAT_FILTER_WEIGHT 0.001f ///< Weight of a new table lookup where the table is flat (per battery check).
+#define BATTERY_SOC_CHARGE_DETECT_PERCENT 3.0f ///< Slow rise in state of charge taken as charging (a charger too weak for a voltage step, or plugged in at boot).
+#define BATTERY_SOC_CHARGE_DETECT_MV 40.0f    ///< Step of the compensated voltage taken as the charger being connected or disconnected (mV).
+#define BATTERY_SOC_CHARGE_CV_MARGIN_MV 15.0f ///< Measured voltage within this of the charge voltage is taken as the constant-voltage phase (mV).
+
+// Loop Budget Monitor Defaults
+#define LOOP_BUDGET_DEFAULT_US 2000           ///< Budget per subsystem tick unless the lap names its own.
+#define LOOP_BUDGET_REPORT_INTERVAL_MS 60000  ///< Interval of the p50/p99/max report (0 disables it).
+#define LOOP_BUDGET_OVERRUN_LOG_INTERVAL_MS 5000 ///< Minimum time between two overrun diagnostics of one subsystem.
+#define LOOP_BUDGET_ESCALATE_TO_TASK_WDT false ///< Put the loop task under the task watchdog (a hung subsystem resets the device).
+
+// CPU Frequency Governor Defaults
+#define CPU_GOVERNOR_ENABLED true             ///< Lower the CPU clock while the UI is idle.
+#define CPU_GOVERNOR_MAX_FREQ_MHZ 240         ///< Clock for touch interaction, animations and audio.
+#define CPU_GOVERNOR_MIN_FREQ_MHZ 80          ///< Idle clock. Below 80 MHz the APB clock drops too, which the Arduino SPI/UART drivers do not follow.
+#define CPU_GOVERNOR_TOUCH_HOLD_MS 1500       ///< Time the clock stays up after the last touch.
+#define CPU_GOVERNOR_RENDER_HOLD_MS 500       ///< Time the clock stays up after the last heavy frame.
+#define CPU_GOVERNOR_RENDER_BOOST_US 3000     ///< Render work (at full clock) from which a frame counts as an animation or full redraw.
+#define CPU_GOVERNOR_FRAME_MIN_US 300         ///< Shorter render passes drew nothing and are left out of the frame statistics.
+#define CPU_GOVERNOR_REPORT_INTERVAL_MS 60000 ///< Interval of the residency / frame time report (0 disables it).
+
+// Idle Sleep Defaults
+#define IDLE_SLEEP_ENABLED true               ///< Wait for the touch interrupt instead of polling while the screensaver idles.
+#define IDLE_SLEEP_LIGHT_SLEEP true           ///< Enter light sleep during the wait when the radios are off.
+#define IDLE_SLEEP_MAX_MS 500                 ///< Longest wait; keeps the screensaver clock (colon blink) updating.
+#define IDLE_SLEEP_MIN_MS 20                  ///< Shorter waits are not worth a light sleep.
+#define IDLE_SLEEP_MIN_AWAKE_MS 30            ///< Time awake after a wake, so the worker tasks (battery, RFID) get their turn.
+#define IDLE_SLEEP_SETTLE_MS 1000             ///< The backlight must have been unchanged this long (no fade running) before idling.
+#define IDLE_SLEEP_WAKE_FRAME_BUDGET_US 16667 ///< Wake-to-first-frame target (one frame at 60 Hz).
+#define IDLE_SLEEP_REPORT_INTERVAL_MS 60000   ///< Interval of the idle / wake latency report (0 disables it).
+
+// Display Sleep Defaults
+#define DISPLAY_SLEEP_ENABLED true            ///< Switch the backlight off and put the panel to sleep after a longer screensaver period.
+#define DISPLAY_SLEEP_TIMEOUT_MS 120000       ///< Screensaver time without a touch before the panel sleeps.
+#define DISPLAY_SLEEP_MAX_WAIT_MS 2000        ///< Longest idle wait while the panel sleeps; bounds the timer and RFID latency.
+#define DISPLAY_SLEEP_REPORT_INTERVAL_MS 60000 ///< Interval of the stage residency / wake latency report (0 disables it).
+
+// Coroutine Defaults
+#define CO_FRAME_POOL_BLOCKS 16               ///< Coroutine frames kept in the fixed pool (more fall back to the heap); sized for the concurrent shutdown steps.
+#define CO_FRAME_BLOCK_SIZE 384               ///< Size of one pooled frame in bytes (larger frames fall back to the heap).
+
+// Shutdown Orchestrator Defaults
+#define SHUTDOWN_MAX_STEPS 12                 ///< Maximum number of registered shutdown steps.
+#define SHUTDOWN_MAX_DEPENDENCIES 8           ///< Maximum number of dependencies of one shutdown step.
+#define SHUTDOWN_TASK_STOP_DEADLINE_MS 2000   ///< Time a worker task gets to exit before the steps after it go ahead.
+#define SHUTDOWN_POLL_INTERVAL_MS 10          ///< Interval at which a shutdown step checks whether a task has exited.
+#define SHUTDOWN_GOODBYE_HOLD_MS 1000         ///< Time the goodbye screen is shown before the power is cut.
 
 // Autoreconnect Default for Wi-Fi and BLE
 #define DEFAULT_AUTORECONNECT_INTERVAL_MS 30000 ///< Default interval in milliseconds for auto-reconnect attempts (30 seconds).
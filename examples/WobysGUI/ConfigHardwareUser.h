@@ -59,6 +59,24 @@
 #define RFID_MOSI_PIN 13 ///< Master Out Slave In (MOSI) pin for RFID module.
 #define RFID_MISO_PIN 11 ///< Master In Slave Out (MISO) pin for RFID module.
 
+/**
+ * @brief Display Control Pin Definitions.
+ *
+ * Backlight PWM and touch controller interrupt of the WT32-SC01 Plus (used by ConfigLGFXUser.h
+ * and by the IdleSleepController).
+ */
+#define BACKLIGHT_PIN 45           ///< Backlight (BL) PWM output pin.
+#define BACKLIGHT_PWM_CHANNEL 7    ///< LEDC channel driving the backlight.
+#define BACKLIGHT_PWM_FREQ 44100   ///< Backlight PWM frequency in Hz.
+#define TOUCH_INT_PIN 7            ///< FT5x06 INT output; held low while the panel is touched.
+
+/**
+ * @brief Wake Source Pin Definitions.
+ *
+ * Additional interrupt lines that wake the device from idle light sleep. Use -1 if not wired.
+ */
+#define RFID_IRQ_PIN -1 ///< MFRC522 IRQ output (active low). Not wired on the reference hardware.
+
 /**
  * @brief SD Card Module Pin Definitions.
  *
@@ -105,6 +123,33 @@ const float BATT_VOLTAGE_LEVEL_4 = 3.70f; ///< Voltage threshold for LEVEL_4 ico
 const float BATT_VOLTAGE_LEVEL_3 = 3.63f; ///< Voltage threshold for LEVEL_3 icon.
 const float BATT_VOLTAGE_LEVEL_2 = 3.45f; ///< Voltage threshold for LEVEL_2 icon.
 const float BATT_VOLTAGE_LEVEL_1 = 3.35f; ///< Voltage threshold for LEVEL_1 icon.
+const float BATT_ICON_HYSTERESIS_VOLTS = 0.03f; ///< The voltage must pass a level threshold by this much before the icon changes (Volts).
+
+/**
+ * @brief Battery model for the state of charge estimation.
+ *
+ * The OCV table maps the open-circuit (unloaded) cell voltage to the state of charge, rows
+ * {millivolts, percent} in descending order; 0 % is placed just above the automatic shutdown so the
+ * remaining runtime counts down to it. The load currents are estimates for the WT32-SC01 Plus and
+ * only need to be roughly right: the learned capacity absorbs a constant scale error. The charger
+ * values let the estimate follow a charge (constant current, then constant voltage until the cell
+ * current falls to the termination current); the charger is detected from the voltage alone.
+ */
+const uint16_t BATT_OCV_TABLE[][2] = {
+  {4180, 100}, {4100, 92}, {4030, 85}, {3970, 78}, {3920, 71}, {3870, 63},
+  {3830, 54},  {3800, 46}, {3780, 38}, {3760, 30}, {3730, 22}, {3690, 15},
+  {3640, 9},   {3570, 5},  {3450, 2},  {3300, 0}
+};
+const float BATT_NOMINAL_CAPACITY_MAH = 2000.0f;      ///< Rated capacity of the cell (mAh), the starting point of the learned capacity.
+const float BATT_INTERNAL_RESISTANCE_OHM = 0.20f;     ///< Cell, protection circuit and wiring resistance (Ohms).
+const float BATT_LOAD_BASE_MA = 85.0f;                ///< Current with the backlight off and the radios disabled (mA).
+const float BATT_LOAD_BACKLIGHT_MAX_MA = 110.0f;      ///< Additional current at full backlight (mA).
+const float BATT_LOAD_WIFI_MA = 70.0f;                ///< Average additional current with Wi-Fi enabled (mA).
+const float BATT_LOAD_BLUETOOTH_MA = 20.0f;           ///< Average additional current with Bluetooth enabled (mA).
+const float BATT_LOAD_AUDIO_MA = 30.0f;               ///< Additional current with the audio amplifier enabled (mA).
+const float BATT_CHARGE_CURRENT_MA = 500.0f;          ///< Constant-current phase of the charger, shared by the load and the cell (mA).
+const float BATT_CHARGE_VOLTAGE = 4.20f;              ///< Constant-voltage phase of the charger, as measured at the ADC (Volts).
+const float BATT_CHARGE_TERMINATION_MA = 50.0f;       ///< Cell current at which the charger ends the charge (mA).
 
 /**
  * @brief Audio Module Pin Definitions.
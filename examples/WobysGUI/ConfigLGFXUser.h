@@ -42,6 +42,8 @@
 // Required for LovyanGFX library version 1.
 #define LGFX_USE_V1
 #include <LovyanGFX.hpp> // Core LovyanGFX library.
+#include "MirrorPanel.h" // ST7796 panel with shadow framebuffer (remote UI mirror).
+#include "ConfigHardwareUser.h" // Backlight and touch pins.
 
 /**
  * @brief Display Orientation Preferences.
@@ -94,7 +96,7 @@ const int LGFX_DEFAULT_ROTATION_LANDSCAPE = 3; ///< Default to LANDSCAPE_RIGHT (
  * This section must define the LGFX class.
  */
 class LGFX : public lgfx::LGFX_Device {
-  lgfx::Panel_ST7796 _panel_instance;  ///< Panel controller instance (ST7796 for WT32-SC01-Plus).
+  MirrorPanel _panel_instance;         ///< Panel controller instance (ST7796 for WT32-SC01-Plus, with optional shadow copy for the remote UI mirror).
   lgfx::Bus_Parallel8 _bus_instance;   ///< Parallel bus instance.
   lgfx::Light_PWM _light_instance;     ///< Backlight controller instance.
   lgfx::Touch_FT5x06 _touch_instance;  ///< Touch panel controller instance (FT5x06 for WT32-SC01-Plus).
@@ -148,10 +150,10 @@ public:
     // Backlight Configuration (PWM) for display illumination.
     {
       auto cfg = _light_instance.config();
-      cfg.pin_bl = 45;      ///< Backlight (BL) pin.
+      cfg.pin_bl = BACKLIGHT_PIN; ///< Backlight (BL) pin.
       cfg.invert = false;   ///< Invert backlight control signal.
-      cfg.freq = 44100;     ///< PWM frequency (Hz).
-      cfg.pwm_channel = 7;  ///< ESP32 PWM channel (0-15).
+      cfg.freq = BACKLIGHT_PWM_FREQ; ///< PWM frequency (Hz).
+      cfg.pwm_channel = BACKLIGHT_PWM_CHANNEL; ///< ESP32 PWM channel (0-15).
 
       _light_instance.config(cfg);
       _panel_instance.setLight(&_light_instance);
@@ -162,7 +164,7 @@ public:
       auto cfg = _touch_instance.config();
       cfg.x_min = 0; cfg.x_max = TFT_WIDTH - 1;  ///< Touch X range on display.
       cfg.y_min = 0; cfg.y_max = TFT_HEIGHT - 1; ///< Touch Y range on display.
-      cfg.pin_int = 7;            ///< INT (Interrupt) pin from touch controller.
+      cfg.pin_int = TOUCH_INT_PIN; ///< INT (Interrupt) pin from touch controller.
       cfg.bus_shared = true;      ///< Bus sharing (true for I2C bus with other devices).
       cfg.offset_rotation = 0;    ///< Rotation offset for touch coordinates.
 
@@ -192,6 +194,12 @@ public:
     setRotation(static_cast<int>(DEFAULT_BOOT_ORIENTATION));
     return result;
   }
+
+  /**
+   * @brief Returns the panel, which can keep a shadow copy of the screen for the remote UI mirror.
+   * @return Pointer to the MirrorPanel instance.
+   */
+  MirrorPanel* getMirrorPanel() { return &_panel_instance; }
 };
 
 #endif // CONFIG_LGFX_USER_H
\ No newline at end of file
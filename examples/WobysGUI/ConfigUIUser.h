@@ -156,6 +156,10 @@
 // --- TimeElement ---
 #define TIMEELEMENT_VERTICAL_ADJUSTMENT_PIXELS  2   ///< Vertical adjustment for centering the time text in the status bar.
 
+// --- BatteryRuntimeElement ---
+#define BATTERY_RUNTIME_ELEMENT_WIDTH           60  ///< Width of the state of charge / remaining runtime text in the status bar.
+#define BATTERY_RUNTIME_MAX_DISPLAY_HOURS       100 ///< Longer predictions (e.g. right after boot at light load) are not shown.
+
 // --- ImageUI ---
 #define IMAGEUI_FALLBACK_TEXT_OFFSET_PIXELS     5   ///< Offset for the fallback text when an image fails to load.
 
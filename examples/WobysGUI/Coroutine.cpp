@@ -0,0 +1,307 @@
+/**
+ * @file Coroutine.cpp
+ * @brief Implements the coroutine frame pool, the CoScheduler and the CoSleep / CoEvent awaitables.
+ *
+ * @version 1.0.0
+ * @date 2025-09-03
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "Coroutine.h"
+#include <stddef.h>
+#include <stdlib.h>
+
+CoScheduler g_coScheduler;
+
+namespace {
+// Fixed pool of coroutine frames. Free blocks form a singly linked list through their first bytes.
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+alignas(max_align_t) uint8_t s_framePool[CO_FRAME_POOL_BLOCKS][CO_FRAME_BLOCK_SIZE];
+FreeBlock* s_freeList = nullptr;
+bool s_poolInitialized = false;
+size_t s_liveFrames = 0;
+uint32_t s_heapFrames = 0;
+
+inline bool isPoolBlock(const void* p) {
+  const uint8_t* b = static_cast<const uint8_t*>(p);
+  return b >= &s_framePool[0][0] && b < &s_framePool[0][0] + sizeof(s_framePool);
+}
+} // namespace
+
+// --- CoTask ---
+
+/**
+ * @brief Allocates a coroutine frame from the pool, or from the heap if it does not fit.
+ * @param size Frame size requested by the compiler.
+ * @return The frame, or nullptr if the heap is exhausted too (the task is then invalid).
+ */
+void* CoTask::promise_type::operator new(size_t size) noexcept {
+  if (!s_poolInitialized) {
+    for (size_t i = 0; i < CO_FRAME_POOL_BLOCKS; ++i) {
+      FreeBlock* block = reinterpret_cast<FreeBlock*>(s_framePool[i]);
+      block->next = s_freeList;
+      s_freeList = block;
+    }
+    s_poolInitialized = true;
+  }
+
+  void* frame = nullptr;
+  if (size <= CO_FRAME_BLOCK_SIZE && s_freeList) {
+    frame = s_freeList;
+    s_freeList = s_freeList->next;
+  } else {
+    frame = malloc(size);
+    if (!frame) {
+      DEBUG_ERROR_PRINTF("Coroutine: Failed to allocate a %u byte frame.\n", (unsigned)size);
+      return nullptr;
+    }
+    s_heapFrames++;
+    DEBUG_WARN_PRINTF("Coroutine: %u byte frame allocated from the heap (pool %s).\n",
+                      (unsigned)size, size > CO_FRAME_BLOCK_SIZE ? "block too small" : "exhausted");
+  }
+  s_liveFrames++;
+  return frame;
+}
+
+/**
+ * @brief Returns a coroutine frame to the pool or the heap.
+ * @param frame The frame to free.
+ */
+void CoTask::promise_type::operator delete(void* frame) noexcept {
+  if (!frame) return;
+  s_liveFrames--;
+  if (isPoolBlock(frame)) {
+    FreeBlock* block = static_cast<FreeBlock*>(frame);
+    block->next = s_freeList;
+    s_freeList = block;
+  } else {
+    free(frame);
+  }
+}
+
+/**
+ * @brief Destructor for the promise. Runs when the coroutine finishes and resumes the coroutine
+ * awaiting it, if any.
+ */
+CoTask::promise_type::~promise_type() {
+  if (continuation) {
+    g_coScheduler.schedule(continuation);
+  }
+}
+
+/**
+ * @brief Move assignment. Destroys the currently owned, never started frame.
+ * @param other The task to take over.
+ * @return This task.
+ */
+CoTask& CoTask::operator=(CoTask&& other) noexcept {
+  if (this != &other) {
+    if (_handle) _handle.destroy();
+    _handle = other._handle;
+    other._handle = nullptr;
+  }
+  return *this;
+}
+
+/**
+ * @brief Destructor for CoTask. Destroys the frame if the task was never started.
+ */
+CoTask::~CoTask() {
+  if (_handle) _handle.destroy();
+}
+
+/**
+ * @brief Starts the child and arranges for the parent to be resumed when the child returns.
+ * @param parent The awaiting coroutine.
+ * @return The child, which runs immediately (symmetric transfer).
+ */
+std::coroutine_handle<> CoTask::Awaiter::await_suspend(Handle parent) noexcept {
+  child.promise().continuation = parent;
+  return child;
+}
+
+// --- CoScheduler ---
+
+/**
+ * @brief Starts a coroutine. It first runs during the next `loop()`.
+ * @param task The task to start.
+ * @return True if started, false if the frame could not be allocated.
+ */
+bool CoScheduler::spawn(CoTask&& task) {
+  if (!task.isValid()) {
+    DEBUG_ERROR_PRINTLN("CoScheduler: Cannot spawn a task without a frame.");
+    return false;
+  }
+  schedule(task.release());
+  return true;
+}
+
+/**
+ * @brief Starts a coroutine and runs it right away, up to its first suspension.
+ * May be called from inside a coroutine; the caller continues once the new one suspends or ends.
+ * @param task The task to start.
+ * @return True if started, false if the frame could not be allocated.
+ */
+bool CoScheduler::start(CoTask&& task) {
+  if (!task.isValid()) {
+    DEBUG_ERROR_PRINTLN("CoScheduler: Cannot start a task without a frame.");
+    return false;
+  }
+  task.release().resume();
+  return true;
+}
+
+/**
+ * @brief Queues a suspended coroutine for resumption. Queuing an already queued coroutine does nothing.
+ * @param handle The coroutine to resume.
+ */
+void CoScheduler::schedule(CoTask::Handle handle) {
+  if (!handle) return;
+  CoTask::promise_type& promise = handle.promise();
+  if (promise.queued) return;
+  promise.queued = true;
+  promise.nextReady = nullptr;
+  if (_readyTail) {
+    _readyTail->nextReady = &promise;
+  } else {
+    _readyHead = &promise;
+  }
+  _readyTail = &promise;
+}
+
+/**
+ * @brief Resumes every coroutine that was ready when the call started.
+ * Coroutines that become ready while this runs are resumed on the next call, so a coroutine that
+ * keeps yielding cannot starve the rest of the main loop.
+ */
+void CoScheduler::loop() {
+  CoTask::promise_type* promise = _readyHead;
+  _readyHead = nullptr;
+  _readyTail = nullptr;
+
+  while (promise) {
+    CoTask::promise_type* next = promise->nextReady; // The frame may be freed by resume().
+    promise->queued = false;
+    promise->nextReady = nullptr;
+    CoTask::Handle::from_promise(*promise).resume();
+    promise = next;
+  }
+}
+
+/**
+ * @brief Returns the number of live coroutine frames.
+ * @return The number of frames currently allocated.
+ */
+size_t CoScheduler::getLiveCount() const {
+  return s_liveFrames;
+}
+
+/**
+ * @brief Returns the number of frames that had to be allocated from the heap.
+ * @return The heap fallback count since boot.
+ */
+uint32_t CoScheduler::getHeapFrameCount() const {
+  return s_heapFrames;
+}
+
+// --- CoSleep ---
+
+/**
+ * @brief Suspends the coroutine and schedules it on the timer wheel.
+ * The wheel callback only queues the coroutine; it is resumed by `g_coScheduler.loop()`, never
+ * from inside `g_timerWheel.advance()`. A delay of 0 skips the wheel: the coroutine is queued
+ * directly, so it runs on the next scheduler pass rather than the next millisecond tick, and
+ * yielding coroutines keep their order (a wheel slot runs its timers newest first).
+ * @param handle The suspending coroutine.
+ */
+void CoSleep::await_suspend(CoTask::Handle handle) {
+  if (_delayMs == 0) {
+    g_coScheduler.schedule(handle);
+    return;
+  }
+  _timer.setCallback([handle]() { g_coScheduler.schedule(handle); });
+  g_timerWheel.start(_timer, _delayMs);
+}
+
+// --- CoEvent ---
+
+/**
+ * @brief Sets the event and resumes every waiting coroutine. Their timeouts are cancelled.
+ */
+void CoEvent::set() {
+  _set = true;
+  while (_waiters) {
+    Wait* wait = _waiters;
+    wait->_unlink();
+    wait->_signaled = true;
+    g_timerWheel.cancel(wait->_timer);
+    g_coScheduler.schedule(wait->_handle);
+  }
+}
+
+/**
+ * @brief Destructor for Wait. Removes the waiter from the event if it is still linked.
+ */
+CoEvent::Wait::~Wait() {
+  if (_linked) _unlink();
+}
+
+/**
+ * @brief Registers the coroutine as a waiter and starts the timeout, if any.
+ * Whichever comes first, `set()` or the timeout, wins and cancels the other.
+ * @param handle The suspending coroutine.
+ */
+void CoEvent::Wait::await_suspend(CoTask::Handle handle) {
+  _handle = handle;
+  _prev = nullptr;
+  _next = _event._waiters;
+  if (_next) _next->_prev = this;
+  _event._waiters = this;
+  _linked = true;
+
+  if (_timeoutMs != NO_TIMEOUT) {
+    _timer.setCallback([this]() {
+      _unlink();
+      g_coScheduler.schedule(_handle);
+    });
+    g_timerWheel.start(_timer, _timeoutMs);
+  }
+}
+
+/**
+ * @brief Removes the waiter from the event's waiter list.
+ */
+void CoEvent::Wait::_unlink() {
+  if (!_linked) return;
+  if (_prev) {
+    _prev->_next = _next;
+  } else {
+    _event._waiters = _next;
+  }
+  if (_next) _next->_prev = _prev;
+  _prev = _next = nullptr;
+  _linked = false;
+}
@@ -0,0 +1,306 @@
+/**
+ * @file Coroutine.h
+ * @brief Defines a small C++20 coroutine runtime for long-running UI flows on the main loop.
+ *
+ * Flows such as the shutdown sequence used to be a chain of `delay()` calls that froze rendering
+ * and input. Written as a `CoTask`, the same flow reads linearly but suspends at every `co_await`:
+ * - `co_await coSleep(ms)` resumes after a delay (driven by `g_timerWheel`),
+ * - `co_await coYield()` resumes on the next main loop pass,
+ * - `co_await event` / `co_await event.waitFor(ms)` resumes when a `CoEvent` is set, which is also
+ *   how the completion of asynchronous I/O is awaited (the operation's callback sets the event),
+ * - `co_await otherTask()` runs another CoTask to completion.
+ *
+ * Coroutine frames come from a fixed pool (with a counted heap fallback for oversized frames or
+ * when the pool is exhausted). Everything runs on the main loop task: `g_coScheduler.loop()`
+ * resumes the coroutines that became ready.
+ *
+ * @version 1.0.0
+ * @date 2025-09-03
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+#include <Arduino.h>
+#include <coroutine>
+#include <exception>
+#include <stdint.h>
+
+#include "Config.h"
+#include "TimerWheel.h"
+
+/**
+ * @brief A fire-and-forget coroutine running on the main loop.
+ *
+ * Calling a coroutine function returning CoTask creates a suspended frame. It starts running when
+ * it is passed to `g_coScheduler.spawn()` or awaited from another CoTask, and its frame is freed
+ * when it returns.
+ */
+class CoTask {
+public:
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    /**
+     * @brief Coroutine promise: frame allocation, scheduling links and the awaiting parent.
+     */
+    struct promise_type {
+        promise_type* nextReady = nullptr;     ///< Link in the scheduler's ready list.
+        bool queued = false;                   ///< True while in the ready list.
+        Handle continuation;                   ///< Coroutine awaiting this one, resumed when it finishes.
+
+        ~promise_type();
+
+        CoTask get_return_object() noexcept { return CoTask(Handle::from_promise(*this)); }
+        static CoTask get_return_object_on_allocation_failure() noexcept { return CoTask(nullptr); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+
+        static void* operator new(size_t size) noexcept;
+        static void operator delete(void* frame) noexcept;
+    };
+
+    CoTask() = default;
+    CoTask(CoTask&& other) noexcept : _handle(other._handle) { other._handle = nullptr; }
+    CoTask& operator=(CoTask&& other) noexcept;
+    CoTask(const CoTask&) = delete;
+    CoTask& operator=(const CoTask&) = delete;
+
+    /**
+     * @brief Destroys the frame if the task was never started.
+     */
+    ~CoTask();
+
+    /**
+     * @brief Checks whether the coroutine frame could be allocated.
+     * @return True if the task can be started, false otherwise.
+     */
+    bool isValid() const { return static_cast<bool>(_handle); }
+
+    /**
+     * @brief Gives up ownership of the frame; the task frees itself when it finishes.
+     * @return The coroutine handle.
+     */
+    Handle release() {
+        Handle h = _handle;
+        _handle = nullptr;
+        return h;
+    }
+
+    /**
+     * @brief Awaiter that runs a child CoTask and resumes the parent when the child returns.
+     */
+    struct Awaiter {
+        Handle child; ///< The child coroutine (owned by the awaiter until started).
+        bool await_ready() const noexcept { return !child; }
+        std::coroutine_handle<> await_suspend(Handle parent) noexcept;
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief Awaits the task from another CoTask.
+     * @return The awaiter.
+     */
+    Awaiter operator co_await() && noexcept { return Awaiter{ release() }; }
+
+private:
+    explicit CoTask(Handle handle) : _handle(handle) {}
+    Handle _handle = nullptr; ///< Owned frame, until started.
+};
+
+/**
+ * @brief Resumes ready coroutines from the main loop.
+ */
+class CoScheduler {
+public:
+    /**
+     * @brief Starts a coroutine. It first runs during the next `loop()`.
+     * @param task The task to start. Ownership of the frame passes to the scheduler.
+     * @return True if started, false if the frame could not be allocated.
+     */
+    bool spawn(CoTask&& task);
+
+    /**
+     * @brief Starts a coroutine and runs it right away, up to its first suspension.
+     * @param task The task to start. Ownership of the frame passes to the scheduler.
+     * @return True if started, false if the frame could not be allocated.
+     */
+    bool start(CoTask&& task);
+
+    /**
+     * @brief Queues a suspended coroutine for resumption. Main loop task only.
+     * @param handle The coroutine to resume.
+     */
+    void schedule(CoTask::Handle handle);
+
+    /**
+     * @brief Resumes every coroutine that was ready when the call started. Call from the main loop.
+     */
+    void loop();
+
+    /**
+     * @brief Checks whether coroutines are waiting to be resumed.
+     * @return True if the ready list is not empty.
+     */
+    bool hasReady() const { return _readyHead != nullptr; }
+
+    /**
+     * @brief Returns the number of live coroutine frames.
+     * @return The number of frames currently allocated.
+     */
+    size_t getLiveCount() const;
+
+    /**
+     * @brief Returns the number of frames that had to be allocated from the heap.
+     * @return The heap fallback count since boot.
+     */
+    uint32_t getHeapFrameCount() const;
+
+private:
+    CoTask::promise_type* _readyHead = nullptr;  ///< First ready coroutine.
+    CoTask::promise_type* _readyTail = nullptr;  ///< Last ready coroutine.
+};
+
+/**
+ * @brief The scheduler shared by the main loop and all coroutines.
+ * It is driven from `loop()` in the main sketch.
+ */
+extern CoScheduler g_coScheduler;
+
+/**
+ * @brief Awaitable that resumes the coroutine after a delay.
+ */
+class CoSleep {
+public:
+    /**
+     * @brief Constructor for CoSleep.
+     * @param delayMs Delay in milliseconds (0 resumes on the next scheduler pass).
+     */
+    explicit CoSleep(uint32_t delayMs) : _delayMs(delayMs) {}
+    CoSleep(const CoSleep&) = delete;
+    CoSleep& operator=(const CoSleep&) = delete;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(CoTask::Handle handle);
+    void await_resume() const noexcept {}
+
+private:
+    uint32_t _delayMs;            ///< Requested delay.
+    TimerWheel::Timer _timer;     ///< Wakes the coroutine (lives in the coroutine frame).
+};
+
+/**
+ * @brief Suspends the coroutine for a delay without blocking the main loop.
+ * @param delayMs Delay in milliseconds.
+ * @return The awaitable.
+ */
+inline CoSleep coSleep(uint32_t delayMs) { return CoSleep(delayMs); }
+
+/**
+ * @brief Suspends the coroutine until the next main loop pass, letting the UI render.
+ * @return The awaitable.
+ */
+inline CoSleep coYield() { return CoSleep(0); }
+
+/**
+ * @brief A manual-reset event coroutines can wait on, with an optional timeout.
+ *
+ * `set()` resumes every waiter; the event stays set until `reset()`. Main loop task only: callbacks
+ * arriving on other tasks must be delivered to the main loop first (as WifiEventBridge does).
+ */
+class CoEvent {
+public:
+    /**
+     * @brief Awaiter for `co_await event` and `co_await event.waitFor(ms)`.
+     * `co_await` returns true if the event was set, false if the timeout expired first.
+     */
+    class Wait {
+    public:
+        Wait(CoEvent& event, uint32_t timeoutMs) : _event(event), _timeoutMs(timeoutMs) {}
+        ~Wait();
+        Wait(const Wait&) = delete;
+        Wait& operator=(const Wait&) = delete;
+
+        bool await_ready() const noexcept { return _event.isSet(); }
+        void await_suspend(CoTask::Handle handle);
+        bool await_resume() const noexcept { return _signaled || _event.isSet(); }
+
+    private:
+        friend class CoEvent;
+        CoEvent& _event;              ///< The awaited event.
+        uint32_t _timeoutMs;          ///< Timeout, or NO_TIMEOUT.
+        CoTask::Handle _handle;       ///< The suspended coroutine.
+        Wait* _prev = nullptr;        ///< Previous waiter of the event.
+        Wait* _next = nullptr;        ///< Next waiter of the event.
+        bool _linked = false;         ///< True while in the event's waiter list.
+        bool _signaled = false;       ///< True if resumed by `set()`.
+        TimerWheel::Timer _timer;     ///< Timeout timer.
+
+        void _unlink();
+    };
+
+    static constexpr uint32_t NO_TIMEOUT = UINT32_MAX; ///< Wait without a timeout.
+
+    CoEvent() = default;
+    CoEvent(const CoEvent&) = delete;
+    CoEvent& operator=(const CoEvent&) = delete;
+
+    /**
+     * @brief Sets the event and resumes every waiting coroutine.
+     */
+    void set();
+
+    /**
+     * @brief Clears the event.
+     */
+    void reset() { _set = false; }
+
+    /**
+     * @brief Checks whether the event is set.
+     * @return True if set.
+     */
+    bool isSet() const { return _set; }
+
+    /**
+     * @brief Waits for the event with a timeout.
+     * @param timeoutMs Timeout in milliseconds.
+     * @return The awaiter; `co_await` yields true if the event was set in time.
+     */
+    Wait waitFor(uint32_t timeoutMs) { return Wait(*this, timeoutMs); }
+
+    /**
+     * @brief Waits for the event without a timeout.
+     * @return The awaiter.
+     */
+    Wait operator co_await() { return Wait(*this, NO_TIMEOUT); }
+
+private:
+    bool _set = false;            ///< Event state.
+    Wait* _waiters = nullptr;     ///< Waiting coroutines.
+};
+
+#endif // COROUTINE_H
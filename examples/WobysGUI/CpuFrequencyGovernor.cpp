@@ -0,0 +1,246 @@
+/**
+ * @file CpuFrequencyGovernor.cpp
+ * @brief Implements the CpuFrequencyGovernor class.
+ *
+ * @version 1.0.0
+ * @date 2025-09-07
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "CpuFrequencyGovernor.h"
+#include "SystemInitializer.h" // For CpuFrequencyGovernorConfig
+#include "ScreenSaverManager.h"
+#include "AudioManager.h"
+#include <esp_timer.h>
+#include <string.h>
+
+/**
+ * @brief Constructor for the CpuFrequencyGovernor class.
+ * @param screenSaverManager Pointer to the ScreenSaverManager (user presence).
+ * @param audioManager Pointer to the AudioManager (playback state).
+ */
+CpuFrequencyGovernor::CpuFrequencyGovernor(ScreenSaverManager* screenSaverManager, AudioManager* audioManager)
+  : _screenSaverManager(screenSaverManager),
+    _audioManager(audioManager),
+    _config(nullptr),
+    _boostLock(nullptr),
+    _usePmLock(false),
+    _boosted(false),
+    _screenSaverActive(false),
+    _lastTouchMs(0),
+    _lastHeavyFrameMs(0),
+    _heavyFrameSeen(false),
+    _currentMhz(0),
+    _lastAccountUs(0),
+    _windowStartUs(0),
+    _boostCount(0),
+    _reportTimer([this]() { logReport(); }) {
+  memset(_stats, 0, sizeof(_stats));
+}
+
+/**
+ * @brief Destructor. Releases the power management lock.
+ */
+CpuFrequencyGovernor::~CpuFrequencyGovernor() {
+  if (_boostLock) {
+    if (_boosted) esp_pm_lock_release(_boostLock);
+    esp_pm_lock_delete(_boostLock);
+  }
+}
+
+/**
+ * @brief Configures the clock scaling and starts at full speed.
+ * @param config Frequencies, hold times and the report interval.
+ * @return True if the governor is ready (or disabled), false if the frequencies are not supported.
+ */
+bool CpuFrequencyGovernor::init(const CpuFrequencyGovernorConfig& config) {
+  DEBUG_INFO_PRINTLN("CpuFrequencyGovernor: init() starting...");
+  if (!config.enabled) {
+    DEBUG_INFO_PRINTLN("CpuFrequencyGovernor: Disabled, the CPU keeps its boot clock.");
+    return true;
+  }
+
+  esp_pm_config_t pmConfig = {};
+  pmConfig.max_freq_mhz = config.maxFreqMhz;
+  pmConfig.min_freq_mhz = config.minFreqMhz;
+  pmConfig.light_sleep_enable = false;
+  esp_err_t err = esp_pm_configure(&pmConfig);
+  if (err == ESP_OK) {
+    err = esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "ui_boost", &_boostLock);
+  }
+  if (err == ESP_OK) {
+    _usePmLock = true;
+  } else {
+    // CONFIG_PM_ENABLE is off in this SDK build: switch the clock directly instead.
+    DEBUG_WARN_PRINTF("CpuFrequencyGovernor: esp_pm not available (%s), using setCpuFrequencyMhz().\n", esp_err_to_name(err));
+    _boostLock = nullptr;
+    if (!setCpuFrequencyMhz(config.maxFreqMhz)) {
+      DEBUG_ERROR_PRINTF("CpuFrequencyGovernor: %u MHz is not a supported CPU clock.\n", (unsigned)config.maxFreqMhz);
+      return false;
+    }
+  }
+  _config = &config;
+
+  _lastAccountUs = esp_timer_get_time();
+  _windowStartUs = _lastAccountUs;
+  _currentMhz = getCpuFrequencyMhz();
+
+  // Start boosted, as if the screen had just been touched: the first screen is being drawn.
+  _lastTouchMs = millis();
+  _setBoost(true);
+  _boostCount = 0;
+
+  if (config.reportIntervalMs > 0) {
+    g_timerWheel.start(_reportTimer, config.reportIntervalMs, config.reportIntervalMs);
+  }
+  DEBUG_INFO_PRINTF("CpuFrequencyGovernor: Initialized (%u-%u MHz, %s).\n", (unsigned)config.minFreqMhz,
+                    (unsigned)config.maxFreqMhz, _usePmLock ? "esp_pm lock" : "direct switching");
+  return true;
+}
+
+/**
+ * @brief Reports the touch state of this loop pass. A press raises the clock at once.
+ * @param isPressed True while the screen is touched.
+ */
+void CpuFrequencyGovernor::onTouch(bool isPressed) {
+  if (!_config || !isPressed) return;
+  _lastTouchMs = millis();
+  _setBoost(true);
+}
+
+/**
+ * @brief Reports the render time of this loop pass.
+ * The time is scaled to the maximum clock before it is compared with `renderBoostUs`, so the same
+ * frame is judged alike at every frequency and the governor does not oscillate between them.
+ * @param renderUs The time spent rendering, in microseconds.
+ */
+void CpuFrequencyGovernor::onFrame(uint32_t renderUs) {
+  if (!_config) return;
+
+  const uint32_t fullClockUs = (uint32_t)((uint64_t)renderUs * _currentMhz / _config->maxFreqMhz);
+  if (fullClockUs >= _config->renderBoostUs && !_screenSaverActive) {
+    _lastHeavyFrameMs = millis();
+    _heavyFrameSeen = true;
+    _setBoost(true);
+  }
+
+  if (renderUs < _config->frameMinUs) return; // Nothing was drawn in this pass.
+  CpuFrequencyStats* stats = _statsFor(_currentMhz);
+  if (!stats) return;
+  stats->frames++;
+  stats->frameUsSum += renderUs;
+  if (renderUs > stats->frameMaxUs) stats->frameMaxUs = renderUs;
+}
+
+/**
+ * @brief Evaluates the inputs, lowers the clock when nothing needs it and accounts the residency.
+ */
+void CpuFrequencyGovernor::loop() {
+  if (!_config) return;
+  const unsigned long now = millis();
+
+  _screenSaverActive = _screenSaverManager && _screenSaverManager->isActive();
+  if (_screenSaverActive) _heavyFrameSeen = false; // The screensaver animation runs at the low clock.
+
+  const bool touch = now - _lastTouchMs < _config->touchHoldMs;
+  const bool render = _heavyFrameSeen && now - _lastHeavyFrameMs < _config->renderHoldMs;
+  const bool audio = _audioManager && _audioManager->isPlaybackActive();
+  _setBoost(touch || render || audio);
+
+  _account();
+}
+
+/**
+ * @brief Prints the residency and frame times per frequency and starts a new reporting window.
+ */
+void CpuFrequencyGovernor::logReport() {
+  _account();
+  const uint64_t windowUs = _lastAccountUs - _windowStartUs;
+  DEBUG_INFO_PRINTF("CpuFrequencyGovernor: %u boosts in the last %us.\n", (unsigned)_boostCount, (unsigned)(windowUs / 1000000));
+  DEBUG_INFO_PRINTLN("CpuFrequencyGovernor: clock   residency          frames  avg frame  max frame");
+  for (size_t i = 0; i < MAX_FREQUENCIES; i++) {
+    const CpuFrequencyStats& s = _stats[i];
+    if (s.mhz == 0) continue;
+    DEBUG_INFO_PRINTF("CpuFrequencyGovernor: %3uMHz %5.1f%% %9ums %7u %8uus %8uus\n",
+                      (unsigned)s.mhz, windowUs ? 100.0f * (float)s.residentUs / (float)windowUs : 0.0f,
+                      (unsigned)(s.residentUs / 1000), (unsigned)s.frames,
+                      (unsigned)(s.frames ? s.frameUsSum / s.frames : 0), (unsigned)s.frameMaxUs);
+  }
+  memset(_stats, 0, sizeof(_stats));
+  _windowStartUs = _lastAccountUs;
+  _boostCount = 0;
+}
+
+/**
+ * @brief Requests or releases full speed.
+ * @param boost True for the maximum clock, false to let it drop to the minimum.
+ */
+void CpuFrequencyGovernor::_setBoost(bool boost) {
+  if (boost == _boosted) return;
+  _account(); // Charge the time so far to the old frequency.
+  _boosted = boost;
+  if (boost) _boostCount++;
+
+  if (_usePmLock) {
+    if (boost) {
+      esp_pm_lock_acquire(_boostLock);
+    } else {
+      esp_pm_lock_release(_boostLock);
+    }
+  } else {
+    setCpuFrequencyMhz(boost ? _config->maxFreqMhz : _config->minFreqMhz);
+  }
+  _currentMhz = getCpuFrequencyMhz();
+  DEBUG_TRACE_PRINTF("CpuFrequencyGovernor: %s, now at %u MHz.\n", boost ? "Boost" : "Idle", (unsigned)_currentMhz);
+}
+
+/**
+ * @brief Adds the time since the last accounting to the frequency it ran at and samples the
+ * current frequency (which other power management locks, e.g. of the radios, may also raise).
+ */
+void CpuFrequencyGovernor::_account() {
+  const uint64_t nowUs = esp_timer_get_time();
+  CpuFrequencyStats* stats = _statsFor(_currentMhz);
+  if (stats) stats->residentUs += nowUs - _lastAccountUs;
+  _lastAccountUs = nowUs;
+  _currentMhz = getCpuFrequencyMhz();
+}
+
+/**
+ * @brief Finds the statistics slot of a frequency, taking a free one if it is new.
+ * @param mhz The frequency.
+ * @return The slot, or nullptr if all slots hold other frequencies.
+ */
+CpuFrequencyStats* CpuFrequencyGovernor::_statsFor(uint32_t mhz) {
+  if (mhz == 0) return nullptr;
+  for (size_t i = 0; i < MAX_FREQUENCIES; i++) {
+    if (_stats[i].mhz == mhz) return &_stats[i];
+  }
+  for (size_t i = 0; i < MAX_FREQUENCIES; i++) {
+    if (_stats[i].mhz == 0) {
+      _stats[i].mhz = mhz;
+      return &_stats[i];
+    }
+  }
+  return nullptr;
+}
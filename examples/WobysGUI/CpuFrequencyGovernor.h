@@ -0,0 +1,177 @@
+/**
+ * @file CpuFrequencyGovernor.h
+ * @brief Defines the CpuFrequencyGovernor class, which lowers the CPU clock while the UI is idle
+ * and raises it for touch interaction, animations and audio playback.
+ *
+ * With the ESP-IDF power management enabled, the clock is scaled by `esp_pm_configure()` between
+ * the configured maximum and minimum, and the governor holds an `ESP_PM_CPU_FREQ_MAX` lock while it
+ * wants full speed. Other drivers (Wi-Fi, Bluetooth) keep taking their own locks. Without power
+ * management support in the SDK configuration the governor falls back to `setCpuFrequencyMhz()`.
+ *
+ * Inputs: touches reported from the main loop, the render time of every loop pass (a frame that
+ * needs more than `renderBoostUs` of work at full clock counts as an animation or a full redraw),
+ * the playback state of the AudioManager and the ScreenSaverManager (while the screensaver runs,
+ * its own animation does not raise the clock). The time spent at every clock frequency and the frame
+ * time at each of them are reported periodically.
+ *
+ * @version 1.0.0
+ * @date 2025-09-07
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef CPU_FREQUENCY_GOVERNOR_H
+#define CPU_FREQUENCY_GOVERNOR_H
+
+#include <Arduino.h>
+#include <esp_pm.h>
+
+#include "Config.h"
+#include "TimerWheel.h"
+
+// Forward declarations
+class ScreenSaverManager;
+class AudioManager;
+struct CpuFrequencyGovernorConfig; // Defined in SystemInitializer.h
+
+/**
+ * @brief Statistics collected for one CPU clock frequency in the current reporting window.
+ */
+struct CpuFrequencyStats {
+  uint32_t mhz;           ///< Clock frequency (0 for an unused slot).
+  uint64_t residentUs;    ///< Time the main loop ran at this frequency.
+  uint32_t frames;        ///< Frames rendered at this frequency.
+  uint64_t frameUsSum;    ///< Sum of their render times.
+  uint32_t frameMaxUs;    ///< Longest render time.
+};
+
+/**
+ * @brief Scales the CPU clock with the UI activity. Main loop task only.
+ */
+class CpuFrequencyGovernor {
+public:
+  static constexpr size_t MAX_FREQUENCIES = 4; ///< Distinct frequencies tracked in the statistics.
+
+  /**
+   * @brief Constructor for the CpuFrequencyGovernor class.
+   * @param screenSaverManager Pointer to the ScreenSaverManager (user presence).
+   * @param audioManager Pointer to the AudioManager (playback state).
+   */
+  CpuFrequencyGovernor(ScreenSaverManager* screenSaverManager, AudioManager* audioManager);
+
+  /**
+   * @brief Destructor. Releases the power management lock.
+   */
+  ~CpuFrequencyGovernor();
+
+  /**
+   * @brief Configures the clock scaling and starts at full speed.
+   * @param config Frequencies, hold times and the report interval.
+   * @return True if the governor is ready (or disabled by the configuration), false if the
+   *         frequencies are not supported.
+   */
+  bool init(const CpuFrequencyGovernorConfig& config);
+
+  /**
+   * @brief Reports the touch state of this loop pass. A press raises the clock at once and
+   * keeps it up for `touchHoldMs` after the release.
+   * @param isPressed True while the screen is touched.
+   */
+  void onTouch(bool isPressed);
+
+  /**
+   * @brief Reports the render time of this loop pass (status bar and screen).
+   * @param renderUs The time spent rendering, in microseconds.
+   */
+  void onFrame(uint32_t renderUs);
+
+  /**
+   * @brief Evaluates the inputs, lowers the clock when nothing needs it and accounts the
+   * residency. Call once per main loop pass.
+   */
+  void loop();
+
+  /**
+   * @brief Checks whether the governor currently asks for full speed.
+   * @return True if boosted.
+   */
+  bool isBoosted() const { return _boosted; }
+
+  /**
+   * @brief Returns the clock frequency measured at the last `loop()`.
+   * @return The frequency in MHz.
+   */
+  uint32_t getFrequencyMhz() const { return _currentMhz; }
+
+  /**
+   * @brief Returns the statistics of one tracked frequency.
+   * @param index Slot index (0 to MAX_FREQUENCIES - 1); unused slots have `mhz == 0`.
+   * @return A const reference to the statistics.
+   */
+  const CpuFrequencyStats& getStats(size_t index) const { return _stats[index % MAX_FREQUENCIES]; }
+
+  /**
+   * @brief Prints the residency and frame times per frequency and starts a new reporting window.
+   */
+  void logReport();
+
+private:
+  ScreenSaverManager* _screenSaverManager;       ///< Pointer to the ScreenSaverManager (not owned).
+  AudioManager* _audioManager;                   ///< Pointer to the AudioManager (not owned).
+  const CpuFrequencyGovernorConfig* _config;     ///< Pointer to the configuration (owned by SystemInitializer).
+
+  esp_pm_lock_handle_t _boostLock;               ///< CPU_FREQ_MAX lock held while boosted (PM mode only).
+  bool _usePmLock;                               ///< True if the clock is scaled by esp_pm, false for setCpuFrequencyMhz().
+  bool _boosted;                                 ///< True while full speed is requested.
+  bool _screenSaverActive;                       ///< Screensaver state seen by the last `loop()`.
+  unsigned long _lastTouchMs;                    ///< millis() of the last touch (or of init()).
+  unsigned long _lastHeavyFrameMs;               ///< millis() of the last frame above `renderBoostUs`.
+  bool _heavyFrameSeen;                          ///< True once a heavy frame has set `_lastHeavyFrameMs`.
+  uint32_t _currentMhz;                          ///< Clock frequency measured at the last accounting.
+  uint64_t _lastAccountUs;                       ///< esp_timer time up to which residency has been accounted.
+  uint64_t _windowStartUs;                       ///< Start of the current reporting window.
+  uint32_t _boostCount;                          ///< Idle-to-boost transitions in the current window.
+  CpuFrequencyStats _stats[MAX_FREQUENCIES];     ///< Per-frequency statistics of the current window.
+  TimerWheel::Timer _reportTimer;                ///< Periodic report on `g_timerWheel`.
+
+  /**
+   * @brief Requests or releases full speed.
+   * @param boost True for the maximum clock, false to let it drop to the minimum.
+   */
+  void _setBoost(bool boost);
+
+  /**
+   * @brief Adds the time since the last accounting to the frequency it ran at and samples the
+   * current frequency.
+   */
+  void _account();
+
+  /**
+   * @brief Finds the statistics slot of a frequency, taking a free one if it is new.
+   * @param mhz The frequency.
+   * @return The slot, or nullptr if all slots hold other frequencies.
+   */
+  CpuFrequencyStats* _statsFor(uint32_t mhz);
+};
+
+#endif // CPU_FREQUENCY_GOVERNOR_H
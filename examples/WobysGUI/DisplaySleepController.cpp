@@ -0,0 +1,247 @@
+/**
+ * @file DisplaySleepController.cpp
+ * @brief Implements the DisplaySleepController class.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "DisplaySleepController.h"
+#include "SystemInitializer.h" // For DisplaySleepConfig
+#include "ScreenSaverManager.h"
+#include <esp_timer.h>
+#include <string.h>
+
+namespace {
+constexpr int64_t ST7796_SLEEP_IN_TO_OUT_US = 120000; // Minimum time between SLPIN and SLPOUT (datasheet).
+constexpr uint32_t ST7796_SLEEP_OUT_SETTLE_MS = 5;    // Time after SLPOUT before the next command (datasheet).
+} // namespace
+
+/**
+ * @brief Constructor for the DisplaySleepController class.
+ * @param lcd Pointer to the LGFX display.
+ * @param screenSaverManager Pointer to the ScreenSaverManager (first stage).
+ */
+DisplaySleepController::DisplaySleepController(LGFX* lcd, ScreenSaverManager* screenSaverManager)
+  : _lcd(lcd),
+    _screenSaverManager(screenSaverManager),
+    _config(nullptr),
+    _stage(Stage::ACTIVE),
+    _lastInteractionMs(0),
+    _savedBrightness(0),
+    _sleepInUs(0),
+    _wakePending(false),
+    _wakeUs(0),
+    _windowStartUs(0),
+    _stageStartUs(0),
+    _panelSleeps(0),
+    _panelWakeMaxUs(0),
+    _latencyCount(0),
+    _latencySumUs(0),
+    _latencyMaxUs(0),
+    _reportTimer([this]() { logReport(); }) {
+  memset(_stageUs, 0, sizeof(_stageUs));
+}
+
+/**
+ * @brief Applies the configuration.
+ * @param config Timeout, idle wait and report interval.
+ * @return True if ready (or disabled), false without a display.
+ */
+bool DisplaySleepController::init(const DisplaySleepConfig& config) {
+  DEBUG_INFO_PRINTLN("DisplaySleepController: init() starting...");
+  if (!config.enabled) {
+    DEBUG_INFO_PRINTLN("DisplaySleepController: Disabled, the screensaver keeps the panel on.");
+    return true;
+  }
+  if (!_lcd) {
+    DEBUG_ERROR_PRINTLN("DisplaySleepController: No display.");
+    return false;
+  }
+  _config = &config;
+
+  _lastInteractionMs = millis();
+  _windowStartUs = esp_timer_get_time();
+  _stageStartUs = _windowStartUs;
+
+  if (config.reportIntervalMs > 0) {
+    g_timerWheel.start(_reportTimer, config.reportIntervalMs, config.reportIntervalMs);
+  }
+  DEBUG_INFO_PRINTF("DisplaySleepController: Initialized (panel sleep after %us of screensaver).\n",
+                    (unsigned)(config.timeoutMs / 1000));
+  return true;
+}
+
+/**
+ * @brief Reports the touch state of this loop pass. A press wakes the panel before the touch is handled.
+ * @param isPressed True while the screen is touched.
+ */
+void DisplaySleepController::onTouch(bool isPressed) {
+  if (!_config || !isPressed) return;
+  _lastInteractionMs = millis();
+  wake();
+}
+
+/**
+ * @brief Follows the screensaver and puts the panel to sleep after the timeout.
+ */
+void DisplaySleepController::loop() {
+  if (!_config) return;
+  const bool saverActive = _screenSaverManager && _screenSaverManager->isActive();
+
+  switch (_stage) {
+    case Stage::ACTIVE:
+      if (saverActive) {
+        _lastInteractionMs = millis(); // The timeout counts from the activation.
+        _setStage(Stage::SCREENSAVER);
+      }
+      break;
+    case Stage::SCREENSAVER:
+      if (!saverActive) {
+        _setStage(Stage::ACTIVE);
+      } else if (millis() - _lastInteractionMs >= _config->timeoutMs) {
+        _enterPanelSleep();
+      }
+      break;
+    case Stage::PANEL_SLEEP:
+      if (!saverActive) wake(); // Screensaver switched off by something other than a touch.
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Reports the end of the render pass; completes a pending wake latency measurement.
+ */
+void DisplaySleepController::onFrame() {
+  if (!_wakePending) return;
+  _wakePending = false;
+
+  const uint32_t latencyUs = (uint32_t)(esp_timer_get_time() - _wakeUs);
+  _latencyCount++;
+  _latencySumUs += latencyUs;
+  if (latencyUs > _latencyMaxUs) _latencyMaxUs = latencyUs;
+  DEBUG_TRACE_PRINTF("DisplaySleepController: Touch to first frame %uus.\n", (unsigned)latencyUs);
+}
+
+/**
+ * @brief Wakes the panel and restores the backlight. The ST7796 kept its frame memory, so the old
+ * picture is back at once and the screensaver only redraws what changed.
+ */
+void DisplaySleepController::wake() {
+  if (_stage != Stage::PANEL_SLEEP) return;
+  const int64_t startUs = esp_timer_get_time();
+
+  const int64_t sinceSleepInUs = startUs - _sleepInUs;
+  if (sinceSleepInUs < ST7796_SLEEP_IN_TO_OUT_US) {
+    delay((uint32_t)((ST7796_SLEEP_IN_TO_OUT_US - sinceSleepInUs + 999) / 1000));
+  }
+  _lcd->wakeup();
+  delay(ST7796_SLEEP_OUT_SETTLE_MS);
+  _lcd->setBrightness(_savedBrightness);
+
+  const uint32_t panelWakeUs = (uint32_t)(esp_timer_get_time() - startUs);
+  if (panelWakeUs > _panelWakeMaxUs) _panelWakeMaxUs = panelWakeUs;
+  _wakePending = true;
+  _wakeUs = startUs;
+  _lastInteractionMs = millis();
+
+  const bool saverActive = _screenSaverManager && _screenSaverManager->isActive();
+  _setStage(saverActive ? Stage::SCREENSAVER : Stage::ACTIVE);
+  DEBUG_TRACE_PRINTF("DisplaySleepController: Panel awake in %uus, backlight %u.\n",
+                     (unsigned)panelWakeUs, (unsigned)_savedBrightness);
+}
+
+/**
+ * @brief Returns the longest idle wait while the panel sleeps.
+ * @return The time in milliseconds.
+ */
+uint32_t DisplaySleepController::getMaxSleepMs() const {
+  return _config ? _config->maxSleepMs : MAIN_LOOP_MAX_SLEEP_MS;
+}
+
+/**
+ * @brief Prints the residency of each stage and the wake latency, and starts a new reporting window.
+ */
+void DisplaySleepController::logReport() {
+  const int64_t nowUs = esp_timer_get_time();
+  _setStage(_stage); // Closes the running period.
+  const float windowUs = (float)(nowUs - _windowStartUs);
+
+  for (size_t i = 0; i < (size_t)Stage::COUNT; i++) {
+    DEBUG_INFO_PRINTF("DisplaySleepController: %-12s %5.1f%% %9ums\n", _stageName((Stage)i),
+                      windowUs > 0 ? 100.0f * (float)_stageUs[i] / windowUs : 0.0f, (unsigned)(_stageUs[i] / 1000));
+  }
+  DEBUG_INFO_PRINTF("DisplaySleepController: %u panel sleeps, panel wake-up max %uus, touch to first frame avg %uus, max %uus.\n",
+                    (unsigned)_panelSleeps, (unsigned)_panelWakeMaxUs,
+                    (unsigned)(_latencyCount ? _latencySumUs / _latencyCount : 0), (unsigned)_latencyMaxUs);
+
+  _windowStartUs = nowUs;
+  memset(_stageUs, 0, sizeof(_stageUs));
+  _panelSleeps = 0;
+  _panelWakeMaxUs = 0;
+  _latencyCount = 0;
+  _latencySumUs = 0;
+  _latencyMaxUs = 0;
+}
+
+/**
+ * @brief Turns the backlight off and puts the panel to sleep. Rendering is already suspended for
+ * the rest of this loop pass, since the main loop checks `isPanelAsleep()` before drawing.
+ */
+void DisplaySleepController::_enterPanelSleep() {
+  _savedBrightness = _lcd->getBrightness();
+  _lcd->setBrightness(0);
+  _lcd->sleep();
+  _sleepInUs = esp_timer_get_time();
+  _panelSleeps++;
+  _setStage(Stage::PANEL_SLEEP);
+  DEBUG_TRACE_PRINTF("DisplaySleepController: Panel asleep (backlight was %u).\n", (unsigned)_savedBrightness);
+}
+
+/**
+ * @brief Closes the residency of the current stage and switches to another.
+ * @param stage The new stage (may be the current one, to close the period for a report).
+ */
+void DisplaySleepController::_setStage(Stage stage) {
+  const int64_t nowUs = esp_timer_get_time();
+  _stageUs[(size_t)_stage] += nowUs - _stageStartUs;
+  _stageStartUs = nowUs;
+  _stage = stage;
+}
+
+/**
+ * @brief Returns a printable name for a stage.
+ * @param stage The stage.
+ * @return The name.
+ */
+const char* DisplaySleepController::_stageName(Stage stage) {
+  switch (stage) {
+    case Stage::ACTIVE: return "active";
+    case Stage::SCREENSAVER: return "screensaver";
+    case Stage::PANEL_SLEEP: return "panel sleep";
+    default: return "?";
+  }
+}
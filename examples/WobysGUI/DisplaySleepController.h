@@ -0,0 +1,172 @@
+/**
+ * @file DisplaySleepController.h
+ * @brief Defines the DisplaySleepController class, which adds a deep stage to the screensaver:
+ * after a second timeout it switches the backlight off, puts the ST7796 into sleep-in mode and
+ * suspends rendering.
+ *
+ * The ScreenSaverManager only dims the backlight, so the panel keeps scanning its frame memory and
+ * the screensaver, status bar and screen loops keep running. Once the screensaver has been active
+ * without a touch for `timeoutMs`, this controller saves the backlight level, turns it off and sends
+ * SLPIN; the main loop then skips the render and animation loops. The ST7796 keeps its frame memory
+ * in sleep-in mode, so a touch only has to send SLPOUT, wait for the controller to come up and
+ * restore the backlight; the screensaver then redraws what changed in the meantime (its clock).
+ *
+ * The time spent in each stage (active UI, screensaver, panel asleep) and the latency from the
+ * waking touch to the first frame are reported periodically.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef DISPLAY_SLEEP_CONTROLLER_H
+#define DISPLAY_SLEEP_CONTROLLER_H
+
+#include <Arduino.h>
+
+#include "Config.h"
+#include "TimerWheel.h"
+
+// Forward declarations
+class ScreenSaverManager;
+struct DisplaySleepConfig; // Defined in SystemInitializer.h
+
+/**
+ * @brief Backlight-off and panel sleep stage after the screensaver. Main loop task only.
+ */
+class DisplaySleepController {
+public:
+  /**
+   * @brief Display power stages, in the order the UI passes through them.
+   */
+  enum class Stage : uint8_t {
+    ACTIVE,       ///< Screensaver off, UI in use.
+    SCREENSAVER,  ///< Screensaver on, backlight dimmed, panel refreshing.
+    PANEL_SLEEP,  ///< Backlight off, panel in sleep-in mode, rendering suspended.
+    COUNT         ///< Number of stages.
+  };
+
+  /**
+   * @brief Constructor for the DisplaySleepController class.
+   * @param lcd Pointer to the LGFX display.
+   * @param screenSaverManager Pointer to the ScreenSaverManager (first stage).
+   */
+  DisplaySleepController(LGFX* lcd, ScreenSaverManager* screenSaverManager);
+
+  /**
+   * @brief Applies the configuration.
+   * @param config Timeout, idle wait and report interval.
+   * @return True if ready (or disabled by the configuration), false without a display.
+   */
+  bool init(const DisplaySleepConfig& config);
+
+  /**
+   * @brief Reports the touch state of this loop pass. A press wakes the panel before the touch is
+   * handled, so it reaches the screensaver as usual.
+   * @param isPressed True while the screen is touched.
+   */
+  void onTouch(bool isPressed);
+
+  /**
+   * @brief Follows the screensaver and puts the panel to sleep after the timeout. Call once per
+   * main loop pass, after the ScreenSaverManager.
+   */
+  void loop();
+
+  /**
+   * @brief Reports the end of the render pass; completes a pending wake latency measurement.
+   */
+  void onFrame();
+
+  /**
+   * @brief Wakes the panel and restores the backlight, e.g. before the shutdown messages.
+   */
+  void wake();
+
+  /**
+   * @brief Checks whether the panel sleeps; the main loop skips rendering meanwhile.
+   * @return True while the panel is asleep.
+   */
+  bool isPanelAsleep() const { return _stage == Stage::PANEL_SLEEP; }
+
+  /**
+   * @brief Returns the current stage.
+   * @return The stage.
+   */
+  Stage getStage() const { return _stage; }
+
+  /**
+   * @brief Returns the longest idle wait while the panel sleeps (nothing is drawn, so the
+   * screensaver clock does not bound it).
+   * @return The time in milliseconds.
+   */
+  uint32_t getMaxSleepMs() const;
+
+  /**
+   * @brief Prints the residency of each stage and the wake latency, and starts a new reporting window.
+   */
+  void logReport();
+
+private:
+  LGFX* _lcd;                                    ///< Pointer to the display (not owned).
+  ScreenSaverManager* _screenSaverManager;       ///< Pointer to the ScreenSaverManager (not owned).
+  const DisplaySleepConfig* _config;             ///< Pointer to the configuration (owned by SystemInitializer).
+
+  Stage _stage;                                  ///< Current stage.
+  unsigned long _lastInteractionMs;              ///< millis() of the last touch or of the screensaver activation.
+  uint8_t _savedBrightness;                      ///< Backlight level restored on wake.
+  int64_t _sleepInUs;                            ///< esp_timer time of the last SLPIN.
+  bool _wakePending;                             ///< True from a wake until the next frame.
+  int64_t _wakeUs;                               ///< esp_timer time of that wake.
+
+  int64_t _windowStartUs;                        ///< Start of the current reporting window.
+  int64_t _stageStartUs;                         ///< Start of the current stage.
+  uint64_t _stageUs[(size_t)Stage::COUNT];       ///< Time in each stage in the window (completed periods).
+  uint32_t _panelSleeps;                         ///< Panel sleeps in the window.
+  uint32_t _panelWakeMaxUs;                      ///< Longest panel wake-up (SLPOUT and settle) in the window.
+  uint32_t _latencyCount;                        ///< Wake latencies measured in the window.
+  uint64_t _latencySumUs;                        ///< Sum of the wake latencies.
+  uint32_t _latencyMaxUs;                        ///< Longest wake latency.
+  TimerWheel::Timer _reportTimer;                ///< Periodic report on `g_timerWheel`.
+
+  /**
+   * @brief Turns the backlight off and puts the panel to sleep.
+   */
+  void _enterPanelSleep();
+
+  /**
+   * @brief Closes the residency of the current stage and switches to another.
+   * @param stage The new stage.
+   */
+  void _setStage(Stage stage);
+
+  /**
+   * @brief Returns a printable name for a stage.
+   * @param stage The stage.
+   * @return The name.
+   */
+  static const char* _stageName(Stage stage);
+};
+
+#endif // DISPLAY_SLEEP_CONTROLLER_H
@@ -0,0 +1,396 @@
+/**
+ * @file IdleSleepController.cpp
+ * @brief Implements the IdleSleepController class.
+ *
+ * @version 1.0.0
+ * @date 2025-09-08
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "IdleSleepController.h"
+#include "SystemInitializer.h" // For IdleSleepConfig
+#include "ScreenSaverManager.h"
+#include "AudioManager.h"
+#include "CpuFrequencyGovernor.h"
+#include "WifiManager.h"
+#include "BLEManager.h"
+#include <driver/gpio.h>
+#include <driver/ledc.h>
+#include <driver/uart.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <algorithm>
+
+/**
+ * @brief Constructor for the IdleSleepController class.
+ * @param lcd Pointer to the LGFX display (backlight level).
+ * @param screenSaverManager Pointer to the ScreenSaverManager (user presence).
+ * @param audioManager Pointer to the AudioManager (playback state).
+ * @param cpuGovernor Pointer to the CpuFrequencyGovernor (UI activity).
+ * @param wifiManager Pointer to the WifiManager (radio state).
+ * @param btManager Pointer to the BLEManager (radio state).
+ */
+IdleSleepController::IdleSleepController(LGFX* lcd, ScreenSaverManager* screenSaverManager, AudioManager* audioManager,
+                                         CpuFrequencyGovernor* cpuGovernor, WifiManager* wifiManager, BLEManager* btManager)
+  : _lcd(lcd),
+    _screenSaverManager(screenSaverManager),
+    _audioManager(audioManager),
+    _cpuGovernor(cpuGovernor),
+    _wifiManager(wifiManager),
+    _btManager(btManager),
+    _config(nullptr),
+    _wakeSignal(nullptr),
+    _backlightInSleep(false),
+    _idle(false),
+    _lastBrightness(0),
+    _lastActivityMs(0),
+    _lastWakeMs(0),
+    _wakePending(false),
+    _wakeUs(0),
+    _windowStartUs(0),
+    _idleStartUs(0),
+    _idleUs(0),
+    _lightSleepUs(0),
+    _waitUs(0),
+    _lightSleeps(0),
+    _interruptWakes(0),
+    _latencyCount(0),
+    _latencySumUs(0),
+    _latencyMaxUs(0),
+    _latencyOverBudget(0),
+    _reportTimer([this]() { logReport(); }) {}
+
+/**
+ * @brief Destructor. Detaches the interrupts and deletes the wake signal.
+ */
+IdleSleepController::~IdleSleepController() {
+  if (_config) {
+    detachInterrupt(_config->touchIntPin);
+    if (_config->rfidIrqPin >= 0) detachInterrupt(_config->rfidIrqPin);
+  }
+  if (_wakeSignal) vSemaphoreDelete(_wakeSignal);
+}
+
+/**
+ * @brief Attaches the wake interrupts and prepares the backlight for light sleep.
+ * @param config Wake pins, sleep limits and the report interval.
+ * @return True if ready (or disabled), false if the touch interrupt could not be set up.
+ */
+bool IdleSleepController::init(const IdleSleepConfig& config) {
+  DEBUG_INFO_PRINTLN("IdleSleepController: init() starting...");
+  if (!config.enabled) {
+    DEBUG_INFO_PRINTLN("IdleSleepController: Disabled, the main loop keeps polling.");
+    return true;
+  }
+  if (config.touchIntPin < 0 || !GPIO_IS_VALID_GPIO(config.touchIntPin)) {
+    DEBUG_ERROR_PRINTF("IdleSleepController: Touch INT pin %d is not valid.\n", config.touchIntPin);
+    return false;
+  }
+
+  _wakeSignal = xSemaphoreCreateBinary();
+  if (!_wakeSignal) {
+    DEBUG_ERROR_PRINTLN("IdleSleepController: Failed to create the wake signal.");
+    return false;
+  }
+
+  // The touch driver reads INT as an input as well; the interrupt only adds the falling edge.
+  pinMode(config.touchIntPin, INPUT_PULLUP);
+  attachInterruptArg(config.touchIntPin, _onWakeInterrupt, this, FALLING);
+  if (config.rfidIrqPin >= 0) {
+    pinMode(config.rfidIrqPin, INPUT_PULLUP);
+    attachInterruptArg(config.rfidIrqPin, _onWakeInterrupt, this, FALLING);
+  }
+  _config = &config;
+
+  _backlightInSleep = config.lightSleep && _keepBacklightInSleep();
+
+  _lastBrightness = _lcd ? _lcd->getBrightness() : 0;
+  _lastActivityMs = millis();
+  _lastWakeMs = _lastActivityMs;
+  _windowStartUs = esp_timer_get_time();
+
+  if (config.reportIntervalMs > 0) {
+    g_timerWheel.start(_reportTimer, config.reportIntervalMs, config.reportIntervalMs);
+  }
+  DEBUG_INFO_PRINTF("IdleSleepController: Initialized (touch INT %d, RFID IRQ %d, light sleep %s, backlight in sleep %s).\n",
+                    config.touchIntPin, config.rfidIrqPin, config.lightSleep ? "on" : "off",
+                    _backlightInSleep ? "kept" : "only when off");
+  return true;
+}
+
+/**
+ * @brief Decides whether the UI is idle: screensaver active, no audio, CPU governor not boosted and
+ * the backlight unchanged for `settleMs` (the screensaver fades run at frame rate).
+ */
+void IdleSleepController::loop() {
+  if (!_config) return;
+  const unsigned long now = millis();
+
+  const uint8_t brightness = _lcd ? _lcd->getBrightness() : 0;
+  const bool active = !(_screenSaverManager && _screenSaverManager->isActive()) ||
+                      (_audioManager && _audioManager->isPlaybackActive()) ||
+                      (_cpuGovernor && _cpuGovernor->isBoosted()) ||
+                      brightness != _lastBrightness;
+  _lastBrightness = brightness;
+  if (active) _lastActivityMs = now;
+
+  const bool idle = now - _lastActivityMs >= _config->settleMs;
+  if (idle == _idle) return;
+  _idle = idle;
+
+  const int64_t nowUs = esp_timer_get_time();
+  if (idle) {
+    _idleStartUs = nowUs;
+  } else {
+    _idleUs += nowUs - std::max(_idleStartUs, _windowStartUs);
+  }
+  DEBUG_TRACE_PRINTF("IdleSleepController: %s.\n", idle ? "Idle, waiting for interrupts" : "Active, polling");
+}
+
+/**
+ * @brief Reports the end of the render pass; completes a pending wake latency measurement.
+ */
+void IdleSleepController::onFrame() {
+  if (!_wakePending) return;
+  _wakePending = false;
+
+  const uint32_t latencyUs = (uint32_t)(esp_timer_get_time() - _wakeUs);
+  _latencyCount++;
+  _latencySumUs += latencyUs;
+  if (latencyUs > _latencyMaxUs) _latencyMaxUs = latencyUs;
+  if (latencyUs > _config->wakeFrameBudgetUs) _latencyOverBudget++;
+  DEBUG_TRACE_PRINTF("IdleSleepController: Wake to first frame %uus.\n", (unsigned)latencyUs);
+}
+
+/**
+ * @brief Ends the main loop pass: a plain `delay()` while the UI is active, otherwise a wait for a
+ * wake interrupt (in light sleep if possible) of at most `ms`.
+ * @param ms Time until the next timer deadline.
+ */
+void IdleSleepController::sleep(uint32_t ms) {
+  if (!_config || !_idle) {
+    delay(ms);
+    return;
+  }
+
+  // Let the worker tasks (battery, RFID, Wi-Fi) run for a while after each wake; a light sleep
+  // stops them together with the main loop.
+  const unsigned long awakeMs = millis() - _lastWakeMs;
+  if (awakeMs < _config->minAwakeMs) {
+    const uint32_t stayMs = std::min<uint32_t>(ms, _config->minAwakeMs - awakeMs);
+    _waitForInterrupt(stayMs);
+    if (_wakePending) return;
+    ms -= stayMs;
+    if (ms == 0) return;
+  }
+
+  if (ms >= _config->minSleepMs && _canLightSleep()) {
+    _lightSleep(ms);
+  } else {
+    _waitForInterrupt(ms);
+  }
+}
+
+/**
+ * @brief Returns the longest wait of the idle state, the cap for the next timer deadline.
+ * @return The time in milliseconds.
+ */
+uint32_t IdleSleepController::getMaxSleepMs() const {
+  return _config ? _config->maxSleepMs : MAIN_LOOP_MAX_SLEEP_MS;
+}
+
+/**
+ * @brief Prints the idle and sleep residency, the wake causes and the wake-to-frame latency, and
+ * starts a new reporting window.
+ */
+void IdleSleepController::logReport() {
+  const int64_t nowUs = esp_timer_get_time();
+  uint64_t idleUs = _idleUs;
+  if (_idle) idleUs += nowUs - std::max(_idleStartUs, _windowStartUs);
+  const float windowUs = (float)(nowUs - _windowStartUs);
+
+  DEBUG_INFO_PRINTF("IdleSleepController: Idle %.1f%% of %us, light sleep %.1f%% (%u sleeps), waiting awake %.1f%%.\n",
+                    windowUs > 0 ? 100.0f * idleUs / windowUs : 0.0f, (unsigned)((nowUs - _windowStartUs) / 1000000),
+                    windowUs > 0 ? 100.0f * _lightSleepUs / windowUs : 0.0f, (unsigned)_lightSleeps,
+                    windowUs > 0 ? 100.0f * _waitUs / windowUs : 0.0f);
+  DEBUG_INFO_PRINTF("IdleSleepController: %u interrupt wakes, wake to first frame avg %uus, max %uus, %u over %uus.\n",
+                    (unsigned)_interruptWakes, (unsigned)(_latencyCount ? _latencySumUs / _latencyCount : 0),
+                    (unsigned)_latencyMaxUs, (unsigned)_latencyOverBudget, (unsigned)_config->wakeFrameBudgetUs);
+
+  _windowStartUs = nowUs;
+  _idleUs = 0;
+  _lightSleepUs = 0;
+  _waitUs = 0;
+  _lightSleeps = 0;
+  _interruptWakes = 0;
+  _latencyCount = 0;
+  _latencySumUs = 0;
+  _latencyMaxUs = 0;
+  _latencyOverBudget = 0;
+}
+
+/**
+ * @brief Wake interrupt handler; gives the wake signal.
+ * @param arg The IdleSleepController instance.
+ */
+void IRAM_ATTR IdleSleepController::_onWakeInterrupt(void* arg) {
+  IdleSleepController* self = static_cast<IdleSleepController*>(arg);
+  BaseType_t higherPriorityTaskWoken = pdFALSE;
+  xSemaphoreGiveFromISR(self->_wakeSignal, &higherPriorityTaskWoken);
+  if (higherPriorityTaskWoken) portYIELD_FROM_ISR();
+}
+
+/**
+ * @brief Checks whether a wake line is asserted (low).
+ * @return True if the touch or RFID line is low.
+ */
+bool IdleSleepController::_wakeLineAsserted() const {
+  if (digitalRead(_config->touchIntPin) == LOW) return true;
+  return _config->rfidIrqPin >= 0 && digitalRead(_config->rfidIrqPin) == LOW;
+}
+
+/**
+ * @brief Checks whether light sleep may be entered now. The radio drivers keep their connections
+ * only with automatic light sleep, and the backlight PWM stops unless its timer runs from RC_FAST.
+ * @return True if enabled, the radios are off and the backlight survives the sleep.
+ */
+bool IdleSleepController::_canLightSleep() const {
+  if (!_config->lightSleep) return false;
+  if (_wifiManager && _wifiManager->isWifiLogicEnabled()) return false;
+  if (_btManager && _btManager->isEnabled()) return false;
+  return _backlightInSleep || (_lcd && _lcd->getBrightness() == 0);
+}
+
+/**
+ * @brief Blocks on the wake signal. A line that is already low (touched during the loop pass)
+ * ends the wait at once, since its edge has been consumed.
+ * @param ms The longest wait.
+ */
+void IdleSleepController::_waitForInterrupt(uint32_t ms) {
+  xSemaphoreTake(_wakeSignal, 0); // Drop edges seen while awake; the level check below covers them.
+  if (_wakeLineAsserted()) {
+    _markWake(esp_timer_get_time());
+    return;
+  }
+  const int64_t startUs = esp_timer_get_time();
+  const bool woken = xSemaphoreTake(_wakeSignal, pdMS_TO_TICKS(std::max<uint32_t>(ms, 1))) == pdTRUE;
+  const int64_t endUs = esp_timer_get_time();
+  _waitUs += endUs - startUs;
+  if (woken) _markWake(endUs);
+}
+
+/**
+ * @brief Enters light sleep with GPIO and timer wake-up. The scheduler is stopped for the whole
+ * sleep; esp_timer, millis() and the tick count are corrected on wake.
+ * @param ms The longest sleep.
+ */
+void IdleSleepController::_lightSleep(uint32_t ms) {
+  if (_wakeLineAsserted()) {
+    _markWake(esp_timer_get_time());
+    return;
+  }
+
+  uart_wait_tx_idle_polling((uart_port_t)CONFIG_ESP_CONSOLE_UART_NUM); // Otherwise the pending debug output is cut.
+  _setGpioWakeup(_config->touchIntPin, true);
+  _setGpioWakeup(_config->rfidIrqPin, true);
+  esp_sleep_enable_gpio_wakeup();
+  esp_sleep_enable_timer_wakeup((uint64_t)ms * 1000);
+
+  const int64_t startUs = esp_timer_get_time();
+  const esp_err_t err = esp_light_sleep_start();
+  const int64_t endUs = esp_timer_get_time();
+  const esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+  esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_GPIO);
+  _setGpioWakeup(_config->touchIntPin, false);
+  _setGpioWakeup(_config->rfidIrqPin, false);
+
+  if (err != ESP_OK) {
+    // Rejected (e.g. a wake source was already pending): do not spin on it.
+    DEBUG_TRACE_PRINTF("IdleSleepController: Light sleep rejected (%s).\n", esp_err_to_name(err));
+    _waitForInterrupt(ms);
+    return;
+  }
+  _lightSleeps++;
+  _lightSleepUs += endUs - startUs;
+  _lastWakeMs = millis();
+  if (cause == ESP_SLEEP_WAKEUP_GPIO) _markWake(endUs);
+}
+
+/**
+ * @brief Switches the GPIO wake-up of a pin on or off around a light sleep. The wake-up needs a
+ * level trigger, which would fire continuously as an interrupt while the line is held low, so the
+ * edge interrupt is disabled for the sleep and restored afterwards.
+ * @param pin The pin, or -1.
+ * @param enable True before the sleep, false after it.
+ */
+void IdleSleepController::_setGpioWakeup(int pin, bool enable) {
+  if (pin < 0) return;
+  const gpio_num_t gpio = (gpio_num_t)pin;
+  if (enable) {
+    gpio_intr_disable(gpio);
+    gpio_wakeup_enable(gpio, GPIO_INTR_LOW_LEVEL);
+  } else {
+    gpio_wakeup_disable(gpio);
+    gpio_set_intr_type(gpio, GPIO_INTR_NEGEDGE);
+    gpio_intr_enable(gpio);
+  }
+}
+
+/**
+ * @brief Moves the backlight LEDC timer to the RC_FAST clock, which keeps running in light sleep,
+ * and keeps that oscillator powered during the sleep. The channel keeps its duty.
+ * @return True on success.
+ */
+bool IdleSleepController::_keepBacklightInSleep() {
+  ledc_timer_config_t timerConfig = {};
+  timerConfig.speed_mode = LEDC_LOW_SPEED_MODE;
+  timerConfig.duty_resolution = LEDC_TIMER_8_BIT;                                  // LovyanGFX Light_PWM resolution.
+  timerConfig.timer_num = (ledc_timer_t)((_config->backlightPwmChannel / 2) % LEDC_TIMER_MAX); // Arduino core channel-to-timer mapping.
+  timerConfig.freq_hz = _config->backlightPwmFreq;
+  timerConfig.clk_cfg = LEDC_USE_RC_FAST_CLK;
+
+  esp_err_t err = ledc_timer_config(&timerConfig);
+  if (err == ESP_OK) {
+    err = esp_sleep_pd_config(ESP_PD_DOMAIN_RC_FAST, ESP_PD_OPTION_ON);
+  }
+  if (err != ESP_OK) {
+    // Most likely another LEDC timer holds the APB clock (all low speed timers share the source).
+    DEBUG_WARN_PRINTF("IdleSleepController: Backlight PWM cannot run in light sleep (%s), sleeping only with the backlight off.\n",
+                      esp_err_to_name(err));
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Records a wake by interrupt for the latency measurement.
+ * @param wakeUs The esp_timer time of the wake.
+ */
+void IdleSleepController::_markWake(int64_t wakeUs) {
+  _interruptWakes++;
+  _wakePending = true;
+  _wakeUs = wakeUs;
+  _lastWakeMs = millis();
+}
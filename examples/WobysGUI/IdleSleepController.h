@@ -0,0 +1,213 @@
+/**
+ * @file IdleSleepController.h
+ * @brief Defines the IdleSleepController class, which stops the main loop from polling while the
+ * screensaver idles and puts the chip into light sleep between timer deadlines.
+ *
+ * Outside the idle state the main loop sleeps up to MAIN_LOOP_MAX_SLEEP_MS and polls the touch
+ * controller over I2C on every pass. The FT5x06 pulls its INT line low while the panel is touched,
+ * so once the screensaver is active, no audio plays, the CPU governor has dropped the clock and the
+ * backlight has settled, the controller waits for that line (and an optional RFID IRQ line) instead,
+ * up to the next timer deadline. If the radios are off the wait is an `esp_light_sleep_start()` with
+ * GPIO and timer wake-up; with Wi-Fi or Bluetooth on, the radio drivers need the system awake, and
+ * the wait is a plain block on the interrupt.
+ *
+ * Light sleep only clock-gates the digital peripherals: the ST7796 keeps its GRAM, the LCD and I2S
+ * registers keep their configuration, and the main loop never sleeps in the middle of a transfer or
+ * while audio plays. The backlight PWM runs from the APB clock, which stops in light sleep; the
+ * controller moves its LEDC timer to the RC_FAST clock, and if that fails, only sleeps while the
+ * backlight is off.
+ *
+ * The time from every touch wake to the end of the first rendered frame is measured and reported
+ * together with the idle and sleep residency.
+ *
+ * @version 1.0.0
+ * @date 2025-09-08
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef IDLE_SLEEP_CONTROLLER_H
+#define IDLE_SLEEP_CONTROLLER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "Config.h"
+#include "TimerWheel.h"
+
+// Forward declarations
+class ScreenSaverManager;
+class AudioManager;
+class CpuFrequencyGovernor;
+class WifiManager;
+class BLEManager;
+struct IdleSleepConfig; // Defined in SystemInitializer.h
+
+/**
+ * @brief Interrupt-driven idle wait and light sleep for the main loop. Main loop task only.
+ */
+class IdleSleepController {
+public:
+  /**
+   * @brief Constructor for the IdleSleepController class.
+   * @param lcd Pointer to the LGFX display (backlight level).
+   * @param screenSaverManager Pointer to the ScreenSaverManager (user presence).
+   * @param audioManager Pointer to the AudioManager (playback state).
+   * @param cpuGovernor Pointer to the CpuFrequencyGovernor (UI activity).
+   * @param wifiManager Pointer to the WifiManager (radio state).
+   * @param btManager Pointer to the BLEManager (radio state).
+   */
+  IdleSleepController(LGFX* lcd, ScreenSaverManager* screenSaverManager, AudioManager* audioManager,
+                      CpuFrequencyGovernor* cpuGovernor, WifiManager* wifiManager, BLEManager* btManager);
+
+  /**
+   * @brief Destructor. Detaches the interrupts and deletes the wake signal.
+   */
+  ~IdleSleepController();
+
+  /**
+   * @brief Attaches the wake interrupts and prepares the backlight for light sleep.
+   * @param config Wake pins, sleep limits and the report interval.
+   * @return True if ready (or disabled by the configuration), false if the touch interrupt could
+   *         not be set up; the main loop then keeps polling.
+   */
+  bool init(const IdleSleepConfig& config);
+
+  /**
+   * @brief Decides whether the UI is idle. Call once per main loop pass, after the CPU governor.
+   */
+  void loop();
+
+  /**
+   * @brief Reports the end of the render pass; completes a pending wake latency measurement.
+   */
+  void onFrame();
+
+  /**
+   * @brief Ends the main loop pass: a plain `delay()` while the UI is active, otherwise a wait for a
+   * wake interrupt (in light sleep if possible) of at most `ms`.
+   * @param ms Time until the next timer deadline.
+   */
+  void sleep(uint32_t ms);
+
+  /**
+   * @brief Checks whether the UI is idle.
+   * @return True while the main loop waits for interrupts.
+   */
+  bool isIdle() const { return _idle; }
+
+  /**
+   * @brief Returns the longest wait of the idle state, the cap for the next timer deadline.
+   * @return The time in milliseconds.
+   */
+  uint32_t getMaxSleepMs() const;
+
+  /**
+   * @brief Prints the idle and sleep residency, the wake causes and the wake-to-frame latency, and
+   * starts a new reporting window.
+   */
+  void logReport();
+
+private:
+  LGFX* _lcd;                                    ///< Pointer to the display (not owned).
+  ScreenSaverManager* _screenSaverManager;       ///< Pointer to the ScreenSaverManager (not owned).
+  AudioManager* _audioManager;                   ///< Pointer to the AudioManager (not owned).
+  CpuFrequencyGovernor* _cpuGovernor;            ///< Pointer to the CpuFrequencyGovernor (not owned).
+  WifiManager* _wifiManager;                     ///< Pointer to the WifiManager (not owned).
+  BLEManager* _btManager;                        ///< Pointer to the BLEManager (not owned).
+  const IdleSleepConfig* _config;                ///< Pointer to the configuration (owned by SystemInitializer).
+
+  SemaphoreHandle_t _wakeSignal;                 ///< Given by the wake interrupts.
+  bool _backlightInSleep;                        ///< True if the backlight PWM keeps running in light sleep.
+  bool _idle;                                    ///< True while the UI is idle.
+  uint8_t _lastBrightness;                       ///< Backlight level seen by the last `loop()`.
+  unsigned long _lastActivityMs;                 ///< millis() of the last backlight change or non-idle pass.
+  unsigned long _lastWakeMs;                     ///< millis() of the last wake.
+  bool _wakePending;                             ///< True from a wake interrupt until the next frame.
+  int64_t _wakeUs;                               ///< esp_timer time of that wake.
+
+  int64_t _windowStartUs;                        ///< Start of the current reporting window.
+  int64_t _idleStartUs;                          ///< Start of the current idle period.
+  uint64_t _idleUs;                              ///< Time idle in the window (completed periods).
+  uint64_t _lightSleepUs;                        ///< Time in light sleep in the window.
+  uint64_t _waitUs;                              ///< Time blocked on the wake signal (awake) in the window.
+  uint32_t _lightSleeps;                         ///< Light sleeps in the window.
+  uint32_t _interruptWakes;                      ///< Wakes by touch or RFID in the window.
+  uint32_t _latencyCount;                        ///< Wake latencies measured in the window.
+  uint64_t _latencySumUs;                        ///< Sum of the wake latencies.
+  uint32_t _latencyMaxUs;                        ///< Longest wake latency.
+  uint32_t _latencyOverBudget;                   ///< Wake latencies above `wakeFrameBudgetUs`.
+  TimerWheel::Timer _reportTimer;                ///< Periodic report on `g_timerWheel`.
+
+  /**
+   * @brief Wake interrupt handler; gives the wake signal.
+   * @param arg The IdleSleepController instance.
+   */
+  static void IRAM_ATTR _onWakeInterrupt(void* arg);
+
+  /**
+   * @brief Checks whether a wake line is asserted (low).
+   * @return True if the touch or RFID line is low.
+   */
+  bool _wakeLineAsserted() const;
+
+  /**
+   * @brief Checks whether light sleep may be entered now.
+   * @return True if enabled, the radios are off and the backlight survives the sleep.
+   */
+  bool _canLightSleep() const;
+
+  /**
+   * @brief Blocks on the wake signal.
+   * @param ms The longest wait.
+   */
+  void _waitForInterrupt(uint32_t ms);
+
+  /**
+   * @brief Enters light sleep with GPIO and timer wake-up.
+   * @param ms The longest sleep.
+   */
+  void _lightSleep(uint32_t ms);
+
+  /**
+   * @brief Switches the GPIO wake-up of a pin on or off around a light sleep.
+   * @param pin The pin, or -1.
+   * @param enable True before the sleep (low level wake, edge interrupt off), false after it.
+   */
+  static void _setGpioWakeup(int pin, bool enable);
+
+  /**
+   * @brief Moves the backlight LEDC timer to the RC_FAST clock, which keeps running in light sleep.
+   * @return True on success.
+   */
+  bool _keepBacklightInSleep();
+
+  /**
+   * @brief Records a wake by interrupt for the latency measurement.
+   * @param wakeUs The esp_timer time of the wake.
+   */
+  void _markWake(int64_t wakeUs);
+};
+
+#endif // IDLE_SLEEP_CONTROLLER_H
@@ -144,6 +144,7 @@ const char* default_en_json = R"({
     "BLE_STATUS_DISABLED": "Bluetooth disabled.",
     "BLE_STATUS_SCAN_PENDING": "Device search pending...",
     "BLE_STATUS_SCANNING": "Scanning in progress...",
+    "BLE_STATUS_DEVICES_FOUND": "devices found",
     "BLE_STATUS_CONNECTING": "Connecting",
     "BLE_STATUS_CONNECTED": "Connected",
     "BLE_STATUS_DISCONNECTED": "disconnected",
@@ -178,8 +179,24 @@ const char* default_en_json = R"({
     "INIT_LANG_MGR_FAILED": "LangMgr Init Failed!",
     "INIT_RFID_MGR_FAILED": "RFIDMgr Init Failed!",
     "INIT_WIFI_MGR_FAILED": "WifiMgr Init Failed!",
+    "INIT_WIFI_EVENTS_FAILED": "Wi-Fi task failed!",
+    "INIT_WIFI_POWER_FAILED": "Wi-Fi power saving unavailable!",
+    "INIT_REMOTE_UI_FAILED": "Remote UI unavailable!",
+    "INIT_OTA_FAILED": "Firmware updates unavailable!",
+    "INIT_TELEMETRY_FAILED": "Telemetry unavailable!",
+    "INIT_MANAGER_TASKS_FAILED": "Peripheral tasks unavailable!",
+    "INIT_CPU_GOVERNOR_FAILED": "CPU clock scaling unavailable!",
+    "INIT_IDLE_SLEEP_FAILED": "Idle sleep unavailable!",
+    "INIT_DISPLAY_SLEEP_FAILED": "Display sleep unavailable!",
+    "OTA_PROGRESS": "Updating firmware",
+    "OTA_VERIFYING": "Verifying update...",
+    "OTA_READY": "Update installed, restarting...",
+    "OTA_FAILED": "Firmware update failed!",
+    "OTA_INTERRUPTED": "Firmware update interrupted.",
+    "OTA_ROLLED_BACK": "Update failed, previous firmware restored.",
     "INIT_TIME_MGR_FAILED": "TimeMgr Init Failed!",
     "INIT_BLE_MGR_FAILED": "BLEMgr Init Failed!",
+    "INIT_BLE_NOTIFY_FAILED": "BLE data pipeline failed!",
     "INIT_SSAVER_MGR_FAILED": "SSaverMgr Init Failed!",
     "INIT_AUDIO_MGR_FAILED": "AudioMgr Init Failed!",
     "INIT_TIME_UI_ERROR": "Time UI Init Error!",
@@ -189,6 +206,7 @@ const char* default_en_json = R"({
     "INIT_WIFI_UI_ERROR": "WiFi UI Init Error!",
     "INIT_SD_UI_ERROR_UI": "SD UI Init Error!",
     "INIT_BATTERY_UI_ERROR": "Battery UI Init Error!",
+    "INIT_BATTERY_RUNTIME_UI_ERROR": "Battery Runtime UI Init Error!",
     "BOOT_IMAGE_NOT_FOUND": "Boot image not found!",
 
     "SHUTDOWN_STATUS_SAVE_SETTINGS": "Saving settings...",
@@ -319,6 +337,7 @@ const char* default_hu_json = R"({
     "BLE_STATUS_DISABLED": "Bluetooth kikapcsolva.",
     "BLE_STATUS_SCAN_PENDING": "Eszközkeresés függőben...",
     "BLE_STATUS_SCANNING": "Keresés folyamatban...",
+    "BLE_STATUS_DEVICES_FOUND": "eszköz található",
     "BLE_STATUS_CONNECTING": "Csatlakozás",
     "BLE_STATUS_CONNECTED": "Csatlakoztatva",
     "BLE_STATUS_DISCONNECTED": "Nincs csatlakoztatva",
@@ -353,8 +372,24 @@ const char* default_hu_json = R"({
     "INIT_LANG_MGR_FAILED": "LangMgr Inicializálás Sikertelen!",
     "INIT_RFID_MGR_FAILED": "RFIDMgr Inicializálás Sikertelen!",
     "INIT_WIFI_MGR_FAILED": "WifiMgr Inicializálás Sikertelen!",
+    "INIT_WIFI_EVENTS_FAILED": "Wi-Fi feladat indítása sikertelen!",
+    "INIT_WIFI_POWER_FAILED": "Wi-Fi energiatakarékosság nem elérhető!",
+    "INIT_REMOTE_UI_FAILED": "Távoli kezelőfelület nem elérhető!",
+    "INIT_OTA_FAILED": "Firmware frissítés nem elérhető!",
+    "INIT_TELEMETRY_FAILED": "Telemetria nem elérhető!",
+    "INIT_MANAGER_TASKS_FAILED": "Periféria taszkok nem elérhetők!",
+    "INIT_CPU_GOVERNOR_FAILED": "CPU órajel-szabályozás nem elérhető!",
+    "INIT_IDLE_SLEEP_FAILED": "Alvó üzemmód nem elérhető!",
+    "INIT_DISPLAY_SLEEP_FAILED": "Kijelző alvó üzemmód nem elérhető!",
+    "OTA_PROGRESS": "Firmware frissítése",
+    "OTA_VERIFYING": "Frissítés ellenőrzése...",
+    "OTA_READY": "Frissítés telepítve, újraindítás...",
+    "OTA_FAILED": "Firmware frissítés sikertelen!",
+    "OTA_INTERRUPTED": "Firmware frissítés megszakadt.",
+    "OTA_ROLLED_BACK": "Frissítés sikertelen, előző firmware visszaállítva.",
     "INIT_TIME_MGR_FAILED": "TimeMgr Inicializálás Sikertelen!",
     "INIT_BLE_MGR_FAILED": "BLEMgr Inicializálás Sikertelen!",
+    "INIT_BLE_NOTIFY_FAILED": "BLE adatcsatorna indítása sikertelen!",
     "INIT_SSAVER_MGR_FAILED": "Képernyővédő Mgr Inicializálás Sikertelen!",
     "INIT_AUDIO_MGR_FAILED": "AudioMgr Inicializálás Sikertelen!",
     "INIT_TIME_UI_ERROR": "Idő UI Init Hiba!",
@@ -364,6 +399,7 @@ const char* default_hu_json = R"({
     "INIT_WIFI_UI_ERROR": "WiFi UI Init Hiba!",
     "INIT_SD_UI_ERROR_UI": "SD UI Init Hiba!",
     "INIT_BATTERY_UI_ERROR": "Akkumulátor UI Init Hiba!",
+    "INIT_BATTERY_RUNTIME_UI_ERROR": "Akkumulátor Üzemidő UI Init Hiba!",
     "BOOT_IMAGE_NOT_FOUND": "Indító kép nem található!",
 
     "SHUTDOWN_STATUS_SAVE_SETTINGS": "Beállítások mentése...",
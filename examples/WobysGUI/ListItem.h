@@ -136,4 +136,18 @@ struct WifiListItemData {
         : ssid(s), rssi(r), encryptionType(enc) {}
 };
 
+/**
+ * @brief Maps an RSSI value to the signal strength glyph of the list rows ('b' weakest to 'f'
+ * strongest). Shared by the Wi-Fi and BLE lists so both show the same bars for the same level.
+ * @param rssi The RSSI value in dBm.
+ * @return A character representing the signal strength icon.
+ */
+inline char mapRssiToSignalIcon(int32_t rssi) {
+    if (rssi >= -55) return 'f'; // Strongest signal
+    if (rssi >= -65) return 'e';
+    if (rssi >= -75) return 'd';
+    if (rssi >= -85) return 'c';
+    return 'b'; // Weakest signal
+}
+
 #endif // LISTITEM_H
\ No newline at end of file
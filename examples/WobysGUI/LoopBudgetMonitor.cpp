@@ -0,0 +1,183 @@
+/**
+ * @file LoopBudgetMonitor.cpp
+ * @brief Implements the LoopBudgetMonitor class.
+ *
+ * @version 1.0.0
+ * @date 2025-09-02
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "LoopBudgetMonitor.h"
+#include "SystemInitializer.h" // For LoopBudgetMonitorConfig
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <string.h>
+
+/**
+ * @brief Constructor for LoopBudgetMonitor.
+ */
+LoopBudgetMonitor::LoopBudgetMonitor()
+  : _count(0),
+    _cursor(0),
+    _lastCycles(0),
+    _cyclesPerUs(1),
+    _defaultBudgetUs(0),
+    _overrunLogIntervalMs(0),
+    _reportTimer([this]() { logReport(); }) {
+  memset(_subsystems, 0, sizeof(_subsystems));
+}
+
+/**
+ * @brief Applies the configuration, starts the periodic report and optionally puts the loop
+ * task under the task watchdog.
+ * @param config Budget and reporting parameters.
+ */
+void LoopBudgetMonitor::init(const LoopBudgetMonitorConfig& config) {
+  _defaultBudgetUs = config.defaultBudgetUs;
+  _overrunLogIntervalMs = config.overrunLogIntervalMs;
+
+  if (config.reportIntervalMs > 0) {
+    g_timerWheel.start(_reportTimer, config.reportIntervalMs, config.reportIntervalMs);
+  }
+  if (config.escalateToTaskWdt) {
+    // The Arduino loop task feeds the watchdog after every loop() pass, so a subsystem that
+    // hangs longer than the watchdog timeout panics with the loop task's backtrace.
+    enableLoopWDT();
+    DEBUG_INFO_PRINTLN("LoopBudgetMonitor: Loop task added to the task watchdog.");
+  }
+  DEBUG_INFO_PRINTF("LoopBudgetMonitor: init() completed (default budget %uus).\n", (unsigned)_defaultBudgetUs);
+}
+
+/**
+ * @brief Retrieves the statistics of a subsystem for the current reporting window.
+ * @param index Subsystem index, in first-seen order.
+ * @param out Receives the statistics.
+ * @return True if the index is valid, false otherwise.
+ */
+bool LoopBudgetMonitor::getStats(size_t index, SubsystemStats& out) const {
+  if (index >= _count) return false;
+  const Subsystem& s = _subsystems[index];
+  out.name = s.name;
+  out.budgetUs = s.budgetUs;
+  out.ticks = s.ticks;
+  out.p50Us = _percentile(s, 50);
+  out.p99Us = _percentile(s, 99);
+  out.maxUs = s.maxUs;
+  out.overruns = s.overruns;
+  return true;
+}
+
+/**
+ * @brief Prints the statistics of every subsystem and starts a new reporting window.
+ */
+void LoopBudgetMonitor::logReport() {
+  DEBUG_INFO_PRINTLN("LoopBudgetMonitor: subsystem        ticks     p50     p99     max  budget  overruns");
+  for (size_t i = 0; i < _count; i++) {
+    SubsystemStats stats;
+    getStats(i, stats);
+    DEBUG_INFO_PRINTF("LoopBudgetMonitor: %-14s %7u %6uus %6uus %6uus %6uus %9u\n",
+                      stats.name, (unsigned)stats.ticks, (unsigned)stats.p50Us, (unsigned)stats.p99Us,
+                      (unsigned)stats.maxUs, (unsigned)stats.budgetUs, (unsigned)stats.overruns);
+
+    Subsystem& s = _subsystems[i];
+    s.ticks = 0;
+    s.maxUs = 0;
+    s.overruns = 0;
+    memset(s.histogram, 0, sizeof(s.histogram));
+  }
+  _lastCycles = esp_cpu_get_cycle_count(); // Printing is not charged to the running subsystem.
+}
+
+/**
+ * @brief Finds a subsystem by name, registering it if it is new.
+ * @param name Subsystem name.
+ * @param budgetUs Budget for a new subsystem, or 0 for the default.
+ * @return The subsystem, or the overflow slot if the table is full.
+ */
+LoopBudgetMonitor::Subsystem* LoopBudgetMonitor::_lookup(const char* name, uint32_t budgetUs) {
+  for (size_t i = 0; i < _count; i++) {
+    if (_subsystems[i].name == name) return &_subsystems[i];
+  }
+  if (_count >= MAX_SUBSYSTEMS) {
+    if (_overflow->ticks++ == 0) {
+      DEBUG_WARN_PRINTF("LoopBudgetMonitor: Too many subsystems, '%s' is not tracked.\n", name);
+    }
+    return _overflow;
+  }
+  Subsystem& s = _subsystems[_count++];
+  s.name = name;
+  s.budgetUs = budgetUs ? budgetUs : _defaultBudgetUs;
+  return &s;
+}
+
+/**
+ * @brief Counts a budget overrun and prints a rate-limited diagnostic: the subsystem, the tick
+ * duration and the loop task's stack high-water mark.
+ * @param s The subsystem that ran over.
+ * @param us The tick duration in microseconds.
+ */
+void LoopBudgetMonitor::_onOverrun(Subsystem& s, uint32_t us) {
+  s.overruns++;
+  const uint32_t nowMs = millis();
+  if (s.lastDiagnosticMs != 0 && nowMs - s.lastDiagnosticMs < _overrunLogIntervalMs) return;
+  s.lastDiagnosticMs = nowMs ? nowMs : 1;
+
+  DEBUG_WARN_PRINTF("LoopBudgetMonitor: '%s' took %uus (budget %uus, p99 %uus, %u overruns in window), loop stack free %u bytes.\n",
+                    s.name, (unsigned)us, (unsigned)s.budgetUs, (unsigned)_percentile(s, 99),
+                    (unsigned)s.overruns, (unsigned)uxTaskGetStackHighWaterMark(NULL));
+  // The diagnostic itself must not be charged to the next subsystem.
+  _lastCycles = esp_cpu_get_cycle_count();
+}
+
+/**
+ * @brief Computes a percentile from a subsystem's histogram.
+ * @param s The subsystem.
+ * @param percent The percentile (1..100).
+ * @return Upper bound of the bucket holding the percentile, capped at the maximum seen.
+ */
+uint32_t LoopBudgetMonitor::_percentile(const Subsystem& s, uint32_t percent) {
+  if (s.ticks == 0) return 0;
+  const uint32_t target = (uint32_t)(((uint64_t)s.ticks * percent + 99) / 100);
+  uint32_t seen = 0;
+  for (uint8_t bucket = 0; bucket < BUCKETS; bucket++) {
+    seen += s.histogram[bucket];
+    if (seen >= target) {
+      uint32_t upper = _bucketUpperUs(bucket);
+      return upper < s.maxUs ? upper : s.maxUs;
+    }
+  }
+  return s.maxUs;
+}
+
+/**
+ * @brief Returns the largest duration that maps to a bucket.
+ * @param bucket The bucket index.
+ * @return Upper bound in microseconds.
+ */
+uint32_t LoopBudgetMonitor::_bucketUpperUs(uint8_t bucket) {
+  if (bucket < 4) return bucket;
+  if (bucket == BUCKETS - 1) return UINT32_MAX; // Open-ended last bucket.
+  const uint32_t exp = bucket / 4 + 1;
+  const uint32_t lower = (4 + (bucket & 3)) << (exp - 2);
+  return lower + (1UL << (exp - 2)) - 1;
+}
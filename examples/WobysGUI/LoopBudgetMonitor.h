@@ -0,0 +1,205 @@
+/**
+ * @file LoopBudgetMonitor.h
+ * @brief Defines the LoopBudgetMonitor class, which times every subsystem tick of the main loop
+ * against a budget.
+ *
+ * The main loop calls `startFrame()` once and `lap()` after each subsystem. Every lap reads the
+ * CPU cycle counter once, so the cost per tick stays well below a microsecond. Durations go into
+ * per-subsystem log-scale histograms (p50/p99/max are derived from them in the periodic report).
+ * A subsystem that runs over its budget prints a rate-limited diagnostic with its name, the tick
+ * duration and the loop task's stack high-water mark. A backtrace taken there would only show
+ * `lap()`, since the slow call has already returned. Optionally the loop task is also put under the task watchdog, so a subsystem that
+ * hangs resets the device with the watchdog's backtrace of the stuck call.
+ *
+ * @version 1.0.0
+ * @date 2025-09-02
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef LOOP_BUDGET_MONITOR_H
+#define LOOP_BUDGET_MONITOR_H
+
+#include <Arduino.h>
+#include <esp_cpu.h>
+#include <esp_rom_sys.h>
+
+#include "Config.h"
+#include "TimerWheel.h"
+
+// Forward declaration for configuration struct (defined in SystemInitializer.h)
+struct LoopBudgetMonitorConfig;
+
+/**
+ * @brief Per-subsystem timing of the main loop with budgets and overrun diagnostics.
+ *
+ * Subsystems are identified by the string literal passed to `lap()` and registered on first use.
+ * Must only be used from the main loop task.
+ */
+class LoopBudgetMonitor {
+public:
+    /**
+     * @brief Statistics of one subsystem over the current reporting window.
+     */
+    struct SubsystemStats {
+        const char* name;       ///< Subsystem name.
+        uint32_t budgetUs;      ///< Budget per tick in microseconds (0 for none).
+        uint32_t ticks;         ///< Ticks measured in the window.
+        uint32_t p50Us;         ///< Median tick duration (histogram bucket upper bound).
+        uint32_t p99Us;         ///< 99th percentile tick duration (histogram bucket upper bound).
+        uint32_t maxUs;         ///< Longest tick.
+        uint32_t overruns;      ///< Ticks that exceeded the budget.
+    };
+
+    /**
+     * @brief Constructor for LoopBudgetMonitor.
+     */
+    LoopBudgetMonitor();
+
+    /**
+     * @brief Applies the configuration, starts the periodic report and optionally puts the loop
+     * task under the task watchdog.
+     * @param config Budget and reporting parameters.
+     */
+    void init(const LoopBudgetMonitorConfig& config);
+
+    /**
+     * @brief Marks the start of a main loop iteration. The next `lap()` measures from here.
+     */
+    inline void startFrame() {
+        _cyclesPerUs = esp_rom_get_cpu_ticks_per_us(); // Follows CPU frequency changes.
+        _cursor = 0;
+        _lastCycles = esp_cpu_get_cycle_count();
+    }
+
+    /**
+     * @brief Ends the tick of a subsystem: records the time since the previous lap (or `startFrame()`).
+     * @param name Subsystem name. Must be a string literal (it is compared by address).
+     * @param budgetUs Budget per tick in microseconds, or 0 for the configured default.
+     */
+    inline void lap(const char* name, uint32_t budgetUs = 0) {
+        const uint32_t now = esp_cpu_get_cycle_count();
+        const uint32_t us = (now - _lastCycles) / _cyclesPerUs;
+        _lastCycles = now;
+
+        Subsystem* s = (_cursor < _count && _subsystems[_cursor].name == name) ? &_subsystems[_cursor] : _lookup(name, budgetUs);
+        _cursor = (s - _subsystems) + 1;
+        if (s == _overflow) return; // More subsystems than slots; not tracked.
+
+        s->ticks++;
+        s->histogram[_bucketFor(us)]++;
+        if (us > s->maxUs) s->maxUs = us;
+        if (s->budgetUs && us > s->budgetUs) _onOverrun(*s, us);
+    }
+
+    /**
+     * @brief Returns the number of registered subsystems.
+     * @return The subsystem count.
+     */
+    size_t getSubsystemCount() const { return _count; }
+
+    /**
+     * @brief Retrieves the statistics of a subsystem for the current reporting window.
+     * @param index Subsystem index (0 .. getSubsystemCount()-1), in first-seen order.
+     * @param out Receives the statistics.
+     * @return True if the index is valid, false otherwise.
+     */
+    bool getStats(size_t index, SubsystemStats& out) const;
+
+    /**
+     * @brief Prints the statistics of every subsystem and starts a new reporting window.
+     */
+    void logReport();
+
+private:
+    static constexpr size_t MAX_SUBSYSTEMS = 24;  ///< Maximum number of tracked subsystems.
+    static constexpr uint8_t BUCKETS = 64;        ///< Histogram buckets: 4 per power of two, up to ~115 ms.
+
+    /**
+     * @brief Timing state of one subsystem.
+     */
+    struct Subsystem {
+        const char* name;               ///< Subsystem name (string literal).
+        uint32_t budgetUs;              ///< Budget per tick in microseconds (0 for none).
+        uint32_t ticks;                 ///< Ticks in the window.
+        uint32_t maxUs;                 ///< Longest tick in the window.
+        uint32_t overruns;              ///< Budget overruns in the window.
+        uint32_t lastDiagnosticMs;      ///< Time of the last overrun diagnostic.
+        uint32_t histogram[BUCKETS];    ///< Tick duration histogram.
+    };
+
+    Subsystem _subsystems[MAX_SUBSYSTEMS + 1];       ///< Registered subsystems, plus one overflow slot.
+    Subsystem* const _overflow = &_subsystems[MAX_SUBSYSTEMS]; ///< Sink for subsystems beyond the limit.
+    size_t _count;                                   ///< Number of registered subsystems.
+    size_t _cursor;                                  ///< Expected index of the next lap (laps repeat in order).
+    uint32_t _lastCycles;                            ///< Cycle counter at the previous lap.
+    uint32_t _cyclesPerUs;                           ///< CPU cycles per microsecond.
+
+    uint32_t _defaultBudgetUs;                       ///< Budget for subsystems registered without one.
+    uint32_t _overrunLogIntervalMs;                  ///< Minimum time between two diagnostics of one subsystem.
+    TimerWheel::Timer _reportTimer;                  ///< Periodic report on `g_timerWheel`.
+
+    /**
+     * @brief Finds a subsystem by name, registering it if it is new.
+     * @param name Subsystem name.
+     * @param budgetUs Budget for a new subsystem, or 0 for the default.
+     * @return The subsystem, or the overflow slot if the table is full.
+     */
+    Subsystem* _lookup(const char* name, uint32_t budgetUs);
+
+    /**
+     * @brief Counts a budget overrun and prints a rate-limited diagnostic.
+     * @param s The subsystem that ran over.
+     * @param us The tick duration in microseconds.
+     */
+    void _onOverrun(Subsystem& s, uint32_t us);
+
+    /**
+     * @brief Computes a percentile from a histogram.
+     * @param s The subsystem.
+     * @param percent The percentile (1..100).
+     * @return Upper bound of the bucket holding the percentile, capped at the maximum seen.
+     */
+    static uint32_t _percentile(const Subsystem& s, uint32_t percent);
+
+    /**
+     * @brief Maps a duration to its histogram bucket (4 sub-buckets per power of two).
+     * @param us Duration in microseconds.
+     * @return The bucket index.
+     */
+    static inline uint8_t _bucketFor(uint32_t us) {
+        if (us < 4) return us;
+        const uint32_t exp = 31 - __builtin_clz(us);
+        const uint32_t index = 4 * (exp - 1) + ((us >> (exp - 2)) & 3);
+        return index < BUCKETS ? index : BUCKETS - 1;
+    }
+
+    /**
+     * @brief Returns the largest duration that maps to a bucket.
+     * @param bucket The bucket index.
+     * @return Upper bound in microseconds.
+     */
+    static uint32_t _bucketUpperUs(uint8_t bucket);
+};
+
+#endif // LOOP_BUDGET_MONITOR_H
@@ -0,0 +1,149 @@
+/**
+ * @file ManagerTask.cpp
+ * @brief Implements the ManagerTask class.
+ *
+ * @version 1.0.0
+ * @date 2025-09-01
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "ManagerTask.h"
+#include <esp_timer.h>
+
+/**
+ * @brief Constructor for ManagerTask.
+ * @param name Task name.
+ */
+ManagerTask::ManagerTask(const char* name)
+  : _name(name),
+    _taskHandle(nullptr),
+    _taskShouldRun(false),
+    _runs(0),
+    _busyUs(0),
+    _maxRunUs(0),
+    _windowStartUs(0) {
+  _taskDoneSignal = xSemaphoreCreateBinary();
+  if (!_taskDoneSignal) {
+    DEBUG_ERROR_PRINTF("ManagerTask(%s): ERROR - Failed to create semaphore!\n", _name);
+  }
+}
+
+/**
+ * @brief Destructor. Stops the task and releases FreeRTOS resources.
+ */
+ManagerTask::~ManagerTask() {
+  stop();
+  if (_taskDoneSignal) vSemaphoreDelete(_taskDoneSignal);
+}
+
+/**
+ * @brief Creates the task and starts running the work function.
+ * @param work The work function.
+ * @param stackSize Stack size of the task in bytes.
+ * @param priority FreeRTOS priority of the task.
+ * @param core Core the task is pinned to.
+ * @return True if the task is running, false if it could not be created.
+ */
+bool ManagerTask::start(Work work, uint32_t stackSize, UBaseType_t priority, BaseType_t core) {
+  if (_taskHandle) return true;
+  if (!work || !_taskDoneSignal) return false;
+
+  _work = std::move(work);
+  _windowStartUs = esp_timer_get_time();
+  _taskShouldRun = true;
+  BaseType_t rc = xTaskCreatePinnedToCore(_taskEntry, _name, stackSize, this, priority, &_taskHandle, core);
+  if (rc != pdPASS) {
+    _taskHandle = nullptr;
+    _taskShouldRun = false;
+    DEBUG_WARN_PRINTF("ManagerTask(%s): Failed to create task.\n", _name);
+    return false;
+  }
+  DEBUG_INFO_PRINTF("ManagerTask(%s): Started (priority %u, core %d).\n", _name, (unsigned)priority, (int)core);
+  return true;
+}
+
+/**
+ * @brief Asks the task to exit and waits for it.
+ */
+void ManagerTask::stop() {
+  if (!_taskHandle) return;
+  _taskShouldRun = false;
+  xTaskNotifyGive(_taskHandle);
+
+  if (xSemaphoreTake(_taskDoneSignal, pdMS_TO_TICKS(1000)) != pdTRUE) {
+    DEBUG_WARN_PRINTF("ManagerTask(%s): Timeout waiting for task termination. Forcibly deleting.\n", _name);
+    vTaskDelete(_taskHandle);
+  }
+  _taskHandle = nullptr;
+}
+
+/**
+ * @brief Makes the work function run as soon as possible.
+ */
+void ManagerTask::wake() {
+  if (_taskHandle) xTaskNotifyGive(_taskHandle);
+}
+
+/**
+ * @brief Returns the statistics of the window since the previous call and starts a new window.
+ * @return The statistics of the finished window.
+ */
+ManagerTaskStats ManagerTask::takeStats() {
+  const int64_t nowUs = esp_timer_get_time();
+  const int64_t windowUs = nowUs - _windowStartUs;
+  _windowStartUs = nowUs;
+
+  ManagerTaskStats stats;
+  stats.name = _name;
+  stats.runs = _runs.exchange(0);
+  const uint32_t busyUs = _busyUs.exchange(0);
+  stats.busyPermille = windowUs > 0 ? (uint32_t)((int64_t)busyUs * 1000 / windowUs) : 0;
+  stats.maxRunUs = _maxRunUs.exchange(0);
+  stats.stackFreeBytes = _taskHandle ? uxTaskGetStackHighWaterMark(_taskHandle) : 0; // Bytes on ESP-IDF.
+  return stats;
+}
+
+/**
+ * @brief Entry point of the task. Runs the work function, then sleeps for the delay it
+ * returned or until `wake()` is called.
+ * @param pvParameters Pointer to the ManagerTask instance.
+ */
+void ManagerTask::_taskEntry(void* pvParameters) {
+  ManagerTask* self = static_cast<ManagerTask*>(pvParameters);
+
+  while (self->_taskShouldRun) {
+    const int64_t startUs = esp_timer_get_time();
+    const uint32_t nextMs = self->_work();
+    const uint32_t runUs = (uint32_t)(esp_timer_get_time() - startUs);
+
+    self->_runs++;
+    self->_busyUs += runUs;
+    uint32_t maxUs = self->_maxRunUs.load();
+    while (runUs > maxUs && !self->_maxRunUs.compare_exchange_weak(maxUs, runUs)) {}
+
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(nextMs));
+  }
+
+  xSemaphoreGive(self->_taskDoneSignal);
+  vTaskDelete(NULL);
+}
@@ -0,0 +1,205 @@
+/**
+ * @file ManagerTask.h
+ * @brief Defines ManagerTask, a periodic FreeRTOS task for peripheral work, and ManagerMailbox,
+ * a typed queue that carries its results back to the UI task.
+ *
+ * A ManagerTask runs one work function at the interval the function itself returns and keeps
+ * simple CPU statistics (busy time per reporting window, longest run, stack headroom). The work
+ * function owns the slow hardware access (ADC, SPI); whatever it produces is posted into a
+ * ManagerMailbox and applied on the UI task, so UI elements are never touched off the UI task.
+ *
+ * @version 1.0.0
+ * @date 2025-09-01
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef MANAGER_TASK_H
+#define MANAGER_TASK_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <functional>
+#include <type_traits>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+
+#include "Config.h"
+
+/**
+ * @brief CPU statistics of one ManagerTask over a reporting window.
+ */
+struct ManagerTaskStats {
+    const char* name;           ///< Task name.
+    uint32_t runs;              ///< Work function calls in the window.
+    uint32_t busyPermille;      ///< Share of the window spent in the work function, in 1/1000.
+    uint32_t maxRunUs;          ///< Longest single run in the window, in microseconds.
+    uint32_t stackFreeBytes;    ///< Lowest free stack seen since the task started.
+};
+
+/**
+ * @brief Runs a work function periodically on a dedicated FreeRTOS task.
+ *
+ * The work function returns the delay in milliseconds until its next run. `wake()` makes it
+ * run immediately, e.g. after a setting changed on the UI task.
+ */
+class ManagerTask {
+public:
+    /**
+     * @brief Work function run on the task.
+     * @return Milliseconds until the next run.
+     */
+    using Work = std::function<uint32_t()>;
+
+    /**
+     * @brief Constructor for ManagerTask.
+     * @param name Task name (must outlive the task, normally a string literal).
+     */
+    explicit ManagerTask(const char* name);
+
+    /**
+     * @brief Destructor. Stops the task and releases FreeRTOS resources.
+     */
+    ~ManagerTask();
+
+    ManagerTask(const ManagerTask&) = delete;
+    ManagerTask& operator=(const ManagerTask&) = delete;
+
+    /**
+     * @brief Creates the task and starts running the work function.
+     * @param work The work function.
+     * @param stackSize Stack size of the task in bytes.
+     * @param priority FreeRTOS priority of the task.
+     * @param core Core the task is pinned to.
+     * @return True if the task is running, false if it could not be created.
+     */
+    bool start(Work work, uint32_t stackSize, UBaseType_t priority, BaseType_t core);
+
+    /**
+     * @brief Asks the task to exit and waits for it.
+     */
+    void stop();
+
+    /**
+     * @brief Makes the work function run as soon as possible.
+     */
+    void wake();
+
+    /**
+     * @brief Checks if the task is running.
+     * @return True if the task is running, false otherwise.
+     */
+    bool isRunning() const { return _taskHandle != nullptr; }
+
+    /**
+     * @brief Returns the statistics of the window since the previous call and starts a new window.
+     * @return The statistics of the finished window.
+     */
+    ManagerTaskStats takeStats();
+
+private:
+    const char* _name;                       ///< Task name.
+    Work _work;                              ///< Work function run on the task.
+    TaskHandle_t _taskHandle;                ///< Handle of the task (nullptr when stopped).
+    SemaphoreHandle_t _taskDoneSignal;       ///< Given by the task when it exits.
+    std::atomic<bool> _taskShouldRun;        ///< Cleared to ask the task to exit.
+
+    std::atomic<uint32_t> _runs;             ///< Work function calls in the current window.
+    std::atomic<uint32_t> _busyUs;           ///< Time spent in the work function in the current window.
+    std::atomic<uint32_t> _maxRunUs;         ///< Longest run in the current window.
+    int64_t _windowStartUs;                  ///< Start of the current window (esp_timer time).
+
+    /**
+     * @brief Entry point of the task.
+     * @param pvParameters Pointer to the ManagerTask instance.
+     */
+    static void _taskEntry(void* pvParameters);
+};
+
+/**
+ * @brief A typed, non-blocking message queue from a ManagerTask to the UI task.
+ * @tparam T Message type. It is copied byte-wise through a FreeRTOS queue.
+ */
+template <typename T>
+class ManagerMailbox {
+    static_assert(std::is_trivially_copyable<T>::value, "ManagerMailbox messages are copied through a FreeRTOS queue");
+
+public:
+    ManagerMailbox() : _queue(nullptr), _droppedCount(0) {}
+
+    ~ManagerMailbox() {
+        if (_queue) vQueueDelete(_queue);
+    }
+
+    ManagerMailbox(const ManagerMailbox&) = delete;
+    ManagerMailbox& operator=(const ManagerMailbox&) = delete;
+
+    /**
+     * @brief Creates the underlying queue.
+     * @param length Maximum number of pending messages.
+     * @return True on success, false if the queue could not be allocated.
+     */
+    bool create(UBaseType_t length) {
+        if (!_queue) _queue = xQueueCreate(length, sizeof(T));
+        return _queue != nullptr;
+    }
+
+    /**
+     * @brief Posts a message without blocking. Called on the producing task.
+     * @param message The message to post.
+     * @return True if queued, false if the mailbox was full (the message is dropped).
+     */
+    bool post(const T& message) {
+        if (_queue && xQueueSend(_queue, &message, 0) == pdTRUE) return true;
+        _droppedCount++;
+        return false;
+    }
+
+    /**
+     * @brief Hands every pending message to `handler`. Called on the UI task.
+     * @param handler Function taking `const T&`.
+     */
+    template <typename Handler>
+    void drain(Handler&& handler) {
+        if (!_queue) return;
+        T message;
+        while (xQueueReceive(_queue, &message, 0) == pdTRUE) {
+            handler(message);
+        }
+    }
+
+    /**
+     * @brief Returns the number of messages dropped because the mailbox was full.
+     * @return The dropped message count.
+     */
+    uint32_t getDroppedCount() const { return _droppedCount.load(); }
+
+private:
+    QueueHandle_t _queue;                    ///< Underlying FreeRTOS queue.
+    std::atomic<uint32_t> _droppedCount;     ///< Messages dropped due to a full queue.
+};
+
+#endif // MANAGER_TASK_H
@@ -0,0 +1,178 @@
+/**
+ * @file ManagerTaskHost.cpp
+ * @brief Implements the ManagerTaskHost class.
+ *
+ * @version 1.0.0
+ * @date 2025-09-01
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "ManagerTaskHost.h"
+#include "SystemInitializer.h" // For ManagerTaskHostConfig
+#include "PowerManager.h"
+
+/**
+ * @brief Constructor for the ManagerTaskHost class.
+ * @param powerManager Pointer to the PowerManager whose battery sampling may be moved.
+ * @param rfidManager Pointer to the RFIDManager whose card polling may be moved.
+ */
+ManagerTaskHost::ManagerTaskHost(PowerManager* powerManager, RFIDManager* rfidManager)
+  : _powerManager(powerManager),
+    _rfidManager(rfidManager),
+    _config(nullptr),
+    _powerTask("PowerMgrTask"),
+    _rfidTask("RfidMgrTask"),
+    _statsTimer([this]() { logStats(); }) {}
+
+/**
+ * @brief Destructor. Stops the tasks and returns the work to the managers' own timers.
+ */
+ManagerTaskHost::~ManagerTaskHost() {
+  if (_powerTask.isRunning()) {
+    _powerTask.stop();
+    if (_powerManager) {
+      _powerManager->setExternalSampling(false);
+      _powerManager->setExternalAdcProcessing(false);
+    }
+  }
+  if (_rfidTask.isRunning()) {
+    _rfidTask.stop();
+    if (_rfidManager) _rfidManager->setExternalPolling(false);
+  }
+}
+
+/**
+ * @brief Creates the mailboxes and starts the enabled manager tasks.
+ * @param config Task placement and reporting parameters.
+ * @return True if every enabled task is running, false if any fell back to the UI task.
+ */
+bool ManagerTaskHost::init(const ManagerTaskHostConfig& config) {
+  DEBUG_INFO_PRINTLN("ManagerTaskHost: init() starting...");
+  _config = &config;
+  bool ok = true;
+
+  if (_config->powerOnTask && _powerManager) {
+    ok = _startPowerTask() && ok;
+  }
+  if (_config->rfidOnTask && _rfidManager) {
+    ok = _startRfidTask() && ok;
+  }
+
+  if (_config->statsIntervalMs > 0 && (_powerTask.isRunning() || _rfidTask.isRunning())) {
+    g_timerWheel.start(_statsTimer, _config->statsIntervalMs, _config->statsIntervalMs);
+  }
+
+  DEBUG_INFO_PRINTF("ManagerTaskHost: init() finished (power on task: %s, RFID on task: %s).\n",
+                    _powerTask.isRunning() ? "yes" : "no", _rfidTask.isRunning() ? "yes" : "no");
+  return ok;
+}
+
+/**
+ * @brief UI-task side of the host. Applies the results posted by the manager tasks.
+ */
+void ManagerTaskHost::loop() {
+  _batteryMailbox.drain([this](float voltage) { _powerManager->applyBatteryVoltage(voltage); });
+  _rfidMailbox.drain([this](const RFIDRawScan& scan) { _rfidManager->deliverScan(scan); });
+}
+
+/**
+ * @brief Prints the CPU statistics of every running task and starts a new reporting window.
+ */
+void ManagerTaskHost::logStats() {
+  ManagerTask* tasks[] = { &_powerTask, &_rfidTask };
+  for (ManagerTask* task : tasks) {
+    if (!task->isRunning()) continue;
+    ManagerTaskStats stats = task->takeStats();
+    DEBUG_INFO_PRINTF("ManagerTaskHost: %s cpu=%u.%u%% runs=%u maxRun=%uus stackFree=%u\n",
+                      stats.name, (unsigned)(stats.busyPermille / 10), (unsigned)(stats.busyPermille % 10),
+                      (unsigned)stats.runs, (unsigned)stats.maxRunUs, (unsigned)stats.stackFreeBytes);
+  }
+  uint32_t dropped = _batteryMailbox.getDroppedCount() + _rfidMailbox.getDroppedCount();
+  if (dropped) {
+    DEBUG_WARN_PRINTF("ManagerTaskHost: %u messages dropped on full mailboxes so far.\n", (unsigned)dropped);
+  }
+}
+
+/**
+ * @brief Starts the battery sampling task. The task only reads the ADC; the icon, callbacks and
+ * shutdown logic run on the UI task when the sample is applied.
+ * With the continuous ADC the task drains and filters the DMA results, and the PowerManager's own
+ * timer reads the filtered value lock-free on the UI task, so no mailbox is needed.
+ * @return True if the task is running.
+ */
+bool ManagerTaskHost::_startPowerTask() {
+  if (_powerManager->isContinuousAdcActive()) {
+    bool started = _powerTask.start([this]() -> uint32_t { return _powerManager->processAdcSamples(); },
+      _config->powerTaskStackSize, _config->powerTaskPriority, _config->powerTaskCore);
+    if (!started) {
+      DEBUG_WARN_PRINTLN("ManagerTaskHost: Battery ADC filtering stays on the UI task.");
+      return false;
+    }
+    _powerManager->setExternalAdcProcessing(true);
+    return true;
+  }
+
+  if (!_batteryMailbox.create(_config->mailboxLength)) {
+    DEBUG_WARN_PRINTLN("ManagerTaskHost: Failed to create battery mailbox. Battery stays on the UI task.");
+    return false;
+  }
+  const uint32_t intervalMs = _powerManager->getBatteryCheckIntervalMs();
+  bool started = _powerTask.start([this, intervalMs]() -> uint32_t {
+      _batteryMailbox.post(_powerManager->readBatteryVoltage());
+      return intervalMs;
+    },
+    _config->powerTaskStackSize, _config->powerTaskPriority, _config->powerTaskCore);
+  if (!started) {
+    DEBUG_WARN_PRINTLN("ManagerTaskHost: Battery stays on the UI task.");
+    return false;
+  }
+  _powerManager->setExternalSampling(true);
+  return true;
+}
+
+/**
+ * @brief Starts the RFID polling task. The task talks to the MFRC522 over SPI; card data is built
+ * and the scanned-card callback runs on the UI task when the scan is delivered.
+ * @return True if the task is running.
+ */
+bool ManagerTaskHost::_startRfidTask() {
+  if (!_rfidMailbox.create(_config->mailboxLength)) {
+    DEBUG_WARN_PRINTLN("ManagerTaskHost: Failed to create RFID mailbox. RFID stays on the UI task.");
+    return false;
+  }
+  const uint32_t intervalMs = _rfidManager->getCardCheckIntervalMs();
+  bool started = _rfidTask.start([this, intervalMs]() -> uint32_t {
+      RFIDRawScan scan;
+      if (_rfidManager->pollCard(scan)) {
+        _rfidMailbox.post(scan);
+      }
+      return intervalMs;
+    },
+    _config->rfidTaskStackSize, _config->rfidTaskPriority, _config->rfidTaskCore);
+  if (!started) {
+    DEBUG_WARN_PRINTLN("ManagerTaskHost: RFID stays on the UI task.");
+    return false;
+  }
+  _rfidManager->setExternalPolling(true);
+  return true;
+}
@@ -0,0 +1,114 @@
+/**
+ * @file ManagerTaskHost.h
+ * @brief Defines the ManagerTaskHost class, which runs the slow peripheral work of the managers
+ * on dedicated FreeRTOS tasks.
+ *
+ * The battery ADC sampling of the PowerManager (or, with the continuous ADC, the filtering of its
+ * DMA results) and the SPI card polling of the RFIDManager each get their own ManagerTask with a
+ * configured stack, priority and core. Their results travel to
+ * the UI task through typed mailboxes and are applied in `loop()`, so a slow peripheral no longer
+ * stretches a UI frame. The host also reports per-task CPU use at a fixed interval.
+ *
+ * @version 1.0.0
+ * @date 2025-09-01
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef MANAGER_TASK_HOST_H
+#define MANAGER_TASK_HOST_H
+
+#include <Arduino.h>
+
+#include "Config.h"
+#include "ManagerTask.h"
+#include "RFIDManager.h"
+#include "TimerWheel.h"
+
+// Forward declarations
+struct ManagerTaskHostConfig; // Defined in SystemInitializer.h
+class PowerManager;
+
+/**
+ * @brief Moves manager peripheral work onto dedicated tasks and applies the results on the UI task.
+ *
+ * If a task cannot be created, its manager keeps running on the UI task's timer wheel as before.
+ */
+class ManagerTaskHost {
+public:
+    /**
+     * @brief Constructor for the ManagerTaskHost class.
+     * @param powerManager Pointer to the PowerManager whose battery sampling may be moved.
+     * @param rfidManager Pointer to the RFIDManager whose card polling may be moved.
+     */
+    ManagerTaskHost(PowerManager* powerManager, RFIDManager* rfidManager);
+
+    /**
+     * @brief Destructor. Stops the tasks and returns the work to the managers' own timers.
+     */
+    ~ManagerTaskHost();
+
+    /**
+     * @brief Creates the mailboxes and starts the enabled manager tasks.
+     * Must be called after the managers have been initialized.
+     * @param config Task placement and reporting parameters.
+     * @return True if every enabled task is running, false if any fell back to the UI task.
+     */
+    bool init(const ManagerTaskHostConfig& config);
+
+    /**
+     * @brief UI-task side of the host. Applies the results posted by the manager tasks.
+     * Call from the main loop.
+     */
+    void loop();
+
+    /**
+     * @brief Prints the CPU statistics of every running task and starts a new reporting window.
+     */
+    void logStats();
+
+private:
+    PowerManager* _powerManager;                 ///< Pointer to the PowerManager (not owned).
+    RFIDManager* _rfidManager;                   ///< Pointer to the RFIDManager (not owned).
+    const ManagerTaskHostConfig* _config;        ///< Pointer to the configuration (owned by SystemInitializer).
+
+    ManagerTask _powerTask;                      ///< Samples the battery voltage.
+    ManagerTask _rfidTask;                       ///< Polls the RFID reader.
+    ManagerMailbox<float> _batteryMailbox;       ///< Battery voltage samples for the UI task.
+    ManagerMailbox<RFIDRawScan> _rfidMailbox;    ///< Card reads for the UI task.
+    TimerWheel::Timer _statsTimer;               ///< Periodic CPU usage report.
+
+    /**
+     * @brief Starts the battery sampling task.
+     * @return True if the task is running.
+     */
+    bool _startPowerTask();
+
+    /**
+     * @brief Starts the RFID polling task.
+     * @return True if the task is running.
+     */
+    bool _startRfidTask();
+};
+
+#endif // MANAGER_TASK_HOST_H
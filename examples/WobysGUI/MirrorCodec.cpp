@@ -0,0 +1,280 @@
+/**
+ * @file MirrorCodec.cpp
+ * @brief Implements the MirrorCodec and MirrorLinkEstimator classes of the remote UI protocol.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "MirrorCodec.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+constexpr uint8_t OP_RUN = 0x00;
+constexpr uint8_t OP_LITERAL = 0x40;
+constexpr uint8_t OP_SKIP = 0x80;
+constexpr size_t OP_MAX_COUNT = 64;
+constexpr size_t TILE_PIXELS = (size_t)MirrorCodec::MAX_TILE_SIZE * MirrorCodec::MAX_TILE_SIZE;
+
+inline uint8_t* putU16(uint8_t* p, uint16_t v) { p[0] = v & 0xFF; p[1] = v >> 8; return p + 2; }
+inline uint8_t* putU32(uint8_t* p, uint32_t v) { p = putU16(p, v & 0xFFFF); return putU16(p, v >> 16); }
+inline uint16_t getU16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+}
+
+/**
+ * @brief Writes the frame header.
+ * @param out Output (at least `FRAME_HEADER_BYTES`).
+ * @param keyframe True if the client clears its framebuffer before applying the frame.
+ * @param width Framebuffer width.
+ * @param height Framebuffer height.
+ * @param seq Frame sequence number.
+ * @param rects Number of rectangles that follow.
+ * @return Number of bytes written.
+ */
+size_t MirrorCodec::writeFrameHeader(uint8_t* out, bool keyframe, uint16_t width, uint16_t height,
+                                     uint32_t seq, uint16_t rects) {
+  uint8_t* p = out;
+  *p++ = 'W';
+  *p++ = 'M';
+  *p++ = FRAME_VERSION;
+  *p++ = keyframe ? FLAG_KEYFRAME : 0;
+  p = putU16(p, width);
+  p = putU16(p, height);
+  p = putU32(p, seq);
+  p = putU16(p, rects);
+  return p - out;
+}
+
+/**
+ * @brief Encodes one tile against the pixels the client already has and updates them.
+ * @param out Output (at least `WORST_TILE_BYTES`).
+ * @param shadow Current pixels (row-major, `stride` pixels per row).
+ * @param sent Pixels as last sent (same layout); the tile is copied into it.
+ * @param stride Pixels per row of `shadow` and `sent`.
+ * @param x Tile X in pixels.
+ * @param y Tile Y in pixels.
+ * @param w Tile width (at most `MAX_TILE_SIZE`).
+ * @param h Tile height (at most `MAX_TILE_SIZE`).
+ * @return Number of bytes written.
+ */
+size_t MirrorCodec::encodeTile(uint8_t* out, const uint16_t* shadow, uint16_t* sent, uint16_t stride,
+                               uint16_t x, uint16_t y, uint8_t w, uint8_t h) {
+  // Gather the tile from PSRAM into contiguous local buffers once.
+  uint16_t cur[TILE_PIXELS];
+  uint16_t prev[TILE_PIXELS];
+  for (uint8_t row = 0; row < h; ++row) {
+    const size_t offset = (size_t)(y + row) * stride + x;
+    memcpy(&cur[row * w], shadow + offset, w * sizeof(uint16_t));
+    memcpy(&prev[row * w], sent + offset, w * sizeof(uint16_t));
+    memcpy(sent + offset, shadow + offset, w * sizeof(uint16_t));
+  }
+
+  uint8_t* o = putU16(putU16(out, x), y);
+  *o++ = w;
+  *o++ = h;
+
+  const size_t n = (size_t)w * h;
+  size_t k = 0;
+  while (k < n) {
+    size_t count = 1;
+    if (cur[k] == prev[k]) { // Unchanged since the client last received this pixel.
+      while (k + count < n && count < OP_MAX_COUNT && cur[k + count] == prev[k + count]) count++;
+      *o++ = OP_SKIP | (uint8_t)(count - 1);
+      k += count;
+      continue;
+    }
+    while (k + count < n && count < OP_MAX_COUNT && cur[k + count] == cur[k]) count++;
+    if (count >= 2) {
+      *o++ = OP_RUN | (uint8_t)(count - 1);
+      memcpy(o, &cur[k], 2);
+      o += 2;
+      k += count;
+      continue;
+    }
+    // Literal: up to the next run or unchanged pixel.
+    const size_t start = k++;
+    count = 1;
+    while (k < n && count < OP_MAX_COUNT && cur[k] != prev[k] && !(k + 1 < n && cur[k + 1] == cur[k])) {
+      k++;
+      count++;
+    }
+    *o++ = OP_LITERAL | (uint8_t)(count - 1);
+    memcpy(o, &cur[start], count * 2);
+    o += count * 2;
+  }
+  return o - out;
+}
+
+/**
+ * @brief Compares an access token in time that depends only on the expected token.
+ * @param given Token presented by the client.
+ * @param expected Configured token.
+ * @return True if both are equal.
+ */
+bool MirrorCodec::tokenEquals(const char* given, const char* expected) {
+  if (!given || !expected) return false;
+  const size_t expectedLen = strlen(expected);
+  const size_t givenLen = strnlen(given, expectedLen + 1);
+  // Every byte of the expected token is visited, whatever the client sent.
+  uint8_t diff = givenLen != expectedLen;
+  for (size_t i = 0; i < expectedLen; ++i) {
+    const uint8_t g = i < givenLen ? (uint8_t)given[i] : 0;
+    diff |= g ^ (uint8_t)expected[i];
+  }
+  return diff == 0;
+}
+
+/**
+ * @brief Parses a touch message and clamps its position to the framebuffer.
+ * @param msg Message bytes.
+ * @param len Message length.
+ * @param width Framebuffer width.
+ * @param height Framebuffer height.
+ * @param x Receives the X coordinate (0..width-1).
+ * @param y Receives the Y coordinate (0..height-1).
+ * @param pressed Receives the pressed state.
+ * @return True if `msg` is a touch message.
+ */
+bool MirrorCodec::parseTouch(const uint8_t* msg, size_t len, uint16_t width, uint16_t height,
+                             int16_t* x, int16_t* y, bool* pressed) {
+  if (len != 6 || msg[0] != 'T' || !width || !height) return false;
+  const int16_t rawX = (int16_t)getU16(msg + 2);
+  const int16_t rawY = (int16_t)getU16(msg + 4);
+  *pressed = msg[1] & 0x01;
+  *x = (int16_t)std::clamp<int32_t>(rawX, 0, width - 1);
+  *y = (int16_t)std::clamp<int32_t>(rawY, 0, height - 1);
+  return true;
+}
+
+/**
+ * @brief Parses an acknowledgement message.
+ * @param msg Message bytes.
+ * @param len Message length.
+ * @param seq Receives the sequence number of the newest applied frame.
+ * @return True if `msg` is an acknowledgement.
+ */
+bool MirrorCodec::parseAck(const uint8_t* msg, size_t len, uint32_t* seq) {
+  if (len != 5 || msg[0] != 'A') return false;
+  *seq = (uint32_t)getU16(msg + 1) | ((uint32_t)getU16(msg + 3) << 16);
+  return true;
+}
+
+/**
+ * @brief Constructor. Starts with a rate of 0 and nothing in flight.
+ */
+MirrorLinkEstimator::MirrorLinkEstimator()
+  : _frames{},
+    _first(0),
+    _count(0),
+    _bytesInFlight(0),
+    _bytesAcked(0),
+    _throughputBps(0) {
+}
+
+/**
+ * @brief Forgets the frames in flight and restarts from a rate.
+ * @param initialBps Starting rate in bytes per second.
+ */
+void MirrorLinkEstimator::reset(uint32_t initialBps) {
+  _first = 0;
+  _count = 0;
+  _bytesInFlight = 0;
+  _throughputBps = initialBps;
+}
+
+/**
+ * @brief Records a frame handed to the network.
+ * @param seq Frame sequence number.
+ * @param bytes Frame size.
+ * @param startUs Time the frame was started (encoding), in microseconds.
+ */
+void MirrorLinkEstimator::onFrameSent(uint32_t seq, uint32_t bytes, int64_t startUs) {
+  if (_count == MAX_IN_FLIGHT) { // Callers check canSend(); forget the oldest rather than overflow.
+    _bytesInFlight -= _frames[_first].bytes;
+    _first = (_first + 1) % MAX_IN_FLIGHT;
+    _count--;
+  }
+  _frames[(_first + _count) % MAX_IN_FLIGHT] = {seq, bytes, startUs};
+  _count++;
+  _bytesInFlight += bytes;
+}
+
+/**
+ * @brief Retires all frames up to `seq` and updates the rate.
+ * @param seq Sequence number acknowledged by the client.
+ * @param nowUs Current time in microseconds.
+ * @param latencyUs Receives the start-to-acknowledgement time of frame `seq` (optional).
+ * @return True if at least one frame was retired.
+ */
+bool MirrorLinkEstimator::onAck(uint32_t seq, int64_t nowUs, uint32_t* latencyUs) {
+  uint32_t bytes = 0;
+  int64_t oldestStartUs = 0;
+  size_t retired = 0;
+  // Sequence numbers wrap; a frame is covered if it is not newer than `seq`.
+  while (_count && (int32_t)(seq - _frames[_first].seq) >= 0) {
+    const InFlight& frame = _frames[_first];
+    if (!retired) oldestStartUs = frame.startUs;
+    if (frame.seq == seq && latencyUs) *latencyUs = (uint32_t)std::max<int64_t>(nowUs - frame.startUs, 0);
+    bytes += frame.bytes;
+    _first = (_first + 1) % MAX_IN_FLIGHT;
+    _count--;
+    retired++;
+  }
+  if (!retired) return false;
+
+  _bytesInFlight -= bytes;
+  _bytesAcked += bytes;
+  const int64_t elapsedUs = std::max<int64_t>(nowUs - oldestStartUs, 1);
+  const uint32_t sample = (uint32_t)std::min<uint64_t>((uint64_t)bytes * 1000000ULL / (uint64_t)elapsedUs, UINT32_MAX / 4);
+  _throughputBps = (uint32_t)(((uint64_t)_throughputBps * 3 + sample) / 4);
+  return true;
+}
+
+/**
+ * @brief Gives up on frames that stay unacknowledged for too long and halves the rate.
+ * @param nowUs Current time in microseconds.
+ * @param timeoutUs Maximum age of the oldest unacknowledged frame.
+ * @return True if frames were dropped.
+ */
+bool MirrorLinkEstimator::expire(int64_t nowUs, int64_t timeoutUs) {
+  if (!_count || nowUs - _frames[_first].startUs < timeoutUs) return false;
+  _first = 0;
+  _count = 0;
+  _bytesInFlight = 0;
+  _throughputBps /= 2;
+  return true;
+}
+
+/**
+ * @brief Returns the frame budget for an interval.
+ * @param intervalMs Frame interval.
+ * @param minBytes Lower bound.
+ * @param maxBytes Upper bound.
+ * @return `rate * interval`, clamped to the bounds.
+ */
+size_t MirrorLinkEstimator::budget(uint32_t intervalMs, size_t minBytes, size_t maxBytes) const {
+  const size_t bytes = (size_t)((uint64_t)_throughputBps * intervalMs / 1000);
+  return std::min(std::max(bytes, minBytes), maxBytes);
+}
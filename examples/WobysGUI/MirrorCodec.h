@@ -0,0 +1,214 @@
+/**
+ * @file MirrorCodec.h
+ * @brief Defines the MirrorCodec and MirrorLinkEstimator classes, the hardware-independent part of the remote UI protocol.
+ *
+ * Frames (device -> client, binary WebSocket messages):
+ *   header  'W' 'M' version flags width:u16 height:u16 seq:u32 rects:u16   (14 bytes, little-endian)
+ *   rect    x:u16 y:u16 w:u8 h:u8 followed by ops until w*h pixels are covered
+ *   op      0x00|n-1 pixel     run of n equal pixels
+ *           0x40|n-1 pixels... n literal pixels
+ *           0x80|n-1           n pixels unchanged since the previous frame
+ * Pixels are RGB565, big-endian (the panel write format). A keyframe (flag 0x01) clears the
+ * client framebuffer first.
+ *
+ * Client messages (binary): 'T' flags:u8 x:i16 y:i16 (touch, flag bit 0 = pressed),
+ * 'A' seq:u32 (frame `seq` and all earlier ones have been applied) and 'K' (request a keyframe).
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef MIRROR_CODEC_H
+#define MIRROR_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Encoder and message parsers of the remote UI protocol. Stateless; safe on any task.
+ */
+class MirrorCodec {
+public:
+  static constexpr uint8_t FRAME_VERSION = 1;        ///< Version byte of the frame header.
+  static constexpr uint8_t FLAG_KEYFRAME = 0x01;     ///< Header flag: the client clears its framebuffer first.
+  static constexpr size_t FRAME_HEADER_BYTES = 14;   ///< Size of the frame header.
+  static constexpr size_t RECT_HEADER_BYTES = 6;     ///< Size of a rectangle header.
+  static constexpr uint16_t MAX_TILE_SIZE = 16;      ///< Largest tile edge `encodeTile()` accepts.
+  /// Upper bound for one encoded tile (no op sequence needs more than 3 bytes per pixel).
+  static constexpr size_t WORST_TILE_BYTES = RECT_HEADER_BYTES + (size_t)MAX_TILE_SIZE * MAX_TILE_SIZE * 3;
+
+  /**
+   * @brief Writes the frame header.
+   * @param out Output (at least `FRAME_HEADER_BYTES`).
+   * @param keyframe True if the client clears its framebuffer before applying the frame.
+   * @param width Framebuffer width.
+   * @param height Framebuffer height.
+   * @param seq Frame sequence number.
+   * @param rects Number of rectangles that follow.
+   * @return Number of bytes written.
+   */
+  static size_t writeFrameHeader(uint8_t* out, bool keyframe, uint16_t width, uint16_t height,
+                                 uint32_t seq, uint16_t rects);
+
+  /**
+   * @brief Encodes one tile against the pixels the client already has and updates them.
+   * @param out Output (at least `WORST_TILE_BYTES`).
+   * @param shadow Current pixels (row-major, `stride` pixels per row).
+   * @param sent Pixels as last sent (same layout); the tile is copied into it.
+   * @param stride Pixels per row of `shadow` and `sent`.
+   * @param x Tile X in pixels.
+   * @param y Tile Y in pixels.
+   * @param w Tile width (at most `MAX_TILE_SIZE`).
+   * @param h Tile height (at most `MAX_TILE_SIZE`).
+   * @return Number of bytes written.
+   */
+  static size_t encodeTile(uint8_t* out, const uint16_t* shadow, uint16_t* sent, uint16_t stride,
+                           uint16_t x, uint16_t y, uint8_t w, uint8_t h);
+
+  /**
+   * @brief Compares an access token in time that depends only on the expected token.
+   * @param given Token presented by the client.
+   * @param expected Configured token.
+   * @return True if both are equal.
+   */
+  static bool tokenEquals(const char* given, const char* expected);
+
+  /**
+   * @brief Parses a touch message and clamps its position to the framebuffer.
+   * @param msg Message bytes.
+   * @param len Message length.
+   * @param width Framebuffer width.
+   * @param height Framebuffer height.
+   * @param x Receives the X coordinate (0..width-1).
+   * @param y Receives the Y coordinate (0..height-1).
+   * @param pressed Receives the pressed state.
+   * @return True if `msg` is a touch message.
+   */
+  static bool parseTouch(const uint8_t* msg, size_t len, uint16_t width, uint16_t height,
+                         int16_t* x, int16_t* y, bool* pressed);
+
+  /**
+   * @brief Parses an acknowledgement message.
+   * @param msg Message bytes.
+   * @param len Message length.
+   * @param seq Receives the sequence number of the newest applied frame.
+   * @return True if `msg` is an acknowledgement.
+   */
+  static bool parseAck(const uint8_t* msg, size_t len, uint32_t* seq);
+};
+
+/**
+ * @brief Estimates the delivery rate of the link from client acknowledgements.
+ *
+ * Every frame handed to the network is recorded with its size and start time; an
+ * acknowledgement retires it and all earlier frames. The rate sample is the acknowledged bytes
+ * divided by the time from the start of the oldest retired frame to the acknowledgement, so it
+ * includes the round trip and reflects what the client actually received, not how fast the
+ * local socket accepted the data. A frame budget of `rate * interval` then converges to what
+ * the link delivers within one frame interval. Not thread-safe; the owner serializes access.
+ */
+class MirrorLinkEstimator {
+public:
+  static constexpr size_t MAX_IN_FLIGHT = 4; ///< Unacknowledged frames tracked at most.
+
+  /**
+   * @brief Constructor. Starts with a rate of 0 and nothing in flight.
+   */
+  MirrorLinkEstimator();
+
+  /**
+   * @brief Forgets the frames in flight and restarts from a rate.
+   * @param initialBps Starting rate in bytes per second.
+   */
+  void reset(uint32_t initialBps);
+
+  /**
+   * @brief Checks whether another frame can be recorded.
+   * @return True if fewer than `MAX_IN_FLIGHT` frames are unacknowledged.
+   */
+  bool canSend() const { return _count < MAX_IN_FLIGHT; }
+
+  /**
+   * @brief Records a frame handed to the network.
+   * @param seq Frame sequence number.
+   * @param bytes Frame size.
+   * @param startUs Time the frame was started (encoding), in microseconds.
+   */
+  void onFrameSent(uint32_t seq, uint32_t bytes, int64_t startUs);
+
+  /**
+   * @brief Retires all frames up to `seq` and updates the rate.
+   * @param seq Sequence number acknowledged by the client.
+   * @param nowUs Current time in microseconds.
+   * @param latencyUs Receives the start-to-acknowledgement time of frame `seq` (optional).
+   * @return True if at least one frame was retired.
+   */
+  bool onAck(uint32_t seq, int64_t nowUs, uint32_t* latencyUs = nullptr);
+
+  /**
+   * @brief Gives up on frames that stay unacknowledged for too long and halves the rate.
+   * @param nowUs Current time in microseconds.
+   * @param timeoutUs Maximum age of the oldest unacknowledged frame.
+   * @return True if frames were dropped.
+   */
+  bool expire(int64_t nowUs, int64_t timeoutUs);
+
+  /**
+   * @brief Returns the frame budget for an interval.
+   * @param intervalMs Frame interval.
+   * @param minBytes Lower bound.
+   * @param maxBytes Upper bound.
+   * @return `rate * interval`, clamped to the bounds.
+   */
+  size_t budget(uint32_t intervalMs, size_t minBytes, size_t maxBytes) const;
+
+  /** @brief Returns the smoothed delivery rate in bytes per second. */
+  uint32_t getThroughputBps() const { return _throughputBps; }
+
+  /** @brief Returns the bytes handed to the network but not yet acknowledged. */
+  uint32_t getBytesInFlight() const { return _bytesInFlight; }
+
+  /** @brief Returns the number of acknowledged bytes. */
+  uint32_t getBytesAcked() const { return _bytesAcked; }
+
+private:
+  /**
+   * @brief One unacknowledged frame.
+   */
+  struct InFlight {
+    uint32_t seq;    ///< Sequence number.
+    uint32_t bytes;  ///< Size.
+    int64_t startUs; ///< Start time.
+  };
+
+  InFlight _frames[MAX_IN_FLIGHT]; ///< Ring of unacknowledged frames, oldest at `_first`.
+  size_t _first;                   ///< Index of the oldest frame.
+  size_t _count;                   ///< Number of frames in the ring.
+  uint32_t _bytesInFlight;         ///< Sum of the sizes in the ring.
+  uint32_t _bytesAcked;            ///< Acknowledged bytes since construction.
+  uint32_t _throughputBps;         ///< Smoothed delivery rate.
+};
+
+#endif // MIRROR_CODEC_H
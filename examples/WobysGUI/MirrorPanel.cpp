@@ -0,0 +1,290 @@
+/**
+ * @file MirrorPanel.cpp
+ * @brief Implements MirrorPanel, an ST7796 panel driver that keeps a shadow copy of the screen.
+ *
+ * @version 1.0.0
+ * @date 2025-08-28
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "MirrorPanel.h"
+#include "Config.h" // For DEBUG_* macros
+#include <esp_heap_caps.h>
+#include <cstring>
+
+/**
+ * @brief Constructor. Capturing starts disabled.
+ */
+MirrorPanel::MirrorPanel()
+  : _shadow(nullptr),
+    _shadowWidth(0),
+    _shadowHeight(0),
+    _dirty(nullptr),
+    _tilesX(0),
+    _tilesY(0),
+    _dirtyCount(0),
+    _geometryVersion(0),
+    _inCapture(false),
+    _winXs(0), _winYs(0), _winXe(0), _winYe(0),
+    _cursorX(0), _cursorY(0) {
+}
+
+/**
+ * @brief Destructor. Frees the shadow framebuffer.
+ */
+MirrorPanel::~MirrorPanel() {
+  disableShadow();
+}
+
+/**
+ * @brief Allocates the shadow framebuffer and starts capturing.
+ * @return True if capturing is active.
+ */
+bool MirrorPanel::enableShadow() {
+  if (_shadow) return true;
+
+  // The buffer is sized for the panel in either orientation.
+  const uint32_t pixels = (uint32_t)TFT_WIDTH * TFT_HEIGHT;
+  const uint32_t tiles = ((TFT_WIDTH + TILE_SIZE - 1) / TILE_SIZE) * ((TFT_HEIGHT + TILE_SIZE - 1) / TILE_SIZE);
+  _shadow = static_cast<uint16_t*>(heap_caps_malloc(pixels * sizeof(uint16_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+  _dirty = static_cast<uint32_t*>(calloc((tiles + 31) / 32 + 1, sizeof(uint32_t)));
+  if (!_shadow || !_dirty) {
+    DEBUG_ERROR_PRINTLN("MirrorPanel: Failed to allocate the shadow framebuffer (PSRAM required).");
+    disableShadow();
+    return false;
+  }
+  _resetGeometry();
+  DEBUG_INFO_PRINTF("MirrorPanel: Shadow framebuffer enabled (%ux%u).\n", _shadowWidth, _shadowHeight);
+  return true;
+}
+
+/**
+ * @brief Stops capturing and frees the shadow framebuffer.
+ */
+void MirrorPanel::disableShadow() {
+  if (_shadow) heap_caps_free(_shadow);
+  if (_dirty) free(_dirty);
+  _shadow = nullptr;
+  _dirty = nullptr;
+  _dirtyCount = 0;
+}
+
+/**
+ * @brief Clears the dirty flag of a tile.
+ * @param index Tile index (row * `getTilesX()` + column).
+ */
+void MirrorPanel::clearTileDirty(uint32_t index) {
+  uint32_t bit = 1u << (index & 31);
+  if (_dirty[index >> 5] & bit) {
+    _dirty[index >> 5] &= ~bit;
+    _dirtyCount--;
+  }
+}
+
+/**
+ * @brief Marks every tile dirty.
+ */
+void MirrorPanel::markAllDirty() {
+  if (!_shadow) return;
+  _markRect(0, 0, _shadowWidth, _shadowHeight);
+}
+
+// --- LovyanGFX panel primitives ---
+// Each primitive updates the shadow first (the driver advances the source position in
+// `pixelcopy_t`), then forwards to Panel_ST7796. Nested primitive calls are not captured twice.
+
+void MirrorPanel::setRotation(uint_fast8_t r) {
+  lgfx::Panel_ST7796::setRotation(r);
+  if (_shadow) _resetGeometry();
+}
+
+void MirrorPanel::setWindow(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye) {
+  _winXs = xs; _winYs = ys; _winXe = xe; _winYe = ye;
+  _cursorX = xs; _cursorY = ys;
+  lgfx::Panel_ST7796::setWindow(xs, ys, xe, ye);
+}
+
+void MirrorPanel::drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor) {
+  if (_canCapture() && x < _shadowWidth && y < _shadowHeight) {
+    _row(y)[x] = (uint16_t)rawcolor;
+    _markRect(x, y, 1, 1);
+  }
+  const bool outer = _inCapture;
+  _inCapture = true;
+  lgfx::Panel_ST7796::drawPixelPreclipped(x, y, rawcolor);
+  _inCapture = outer;
+}
+
+void MirrorPanel::writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor) {
+  if (_canCapture() && x < _shadowWidth && y < _shadowHeight) {
+    const uint_fast16_t cw = std::min<uint_fast16_t>(w, _shadowWidth - x);
+    const uint_fast16_t ch = std::min<uint_fast16_t>(h, _shadowHeight - y);
+    const uint16_t color = (uint16_t)rawcolor;
+    for (uint_fast16_t row = 0; row < ch; ++row) {
+      uint16_t* dst = _row(y + row) + x;
+      for (uint_fast16_t i = 0; i < cw; ++i) dst[i] = color;
+    }
+    _markRect(x, y, cw, ch);
+  }
+  const bool outer = _inCapture;
+  _inCapture = true;
+  lgfx::Panel_ST7796::writeFillRectPreclipped(x, y, w, h, rawcolor);
+  _inCapture = outer;
+}
+
+void MirrorPanel::writeBlock(uint32_t rawcolor, uint32_t len) {
+  if (_canCapture()) {
+    const uint16_t color = (uint16_t)rawcolor;
+    uint32_t remaining = len;
+    while (remaining && _cursorY <= _winYe && _cursorY < _shadowHeight) {
+      uint32_t n = std::min<uint32_t>(remaining, _winXe - _cursorX + 1);
+      if (_cursorX < _shadowWidth) {
+        uint32_t visible = std::min<uint32_t>(n, _shadowWidth - _cursorX);
+        uint16_t* dst = _row(_cursorY) + _cursorX;
+        for (uint32_t i = 0; i < visible; ++i) dst[i] = color;
+        _markRect(_cursorX, _cursorY, visible, 1);
+      }
+      remaining -= n;
+      _cursorX += n;
+      if (_cursorX > _winXe) { _cursorX = _winXs; ++_cursorY; }
+    }
+  }
+  const bool outer = _inCapture;
+  _inCapture = true;
+  lgfx::Panel_ST7796::writeBlock(rawcolor, len);
+  _inCapture = outer;
+}
+
+void MirrorPanel::writePixels(lgfx::pixelcopy_t* param, uint32_t len, bool use_dma) {
+  if (_canCapture()) {
+    // The panel's copy advances the source position in `param`; convert from a private copy.
+    lgfx::pixelcopy_t copy = *param;
+    uint32_t remaining = len;
+    while (remaining && _cursorY <= _winYe && _cursorY < _shadowHeight && _cursorX < _shadowWidth) {
+      uint32_t n = std::min<uint32_t>(remaining, _winXe - _cursorX + 1);
+      n = std::min<uint32_t>(n, _shadowWidth - _cursorX);
+      copy.fp_copy(_row(_cursorY), _cursorX, _cursorX + n, &copy);
+      _markRect(_cursorX, _cursorY, n, 1);
+      remaining -= n;
+      _cursorX += n;
+      if (_cursorX > _winXe) { _cursorX = _winXs; ++_cursorY; }
+    }
+  }
+  const bool outer = _inCapture;
+  _inCapture = true;
+  lgfx::Panel_ST7796::writePixels(param, len, use_dma);
+  _inCapture = outer;
+}
+
+void MirrorPanel::writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, lgfx::pixelcopy_t* param, bool use_dma) {
+  if (_canCapture() && x + w <= _shadowWidth && y + h <= _shadowHeight) {
+    // Same row stepping as the panel driver: reset the source column, advance the source row.
+    lgfx::pixelcopy_t copy = *param;
+    const auto sx = copy.src_x;
+    const bool transparent = copy.transp != lgfx::pixelcopy_t::NON_TRANSP;
+    for (uint_fast16_t row = 0; row < h; ++row) {
+      uint16_t* dst = _row(y + row) + x;
+      if (!transparent) {
+        copy.fp_copy(dst, 0, w, &copy);
+      } else {
+        uint32_t i = 0;
+        while (w != (i = copy.fp_skip(i, w, &copy))) {
+          i = copy.fp_copy(dst, i, w, &copy);
+          if (i == w) break;
+        }
+      }
+      copy.src_x = sx;
+      copy.src_y++;
+    }
+    _markRect(x, y, w, h);
+  }
+  const bool outer = _inCapture;
+  _inCapture = true;
+  lgfx::Panel_ST7796::writeImage(x, y, w, h, param, use_dma);
+  _inCapture = outer;
+}
+
+void MirrorPanel::copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y) {
+  if (_canCapture() && dst_x + w <= _shadowWidth && dst_y + h <= _shadowHeight &&
+      src_x + w <= _shadowWidth && src_y + h <= _shadowHeight) {
+    // Copy rows in the direction that does not overwrite unread source rows.
+    if (dst_y <= src_y) {
+      for (uint_fast16_t row = 0; row < h; ++row) {
+        memmove(_row(dst_y + row) + dst_x, _row(src_y + row) + src_x, w * sizeof(uint16_t));
+      }
+    } else {
+      for (uint_fast16_t row = h; row-- > 0;) {
+        memmove(_row(dst_y + row) + dst_x, _row(src_y + row) + src_x, w * sizeof(uint16_t));
+      }
+    }
+    _markRect(dst_x, dst_y, w, h);
+  }
+  const bool outer = _inCapture;
+  _inCapture = true;
+  lgfx::Panel_ST7796::copyRect(dst_x, dst_y, w, h, src_x, src_y);
+  _inCapture = outer;
+}
+
+/**
+ * @brief Re-reads the logical size after a rotation change, clears the shadow and marks it dirty.
+ */
+void MirrorPanel::_resetGeometry() {
+  _shadowWidth = (uint16_t)width();
+  _shadowHeight = (uint16_t)height();
+  _tilesX = (_shadowWidth + TILE_SIZE - 1) / TILE_SIZE;
+  _tilesY = (_shadowHeight + TILE_SIZE - 1) / TILE_SIZE;
+  memset(_shadow, 0, (size_t)_shadowWidth * _shadowHeight * sizeof(uint16_t));
+  memset(_dirty, 0, ((_tilesX * _tilesY + 31) / 32) * sizeof(uint32_t));
+  _dirtyCount = 0;
+  _geometryVersion++;
+  markAllDirty();
+}
+
+/**
+ * @brief Checks whether a primitive should be captured.
+ * @return True if capturing is on, the write depth is 16-bit and no capture is in progress.
+ */
+bool MirrorPanel::_canCapture() const {
+  return _shadow && !_inCapture && getWriteDepth() == lgfx::rgb565_2Byte;
+}
+
+/**
+ * @brief Marks the tiles covering a rectangle dirty.
+ */
+void MirrorPanel::_markRect(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h) {
+  if (!w || !h) return;
+  const uint_fast16_t tx0 = x / TILE_SIZE;
+  const uint_fast16_t ty0 = y / TILE_SIZE;
+  const uint_fast16_t tx1 = std::min<uint_fast16_t>((x + w - 1) / TILE_SIZE, _tilesX - 1);
+  const uint_fast16_t ty1 = std::min<uint_fast16_t>((y + h - 1) / TILE_SIZE, _tilesY - 1);
+  for (uint_fast16_t ty = ty0; ty <= ty1; ++ty) {
+    for (uint_fast16_t tx = tx0; tx <= tx1; ++tx) {
+      const uint32_t index = ty * _tilesX + tx;
+      const uint32_t bit = 1u << (index & 31);
+      if (!(_dirty[index >> 5] & bit)) {
+        _dirty[index >> 5] |= bit;
+        _dirtyCount++;
+      }
+    }
+  }
+}
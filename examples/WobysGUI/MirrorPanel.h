@@ -0,0 +1,181 @@
+/**
+ * @file MirrorPanel.h
+ * @brief Defines MirrorPanel, an ST7796 panel driver that keeps a shadow copy of the screen.
+ *
+ * The WT32-SC01-Plus panel is write-only (RD is not connected), so the screen content cannot
+ * be read back. MirrorPanel intercepts the LovyanGFX panel write primitives, copies every
+ * written pixel into a shadow framebuffer (in PSRAM) and marks the touched 16x16 tiles as
+ * dirty. The RemoteUiMirror encodes and streams the dirty tiles.
+ *
+ * @version 1.0.0
+ * @date 2025-08-28
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef MIRROR_PANEL_H
+#define MIRROR_PANEL_H
+
+#ifndef LGFX_USE_V1
+#define LGFX_USE_V1
+#endif
+#include <LovyanGFX.hpp>
+
+/**
+ * @brief ST7796 panel with an optional shadow framebuffer and dirty-tile tracking.
+ *
+ * Capturing is off until `enableShadow()` is called and costs nothing while off. The shadow
+ * holds the pixels in the panel's write format (RGB565, big-endian in memory) in logical
+ * (rotated) coordinates; a rotation change clears it and marks every tile dirty.
+ * Capturing requires the 16-bit write depth; other depths are not captured.
+ * Must only be used from the task that draws (the UI task).
+ */
+class MirrorPanel : public lgfx::Panel_ST7796 {
+public:
+  static constexpr uint16_t TILE_SIZE = 16; ///< Edge length of a dirty-tracking tile in pixels.
+
+  /**
+   * @brief Constructor. Capturing starts disabled.
+   */
+  MirrorPanel();
+
+  /**
+   * @brief Destructor. Frees the shadow framebuffer.
+   */
+  ~MirrorPanel();
+
+  /**
+   * @brief Allocates the shadow framebuffer and starts capturing.
+   * Areas drawn before this call stay black in the shadow until they are redrawn.
+   * @return True if capturing is active.
+   */
+  bool enableShadow();
+
+  /**
+   * @brief Stops capturing and frees the shadow framebuffer.
+   */
+  void disableShadow();
+
+  /**
+   * @brief Checks whether capturing is active.
+   * @return True if the shadow framebuffer exists.
+   */
+  bool isShadowEnabled() const { return _shadow != nullptr; }
+
+  /**
+   * @brief Returns the shadow framebuffer (row-major, `getShadowWidth()` pixels per row).
+   * @return Pointer to the pixels, or nullptr if capturing is off.
+   */
+  const uint16_t* getShadow() const { return _shadow; }
+
+  /** @brief Returns the logical width of the shadow in pixels. */
+  uint16_t getShadowWidth() const { return _shadowWidth; }
+
+  /** @brief Returns the logical height of the shadow in pixels. */
+  uint16_t getShadowHeight() const { return _shadowHeight; }
+
+  /**
+   * @brief Returns a counter that changes whenever the shadow geometry changes (enable, rotation).
+   * @return The geometry version.
+   */
+  uint32_t getGeometryVersion() const { return _geometryVersion; }
+
+  /** @brief Returns the number of tile columns. */
+  uint16_t getTilesX() const { return _tilesX; }
+
+  /** @brief Returns the number of tile rows. */
+  uint16_t getTilesY() const { return _tilesY; }
+
+  /**
+   * @brief Checks whether any tile is dirty.
+   * @return True if at least one tile changed since it was last cleared.
+   */
+  bool hasDirtyTiles() const { return _dirtyCount > 0; }
+
+  /**
+   * @brief Checks whether a tile is dirty.
+   * @param index Tile index (row * `getTilesX()` + column).
+   * @return True if the tile changed since it was last cleared.
+   */
+  bool isTileDirty(uint32_t index) const { return (_dirty[index >> 5] >> (index & 31)) & 1u; }
+
+  /**
+   * @brief Clears the dirty flag of a tile.
+   * @param index Tile index (row * `getTilesX()` + column).
+   */
+  void clearTileDirty(uint32_t index);
+
+  /**
+   * @brief Marks every tile dirty (e.g. for a keyframe).
+   */
+  void markAllDirty();
+
+  // --- LovyanGFX panel primitives (captured, then forwarded to Panel_ST7796) ---
+  void setRotation(uint_fast8_t r) override;
+  void setWindow(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye) override;
+  void drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor) override;
+  void writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor) override;
+  void writeBlock(uint32_t rawcolor, uint32_t len) override;
+  void writePixels(lgfx::pixelcopy_t* param, uint32_t len, bool use_dma) override;
+  void writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, lgfx::pixelcopy_t* param, bool use_dma) override;
+  void copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y) override;
+
+private:
+  uint16_t* _shadow;           ///< Shadow framebuffer (nullptr while capturing is off).
+  uint16_t _shadowWidth;       ///< Logical width of the shadow.
+  uint16_t _shadowHeight;      ///< Logical height of the shadow.
+  uint32_t* _dirty;            ///< Dirty tile bitmap.
+  uint16_t _tilesX;            ///< Tile columns.
+  uint16_t _tilesY;            ///< Tile rows.
+  uint32_t _dirtyCount;        ///< Number of dirty tiles.
+  uint32_t _geometryVersion;   ///< Incremented when the geometry changes.
+  bool _inCapture;             ///< Set while a primitive is being forwarded (nested calls are not captured twice).
+
+  uint16_t _winXs, _winYs, _winXe, _winYe; ///< Current address window.
+  uint16_t _cursorX, _cursorY;             ///< Next pixel position inside the window.
+
+  /**
+   * @brief Re-reads the logical size after a rotation change, clears the shadow and marks it dirty.
+   */
+  void _resetGeometry();
+
+  /**
+   * @brief Checks whether a primitive should be captured.
+   * @return True if capturing is on, the write depth is 16-bit and no capture is in progress.
+   */
+  bool _canCapture() const;
+
+  /**
+   * @brief Marks the tiles covering a rectangle dirty.
+   */
+  void _markRect(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h);
+
+  /**
+   * @brief Returns a pointer to the start of a shadow row.
+   * @param y The row.
+   * @return Pointer to the first pixel of the row.
+   */
+  uint16_t* _row(uint_fast16_t y) const { return _shadow + (uint32_t)y * _shadowWidth; }
+};
+
+#endif // MIRROR_PANEL_H
@@ -0,0 +1,775 @@
+/**
+ * @file OtaUpdater.cpp
+ * @brief Implements the OtaUpdater class, which installs firmware images over HTTP(S) into the inactive app slot.
+ *
+ * @version 1.0.0
+ * @date 2025-08-29
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "OtaUpdater.h"
+#include "SystemInitializer.h" // For OtaUpdaterConfig and g_systemStatus
+#include "Config.h"            // For DEBUG_* macros and UI colors
+#include "WifiManager.h"
+#include "LanguageManager.h"
+#include "MessageBoardElement.h"
+
+#include <Preferences.h>
+#include <esp_ota_ops.h>
+#include <esp_http_client.h>
+#include <esp_crt_bundle.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <mbedtls/sha256.h>
+#include <algorithm>
+#include <cstring>
+#include <strings.h> // For strcasecmp()
+
+namespace {
+const char* const NVS_NAMESPACE = "ota";
+const char* const KEY_URL = "url";
+const char* const KEY_SHA = "sha";
+const char* const KEY_PARTITION = "part";
+const char* const KEY_BYTES = "bytes";
+const char* const KEY_ETAG = "etag";
+const char* const KEY_LENGTH = "len";
+const char* const KEY_INSTALLED = "installed";
+const char* const KEY_NEXT_SHA = "nextsha";
+const char* const KEY_RUNNING_SHA = "runsha";
+const char* const KEY_RUNNING_PARTITION = "runpart";
+constexpr uint32_t FLASH_SECTOR_BYTES = 4096; ///< Erase granularity of the SPI flash.
+// Macros rather than constants, so the manifest sscanf() widths can be stringified from them.
+#define OTA_MANIFEST_MAX_BYTES 512 ///< Longest manifest read (and so the longest image URL).
+#define OTA_SHA256_HEX_CHARS 64    ///< Hex digits of a SHA-256 digest.
+#define OTA_STRINGIFY_(x) #x
+#define OTA_STRINGIFY(x) OTA_STRINGIFY_(x)
+constexpr size_t MANIFEST_MAX_BYTES = OTA_MANIFEST_MAX_BYTES;
+
+/**
+ * @brief Converts a 32-byte digest to lowercase hex.
+ */
+std::string toHex(const uint8_t* digest) {
+  static const char digits[] = "0123456789abcdef";
+  std::string hex(64, '0');
+  for (int i = 0; i < 32; ++i) {
+    hex[i * 2] = digits[digest[i] >> 4];
+    hex[i * 2 + 1] = digits[digest[i] & 0x0F];
+  }
+  return hex;
+}
+
+/**
+ * @brief Compares two hex strings case-insensitively.
+ */
+bool hexEquals(const std::string& a, const std::string& b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (tolower((unsigned char)a[i]) != tolower((unsigned char)b[i])) return false;
+  }
+  return true;
+}
+}
+
+/**
+ * @brief Constructor for the OtaUpdater class.
+ * @param wifiManager Pointer to the WifiManager (updates only start while connected).
+ * @param languageManager Pointer to the LanguageManager (progress and result texts).
+ */
+OtaUpdater::OtaUpdater(WifiManager* wifiManager, LanguageManager* languageManager)
+  : _wifiManager(wifiManager),
+    _languageManager(languageManager),
+    _messageBoard(nullptr),
+    _config(nullptr),
+    _partition(nullptr),
+    _initialized(false),
+    _task(nullptr),
+    _taskRunning(false),
+    _abortRequested(false),
+    _checkOnly(false),
+    _responseTotal(0),
+    _state(OtaState::IDLE),
+    _lastError(OtaError::NONE),
+    _bytesWritten(0),
+    _imageSize(0),
+    _throughputBps(0),
+    _resumePending(false),
+    _checkedOnce(false),
+    _stopped(false),
+    _lastCheckMs(0),
+    _pendingVerify(false),
+    _reportedResult(true),
+    _shownState(OtaState::IDLE),
+    _shownPercent(0),
+    _lastProgressMs(0),
+    _readySinceMs(0) {
+}
+
+/**
+ * @brief Destructor. Aborts a running download and waits for the task to end.
+ */
+OtaUpdater::~OtaUpdater() {
+  _abortRequested = true;
+  while (_taskRunning.load()) {
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+}
+
+/**
+ * @brief Initializes the updater: finds the update partition, checks whether the running image
+ * still awaits confirmation and loads the checkpoint of an interrupted download.
+ * @param config Chunk sizes, timings and task parameters.
+ * @return True if updates are possible.
+ */
+bool OtaUpdater::init(const OtaUpdaterConfig& config) {
+  DEBUG_INFO_PRINTLN("OtaUpdater: init() starting...");
+  _config = &config;
+
+  const esp_partition_t* running = esp_ota_get_running_partition();
+  esp_ota_img_states_t runningState;
+  if (running && esp_ota_get_state_partition(running, &runningState) == ESP_OK) {
+    _pendingVerify = (runningState == ESP_OTA_IMG_PENDING_VERIFY);
+  }
+
+  _partition = esp_ota_get_next_update_partition(nullptr);
+  if (!_partition) {
+    DEBUG_ERROR_PRINTLN("OtaUpdater: No OTA update partition (partition scheme without OTA slots?).");
+    return false;
+  }
+
+  Preferences prefs;
+  if (prefs.begin(NVS_NAMESPACE, false)) {
+    const uint32_t installed = prefs.getUInt(KEY_INSTALLED, 0);
+    if (installed) {
+      // An update was installed before the last restart; if we are not running it, it was rolled back.
+      if (running && running->address != installed) {
+        DEBUG_WARN_PRINTLN("OtaUpdater: The installed update did not boot, previous firmware restored.");
+        _lastError = OtaError::INVALID_IMAGE;
+        _state = OtaState::FAILED;
+        _reportedResult = false;
+      } else {
+        prefs.putString(KEY_RUNNING_SHA, prefs.getString(KEY_NEXT_SHA, ""));
+        prefs.putUInt(KEY_RUNNING_PARTITION, installed);
+      }
+      prefs.remove(KEY_INSTALLED);
+      prefs.remove(KEY_NEXT_SHA);
+    }
+    if (running && prefs.getUInt(KEY_RUNNING_PARTITION, 0) == running->address) {
+      _runningSha256 = prefs.getString(KEY_RUNNING_SHA, "").c_str();
+    }
+    if (prefs.getUInt(KEY_PARTITION, 0) == _partition->address && prefs.getUInt(KEY_BYTES, 0) > 0) {
+      _checkpointUrl = prefs.getString(KEY_URL, "").c_str();
+      _checkpointSha256 = prefs.getString(KEY_SHA, "").c_str();
+      _resumePending = config.autoResume && !_checkpointUrl.empty();
+      DEBUG_INFO_PRINTF("OtaUpdater: Interrupted update found (%u bytes in flash).\n", prefs.getUInt(KEY_BYTES, 0));
+    }
+    prefs.end();
+  }
+
+  _initialized = true;
+  DEBUG_INFO_PRINTF("OtaUpdater: Initialized (target '%s' at 0x%06x, %u KB%s).\n",
+                    _partition->label, (unsigned)_partition->address, (unsigned)(_partition->size / 1024),
+                    _pendingVerify ? ", running image pending verification" : "");
+  return true;
+}
+
+/**
+ * @brief Updates the progress display, confirms or rolls back the running image, resumes an
+ * interrupted download and restarts after an installation. Call from the main loop.
+ */
+void OtaUpdater::loop() {
+  if (!_initialized || _stopped) return;
+  if (_pendingVerify) _checkRunningImage();
+
+  if (_resumePending && !_taskRunning.load() &&
+      _wifiManager && _wifiManager->getCurrentState() == WifiMgr_State_t::CONNECTED) {
+    _resumePending = false;
+    DEBUG_INFO_PRINTLN("OtaUpdater: Resuming interrupted update.");
+    startUpdate(_checkpointUrl, _checkpointSha256);
+  }
+
+  if (_config->manifestUrl && _config->manifestUrl[0] && !_resumePending && !_pendingVerify && !_taskRunning.load() &&
+      (!_checkedOnce || millis() - _lastCheckMs >= _config->checkIntervalMs) &&
+      _wifiManager && _wifiManager->getCurrentState() == WifiMgr_State_t::CONNECTED) {
+    _checkedOnce = true;
+    _lastCheckMs = millis();
+    checkForUpdate();
+  }
+
+  if (_taskRunning.load() && _onActivity) _onActivity();
+  _updateDisplay();
+
+  if (_state.load() == OtaState::READY_TO_REBOOT && millis() - _readySinceMs >= _config->restartDelayMs) {
+    DEBUG_INFO_PRINTLN("OtaUpdater: Restarting into the new firmware.");
+    delay(100); // Let the serial output drain.
+    esp_restart();
+  }
+}
+
+/**
+ * @brief Starts downloading an image. Continues the checkpoint if it belongs to the same image.
+ * @param url HTTP or HTTPS URL of the image.
+ * @param sha256Hex Expected SHA-256 of the image (64 hex digits). If empty, only the image's own
+ * checksum is verified.
+ * @return True if the download task was started. Refused while the running image awaits confirmation
+ * and after `stop()`.
+ */
+bool OtaUpdater::startUpdate(const std::string& url, const std::string& sha256Hex) {
+  if (!_initialized || _stopped || url.empty()) return false;
+  if (_taskRunning.load() || _state.load() == OtaState::READY_TO_REBOOT) {
+    DEBUG_WARN_PRINTLN("OtaUpdater: An update is already in progress.");
+    return false;
+  }
+  if (_pendingVerify) {
+    // The other slot holds the rollback image until the running one is confirmed.
+    DEBUG_WARN_PRINTLN("OtaUpdater: Running firmware not confirmed yet, update refused.");
+    return false;
+  }
+  if (!sha256Hex.empty() && sha256Hex.size() != 64) {
+    DEBUG_ERROR_PRINTLN("OtaUpdater: The expected SHA-256 must have 64 hex digits.");
+    return false;
+  }
+
+  _url = url;
+  _sha256Hex = sha256Hex;
+  _checkOnly = false;
+  _state = OtaState::CONNECTING;
+  if (!_startTask()) return false;
+  DEBUG_INFO_PRINTF("OtaUpdater: Update started from %s\n", url.c_str());
+  return true;
+}
+
+/**
+ * @brief Fetches the update manifest on the download task and installs the image it names,
+ * unless the running firmware already is that image.
+ * @return True if the check was started. Refused without a manifest URL, while a download runs
+ * or while the running image awaits confirmation, and after `stop()`.
+ */
+bool OtaUpdater::checkForUpdate() {
+  if (!_initialized || _stopped || !_config->manifestUrl || !_config->manifestUrl[0]) return false;
+  if (_taskRunning.load() || _state.load() == OtaState::READY_TO_REBOOT || _pendingVerify) return false;
+  _url.clear();
+  _sha256Hex.clear();
+  _checkOnly = true;
+  _state = OtaState::CHECKING;
+  return _startTask();
+}
+
+/**
+ * @brief Starts the download task.
+ * @return True if the task was created.
+ */
+bool OtaUpdater::_startTask() {
+  const OtaState requested = _state.load();
+  _abortRequested = false;
+  _bytesWritten = 0;
+  _imageSize = 0;
+  _throughputBps = 0;
+  _lastError = OtaError::NONE;
+  _reportedResult = requested == OtaState::CHECKING; // A check without a result shows nothing.
+  _taskRunning = true;
+
+  BaseType_t rc = xTaskCreatePinnedToCore(
+    _taskFn,
+    "OtaUpdater",
+    _config->taskStackSize,
+    this,
+    _config->taskPriority,
+    &_task,
+    _config->taskCore);
+  if (rc != pdPASS) {
+    _task = nullptr;
+    _taskRunning = false;
+    _state = OtaState::IDLE;
+    _reportedResult = true;
+    DEBUG_ERROR_PRINTLN("OtaUpdater: Failed to create download task.");
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Stops a running download. The checkpoint is kept, so the update can be resumed.
+ */
+void OtaUpdater::abort() {
+  if (_taskRunning.load()) _abortRequested = true;
+  _resumePending = false;
+}
+
+/**
+ * @brief Aborts a running download or check and refuses new ones, for the shutdown.
+ */
+void OtaUpdater::stop() {
+  _stopped = true;
+  abort();
+}
+
+/**
+ * @brief Returns the progress of the running download.
+ * @return 0..100, or 0 if the size is unknown.
+ */
+uint8_t OtaUpdater::getProgressPercent() const {
+  const uint32_t size = _imageSize.load();
+  if (!size) return 0;
+  return (uint8_t)std::min<uint64_t>(100, (uint64_t)_bytesWritten.load() * 100 / size);
+}
+
+/**
+ * @brief Download task entry point.
+ * @param arg Pointer to the OtaUpdater instance.
+ */
+void OtaUpdater::_taskFn(void* arg) {
+  OtaUpdater* self = static_cast<OtaUpdater*>(arg);
+  if (self->_checkOnly && !self->_fetchManifest()) {
+    self->_state = OtaState::IDLE;
+    self->_task = nullptr;
+    self->_taskRunning = false;
+    vTaskDelete(nullptr);
+    return;
+  }
+  self->_checkOnly = false;
+  self->_reportedResult = false;
+  self->_state = OtaState::CONNECTING;
+  OtaError result = self->_run();
+  self->_lastError = result;
+  if (result == OtaError::NONE) {
+    self->_readySinceMs = millis();
+    self->_state = OtaState::READY_TO_REBOOT;
+  } else {
+    self->_state = OtaState::FAILED;
+  }
+  self->_task = nullptr;
+  self->_taskRunning = false;
+  vTaskDelete(nullptr);
+}
+
+/**
+ * @brief Downloads, verifies and installs the image. Runs on the download task.
+ * @return The result (NONE on success).
+ */
+OtaError OtaUpdater::_run() {
+  const uint32_t chunkBytes = _config->chunkBytes;
+  // Checkpoints must fall on sector boundaries (see the class description).
+  const uint32_t checkpointStep = std::max(FLASH_SECTOR_BYTES, _config->checkpointBytes / FLASH_SECTOR_BYTES * FLASH_SECTOR_BYTES);
+
+  // Flash is written with the cache disabled, so the source buffer must be in internal RAM.
+  uint8_t* buffer = static_cast<uint8_t*>(heap_caps_malloc(chunkBytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT));
+  if (!buffer) {
+    DEBUG_ERROR_PRINTLN("OtaUpdater: Failed to allocate the chunk buffer.");
+    return OtaError::FLASH;
+  }
+
+  mbedtls_sha256_context sha;
+  mbedtls_sha256_init(&sha);
+  mbedtls_sha256_starts(&sha, 0);
+
+  // Continue the checkpoint if it belongs to this image.
+  uint32_t offset = 0;
+  std::string etag;
+  uint32_t checkpointSize = 0;
+  {
+    Preferences prefs;
+    if (prefs.begin(NVS_NAMESPACE, true)) {
+      if (prefs.getUInt(KEY_PARTITION, 0) == _partition->address &&
+          _url == prefs.getString(KEY_URL, "").c_str() &&
+          hexEquals(_sha256Hex, prefs.getString(KEY_SHA, "").c_str())) {
+        offset = prefs.getUInt(KEY_BYTES, 0);
+        etag = prefs.getString(KEY_ETAG, "").c_str();
+        checkpointSize = prefs.getUInt(KEY_LENGTH, 0);
+      }
+      prefs.end();
+    }
+  }
+  // Without the image size the server's image cannot be compared, so such a checkpoint is not resumed.
+  if (!checkpointSize || offset > checkpointSize || offset > _partition->size || offset % FLASH_SECTOR_BYTES != 0 ||
+      !_rehash(&sha, buffer, offset)) {
+    offset = 0;
+    mbedtls_sha256_starts(&sha, 0);
+  }
+  _bytesWritten = offset;
+
+  esp_http_client_config_t httpConfig = {};
+  httpConfig.url = _url.c_str();
+  httpConfig.timeout_ms = _config->httpTimeoutMs;
+  httpConfig.buffer_size = chunkBytes;
+  httpConfig.keep_alive_enable = true;
+  httpConfig.crt_bundle_attach = esp_crt_bundle_attach;
+  httpConfig.event_handler = _onHttpEvent;
+  httpConfig.user_data = this;
+  esp_http_client_handle_t client = esp_http_client_init(&httpConfig);
+  if (!client) {
+    free(buffer);
+    mbedtls_sha256_free(&sha);
+    return OtaError::HTTP;
+  }
+
+  // At most two requests: the resume, and a fresh download if the server's image changed.
+  OtaError result = OtaError::NONE;
+  uint32_t total = 0;
+  for (;;) {
+    _responseEtag.clear();
+    _responseTotal = 0;
+    if (offset) {
+      char range[32];
+      snprintf(range, sizeof(range), "bytes=%u-", (unsigned)offset);
+      esp_http_client_set_header(client, "Range", range);
+      // A server whose image changed answers with the whole new image instead of the range.
+      if (!etag.empty()) esp_http_client_set_header(client, "If-Range", etag.c_str());
+    } else {
+      esp_http_client_delete_header(client, "Range");
+      esp_http_client_delete_header(client, "If-Range");
+    }
+    if (esp_http_client_open(client, 0) != ESP_OK) {
+      result = OtaError::HTTP;
+      break;
+    }
+    const int64_t contentLength = esp_http_client_fetch_headers(client);
+    const int status = esp_http_client_get_status_code(client);
+
+    if (offset && status == 206) {
+      if (_responseTotal == checkpointSize && (etag.empty() || _responseEtag == etag)) {
+        total = checkpointSize;
+        break;
+      }
+      DEBUG_WARN_PRINTLN("OtaUpdater: The image on the server changed, downloading from the start.");
+      esp_http_client_close(client);
+      offset = 0;
+      _bytesWritten = 0;
+      mbedtls_sha256_starts(&sha, 0);
+      continue;
+    }
+    if (offset && status == 200) {
+      // The server ignored the range, or If-Range found a different image: the body is the whole image.
+      DEBUG_WARN_PRINTLN("OtaUpdater: Resume not possible, downloading from the start.");
+      offset = 0;
+      _bytesWritten = 0;
+      mbedtls_sha256_starts(&sha, 0);
+    }
+    if (status != 200) {
+      DEBUG_ERROR_PRINTF("OtaUpdater: Unexpected HTTP status %d.\n", status);
+      result = OtaError::HTTP;
+      break;
+    }
+    total = contentLength > 0 ? (uint32_t)contentLength : 0;
+    // If-Range needs a strong validator.
+    etag = _responseEtag.rfind("W/", 0) == 0 ? std::string() : _responseEtag;
+    break;
+  }
+
+  if (result == OtaError::NONE) {
+    if (total > _partition->size) {
+      result = OtaError::TOO_LARGE;
+    } else {
+      _imageSize = total;
+      _state = OtaState::DOWNLOADING;
+      _saveCheckpoint(_url, _sha256Hex, etag, total, offset);
+    }
+  }
+
+  uint32_t erasedTo = offset;
+  uint32_t checkpoint = offset;
+  int64_t windowStartUs = esp_timer_get_time();
+  uint32_t windowBytes = 0;
+  while (result == OtaError::NONE) {
+    if (_abortRequested.load()) {
+      result = OtaError::ABORTED;
+      break;
+    }
+    int n = esp_http_client_read(client, reinterpret_cast<char*>(buffer), chunkBytes);
+    if (n < 0) {
+      result = OtaError::HTTP;
+      break;
+    }
+    if (n == 0) {
+      if (!esp_http_client_is_complete_data_received(client)) result = OtaError::HTTP;
+      break;
+    }
+    if (offset + (uint32_t)n > _partition->size) {
+      result = OtaError::TOO_LARGE;
+      break;
+    }
+    // One sector at a time, just ahead of the data: each erase stalls the flash cache only briefly.
+    while (erasedTo < offset + (uint32_t)n) {
+      const uint32_t length = std::min(FLASH_SECTOR_BYTES, (uint32_t)_partition->size - erasedTo);
+      if (esp_partition_erase_range(_partition, erasedTo, length) != ESP_OK) {
+        result = OtaError::FLASH;
+        break;
+      }
+      erasedTo += length;
+    }
+    if (result != OtaError::NONE) break;
+    if (esp_partition_write(_partition, offset, buffer, n) != ESP_OK) {
+      result = OtaError::FLASH;
+      break;
+    }
+    mbedtls_sha256_update(&sha, buffer, n);
+    offset += n;
+    _bytesWritten = offset;
+
+    if (offset - checkpoint >= checkpointStep) {
+      checkpoint = offset / FLASH_SECTOR_BYTES * FLASH_SECTOR_BYTES;
+      _saveCheckpoint(_url, _sha256Hex, etag, total, checkpoint);
+    }
+
+    windowBytes += n;
+    const int64_t nowUs = esp_timer_get_time();
+    if (nowUs - windowStartUs >= 500000) {
+      const uint32_t sample = (uint32_t)((uint64_t)windowBytes * 1000000ULL / (uint64_t)(nowUs - windowStartUs));
+      const uint32_t previous = _throughputBps.load();
+      _throughputBps = previous ? (previous * 3 + sample) / 4 : sample;
+      windowStartUs = nowUs;
+      windowBytes = 0;
+    }
+  }
+  esp_http_client_close(client);
+  esp_http_client_cleanup(client);
+  free(buffer);
+
+  if (result == OtaError::NONE && total && offset != total) result = OtaError::HTTP;
+
+  if (result == OtaError::NONE) {
+    _state = OtaState::VERIFYING;
+    uint8_t digest[32];
+    mbedtls_sha256_finish(&sha, digest);
+    const std::string actual = toHex(digest);
+    if (!_sha256Hex.empty() && !hexEquals(actual, _sha256Hex)) {
+      DEBUG_ERROR_PRINTF("OtaUpdater: SHA-256 mismatch (got %s).\n", actual.c_str());
+      result = OtaError::HASH_MISMATCH;
+    } else if (esp_ota_set_boot_partition(_partition) != ESP_OK) { // Also validates the image.
+      DEBUG_ERROR_PRINTLN("OtaUpdater: The image was rejected.");
+      result = OtaError::INVALID_IMAGE;
+    }
+    // Either way the image in flash is final: the next attempt starts over.
+    _saveCheckpoint("", "", "", 0, 0);
+    if (result == OtaError::NONE) {
+      Preferences prefs;
+      if (prefs.begin(NVS_NAMESPACE, false)) {
+        prefs.putUInt(KEY_INSTALLED, _partition->address);
+        prefs.putString(KEY_NEXT_SHA, actual.c_str()); // Becomes the running hash once it boots.
+        prefs.end();
+      }
+      DEBUG_INFO_PRINTF("OtaUpdater: Installed %u bytes into '%s'.\n", (unsigned)offset, _partition->label);
+    }
+  } else {
+    DEBUG_WARN_PRINTF("OtaUpdater: Update stopped at %u bytes (error %d).\n", (unsigned)offset, (int)result);
+  }
+  mbedtls_sha256_free(&sha);
+  return result;
+}
+
+/**
+ * @brief Hashes the first `length` bytes already in the partition (resume).
+ * @param sha Pointer to the running `mbedtls_sha256_context`.
+ * @param buffer Scratch buffer of `chunkBytes`.
+ * @param length Number of bytes to hash.
+ * @return True on success.
+ */
+bool OtaUpdater::_rehash(void* sha, uint8_t* buffer, uint32_t length) {
+  mbedtls_sha256_context* ctx = static_cast<mbedtls_sha256_context*>(sha);
+  for (uint32_t pos = 0; pos < length; ) {
+    const uint32_t n = std::min(_config->chunkBytes, length - pos);
+    if (esp_partition_read(_partition, pos, buffer, n) != ESP_OK) return false;
+    mbedtls_sha256_update(ctx, buffer, n);
+    pos += n;
+    _bytesWritten = pos;
+    if (_abortRequested.load()) return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Fetches the manifest and, if it names a different image, sets `_url` and `_sha256Hex`.
+ * Runs on the download task.
+ * @return True if an update should be installed.
+ */
+bool OtaUpdater::_fetchManifest() {
+  esp_http_client_config_t httpConfig = {};
+  httpConfig.url = _config->manifestUrl;
+  httpConfig.timeout_ms = _config->httpTimeoutMs;
+  httpConfig.crt_bundle_attach = esp_crt_bundle_attach;
+  esp_http_client_handle_t client = esp_http_client_init(&httpConfig);
+  if (!client) return false;
+
+  char text[MANIFEST_MAX_BYTES + 1] = {0};
+  int length = 0;
+  if (esp_http_client_open(client, 0) == ESP_OK && esp_http_client_fetch_headers(client) >= 0 &&
+      esp_http_client_get_status_code(client) == 200) {
+    int n;
+    while (length < (int)MANIFEST_MAX_BYTES &&
+           (n = esp_http_client_read(client, text + length, MANIFEST_MAX_BYTES - length)) > 0) {
+      length += n;
+    }
+  } else {
+    DEBUG_WARN_PRINTLN("OtaUpdater: Update manifest not available.");
+  }
+  esp_http_client_close(client);
+  esp_http_client_cleanup(client);
+  if (length <= 0) return false;
+  text[length] = '\0';
+
+  // "<image url> <sha256 hex>", separated by any whitespace.
+  char url[OTA_MANIFEST_MAX_BYTES + 1];
+  char sha[OTA_SHA256_HEX_CHARS + 1];
+  if (sscanf(text, "%" OTA_STRINGIFY(OTA_MANIFEST_MAX_BYTES) "s %" OTA_STRINGIFY(OTA_SHA256_HEX_CHARS) "s",
+             url, sha) != 2 ||
+      strlen(sha) != OTA_SHA256_HEX_CHARS) {
+    DEBUG_WARN_PRINTLN("OtaUpdater: Malformed update manifest.");
+    return false;
+  }
+  if (hexEquals(sha, _runningSha256)) {
+    DEBUG_INFO_PRINTLN("OtaUpdater: Firmware is up to date.");
+    return false;
+  }
+  DEBUG_INFO_PRINTF("OtaUpdater: Update available from %s\n", url);
+  _url = url;
+  _sha256Hex = sha;
+  return true;
+}
+
+/**
+ * @brief HTTP client event handler. Records the ETag and Content-Range of responses.
+ * @param event The event; `user_data` is the OtaUpdater instance.
+ * @return ESP_OK.
+ */
+esp_err_t OtaUpdater::_onHttpEvent(esp_http_client_event_t* event) {
+  if (event->event_id != HTTP_EVENT_ON_HEADER || !event->user_data) return ESP_OK;
+  OtaUpdater* self = static_cast<OtaUpdater*>(event->user_data);
+  if (strcasecmp(event->header_key, "ETag") == 0) {
+    self->_responseEtag = event->header_value;
+  } else if (strcasecmp(event->header_key, "Content-Range") == 0) {
+    // "bytes <first>-<last>/<size>"; the size may be "*" if the server does not know it.
+    const char* slash = strrchr(event->header_value, '/');
+    self->_responseTotal = slash && slash[1] != '*' ? (uint32_t)strtoul(slash + 1, nullptr, 10) : 0;
+  }
+  return ESP_OK;
+}
+
+/**
+ * @brief Stores the checkpoint in NVS. An empty URL clears it.
+ * @param url Image URL.
+ * @param sha256Hex Expected hash.
+ * @param etag Strong ETag of the image (empty if the server sent none).
+ * @param imageSize Size of the image (0 if unknown; such a download cannot be resumed).
+ * @param bytes Bytes in flash that are covered by the checkpoint.
+ */
+void OtaUpdater::_saveCheckpoint(const std::string& url, const std::string& sha256Hex, const std::string& etag,
+                                 uint32_t imageSize, uint32_t bytes) {
+  Preferences prefs;
+  if (!prefs.begin(NVS_NAMESPACE, false)) return;
+  if (url.empty()) {
+    prefs.remove(KEY_URL);
+    prefs.remove(KEY_SHA);
+    prefs.remove(KEY_PARTITION);
+    prefs.remove(KEY_BYTES);
+    prefs.remove(KEY_ETAG);
+    prefs.remove(KEY_LENGTH);
+  } else {
+    if (prefs.getString(KEY_URL, "") != url.c_str()) prefs.putString(KEY_URL, url.c_str());
+    if (prefs.getString(KEY_SHA, "") != sha256Hex.c_str()) prefs.putString(KEY_SHA, sha256Hex.c_str());
+    if (prefs.getString(KEY_ETAG, "") != etag.c_str()) prefs.putString(KEY_ETAG, etag.c_str());
+    prefs.putUInt(KEY_LENGTH, imageSize);
+    prefs.putUInt(KEY_PARTITION, _partition->address);
+    prefs.putUInt(KEY_BYTES, bytes);
+  }
+  prefs.end();
+}
+
+/**
+ * @brief Shows the progress or the result of the update on the message board.
+ */
+void OtaUpdater::_updateDisplay() {
+  if (!_messageBoard) return;
+  const OtaState state = _state.load();
+  const unsigned long now = millis();
+
+  switch (state) {
+    case OtaState::CONNECTING:
+    case OtaState::DOWNLOADING:
+    case OtaState::VERIFYING: {
+      const uint8_t percent = getProgressPercent();
+      if (state == _shownState) {
+        if (now - _lastProgressMs < _config->progressIntervalMs) return;
+        if (_imageSize.load() && percent == _shownPercent) return;
+      }
+      std::string text;
+      if (state == OtaState::VERIFYING) {
+        text = _text("OTA_VERIFYING", "Verifying update...");
+      } else {
+        text = _text("OTA_PROGRESS", "Updating firmware") + ": ";
+        text += _imageSize.load() ? std::to_string(percent) + "%" : std::to_string(_bytesWritten.load() / 1024) + " KB";
+        if (_throughputBps.load()) text += " (" + std::to_string(_throughputBps.load() / 1024) + " KB/s)";
+      }
+      _messageBoard->setText(text, 0);
+      _shownState = state;
+      _shownPercent = percent;
+      _lastProgressMs = now;
+      break;
+    }
+    case OtaState::READY_TO_REBOOT:
+    case OtaState::FAILED:
+      if (_reportedResult) return;
+      _reportedResult = true;
+      _shownState = state;
+      if (state == OtaState::READY_TO_REBOOT) {
+        _messageBoard->setText(_text("OTA_READY", "Update installed, restarting..."), 0);
+      } else if (_lastError.load() == OtaError::INVALID_IMAGE && !_url.empty()) {
+        _messageBoard->setText(_text("OTA_FAILED", "Firmware update failed!"), 5000);
+      } else if (_lastError.load() == OtaError::INVALID_IMAGE) {
+        _messageBoard->setText(_text("OTA_ROLLED_BACK", "Update failed, previous firmware restored."), 5000);
+      } else if (_lastError.load() == OtaError::HTTP || _lastError.load() == OtaError::ABORTED) {
+        _messageBoard->setText(_text("OTA_INTERRUPTED", "Firmware update interrupted."), 5000);
+      } else {
+        _messageBoard->setText(_text("OTA_FAILED", "Firmware update failed!"), 5000);
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Confirms the running image or rolls it back, depending on the system status.
+ */
+void OtaUpdater::_checkRunningImage() {
+  if (g_systemStatus == SystemStatus::CRITICAL_ERROR) {
+    DEBUG_ERROR_PRINTLN("OtaUpdater: New firmware failed to initialize, rolling back.");
+    delay(100);
+    esp_ota_mark_app_invalid_rollback_and_reboot();
+    return; // Only reached if no previous image exists.
+  }
+  if (g_systemStatus == SystemStatus::OPERATIONAL && millis() >= _config->confirmAfterMs) {
+    if (esp_ota_mark_app_valid_cancel_rollback() == ESP_OK) {
+      DEBUG_INFO_PRINTLN("OtaUpdater: Running firmware confirmed.");
+    }
+    _pendingVerify = false;
+  }
+}
+
+/**
+ * @brief Returns a localized string.
+ * @param key The string key.
+ * @param fallback Text used if the key or the LanguageManager is missing.
+ * @return The string.
+ */
+std::string OtaUpdater::_text(const char* key, const char* fallback) const {
+  return _languageManager ? _languageManager->getString(key, fallback) : std::string(fallback);
+}
@@ -0,0 +1,328 @@
+/**
+ * @file OtaUpdater.h
+ * @brief Defines the OtaUpdater class, which installs firmware images over HTTP(S) into the inactive app slot.
+ *
+ * The image is streamed in fixed chunks straight into the next OTA partition and hashed with
+ * SHA-256 on the way, so it is never buffered as a whole. Progress is checkpointed in NVS; an
+ * interrupted download continues with an HTTP range request (also after a reboot), and the part
+ * already in flash is re-hashed instead of downloaded again. After the new image has booted it
+ * must reach the operational state and stay up for a while before it is confirmed; otherwise the
+ * bootloader rolls back to the previous image. Progress and results are shown on the status bar
+ * message board.
+ *
+ * Requires a partition scheme with two OTA app slots.
+ *
+ * @version 1.0.0
+ * @date 2025-08-29
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef OTA_UPDATER_H
+#define OTA_UPDATER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <functional>
+#include <string>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_partition.h>
+#include <esp_http_client.h>
+
+// Forward declarations
+class WifiManager;
+class LanguageManager;
+class MessageBoardElement;
+struct OtaUpdaterConfig; // Defined in SystemInitializer.h
+
+/**
+ * @brief States of an update.
+ */
+enum class OtaState : uint8_t {
+  IDLE = 0,        ///< No update running.
+  CHECKING,        ///< Fetching the update manifest.
+  CONNECTING,      ///< Resuming the checkpoint and requesting the image.
+  DOWNLOADING,     ///< Streaming the image into flash.
+  VERIFYING,       ///< Checking the hash and the image, selecting the boot partition.
+  READY_TO_REBOOT, ///< Installed; the device restarts after `restartDelayMs`.
+  FAILED           ///< Failed; see `getLastError()`.
+};
+
+/**
+ * @brief Reasons an update failed.
+ */
+enum class OtaError : uint8_t {
+  NONE = 0,        ///< No error.
+  NO_PARTITION,    ///< No inactive OTA app partition.
+  HTTP,            ///< Connection, status or transfer error (resumable).
+  TOO_LARGE,       ///< The image does not fit the partition.
+  FLASH,           ///< Flash erase, write or read failed.
+  HASH_MISMATCH,   ///< The SHA-256 of the download does not match the expected one.
+  INVALID_IMAGE,   ///< The bootloader would not accept the image.
+  ABORTED          ///< Aborted by `abort()` (resumable).
+};
+
+/**
+ * @brief Downloads and installs firmware images on a background task.
+ *
+ * The download task only touches flash, NVS and the network; the UI is updated from `loop()`
+ * on the main task. Flash is erased one 4 KB sector at a time just ahead of the write pointer and
+ * the checkpoint is only advanced to sector boundaries, so a resumed download always writes into
+ * freshly erased flash. The checkpoint also records the ETag and size of the image; a resume
+ * sends `If-Range`, and starts over from zero if the server's image is no longer the same.
+ *
+ * If `manifestUrl` is configured, `loop()` fetches it once Wi-Fi is connected and then every
+ * `checkIntervalMs`. The manifest is a text file `<image url> <sha256 hex>`; the image is
+ * installed unless its hash is the one of the running firmware (known for images this updater
+ * installed). `startUpdate()` installs a given image directly.
+ */
+class OtaUpdater {
+public:
+  /**
+   * @brief Constructor for the OtaUpdater class.
+   * @param wifiManager Pointer to the WifiManager (updates only start while connected).
+   * @param languageManager Pointer to the LanguageManager (progress and result texts).
+   */
+  OtaUpdater(WifiManager* wifiManager, LanguageManager* languageManager);
+
+  /**
+   * @brief Destructor. Aborts a running download and waits for the task to end.
+   */
+  ~OtaUpdater();
+
+  /**
+   * @brief Initializes the updater: finds the update partition, checks whether the running image
+   * still awaits confirmation and loads the checkpoint of an interrupted download.
+   * @param config Chunk sizes, timings and task parameters.
+   * @return True if updates are possible.
+   */
+  bool init(const OtaUpdaterConfig& config);
+
+  /**
+   * @brief Updates the progress display, confirms or rolls back the running image, resumes an
+   * interrupted download and restarts after an installation. Call from the main loop.
+   */
+  void loop();
+
+  /**
+   * @brief Starts downloading an image. Continues the checkpoint if it belongs to the same image.
+   * @param url HTTP or HTTPS URL of the image.
+   * @param sha256Hex Expected SHA-256 of the image (64 hex digits). If empty, only the image's own
+   * checksum is verified.
+   * @return True if the download task was started. Refused while the running image awaits confirmation
+   * and after `stop()`.
+   */
+  bool startUpdate(const std::string& url, const std::string& sha256Hex);
+
+  /**
+   * @brief Fetches the update manifest on the download task and installs the image it names,
+   * unless the running firmware already is that image.
+   * @return True if the check was started. Refused without a manifest URL, while a download runs
+   * or while the running image awaits confirmation, and after `stop()`.
+   */
+  bool checkForUpdate();
+
+  /**
+   * @brief Stops a running download. The checkpoint is kept, so the update can be resumed.
+   */
+  void abort();
+
+  /**
+   * @brief Aborts a running download or check and refuses new ones, for the shutdown.
+   * Does not wait; the checkpoint is kept, so the update resumes after the next boot.
+   */
+  void stop();
+
+  /**
+   * @brief Checks whether `stop()` was called and the download task has ended.
+   * @return True once the updater is idle for good.
+   */
+  bool isStopped() const { return _stopped && !_taskRunning.load(); }
+
+  /**
+   * @brief Sets the message board used for progress and result messages.
+   * @param messageBoard Pointer to the MessageBoardElement (owned by SystemInitializer).
+   */
+  void setMessageBoard(MessageBoardElement* messageBoard) { _messageBoard = messageBoard; }
+
+  /**
+   * @brief Sets a callback invoked from `loop()` while a download is running (network activity).
+   * @param callback The callback.
+   */
+  void setOnActivityCallback(std::function<void()> callback) { _onActivity = std::move(callback); }
+
+  /**
+   * @brief Returns the current state.
+   * @return The state.
+   */
+  OtaState getState() const { return _state.load(); }
+
+  /**
+   * @brief Returns the reason of the last failure.
+   * @return The error.
+   */
+  OtaError getLastError() const { return _lastError.load(); }
+
+  /**
+   * @brief Returns the number of image bytes in flash.
+   * @return Bytes written (including the resumed part).
+   */
+  uint32_t getBytesWritten() const { return _bytesWritten.load(); }
+
+  /**
+   * @brief Returns the image size, if the server reported it.
+   * @return The size in bytes, or 0 if unknown.
+   */
+  uint32_t getImageSize() const { return _imageSize.load(); }
+
+  /**
+   * @brief Returns the progress of the running download.
+   * @return 0..100, or 0 if the size is unknown.
+   */
+  uint8_t getProgressPercent() const;
+
+  /**
+   * @brief Returns the smoothed download-and-write throughput.
+   * @return Bytes per second.
+   */
+  uint32_t getThroughputBps() const { return _throughputBps.load(); }
+
+  /**
+   * @brief Checks whether the running image still awaits confirmation.
+   * @return True if the bootloader would roll back on the next reset.
+   */
+  bool isPendingVerify() const { return _pendingVerify; }
+
+private:
+  WifiManager* _wifiManager;                 ///< Pointer to the WifiManager (not owned).
+  LanguageManager* _languageManager;         ///< Pointer to the LanguageManager (not owned).
+  MessageBoardElement* _messageBoard;        ///< Pointer to the message board (not owned).
+  const OtaUpdaterConfig* _config;           ///< Pointer to the configuration (owned by SystemInitializer).
+  const esp_partition_t* _partition;         ///< Partition the next image is written to.
+  bool _initialized;                         ///< True once `init()` succeeded.
+
+  TaskHandle_t _task;                        ///< Download task, or nullptr.
+  std::atomic<bool> _taskRunning;            ///< True while the download task runs.
+  std::atomic<bool> _abortRequested;         ///< Asks the download task to stop.
+  std::string _url;                          ///< URL of the current download (read by the task).
+  std::string _sha256Hex;                    ///< Expected hash of the current download (read by the task).
+  bool _checkOnly;                           ///< The task fetches the manifest before downloading.
+  std::string _responseEtag;                 ///< ETag of the last response (set by the HTTP event handler).
+  uint32_t _responseTotal;                   ///< Image size from the last Content-Range (0 if none).
+
+  std::atomic<OtaState> _state;              ///< Current state.
+  std::atomic<OtaError> _lastError;          ///< Reason of the last failure.
+  std::atomic<uint32_t> _bytesWritten;       ///< Image bytes in flash.
+  std::atomic<uint32_t> _imageSize;          ///< Image size, 0 if unknown.
+  std::atomic<uint32_t> _throughputBps;      ///< Smoothed throughput.
+
+  std::string _checkpointUrl;                ///< URL of the download interrupted before this boot.
+  std::string _checkpointSha256;             ///< Expected hash of that download.
+  bool _resumePending;                       ///< Resume the checkpoint once Wi-Fi is connected.
+  std::string _runningSha256;                ///< Hash of the running image, if this updater installed it.
+  bool _checkedOnce;                         ///< The manifest was checked since boot.
+  bool _stopped;                             ///< Set by `stop()`; no task is started any more.
+  unsigned long _lastCheckMs;                ///< Time of the last manifest check.
+
+  bool _pendingVerify;                       ///< Running image awaits confirmation.
+  bool _reportedResult;                      ///< Result of the current/last update has been shown.
+  OtaState _shownState;                      ///< State last shown on the message board.
+  uint8_t _shownPercent;                     ///< Progress last shown on the message board.
+  unsigned long _lastProgressMs;             ///< Time of the last progress update.
+  unsigned long _readySinceMs;               ///< Time the installation completed.
+  std::function<void()> _onActivity;         ///< Called from `loop()` while downloading.
+
+  /**
+   * @brief Download task entry point.
+   * @param arg Pointer to the OtaUpdater instance.
+   */
+  static void _taskFn(void* arg);
+
+  /**
+   * @brief Starts the download task.
+   * @return True if the task was created.
+   */
+  bool _startTask();
+
+  /**
+   * @brief Downloads, verifies and installs the image. Runs on the download task.
+   * @return The result (NONE on success).
+   */
+  OtaError _run();
+
+  /**
+   * @brief Fetches the manifest and, if it names a different image, sets `_url` and `_sha256Hex`.
+   * Runs on the download task.
+   * @return True if an update should be installed.
+   */
+  bool _fetchManifest();
+
+  /**
+   * @brief HTTP client event handler. Records the ETag and Content-Range of responses.
+   * @param event The event; `user_data` is the OtaUpdater instance.
+   * @return ESP_OK.
+   */
+  static esp_err_t _onHttpEvent(esp_http_client_event_t* event);
+
+  /**
+   * @brief Hashes the first `length` bytes already in the partition (resume).
+   * @param sha Pointer to the running `mbedtls_sha256_context`.
+   * @param buffer Scratch buffer of `chunkBytes`.
+   * @param length Number of bytes to hash.
+   * @return True on success.
+   */
+  bool _rehash(void* sha, uint8_t* buffer, uint32_t length);
+
+  /**
+   * @brief Stores the checkpoint in NVS. An empty URL clears it.
+   * @param url Image URL.
+   * @param sha256Hex Expected hash.
+   * @param etag Strong ETag of the image (empty if the server sent none).
+   * @param imageSize Size of the image (0 if unknown; such a download cannot be resumed).
+   * @param bytes Bytes in flash that are covered by the checkpoint.
+   */
+  void _saveCheckpoint(const std::string& url, const std::string& sha256Hex, const std::string& etag,
+                       uint32_t imageSize, uint32_t bytes);
+
+  /**
+   * @brief Shows the progress or the result of the update on the message board.
+   */
+  void _updateDisplay();
+
+  /**
+   * @brief Confirms the running image or rolls it back, depending on the system status.
+   */
+  void _checkRunningImage();
+
+  /**
+   * @brief Returns a localized string.
+   * @param key The string key.
+   * @param fallback Text used if the key or the LanguageManager is missing.
+   * @return The string.
+   */
+  std::string _text(const char* key, const char* fallback) const;
+};
+
+#endif // OTA_UPDATER_H
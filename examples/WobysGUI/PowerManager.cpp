@@ -49,16 +49,21 @@
 PowerManager::PowerManager(StatusbarUI* statusbar, IconElement* batteryIconElement)
   : _statusbarPtr(statusbar),
     _batteryIconElement(batteryIconElement),
-    _lastBatteryCheckMillis(0),
+    _batteryCheckTimer([this]() { checkBatteryStatus(); }),
     _lowBatteryShutdownArmed(false),
+    _shutdownInProgress(false),
+    _adcProcessedExternally(false),
+    _currentBatteryLevel(-1),
     _currentBatteryVoltage(0.0f),
     _currentBatteryLevelIcon('?'), // Initial unknown icon, init() will set the first real value.
     _batteryLevelChangedCallback(nullptr),
     _shutdownWarningCallback(nullptr),
     _performShutdownCallback(nullptr),
+    _performShutdownAsyncCallback(nullptr),
     _batteryVoltageUpdateCallback(nullptr),
+    _loadStateProvider(nullptr),
     _battAdcPin(0), _powerCtrlPin(0), _r1ValueOhm(0.0f), _r2ValueOhm(0.0f),
-    _batteryCheckIntervalMs(0), _lowThresholdPowerOffVolts(0.0f), _hysteresisVolts(0.0f),
+    _batteryCheckIntervalMs(0), _lowThresholdPowerOffVolts(0.0f), _hysteresisVolts(0.0f), _iconHysteresisVolts(0.0f),
     _battIconLevel6('?'), _battIconLevel5('?'), _battIconLevel4('?'), _battIconLevel3('?'),
     _battIconLevel2('?'), _battIconLevel1('?'), _battIconLevel0('?'), _battIconLevelUnknown('?'),
     _battVoltageLevel6(0.0f), _battVoltageLevel5(0.0f), _battVoltageLevel4(0.0f), _battVoltageLevel3(0.0f),
@@ -87,6 +92,8 @@ void PowerManager::init(const PowerManagerConfig& config) {
   _batteryCheckIntervalMs = config.batteryCheckIntervalMs;
   _lowThresholdPowerOffVolts = config.lowThresholdPowerOffVolts;
   _hysteresisVolts = config.hysteresisVolts;
+  _iconHysteresisVolts = config.iconHysteresisVolts;
+  _socEstimator.init(config.soc);
 
   _battIconLevel6 = config.battIconLevel6;
   _battIconLevel5 = config.battIconLevel5;
@@ -112,17 +119,22 @@ void PowerManager::init(const PowerManagerConfig& config) {
 
   // First battery check and UI update
   _currentBatteryVoltage = readBatteryVoltage();
-  _currentBatteryLevelIcon = determineBatteryLevelIcon(_currentBatteryVoltage);
+  _currentBatteryLevel = determineBatteryLevel(updateStateOfCharge(_currentBatteryVoltage));
+  _currentBatteryLevelIcon = batteryLevelIcon(_currentBatteryLevel);
   if (_batteryIconElement) { // Null pointer check
     _batteryIconElement->setIcon(_currentBatteryLevelIcon);
   }
   if (_batteryLevelChangedCallback) { // Null pointer check
     _batteryLevelChangedCallback(_currentBatteryLevelIcon);
   }
-  _lastBatteryCheckMillis = millis();
+  // Switch to continuous sampling after the first (one-shot) reading; the two modes cannot share the ADC.
+  if (config.continuousAdc && !_adcSampler.begin(_battAdcPin)) {
+    DEBUG_WARN_PRINTLN("PowerManager: Continuous ADC not available, falling back to periodic readings.");
+  }
+  g_timerWheel.start(_batteryCheckTimer, _batteryCheckIntervalMs, _batteryCheckIntervalMs);
   DEBUG_INFO_PRINTF(
-    "PowerManager: Initial battery voltage: %.2fV, Icon: '%c'\n",
-    _currentBatteryVoltage, _currentBatteryLevelIcon);
+    "PowerManager: Initial battery voltage: %.2fV, Icon: '%c', State of charge: %d%%\n",
+    _currentBatteryVoltage, _currentBatteryLevelIcon, getStateOfChargePercent());
   DEBUG_INFO_PRINTLN("PowerManager: init() completed.");
 }
 
@@ -155,23 +167,40 @@ void PowerManager::setBatteryIconElement(IconElement* element) {
 }
 
 /**
- * @brief Main loop function for PowerManager.
- * Should be called repeatedly in the Arduino loop(). Monitors battery and manages power.
+ * @brief Sets the function that reports the subsystem states for the load estimate.
+ * @param provider The `std::function` returning the current `BatteryLoadState`.
+ */
+void PowerManager::setLoadStateProvider(std::function<BatteryLoadState()> provider) {
+  _loadStateProvider = provider;
+}
+
+/**
+ * @brief Selects who samples the battery: `_batteryCheckTimer` on the UI task, or a manager task
+ * that feeds `applyBatteryVoltage()`.
+ * @param external True if a manager task samples the battery, false to use the built-in timer.
  */
-void PowerManager::loop() {
-  unsigned long currentMillis = millis();
-  if (currentMillis - _lastBatteryCheckMillis >= _batteryCheckIntervalMs) {
-    _lastBatteryCheckMillis = currentMillis;
-    checkBatteryStatus();
+void PowerManager::setExternalSampling(bool external) {
+  if (external) {
+    g_timerWheel.cancel(_batteryCheckTimer);
+  } else if (!_batteryCheckTimer.isActive()) {
+    g_timerWheel.start(_batteryCheckTimer, _batteryCheckIntervalMs, _batteryCheckIntervalMs);
   }
 }
 
 /**
- * @brief Reads the raw battery voltage from the ADC pin and converts it to Volts.
- * This method takes multiple readings and averages them for accuracy.
+ * @brief Reads the battery voltage and converts it to Volts.
+ * With the continuous ADC, the filtered value is read without touching the ADC; until the first
+ * batch has been filtered the previous voltage is kept. Otherwise this method takes multiple
+ * readings and averages them for accuracy.
  * @return The calculated battery voltage in Volts.
  */
 float PowerManager::readBatteryVoltage() {
+  if (_adcSampler.isRunning()) {
+    if (!_adcSampler.hasSample()) return _currentBatteryVoltage;
+    const float voltageDividerRatio = (_r1ValueOhm + _r2ValueOhm) / _r2ValueOhm;
+    return _adcSampler.getFilteredMilliVolts() / 1000.0f * voltageDividerRatio;
+  }
+
   int numReadings = 10;
   long sum_mV = 0;
   for (int i = 0; i < numReadings; i++) {
@@ -188,32 +217,93 @@ float PowerManager::readBatteryVoltage() {
 }
 
 /**
- * @brief Determines the appropriate battery icon character based on the provided voltage.
- * This method uses the configured voltage thresholds to map voltage to an icon.
+ * @brief Determines the battery level based on the provided voltage.
+ * This method uses the configured voltage thresholds to map voltage to a level.
  * @param voltage The current battery voltage.
- * @return The character icon representing the battery level.
+ * @return The battery level (0..6), or -1 if the voltage is not a number.
  */
-char PowerManager::determineBatteryLevelIcon(float voltage) {
+int PowerManager::determineBatteryLevel(float voltage) const {
   // Now uses member variables set by init() from the config struct
-  if (voltage >= _battVoltageLevel6) return _battIconLevel6;
-  else if (voltage >= _battVoltageLevel5) return _battIconLevel5;
-  else if (voltage >= _battVoltageLevel4) return _battIconLevel4;
-  else if (voltage >= _battVoltageLevel3) return _battIconLevel3;
-  else if (voltage >= _battVoltageLevel2) return _battIconLevel2;
-  else if (voltage >= _battVoltageLevel1) return _battIconLevel1;
+  if (voltage >= _battVoltageLevel6) return 6;
+  else if (voltage >= _battVoltageLevel5) return 5;
+  else if (voltage >= _battVoltageLevel4) return 4;
+  else if (voltage >= _battVoltageLevel3) return 3;
+  else if (voltage >= _battVoltageLevel2) return 2;
+  else if (voltage >= _battVoltageLevel1) return 1;
   else if (voltage < _battVoltageLevel1) { // If below the lowest threshold
-    return _battIconLevel0;
+    return 0;
+  }
+  return -1; // Fallback for unexpected values
+}
+
+/**
+ * @brief Determines the next displayed battery level with hysteresis.
+ * Going down requires the voltage to be `_iconHysteresisVolts` below the threshold of the current
+ * level, going up requires it to be that much above the threshold of the new level.
+ * @param voltage The current battery voltage.
+ * @return The battery level to display (0..6), or -1 if unknown.
+ */
+int PowerManager::nextBatteryLevel(float voltage) const {
+  if (_currentBatteryLevel < 0) return determineBatteryLevel(voltage);
+
+  const int lower = determineBatteryLevel(voltage + _iconHysteresisVolts);
+  if (lower < _currentBatteryLevel) return lower;
+  const int upper = determineBatteryLevel(voltage - _iconHysteresisVolts);
+  if (upper > _currentBatteryLevel) return upper;
+  return _currentBatteryLevel;
+}
+
+/**
+ * @brief Maps a battery level to its icon character.
+ * @param level The battery level (0..6), or -1 for unknown.
+ * @return The character icon representing the battery level.
+ */
+char PowerManager::batteryLevelIcon(int level) const {
+  switch (level) {
+    case 6: return _battIconLevel6;
+    case 5: return _battIconLevel5;
+    case 4: return _battIconLevel4;
+    case 3: return _battIconLevel3;
+    case 2: return _battIconLevel2;
+    case 1: return _battIconLevel1;
+    case 0: return _battIconLevel0;
+    default: return _battIconLevelUnknown;
   }
-  return _battIconLevelUnknown; // Fallback for unexpected values
+}
+
+/**
+ * @brief Feeds a voltage sample to the state of charge estimator, with the current estimated from
+ * the subsystem states reported by `_loadStateProvider`.
+ * @param voltage The measured battery voltage in Volts.
+ * @return The load-compensated voltage, used for the battery icon so it does not jump with the load.
+ */
+float PowerManager::updateStateOfCharge(float voltage) {
+  const BatteryLoadState load = _loadStateProvider ? _loadStateProvider() : BatteryLoadState();
+  _socEstimator.update(voltage, _socEstimator.estimateLoadMilliAmps(load), millis());
+  const float compensated = _socEstimator.getCompensatedVoltage();
+  return compensated > 0.0f ? compensated : voltage;
 }
 
 /**
  * @brief Checks the current battery status and triggers warnings or shutdown if necessary.
- * This is the core logic for battery monitoring, invoked periodically by `loop()`.
+ * Invoked periodically by `_batteryCheckTimer` unless sampling runs on a manager task.
  */
 void PowerManager::checkBatteryStatus() {
-  _currentBatteryVoltage = readBatteryVoltage();
-  char newLevelIcon = determineBatteryLevelIcon(_currentBatteryVoltage);
+  if (_adcSampler.isRunning() && !_adcProcessedExternally) {
+    _adcSampler.process(); // No sampling task: filter the DMA results here.
+  }
+  applyBatteryVoltage(readBatteryVoltage());
+}
+
+/**
+ * @brief Applies a battery voltage sample: updates the state of charge and the icon, notifies
+ * the callbacks and arms or disarms the low battery shutdown. Must be called on the UI task.
+ * @param voltage The sampled battery voltage in Volts.
+ */
+void PowerManager::applyBatteryVoltage(float voltage) {
+  _currentBatteryVoltage = voltage;
+  _currentBatteryLevel = nextBatteryLevel(updateStateOfCharge(_currentBatteryVoltage));
+  char newLevelIcon = batteryLevelIcon(_currentBatteryLevel);
 
   if (_batteryVoltageUpdateCallback) { // Null pointer check
     _batteryVoltageUpdateCallback(_currentBatteryVoltage);
@@ -235,6 +325,7 @@ void PowerManager::checkBatteryStatus() {
   }
 
   // Low battery shutdown logic
+  // Uses the measured (loaded) voltage: that is what the regulator sees.
   // Also check _currentBatteryVoltage > 0.5f to prevent triggering on 0V readings (e.g., disconnected battery)
   if (_currentBatteryVoltage < _lowThresholdPowerOffVolts &&
       _currentBatteryVoltage > 0.5f) {
@@ -265,13 +356,22 @@ void PowerManager::checkBatteryStatus() {
  * actual power-off procedure.
  */
 void PowerManager::requestSystemPowerOff() {
+  if (_shutdownInProgress) {
+    DEBUG_INFO_PRINTLN("PowerManager: Shutdown already in progress, request ignored.");
+    return;
+  }
   DEBUG_INFO_PRINTLN("PowerManager: System power-off requested.");
 
   if (_shutdownWarningCallback) { // Null pointer check
     _shutdownWarningCallback("POWER_INFO_SHUTDOWN_INIT");
   }
 
-  if (_performShutdownCallback) { // Null pointer check
+  if (_performShutdownAsyncCallback) {
+    // The final tasks run on the main loop; the callback powers off when they are done.
+    DEBUG_INFO_PRINTLN("PowerManager: Starting asynchronous shutdown sequence...");
+    _shutdownInProgress = true;
+    _performShutdownAsyncCallback([this]() { performActualPowerOff(); });
+  } else if (_performShutdownCallback) { // Null pointer check
     DEBUG_INFO_PRINTLN("PowerManager: Calling _performShutdownCallback...");
     _performShutdownCallback();
     DEBUG_INFO_PRINTLN("PowerManager: _performShutdownCallback RETURNED. Now calling performActualPowerOff().");
@@ -362,4 +462,16 @@ void PowerManager::setOnShutdownWarningCallback(
 void PowerManager::setOnPerformShutdownCallback(std::function<void()> callback) {
     _performShutdownCallback = callback;
     DEBUG_INFO_PRINTLN("PowerManager: OnPerformShutdown callback registered.");
+}
+
+/**
+ * @brief Sets an asynchronous shutdown callback, used instead of the synchronous one.
+ *
+ * The callback receives the function that performs the actual power-off and calls it once
+ * the final tasks have completed.
+ * @param callback The `std::function` to register, which takes the power-off function as an argument.
+ */
+void PowerManager::setOnPerformShutdownAsyncCallback(std::function<void(std::function<void()> powerOff)> callback) {
+    _performShutdownAsyncCallback = callback;
+    DEBUG_INFO_PRINTLN("PowerManager: OnPerformShutdownAsync callback registered.");
 }
\ No newline at end of file
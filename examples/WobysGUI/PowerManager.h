@@ -41,6 +41,9 @@
 #include <functional>   // For std::function
 #include <string>       // For std::string in callbacks
 #include "Config.h"     // For ALL custom configurations (e.g., DEBUG_PRINT macros)
+#include "TimerWheel.h" // For the periodic battery check timer
+#include "BatteryAdcSampler.h" // For continuous battery sampling
+#include "BatterySocEstimator.h" // For the state of charge and remaining runtime
 
 // Forward declarations to avoid circular dependencies.
 // The PowerManagerConfig struct is defined in SystemInitializer.h.
@@ -52,8 +55,8 @@ class IconElement;
  * @brief Manages battery status, voltage monitoring, and system power control.
  *
  * The PowerManager handles reading battery voltage, determining the corresponding
- * battery level icon, and triggering warnings or system shutdown based on
- * configurable thresholds. It also provides an interface for UI elements
+ * battery level icon, estimating the state of charge and the remaining runtime,
+ * and triggering warnings or system shutdown based on configurable thresholds. It also provides an interface for UI elements
  * to register callbacks for battery status updates and shutdown events.
  */
 class PowerManager {
@@ -89,15 +92,7 @@ class PowerManager {
      */
     void setBatteryIconElement(IconElement* element);
 
-    // Main Loop and System Control
-    /**
-     * @brief Main loop function for PowerManager.
-     *
-     * This method should be called repeatedly in the Arduino `loop()` function.
-     * It periodically checks the battery status and manages power-related events.
-     */
-    void loop();
-
+    // System Control
     /**
      * @brief Requests a graceful system power-off.
      *
@@ -116,6 +111,57 @@ class PowerManager {
      */
     void enablePowerRelay(int powerCtrlPin);
 
+    // Battery Sampling
+    /**
+     * @brief Reads the battery voltage in Volts.
+     * With the continuous ADC this returns the latest filtered value (a single atomic load).
+     * Otherwise it takes multiple readings and averages them. It only touches the ADC, so it may be
+     * called from a manager task.
+     * @return The calculated battery voltage in Volts.
+     */
+    float readBatteryVoltage();
+
+    /**
+     * @brief Checks whether the battery is sampled by the continuous ADC.
+     * @return True if the continuous ADC is running.
+     */
+    bool isContinuousAdcActive() const { return _adcSampler.isRunning(); }
+
+    /**
+     * @brief Drains and filters the continuous ADC results. Called on the battery sampling task.
+     * @return Milliseconds until the next call.
+     */
+    uint32_t processAdcSamples() { return _adcSampler.process(); }
+
+    /**
+     * @brief Selects who filters the continuous ADC results.
+     * By default `_batteryCheckTimer` does it on the UI task before reading the value.
+     * @param external True if a manager task calls `processAdcSamples()`, false otherwise.
+     */
+    void setExternalAdcProcessing(bool external) { _adcProcessedExternally = external; }
+
+    /**
+     * @brief Applies a battery voltage sample: updates the state of charge and the icon, notifies
+     * the callbacks and arms or disarms the low battery shutdown. This is the core logic for battery monitoring.
+     * Must be called on the UI task.
+     * @param voltage The sampled battery voltage in Volts.
+     */
+    void applyBatteryVoltage(float voltage);
+
+    /**
+     * @brief Selects who samples the battery.
+     * By default `_batteryCheckTimer` samples it on the UI task. When a manager task takes over,
+     * the timer is stopped and the task feeds `applyBatteryVoltage()` instead.
+     * @param external True if a manager task samples the battery, false to use the built-in timer.
+     */
+    void setExternalSampling(bool external);
+
+    /**
+     * @brief Retrieves the configured battery check interval.
+     * @return The interval in milliseconds.
+     */
+    unsigned long getBatteryCheckIntervalMs() const { return _batteryCheckIntervalMs; }
+
     // Getters for Current State
     /**
      * @brief Retrieves the current battery voltage.
@@ -129,6 +175,45 @@ class PowerManager {
      */
     char getCurrentBatteryLevelIcon() const;
 
+    /**
+     * @brief Retrieves the estimated state of charge.
+     * @return The state of charge in percent (0-100), or -1 if not known yet.
+     */
+    int getStateOfChargePercent() const { return _socEstimator.getPercent(); }
+
+    /**
+     * @brief Retrieves the predicted remaining runtime at the recent average load.
+     * @return The remaining runtime in minutes, or -1 if not known yet or while charging.
+     */
+    int getRemainingRuntimeMinutes() const { return _socEstimator.getRemainingMinutes(); }
+
+    /**
+     * @brief Retrieves whether a charger is connected and charging the battery.
+     * @return True while charging.
+     */
+    bool isCharging() const { return _socEstimator.isCharging(); }
+
+    /**
+     * @brief Retrieves the predicted time until the charger ends the charge.
+     * @return The time to full in minutes, or -1 while not charging.
+     */
+    int getMinutesToFull() const { return _socEstimator.getMinutesToFull(); }
+
+    /**
+     * @brief Retrieves the battery voltage corrected for the sag under the estimated load.
+     * @return The open-circuit voltage in Volts, or 0 if not known yet.
+     */
+    float getCompensatedVoltage() const { return _socEstimator.getCompensatedVoltage(); }
+
+    /**
+     * @brief Sets the function that reports the states of the subsystems drawing most of the
+     * battery current (backlight, radios, audio). Called on the UI task with every battery sample.
+     * Without a provider only the base load is assumed.
+     *
+     * @param provider The `std::function` returning the current `BatteryLoadState`.
+     */
+    void setLoadStateProvider(std::function<BatteryLoadState()> provider);
+
     // Callback Setup Methods
     /**
      * @brief Sets the callback function to be invoked when the battery level icon changes.
@@ -161,6 +246,16 @@ class PowerManager {
      */
     void setOnPerformShutdownCallback(std::function<void()> callback);
 
+    /**
+     * @brief Sets an asynchronous shutdown callback, used instead of the synchronous one.
+     *
+     * The callback starts the final tasks (e.g. as a coroutine on the main loop) and returns at
+     * once; it calls the `powerOff` function it receives when the tasks are done. Further power-off
+     * requests are ignored while the sequence runs.
+     * @param callback The `std::function` to register, which takes the power-off function as an argument.
+     */
+    void setOnPerformShutdownAsyncCallback(std::function<void(std::function<void()> powerOff)> callback);
+
 
   private:
     // Core Dependencies
@@ -168,8 +263,13 @@ class PowerManager {
     IconElement* _batteryIconElement;   ///< Pointer to the `IconElement` instance used for displaying the battery status.
 
     // Internal State Variables
-    unsigned long _lastBatteryCheckMillis; ///< Timestamp of the last battery voltage check in milliseconds.
+    TimerWheel::Timer _batteryCheckTimer;  ///< Periodic timer on `g_timerWheel` that runs `checkBatteryStatus()`.
     bool _lowBatteryShutdownArmed;         ///< Flag indicating if the system is armed for an automatic low battery shutdown.
+    bool _shutdownInProgress;              ///< Set once an asynchronous shutdown sequence has been started.
+    BatteryAdcSampler _adcSampler;         ///< Continuous ADC sampling of the battery (if enabled and available).
+    bool _adcProcessedExternally;          ///< True if a manager task filters the continuous ADC results.
+    BatterySocEstimator _socEstimator;     ///< State of charge and remaining runtime estimation.
+    int _currentBatteryLevel;              ///< Displayed battery level (0..6), or -1 if unknown.
     float _currentBatteryVoltage;          ///< The most recently read battery voltage in Volts.
     char _currentBatteryLevelIcon;         ///< The character icon representing the current battery charge level.
 
@@ -181,6 +281,7 @@ class PowerManager {
     unsigned long _batteryCheckIntervalMs; ///< The interval (in milliseconds) at which the battery voltage is checked.
     float _lowThresholdPowerOffVolts;    ///< The voltage threshold (in Volts) below which an automatic system shutdown is initiated.
     float _hysteresisVolts;              ///< The hysteresis voltage (in Volts) to prevent rapid toggling of the low battery warning.
+    float _iconHysteresisVolts;          ///< Margin (in Volts) beyond a level threshold before the battery icon changes.
 
     // Battery Icon and Voltage Level Thresholds (set via `init()` method)
     char _battIconLevel6;               ///< Icon for battery level 6 (highest).
@@ -202,27 +303,45 @@ class PowerManager {
     std::function<void(char newLevelIcon)> _batteryLevelChangedCallback;         ///< Callback for battery icon changes.
     std::function<void(const std::string& messageKey)> _shutdownWarningCallback; ///< Callback for shutdown warnings.
     std::function<void()> _performShutdownCallback;                              ///< Callback before actual power-off.
+    std::function<void(std::function<void()> powerOff)> _performShutdownAsyncCallback; ///< Asynchronous variant, preferred when set.
     std::function<void(float newVoltage)> _batteryVoltageUpdateCallback;         ///< Callback for raw voltage updates.
+    std::function<BatteryLoadState()> _loadStateProvider;                        ///< Reports the subsystem states for the load estimate.
 
     // Private Helper Methods
     /**
-     * @brief Reads the raw battery voltage from the ADC pin and converts it to Volts.
-     * This method takes multiple readings and averages them for accuracy.
-     * @return The calculated battery voltage in Volts.
+     * @brief Determines the battery level based on the provided voltage.
+     * This method uses the configured voltage thresholds to map voltage to a level.
+     * @param voltage The current battery voltage.
+     * @return The battery level (0..6), or -1 if the voltage is not a number.
      */
-    float readBatteryVoltage();
+    int determineBatteryLevel(float voltage) const;
 
     /**
-     * @brief Determines the appropriate battery icon character based on the provided voltage.
-     * This method uses the configured voltage thresholds to map voltage to an icon.
+     * @brief Determines the next displayed battery level with hysteresis.
+     * The level only changes once the voltage is past a threshold by `_iconHysteresisVolts`,
+     * so a voltage hovering at a threshold does not make the icon flicker.
      * @param voltage The current battery voltage.
+     * @return The battery level to display (0..6), or -1 if unknown.
+     */
+    int nextBatteryLevel(float voltage) const;
+
+    /**
+     * @brief Maps a battery level to its icon character.
+     * @param level The battery level (0..6), or -1 for unknown.
      * @return The character icon representing the battery level.
      */
-    char determineBatteryLevelIcon(float voltage);
+    char batteryLevelIcon(int level) const;
+
+    /**
+     * @brief Feeds a voltage sample to the state of charge estimator.
+     * @param voltage The measured battery voltage in Volts.
+     * @return The load-compensated voltage, used for the battery icon.
+     */
+    float updateStateOfCharge(float voltage);
 
     /**
      * @brief Checks the current battery status and triggers warnings or shutdown if necessary.
-     * This is the core logic for battery monitoring, invoked periodically by `loop()`.
+     * Invoked periodically by `_batteryCheckTimer` unless sampling runs on a manager task.
      */
     void checkBatteryStatus();
 
@@ -35,6 +35,7 @@
  */
 #include "RFIDManager.h"
 #include <SPI.h> // Required for `SPI.begin()` and `SPI` object
+#include <algorithm> // For std::min
 // Required for `RFIDManagerConfig` struct definition (defined in SystemInitializer.h).
 #include "SystemInitializer.h"
 #include "IconElement.h" // Required for `IconElement` class definition
@@ -51,10 +52,15 @@ RFIDManager::RFIDManager()
     _isEnabled(true),
     _rfidIconElement(nullptr), // Initialize pointer to nullptr.
     _cardScannedCallback(nullptr),
-    _lastCardCheckTime(0),
+    _cardCheckTimer([this]() { _pollCard(); }),
     _previousUID(), // Empty vector.
-    _lastSuccessfulReadTime(0)
+    _lastSuccessfulReadTime(0),
+    _externalPolling(false)
 {
+  _chipMutex = xSemaphoreCreateMutex(); // Serializes MFRC522 access between the UI and a manager task.
+  if (!_chipMutex) {
+    DEBUG_ERROR_PRINTLN("RFIDManager: ERROR - Failed to create chip mutex!");
+  }
   DEBUG_INFO_PRINTLN("RFIDManager: Constructor executed.");
 }
 
@@ -68,6 +74,7 @@ RFIDManager::RFIDManager()
 RFIDManager::~RFIDManager() {
     DEBUG_INFO_PRINTLN("RFIDManager: Destructor executed. Releasing MFRC522 driver resources.");
     _cleanup(); // Call cleanup to ensure any active MFRC522 features are stopped/reset.
+    if (_chipMutex) vSemaphoreDelete(_chipMutex);
 }
 
 // --- Initialization & Lifecycle ---
@@ -129,38 +136,50 @@ bool RFIDManager::init(const RFIDManagerConfig& config) {
   _mfrc522->PCD_Init(); // Re-init after self-test.
   
   _isEnabled = true; // Set to true after successful allocation and init.
+  if (!_externalPolling) {
+    g_timerWheel.start(_cardCheckTimer, CARD_CHECK_INTERVAL, CARD_CHECK_INTERVAL);
+  }
   DEBUG_INFO_PRINTLN("RFIDManager: Initialization completed. Searching for cards...");
   return true;
 }
 
 /**
- * @brief Main loop method for the RFIDManager.
- * This function should be called repeatedly in the Arduino `loop()` function.
- * It continuously checks for the presence of new RFID cards and attempts to read them.
- * It respects the enabled/disabled state of the manager and incorporates debouncing logic.
+ * @brief Polls the reader and delivers a newly read card on the UI task.
+ * Runs every `CARD_CHECK_INTERVAL` milliseconds from `_cardCheckTimer` while scanning is enabled
+ * and no manager task polls the reader.
  */
-void RFIDManager::loop() {
-  // If RFID is disabled, or MFRC522 object not initialized, skip loop logic.
-  if (!_isEnabled || !_mfrc522) { // _mfrc522 will be nullptr if init failed.
-      return;
+void RFIDManager::_pollCard() {
+  RFIDRawScan scan;
+  if (pollCard(scan)) {
+    deliverScan(scan);
   }
+}
 
-  unsigned long currentTime = millis();
+/**
+ * @brief Checks for the presence of a new RFID card and attempts to read it.
+ * Only the MFRC522 is accessed here, so it may be called from a manager task.
+ * It incorporates debouncing logic for repeated reads of the same card.
+ * @param scan Receives the UID and SAK of the card.
+ * @return True if a new (not debounced) card was read, false otherwise.
+ */
+bool RFIDManager::pollCard(RFIDRawScan& scan) {
+  ChipLock chipLock(_chipMutex);
 
-  // Apply check interval cooldown.
-  if (currentTime - _lastCardCheckTime < CARD_CHECK_INTERVAL) {
-    return;
+  // If RFID is disabled, or MFRC522 object not initialized, skip polling.
+  if (!_isEnabled || !_mfrc522) { // _mfrc522 will be nullptr if init failed.
+      return false;
   }
-  _lastCardCheckTime = currentTime;
+
+  unsigned long currentTime = millis();
 
   // Check for new cards.
   if (!_mfrc522->PICC_IsNewCardPresent()) {
-    return;
+    return false;
   }
 
   // Read card serial (UID).
   if (!_mfrc522->PICC_ReadCardSerial()) {
-    return;
+    return false;
   }
 
   // Debounce logic: check if the same card was read recently.
@@ -179,24 +198,42 @@ void RFIDManager::loop() {
   // If same card and within debounce interval, ignore.
   if (sameAsPrevious && (currentTime - _lastSuccessfulReadTime < DEBOUNCE_READ_INTERVAL)) {
     DEBUG_TRACE_PRINTLN("RFIDManager: Same card detected within debounce interval, ignoring.");
-    return;
+    return false;
   }
 
+  // MFRC522::uid.uidByte array has a maximum capacity of 10 bytes.
+  scan.uidSize = std::min<byte>(_mfrc522->uid.size, sizeof(scan.uid));
+  memcpy(scan.uid, _mfrc522->uid.uidByte, scan.uidSize);
+  scan.sak = _mfrc522->uid.sak;
+
+  // Update debouncing state.
+  _previousUID.assign(scan.uid, scan.uid + scan.uidSize);
+  _lastSuccessfulReadTime = currentTime;
+
+  _mfrc522->PICC_HaltA(); // Halt PICC to prevent multiple reads of the same card in short interval.
+  return true;
+}
+
+/**
+ * @brief Builds the card data for a scan returned by `pollCard()` and invokes the scanned-card callback.
+ * Must be called on the UI task.
+ * @param scan The raw scan to deliver.
+ */
+void RFIDManager::deliverScan(const RFIDRawScan& scan) {
   // Process newly detected card.
   RFIDCardData cardData;
-  cardData.uid_bytes.assign(_mfrc522->uid.uidByte, _mfrc522->uid.uidByte + _mfrc522->uid.size);
+  cardData.uid_bytes.assign(scan.uid, scan.uid + scan.uidSize);
 
   // Convert UID bytes to hexadecimal string.
-  // MFRC522::uid.uidByte array has a maximum capacity of 10 bytes.
   // Each byte is converted to 2 hexadecimal characters (e.g., "0A", "FF").
   // Plus, 1 byte for the null terminator. So, 10 bytes * 2 chars/byte + 1 null terminator = 21 bytes.
   // A buffer size of 32 is used for safety and potential future formatting changes.
   char uidBuffer[32]; // Sufficient for 10 UID bytes (20 hex chars) + separators/null.
   char* ptr = uidBuffer; 
-  for (byte i = 0; i < _mfrc522->uid.size; i++) {
+  for (byte i = 0; i < scan.uidSize; i++) {
     // Check for buffer overflow before writing.
     if ((ptr - uidBuffer) + 2 < sizeof(uidBuffer)) {
-        sprintf(ptr, "%02X", _mfrc522->uid.uidByte[i]);
+        sprintf(ptr, "%02X", scan.uid[i]);
         ptr += 2;
     } else {
         DEBUG_ERROR_PRINTLN("RFIDManager: UID buffer overflow prevented during string conversion.");
@@ -207,8 +244,8 @@ void RFIDManager::loop() {
   cardData.uid_string = std::string(uidBuffer);
 
   // Determine PICC type.
-  cardData.picc_type = _mfrc522->PICC_GetType(_mfrc522->uid.sak);
-  cardData.card_type_string = getPICCTypeName(cardData.picc_type, _mfrc522->uid.sak);
+  cardData.picc_type = MFRC522::PICC_GetType(scan.sak);
+  cardData.card_type_string = getPICCTypeName(cardData.picc_type, scan.sak);
 
   DEBUG_INFO_PRINTF("RFIDManager: Card read! UID: %s, Type: %s.\n",
                cardData.uid_string.c_str(), cardData.card_type_string.c_str());
@@ -217,12 +254,20 @@ void RFIDManager::loop() {
   if (_cardScannedCallback) {
     _cardScannedCallback(cardData);
   }
+}
 
-  // Update debouncing state.
-  _previousUID = cardData.uid_bytes;
-  _lastSuccessfulReadTime = currentTime;
-
-  _mfrc522->PICC_HaltA(); // Halt PICC to prevent multiple reads of the same card in short interval.
+/**
+ * @brief Selects who polls the reader: `_cardCheckTimer` on the UI task, or a manager task that
+ * calls `pollCard()` and hands the results to `deliverScan()`.
+ * @param external True if a manager task polls the reader, false to use the built-in timer.
+ */
+void RFIDManager::setExternalPolling(bool external) {
+  _externalPolling = external;
+  if (external) {
+    g_timerWheel.cancel(_cardCheckTimer);
+  } else if (_isEnabled && _mfrc522) {
+    g_timerWheel.start(_cardCheckTimer, CARD_CHECK_INTERVAL, CARD_CHECK_INTERVAL);
+  }
 }
 
 // --- Configuration & Control ---
@@ -233,12 +278,16 @@ void RFIDManager::loop() {
  * @param enabled True to enable RFID scanning, false to disable.
  */
 void RFIDManager::setEnabled(bool enabled) {
+    ChipLock chipLock(_chipMutex); // A manager task may be polling the reader.
     if (_isEnabled != enabled) {
         _isEnabled = enabled;
         if (_isEnabled) {
             DEBUG_INFO_PRINTLN("RFIDManager: Scanning enabled. Re-initializing MFRC522...");
             if (_mfrc522) { // Ensure MFRC522 object is valid before using.
                 _mfrc522->PCD_Init(); // Bring out of power down.
+                if (!_externalPolling) {
+                    g_timerWheel.start(_cardCheckTimer, CARD_CHECK_INTERVAL, CARD_CHECK_INTERVAL);
+                }
             } else {
                 DEBUG_WARN_PRINTLN("RFIDManager: WARNING - _mfrc522 is nullptr, cannot init PCD.");
             }
@@ -249,6 +298,7 @@ void RFIDManager::setEnabled(bool enabled) {
             }
         } else {
             DEBUG_INFO_PRINTLN("RFIDManager: Scanning disabled. Putting MFRC522 into SoftPowerDown...");
+            g_timerWheel.cancel(_cardCheckTimer); // No polling while powered down.
             if (_mfrc522) { // Ensure MFRC522 object is valid before using.
                 _mfrc522->PCD_SoftPowerDown();
             } else {
@@ -301,6 +351,8 @@ void RFIDManager::setOnCardScannedCallback(CardScannedCallback callback) {
  * `std::unique_ptr` automatically handles memory deallocation.
  */
 void RFIDManager::_cleanup() {
+    g_timerWheel.cancel(_cardCheckTimer); // Stop polling before the driver objects go away.
+    ChipLock chipLock(_chipMutex);
     // Resetting unique_ptrs will free the memory they manage.
     if (_mfrc522) {
         // Attempt to put the MFRC522 into a safe state before releasing its resources.
@@ -40,8 +40,11 @@
 #include <vector>
 #include <string>
 #include <functional>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
 #include "Config.h"
 #include "ListItem.h"
+#include "TimerWheel.h"
 
 // Required MFRC522 library headers.
 #include <MFRC522v2.h>
@@ -71,6 +74,16 @@ struct RFIDCardData {
       return ListItem({ ColumnData(uid_string), ColumnData("X") });
   }
 };
+
+/**
+ * @brief Raw result of a card read, small enough to pass through a FreeRTOS queue.
+ * `RFIDManager::deliverScan()` turns it into an `RFIDCardData` on the UI task.
+ */
+struct RFIDRawScan {
+  byte uid[10];   ///< UID bytes (MFRC522 UIDs are at most 10 bytes).
+  byte uidSize;   ///< Number of valid bytes in `uid`.
+  byte sak;       ///< SAK (Select Acknowledge) byte, used to determine the card type.
+};
     
 /**
  * @brief The RFIDManager class manages RFID reader operations.
@@ -116,14 +129,6 @@ public:
    */
   bool init(const RFIDManagerConfig& config);
   
-  /**
-   * @brief Main loop method for the RFIDManager.
-   * This function should be called repeatedly in the Arduino `loop()` function.
-   * It continuously checks for the presence of new RFID cards and attempts to read them.
-   * It respects the enabled/disabled state of the manager and incorporates debouncing logic.
-   */
-  void loop();
-
   // --- Configuration & Control ---
   /**
    * @brief Enables or disables the RFID scanning functionality.
@@ -139,6 +144,37 @@ public:
    */
   bool isEnabled() const;
 
+  // --- Polling ---
+  /**
+   * @brief Checks for the presence of a new RFID card and attempts to read it.
+   * Only the MFRC522 is accessed, so it may be called from a manager task.
+   * Repeated reads of the same card within `DEBOUNCE_READ_INTERVAL` are ignored.
+   * @param scan Receives the UID and SAK of the card.
+   * @return True if a new card was read, false otherwise.
+   */
+  bool pollCard(RFIDRawScan& scan);
+
+  /**
+   * @brief Builds the card data for a scan returned by `pollCard()` and invokes the scanned-card callback.
+   * Must be called on the UI task.
+   * @param scan The raw scan to deliver.
+   */
+  void deliverScan(const RFIDRawScan& scan);
+
+  /**
+   * @brief Selects who polls the reader.
+   * By default `_cardCheckTimer` polls it on the UI task. When a manager task takes over, the
+   * timer is stopped and the task calls `pollCard()` instead.
+   * @param external True if a manager task polls the reader, false to use the built-in timer.
+   */
+  void setExternalPolling(bool external);
+
+  /**
+   * @brief Retrieves the interval between card presence checks.
+   * @return The interval in milliseconds.
+   */
+  unsigned long getCardCheckIntervalMs() const { return CARD_CHECK_INTERVAL; }
+
   // --- UI Integration ---
   /**
    * @brief Sets the `IconElement` instance used to display the RFID module's status.
@@ -172,11 +208,28 @@ private:
   CardScannedCallback _cardScannedCallback; ///< Registered callback for scanned card events.
 
   // --- Timing & Debouncing ---
-  unsigned long _lastCardCheckTime;  ///< Timestamp of the last RFID card presence check.
+  TimerWheel::Timer _cardCheckTimer; ///< Periodic timer on `g_timerWheel` that runs `_pollCard()` while scanning is enabled.
   std::vector<byte> _previousUID;    ///< Stores the UID of the last successfully read card for debouncing.
   unsigned long _lastSuccessfulReadTime; ///< Timestamp of the last successful, debounced card read.
   const unsigned long CARD_CHECK_INTERVAL = 200; ///< Interval in milliseconds between checking for new cards.
   const unsigned long DEBOUNCE_READ_INTERVAL = 1500; ///< Interval in milliseconds to debounce repeated reads of the same card.
+  bool _externalPolling;             ///< True while a manager task polls the reader instead of `_cardCheckTimer`.
+
+  // --- Task Safety ---
+  SemaphoreHandle_t _chipMutex;      ///< Serializes MFRC522 access between the UI task and a polling manager task.
+
+  /**
+   * @brief RAII helper that holds `_chipMutex` for the lifetime of the object.
+   */
+  class ChipLock {
+  public:
+    explicit ChipLock(SemaphoreHandle_t mutex) : _mutex(mutex) { if (_mutex) xSemaphoreTake(_mutex, portMAX_DELAY); }
+    ~ChipLock() { if (_mutex) xSemaphoreGive(_mutex); }
+    ChipLock(const ChipLock&) = delete;
+    ChipLock& operator=(const ChipLock&) = delete;
+  private:
+    SemaphoreHandle_t _mutex; ///< The held mutex.
+  };
 
 
   // --- Private Helper Methods ---
@@ -187,6 +240,13 @@ private:
    */
   void _cleanup();
 
+  /**
+   * @brief Polls the reader and delivers a newly read card on the UI task.
+   * Runs every `CARD_CHECK_INTERVAL` milliseconds from `_cardCheckTimer` while scanning is enabled
+   * and no manager task polls the reader.
+   */
+  void _pollCard();
+
   /**
    * @brief Converts a `MFRC522Constants::PICC_Type` enum and SAK value to a human-readable string.
    * @param piccType The `PICC_Type` enum value representing the card type.
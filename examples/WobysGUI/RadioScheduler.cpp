@@ -0,0 +1,349 @@
+/**
+ * @file RadioScheduler.cpp
+ * @brief Implements the RadioScheduler class, which time-slices the shared 2.4 GHz radio between Wi-Fi and BLE.
+ *
+ * @version 1.0.0
+ * @date 2025-08-23
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "RadioScheduler.h"
+#include "SystemInitializer.h" // For RadioSchedulerConfig
+#include <algorithm>
+
+#if __has_include("esp_coexist.h")
+#include "esp_coexist.h"
+#define RADIO_SCHEDULER_HAS_ESP_COEX 1
+#endif
+
+/**
+ * @brief Returns the Arduino `millis()` counter.
+ * @return Milliseconds since boot.
+ */
+uint32_t SystemRadioClock::nowMs() const {
+  return millis();
+}
+
+/**
+ * @brief Constructor for the RadioScheduler class.
+ * @param clock Time source. If nullptr, an internal `SystemRadioClock` is used.
+ */
+RadioScheduler::RadioScheduler(RadioClock* clock)
+  : _clock(clock ? clock : &_systemClock),
+    _config(nullptr),
+    _nextId(1),
+    _expiredCount(0),
+    _timelineHead(0),
+    _coexMode(RadioCoexMode::BALANCE),
+    _sliceEpochMs(0) {
+}
+
+/**
+ * @brief Applies the configuration and installs the ESP32 coexistence handler.
+ * @param config Slice and deadline parameters.
+ * @return True on success.
+ */
+bool RadioScheduler::init(const RadioSchedulerConfig& config) {
+  _config = &config;
+  _timeline.reserve(_config->timelineCapacity);
+
+#ifdef RADIO_SCHEDULER_HAS_ESP_COEX
+  if (!_coexHandler && _config->applyCoexPreference) {
+    _coexHandler = [](RadioCoexMode mode) {
+      esp_coex_prefer_t prefer = ESP_COEX_PREFER_BALANCE;
+      if (mode == RadioCoexMode::PREFER_WIFI) prefer = ESP_COEX_PREFER_WIFI;
+      else if (mode == RadioCoexMode::PREFER_BLE) prefer = ESP_COEX_PREFER_BT;
+      esp_err_t err = esp_coex_preference_set(prefer);
+      if (err != ESP_OK) {
+        DEBUG_WARN_PRINTF("RadioScheduler: esp_coex_preference_set failed (%d).\n", err);
+      }
+    };
+  }
+#endif
+
+  DEBUG_INFO_PRINTF("RadioScheduler: Initialized (slice period %lu ms, min slice %lu ms).\n",
+                    (unsigned long)_config->slicePeriodMs, (unsigned long)_config->minSliceMs);
+  return true;
+}
+
+/**
+ * @brief Queues a request for radio time.
+ * @param request The request.
+ * @return The request ID.
+ */
+RadioRequestId RadioScheduler::submit(const RadioRequest& request) {
+  RadioRequestId id = _nextId++;
+  if (_nextId == 0) _nextId = 1;
+  _pending.push_back({ id, request, _clock->nowMs(), 0 });
+  DEBUG_TRACE_PRINTF("RadioScheduler: Request %lu queued (%s, kind %u, prio %u).\n",
+                     (unsigned long)id, request.owner == RadioOwner::WIFI ? "Wi-Fi" : "BLE",
+                     (unsigned)request.kind, (unsigned)request.priority);
+  return id;
+}
+
+/**
+ * @brief Marks a running request as finished, or removes a pending one.
+ * @param id The request ID.
+ */
+void RadioScheduler::complete(RadioRequestId id) {
+  for (auto it = _running.begin(); it != _running.end(); ++it) {
+    if (it->id == id) {
+      _record({ it->startMs, _clock->nowMs(), it->request.owner, it->request.kind, it->request.priority, false });
+      _running.erase(it);
+      return;
+    }
+  }
+  for (auto it = _pending.begin(); it != _pending.end(); ++it) {
+    if (it->id == id) {
+      _pending.erase(it);
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Registers a probe for an operation driven by a manager outside the scheduler.
+ * @param owner Radio the operation runs on.
+ * @param kind Kind of operation.
+ * @param priority Priority the operation is treated with while active.
+ * @param probe Returns true while the operation is running.
+ */
+void RadioScheduler::addActivityProbe(RadioOwner owner, RadioOpKind kind, RadioPriority priority, ActivityProbe probe) {
+  if (!probe) return;
+  _probes.push_back({ owner, kind, priority, probe, false, 0 });
+}
+
+/**
+ * @brief Expires stale requests, grants free radios, ends timed slots and updates the coexistence preference.
+ */
+void RadioScheduler::loop() {
+  if (!_config) return;
+  uint32_t now = _clock->nowMs();
+
+  // Manager-driven operations.
+  for (auto& p : _probes) {
+    bool active = p.probe();
+    if (active && !p.active) {
+      p.startMs = now;
+    } else if (!active && p.active) {
+      _record({ p.startMs, now, p.owner, p.kind, p.priority, true });
+    }
+    p.active = active;
+  }
+
+  // Timed slots end on their own.
+  for (size_t i = 0; i < _running.size();) {
+    const Slot& s = _running[i];
+    if (s.request.durationMs && now - s.startMs >= s.request.durationMs) {
+      _record({ s.startMs, now, s.request.owner, s.request.kind, s.request.priority, false });
+      _running.erase(_running.begin() + i);
+    } else {
+      ++i;
+    }
+  }
+
+  // Expire requests that waited past their deadline. Callbacks run after removal so they may resubmit.
+  std::vector<Slot> expired;
+  for (size_t i = 0; i < _pending.size();) {
+    if (now - _pending[i].submitMs > _deadlineOf(_pending[i])) {
+      expired.push_back(_pending[i]);
+      _pending.erase(_pending.begin() + i);
+    } else {
+      ++i;
+    }
+  }
+  for (const Slot& s : expired) {
+    _expiredCount++;
+    DEBUG_WARN_PRINTF("RadioScheduler: Request %lu expired after %lu ms.\n",
+                      (unsigned long)s.id, (unsigned long)(now - s.submitMs));
+    if (s.request.onExpired) s.request.onExpired(s.id);
+  }
+
+  _grant(RadioOwner::WIFI, now);
+  _grant(RadioOwner::BLE, now);
+  _updateCoex(now);
+}
+
+/**
+ * @brief Checks if a radio is currently occupied.
+ * @param owner The radio to check.
+ * @return True if a submitted or probed operation holds the radio.
+ */
+bool RadioScheduler::isBusy(RadioOwner owner) const {
+  bool busy = false;
+  _activePriority(owner, busy);
+  return busy;
+}
+
+/**
+ * @brief Copies the occupancy timeline, oldest first.
+ * @return The timeline entries.
+ */
+std::vector<RadioTimelineEntry> RadioScheduler::getTimeline() const {
+  std::vector<RadioTimelineEntry> out;
+  out.reserve(_timeline.size() + _running.size() + _probes.size());
+  for (size_t i = 0; i < _timeline.size(); ++i) {
+    out.push_back(_timeline[(_timelineHead + i) % _timeline.size()]);
+  }
+  uint32_t now = _clock->nowMs();
+  for (const Slot& s : _running) {
+    out.push_back({ s.startMs, now, s.request.owner, s.request.kind, s.request.priority, false });
+  }
+  for (const Probe& p : _probes) {
+    if (p.active) out.push_back({ p.startMs, now, p.owner, p.kind, p.priority, true });
+  }
+  return out;
+}
+
+/**
+ * @brief Returns the highest priority among the operations holding a radio.
+ * @param owner The radio.
+ * @param busy Set to true if any operation holds the radio.
+ * @return The highest priority (BACKGROUND if idle).
+ */
+RadioPriority RadioScheduler::_activePriority(RadioOwner owner, bool& busy) const {
+  busy = false;
+  uint8_t best = static_cast<uint8_t>(RadioPriority::BACKGROUND);
+  for (const Slot& s : _running) {
+    if (s.request.owner != owner) continue;
+    busy = true;
+    best = std::max(best, static_cast<uint8_t>(s.request.priority));
+  }
+  for (const Probe& p : _probes) {
+    if (p.owner != owner || !p.active) continue;
+    busy = true;
+    best = std::max(best, static_cast<uint8_t>(p.priority));
+  }
+  return static_cast<RadioPriority>(best);
+}
+
+/**
+ * @brief Starts pending requests for a radio. Scans and connects are exclusive per radio and are
+ * picked by highest priority, then earliest deadline; data requests run alongside them.
+ * @param owner The radio.
+ * @param now Current time.
+ */
+void RadioScheduler::_grant(RadioOwner owner, uint32_t now) {
+  while (true) {
+    bool exclusiveBusy = _isExclusiveBusy(owner);
+    int bestIndex = -1;
+    uint32_t bestRemaining = 0;
+    for (size_t i = 0; i < _pending.size(); ++i) {
+      const Slot& s = _pending[i];
+      if (s.request.owner != owner) continue;
+      if (exclusiveBusy && s.request.kind != RadioOpKind::DATA) continue;
+      uint32_t remaining = _deadlineOf(s) - (now - s.submitMs);
+      if (bestIndex < 0 ||
+          s.request.priority > _pending[bestIndex].request.priority ||
+          (s.request.priority == _pending[bestIndex].request.priority && remaining < bestRemaining)) {
+        bestIndex = static_cast<int>(i);
+        bestRemaining = remaining;
+      }
+    }
+    if (bestIndex < 0) return;
+
+    Slot slot = _pending[bestIndex];
+    _pending.erase(_pending.begin() + bestIndex);
+    slot.startMs = now;
+    _running.push_back(slot);
+    DEBUG_TRACE_PRINTF("RadioScheduler: Request %lu started after %lu ms.\n",
+                       (unsigned long)slot.id, (unsigned long)(now - slot.submitMs));
+    if (slot.request.onStart) slot.request.onStart(slot.id);
+  }
+}
+
+/**
+ * @brief Checks if a scan or connect currently holds a radio.
+ * @param owner The radio.
+ * @return True if an exclusive operation (submitted or probed) is running.
+ */
+bool RadioScheduler::_isExclusiveBusy(RadioOwner owner) const {
+  for (const Slot& s : _running) {
+    if (s.request.owner == owner && s.request.kind != RadioOpKind::DATA) return true;
+  }
+  for (const Probe& p : _probes) {
+    if (p.owner == owner && p.active && p.kind != RadioOpKind::DATA) return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Computes and applies the coexistence preference for the current time.
+ * @param now Current time.
+ */
+void RadioScheduler::_updateCoex(uint32_t now) {
+  bool wifiBusy = false;
+  bool bleBusy = false;
+  RadioPriority wifiPrio = _activePriority(RadioOwner::WIFI, wifiBusy);
+  RadioPriority blePrio = _activePriority(RadioOwner::BLE, bleBusy);
+
+  RadioCoexMode mode = RadioCoexMode::BALANCE;
+  if (wifiBusy && bleBusy) {
+    if (_sliceEpochMs == 0) _sliceEpochMs = now ? now : 1; // Both radios just became busy.
+
+    // Split each period by priority weight, keeping a minimum slice for the weaker side.
+    uint32_t period = _config->slicePeriodMs;
+    uint32_t wifiWeight = static_cast<uint32_t>(wifiPrio) + 1;
+    uint32_t bleWeight = static_cast<uint32_t>(blePrio) + 1;
+    uint32_t wifiShare = period * wifiWeight / (wifiWeight + bleWeight);
+    uint32_t minSlice = std::min(_config->minSliceMs, period / 2);
+    wifiShare = std::max(minSlice, std::min(wifiShare, period - minSlice));
+
+    uint32_t phase = (now - _sliceEpochMs) % period;
+    mode = (phase < wifiShare) ? RadioCoexMode::PREFER_WIFI : RadioCoexMode::PREFER_BLE;
+  } else {
+    _sliceEpochMs = 0;
+    if (wifiBusy) mode = RadioCoexMode::PREFER_WIFI;
+    else if (bleBusy) mode = RadioCoexMode::PREFER_BLE;
+  }
+
+  if (mode != _coexMode) {
+    _coexMode = mode;
+    if (_coexHandler) _coexHandler(mode);
+  }
+}
+
+/**
+ * @brief Appends a finished entry to the timeline ring buffer.
+ * @param entry The entry to record.
+ */
+void RadioScheduler::_record(const RadioTimelineEntry& entry) {
+  size_t capacity = _config ? _config->timelineCapacity : 0;
+  if (capacity == 0) return;
+  if (_timeline.size() < capacity) {
+    _timeline.push_back(entry);
+  } else {
+    _timeline[_timelineHead] = entry;
+    _timelineHead = (_timelineHead + 1) % capacity;
+  }
+}
+
+/**
+ * @brief Returns the effective start deadline of a request.
+ * @param slot The request.
+ * @return The deadline in milliseconds after submission.
+ */
+uint32_t RadioScheduler::_deadlineOf(const Slot& slot) const {
+  if (slot.request.deadlineMs) return slot.request.deadlineMs;
+  return _config ? _config->defaultDeadlineMs : 0;
+}
@@ -0,0 +1,349 @@
+/**
+ * @file RadioScheduler.h
+ * @brief Defines the RadioScheduler class, which time-slices the shared 2.4 GHz radio between Wi-Fi and BLE.
+ *
+ * The ESP32-S3 has a single 2.4 GHz radio shared by Wi-Fi and Bluetooth LE. This scheduler
+ * accepts scan, connect and data requests from both sides with a priority and a start deadline,
+ * runs at most one scan or connect per radio at a time, and, while both radios are busy, alternates the
+ * coexistence preference in fixed slice periods weighted by priority. Finished operations are
+ * kept in a small occupancy timeline for diagnostics.
+ *
+ * Time is read through the `RadioClock` interface, so the scheduling logic can be driven by a
+ * `SimulatedRadioClock` instead of `millis()`.
+ *
+ * @version 1.0.0
+ * @date 2025-08-23
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef RADIO_SCHEDULER_H
+#define RADIO_SCHEDULER_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Forward declaration for configuration struct (defined in SystemInitializer.h)
+struct RadioSchedulerConfig;
+
+/**
+ * @brief The radio a request belongs to.
+ */
+enum class RadioOwner : uint8_t {
+  WIFI, ///< Wi-Fi station.
+  BLE   ///< Bluetooth Low Energy.
+};
+
+/**
+ * @brief The kind of radio operation being requested.
+ */
+enum class RadioOpKind : uint8_t {
+  SCAN,    ///< Active or passive scan.
+  CONNECT, ///< Connection establishment.
+  DATA     ///< Ongoing traffic on an established link.
+};
+
+/**
+ * @brief Request priority. Higher values win the radio first and get a larger slice share.
+ */
+enum class RadioPriority : uint8_t {
+  BACKGROUND = 0,  ///< Housekeeping (e.g. idle link traffic).
+  NORMAL = 1,      ///< Regular operations started by the system.
+  INTERACTIVE = 2, ///< Operations the user is waiting for on screen.
+  CRITICAL = 3     ///< Must not be delayed (e.g. reconnect of an active session).
+};
+
+/**
+ * @brief Coexistence preference applied to the shared radio.
+ */
+enum class RadioCoexMode : uint8_t {
+  BALANCE,     ///< No preference (radio idle or a single low-priority user).
+  PREFER_WIFI, ///< Wi-Fi gets the radio.
+  PREFER_BLE   ///< Bluetooth LE gets the radio.
+};
+
+/**
+ * @brief Time source used by the scheduler.
+ */
+class RadioClock {
+public:
+  virtual ~RadioClock() = default;
+  /**
+   * @brief Returns the current time.
+   * @return Milliseconds since an arbitrary epoch (wraps like `millis()`).
+   */
+  virtual uint32_t nowMs() const = 0;
+};
+
+/**
+ * @brief Clock backed by the Arduino `millis()` counter.
+ */
+class SystemRadioClock : public RadioClock {
+public:
+  uint32_t nowMs() const override;
+};
+
+/**
+ * @brief Manually advanced clock, used to drive the scheduler deterministically.
+ */
+class SimulatedRadioClock : public RadioClock {
+public:
+  uint32_t nowMs() const override { return _nowMs; }
+  /**
+   * @brief Sets the current time.
+   * @param ms The new time in milliseconds.
+   */
+  void setMs(uint32_t ms) { _nowMs = ms; }
+  /**
+   * @brief Advances the current time.
+   * @param ms The number of milliseconds to advance.
+   */
+  void advanceMs(uint32_t ms) { _nowMs += ms; }
+private:
+  uint32_t _nowMs = 0; ///< Current simulated time.
+};
+
+/**
+ * @brief Identifier returned by `RadioScheduler::submit()`. Zero is never a valid ID.
+ */
+using RadioRequestId = uint32_t;
+
+/**
+ * @brief A request for radio time.
+ */
+struct RadioRequest {
+  RadioOwner owner = RadioOwner::WIFI;             ///< Radio the operation runs on.
+  RadioOpKind kind = RadioOpKind::SCAN;            ///< Kind of operation.
+  RadioPriority priority = RadioPriority::NORMAL;  ///< Scheduling priority.
+  uint32_t deadlineMs = 0;      ///< Maximum wait before the request starts (relative, 0 = scheduler default).
+  uint32_t durationMs = 0;      ///< Expected airtime; the slot ends automatically after it (0 = until `complete()`).
+  std::function<void(RadioRequestId id)> onStart;  ///< Called when the request is granted the radio.
+  std::function<void(RadioRequestId id)> onExpired; ///< Called if the deadline passes before the request starts.
+};
+
+/**
+ * @brief One finished (or ongoing) period of radio occupancy.
+ */
+struct RadioTimelineEntry {
+  uint32_t startMs;             ///< Time the operation got the radio.
+  uint32_t endMs;               ///< Time the operation released the radio.
+  RadioOwner owner;             ///< Radio that was used.
+  RadioOpKind kind;             ///< Kind of operation.
+  RadioPriority priority;       ///< Priority it ran with.
+  bool external;                ///< True if reported by a manager probe rather than submitted.
+};
+
+/**
+ * @brief Central scheduler for the shared Wi-Fi/BLE radio.
+ *
+ * Submitted requests wait in a queue and are started from `loop()`. Scans and connects are
+ * exclusive per radio: the pending one with the highest priority (then the earliest deadline)
+ * is granted as soon as that radio has no other scan or connect running. Data requests only
+ * take part in time-slicing. Operations started by the precompiled managers are reported
+ * through activity probes and count like submitted requests.
+ *
+ * While both radios are occupied, every slice period is split between them in proportion to
+ * their priorities (never less than the minimum slice), and the coexistence preference is
+ * switched accordingly. With a single busy radio it gets full preference.
+ */
+class RadioScheduler {
+public:
+  /**
+   * @brief Callback type used to apply a coexistence preference to the hardware.
+   * @param mode The preference to apply.
+   */
+  using CoexHandler = std::function<void(RadioCoexMode mode)>;
+
+  /**
+   * @brief Callback type of an activity probe; returns true while the monitored operation runs.
+   */
+  using ActivityProbe = std::function<bool()>;
+
+  /**
+   * @brief Constructor for the RadioScheduler class.
+   * @param clock Time source. If nullptr, an internal `SystemRadioClock` is used.
+   */
+  RadioScheduler(RadioClock* clock = nullptr);
+
+  /**
+   * @brief Applies the configuration and installs the ESP32 coexistence handler.
+   * @param config Slice and deadline parameters.
+   * @return True on success.
+   */
+  bool init(const RadioSchedulerConfig& config);
+
+  /**
+   * @brief Queues a request for radio time. It is started from `loop()`.
+   * @param request The request.
+   * @return The request ID.
+   */
+  RadioRequestId submit(const RadioRequest& request);
+
+  /**
+   * @brief Marks a running request as finished, or removes a pending one.
+   * @param id The request ID.
+   */
+  void complete(RadioRequestId id);
+
+  /**
+   * @brief Removes a request without invoking any callback. Same as `complete()`.
+   * @param id The request ID.
+   */
+  void cancel(RadioRequestId id) { complete(id); }
+
+  /**
+   * @brief Registers a probe for an operation driven by a manager outside the scheduler.
+   * @param owner Radio the operation runs on.
+   * @param kind Kind of operation.
+   * @param priority Priority the operation is treated with while active.
+   * @param probe Returns true while the operation is running.
+   */
+  void addActivityProbe(RadioOwner owner, RadioOpKind kind, RadioPriority priority, ActivityProbe probe);
+
+  /**
+   * @brief Expires stale requests, grants free radios, ends timed slots and updates the coexistence preference.
+   * Call regularly from the main loop.
+   */
+  void loop();
+
+  /**
+   * @brief Sets the handler that applies coexistence preferences (replaces the ESP32 default).
+   * @param handler The handler, or nullptr to only track the mode.
+   */
+  void setCoexHandler(CoexHandler handler) { _coexHandler = handler; }
+
+  /**
+   * @brief Returns the coexistence preference currently applied.
+   * @return The current mode.
+   */
+  RadioCoexMode getCoexMode() const { return _coexMode; }
+
+  /**
+   * @brief Checks if a radio is currently occupied.
+   * @param owner The radio to check.
+   * @return True if a submitted or probed operation holds the radio.
+   */
+  bool isBusy(RadioOwner owner) const;
+
+  /**
+   * @brief Returns the number of requests waiting for the radio.
+   * @return The pending request count.
+   */
+  size_t getPendingCount() const { return _pending.size(); }
+
+  /**
+   * @brief Returns the number of requests that expired before they could start.
+   * @return The expired request count.
+   */
+  uint32_t getExpiredCount() const { return _expiredCount; }
+
+  /**
+   * @brief Copies the occupancy timeline, oldest first. Running operations are included with `endMs` = now.
+   * @return The timeline entries.
+   */
+  std::vector<RadioTimelineEntry> getTimeline() const;
+
+private:
+  /**
+   * @brief A submitted request with its bookkeeping.
+   */
+  struct Slot {
+    RadioRequestId id;          ///< Request ID.
+    RadioRequest request;       ///< The request as submitted.
+    uint32_t submitMs;          ///< Time the request was submitted.
+    uint32_t startMs;           ///< Time the request was granted the radio.
+  };
+
+  /**
+   * @brief A registered probe and its last observed state.
+   */
+  struct Probe {
+    RadioOwner owner;           ///< Radio the operation runs on.
+    RadioOpKind kind;           ///< Kind of operation.
+    RadioPriority priority;     ///< Priority while active.
+    ActivityProbe probe;        ///< Returns true while active.
+    bool active;                ///< Last observed state.
+    uint32_t startMs;           ///< Time the operation was first seen active.
+  };
+
+  SystemRadioClock _systemClock;        ///< Default time source.
+  RadioClock* _clock;                   ///< Active time source (not owned).
+  const RadioSchedulerConfig* _config;  ///< Pointer to the configuration (owned by SystemInitializer).
+
+  std::vector<Slot> _pending;           ///< Requests waiting for their radio.
+  std::vector<Slot> _running;           ///< Requests holding their radio (at most one per radio).
+  std::vector<Probe> _probes;           ///< Probes for manager-driven operations.
+  RadioRequestId _nextId;               ///< Next request ID to hand out.
+  uint32_t _expiredCount;               ///< Requests that expired while pending.
+
+  std::vector<RadioTimelineEntry> _timeline; ///< Ring buffer of finished occupancy entries.
+  size_t _timelineHead;                 ///< Next write position in `_timeline` once it is full.
+
+  CoexHandler _coexHandler;             ///< Applies the preference to the hardware.
+  RadioCoexMode _coexMode;              ///< Preference currently applied.
+  uint32_t _sliceEpochMs;               ///< Start of the current shared-radio period sequence.
+
+  /**
+   * @brief Returns the highest priority among the operations holding a radio.
+   * @param owner The radio.
+   * @param busy Set to true if any operation holds the radio.
+   * @return The highest priority (BACKGROUND if idle).
+   */
+  RadioPriority _activePriority(RadioOwner owner, bool& busy) const;
+
+  /**
+   * @brief Starts pending requests for a radio (one exclusive operation at a time, data alongside).
+   * @param owner The radio.
+   * @param now Current time.
+   */
+  void _grant(RadioOwner owner, uint32_t now);
+
+  /**
+   * @brief Checks if a scan or connect currently holds a radio.
+   * @param owner The radio.
+   * @return True if an exclusive operation (submitted or probed) is running.
+   */
+  bool _isExclusiveBusy(RadioOwner owner) const;
+
+  /**
+   * @brief Computes and applies the coexistence preference for the current time.
+   * @param now Current time.
+   */
+  void _updateCoex(uint32_t now);
+
+  /**
+   * @brief Appends a finished entry to the timeline ring buffer.
+   * @param entry The entry to record.
+   */
+  void _record(const RadioTimelineEntry& entry);
+
+  /**
+   * @brief Returns the effective start deadline of a request.
+   * @param slot The request.
+   * @return The deadline in milliseconds after submission.
+   */
+  uint32_t _deadlineOf(const Slot& slot) const;
+};
+
+#endif // RADIO_SCHEDULER_H
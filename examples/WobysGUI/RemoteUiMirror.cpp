@@ -0,0 +1,476 @@
+/**
+ * @file RemoteUiMirror.cpp
+ * @brief Implements the RemoteUiMirror class, which streams the UI over WebSocket and accepts remote touches.
+ *
+ * @version 1.0.0
+ * @date 2025-08-28
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "RemoteUiMirror.h"
+#include "SystemInitializer.h" // For RemoteUiMirrorConfig
+#include "Config.h"            // For LGFX (ConfigLGFXUser.h) and DEBUG_* macros
+#include "MirrorCodec.h"
+#include "MirrorPanel.h"
+#include "WifiManager.h"
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#include <unistd.h> // For close()
+#include <cstring>
+
+namespace {
+constexpr unsigned long SERVER_RETRY_MS = 5000;
+static_assert(MirrorPanel::TILE_SIZE <= MirrorCodec::MAX_TILE_SIZE, "Tiles must fit the codec's tile buffers");
+}
+
+/**
+ * @brief Constructor for the RemoteUiMirror class.
+ * @param lcd Pointer to the display (provides the MirrorPanel).
+ * @param wifiManager Pointer to the WifiManager (the server starts once Wi-Fi is connected).
+ */
+RemoteUiMirror::RemoteUiMirror(LGFX* lcd, WifiManager* wifiManager)
+  : _lcd(lcd),
+    _wifiManager(wifiManager),
+    _panel(nullptr),
+    _config(nullptr),
+    _enabled(false),
+    _server(nullptr),
+    _clientFd(-1),
+    _keyframeRequested(false),
+    _frame(nullptr),
+    _frameCapacity(0),
+    _frameLen(0),
+    _sendBusy(false),
+    _sent(nullptr),
+    _geometryVersion(0),
+    _tileCursor(0),
+    _frameSeq(0),
+    _pendingSeq(0),
+    _lastFrameMs(0),
+    _frameStartUs(0),
+    _framesSent(0),
+    _framesDropped(0),
+    _bytesSent(0),
+    _throughputBps(0),
+    _lastFrameLatencyUs(0),
+    _initialBps(0),
+    _linkMux(portMUX_INITIALIZER_UNLOCKED),
+    _touchHead(0),
+    _touchTail(0),
+    _touchMux(portMUX_INITIALIZER_UNLOCKED),
+    _remotePressed(false),
+    _remoteX(0),
+    _remoteY(0),
+    _lastInjected{0, 0, false} {
+}
+
+/**
+ * @brief Destructor. Stops the server and frees the buffers.
+ */
+RemoteUiMirror::~RemoteUiMirror() {
+  if (_server) httpd_stop(_server); // Waits for the server task, including queued sends.
+  _server = nullptr;
+  if (_frame) heap_caps_free(_frame);
+  if (_sent) heap_caps_free(_sent);
+  if (_panel) _panel->disableShadow();
+}
+
+/**
+ * @brief Initializes the mirror. Enables the panel shadow and allocates the frame buffers.
+ * @param config Port, access token, frame timing and budget limits.
+ * @return True if the mirror is ready or disabled by configuration, false on allocation failure.
+ */
+bool RemoteUiMirror::init(const RemoteUiMirrorConfig& config) {
+  DEBUG_INFO_PRINTLN("RemoteUiMirror: init() starting...");
+  _config = &config;
+  if (!config.accessToken || !config.accessToken[0]) {
+    DEBUG_INFO_PRINTLN("RemoteUiMirror: No access token configured, remote UI disabled.");
+    return true;
+  }
+  if (!_lcd || !_wifiManager) {
+    DEBUG_ERROR_PRINTLN("RemoteUiMirror: LCD or WifiManager pointer is null. Initialization aborted.");
+    return false;
+  }
+
+  _panel = _lcd->getMirrorPanel();
+  if (!_panel || !_panel->enableShadow()) {
+    DEBUG_ERROR_PRINTLN("RemoteUiMirror: Shadow framebuffer unavailable. Initialization aborted.");
+    return false;
+  }
+
+  _frameCapacity = std::max(config.frameBufferBytes, MirrorCodec::FRAME_HEADER_BYTES + MirrorCodec::WORST_TILE_BYTES);
+  _frame = static_cast<uint8_t*>(heap_caps_malloc(_frameCapacity, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+  _sent = static_cast<uint16_t*>(heap_caps_malloc((size_t)TFT_WIDTH * TFT_HEIGHT * sizeof(uint16_t),
+                                                  MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+  if (!_frame || !_sent) {
+    DEBUG_ERROR_PRINTLN("RemoteUiMirror: Failed to allocate frame buffers.");
+    if (_frame) heap_caps_free(_frame);
+    if (_sent) heap_caps_free(_sent);
+    _frame = nullptr;
+    _sent = nullptr;
+    _panel->disableShadow();
+    return false;
+  }
+
+  // Start with a budget of twice the minimum frame per interval; the acknowledged rate takes over.
+  _initialBps = (uint32_t)(config.minFrameBytes * 2 * 1000 / std::max<uint32_t>(config.frameIntervalMs, 1));
+  _link.reset(_initialBps);
+  _throughputBps = _initialBps;
+  _geometryVersion = _panel->getGeometryVersion();
+  _enabled = true;
+  DEBUG_INFO_PRINTF("RemoteUiMirror: Initialized (port %u, server starts when Wi-Fi connects).\n", config.port);
+  return true;
+}
+
+/**
+ * @brief Starts the server when Wi-Fi is up and encodes the next frame when due. Call from the main loop.
+ */
+void RemoteUiMirror::loop() {
+  if (!_enabled) return;
+  unsigned long now = millis();
+
+  if (!_server) {
+    if (now - _lastFrameMs >= SERVER_RETRY_MS &&
+        _wifiManager->getCurrentState() == WifiMgr_State_t::CONNECTED) {
+      _lastFrameMs = now;
+      _startServer();
+    }
+    return;
+  }
+  if (_clientFd.load() < 0) return;
+  if (now - _lastFrameMs < _config->frameIntervalMs) return;
+  _lastFrameMs = now;
+
+  if (_sendBusy.load()) {
+    _framesDropped++; // The dirty tiles stay marked and go out with a later frame.
+    return;
+  }
+
+  // Keep at most one budget of unacknowledged bytes on the link, so frames never queue up
+  // in the socket faster than the client applies them.
+  portENTER_CRITICAL(&_linkMux);
+  const bool expired = _link.expire(esp_timer_get_time(), (int64_t)_config->ackTimeoutMs * 1000);
+  const size_t budget = _link.budget(_config->frameIntervalMs, _config->minFrameBytes, _frameCapacity);
+  const bool linkFree = _link.canSend() && _link.getBytesInFlight() < budget;
+  portEXIT_CRITICAL(&_linkMux);
+  if (expired) {
+    DEBUG_WARN_PRINTLN("RemoteUiMirror: Frames not acknowledged, halving the frame budget.");
+  }
+  if (!linkFree) {
+    if (_panel->hasDirtyTiles()) _framesDropped++;
+    return;
+  }
+
+  bool keyframe = _keyframeRequested.exchange(false);
+  if (_panel->getGeometryVersion() != _geometryVersion) {
+    _geometryVersion = _panel->getGeometryVersion();
+    keyframe = true;
+  }
+  if (keyframe) {
+    _panel->markAllDirty();
+    memset(_sent, 0, (size_t)_panel->getShadowWidth() * _panel->getShadowHeight() * sizeof(uint16_t));
+  }
+  if (!_panel->hasDirtyTiles()) return;
+
+  int64_t startUs = esp_timer_get_time();
+  size_t len = _encodeFrame(keyframe, budget);
+  if (!len) return;
+
+  _frameLen = len;
+  _pendingSeq = _frameSeq - 1;
+  _frameStartUs = startUs;
+  _sendBusy = true;
+  if (httpd_queue_work(_server, _sendWork, this) != ESP_OK) {
+    _sendBusy = false;
+    _framesDropped++;
+    _keyframeRequested = true; // The encoded tiles are lost; resynchronize the client.
+    return;
+  }
+  if (_onActivity) _onActivity();
+}
+
+/**
+ * @brief Closes the client connection and stops the server for good, for the shutdown.
+ */
+void RemoteUiMirror::stop() {
+  _enabled = false; // loop() no longer restarts the server and pollTouch() injects nothing.
+  if (_server) httpd_stop(_server); // Waits for the server task, including queued sends.
+  _server = nullptr;
+  _clientFd = -1;
+  _sendBusy = false;
+  DEBUG_INFO_PRINTLN("RemoteUiMirror: Stopped.");
+}
+
+/**
+ * @brief Returns the remote touch state, if the remote client is driving the UI.
+ * @param x Receives the X coordinate.
+ * @param y Receives the Y coordinate.
+ * @param pressed Receives the pressed state.
+ * @return True if the remote state should replace the local touch reading.
+ */
+bool RemoteUiMirror::pollTouch(int32_t* x, int32_t* y, bool* pressed) {
+  if (!_enabled) return false;
+
+  TouchEvent event;
+  bool haveEvent = false;
+  portENTER_CRITICAL(&_touchMux);
+  if (_touchTail != _touchHead) {
+    event = _touchQueue[_touchTail % TOUCH_QUEUE_LENGTH];
+    _touchTail++;
+    haveEvent = true;
+  }
+  portEXIT_CRITICAL(&_touchMux);
+
+  if (haveEvent) {
+    _remotePressed = event.pressed;
+    _remoteX = event.x;
+    _remoteY = event.y;
+  } else if (!_remotePressed) {
+    return false;
+  }
+  *x = _remoteX;
+  *y = _remoteY;
+  *pressed = _remotePressed;
+  return true;
+}
+
+/**
+ * @brief Starts the HTTP server and registers the WebSocket endpoint.
+ * @return True if the server is running.
+ */
+bool RemoteUiMirror::_startServer() {
+  httpd_config_t cfg = HTTPD_DEFAULT_CONFIG();
+  cfg.server_port = _config->port;
+  cfg.ctrl_port = _config->port + 1; // Keep clear of other server instances on the default control port.
+  cfg.max_open_sockets = 2;
+  cfg.max_uri_handlers = 1;
+  cfg.lru_purge_enable = true;
+  cfg.stack_size = _config->serverTaskStackSize;
+  cfg.task_priority = _config->serverTaskPriority;
+  cfg.core_id = _config->serverTaskCore;
+  cfg.global_user_ctx = this;
+  cfg.global_user_ctx_free_fn = [](void*) {}; // Not owned by the server.
+  cfg.close_fn = _onSocketClose;
+
+  if (httpd_start(&_server, &cfg) != ESP_OK) {
+    DEBUG_WARN_PRINTLN("RemoteUiMirror: Failed to start the server.");
+    _server = nullptr;
+    return false;
+  }
+
+  httpd_uri_t uri = {};
+  uri.uri = "/mirror";
+  uri.method = HTTP_GET;
+  uri.handler = _wsHandler;
+  uri.user_ctx = this;
+  uri.is_websocket = true;
+  if (httpd_register_uri_handler(_server, &uri) != ESP_OK) {
+    DEBUG_WARN_PRINTLN("RemoteUiMirror: Failed to register the WebSocket endpoint.");
+    httpd_stop(_server);
+    _server = nullptr;
+    return false;
+  }
+  DEBUG_INFO_PRINTF("RemoteUiMirror: Listening on port %u.\n", _config->port);
+  return true;
+}
+
+/**
+ * @brief Encodes the dirty tiles into `_frame` within a byte budget.
+ * @param keyframe True if the client clears its framebuffer before applying the frame.
+ * @param budget Maximum frame length.
+ * @return The frame length, or 0 if no tile was encoded.
+ */
+size_t RemoteUiMirror::_encodeFrame(bool keyframe, size_t budget) {
+  const uint16_t width = _panel->getShadowWidth();
+  const uint16_t height = _panel->getShadowHeight();
+  const uint32_t tiles = (uint32_t)_panel->getTilesX() * _panel->getTilesY();
+  if (!tiles) return 0;
+
+  const uint16_t* shadow = _panel->getShadow();
+  size_t len = MirrorCodec::FRAME_HEADER_BYTES;
+  uint16_t rects = 0;
+  uint32_t i = 0;
+  // Start where the previous frame stopped, so a small budget does not starve the lower tiles.
+  for (; i < tiles && _panel->hasDirtyTiles(); ++i) {
+    const uint32_t index = (_tileCursor + i) % tiles;
+    if (!_panel->isTileDirty(index)) continue;
+    if (len + MirrorCodec::WORST_TILE_BYTES > budget) break;
+
+    const uint16_t x = (index % _panel->getTilesX()) * MirrorPanel::TILE_SIZE;
+    const uint16_t y = (index / _panel->getTilesX()) * MirrorPanel::TILE_SIZE;
+    const uint8_t w = (uint8_t)std::min<uint16_t>(MirrorPanel::TILE_SIZE, width - x);
+    const uint8_t h = (uint8_t)std::min<uint16_t>(MirrorPanel::TILE_SIZE, height - y);
+    len += MirrorCodec::encodeTile(_frame + len, shadow, _sent, width, x, y, w, h);
+    _panel->clearTileDirty(index);
+    rects++;
+  }
+  _tileCursor = (_tileCursor + i) % tiles;
+  if (!rects) return 0;
+
+  MirrorCodec::writeFrameHeader(_frame, keyframe, width, height, _frameSeq++, rects);
+  return len;
+}
+
+/**
+ * @brief Queues a touch event received from the client. Moves are coalesced when the queue is full.
+ * @param event The event.
+ */
+void RemoteUiMirror::_pushTouch(const TouchEvent& event) {
+  portENTER_CRITICAL(&_touchMux);
+  if (_touchHead - _touchTail >= TOUCH_QUEUE_LENGTH) {
+    TouchEvent& last = _touchQueue[(_touchHead - 1) % TOUCH_QUEUE_LENGTH];
+    if (last.pressed && event.pressed) {
+      last = event; // Replace the last move.
+      _lastInjected = event;
+      portEXIT_CRITICAL(&_touchMux);
+      return;
+    }
+    _touchTail++; // Drop the oldest event; presses and releases stay in order.
+  }
+  _touchQueue[_touchHead % TOUCH_QUEUE_LENGTH] = event;
+  _touchHead++;
+  _lastInjected = event;
+  portEXIT_CRITICAL(&_touchMux);
+}
+
+/**
+ * @brief WebSocket handler (handshake and client messages). Runs on the server task.
+ * @param req The request.
+ * @return ESP_OK to keep the connection, an error to close it.
+ */
+esp_err_t RemoteUiMirror::_wsHandler(httpd_req_t* req) {
+  RemoteUiMirror* self = static_cast<RemoteUiMirror*>(req->user_ctx);
+  const int fd = httpd_req_to_sockfd(req);
+
+  if (req->method == HTTP_GET) { // Handshake of a new connection.
+    char query[96] = {0};
+    char token[64] = {0};
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) != ESP_OK ||
+        httpd_query_key_value(query, "token", token, sizeof(token)) != ESP_OK ||
+        !MirrorCodec::tokenEquals(token, self->_config->accessToken)) {
+      DEBUG_WARN_PRINTLN("RemoteUiMirror: Client rejected (invalid token).");
+      return ESP_FAIL;
+    }
+    int previous = self->_clientFd.exchange(fd);
+    if (previous >= 0 && previous != fd) {
+      httpd_sess_trigger_close(req->handle, previous);
+    }
+    portENTER_CRITICAL(&self->_linkMux);
+    self->_link.reset(self->_initialBps); // Frames in flight to the previous client are never acknowledged.
+    portEXIT_CRITICAL(&self->_linkMux);
+    self->_keyframeRequested = true;
+    DEBUG_INFO_PRINTF("RemoteUiMirror: Client connected (socket %d).\n", fd);
+    return ESP_OK;
+  }
+
+  httpd_ws_frame_t packet;
+  memset(&packet, 0, sizeof(packet));
+  esp_err_t err = httpd_ws_recv_frame(req, &packet, 0); // Reads the length only.
+  if (err != ESP_OK) return err;
+  uint8_t payload[8];
+  if (packet.len > sizeof(payload)) return ESP_FAIL; // No valid message is that long.
+  if (packet.len) {
+    packet.payload = payload;
+    err = httpd_ws_recv_frame(req, &packet, packet.len);
+    if (err != ESP_OK) return err;
+  }
+  if (fd != self->_clientFd.load() || packet.type != HTTPD_WS_TYPE_BINARY || !packet.len) return ESP_OK;
+
+  TouchEvent event;
+  uint32_t ackSeq;
+  if (MirrorCodec::parseTouch(payload, packet.len, self->_panel->getShadowWidth(), self->_panel->getShadowHeight(),
+                              &event.x, &event.y, &event.pressed)) {
+    self->_pushTouch(event);
+  } else if (MirrorCodec::parseAck(payload, packet.len, &ackSeq)) {
+    uint32_t latencyUs = 0;
+    portENTER_CRITICAL(&self->_linkMux);
+    const bool retired = self->_link.onAck(ackSeq, esp_timer_get_time(), &latencyUs);
+    const uint32_t throughputBps = self->_link.getThroughputBps();
+    portEXIT_CRITICAL(&self->_linkMux);
+    if (retired) {
+      self->_throughputBps = throughputBps;
+      if (latencyUs) self->_lastFrameLatencyUs = latencyUs;
+    }
+  } else if (payload[0] == 'K') {
+    self->_keyframeRequested = true;
+  }
+  return ESP_OK;
+}
+
+/**
+ * @brief Sends `_frame` to the client. Queued work, runs on the server task.
+ * @param arg Pointer to the RemoteUiMirror instance.
+ */
+void RemoteUiMirror::_sendWork(void* arg) {
+  RemoteUiMirror* self = static_cast<RemoteUiMirror*>(arg);
+  const int fd = self->_clientFd.load();
+  if (fd >= 0) {
+    httpd_ws_frame_t frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.final = true;
+    frame.type = HTTPD_WS_TYPE_BINARY;
+    frame.payload = self->_frame;
+    frame.len = self->_frameLen;
+
+    esp_err_t err = httpd_ws_send_frame_async(self->_server, fd, &frame);
+    if (err == ESP_OK) {
+      self->_framesSent++;
+      self->_bytesSent += (uint32_t)frame.len;
+      // Returning only means the socket took the data; the rate follows the client's acknowledgements.
+      portENTER_CRITICAL(&self->_linkMux);
+      self->_link.onFrameSent(self->_pendingSeq, (uint32_t)frame.len, self->_frameStartUs);
+      portEXIT_CRITICAL(&self->_linkMux);
+    } else {
+      DEBUG_WARN_PRINTF("RemoteUiMirror: Send failed (%d), closing client.\n", (int)err);
+      int expected = fd;
+      if (self->_clientFd.compare_exchange_strong(expected, -1)) {
+        httpd_sess_trigger_close(self->_server, fd);
+      }
+    }
+  }
+  self->_sendBusy = false;
+}
+
+/**
+ * @brief Socket close hook of the server. Forgets the client if its socket closes.
+ * @param hd The server handle.
+ * @param sockfd The closed socket.
+ */
+void RemoteUiMirror::_onSocketClose(httpd_handle_t hd, int sockfd) {
+  RemoteUiMirror* self = static_cast<RemoteUiMirror*>(httpd_get_global_user_ctx(hd));
+  if (self) {
+    int expected = sockfd;
+    if (self->_clientFd.compare_exchange_strong(expected, -1)) {
+      DEBUG_INFO_PRINTF("RemoteUiMirror: Client disconnected (socket %d).\n", sockfd);
+    }
+    // Do not leave the remote finger down on the UI.
+    portENTER_CRITICAL(&self->_touchMux);
+    TouchEvent last = self->_lastInjected;
+    portEXIT_CRITICAL(&self->_touchMux);
+    if (last.pressed && self->_clientFd.load() < 0) {
+      last.pressed = false;
+      self->_pushTouch(last);
+    }
+  }
+  close(sockfd); // The close hook owns the socket.
+}
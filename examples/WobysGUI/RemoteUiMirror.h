@@ -0,0 +1,235 @@
+/**
+ * @file RemoteUiMirror.h
+ * @brief Defines the RemoteUiMirror class, which streams the UI over WebSocket and accepts remote touches.
+ *
+ * A WebSocket endpoint (ESP-IDF HTTP server) sends the tiles that changed on screen, taken from
+ * the MirrorPanel shadow framebuffer, as run-length and delta encoded RGB565, and injects touch
+ * events received from the client into the main loop in place of `lcd.getTouch()`.
+ *
+ * Wire format (all integers little-endian, pixels RGB565 big-endian as sent to the panel):
+ * - Server frame: "WM", version (1), flags (bit 0: keyframe, the client clears its framebuffer to 0
+ *   first), width u16, height u16, sequence u32,
+ *   rect count u16; then per rect: x u16, y u16, w u8, h u8 and ops until w*h pixels are covered.
+ *   Op byte: bits 7..6 = kind, bits 5..0 = count - 1 (1..64 pixels).
+ *   Kind 0 = run (one pixel follows), 1 = literal (count pixels follow), 2 = unchanged since the
+ *   previous frame.
+ * - Client messages: 'T' flags(bit 0: pressed) x u16 y u16 = touch; 'K' = request a keyframe.
+ *
+ * @version 1.0.0
+ * @date 2025-08-28
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef REMOTE_UI_MIRROR_H
+#define REMOTE_UI_MIRROR_H
+
+#include <Arduino.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+
+#include <freertos/FreeRTOS.h>
+#include <esp_http_server.h>
+
+#include "MirrorCodec.h"
+
+// Forward declarations
+class LGFX;
+class MirrorPanel;
+class WifiManager;
+struct RemoteUiMirrorConfig; // Defined in SystemInitializer.h
+
+/**
+ * @brief Streams the UI to one WebSocket client and injects its touch input.
+ *
+ * Encoding runs on the UI task and only reads memory. Sending is queued to the HTTP server
+ * task, so a slow link never blocks drawing: while a frame is still being sent, the next frame
+ * is skipped (counted as dropped) and the dirty tiles accumulate until the link is free. The
+ * client acknowledges every frame it applied; the size of a frame is limited by a byte budget
+ * derived from the acknowledged delivery rate, and no new frame is encoded while one budget is
+ * still unacknowledged. Tiles that do not fit are sent in the following frames. The wire format
+ * is described in MirrorCodec.h; `tools/remote_ui_client.py` is a desktop client.
+ *
+ * The server only starts if an access token is configured; clients must connect to
+ * `ws://<ip>:<port>/mirror?token=<token>`. The token travels in clear text over plain `ws://`,
+ * so it only keeps casual clients on the same network out. A new client replaces the current one.
+ */
+class RemoteUiMirror {
+public:
+  /**
+   * @brief Constructor for the RemoteUiMirror class.
+   * @param lcd Pointer to the display (provides the MirrorPanel).
+   * @param wifiManager Pointer to the WifiManager (the server starts once Wi-Fi is connected).
+   */
+  RemoteUiMirror(LGFX* lcd, WifiManager* wifiManager);
+
+  /**
+   * @brief Destructor. Stops the server and frees the buffers.
+   */
+  ~RemoteUiMirror();
+
+  /**
+   * @brief Initializes the mirror. Enables the panel shadow and allocates the frame buffers.
+   * @param config Port, access token, frame timing and budget limits.
+   * @return True if the mirror is ready or disabled by configuration, false on allocation failure.
+   */
+  bool init(const RemoteUiMirrorConfig& config);
+
+  /**
+   * @brief Starts the server when Wi-Fi is up and encodes the next frame when due. Call from the main loop.
+   */
+  void loop();
+
+  /**
+   * @brief Closes the client connection and stops the server for good, for the shutdown.
+   * Waits for the server task, including a frame still being sent. Call from the main loop.
+   */
+  void stop();
+
+  /**
+   * @brief Returns the remote touch state, if the remote client is driving the UI.
+   * Each injected press/release is returned once, in order; while the remote finger is down
+   * its last position is returned.
+   * @param x Receives the X coordinate.
+   * @param y Receives the Y coordinate.
+   * @param pressed Receives the pressed state.
+   * @return True if the remote state should replace the local touch reading.
+   */
+  bool pollTouch(int32_t* x, int32_t* y, bool* pressed);
+
+  /**
+   * @brief Sets a callback invoked on the main loop whenever a frame is handed to the network.
+   * @param cb The callback (e.g. to report traffic to the Wi-Fi power-save policy).
+   */
+  void setOnActivityCallback(std::function<void()> cb) { _onActivity = cb; }
+
+  /** @brief Checks whether a client is connected. */
+  bool isClientConnected() const { return _clientFd.load() >= 0; }
+
+  /** @brief Returns the number of frames sent. */
+  uint32_t getFramesSent() const { return _framesSent.load(); }
+
+  /** @brief Returns the number of frames skipped because the previous one was still being sent. */
+  uint32_t getFramesDropped() const { return _framesDropped; }
+
+  /** @brief Returns the number of payload bytes sent. */
+  uint32_t getBytesSent() const { return _bytesSent.load(); }
+
+  /** @brief Returns the smoothed delivery rate acknowledged by the client, in bytes per second. */
+  uint32_t getThroughputBps() const { return _throughputBps.load(); }
+
+  /** @brief Returns the time from the start of encoding to the acknowledgement of the last acknowledged frame, in microseconds. */
+  uint32_t getLastFrameLatencyUs() const { return _lastFrameLatencyUs.load(); }
+
+private:
+  /**
+   * @brief One injected touch event.
+   */
+  struct TouchEvent {
+    int16_t x;     ///< X coordinate.
+    int16_t y;     ///< Y coordinate.
+    bool pressed;  ///< Pressed state.
+  };
+
+  static constexpr size_t TOUCH_QUEUE_LENGTH = 8; ///< Injected touch events buffered between two loops.
+
+  LGFX* _lcd;                                   ///< Pointer to the display (not owned).
+  WifiManager* _wifiManager;                    ///< Pointer to the WifiManager (not owned).
+  MirrorPanel* _panel;                          ///< Panel with the shadow framebuffer.
+  const RemoteUiMirrorConfig* _config;          ///< Pointer to the configuration (owned by SystemInitializer).
+  bool _enabled;                                ///< True if the mirror is configured and initialized.
+
+  httpd_handle_t _server;                       ///< HTTP/WebSocket server (nullptr until started).
+  std::atomic<int> _clientFd;                   ///< Socket of the connected client (-1 if none).
+  std::atomic<bool> _keyframeRequested;         ///< Next frame must be a keyframe (new client or resync).
+
+  uint8_t* _frame;                              ///< Encoded frame being sent.
+  size_t _frameCapacity;                        ///< Size of `_frame` in bytes.
+  size_t _frameLen;                             ///< Length of the encoded frame.
+  std::atomic<bool> _sendBusy;                  ///< True while the server task sends `_frame`.
+  uint16_t* _sent;                              ///< Pixels as last sent (for unchanged-pixel ops).
+  uint32_t _geometryVersion;                    ///< Panel geometry the client was last sent.
+  uint32_t _tileCursor;                         ///< Tile index where the next frame starts scanning.
+  uint32_t _frameSeq;                           ///< Sequence number of the next frame.
+  uint32_t _pendingSeq;                         ///< Sequence number of the frame in `_frame`.
+  unsigned long _lastFrameMs;                   ///< millis() of the last frame attempt.
+  int64_t _frameStartUs;                        ///< esp_timer time when the frame being sent was encoded.
+
+  std::atomic<uint32_t> _framesSent;            ///< Frames sent.
+  uint32_t _framesDropped;                      ///< Frames skipped because the link was busy.
+  std::atomic<uint32_t> _bytesSent;             ///< Bytes sent.
+  std::atomic<uint32_t> _throughputBps;         ///< Smoothed acknowledged delivery rate (copy for readers).
+  std::atomic<uint32_t> _lastFrameLatencyUs;    ///< Encode-to-acknowledgement time of the last acknowledged frame.
+  uint32_t _initialBps;                         ///< Delivery rate assumed for a new client.
+  MirrorLinkEstimator _link;                    ///< Frames in flight and delivery rate (protected by `_linkMux`).
+  portMUX_TYPE _linkMux;                        ///< Protects `_link` (main loop vs. server task).
+
+  TouchEvent _touchQueue[TOUCH_QUEUE_LENGTH];   ///< Injected touch events (server task -> main loop).
+  size_t _touchHead;                            ///< Next write position.
+  size_t _touchTail;                            ///< Next read position.
+  portMUX_TYPE _touchMux;                       ///< Protects the touch queue.
+  bool _remotePressed;                          ///< Remote finger is down.
+  int16_t _remoteX;                             ///< Last remote X coordinate.
+  int16_t _remoteY;                             ///< Last remote Y coordinate.
+  TouchEvent _lastInjected;                     ///< Last event queued by the server task (protected by `_touchMux`).
+
+  std::function<void()> _onActivity;            ///< Callback for network activity.
+
+  /**
+   * @brief Starts the HTTP server and registers the WebSocket endpoint.
+   * @return True if the server is running.
+   */
+  bool _startServer();
+
+  /**
+   * @brief Encodes the dirty tiles into `_frame` within a byte budget.
+   * @param keyframe True to encode without unchanged-pixel ops.
+   * @param budget Maximum frame length.
+   * @return The frame length, or 0 if no tile was encoded.
+   */
+  size_t _encodeFrame(bool keyframe, size_t budget);
+
+  /**
+   * @brief Queues a touch event received from the client.
+   * @param event The event.
+   */
+  void _pushTouch(const TouchEvent& event);
+
+  /**
+   * @brief WebSocket handler (handshake and client messages). Runs on the server task.
+   */
+  static esp_err_t _wsHandler(httpd_req_t* req);
+
+  /**
+   * @brief Sends `_frame` to the client. Queued work, runs on the server task.
+   */
+  static void _sendWork(void* arg);
+
+  /**
+   * @brief Socket close hook of the server. Forgets the client if its socket closes.
+   */
+  static void _onSocketClose(httpd_handle_t hd, int sockfd);
+};
+
+#endif // REMOTE_UI_MIRROR_H
@@ -121,7 +121,7 @@ bool SettingsManager::loadSettingsFromFile() {
   }
 
   // Use a sufficient buffer for JSON document (adjust size as settings grow).
-  DynamicJsonDocument doc(2048);
+  DynamicJsonDocument doc(3072);
 
   DeserializationError error = deserializeJson(doc, configFile);
   configFile.close();
@@ -158,6 +158,31 @@ bool SettingsManager::loadSettingsFromFile() {
   }
   DEBUG_INFO_PRINTF("SettingsManager: Loaded %d saved Wi-Fi networks.\n", _savedNetworks.size());
 
+  _wifiApHints.clear();
+  JsonArray hintsArray = doc["wifiApHints"].as<JsonArray>();
+  if (!hintsArray.isNull()) {
+    for (JsonObject hintObj : hintsArray) {
+      WifiApHint hint(hintObj["ssid"] | "");
+      if (hint.ssid.empty() || !findSavedNetwork(hint.ssid)) continue; // Drop hints of forgotten networks.
+      const char* bssidStr = hintObj["bssid"] | "";
+      unsigned int b[6];
+      if (sscanf(bssidStr, "%02x:%02x:%02x:%02x:%02x:%02x", &b[0], &b[1], &b[2], &b[3], &b[4], &b[5]) == 6) {
+        for (int i = 0; i < 6; ++i) hint.bssid[i] = static_cast<uint8_t>(b[i]);
+        hint.channel = hintObj["channel"] | 0;
+      }
+      JsonArray rssiArray = hintObj["rssi"].as<JsonArray>();
+      for (JsonVariant v : rssiArray) {
+        if (hint.rssiCount >= WIFI_AP_HINT_RSSI_HISTORY) break;
+        hint.rssiHistory[hint.rssiCount++] = v.as<int>();
+      }
+      hint.rssiHead = hint.rssiCount % WIFI_AP_HINT_RSSI_HISTORY;
+      hint.lastConnectMs = hintObj["connectMs"] | 0;
+      if (_wifiApHints.size() < MAX_SAVED_WIFI_NETWORKS) {
+        _wifiApHints.push_back(hint);
+      }
+    }
+  }
+
   // Load Bluetooth settings.
   _bluetoothEnabledLastState = doc["btEnabledLastState"] | false;
   _pairedBleDevices.clear();
@@ -214,7 +239,7 @@ bool SettingsManager::saveSettingsToFile() {
       return false;
   }
 
-  DynamicJsonDocument doc(2048); // Ensure sufficient buffer size.
+  DynamicJsonDocument doc(3072); // Ensure sufficient buffer size.
 
   // Save Wi-Fi settings.
   doc["deviceName"] = _deviceName;
@@ -229,6 +254,26 @@ bool SettingsManager::saveSettingsToFile() {
     networkObj["password"] = net.password; // Store empty string if no password.
   }
 
+  JsonArray hintsArray = doc.createNestedArray("wifiApHints");
+  for (const auto& hint : _wifiApHints) {
+    JsonObject hintObj = hintsArray.createNestedObject();
+    char bssidStr[18];
+    snprintf(bssidStr, sizeof(bssidStr), "%02X:%02X:%02X:%02X:%02X:%02X",
+             hint.bssid[0], hint.bssid[1], hint.bssid[2], hint.bssid[3], hint.bssid[4], hint.bssid[5]);
+    hintObj["ssid"] = hint.ssid;
+    hintObj["bssid"] = bssidStr;
+    hintObj["channel"] = hint.channel;
+    hintObj["connectMs"] = hint.lastConnectMs;
+    JsonArray rssiArray = hintObj.createNestedArray("rssi");
+    // Oldest first, so the order survives a load/save round trip.
+    for (uint8_t i = 0; i < hint.rssiCount; ++i) {
+      uint8_t idx = (hint.rssiCount < WIFI_AP_HINT_RSSI_HISTORY)
+                      ? i
+                      : (hint.rssiHead + i) % WIFI_AP_HINT_RSSI_HISTORY;
+      rssiArray.add(hint.rssiHistory[idx]);
+    }
+  }
+
   // Save Bluetooth settings.
   doc["btEnabledLastState"] = _bluetoothEnabledLastState;
   JsonArray bleArray = doc.createNestedArray("pairedBleDevices");
@@ -336,6 +381,10 @@ bool SettingsManager::removeSavedNetwork(const std::string& ssid) {
     _savedNetworks.end());
 
   if (changed) {
+    _wifiApHints.erase(
+      std::remove_if(_wifiApHints.begin(), _wifiApHints.end(),
+                     [&](const WifiApHint& hint) { return hint.ssid == ssid; }),
+      _wifiApHints.end());
     DEBUG_INFO_PRINTF("SettingsManager: Wi-Fi network '%s' removed.\n", ssid.c_str());
     return saveSettingsToFile();
   }
@@ -369,6 +418,7 @@ bool SettingsManager::clearAllSavedNetworks() {
   }
   if (!_savedNetworks.empty()) {
     _savedNetworks.clear();
+    _wifiApHints.clear();
     DEBUG_INFO_PRINTLN("SettingsManager: All saved Wi-Fi networks cleared.");
     return saveSettingsToFile();
   }
@@ -376,6 +426,84 @@ bool SettingsManager::clearAllSavedNetworks() {
   return true; // Already empty.
 }
 
+/**
+ * @brief Finds the cached access point hint for a saved network.
+ * @param ssid The SSID to look up.
+ * @return A `const pointer` to the `WifiApHint` if found, `nullptr` otherwise.
+ */
+const WifiApHint* SettingsManager::findWifiApHint(const std::string& ssid) const {
+  for (const auto& hint : _wifiApHints) {
+    if (hint.ssid == ssid) {
+      return &hint;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Records the access point used for a successful connection.
+ * @param ssid The SSID that was connected.
+ * @param bssid The 6-byte BSSID of the access point.
+ * @param channel The primary channel of the access point.
+ * @param rssi The RSSI at connect time.
+ * @param connectMs How long the connection took, in milliseconds.
+ * @return True if the hint was stored, false if the SSID is not saved or arguments are invalid.
+ */
+bool SettingsManager::updateWifiApHint(const std::string& ssid, const uint8_t* bssid, uint8_t channel,
+                                       int8_t rssi, uint32_t connectMs) {
+  if (!_isInitialized || ssid.empty() || !bssid || channel == 0) {
+      DEBUG_WARN_PRINTLN("SettingsManager: Not initialized or invalid arguments, cannot update Wi-Fi AP hint.");
+      return false;
+  }
+  if (!findSavedNetwork(ssid)) {
+      DEBUG_TRACE_PRINTF("SettingsManager: '%s' is not a saved network, AP hint not stored.\n", ssid.c_str());
+      return false;
+  }
+
+  WifiApHint* hint = nullptr;
+  for (auto& h : _wifiApHints) {
+    if (h.ssid == ssid) {
+      hint = &h;
+      break;
+    }
+  }
+  if (!hint) {
+    _wifiApHints.push_back(WifiApHint(ssid));
+    hint = &_wifiApHints.back();
+  }
+
+  bool apChanged = (hint->channel != channel) || (memcmp(hint->bssid, bssid, 6) != 0);
+  memcpy(hint->bssid, bssid, 6);
+  hint->channel = channel;
+  hint->lastConnectMs = connectMs;
+  hint->rssiHistory[hint->rssiHead] = rssi;
+  hint->rssiHead = (hint->rssiHead + 1) % WIFI_AP_HINT_RSSI_HISTORY;
+  if (hint->rssiCount < WIFI_AP_HINT_RSSI_HISTORY) hint->rssiCount++;
+
+  DEBUG_INFO_PRINTF("SettingsManager: AP hint for '%s' updated (ch %u, RSSI %d, %lu ms).\n",
+                    ssid.c_str(), channel, rssi, (unsigned long)connectMs);
+
+  // Persist when the AP moved, or once per full RSSI history cycle to limit flash writes.
+  if (apChanged || hint->rssiHead == 0) {
+    return saveSettingsToFile();
+  }
+  return true;
+}
+
+/**
+ * @brief Invalidates the cached BSSID/channel for a network (e.g. after a failed directed connect).
+ * @param ssid The SSID whose hint should be invalidated.
+ */
+void SettingsManager::invalidateWifiApHint(const std::string& ssid) {
+  for (auto& hint : _wifiApHints) {
+    if (hint.ssid == ssid && hint.isValid()) {
+      hint.channel = 0;
+      DEBUG_INFO_PRINTF("SettingsManager: AP hint for '%s' invalidated.\n", ssid.c_str());
+      saveSettingsToFile();
+      return;
+    }
+  }
+}
 
 // --- Wi-Fi Module State Getters/Setters ---
 /**
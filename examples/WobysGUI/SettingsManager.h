@@ -41,6 +41,7 @@
 #include <string>       // Required for `std::string`
 #include <LittleFS.h>   // Required for LittleFS filesystem operations
 #include <ArduinoJson.h> // Required for JSON serialization/deserialization
+#include "Config.h"     // Required for `WIFI_AP_HINT_RSSI_HISTORY`
 
 // --- Data Structures for Stored Settings ---
 /**
@@ -64,6 +65,47 @@ struct SavedWifiNetwork {
     : ssid(s), password(p) {}
 };
 
+/**
+ * @brief Structure to cache the last access point used for a saved Wi-Fi network.
+ *
+ * Kept separately from `SavedWifiNetwork` because that structure is shared with the
+ * precompiled `WifiManager` and its layout must not change. The cached BSSID and channel
+ * allow a directed, single-channel reconnect without a preceding full scan.
+ */
+struct WifiApHint {
+  std::string ssid;                               ///< The SSID this hint belongs to.
+  uint8_t bssid[6];                               ///< MAC address of the last access point used.
+  uint8_t channel;                                ///< Primary channel of that access point.
+  int8_t rssiHistory[WIFI_AP_HINT_RSSI_HISTORY];  ///< RSSI at the most recent connects (ring buffer).
+  uint8_t rssiCount;                              ///< Number of valid entries in `rssiHistory`.
+  uint8_t rssiHead;                               ///< Index where the next RSSI sample is written.
+  uint32_t lastConnectMs;                         ///< Duration of the last successful connect in milliseconds.
+
+  /**
+   * @brief Constructor for `WifiApHint`.
+   * @param s The SSID (default: empty string).
+   */
+  WifiApHint(const std::string& s = "")
+    : ssid(s), bssid{0}, channel(0), rssiHistory{0}, rssiCount(0), rssiHead(0), lastConnectMs(0) {}
+
+  /**
+   * @brief Checks whether the hint holds a usable BSSID/channel pair.
+   * @return True if a directed connect can be attempted.
+   */
+  bool isValid() const { return channel != 0; }
+
+  /**
+   * @brief Calculates the average of the recorded RSSI samples.
+   * @return The average RSSI, or -127 if no samples exist.
+   */
+  int averageRssi() const {
+    if (rssiCount == 0) return -127;
+    int sum = 0;
+    for (uint8_t i = 0; i < rssiCount; ++i) sum += rssiHistory[i];
+    return sum / rssiCount;
+  }
+};
+
 /**
  * @brief Structure to store details of a paired Bluetooth Low Energy (BLE) device.
  */
@@ -127,6 +169,9 @@ private:
   // RFID Settings
   bool _rfidEnabled;                   ///< True if RFID functionality is enabled.
 
+  // Wi-Fi access point cache (appended last to keep the offsets of the members above stable)
+  std::vector<WifiApHint> _wifiApHints; ///< Last BSSID/channel/RSSI per saved network, used for fast reconnect.
+
   // --- Private Helper Methods ---
   /**
    * @brief Loads all application settings from the `/settings.json` file on LittleFS.
@@ -202,6 +247,33 @@ public:
    */
   bool clearAllSavedNetworks();
 
+  /**
+   * @brief Finds the cached access point hint for a saved network.
+   * @param ssid The SSID to look up.
+   * @return A `const pointer` to the `WifiApHint` if found, `nullptr` otherwise.
+   */
+  const WifiApHint* findWifiApHint(const std::string& ssid) const;
+
+  /**
+   * @brief Records the access point used for a successful connection.
+   * Only networks that are saved get a hint. The file is only rewritten when the BSSID or
+   * channel changed, or every few connects, to limit flash wear.
+   * @param ssid The SSID that was connected.
+   * @param bssid The 6-byte BSSID of the access point.
+   * @param channel The primary channel of the access point.
+   * @param rssi The RSSI at connect time.
+   * @param connectMs How long the connection took, in milliseconds.
+   * @return True if the hint was stored, false if the SSID is not saved or arguments are invalid.
+   */
+  bool updateWifiApHint(const std::string& ssid, const uint8_t* bssid, uint8_t channel,
+                        int8_t rssi, uint32_t connectMs);
+
+  /**
+   * @brief Invalidates the cached BSSID/channel for a network (e.g. after a failed directed connect).
+   * @param ssid The SSID whose hint should be invalidated.
+   */
+  void invalidateWifiApHint(const std::string& ssid);
+
   // --- Wi-Fi Module State Getters/Setters ---
   /**
    * @brief Sets the last known enabled/disabled state of the Wi-Fi module.
@@ -359,16 +359,6 @@ void SettingsUI::openPanel() {
     } else { // No pull-down status bar panel exists
         proceedToOpenPanel();
     }
-
-    UILayer* settingsLayer = _screenManager->getLayer("settings_layer");
-    if (settingsLayer) { // Null pointer check
-        settingsLayer->setOnLoopCallback([this]() {
-            this->_settingsLoop();
-        });
-    } else {
-        DEBUG_ERROR_PRINTLN("SettingsUI: Failed to get 'settings_layer' for loop callback.");
-    }
-    _settingsLoop(); // Initial call to update immediately upon opening
 }
 
 /**
@@ -385,6 +375,11 @@ void SettingsUI::proceedToOpenPanel() {
 
     _screenManager->pushLayer("settings_layer");
     _loadAndApplySettings(); // Load and apply settings to UI elements
+
+    // Dynamic labels are refreshed from the system timer wheel while the layer is open.
+    // Started here rather than in openPanel() so a deferred open does not refresh a hidden layer.
+    g_timerWheel.start(_refreshTimer, UPDATE_INTERVAL_MS, UPDATE_INTERVAL_MS);
+    _settingsLoop(); // Initial call to update immediately upon opening
 }
 
 /**
@@ -510,13 +505,8 @@ void SettingsUI::_onBackButtonPressed() {
         DEBUG_ERROR_PRINTLN("SettingsUI: ScreenManager pointer is null. Cannot handle back button.");
         return;
     }
-    UILayer* settingsLayer = _screenManager->getLayer("settings_layer");
-    if (settingsLayer) { // Null pointer check
-        settingsLayer->setOnLoopCallback(nullptr); // Deregister the loop callback
-        DEBUG_INFO_PRINTLN("SettingsUI: _onBackButtonPressed() - Settings layer loop callback unregistered.");
-    } else {
-        DEBUG_WARN_PRINTLN("SettingsUI: Settings layer not found when unregistering loop callback.");
-    }
+    g_timerWheel.cancel(_refreshTimer); // Stop the periodic refresh of the dynamic labels
+    DEBUG_INFO_PRINTLN("SettingsUI: _onBackButtonPressed() - Settings refresh timer cancelled.");
     _screenManager->popLayer();
 }
 
@@ -760,22 +750,30 @@ void SettingsUI::_populateLanguageList() {
 }
 
 /**
- * @brief Loop callback for the settings UI layer.
- * This method is called periodically when the settings layer is active.
+ * @brief Periodic update for the settings UI layer.
+ * This method is called every `UPDATE_INTERVAL_MS` from `_refreshTimer` while the settings layer is active.
  * It's used for dynamic updates, such as battery voltage display.
+ * Cancels `_refreshTimer` once the settings layer is no longer on top, however it was left.
  */
 void SettingsUI::_settingsLoop() {
+    // The layer can also be left without the back button (switchToLayer(), a popLayer() issued by
+    // another controller). Stop refreshing as soon as the settings layer is no longer on top.
+    if (!_screenManager || _screenManager->getTopLayerName() != "settings_layer") {
+        g_timerWheel.cancel(_refreshTimer);
+        DEBUG_INFO_PRINTLN("SettingsUI: Settings layer left, refresh timer cancelled.");
+        return;
+    }
+
     // This is where dynamic updates can happen when the SettingsUI layer is ACTIVE
     // For example, updating battery voltage.
 
     // Update battery voltage (originally from _onBatteryVoltageUpdate method)
-    if (_powerManager && (millis() - _lastUpdateMillis >= UPDATE_INTERVAL_MS)) { // Null pointer check and interval check
+    if (_powerManager) { // Null pointer check
         float newVoltage = _powerManager->getCurrentVoltage(); // Get voltage
         char buffer[20];
         snprintf(buffer, sizeof(buffer), "%.2fV", newVoltage);
         _batteryVoltageLabel.setText(buffer); // Update the UI element
         // DEBUG_TRACE_PRINTF("SettingsUI: _settingsLoop - Battery voltage updated: %.2fV\n", newVoltage);
-        _lastUpdateMillis = millis(); // Update last update time
     }
     // Other periodic updates can be added here, e.g., WiFi/BLE status query if relevant in SettingsUI.
 }
\ No newline at end of file
@@ -46,6 +46,7 @@
 #include "ScreenSaverManager.h"
 #include "StatusbarUI.h" 
 #include "AudioManager.h"
+#include "TimerWheel.h"
 
 // UI elements import
 #include "ButtonUI.h"
@@ -228,9 +229,10 @@ private:
     void _onVolumeChanged(float value, bool isFinalChange);
 
     /**
-     * @brief Loop callback for the settings UI layer.
-     * This method is called periodically when the settings layer is active.
+     * @brief Periodic update for the settings UI layer.
+     * This method is called every `UPDATE_INTERVAL_MS` from `_refreshTimer` while the settings layer is active.
      * It's used for dynamic updates, such as battery voltage display.
+     * Cancels `_refreshTimer` once the settings layer is no longer on top, however it was left.
      */
     void _settingsLoop();
 
@@ -247,7 +249,7 @@ private:
     void _populateLanguageList();
 
     // --- Private Members for Periodic Updates ---
-    unsigned long _lastUpdateMillis = 0; ///< Stores the last time an update occurred in _settingsLoop.
+    TimerWheel::Timer _refreshTimer{[this]() { _settingsLoop(); }}; ///< Runs _settingsLoop on `g_timerWheel` while the layer is open.
     const unsigned long UPDATE_INTERVAL_MS = 1000; ///< Interval for periodic updates in milliseconds.
 };
 
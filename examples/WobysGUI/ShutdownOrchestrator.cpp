@@ -0,0 +1,219 @@
+/**
+ * @file ShutdownOrchestrator.cpp
+ * @brief Implements the ShutdownOrchestrator class.
+ *
+ * @version 1.0.0
+ * @date 2025-09-04
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "ShutdownOrchestrator.h"
+#include <string.h>
+
+/**
+ * @brief Constructor for ShutdownOrchestrator.
+ */
+ShutdownOrchestrator::ShutdownOrchestrator()
+  : _count(0),
+    _running(false),
+    _hasRun(false),
+    _runStartUs(0),
+    _runDurationUs(0) {
+  DEBUG_INFO_PRINTLN("ShutdownOrchestrator: Constructor called.");
+}
+
+/**
+ * @brief Registers a shutdown step.
+ * @param name Step name.
+ * @param handler The step handler.
+ * @param dependsOn Names of the steps that must be finished before this one starts.
+ * @param deadlineMs Deadline of the handler, or NO_DEADLINE to always wait for it.
+ * @return True if registered, false if the table is full or a dependency is unknown.
+ */
+bool ShutdownOrchestrator::addStep(const char* name, Handler handler, std::initializer_list<const char*> dependsOn,
+                                   uint32_t deadlineMs) {
+  if (_hasRun) {
+    DEBUG_WARN_PRINTF("ShutdownOrchestrator: Step '%s' added after the shutdown started, ignored.\n", name);
+    return false;
+  }
+  if (_count >= SHUTDOWN_MAX_STEPS) {
+    DEBUG_ERROR_PRINTF("ShutdownOrchestrator: Too many steps, '%s' not registered.\n", name);
+    return false;
+  }
+  if (_find(name) >= 0) {
+    DEBUG_ERROR_PRINTF("ShutdownOrchestrator: Step '%s' is already registered.\n", name);
+    return false;
+  }
+  if (dependsOn.size() > SHUTDOWN_MAX_DEPENDENCIES) {
+    DEBUG_ERROR_PRINTF("ShutdownOrchestrator: Step '%s' has too many dependencies.\n", name);
+    return false;
+  }
+
+  Step& step = _steps[_count];
+  step.dependencyCount = 0;
+  for (const char* dependency : dependsOn) {
+    const int index = _find(dependency);
+    if (index < 0) {
+      DEBUG_ERROR_PRINTF("ShutdownOrchestrator: Step '%s' depends on unknown step '%s'.\n", name, dependency);
+      return false;
+    }
+    step.dependencies[step.dependencyCount++] = static_cast<uint8_t>(index);
+  }
+  step.name = name;
+  step.handler = std::move(handler);
+  step.deadlineMs = deadlineMs;
+  _count++;
+
+  DEBUG_INFO_PRINTF("ShutdownOrchestrator: Step '%s' registered (%u dependencies, deadline %ums).\n",
+                    name, (unsigned)step.dependencyCount, (unsigned)deadlineMs);
+  return true;
+}
+
+/**
+ * @brief Runs every step and finishes when all of them are done or timed out.
+ * @return The coroutine to await.
+ */
+CoTask ShutdownOrchestrator::run() {
+  if (_hasRun) {
+    DEBUG_WARN_PRINTLN("ShutdownOrchestrator: run() called more than once, ignored.");
+    co_return;
+  }
+  _hasRun = true;
+  _running = true;
+  _runStartUs = micros();
+  DEBUG_INFO_PRINTF("ShutdownOrchestrator: Running %u shutdown steps...\n", (unsigned)_count);
+
+  // Every step starts right away and waits for its own dependencies.
+  for (size_t i = 0; i < _count; ++i) {
+    if (!g_coScheduler.start(_runStep(_steps[i]))) {
+      _steps[i].result = StepResult::FAILED;
+      _steps[i].done.set();
+    }
+  }
+  for (size_t i = 0; i < _count; ++i) {
+    co_await _steps[i].done;
+  }
+
+  _runDurationUs = micros() - _runStartUs;
+  _running = false;
+  logReport();
+}
+
+/**
+ * @brief Returns the outcome of a step.
+ * @param name The step name.
+ * @return The step result, or FAILED if no such step is registered.
+ */
+ShutdownOrchestrator::StepResult ShutdownOrchestrator::getStepResult(const char* name) const {
+  const int index = _find(name);
+  return index >= 0 ? _steps[index].result : StepResult::FAILED;
+}
+
+/**
+ * @brief Prints the start offset, duration and outcome of every step.
+ */
+void ShutdownOrchestrator::logReport() const {
+  DEBUG_INFO_PRINTLN("ShutdownOrchestrator: step             start  duration  deadline  result");
+  for (size_t i = 0; i < _count; ++i) {
+    const Step& step = _steps[i];
+    DEBUG_INFO_PRINTF("ShutdownOrchestrator: %-16s %5ums %7ums %8ums  %s\n",
+                      step.name, (unsigned)(step.startUs / 1000), (unsigned)(step.durationUs / 1000),
+                      (unsigned)step.deadlineMs, _resultName(step.result));
+  }
+  DEBUG_INFO_PRINTF("ShutdownOrchestrator: All steps finished in %ums.\n", (unsigned)(_runDurationUs / 1000));
+}
+
+/**
+ * @brief Finds a step by name.
+ * @param name The step name.
+ * @return The step index, or -1 if not found.
+ */
+int ShutdownOrchestrator::_find(const char* name) const {
+  for (size_t i = 0; i < _count; ++i) {
+    if (strcmp(_steps[i].name, name) == 0) return static_cast<int>(i);
+  }
+  return -1;
+}
+
+/**
+ * @brief Waits for the dependencies of a step, then runs it under its deadline.
+ * A dependency that timed out or failed still releases its dependents.
+ * @param step The step.
+ * @return The coroutine.
+ */
+CoTask ShutdownOrchestrator::_runStep(Step& step) {
+  for (uint8_t i = 0; i < step.dependencyCount; ++i) {
+    co_await _steps[step.dependencies[i]].done;
+  }
+
+  const uint32_t startUs = micros();
+  step.startUs = startUs - _runStartUs;
+  DEBUG_TRACE_PRINTF("ShutdownOrchestrator: Step '%s' started.\n", step.name);
+
+  if (!step.handler || !g_coScheduler.start(_invokeHandler(step))) {
+    DEBUG_ERROR_PRINTF("ShutdownOrchestrator: Step '%s' could not be started.\n", step.name);
+    step.result = StepResult::FAILED;
+  } else {
+    // One wait for both cases keeps the frame small enough for the coroutine frame pool.
+    const bool finished = co_await step.handlerFinished.waitFor(
+      step.deadlineMs == NO_DEADLINE ? CoEvent::NO_TIMEOUT : step.deadlineMs);
+    step.result = finished ? StepResult::DONE : StepResult::TIMED_OUT;
+    if (!finished) {
+      DEBUG_WARN_PRINTF("ShutdownOrchestrator: Step '%s' missed its %ums deadline, continuing without it.\n",
+                        step.name, (unsigned)step.deadlineMs);
+    }
+  }
+
+  step.durationUs = micros() - startUs;
+  step.done.set();
+}
+
+/**
+ * @brief Runs the handler of a step and signals its completion.
+ * @param step The step.
+ * @return The coroutine.
+ */
+CoTask ShutdownOrchestrator::_invokeHandler(Step& step) {
+  CoTask handlerTask = step.handler();
+  if (handlerTask.isValid()) {
+    co_await std::move(handlerTask);
+  } else {
+    DEBUG_ERROR_PRINTF("ShutdownOrchestrator: Handler of step '%s' could not be allocated.\n", step.name);
+  }
+  step.handlerFinished.set();
+}
+
+/**
+ * @brief Returns a printable name for a step result.
+ * @param result The step result.
+ * @return The name.
+ */
+const char* ShutdownOrchestrator::_resultName(StepResult result) {
+  switch (result) {
+    case StepResult::PENDING: return "pending";
+    case StepResult::DONE: return "done";
+    case StepResult::TIMED_OUT: return "TIMED OUT";
+    case StepResult::FAILED: return "FAILED";
+  }
+  return "?";
+}
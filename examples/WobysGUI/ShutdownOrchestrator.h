@@ -0,0 +1,178 @@
+/**
+ * @file ShutdownOrchestrator.h
+ * @brief Defines the ShutdownOrchestrator class, which runs the shutdown steps of the subsystems
+ * as a dependency graph on the coroutine runtime.
+ *
+ * Every subsystem registers a named step with the steps it depends on. When the shutdown starts,
+ * each step waits only for its own dependencies, and a step is finished when its handler completes
+ * rather than after a fixed delay. The duration of every step is printed when the shutdown has
+ * completed.
+ *
+ * Handlers are coroutines on the main loop. A handler that never suspends (stopping a radio,
+ * flushing the settings) runs to completion as soon as its step starts, so such steps run one after
+ * the other and no deadline can cut them short; they are registered without one. Only a handler
+ * that suspends, such as one waiting for a worker task to exit, runs alongside other steps, and
+ * only there a deadline applies: a step that misses it is reported and no longer holds up its
+ * dependents.
+ *
+ * @version 1.0.0
+ * @date 2025-09-04
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef SHUTDOWN_ORCHESTRATOR_H
+#define SHUTDOWN_ORCHESTRATOR_H
+
+#include <Arduino.h>
+#include <functional>
+#include <initializer_list>
+
+#include "Config.h"
+#include "Coroutine.h"
+
+/**
+ * @brief Runs registered shutdown steps in dependency order; steps that suspend overlap.
+ *
+ * Steps are registered once (normally during setup) and run by awaiting `run()` from a coroutine.
+ * Main loop task only.
+ */
+class ShutdownOrchestrator {
+public:
+    /**
+     * @brief Step handler. The step is complete when the returned coroutine finishes.
+     * A synchronous step is a coroutine that simply does its work and returns; it blocks the main
+     * loop until it is done.
+     */
+    using Handler = std::function<CoTask()>;
+
+    static constexpr uint32_t NO_DEADLINE = 0; ///< Deadline value for steps that must always complete.
+
+    /**
+     * @brief Outcome of a step.
+     */
+    enum class StepResult : uint8_t {
+        PENDING,    ///< Not finished (or not run yet).
+        DONE,       ///< The handler completed.
+        TIMED_OUT,  ///< The deadline expired before the handler completed.
+        FAILED      ///< The handler could not be started.
+    };
+
+    /**
+     * @brief Constructor for ShutdownOrchestrator.
+     */
+    ShutdownOrchestrator();
+
+    /**
+     * @brief Registers a shutdown step.
+     * Dependencies must already be registered, so the steps always form an acyclic graph.
+     * @param name Step name (must outlive the orchestrator, normally a string literal).
+     * @param handler The step handler.
+     * @param dependsOn Names of the steps that must be finished before this one starts.
+     * @param deadlineMs Time the handler may take before its dependents go ahead without it,
+     *                   or NO_DEADLINE to always wait for it. Only a handler that suspends can be
+     *                   overtaken by its deadline.
+     * @return True if registered, false if the table is full or a dependency is unknown.
+     */
+    bool addStep(const char* name, Handler handler, std::initializer_list<const char*> dependsOn = {},
+                 uint32_t deadlineMs = NO_DEADLINE);
+
+    /**
+     * @brief Runs every step and finishes when all of them are done or timed out.
+     * Steps without a deadline are always waited for. Runs only once.
+     * @return The coroutine to await.
+     */
+    CoTask run();
+
+    /**
+     * @brief Checks whether the steps are running.
+     * @return True between the start and the end of `run()`.
+     */
+    bool isRunning() const { return _running; }
+
+    /**
+     * @brief Returns the outcome of a step.
+     * @param name The step name.
+     * @return The step result, or FAILED if no such step is registered.
+     */
+    StepResult getStepResult(const char* name) const;
+
+    /**
+     * @brief Prints the start offset, duration and outcome of every step.
+     */
+    void logReport() const;
+
+private:
+    /**
+     * @brief A registered shutdown step and its run state.
+     */
+    struct Step {
+        const char* name = nullptr;                     ///< Step name.
+        Handler handler;                                ///< Step handler.
+        uint8_t dependencies[SHUTDOWN_MAX_DEPENDENCIES];///< Indices of the steps this one waits for.
+        uint8_t dependencyCount = 0;                    ///< Number of dependencies.
+        uint32_t deadlineMs = 0;                        ///< Deadline of the handler, or NO_DEADLINE.
+        CoEvent handlerFinished;                        ///< Set when the handler has returned.
+        CoEvent done;                                   ///< Set when the step is finished or timed out.
+        uint32_t startUs = 0;                           ///< Start time relative to the start of `run()`.
+        uint32_t durationUs = 0;                        ///< Time until the step finished or timed out.
+        StepResult result = StepResult::PENDING;        ///< Outcome.
+    };
+
+    Step _steps[SHUTDOWN_MAX_STEPS];  ///< Registered steps, in registration order.
+    size_t _count;                    ///< Number of registered steps.
+    bool _running;                    ///< True while `run()` is in progress.
+    bool _hasRun;                     ///< True once `run()` has been started.
+    uint32_t _runStartUs;             ///< `micros()` at the start of `run()`.
+    uint32_t _runDurationUs;          ///< Total duration of `run()`.
+
+    /**
+     * @brief Finds a step by name.
+     * @param name The step name.
+     * @return The step index, or -1 if not found.
+     */
+    int _find(const char* name) const;
+
+    /**
+     * @brief Waits for the dependencies of a step, then runs it under its deadline.
+     * @param step The step.
+     * @return The coroutine.
+     */
+    CoTask _runStep(Step& step);
+
+    /**
+     * @brief Runs the handler of a step and signals its completion.
+     * @param step The step.
+     * @return The coroutine.
+     */
+    static CoTask _invokeHandler(Step& step);
+
+    /**
+     * @brief Returns a printable name for a step result.
+     * @param result The step result.
+     * @return The name.
+     */
+    static const char* _resultName(StepResult result);
+};
+
+#endif // SHUTDOWN_ORCHESTRATOR_H
@@ -0,0 +1,171 @@
+/**
+ * @file SsidIndex.h
+ * @brief Defines SsidIndex, a hash index from SSID to position in a vector of networks.
+ *
+ * Scan results arrive as one entry per BSSID and are matched against the saved networks
+ * by SSID. The index replaces the linear searches of those merges with an open-addressing
+ * table over the positions of an existing vector, so no SSID strings are copied.
+ *
+ * @version 1.0.0
+ * @date 2025-08-27
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef SSID_INDEX_H
+#define SSID_INDEX_H
+
+#include <Arduino.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Hash index over the `ssid` member of the elements of a vector.
+ *
+ * The index stores element positions, not strings, so it stays valid when the vector
+ * reallocates. Elements may only be appended (and announced with `add()`); after any other
+ * modification of the vector the index must be rebuilt with `rebuild()`.
+ *
+ * @tparam T Element type with a `std::string ssid` member (e.g. `WifiListItemData`, `SavedWifiNetwork`).
+ */
+template <typename T>
+class SsidIndex {
+public:
+  /**
+   * @brief Constructor. The index starts empty; call `rebuild()` to index existing elements.
+   * @param items The indexed vector (must outlive the index).
+   */
+  explicit SsidIndex(const std::vector<T>& items) : _items(items), _count(0) {}
+
+  /**
+   * @brief Removes all entries (e.g. after the vector was cleared).
+   */
+  void clear() {
+    _slots.clear();
+    _count = 0;
+  }
+
+  /**
+   * @brief Re-indexes the whole vector. For duplicate SSIDs the first element wins.
+   */
+  void rebuild() {
+    clear();
+    _resize(_items.size());
+    for (size_t i = 0; i < _items.size(); ++i) {
+      if (find(_items[i].ssid) < 0) _insert(_hash(_items[i].ssid), (int32_t)i);
+    }
+  }
+
+  /**
+   * @brief Indexes the element at `position` (normally the one just appended).
+   * @param position Position of the element in the vector.
+   */
+  void add(size_t position) {
+    if (position >= _items.size()) return;
+    if ((_count + 1) * 2 > _slots.size()) {
+      _resize(_count + 1); // Rehashes the entries indexed so far.
+    }
+    _insert(_hash(_items[position].ssid), (int32_t)position);
+  }
+
+  /**
+   * @brief Looks up an SSID.
+   * @param ssid The SSID to look up.
+   * @return Position of the element in the vector, or -1 if the SSID is not indexed.
+   */
+  int find(const std::string& ssid) const {
+    if (_slots.empty()) return -1;
+    const uint32_t hash = _hash(ssid);
+    const size_t mask = _slots.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+      const Slot& slot = _slots[i];
+      if (slot.position < 0) return -1;
+      if (slot.hash == hash && _items[slot.position].ssid == ssid) return slot.position;
+    }
+  }
+
+  /**
+   * @brief Returns the number of indexed SSIDs.
+   * @return The entry count.
+   */
+  size_t size() const { return _count; }
+
+private:
+  /**
+   * @brief One table slot (position -1 = empty).
+   */
+  struct Slot {
+    uint32_t hash;     ///< Full hash of the SSID, compared before the string.
+    int32_t position;  ///< Position of the element in the vector.
+  };
+
+  const std::vector<T>& _items;  ///< The indexed vector (not owned).
+  std::vector<Slot> _slots;      ///< Open-addressing table, power-of-two size, at most half full.
+  size_t _count;                 ///< Number of occupied slots.
+
+  /**
+   * @brief FNV-1a hash of an SSID.
+   * @param ssid The SSID.
+   * @return The 32-bit hash.
+   */
+  static uint32_t _hash(const std::string& ssid) {
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : ssid) {
+      hash = (hash ^ c) * 16777619u;
+    }
+    return hash;
+  }
+
+  /**
+   * @brief Inserts an entry with linear probing. The table must have a free slot.
+   * @param hash Hash of the SSID.
+   * @param position Position of the element in the vector.
+   */
+  void _insert(uint32_t hash, int32_t position) {
+    const size_t mask = _slots.size() - 1;
+    size_t i = hash & mask;
+    while (_slots[i].position >= 0) i = (i + 1) & mask;
+    _slots[i] = {hash, position};
+    _count++;
+  }
+
+  /**
+   * @brief Grows the table to hold at least `entries` entries at half load, keeping the current entries.
+   * @param entries The number of entries the table must hold.
+   */
+  void _resize(size_t entries) {
+    size_t capacity = 16;
+    while (capacity < entries * 2) capacity <<= 1;
+    if (capacity <= _slots.size()) return;
+
+    std::vector<Slot> old;
+    old.swap(_slots);
+    _slots.assign(capacity, Slot{0, -1});
+    _count = 0;
+    for (const Slot& slot : old) {
+      if (slot.position >= 0) _insert(slot.hash, slot.position);
+    }
+  }
+};
+
+#endif // SSID_INDEX_H
@@ -57,11 +57,25 @@
 #include "SettingsUI.h"
 #include "AudioManager.h"
 #include "SDManager.h"
+#include "WifiFastReconnect.h"
+#include "WifiEventBridge.h"
+#include "RadioScheduler.h"
+#include "BleNotifyPipeline.h"
+#include "WifiPowerPolicy.h"
+#include "RemoteUiMirror.h"
+#include "OtaUpdater.h"
+#include "TelemetryPublisher.h"
+#include "ManagerTaskHost.h"
+#include "LoopBudgetMonitor.h"
+#include "CpuFrequencyGovernor.h"
+#include "IdleSleepController.h"
+#include "DisplaySleepController.h"
 #include "GlobalSystemEvents.h" // Include the new global event header
 
 // Specific UI Elements used in setup (dynamically allocated)
 #include "TimeElement.h"
 #include "IconElement.h"
+#include "BatteryRuntimeElement.h"
 
 //=============================================================================
 // Global System Status (new)
@@ -84,7 +98,7 @@ extern void openWiFiSettingsPanel();
 extern void openBluetoothSettingsPanel();
 extern void openSettingsScreen();
 extern void handleShutdownWarning(const std::string& messageKey);
-extern void handlePerformShutdownTasks();
+extern void handlePerformShutdownTasks(std::function<void()> powerOff);
 extern void handleCardScanned(const RFIDCardData& cardData);
 
 
@@ -115,6 +129,19 @@ extern void handleCardScanned(const RFIDCardData& cardData);
  * @param sui Pointer to the SettingsUI instance.
  * @param am Pointer to the AudioManager instance.
  * @param sdm Pointer to the SDManager instance.
+ * @param wfr Pointer to the WifiFastReconnect instance.
+ * @param web Pointer to the WifiEventBridge instance.
+ * @param rs Pointer to the RadioScheduler instance.
+ * @param bnp Pointer to the BleNotifyPipeline instance.
+ * @param wpp Pointer to the WifiPowerPolicy instance.
+ * @param rum Pointer to the RemoteUiMirror instance.
+ * @param ota Pointer to the OtaUpdater instance.
+ * @param tlm Pointer to the TelemetryPublisher instance.
+ * @param mth Pointer to the ManagerTaskHost instance.
+ * @param lbm Pointer to the LoopBudgetMonitor instance.
+ * @param cfg Pointer to the CpuFrequencyGovernor instance.
+ * @param isc Pointer to the IdleSleepController instance.
+ * @param dsc Pointer to the DisplaySleepController instance.
  */
 SystemInitializer::SystemInitializer(
     LGFX* lcdRef, ScreenManager* sm, StatusbarUI* sb,
@@ -123,7 +150,12 @@ SystemInitializer::SystemInitializer(
     ScreenSaverManager* ssm, ClockLabelUI* ssc,
     BLEUI* bui, WifiUI* wui, MainUI* mui,
     LanguageManager* lm,
-    SettingsUI* sui, AudioManager* am, SDManager* sdm)
+    SettingsUI* sui, AudioManager* am, SDManager* sdm,
+    WifiFastReconnect* wfr, WifiEventBridge* web, RadioScheduler* rs,
+    BleNotifyPipeline* bnp, WifiPowerPolicy* wpp, RemoteUiMirror* rum,
+    OtaUpdater* ota, TelemetryPublisher* tlm, ManagerTaskHost* mth,
+    LoopBudgetMonitor* lbm, CpuFrequencyGovernor* cfg, IdleSleepController* isc,
+    DisplaySleepController* dsc)
     : _lcd(lcdRef), _screenManager(sm), _statusbar(sb),
       _settingsManager(settingsMgr), _wifiManager(wm), _timeManager(tm),
       _btManager(bm), _powerManager(pm), _rfidManager(rm),
@@ -132,10 +164,14 @@ SystemInitializer::SystemInitializer(
       _languageManager(lm),
       _settingsUI(sui),
       _audioManager(am), _sdManager(sdm),
+      _wifiFastReconnect(wfr), _wifiEventBridge(web), _radioScheduler(rs),
+      _bleNotifyPipeline(bnp), _wifiPowerPolicy(wpp), _remoteUiMirror(rum),
+      _otaUpdater(ota), _telemetryPublisher(tlm), _managerTaskHost(mth),
+      _loopBudgetMonitor(lbm), _cpuGovernor(cfg), _idleSleep(isc), _displaySleep(dsc),
       // Raw pointers (temporarily nullptr, will be assigned during _setupUIElements).
       _messageBoard(nullptr), _timeElement(nullptr), _rfidElement(nullptr),
       _speakerElement(nullptr), _btElement(nullptr), _wifiElement(nullptr), _sdElement(nullptr),
-      _batteryElement(nullptr),
+      _batteryElement(nullptr), _batteryRuntimeElement(nullptr),
       // `std::unique_ptr` members are default-initialized to `nullptr`.
       // Configuration structs are initialized here.
       _sdConfig({
@@ -147,6 +183,88 @@ SystemInitializer::SystemInitializer(
             .sampleRate = AUDIO_I2S_SAMPLE_RATE, .channels = AUDIO_I2S_CHANNELS,
             .initialVolume_0_100 = (uint8_t)AUDIO_DEFAULT_VOLUME_PERCENT,
             .initialEnabledState = true
+      }),
+      _wifiEventConfig({
+            .taskStackSize = WIFI_EVENT_TASK_STACK_SIZE, .taskPriority = WIFI_EVENT_TASK_PRIORITY,
+            .taskCore = WIFI_EVENT_TASK_CORE, .idlePollMs = WIFI_EVENT_IDLE_POLL_MS,
+            .eventQueueLength = WIFI_EVENT_QUEUE_LENGTH
+      }),
+      _radioConfig({
+            .slicePeriodMs = RADIO_COEX_SLICE_PERIOD_MS, .minSliceMs = RADIO_COEX_MIN_SLICE_MS,
+            .defaultDeadlineMs = RADIO_DEFAULT_DEADLINE_MS, .timelineCapacity = RADIO_TIMELINE_CAPACITY,
+            .applyCoexPreference = true
+      }),
+      _bleNotifyConfig({
+            .preferredMtu = BLE_NOTIFY_PREFERRED_MTU,
+            .connIntervalMin = BLE_NOTIFY_CONN_INTERVAL_MIN, .connIntervalMax = BLE_NOTIFY_CONN_INTERVAL_MAX,
+            .slaveLatency = BLE_NOTIFY_SLAVE_LATENCY, .supervisionTimeout = BLE_NOTIFY_SUPERVISION_TIMEOUT,
+            .deliveryIntervalMs = BLE_NOTIFY_DELIVERY_INTERVAL_MS,
+            .setupTaskStackSize = BLE_NOTIFY_SETUP_TASK_STACK_SIZE, .setupTaskPriority = BLE_NOTIFY_SETUP_TASK_PRIORITY,
+            .setupTaskCore = BLE_NOTIFY_SETUP_TASK_CORE
+      }),
+      _wifiPowerConfig({
+            .trafficHoldMs = WIFI_PS_TRAFFIC_HOLD_MS, .deepIdleAfterMs = WIFI_PS_DEEP_IDLE_AFTER_MS,
+            .minDwellMs = WIFI_PS_MIN_DWELL_MS, .batteryCheckIntervalMs = WIFI_PS_BATTERY_CHECK_INTERVAL_MS,
+            .lowBatteryVolts = WIFI_PS_LOW_BATTERY_VOLTS, .batteryHysteresisVolts = WIFI_PS_BATTERY_HYSTERESIS_VOLTS,
+            .currentNoneMa = WIFI_PS_CURRENT_NONE_MA, .currentMinModemMa = WIFI_PS_CURRENT_MIN_MODEM_MA,
+            .currentMaxModemMa = WIFI_PS_CURRENT_MAX_MODEM_MA
+      }),
+      _remoteUiConfig({
+            .accessToken = REMOTE_UI_ACCESS_TOKEN, .port = REMOTE_UI_PORT,
+            .frameIntervalMs = REMOTE_UI_FRAME_INTERVAL_MS,
+            .frameBufferBytes = REMOTE_UI_FRAME_BUFFER_BYTES, .minFrameBytes = REMOTE_UI_MIN_FRAME_BYTES,
+            .ackTimeoutMs = REMOTE_UI_ACK_TIMEOUT_MS,
+            .serverTaskStackSize = REMOTE_UI_SERVER_TASK_STACK_SIZE, .serverTaskPriority = REMOTE_UI_SERVER_TASK_PRIORITY,
+            .serverTaskCore = REMOTE_UI_SERVER_TASK_CORE
+      }),
+      _otaConfig({
+            .chunkBytes = OTA_CHUNK_BYTES,
+            .checkpointBytes = OTA_CHECKPOINT_BYTES, .httpTimeoutMs = OTA_HTTP_TIMEOUT_MS,
+            .progressIntervalMs = OTA_PROGRESS_INTERVAL_MS, .confirmAfterMs = OTA_CONFIRM_AFTER_MS,
+            .restartDelayMs = OTA_RESTART_DELAY_MS, .autoResume = OTA_AUTO_RESUME,
+            .manifestUrl = OTA_MANIFEST_URL, .checkIntervalMs = OTA_CHECK_INTERVAL_MS,
+            .taskStackSize = OTA_TASK_STACK_SIZE, .taskPriority = OTA_TASK_PRIORITY,
+            .taskCore = OTA_TASK_CORE
+      }),
+      _telemetryConfig({
+            .brokerUri = TELEMETRY_BROKER_URI, .username = TELEMETRY_USERNAME, .password = TELEMETRY_PASSWORD,
+            .topicPrefix = TELEMETRY_TOPIC_PREFIX, .sampleIntervalMs = TELEMETRY_SAMPLE_INTERVAL_MS,
+            .batchMaxSamples = TELEMETRY_BATCH_MAX_SAMPLES, .batchIntervalMs = TELEMETRY_BATCH_INTERVAL_MS,
+            .ringCapacity = TELEMETRY_RING_CAPACITY, .queueDir = TELEMETRY_QUEUE_DIR,
+            .maxQueuedBatches = TELEMETRY_MAX_QUEUED_BATCHES, .drainIntervalMs = TELEMETRY_DRAIN_INTERVAL_MS,
+            .ackTimeoutMs = TELEMETRY_ACK_TIMEOUT_MS, .serviceIntervalMs = TELEMETRY_SERVICE_INTERVAL_MS,
+            .taskStackSize = TELEMETRY_TASK_STACK_SIZE, .taskPriority = TELEMETRY_TASK_PRIORITY,
+            .taskCore = TELEMETRY_TASK_CORE
+      }),
+      _managerTaskConfig({
+            .powerOnTask = MANAGER_TASK_POWER_ON_TASK, .powerTaskStackSize = MANAGER_TASK_POWER_STACK_SIZE,
+            .powerTaskPriority = MANAGER_TASK_POWER_PRIORITY, .powerTaskCore = MANAGER_TASK_POWER_CORE,
+            .rfidOnTask = MANAGER_TASK_RFID_ON_TASK, .rfidTaskStackSize = MANAGER_TASK_RFID_STACK_SIZE,
+            .rfidTaskPriority = MANAGER_TASK_RFID_PRIORITY, .rfidTaskCore = MANAGER_TASK_RFID_CORE,
+            .mailboxLength = MANAGER_TASK_MAILBOX_LENGTH, .statsIntervalMs = MANAGER_TASK_STATS_INTERVAL_MS
+      }),
+      _loopBudgetConfig({
+            .defaultBudgetUs = LOOP_BUDGET_DEFAULT_US, .reportIntervalMs = LOOP_BUDGET_REPORT_INTERVAL_MS,
+            .overrunLogIntervalMs = LOOP_BUDGET_OVERRUN_LOG_INTERVAL_MS,
+            .escalateToTaskWdt = LOOP_BUDGET_ESCALATE_TO_TASK_WDT
+      }),
+      _cpuGovernorConfig({
+            .enabled = CPU_GOVERNOR_ENABLED, .maxFreqMhz = CPU_GOVERNOR_MAX_FREQ_MHZ,
+            .minFreqMhz = CPU_GOVERNOR_MIN_FREQ_MHZ, .touchHoldMs = CPU_GOVERNOR_TOUCH_HOLD_MS,
+            .renderHoldMs = CPU_GOVERNOR_RENDER_HOLD_MS, .renderBoostUs = CPU_GOVERNOR_RENDER_BOOST_US,
+            .frameMinUs = CPU_GOVERNOR_FRAME_MIN_US, .reportIntervalMs = CPU_GOVERNOR_REPORT_INTERVAL_MS
+      }),
+      _idleSleepConfig({
+            .enabled = IDLE_SLEEP_ENABLED, .lightSleep = IDLE_SLEEP_LIGHT_SLEEP,
+            .touchIntPin = TOUCH_INT_PIN, .rfidIrqPin = RFID_IRQ_PIN,
+            .backlightPwmChannel = BACKLIGHT_PWM_CHANNEL, .backlightPwmFreq = BACKLIGHT_PWM_FREQ,
+            .maxSleepMs = IDLE_SLEEP_MAX_MS, .minSleepMs = IDLE_SLEEP_MIN_MS, .minAwakeMs = IDLE_SLEEP_MIN_AWAKE_MS,
+            .settleMs = IDLE_SLEEP_SETTLE_MS, .wakeFrameBudgetUs = IDLE_SLEEP_WAKE_FRAME_BUDGET_US,
+            .reportIntervalMs = IDLE_SLEEP_REPORT_INTERVAL_MS
+      }),
+      _displaySleepConfig({
+            .enabled = DISPLAY_SLEEP_ENABLED, .timeoutMs = DISPLAY_SLEEP_TIMEOUT_MS,
+            .maxSleepMs = DISPLAY_SLEEP_MAX_WAIT_MS, .reportIntervalMs = DISPLAY_SLEEP_REPORT_INTERVAL_MS
       })
 {
     DEBUG_INFO_PRINTLN("SystemInitializer: Constructor called.");
@@ -437,12 +555,31 @@ bool SystemInitializer::_initManagers() {
             .battIconLevel0 = BATT_ICON_LEVEL_0, .battIconLevelUnknown = BATT_ICON_LEVEL_UNKNOWN,
             .battVoltageLevel6 = BATT_VOLTAGE_LEVEL_6, .battVoltageLevel5 = BATT_VOLTAGE_LEVEL_5,
             .battVoltageLevel4 = BATT_VOLTAGE_LEVEL_4, .battVoltageLevel3 = BATT_VOLTAGE_LEVEL_3,
-            .battVoltageLevel2 = BATT_VOLTAGE_LEVEL_2, .battVoltageLevel1 = BATT_VOLTAGE_LEVEL_1
+            .battVoltageLevel2 = BATT_VOLTAGE_LEVEL_2, .battVoltageLevel1 = BATT_VOLTAGE_LEVEL_1,
+            .iconHysteresisVolts = BATT_ICON_HYSTERESIS_VOLTS, .continuousAdc = BATTERY_ADC_CONTINUOUS_ENABLED,
+            .soc = {
+                .ocvTable = BATT_OCV_TABLE, .ocvTableSize = sizeof(BATT_OCV_TABLE) / sizeof(BATT_OCV_TABLE[0]),
+                .nominalCapacityMah = BATT_NOMINAL_CAPACITY_MAH, .internalResistanceOhm = BATT_INTERNAL_RESISTANCE_OHM,
+                .loadBaseMilliAmps = BATT_LOAD_BASE_MA, .loadBacklightMaxMilliAmps = BATT_LOAD_BACKLIGHT_MAX_MA,
+                .loadWifiMilliAmps = BATT_LOAD_WIFI_MA, .loadBluetoothMilliAmps = BATT_LOAD_BLUETOOTH_MA,
+                .loadAudioMilliAmps = BATT_LOAD_AUDIO_MA,
+                .chargeCurrentMilliAmps = BATT_CHARGE_CURRENT_MA, .chargeVoltage = BATT_CHARGE_VOLTAGE,
+                .chargeTerminationMilliAmps = BATT_CHARGE_TERMINATION_MA
+            }
         };
+        // The load estimate for the state of charge; the managers are read lazily, so their init order does not matter.
+        _powerManager->setLoadStateProvider([this]() {
+            BatteryLoadState load;
+            load.backlight = _lcd->getBrightness();
+            load.wifiEnabled = _wifiManager && _wifiManager->isWifiLogicEnabled();
+            load.bluetoothEnabled = _btManager && _btManager->isEnabled();
+            load.audioEnabled = _audioManager && _audioManager->isEnabled();
+            return load;
+        });
         // PowerManager init itself doesn't return bool, its state reflects later.
         _powerManager->init(pmConfig);
         _powerManager->setOnShutdownWarningCallback(handleShutdownWarning);
-        _powerManager->setOnPerformShutdownCallback(handlePerformShutdownTasks);
+        _powerManager->setOnPerformShutdownAsyncCallback(handlePerformShutdownTasks);
     } else {
         DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - PowerManager, LCD or SettingsManager pointer is nullptr. Skipping PowerManager initialization.");
         if (_messageBoard) { 
@@ -499,11 +636,31 @@ bool SystemInitializer::_initManagers() {
         bool autoConnectWifi = _settingsManager->isWifiAutoConnectEnabled(true);
 
         if (wasWifiEnabledInSettings) {
-            _wifiManager->enableWifi(autoConnectWifi);
+            // With a cached access point, skip the manager's scan-first auto-connect and
+            // reconnect directly on the known channel; the helper falls back to a scan on failure.
+            bool useFastReconnect = autoConnectWifi && _wifiFastReconnect && _wifiFastReconnect->hasCandidate();
+            _wifiManager->enableWifi(autoConnectWifi && !useFastReconnect);
+            if (useFastReconnect) {
+                _wifiFastReconnect->requestReconnect();
+            }
         } else {
             _wifiManager->disableWifi();
         }
         // No warning here if _wifiManager->isWifiLogicEnabled() is false, as it could be intentional.
+
+        // Move the manager onto its event-driven task. The bridge takes over the manager
+        // callbacks, so WifiUI must register on the bridge instead (see _setupUILayers()).
+        if (_wifiEventBridge) {
+            if (!_wifiEventBridge->init(_wifiEventConfig)) {
+                DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - WifiEventBridge task not started. WifiManager runs on the UI loop.");
+                if (_messageBoard) {
+                    std::string localizedMsg = _languageManager->getString("INIT_WIFI_EVENTS_FAILED", "Wi-Fi task failed!");
+                    _messageBoard->pushMessage(localizedMsg, 5000, UI_COLOR_WARNING);
+                }
+            }
+            if (_wifiUI) _wifiUI->setWifiEventBridge(_wifiEventBridge);
+            if (_btUI) _btUI->setWifiEventBridge(_wifiEventBridge);
+        }
     } else {
         DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - WifiManager, SettingsManager or BLEManager pointer is nullptr. Skipping WifiManager initialization.");
         if (_messageBoard) { 
@@ -556,6 +713,111 @@ bool SystemInitializer::_initManagers() {
         }
     }
 
+    // --- RadioScheduler (Not critical; without it both radios keep their built-in arbitration) ---
+    if (_radioScheduler && _wifiManager && _btManager) {
+        _radioScheduler->init(_radioConfig);
+        // The precompiled managers drive their own operations; report them so they occupy the
+        // radio in the schedule and take part in time-slicing.
+        WifiManager* wm = _wifiManager;
+        BLEManager* bm = _btManager;
+        _radioScheduler->addActivityProbe(RadioOwner::WIFI, RadioOpKind::SCAN, RadioPriority::NORMAL,
+            [wm]() { return wm->getCurrentState() == WifiMgr_State_t::SCANNING; });
+        _radioScheduler->addActivityProbe(RadioOwner::WIFI, RadioOpKind::CONNECT, RadioPriority::INTERACTIVE,
+            [wm]() { return wm->getCurrentState() == WifiMgr_State_t::CONNECTING; });
+        _radioScheduler->addActivityProbe(RadioOwner::WIFI, RadioOpKind::DATA, RadioPriority::BACKGROUND,
+            [wm]() { return wm->getCurrentState() == WifiMgr_State_t::CONNECTED; });
+        _radioScheduler->addActivityProbe(RadioOwner::BLE, RadioOpKind::SCAN, RadioPriority::NORMAL,
+            [bm]() { return bm->getCurrentState() == BLEMgr_State_t::BLE_SCANNING; });
+        _radioScheduler->addActivityProbe(RadioOwner::BLE, RadioOpKind::CONNECT, RadioPriority::INTERACTIVE,
+            [bm]() { return bm->getCurrentState() == BLEMgr_State_t::BLE_CONNECTING; });
+        _radioScheduler->addActivityProbe(RadioOwner::BLE, RadioOpKind::DATA, RadioPriority::BACKGROUND,
+            [bm]() { return bm->getCurrentState() == BLEMgr_State_t::BLE_CONNECTED; });
+        if (_wifiUI) _wifiUI->setRadioScheduler(_radioScheduler);
+        if (_btUI) _btUI->setRadioScheduler(_radioScheduler);
+    } else {
+        DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - RadioScheduler, WifiManager or BLEManager pointer is nullptr. Skipping RadioScheduler initialization.");
+    }
+
+    // --- BleNotifyPipeline (Not critical; only needed by components that stream GATT notifications) ---
+    if (_bleNotifyPipeline && _btManager) {
+        if (!_bleNotifyPipeline->init(_bleNotifyConfig)) {
+            DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - BleNotifyPipeline initialization failed.");
+            if (_messageBoard) {
+                std::string localizedMsg = _languageManager->getString("INIT_BLE_NOTIFY_FAILED", "BLE data pipeline failed!");
+                _messageBoard->pushMessage(localizedMsg, 5000, UI_COLOR_WARNING);
+            }
+        }
+    } else {
+        DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - BleNotifyPipeline or BLEManager pointer is nullptr. Skipping BleNotifyPipeline initialization.");
+    }
+
+    // --- WifiPowerPolicy (Not critical; without it the modem keeps the driver's default power save) ---
+    if (_wifiPowerPolicy && _wifiManager) {
+        if (!_wifiPowerPolicy->init(_wifiPowerConfig)) {
+            DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - WifiPowerPolicy initialization failed.");
+            if (_messageBoard) {
+                std::string localizedMsg = _languageManager->getString("INIT_WIFI_POWER_FAILED", "Wi-Fi power saving unavailable!");
+                _messageBoard->pushMessage(localizedMsg, 5000, UI_COLOR_WARNING);
+            }
+        }
+    } else {
+        DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - WifiPowerPolicy or WifiManager pointer is nullptr. Skipping WifiPowerPolicy initialization.");
+    }
+
+    // --- RemoteUiMirror (Not critical; the local display works without it) ---
+    if (_remoteUiMirror && _wifiManager) {
+        if (_wifiPowerPolicy) {
+            WifiPowerPolicy* wifiPowerPolicy = _wifiPowerPolicy;
+            // Keep the modem awake while frames are streaming.
+            _remoteUiMirror->setOnActivityCallback([wifiPowerPolicy]() { wifiPowerPolicy->noteTraffic(); });
+        }
+        if (!_remoteUiMirror->init(_remoteUiConfig)) {
+            DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - RemoteUiMirror initialization failed.");
+            if (_messageBoard) {
+                std::string localizedMsg = _languageManager->getString("INIT_REMOTE_UI_FAILED", "Remote UI unavailable!");
+                _messageBoard->pushMessage(localizedMsg, 5000, UI_COLOR_WARNING);
+            }
+        }
+    } else {
+        DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - RemoteUiMirror or WifiManager pointer is nullptr. Skipping RemoteUiMirror initialization.");
+    }
+
+    // --- OtaUpdater (Not critical; without it the running firmware is simply kept) ---
+    if (_otaUpdater && _wifiManager) {
+        _otaUpdater->setMessageBoard(_messageBoard);
+        if (_wifiPowerPolicy) {
+            WifiPowerPolicy* wifiPowerPolicy = _wifiPowerPolicy;
+            // Keep the modem awake while an image is downloading.
+            _otaUpdater->setOnActivityCallback([wifiPowerPolicy]() { wifiPowerPolicy->noteTraffic(); });
+        }
+        if (!_otaUpdater->init(_otaConfig)) {
+            DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - OtaUpdater initialization failed.");
+            if (_messageBoard) {
+                std::string localizedMsg = _languageManager->getString("INIT_OTA_FAILED", "Firmware updates unavailable!");
+                _messageBoard->pushMessage(localizedMsg, 5000, UI_COLOR_WARNING);
+            }
+        }
+    } else {
+        DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - OtaUpdater or WifiManager pointer is nullptr. Skipping OtaUpdater initialization.");
+    }
+
+    // --- TelemetryPublisher (Not critical; the device works without reporting) ---
+    if (_telemetryPublisher && _wifiManager) {
+        if (_wifiPowerPolicy) {
+            WifiPowerPolicy* wifiPowerPolicy = _wifiPowerPolicy;
+            _telemetryPublisher->setOnActivityCallback([wifiPowerPolicy]() { wifiPowerPolicy->noteTraffic(); });
+        }
+        if (!_telemetryPublisher->init(_telemetryConfig)) {
+            DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - TelemetryPublisher initialization failed.");
+            if (_messageBoard) {
+                std::string localizedMsg = _languageManager->getString("INIT_TELEMETRY_FAILED", "Telemetry unavailable!");
+                _messageBoard->pushMessage(localizedMsg, 5000, UI_COLOR_WARNING);
+            }
+        }
+    } else {
+        DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - TelemetryPublisher or WifiManager pointer is nullptr. Skipping TelemetryPublisher initialization.");
+    }
+
     // --- ScreenSaverManager Configuration (Not critical to halt the system) ---
     if (_screenSaverManager && _settingsManager && _screenSaverClock && _screenManager && _statusbar && _timeManager) {
         ScreenSaverManagerConfig screensaverConfig = {
@@ -639,6 +901,66 @@ bool SystemInitializer::_initManagers() {
         }
     }
 
+    // --- ManagerTaskHost (Not critical; managers fall back to the UI task) ---
+    // Must follow PowerManager and RFIDManager initialization.
+    if (_managerTaskHost) {
+        if (!_managerTaskHost->init(_managerTaskConfig)) {
+            DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - ManagerTaskHost could not start every task. Affected managers run on the UI task.");
+            if (_messageBoard) {
+                std::string localizedMsg = _languageManager->getString("INIT_MANAGER_TASKS_FAILED", "Peripheral tasks unavailable!");
+                _messageBoard->pushMessage(localizedMsg, 5000, UI_COLOR_WARNING);
+            }
+        }
+    } else {
+        DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - ManagerTaskHost pointer is nullptr. Skipping ManagerTaskHost initialization.");
+    }
+
+    // --- LoopBudgetMonitor (Diagnostics only) ---
+    if (_loopBudgetMonitor) {
+        _loopBudgetMonitor->init(_loopBudgetConfig);
+    } else {
+        DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - LoopBudgetMonitor pointer is nullptr. Skipping LoopBudgetMonitor initialization.");
+    }
+
+    // --- CpuFrequencyGovernor (Not critical, the CPU then keeps its full clock) ---
+    if (_cpuGovernor) {
+        if (!_cpuGovernor->init(_cpuGovernorConfig)) {
+            DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - CpuFrequencyGovernor initialization failed.");
+            if (_messageBoard) {
+                std::string localizedMsg = _languageManager->getString("INIT_CPU_GOVERNOR_FAILED", "CPU clock scaling unavailable!");
+                _messageBoard->pushMessage(localizedMsg, 5000, UI_COLOR_WARNING);
+            }
+        }
+    } else {
+        DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - CpuFrequencyGovernor pointer is nullptr. Skipping CpuFrequencyGovernor initialization.");
+    }
+
+    // --- IdleSleepController (Not critical, the main loop then keeps polling the touch controller) ---
+    if (_idleSleep) {
+        if (!_idleSleep->init(_idleSleepConfig)) {
+            DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - IdleSleepController initialization failed.");
+            if (_messageBoard) {
+                std::string localizedMsg = _languageManager->getString("INIT_IDLE_SLEEP_FAILED", "Idle sleep unavailable!");
+                _messageBoard->pushMessage(localizedMsg, 5000, UI_COLOR_WARNING);
+            }
+        }
+    } else {
+        DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - IdleSleepController pointer is nullptr. Skipping IdleSleepController initialization.");
+    }
+
+    // --- DisplaySleepController (Not critical, the screensaver then keeps the panel on) ---
+    if (_displaySleep) {
+        if (!_displaySleep->init(_displaySleepConfig)) {
+            DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - DisplaySleepController initialization failed.");
+            if (_messageBoard) {
+                std::string localizedMsg = _languageManager->getString("INIT_DISPLAY_SLEEP_FAILED", "Display sleep unavailable!");
+                _messageBoard->pushMessage(localizedMsg, 5000, UI_COLOR_WARNING);
+            }
+        }
+    } else {
+        DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - DisplaySleepController pointer is nullptr. Skipping DisplaySleepController initialization.");
+    }
+
     DEBUG_INFO_PRINTLN("SystemInitializer: All Managers Initialized.");
     return true; // All critical managers initialized successfully.
 }
@@ -781,15 +1103,30 @@ bool SystemInitializer::_setupUIElements() {
         _batteryElement->setStatusBarHeightRef(STATUSBAR_HEIGHT);
     }
 
+    // `BatteryRuntimeElement` (Optional, state of charge and remaining runtime next to the battery icon).
+    _batteryRuntimeElementUnique = std::make_unique<BatteryRuntimeElement>(_lcd, BATTERY_RUNTIME_ELEMENT_WIDTH, _powerManager);
+    if (!_batteryRuntimeElementUnique) {
+        DEBUG_WARN_PRINTLN("SystemInitializer: WARNING - Failed to allocate BatteryRuntimeElement! Out of memory. Skipping battery runtime display.");
+        // Use _messageBoard directly as g_displayLocalizedMessage is not yet defined.
+        if (_messageBoard && _languageManager) {
+            std::string localizedMsg = _languageManager->getString("INIT_BATTERY_RUNTIME_UI_ERROR", "Battery Runtime UI Init Error!");
+            _messageBoard->pushMessage(localizedMsg, 5000, UI_COLOR_WARNING);
+        }
+    } else {
+        _batteryRuntimeElement = _batteryRuntimeElementUnique.get(); // Assign raw pointer.
+        _batteryRuntimeElement->setStatusBarHeightRef(STATUSBAR_HEIGHT);
+    }
+
 
-    // --- Add Right-Aligned Elements to Statusbar (Visual Order: [SD Card] [RFID] [Speaker] [Bluetooth] [WiFi] [Battery]) ---
+    // --- Add Right-Aligned Elements to Statusbar (Visual Order: [SD Card] [RFID] [Speaker] [Bluetooth] [WiFi] [Runtime] [Battery]) ---
     // As `StatusbarUI::drawFixedElements()` iterates `_rightElements` in reverse (from rbegin() to rend()),
     // the visual order (left to right) will be the inverse of the addition order.
-    // Therefore, to achieve the visual order: [SD Card] [RFID] [Speaker] [Bluetooth] [WiFi] [Battery],
+    // Therefore, to achieve the visual order: [SD Card] [RFID] [Speaker] [Bluetooth] [WiFi] [Runtime] [Battery],
     // elements must be added in this order (first element is rightmost visually, last element is leftmost visually).
     
     // Visually Rightmost
     if (_batteryElement) _statusbar->addElement(_batteryElement, StatusbarUI::Alignment::RIGHT);
+    if (_batteryRuntimeElement) _statusbar->addElement(_batteryRuntimeElement, StatusbarUI::Alignment::RIGHT);
     if (_wifiElement) _statusbar->addElement(_wifiElement, StatusbarUI::Alignment::RIGHT);
     if (_btElement) _statusbar->addElement(_btElement, StatusbarUI::Alignment::RIGHT);
     if (_speakerElement) _statusbar->addElement(_speakerElement, StatusbarUI::Alignment::RIGHT);
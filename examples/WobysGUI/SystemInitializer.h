@@ -54,10 +54,24 @@ class WifiUI;
 class MainUI;
 class AudioManager;
 class SDManager;
+class WifiFastReconnect;
+class WifiEventBridge;
+class RadioScheduler;
+class BleNotifyPipeline;
+class WifiPowerPolicy;
+class RemoteUiMirror;
+class OtaUpdater;
+class TelemetryPublisher;
+class ManagerTaskHost;
+class LoopBudgetMonitor;
+class CpuFrequencyGovernor;
+class IdleSleepController;
+class DisplaySleepController;
 
 // Forward Declaration for statusbar elements (dynamically allocated and owned by SystemInitializer)
 class TimeElement;
 class IconElement;
+class BatteryRuntimeElement;
 
 
 //=============================================================================
@@ -68,6 +82,25 @@ class IconElement;
 // These structs are now defined globally for clarity and direct use in _initManagers.
 //=============================================================================
 
+/**
+ * @brief Battery model for the state of charge estimation of the PowerManager.
+ * Passed to BatterySocEstimator::init() as part of PowerManagerConfig.
+ */
+struct BatterySocConfig {
+    const uint16_t (*ocvTable)[2];      ///< OCV table rows {mV, percent}, descending voltage.
+    size_t ocvTableSize;                ///< Number of rows in the OCV table.
+    float nominalCapacityMah;           ///< Rated capacity, the starting point of the learned capacity.
+    float internalResistanceOhm;        ///< Resistance used to compensate the voltage sag under load.
+    float loadBaseMilliAmps;            ///< Current with the backlight off and the radios disabled.
+    float loadBacklightMaxMilliAmps;    ///< Additional current at full backlight.
+    float loadWifiMilliAmps;            ///< Average additional current with Wi-Fi enabled.
+    float loadBluetoothMilliAmps;       ///< Average additional current with Bluetooth enabled.
+    float loadAudioMilliAmps;           ///< Additional current with the audio amplifier enabled.
+    float chargeCurrentMilliAmps;       ///< Charger current in the constant-current phase, shared by the load and the cell.
+    float chargeVoltage;                ///< Charger voltage in the constant-voltage phase (Volts).
+    float chargeTerminationMilliAmps;   ///< Cell current at which the charger ends the charge.
+};
+
 /**
  * @brief Configuration parameters for the PowerManager.
  * These will be passed to PowerManager::init().
@@ -94,6 +127,9 @@ struct PowerManagerConfig {
     float battVoltageLevel3;            ///< Voltage threshold for battery level 3.
     float battVoltageLevel2;            ///< Voltage threshold for battery level 2.
     float battVoltageLevel1;            ///< Voltage threshold for battery level 1.
+    float iconHysteresisVolts;          ///< Margin beyond a level threshold before the battery icon changes.
+    bool continuousAdc;                 ///< Sample the battery with the continuous (DMA) ADC.
+    BatterySocConfig soc;               ///< Battery model for the state of charge estimation.
 };
 
 /**
@@ -171,6 +207,181 @@ struct SDManagerConfig {
     unsigned long checkIntervalMs;      ///< Interval in milliseconds for checking SD card presence.
 };
 
+/**
+ * @brief Configuration parameters for the WifiEventBridge (event-driven Wi-Fi manager task).
+ */
+struct WifiEventBridgeConfig {
+    uint32_t taskStackSize;             ///< Stack size of the Wi-Fi manager task in bytes.
+    UBaseType_t taskPriority;           ///< FreeRTOS priority of the Wi-Fi manager task.
+    BaseType_t taskCore;                ///< Core the Wi-Fi manager task is pinned to.
+    uint32_t idlePollMs;                ///< Manager tick interval when no driver event arrives.
+    uint32_t eventQueueLength;          ///< Depth of the driver event queue.
+};
+
+/**
+ * @brief Configuration parameters for the RadioScheduler (Wi-Fi/BLE coexistence).
+ */
+struct RadioSchedulerConfig {
+    uint32_t slicePeriodMs;             ///< Length of one time-slice period while both radios are busy.
+    uint32_t minSliceMs;                ///< Minimum share of a period for the lower-priority radio.
+    uint32_t defaultDeadlineMs;         ///< Start deadline for requests that do not specify one.
+    size_t timelineCapacity;            ///< Number of finished occupancy entries kept.
+    bool applyCoexPreference;           ///< True to apply the preference through the ESP32 coexistence API.
+};
+
+/**
+ * @brief Configuration parameters for the BleNotifyPipeline (GATT notification streaming).
+ */
+struct BleNotifyPipelineConfig {
+    uint16_t preferredMtu;              ///< ATT MTU requested after connecting.
+    uint16_t connIntervalMin;           ///< Requested minimum connection interval (1.25 ms units).
+    uint16_t connIntervalMax;           ///< Requested maximum connection interval (1.25 ms units).
+    uint16_t slaveLatency;              ///< Requested peripheral latency.
+    uint16_t supervisionTimeout;        ///< Requested supervision timeout (10 ms units).
+    uint32_t deliveryIntervalMs;        ///< Interval between batched deliveries to the UI task.
+    uint32_t setupTaskStackSize;        ///< Stack size of the subscription setup task in bytes.
+    UBaseType_t setupTaskPriority;      ///< FreeRTOS priority of the subscription setup task.
+    BaseType_t setupTaskCore;           ///< Core the subscription setup task is pinned to.
+};
+
+/**
+ * @brief Configuration parameters for the WifiPowerPolicy (modem power-save selection).
+ */
+struct WifiPowerPolicyConfig {
+    uint32_t trafficHoldMs;             ///< Time the modem stays awake after reported traffic.
+    uint32_t deepIdleAfterMs;           ///< Screensaver time after which max-modem power save is used.
+    uint32_t minDwellMs;                ///< Minimum time in a mode before switching to a more economical one.
+    uint32_t batteryCheckIntervalMs;    ///< Interval for re-evaluating the battery voltage.
+    float lowBatteryVolts;              ///< Voltage below which an unattended modem uses max-modem power save.
+    float batteryHysteresisVolts;       ///< Hysteresis for leaving the low-battery state.
+    float currentNoneMa;                ///< Nominal current without power save (statistics only).
+    float currentMinModemMa;            ///< Nominal current in min-modem power save (statistics only).
+    float currentMaxModemMa;            ///< Nominal current in max-modem power save (statistics only).
+};
+
+/**
+ * @brief Configuration parameters for the RemoteUiMirror (WebSocket screen streaming).
+ */
+struct RemoteUiMirrorConfig {
+    const char* accessToken;            ///< Token clients must present. Empty disables the remote UI.
+    uint16_t port;                      ///< TCP port of the server.
+    uint32_t frameIntervalMs;           ///< Minimum time between two frames.
+    size_t frameBufferBytes;            ///< Maximum size of one encoded frame.
+    size_t minFrameBytes;               ///< Lower bound of the throughput-based frame budget.
+    uint32_t ackTimeoutMs;              ///< Time after which unacknowledged frames are given up.
+    uint32_t serverTaskStackSize;       ///< Stack size for the server task.
+    UBaseType_t serverTaskPriority;     ///< FreeRTOS priority of the server task.
+    BaseType_t serverTaskCore;          ///< Core the server task is pinned to.
+};
+
+/**
+ * @brief Configuration parameters for the OtaUpdater (firmware updates).
+ */
+struct OtaUpdaterConfig {
+    uint32_t chunkBytes;                ///< Download/flash write chunk size.
+    uint32_t checkpointBytes;           ///< Download progress between two NVS checkpoints.
+    uint32_t httpTimeoutMs;             ///< Network timeout.
+    uint32_t progressIntervalMs;        ///< Minimum time between two progress messages.
+    uint32_t confirmAfterMs;            ///< Uptime before a new image is confirmed.
+    uint32_t restartDelayMs;            ///< Delay between installation and restart.
+    bool autoResume;                    ///< Resume an interrupted download once Wi-Fi is connected.
+    const char* manifestUrl;            ///< Update manifest URL. Empty disables automatic updates.
+    uint32_t checkIntervalMs;           ///< Interval of the manifest checks.
+    uint32_t taskStackSize;             ///< Stack size for the download task.
+    UBaseType_t taskPriority;           ///< FreeRTOS priority of the download task.
+    BaseType_t taskCore;                ///< Core the download task is pinned to.
+};
+
+/**
+ * @brief Configuration parameters for the TelemetryPublisher (MQTT telemetry with offline queue).
+ */
+struct TelemetryPublisherConfig {
+    const char* brokerUri;              ///< Broker URI. Empty disables telemetry.
+    const char* username;               ///< Broker user name (empty for none).
+    const char* password;               ///< Broker password (empty for none).
+    const char* topicPrefix;            ///< Topic prefix.
+    uint32_t sampleIntervalMs;          ///< Interval of the periodic samples.
+    uint16_t batchMaxSamples;           ///< Maximum number of samples in one batch.
+    uint32_t batchIntervalMs;           ///< Maximum age of the oldest sample before a batch is closed.
+    uint16_t ringCapacity;              ///< Samples buffered in RAM.
+    const char* queueDir;               ///< LittleFS directory of the offline queue.
+    uint16_t maxQueuedBatches;          ///< Offline queue limit.
+    uint32_t drainIntervalMs;           ///< Minimum time between two queued batches when draining.
+    uint32_t ackTimeoutMs;              ///< Time to wait for the broker's acknowledgement.
+    uint32_t serviceIntervalMs;         ///< Period of the publisher task.
+    uint32_t taskStackSize;             ///< Stack size for the publisher task.
+    UBaseType_t taskPriority;           ///< FreeRTOS priority of the publisher task.
+    BaseType_t taskCore;                ///< Core the publisher task is pinned to.
+};
+
+/**
+ * @brief Configuration parameters for the ManagerTaskHost (manager peripheral work on dedicated tasks).
+ */
+struct ManagerTaskHostConfig {
+    bool powerOnTask;                   ///< Sample the battery ADC on its own task.
+    uint32_t powerTaskStackSize;        ///< Stack size for the battery sampling task.
+    UBaseType_t powerTaskPriority;      ///< FreeRTOS priority of the battery sampling task.
+    BaseType_t powerTaskCore;           ///< Core the battery sampling task is pinned to.
+    bool rfidOnTask;                    ///< Poll the RFID reader on its own task.
+    uint32_t rfidTaskStackSize;         ///< Stack size for the RFID polling task.
+    UBaseType_t rfidTaskPriority;       ///< FreeRTOS priority of the RFID polling task.
+    BaseType_t rfidTaskCore;            ///< Core the RFID polling task is pinned to.
+    UBaseType_t mailboxLength;          ///< Pending results per manager.
+    uint32_t statsIntervalMs;           ///< Interval of the CPU usage report (0 disables it).
+};
+
+/**
+ * @brief Configuration parameters for the LoopBudgetMonitor (per-subsystem main loop timing).
+ */
+struct LoopBudgetMonitorConfig {
+    uint32_t defaultBudgetUs;           ///< Budget per subsystem tick unless the lap names its own.
+    uint32_t reportIntervalMs;          ///< Interval of the p50/p99/max report (0 disables it).
+    uint32_t overrunLogIntervalMs;      ///< Minimum time between two overrun diagnostics of one subsystem.
+    bool escalateToTaskWdt;             ///< Put the loop task under the task watchdog.
+};
+
+/**
+ * @brief Configuration parameters for the CpuFrequencyGovernor (CPU clock scaling).
+ */
+struct CpuFrequencyGovernorConfig {
+    bool enabled;                       ///< Scale the clock; if false the CPU keeps its boot clock.
+    uint32_t maxFreqMhz;                ///< Clock for touch interaction, animations and audio.
+    uint32_t minFreqMhz;                ///< Idle clock.
+    uint32_t touchHoldMs;               ///< Time the clock stays up after the last touch.
+    uint32_t renderHoldMs;              ///< Time the clock stays up after the last heavy frame.
+    uint32_t renderBoostUs;             ///< Render work (at full clock) from which a frame raises the clock.
+    uint32_t frameMinUs;                ///< Shorter render passes are left out of the frame statistics.
+    uint32_t reportIntervalMs;          ///< Interval of the residency / frame time report (0 disables it).
+};
+
+/**
+ * @brief Configuration parameters for the IdleSleepController (interrupt wait and light sleep while idle).
+ */
+struct IdleSleepConfig {
+    bool enabled;                       ///< Wait for interrupts while idle; if false the main loop keeps polling.
+    bool lightSleep;                    ///< Enter light sleep during the wait when the radios are off.
+    int touchIntPin;                    ///< Touch controller INT pin (active low).
+    int rfidIrqPin;                     ///< RFID reader IRQ pin (active low), or -1.
+    int backlightPwmChannel;            ///< LEDC channel of the backlight (kept running in light sleep).
+    uint32_t backlightPwmFreq;          ///< Backlight PWM frequency in Hz.
+    uint32_t maxSleepMs;                ///< Longest wait.
+    uint32_t minSleepMs;                ///< Shorter waits are not worth a light sleep.
+    uint32_t minAwakeMs;                ///< Time awake after a wake before sleeping again.
+    uint32_t settleMs;                  ///< Time the backlight must be unchanged before idling.
+    uint32_t wakeFrameBudgetUs;         ///< Wake-to-first-frame target.
+    uint32_t reportIntervalMs;          ///< Interval of the idle / wake latency report (0 disables it).
+};
+
+/**
+ * @brief Configuration parameters for the DisplaySleepController (backlight-off and panel sleep stage).
+ */
+struct DisplaySleepConfig {
+    bool enabled;                       ///< Put the panel to sleep; if false the screensaver keeps it on.
+    uint32_t timeoutMs;                 ///< Screensaver time without a touch before the panel sleeps.
+    uint32_t maxSleepMs;                ///< Longest idle wait while the panel sleeps.
+    uint32_t reportIntervalMs;          ///< Interval of the stage residency / wake latency report (0 disables it).
+};
+
 /**
  * @brief Defines the overall system status.
  * This enum tracks the general operational state of the embedded system,
@@ -214,6 +425,19 @@ public:
     ClockLabelUI*         _screenSaverClock;   ///< Pointer to the ClockLabelUI instance for the screensaver.
     AudioManager*         _audioManager;       ///< Pointer to the AudioManager instance.
     SDManager*            _sdManager;          ///< Pointer to the SDManager instance.
+    WifiFastReconnect*    _wifiFastReconnect;  ///< Pointer to the WifiFastReconnect helper (directed reconnect to cached AP).
+    WifiEventBridge*      _wifiEventBridge;    ///< Pointer to the WifiEventBridge (runs the WifiManager on its own task).
+    RadioScheduler*       _radioScheduler;     ///< Pointer to the RadioScheduler (shared Wi-Fi/BLE radio time-slicing).
+    BleNotifyPipeline*    _bleNotifyPipeline;  ///< Pointer to the BleNotifyPipeline (GATT notification streaming).
+    WifiPowerPolicy*      _wifiPowerPolicy;    ///< Pointer to the WifiPowerPolicy (modem power-save selection).
+    RemoteUiMirror*       _remoteUiMirror;     ///< Pointer to the RemoteUiMirror (WebSocket screen streaming).
+    OtaUpdater*           _otaUpdater;         ///< Pointer to the OtaUpdater (firmware updates).
+    TelemetryPublisher*   _telemetryPublisher; ///< Pointer to the TelemetryPublisher (MQTT telemetry).
+    ManagerTaskHost*      _managerTaskHost;    ///< Pointer to the ManagerTaskHost (peripheral work on dedicated tasks).
+    LoopBudgetMonitor*    _loopBudgetMonitor;  ///< Pointer to the LoopBudgetMonitor (main loop timing).
+    CpuFrequencyGovernor* _cpuGovernor;        ///< Pointer to the CpuFrequencyGovernor (CPU clock scaling).
+    IdleSleepController*  _idleSleep;          ///< Pointer to the IdleSleepController (idle wait and light sleep).
+    DisplaySleepController* _displaySleep;     ///< Pointer to the DisplaySleepController (panel sleep stage).
     
     //=========================================================================
     // Pointers to High-Level UI Controllers (Globally Instantiated, Not Owned by SystemInitializer)
@@ -236,6 +460,7 @@ public:
     std::unique_ptr<IconElement>          _wifiElementUnique;        ///< Dynamically allocated IconElement for Wi-Fi status.
     std::unique_ptr<IconElement>          _batteryElementUnique;     ///< Dynamically allocated IconElement for battery status.
     std::unique_ptr<IconElement>          _sdElementUnique;          ///< Dynamically allocated IconElement for SD card status.
+    std::unique_ptr<BatteryRuntimeElement> _batteryRuntimeElementUnique; ///< Dynamically allocated element for the state of charge and runtime.
 
     // Raw pointers to the owned elements (for passing to other classes that don't take ownership).
     MessageBoardElement*  _messageBoard;       ///< Raw pointer to the dynamically allocated MessageBoardElement.
@@ -246,6 +471,7 @@ public:
     IconElement*          _wifiElement;        ///< Raw pointer to the dynamically allocated Wi-Fi IconElement.
     IconElement*          _batteryElement;     ///< Raw pointer to the dynamically allocated Battery IconElement.
     IconElement*          _sdElement;          ///< Raw pointer to the dynamically allocated SD Card IconElement.
+    BatteryRuntimeElement* _batteryRuntimeElement; ///< Raw pointer to the dynamically allocated BatteryRuntimeElement.
 
     //=========================================================================
     // Configuration Structs for Managers (Owned by SystemInitializer, Passed by const ref to Managers)
@@ -253,6 +479,18 @@ public:
     //=========================================================================
     SDManagerConfig       _sdConfig;           ///< Configuration parameters for the SDManager.
     AudioManagerConfig    _audioConfig;        ///< Configuration parameters for the AudioManager.
+    WifiEventBridgeConfig _wifiEventConfig;    ///< Configuration parameters for the WifiEventBridge.
+    RadioSchedulerConfig  _radioConfig;        ///< Configuration parameters for the RadioScheduler.
+    BleNotifyPipelineConfig _bleNotifyConfig;  ///< Configuration parameters for the BleNotifyPipeline.
+    WifiPowerPolicyConfig _wifiPowerConfig;    ///< Configuration parameters for the WifiPowerPolicy.
+    RemoteUiMirrorConfig  _remoteUiConfig;     ///< Configuration parameters for the RemoteUiMirror.
+    OtaUpdaterConfig      _otaConfig;          ///< Configuration parameters for the OtaUpdater.
+    TelemetryPublisherConfig _telemetryConfig; ///< Configuration parameters for the TelemetryPublisher.
+    ManagerTaskHostConfig _managerTaskConfig;  ///< Configuration parameters for the ManagerTaskHost.
+    LoopBudgetMonitorConfig _loopBudgetConfig; ///< Configuration parameters for the LoopBudgetMonitor.
+    CpuFrequencyGovernorConfig _cpuGovernorConfig; ///< Configuration parameters for the CpuFrequencyGovernor.
+    IdleSleepConfig       _idleSleepConfig;    ///< Configuration parameters for the IdleSleepController.
+    DisplaySleepConfig    _displaySleepConfig; ///< Configuration parameters for the DisplaySleepController.
 
 
     /**
@@ -278,6 +516,19 @@ public:
      * @param sui Pointer to the SettingsUI instance.
      * @param am Pointer to the AudioManager instance.
      * @param sdm Pointer to the SDManager instance.
+     * @param wfr Pointer to the WifiFastReconnect instance.
+     * @param web Pointer to the WifiEventBridge instance.
+     * @param rs Pointer to the RadioScheduler instance.
+     * @param bnp Pointer to the BleNotifyPipeline instance.
+     * @param wpp Pointer to the WifiPowerPolicy instance.
+     * @param rum Pointer to the RemoteUiMirror instance.
+     * @param ota Pointer to the OtaUpdater instance.
+     * @param tlm Pointer to the TelemetryPublisher instance.
+     * @param mth Pointer to the ManagerTaskHost instance.
+     * @param lbm Pointer to the LoopBudgetMonitor instance.
+     * @param cfg Pointer to the CpuFrequencyGovernor instance.
+     * @param isc Pointer to the IdleSleepController instance.
+     * @param dsc Pointer to the DisplaySleepController instance.
      */
     SystemInitializer(
         LGFX* lcdRef, ScreenManager* sm, StatusbarUI* sb,
@@ -287,7 +538,13 @@ public:
         BLEUI* bui, WifiUI* wui, MainUI* mui,
         LanguageManager* lm,
         SettingsUI* sui, AudioManager* am,
-        SDManager* sdm);
+        SDManager* sdm, WifiFastReconnect* wfr,
+        WifiEventBridge* web, RadioScheduler* rs,
+        BleNotifyPipeline* bnp, WifiPowerPolicy* wpp,
+        RemoteUiMirror* rum, OtaUpdater* ota, TelemetryPublisher* tlm,
+        ManagerTaskHost* mth, LoopBudgetMonitor* lbm,
+        CpuFrequencyGovernor* cfg, IdleSleepController* isc,
+        DisplaySleepController* dsc);
 
     /**
      * @brief Destructor for SystemInitializer.
@@ -0,0 +1,503 @@
+/**
+ * @file TelemetryPublisher.cpp
+ * @brief Implements the TelemetryPublisher class, which reports device health over MQTT in batches.
+ *
+ * @version 1.0.0
+ * @date 2025-08-30
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "TelemetryPublisher.h"
+#include "SystemInitializer.h" // For TelemetryPublisherConfig
+#include "Config.h"            // For DEBUG_* macros
+#include "WifiManager.h"
+#include "PowerManager.h"
+
+#include <LittleFS.h>
+#include <esp_random.h>
+#include <esp_system.h>
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+
+namespace {
+constexpr uint8_t BATCH_VERSION = 1;
+constexpr size_t KIND_SLOTS = 8; // TelemetryKind values are 1..7.
+constexpr time_t MIN_VALID_EPOCH = 1600000000; // Earlier clocks were not set by NTP.
+
+void putU16(std::vector<uint8_t>& out, uint16_t v) {
+  out.push_back(v & 0xFF);
+  out.push_back(v >> 8);
+}
+
+void putU32(std::vector<uint8_t>& out, uint32_t v) {
+  putU16(out, v & 0xFFFF);
+  putU16(out, v >> 16);
+}
+
+void putVarint(std::vector<uint8_t>& out, uint32_t v) {
+  while (v >= 0x80) {
+    out.push_back((uint8_t)(v | 0x80));
+    v >>= 7;
+  }
+  out.push_back((uint8_t)v);
+}
+
+uint32_t zigzag(int32_t v) {
+  return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+uint32_t fnv1a(const std::string& text) {
+  uint32_t hash = 2166136261u;
+  for (unsigned char c : text) {
+    hash ^= c;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+}
+
+/**
+ * @brief Constructor for the TelemetryPublisher class.
+ * @param wifiManager Pointer to the WifiManager (connection state, RSSI).
+ * @param powerManager Pointer to the PowerManager (battery voltage).
+ */
+TelemetryPublisher::TelemetryPublisher(WifiManager* wifiManager, PowerManager* powerManager)
+  : _wifiManager(wifiManager),
+    _powerManager(powerManager),
+    _config(nullptr),
+    _enabled(false),
+    _ringHead(0),
+    _ringTail(0),
+    _ringMux(portMUX_INITIALIZER_UNLOCKED),
+    _samplesRecorded(0),
+    _samplesDropped(0),
+    _lastSampleMs(0),
+    _lastLoopUs(0),
+    _loopMaxUs(0),
+    _loopSumUs(0),
+    _loopCount(0),
+    _wifiConnected(false),
+    _activityPending(false),
+    _task(nullptr),
+    _stopRequested(false),
+    _taskRunning(false),
+    _mqtt(nullptr),
+    _mqttConnected(false),
+    _ackedMsgId(-1),
+    _bootId(0),
+    _inFlightMsgId(-1),
+    _inFlightQueued(false),
+    _inFlightSinceMs(0),
+    _lastDrainMs(0),
+    _queueHead(0),
+    _queueTail(0),
+    _batchesPublished(0),
+    _batchesDropped(0) {
+}
+
+/**
+ * @brief Destructor. Stops the publisher task and the MQTT client.
+ */
+TelemetryPublisher::~TelemetryPublisher() {
+  _stopRequested = true;
+  while (_taskRunning.load()) {
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+  if (_mqtt) {
+    esp_mqtt_client_stop(_mqtt);
+    esp_mqtt_client_destroy(_mqtt);
+    _mqtt = nullptr;
+  }
+}
+
+/**
+ * @brief Asks the publisher task to end after its current iteration.
+ */
+void TelemetryPublisher::stop() {
+  _stopRequested = true;
+}
+
+/**
+ * @brief Initializes the publisher: scans the on-flash queue and starts the publisher task.
+ * @param config Broker, sampling, batching and queue limits.
+ * @return True if the publisher is running or disabled by configuration (no broker URI).
+ */
+bool TelemetryPublisher::init(const TelemetryPublisherConfig& config) {
+  DEBUG_INFO_PRINTLN("TelemetryPublisher: init() starting...");
+  _config = &config;
+  if (!config.brokerUri || !config.brokerUri[0]) {
+    DEBUG_INFO_PRINTLN("TelemetryPublisher: No broker configured, telemetry disabled.");
+    return true;
+  }
+  if (!_wifiManager || config.batchMaxSamples == 0 || config.ringCapacity < config.batchMaxSamples) {
+    DEBUG_ERROR_PRINTLN("TelemetryPublisher: Invalid configuration or missing WifiManager. Initialization aborted.");
+    return false;
+  }
+
+  _ring.resize(config.ringCapacity);
+  _scratch.resize(config.batchMaxSamples);
+  _batch.reserve(17 + (size_t)config.batchMaxSamples * 11);
+  _bootId = esp_random();
+
+  char deviceId[13];
+  snprintf(deviceId, sizeof(deviceId), "%012llx", (unsigned long long)ESP.getEfuseMac());
+  _clientId = std::string("wobys-") + deviceId;
+  _topic = std::string(config.topicPrefix) + "/" + deviceId + "/telemetry";
+
+  // Find the queued batches left from earlier runs (LittleFS is mounted by the SettingsManager).
+  if (!LittleFS.exists(config.queueDir) && !LittleFS.mkdir(config.queueDir)) {
+    DEBUG_ERROR_PRINTF("TelemetryPublisher: Cannot create queue directory %s.\n", config.queueDir);
+    return false;
+  }
+  uint32_t minSeq = UINT32_MAX, maxSeq = 0;
+  bool any = false;
+  File dir = LittleFS.open(config.queueDir);
+  for (File entry = dir.openNextFile(); entry; entry = dir.openNextFile()) {
+    char* end = nullptr;
+    const uint32_t seq = strtoul(entry.name(), &end, 10);
+    if (end && strcmp(end, ".bin") == 0) {
+      minSeq = std::min(minSeq, seq);
+      maxSeq = std::max(maxSeq, seq);
+      any = true;
+    }
+  }
+  dir.close();
+  _queueHead = any ? minSeq : 0;
+  _queueTail = any ? maxSeq + 1 : 0;
+
+  _taskRunning = true;
+  BaseType_t rc = xTaskCreatePinnedToCore(
+    _taskFn,
+    "Telemetry",
+    config.taskStackSize,
+    this,
+    config.taskPriority,
+    &_task,
+    config.taskCore);
+  if (rc != pdPASS) {
+    _task = nullptr;
+    _taskRunning = false;
+    DEBUG_ERROR_PRINTLN("TelemetryPublisher: Failed to create publisher task.");
+    return false;
+  }
+
+  _enabled = true;
+  DEBUG_INFO_PRINTF("TelemetryPublisher: Initialized (topic %s, %u batches queued).\n",
+                    _topic.c_str(), (unsigned)getQueuedBatches());
+  return true;
+}
+
+/**
+ * @brief Takes the periodic samples and measures the loop period. Call from the main loop.
+ */
+void TelemetryPublisher::loop() {
+  if (!_enabled) return;
+
+  const uint32_t nowUs = micros();
+  if (_lastLoopUs) {
+    const uint32_t periodUs = nowUs - _lastLoopUs;
+    _loopMaxUs = std::max(_loopMaxUs, periodUs);
+    _loopSumUs += periodUs;
+    _loopCount++;
+  }
+  _lastLoopUs = nowUs;
+
+  _wifiConnected = (_wifiManager->getCurrentState() == WifiMgr_State_t::CONNECTED);
+  if (_activityPending.exchange(false) && _onActivity) _onActivity();
+
+  const unsigned long now = millis();
+  if (now - _lastSampleMs < _config->sampleIntervalMs) return;
+  _lastSampleMs = now;
+
+  if (_powerManager) _record(TelemetryKind::BATTERY_MV, (int32_t)lroundf(_powerManager->getCurrentVoltage() * 1000.0f));
+  if (_wifiConnected.load()) _record(TelemetryKind::WIFI_RSSI_DBM, _wifiManager->getRssi());
+  if (_loopCount) {
+    _record(TelemetryKind::UI_LOOP_MAX_US, (int32_t)_loopMaxUs);
+    _record(TelemetryKind::UI_LOOP_AVG_US, (int32_t)(_loopSumUs / _loopCount));
+    _loopMaxUs = 0;
+    _loopSumUs = 0;
+    _loopCount = 0;
+  }
+  _record(TelemetryKind::FREE_HEAP_KB, (int32_t)(esp_get_free_heap_size() / 1024));
+  _record(TelemetryKind::MIN_FREE_HEAP_KB, (int32_t)(esp_get_minimum_free_heap_size() / 1024));
+}
+
+/**
+ * @brief Records an RFID scan. Call from the UI task.
+ * @param uid The card UID as a string.
+ */
+void TelemetryPublisher::recordRfidScan(const std::string& uid) {
+  if (!_enabled) return;
+  _record(TelemetryKind::RFID_SCAN, (int32_t)fnv1a(uid));
+}
+
+/**
+ * @brief Appends a sample to the ring. Drops the oldest sample if the ring is full.
+ * @param kind Sample kind.
+ * @param value Sample value.
+ */
+void TelemetryPublisher::_record(TelemetryKind kind, int32_t value) {
+  const Sample sample = { (uint32_t)millis(), kind, value };
+  bool dropped = false;
+  portENTER_CRITICAL(&_ringMux);
+  if (_ringHead - _ringTail >= _ring.size()) {
+    _ringTail++;
+    dropped = true;
+  }
+  _ring[_ringHead % _ring.size()] = sample;
+  _ringHead++;
+  portEXIT_CRITICAL(&_ringMux);
+  _samplesRecorded++;
+  if (dropped) _samplesDropped++;
+}
+
+/**
+ * @brief Publisher task entry point.
+ * @param arg Pointer to the TelemetryPublisher instance.
+ */
+void TelemetryPublisher::_taskFn(void* arg) {
+  TelemetryPublisher* self = static_cast<TelemetryPublisher*>(arg);
+  while (!self->_stopRequested.load()) {
+    self->_service();
+    vTaskDelay(pdMS_TO_TICKS(self->_config->serviceIntervalMs));
+  }
+  self->_task = nullptr;
+  self->_taskRunning = false;
+  vTaskDelete(nullptr);
+}
+
+/**
+ * @brief One iteration of the publisher task: batch, publish, queue and drain.
+ */
+void TelemetryPublisher::_service() {
+  const unsigned long now = millis();
+
+  // The client is created on the first connection; afterwards it reconnects on its own.
+  if (!_mqtt && _wifiConnected.load()) {
+    esp_mqtt_client_config_t mqttConfig = {};
+    mqttConfig.broker.address.uri = _config->brokerUri;
+    mqttConfig.credentials.client_id = _clientId.c_str();
+    if (_config->username && _config->username[0]) mqttConfig.credentials.username = _config->username;
+    if (_config->password && _config->password[0]) mqttConfig.credentials.authentication.password = _config->password;
+    _mqtt = esp_mqtt_client_init(&mqttConfig);
+    if (_mqtt) {
+      esp_mqtt_client_register_event(_mqtt, MQTT_EVENT_ANY, _mqttEventHandler, this);
+      esp_mqtt_client_start(_mqtt);
+    } else {
+      DEBUG_WARN_PRINTLN("TelemetryPublisher: Failed to create MQTT client.");
+    }
+  }
+  const bool online = _wifiConnected.load() && _mqttConnected.load();
+
+  // Settle the batch in flight.
+  if (_inFlightMsgId >= 0) {
+    if (_ackedMsgId.load() == _inFlightMsgId) {
+      if (_inFlightQueued) _removeOldest();
+      _batchesPublished++;
+      _activityPending = true;
+      _inFlightMsgId = -1;
+    } else if (!online || now - _inFlightSinceMs >= _config->ackTimeoutMs) {
+      // Not acknowledged: a direct batch falls back to the queue, a queued one stays there.
+      if (!_inFlightQueued) _enqueue(_inFlight);
+      _inFlightMsgId = -1;
+    }
+  }
+
+  // Close a batch when it is full or its oldest sample is old enough.
+  uint32_t pending;
+  uint32_t oldestMs = 0;
+  portENTER_CRITICAL(&_ringMux);
+  pending = _ringHead - _ringTail;
+  if (pending) oldestMs = _ring[_ringTail % _ring.size()].uptimeMs;
+  portEXIT_CRITICAL(&_ringMux);
+  if (pending >= _config->batchMaxSamples || (pending && now - oldestMs >= _config->batchIntervalMs)) {
+    if (_encodeBatch()) {
+      const bool queueEmpty = (_queueTail.load() == _queueHead.load());
+      if (!(online && _inFlightMsgId < 0 && queueEmpty && _publish(_batch, false))) {
+        _enqueue(_batch); // Keeps the order: newer batches never overtake queued ones.
+      }
+    }
+  }
+
+  // Drain the queue, one acknowledged batch at a time.
+  if (online && _inFlightMsgId < 0 && _queueTail.load() != _queueHead.load() &&
+      now - _lastDrainMs >= _config->drainIntervalMs) {
+    _lastDrainMs = now;
+    std::vector<uint8_t> data;
+    if (!_readOldest(data)) {
+      DEBUG_WARN_PRINTLN("TelemetryPublisher: Unreadable queue entry discarded.");
+      _removeOldest();
+      _batchesDropped++;
+    } else {
+      _publish(data, true);
+    }
+  }
+}
+
+/**
+ * @brief Encodes up to `batchMaxSamples` samples from the ring into `_batch`.
+ * @return True if a batch was encoded.
+ */
+bool TelemetryPublisher::_encodeBatch() {
+  uint32_t count = 0;
+  portENTER_CRITICAL(&_ringMux);
+  count = std::min<uint32_t>(_ringHead - _ringTail, _config->batchMaxSamples);
+  for (uint32_t i = 0; i < count; ++i) {
+    _scratch[i] = _ring[(_ringTail + i) % _ring.size()];
+  }
+  _ringTail += count;
+  portEXIT_CRITICAL(&_ringMux);
+  if (!count) return false;
+
+  const uint32_t baseUptimeMs = _scratch[0].uptimeMs;
+  uint32_t baseEpoch = 0;
+  const time_t epoch = time(nullptr);
+  if (epoch >= MIN_VALID_EPOCH) {
+    baseEpoch = (uint32_t)(epoch - (time_t)((millis() - baseUptimeMs) / 1000));
+  }
+
+  _batch.clear();
+  _batch.push_back('T');
+  _batch.push_back('B');
+  _batch.push_back(BATCH_VERSION);
+  putU16(_batch, (uint16_t)count);
+  putU32(_batch, _bootId);
+  putU32(_batch, baseEpoch);
+  putU32(_batch, baseUptimeMs);
+
+  int32_t previous[KIND_SLOTS] = {0};
+  uint32_t previousMs = baseUptimeMs;
+  for (uint32_t i = 0; i < count; ++i) {
+    const Sample& sample = _scratch[i];
+    const size_t slot = (size_t)sample.kind % KIND_SLOTS;
+    _batch.push_back((uint8_t)sample.kind);
+    putVarint(_batch, sample.uptimeMs - previousMs);
+    putVarint(_batch, zigzag((int32_t)((uint32_t)sample.value - (uint32_t)previous[slot])));
+    previousMs = sample.uptimeMs;
+    previous[slot] = sample.value;
+  }
+  return true;
+}
+
+/**
+ * @brief Publishes a batch with QoS 1 and keeps it as the batch in flight.
+ * @param data Batch bytes.
+ * @param fromQueue True if the batch is the oldest queue file.
+ * @return True if the client accepted the publish.
+ */
+bool TelemetryPublisher::_publish(const std::vector<uint8_t>& data, bool fromQueue) {
+  _ackedMsgId = -1;
+  const int msgId = esp_mqtt_client_publish(_mqtt, _topic.c_str(),
+                                            reinterpret_cast<const char*>(data.data()), (int)data.size(), 1, 0);
+  if (msgId < 0) return false;
+  if (!fromQueue) _inFlight = data;
+  _inFlightMsgId = msgId;
+  _inFlightQueued = fromQueue;
+  _inFlightSinceMs = millis();
+  return true;
+}
+
+/**
+ * @brief Appends a batch to the on-flash queue, discarding the oldest batch if it is full.
+ * @param data Batch bytes.
+ */
+void TelemetryPublisher::_enqueue(const std::vector<uint8_t>& data) {
+  if (_queueTail.load() - _queueHead.load() >= _config->maxQueuedBatches) {
+    if (_inFlightMsgId >= 0 && _inFlightQueued) {
+      _batchesDropped++; // The oldest file is in flight; drop the new batch instead.
+      return;
+    }
+    _removeOldest();
+    _batchesDropped++;
+  }
+  const uint32_t seq = _queueTail.load();
+  File file = LittleFS.open(_queuePath(seq).c_str(), "w");
+  if (!file || file.write(data.data(), data.size()) != data.size()) {
+    if (file) file.close();
+    LittleFS.remove(_queuePath(seq).c_str());
+    _batchesDropped++;
+    DEBUG_WARN_PRINTLN("TelemetryPublisher: Failed to queue batch (filesystem full?).");
+    return;
+  }
+  file.close();
+  _queueTail = seq + 1;
+}
+
+/**
+ * @brief Reads the oldest queued batch.
+ * @param data Receives the batch bytes.
+ * @return True if a batch was read.
+ */
+bool TelemetryPublisher::_readOldest(std::vector<uint8_t>& data) {
+  File file = LittleFS.open(_queuePath(_queueHead.load()).c_str(), "r");
+  if (!file) return false;
+  data.resize(file.size());
+  const bool ok = !data.empty() && file.read(data.data(), data.size()) == data.size();
+  file.close();
+  return ok;
+}
+
+/**
+ * @brief Deletes the oldest queued batch.
+ */
+void TelemetryPublisher::_removeOldest() {
+  const uint32_t head = _queueHead.load();
+  if (head == _queueTail.load()) return;
+  LittleFS.remove(_queuePath(head).c_str());
+  _queueHead = head + 1;
+}
+
+/**
+ * @brief Builds the path of a queue file.
+ * @param seq Sequence number.
+ * @return The path.
+ */
+std::string TelemetryPublisher::_queuePath(uint32_t seq) const {
+  char name[16];
+  snprintf(name, sizeof(name), "/%08u.bin", (unsigned)seq);
+  return std::string(_config->queueDir) + name;
+}
+
+/**
+ * @brief MQTT event handler. Runs on the MQTT task.
+ */
+void TelemetryPublisher::_mqttEventHandler(void* handlerArgs, esp_event_base_t /*base*/, int32_t eventId, void* eventData) {
+  TelemetryPublisher* self = static_cast<TelemetryPublisher*>(handlerArgs);
+  esp_mqtt_event_handle_t event = static_cast<esp_mqtt_event_handle_t>(eventData);
+  switch ((esp_mqtt_event_id_t)eventId) {
+    case MQTT_EVENT_CONNECTED:
+      self->_mqttConnected = true;
+      DEBUG_INFO_PRINTLN("TelemetryPublisher: Connected to broker.");
+      break;
+    case MQTT_EVENT_DISCONNECTED:
+      self->_mqttConnected = false;
+      DEBUG_INFO_PRINTLN("TelemetryPublisher: Disconnected from broker.");
+      break;
+    case MQTT_EVENT_PUBLISHED:
+      self->_ackedMsgId = event->msg_id;
+      break;
+    default:
+      break;
+  }
+}
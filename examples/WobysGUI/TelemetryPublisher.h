@@ -0,0 +1,280 @@
+/**
+ * @file TelemetryPublisher.h
+ * @brief Defines the TelemetryPublisher class, which reports device health over MQTT in batches.
+ *
+ * Battery voltage, Wi-Fi RSSI, RFID scans and UI health (main loop period, free heap) are
+ * sampled on the UI task into a small in-memory ring. A background task packs them into
+ * delta/varint encoded batches and publishes them with QoS 1. While Wi-Fi or the broker is
+ * unavailable, batches go to a bounded queue on LittleFS and are drained one at a time once
+ * the connection is back, each waiting for the broker's acknowledgement.
+ *
+ * @version 1.0.0
+ * @date 2025-08-30
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef TELEMETRY_PUBLISHER_H
+#define TELEMETRY_PUBLISHER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <mqtt_client.h>
+
+// Forward declarations
+class WifiManager;
+class PowerManager;
+struct TelemetryPublisherConfig; // Defined in SystemInitializer.h
+
+/**
+ * @brief Kinds of telemetry samples. The numeric values are part of the batch format.
+ */
+enum class TelemetryKind : uint8_t {
+  BATTERY_MV = 1,        ///< Battery voltage in mV.
+  WIFI_RSSI_DBM = 2,     ///< RSSI of the connected network in dBm.
+  RFID_SCAN = 3,         ///< RFID card scanned; value is an FNV-1a hash of the UID.
+  UI_LOOP_MAX_US = 4,    ///< Longest main loop period since the previous sample.
+  UI_LOOP_AVG_US = 5,    ///< Average main loop period since the previous sample.
+  FREE_HEAP_KB = 6,      ///< Free heap.
+  MIN_FREE_HEAP_KB = 7   ///< Lowest free heap since boot.
+};
+
+/**
+ * @brief Samples device health and publishes it in batches, with store-and-forward.
+ *
+ * Batch format (little-endian), published to `<topicPrefix>/<device id>/telemetry`:
+ * - Header: "TB", version (1), sample count u16, boot id u32, base epoch seconds u32 (0 if the
+ *   clock was not set), base uptime ms u32 (17 bytes).
+ * - Per sample: kind u8, uptime delta to the previous sample (ms, unsigned LEB128), value delta to
+ *   the previous sample of the same kind (zigzag LEB128; the first of each kind is relative to 0).
+ *
+ * The UI task only copies samples into the ring (a short critical section); encoding, file I/O
+ * and network calls run on the publisher task. A batch holds at most `batchMaxSamples`, so the
+ * work per batch is bounded. With a local broker, `mosquitto_sub -t '<prefix>/+/telemetry' -v`
+ * shows the batches.
+ */
+class TelemetryPublisher {
+public:
+  /**
+   * @brief Constructor for the TelemetryPublisher class.
+   * @param wifiManager Pointer to the WifiManager (connection state, RSSI).
+   * @param powerManager Pointer to the PowerManager (battery voltage).
+   */
+  TelemetryPublisher(WifiManager* wifiManager, PowerManager* powerManager);
+
+  /**
+   * @brief Destructor. Stops the publisher task and the MQTT client.
+   */
+  ~TelemetryPublisher();
+
+  /**
+   * @brief Initializes the publisher: scans the on-flash queue and starts the publisher task.
+   * @param config Broker, sampling, batching and queue limits.
+   * @return True if the publisher is running or disabled by configuration (no broker URI).
+   */
+  bool init(const TelemetryPublisherConfig& config);
+
+  /**
+   * @brief Takes the periodic samples and measures the loop period. Call from the main loop.
+   */
+  void loop();
+
+  /**
+   * @brief Asks the publisher task to end after its current iteration. Does not wait; batches
+   * still in the ring stay unpublished.
+   */
+  void stop();
+
+  /**
+   * @brief Checks whether the publisher task has ended (or never ran).
+   * @return True once nothing writes to the on-flash queue any more.
+   */
+  bool isStopped() const { return !_taskRunning.load(); }
+
+  /**
+   * @brief Records an RFID scan. Call from the UI task.
+   * @param uid The card UID as a string.
+   */
+  void recordRfidScan(const std::string& uid);
+
+  /**
+   * @brief Sets a callback invoked from `loop()` after batches were published (network activity).
+   * @param callback The callback.
+   */
+  void setOnActivityCallback(std::function<void()> callback) { _onActivity = std::move(callback); }
+
+  /**
+   * @brief Returns the number of samples recorded since boot.
+   * @return Sample count.
+   */
+  uint32_t getSamplesRecorded() const { return _samplesRecorded; }
+
+  /**
+   * @brief Returns the number of samples lost because the ring was full.
+   * @return Sample count.
+   */
+  uint32_t getSamplesDropped() const { return _samplesDropped.load(); }
+
+  /**
+   * @brief Returns the number of batches acknowledged by the broker.
+   * @return Batch count.
+   */
+  uint32_t getBatchesPublished() const { return _batchesPublished.load(); }
+
+  /**
+   * @brief Returns the number of batches discarded because the queue was full.
+   * @return Batch count.
+   */
+  uint32_t getBatchesDropped() const { return _batchesDropped.load(); }
+
+  /**
+   * @brief Returns the number of batches waiting in the on-flash queue.
+   * @return Batch count.
+   */
+  uint32_t getQueuedBatches() const { return _queueTail.load() - _queueHead.load(); }
+
+private:
+  /**
+   * @brief A sample as stored in the ring.
+   */
+  struct Sample {
+    uint32_t uptimeMs;   ///< Time of the sample (millis()).
+    TelemetryKind kind;  ///< Kind of the sample.
+    int32_t value;       ///< Value of the sample.
+  };
+
+  WifiManager* _wifiManager;                 ///< Pointer to the WifiManager (not owned).
+  PowerManager* _powerManager;               ///< Pointer to the PowerManager (not owned).
+  const TelemetryPublisherConfig* _config;   ///< Pointer to the configuration (owned by SystemInitializer).
+  bool _enabled;                             ///< True once `init()` started the publisher.
+
+  // Sample ring (written by the UI task, read by the publisher task)
+  std::vector<Sample> _ring;                 ///< Fixed-capacity ring of samples.
+  uint32_t _ringHead;                        ///< Next write position (monotonic).
+  uint32_t _ringTail;                        ///< Next read position (monotonic).
+  portMUX_TYPE _ringMux;                     ///< Protects the ring indices.
+  uint32_t _samplesRecorded;                 ///< Samples recorded since boot.
+  std::atomic<uint32_t> _samplesDropped;     ///< Samples lost to a full ring.
+
+  // UI-task sampling state
+  unsigned long _lastSampleMs;               ///< Time of the last periodic sample.
+  uint32_t _lastLoopUs;                      ///< micros() at the previous loop() call.
+  uint32_t _loopMaxUs;                       ///< Longest loop period in the current window.
+  uint64_t _loopSumUs;                       ///< Sum of loop periods in the current window.
+  uint32_t _loopCount;                       ///< Number of loop periods in the current window.
+  std::atomic<bool> _wifiConnected;          ///< Wi-Fi state as seen by the UI task.
+  std::atomic<bool> _activityPending;        ///< A batch was published since the last activity callback.
+  std::function<void()> _onActivity;         ///< Called from `loop()` after publishing.
+
+  // Publisher task state
+  TaskHandle_t _task;                        ///< Publisher task.
+  std::atomic<bool> _stopRequested;          ///< Asks the publisher task to end.
+  std::atomic<bool> _taskRunning;            ///< True while the publisher task runs.
+  esp_mqtt_client_handle_t _mqtt;            ///< MQTT client, created on the first connection.
+  std::atomic<bool> _mqttConnected;          ///< Broker connection state (set by the MQTT task).
+  std::atomic<int> _ackedMsgId;              ///< Message id of the last acknowledged publish.
+  std::string _topic;                        ///< Telemetry topic.
+  std::string _clientId;                     ///< MQTT client id (device id).
+  uint32_t _bootId;                          ///< Random id of this boot (distinguishes uptime bases).
+  std::vector<Sample> _scratch;              ///< Samples taken out of the ring for one batch.
+  std::vector<uint8_t> _batch;               ///< Batch being encoded (publisher task).
+  std::vector<uint8_t> _inFlight;            ///< Batch awaiting acknowledgement.
+  int _inFlightMsgId;                        ///< Message id of the batch in flight, -1 if none.
+  bool _inFlightQueued;                      ///< True if the batch in flight is the oldest queue file.
+  unsigned long _inFlightSinceMs;            ///< Time the batch in flight was published.
+  unsigned long _lastDrainMs;                ///< Time of the last queue drain step.
+  std::atomic<uint32_t> _queueHead;          ///< Sequence number of the oldest queued batch.
+  std::atomic<uint32_t> _queueTail;          ///< Sequence number of the next batch to queue.
+  std::atomic<uint32_t> _batchesPublished;   ///< Batches acknowledged by the broker.
+  std::atomic<uint32_t> _batchesDropped;     ///< Batches discarded to bound the queue.
+
+  /**
+   * @brief Appends a sample to the ring. Drops the oldest sample if the ring is full.
+   * @param kind Sample kind.
+   * @param value Sample value.
+   */
+  void _record(TelemetryKind kind, int32_t value);
+
+  /**
+   * @brief Publisher task entry point.
+   * @param arg Pointer to the TelemetryPublisher instance.
+   */
+  static void _taskFn(void* arg);
+
+  /**
+   * @brief One iteration of the publisher task: batch, publish, queue and drain.
+   */
+  void _service();
+
+  /**
+   * @brief Encodes up to `batchMaxSamples` samples from the ring into `_batch`.
+   * @return True if a batch was encoded.
+   */
+  bool _encodeBatch();
+
+  /**
+   * @brief Publishes a batch with QoS 1 and keeps it as the batch in flight.
+   * @param data Batch bytes.
+   * @param fromQueue True if the batch is the oldest queue file.
+   * @return True if the client accepted the publish.
+   */
+  bool _publish(const std::vector<uint8_t>& data, bool fromQueue);
+
+  /**
+   * @brief Appends a batch to the on-flash queue, discarding the oldest batch if it is full.
+   * @param data Batch bytes.
+   */
+  void _enqueue(const std::vector<uint8_t>& data);
+
+  /**
+   * @brief Reads the oldest queued batch.
+   * @param data Receives the batch bytes.
+   * @return True if a batch was read.
+   */
+  bool _readOldest(std::vector<uint8_t>& data);
+
+  /**
+   * @brief Deletes the oldest queued batch.
+   */
+  void _removeOldest();
+
+  /**
+   * @brief Builds the path of a queue file.
+   * @param seq Sequence number.
+   * @return The path.
+   */
+  std::string _queuePath(uint32_t seq) const;
+
+  /**
+   * @brief MQTT event handler. Runs on the MQTT task.
+   */
+  static void _mqttEventHandler(void* handlerArgs, esp_event_base_t base, int32_t eventId, void* eventData);
+};
+
+#endif // TELEMETRY_PUBLISHER_H
@@ -56,7 +56,7 @@ TimeElement::TimeElement(LGFX* lcd, int32_t width, TimeManager* timeManager,
 void TimeElement::update() {
     if (!_timeManager) return; // Do nothing if TimeManager is not set.
 
-    std::string currentTime = _timeManager->getCurrentTimeString();
+    const std::string& currentTime = _timeManager->getCurrentTimeString();
     bool colonVisible = _timeManager->isColonVisible();
 
     // Check if the minute part of the time has changed (requiring full redraw).
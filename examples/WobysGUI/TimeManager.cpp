@@ -33,9 +33,16 @@
  * on these components, their copyrights, and the obligations required for compliance.
  */
 #include "TimeManager.h"
-#include <time.h>     // Required for `struct tm` and `getLocalTime()`
-#include <sys/time.h> // Required for `settimeofday()` or underlying time functions
-#include <Arduino.h>  // Required for `millis()`, `configTime()`
+#include <time.h>     // Required for `struct tm` and `localtime_r()`
+#include <sys/time.h> // Required for `gettimeofday()`
+#include <Arduino.h>  // Required for `configTime()`
+#include <esp_sntp.h> // Required for the SNTP sync notification and interval
+#include <esp_timer.h> // Required for `esp_timer_get_time()` (monotonic clock)
+#include <atomic>
+
+namespace {
+std::atomic<bool> s_timeSyncNotified(false); ///< Set by the SNTP callback, consumed by `loop()`.
+}
 
 // --- Constructor Implementation ---
 /**
@@ -55,10 +62,11 @@ TimeManager::TimeManager(WifiManager* wifiMgr,
     _daylightOffsetSec(daylightOffsetSec),
     _ntpServer(ntpServer),
     _syncState(UNSYNCED),          // Initial state is unsynchronized.
-    _lastSyncAttemptMs(0),
-    _lastDisplayMs(0),
-    _blink(false),                 // Colon initially not blinking.
-    _lastMinute(-1),               // Initialize with invalid minute to force first update.
+    _sntpStarted(false),
+    _baseEpochUs(0),
+    _baseMonotonicUs(0),
+    _lastEpochSec(-1),
+    _lastMinuteKey(-1),            // Invalid minute forces the first update.
     _cachedTimeString("--:--"),    // Initial cached time string.
     _cachedColonVisible(true)      // Colon visible by default for initial display.
 {
@@ -73,19 +81,17 @@ TimeManager::TimeManager(WifiManager* wifiMgr,
 void TimeManager::begin() {
   DEBUG_INFO_PRINTLN("TimeManager: Begin called. Resetting sync state.");
   _syncState = UNSYNCED;
-  _lastSyncAttemptMs = 0;
-  _lastDisplayMs = 0;
-  _blink = false;
-  _lastMinute = -1;
+  _lastEpochSec = -1;
+  _lastMinuteKey = -1;
   _cachedTimeString = "--:--";
   _cachedColonVisible = true;
 }
 
 /**
  * @brief Retrieves the currently cached formatted time string (e.g., "HH:MM").
- * @return The formatted time string.
+ * @return The formatted time string (valid until the next `loop()`).
  */
-std::string TimeManager::getCurrentTimeString() const {
+const std::string& TimeManager::getCurrentTimeString() const {
     return _cachedTimeString;
 }
 
@@ -97,72 +103,66 @@ bool TimeManager::isColonVisible() const {
     return _cachedColonVisible;
 }
 
+/**
+ * @brief SNTP time-sync notification callback. Runs on the lwIP task.
+ * Only raises a flag; the clock is rebased on the UI task in `loop()`.
+ * @param tv The time that was set.
+ */
+void TimeManager::_onTimeSynced(struct timeval* tv) {
+  (void)tv;
+  s_timeSyncNotified.store(true);
+}
+
 /**
  * @brief Main update method for the TimeManager.
  * This function should be called repeatedly in the Arduino `loop()` function.
- * It handles periodic NTP synchronization attempts and updates the cached time string
- * and colon visibility flag for efficient UI rendering.
+ * It starts SNTP once Wi-Fi is connected, applies completed synchronizations and updates
+ * the cached time string and colon visibility flag for efficient UI rendering. Never blocks.
  */
 void TimeManager::loop() {
-  unsigned long now = millis();
-
-  // 1) NTP Synchronization Logic.
-  // Attempt initial sync after a short delay, or resync periodically.
-  unsigned long sinceSync = now - _lastSyncAttemptMs;
-  if ((_syncState == UNSYNCED && sinceSync >= FIRST_RETRY_MS) || (_syncState == SYNCED && sinceSync >= RESYNC_INTERVAL_MS)) {
-    // Only attempt sync if Wi-Fi is connected.
-    if (_wifiMgr && _wifiMgr->getCurrentState() == WifiMgr_State_t::CONNECTED) {
-      DEBUG_INFO_PRINTLN("TimeManager: Attempting NTP synchronization...");
-      configTime(_gmtOffsetSec, _daylightOffsetSec, _ntpServer);
-      struct tm timeinfo;
-      // Wait up to 2 seconds for time to become available.
-      if (getLocalTime(&timeinfo, 2000)) {
-        _syncState = SYNCED;
-        _lastDisplayMs = now;
-        _blink = (timeinfo.tm_sec % 2 == 0); // Initialize blink state based on current second.
-        _lastMinute = timeinfo.tm_min;       // Store current minute for change detection.
-
-        // Immediately update cached time string and colon visibility after successful sync.
-        char buf[6]; // Sufficient for "HH:MM\0".
-        snprintf(buf, sizeof(buf), "%02d:%02d", timeinfo.tm_hour, timeinfo.tm_min);
-        _cachedTimeString = std::string(buf);
-        _cachedColonVisible = _blink;
-        DEBUG_INFO_PRINTF("TimeManager: NTP sync successful. Time: %s (Colon visible: %s).\n", _cachedTimeString.c_str(), _cachedColonVisible ? "true" : "false");
+  // 1) Start SNTP once Wi-Fi is connected. `configTime()` only configures the client; lwIP
+  //    then synchronizes in the background, retries on its own and resyncs every RESYNC_INTERVAL_MS.
+  if (!_sntpStarted && _wifiMgr && _wifiMgr->getCurrentState() == WifiMgr_State_t::CONNECTED) {
+    DEBUG_INFO_PRINTLN("TimeManager: Starting background NTP synchronization...");
+    sntp_set_time_sync_notification_cb(_onTimeSynced);
+    sntp_set_sync_interval(RESYNC_INTERVAL_MS);
+    configTime(_gmtOffsetSec, _daylightOffsetSec, _ntpServer);
+    _sntpStarted = true;
+  }
 
-      } else {
-        DEBUG_WARN_PRINTLN("TimeManager: NTP sync failed to get local time.");
-        // If sync fails, `_syncState` remains `UNSYNCED` if it was, or we try again if `SYNCED` and resync interval passes.
-      }
-      _lastSyncAttemptMs = now; // Record time of sync attempt.
-    } else if (_wifiMgr) {
-      DEBUG_TRACE_PRINTF("TimeManager: Wi-Fi not connected (State: %d), deferring NTP sync attempt.\n", (int)_wifiMgr->getCurrentState());
+  // 2) A synchronization completed: rebase the monotonic clock on the new wall-clock time.
+  if (s_timeSyncNotified.exchange(false)) {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    _baseMonotonicUs = esp_timer_get_time();
+    _baseEpochUs = (int64_t)tv.tv_sec * 1000000LL + tv.tv_usec;
+    _lastEpochSec = -1;  // Refresh the cached values now.
+    _lastMinuteKey = -1;
+    if (_syncState != SYNCED) {
+      DEBUG_INFO_PRINTLN("TimeManager: NTP sync successful.");
     }
+    _syncState = SYNCED;
   }
 
-  // 2) Update cached time string and colon visibility for UI.
-  if (_syncState == SYNCED) {
-    struct tm timeinfo;
-    // Get local time with a short timeout to avoid blocking.
-    if (!getLocalTime(&timeinfo, 50)) {
-      DEBUG_TRACE_PRINTLN("TimeManager: Failed to get local time during update, skipping.");
-      return; // Skip update if time not available.
-    }
+  if (_syncState != SYNCED) return;
+
+  // 3) Update cached time string and colon visibility for UI, only when the second changes.
+  const int64_t epochSec = (_baseEpochUs + (esp_timer_get_time() - _baseMonotonicUs)) / 1000000LL;
+  if (epochSec == _lastEpochSec) return;
+  _lastEpochSec = epochSec;
 
+  // Time zone offsets are whole minutes, so the parity of the UTC second is the local one.
+  _cachedColonVisible = (epochSec % 2 == 0);
+
+  const int64_t minuteKey = epochSec / 60;
+  if (minuteKey != _lastMinuteKey) {
+    _lastMinuteKey = minuteKey;
+    const time_t t = (time_t)epochSec;
+    struct tm timeinfo;
+    localtime_r(&t, &timeinfo);
     char buf[6]; // Sufficient for "HH:MM\0".
     snprintf(buf, sizeof(buf), "%02d:%02d", timeinfo.tm_hour, timeinfo.tm_min);
-    
-    // Update cached time string if minute or hour changes.
-    if (_lastMinute != timeinfo.tm_min) {
-        _cachedTimeString = std::string(buf);
-        _lastMinute = timeinfo.tm_min;
-        DEBUG_TRACE_PRINTF("TimeManager: Cached time string updated to %s.\n", _cachedTimeString.c_str());
-    }
-
-    // Update colon visibility every second for blinking effect.
-    bool currentColonVisible = (timeinfo.tm_sec % 2 == 0);
-    if (_cachedColonVisible != currentColonVisible) {
-        _cachedColonVisible = currentColonVisible;
-        DEBUG_TRACE_PRINTF("TimeManager: Cached colon visibility updated to %s.\n", _cachedColonVisible ? "true" : "false");
-    }
+    _cachedTimeString = buf;
+    DEBUG_TRACE_PRINTF("TimeManager: Cached time string updated to %s.\n", _cachedTimeString.c_str());
   }
-}
\ No newline at end of file
+}
@@ -50,6 +50,11 @@ struct TimeManagerConfig;
  * for network connectivity. It provides an interface to retrieve the current
  * formatted time string and a flag for colon blinking, which is useful for
  * UI clock displays.
+ *
+ * SNTP runs in the background (lwIP) and reports completed synchronizations through its
+ * notification callback, so `loop()` never waits for the network. Between synchronizations
+ * the time is derived from the monotonic `esp_timer` clock, and the calendar time is only
+ * computed and formatted when the displayed minute changes.
  */
 class TimeManager {
 public:
@@ -77,17 +82,17 @@ public:
   /**
    * @brief Main update method for the TimeManager.
    * This function should be called repeatedly in the Arduino `loop()` function.
-   * It handles periodic NTP synchronization attempts and updates the cached time string
-   * and colon visibility flag for efficient UI rendering.
+   * It starts SNTP once Wi-Fi is connected, applies completed synchronizations and updates
+   * the cached time string and colon visibility flag for efficient UI rendering. Never blocks.
    */
   void loop();
 
   // --- Accessors ---
   /**
    * @brief Retrieves the currently cached formatted time string (e.g., "HH:MM").
-   * @return The formatted time string.
+   * @return The formatted time string (valid until the next `loop()`).
    */
-  std::string getCurrentTimeString() const;
+  const std::string& getCurrentTimeString() const;
 
   /**
    * @brief Checks if the colon in the time string should currently be visible (for blinking effect).
@@ -107,18 +112,24 @@ private:
   // --- Internal State ---
   enum SyncState { UNSYNCED, SYNCED }; ///< Enumerates NTP synchronization states.
   SyncState _syncState;               ///< Current NTP synchronization state.
-  unsigned long _lastSyncAttemptMs;   ///< Timestamp of the last NTP synchronization attempt.
-  unsigned long _lastDisplayMs;       ///< Timestamp of the last display update (for colon blinking).
-  bool _blink;                        ///< Current state of the colon blink (true for visible, false for hidden).
-  int _lastMinute;                    ///< Stores the minute from the last time update (for change detection).
+  bool _sntpStarted;                  ///< True once the SNTP client has been configured and started.
+  int64_t _baseEpochUs;               ///< Wall-clock time (UTC, microseconds) at the last synchronization.
+  int64_t _baseMonotonicUs;           ///< `esp_timer` time at the last synchronization.
+  int64_t _lastEpochSec;              ///< Second shown by the last update (for change detection).
+  int64_t _lastMinuteKey;             ///< Minute (epoch seconds / 60) of the cached time string.
 
   // --- Cached Values for UI ---
   std::string _cachedTimeString;      ///< Cached formatted time string for quick access by UI.
   bool _cachedColonVisible;           ///< Cached colon visibility state for UI blinking.
 
   // --- Constants ---
-  static constexpr unsigned long FIRST_RETRY_MS   = 30UL * 1000UL; ///< Initial retry interval for NTP sync (30 seconds).
   static constexpr unsigned long RESYNC_INTERVAL_MS = 4UL * 60UL * 60UL * 1000UL; ///< Interval for regular NTP resynchronization (4 hours).
+
+  /**
+   * @brief SNTP time-sync notification callback. Runs on the lwIP task.
+   * @param tv The time that was set.
+   */
+  static void _onTimeSynced(struct timeval* tv);
 };
 
 #endif // TIMEMANAGER_H
\ No newline at end of file
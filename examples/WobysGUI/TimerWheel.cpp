@@ -0,0 +1,220 @@
+/**
+ * @file TimerWheel.cpp
+ * @brief Implements the TimerWheel hierarchical timing wheel.
+ *
+ * @version 1.0.0
+ * @date 2025-08-31
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "TimerWheel.h"
+
+TimerWheel g_timerWheel;
+
+namespace {
+// Rotates a 64-bit slot bitmap right so that bit 0 corresponds to slot `by`.
+inline uint64_t rotateRight(uint64_t bits, uint8_t by) {
+  by &= 63;
+  return by ? (bits >> by) | (bits << (64 - by)) : bits;
+}
+} // namespace
+
+/**
+ * @brief Destructor for Timer. Cancels the timer if it is still scheduled.
+ */
+TimerWheel::Timer::~Timer() {
+  if (_wheel) {
+    _wheel->cancel(*this);
+  }
+}
+
+/**
+ * @brief Constructor for TimerWheel.
+ * @param clock Millisecond time source used to anchor new timers.
+ */
+TimerWheel::TimerWheel(uint32_t (*clock)())
+  : _clock(clock), _nowMs(clock()) {}
+
+/**
+ * @brief Schedules a timer, replacing any earlier schedule of the same timer.
+ * A delay of 0 expires on the next `advance()`.
+ * @param timer The timer to schedule.
+ * @param delayMs Delay in milliseconds until the first expiry.
+ * @param periodMs Reload period in milliseconds, or 0 for a one-shot timer.
+ */
+void TimerWheel::start(Timer& timer, uint32_t delayMs, uint32_t periodMs) {
+  if (timer._wheel) {
+    timer._wheel->cancel(timer);
+  }
+  uint32_t expires = _clock() + delayMs;
+  // Never schedule into a tick that has already been processed.
+  if ((int32_t)(expires - _nowMs) <= 0) {
+    expires = _nowMs + 1;
+  }
+  timer._expiresMs = expires;
+  timer._periodMs = periodMs;
+  timer._wheel = this;
+  _link(timer);
+  _activeCount++;
+}
+
+/**
+ * @brief Cancels a timer. Does nothing if the timer is not scheduled on this wheel.
+ * @param timer The timer to cancel.
+ */
+void TimerWheel::cancel(Timer& timer) {
+  if (timer._wheel != this) return;
+  _unlink(timer);
+  timer._wheel = nullptr;
+  _activeCount--;
+}
+
+/**
+ * @brief Moves the wheel forward one tick at a time up to `nowMs`, cascading the upper
+ * levels when the lower ones wrap and running the timers of each level-0 slot reached.
+ * @param nowMs The current time in milliseconds.
+ */
+void TimerWheel::advance(uint32_t nowMs) {
+  while ((int32_t)(nowMs - _nowMs) > 0) {
+    if (_activeCount == 0) { // Nothing to expire or cascade, jump straight to now.
+      _nowMs = nowMs;
+      return;
+    }
+    _nowMs++;
+    // Cascade from the top down, so timers falling into a slot that is cascaded
+    // in this same tick are picked up by the level below.
+    for (uint8_t level = LEVELS - 1; level > 0; level--) {
+      if ((_nowMs & ((1UL << (SLOT_BITS * level)) - 1)) == 0) {
+        _cascade(level);
+      }
+    }
+    _fireSlot(_nowMs & SLOT_MASK);
+  }
+}
+
+/**
+ * @brief Computes how long the caller may sleep before the next timer expires.
+ * Only the first occupied slot of each level needs to be looked at: slots are visited in
+ * the order they come due, and every timer in a slot expires before those in later slots.
+ * @param maxMs Upper bound for the result.
+ * @return Milliseconds until the earliest deadline, clamped to [0, maxMs].
+ */
+uint32_t TimerWheel::msUntilNextDeadline(uint32_t maxMs) const {
+  if (_activeCount == 0) return maxMs;
+
+  int32_t earliest = INT32_MAX; // Relative to _nowMs.
+  for (uint8_t level = 0; level < LEVELS; level++) {
+    if (!_occupied[level]) continue;
+    const uint8_t shift = SLOT_BITS * level;
+    const uint8_t first = ((_nowMs >> shift) + 1) & SLOT_MASK;
+    const uint8_t slot = (first + __builtin_ctzll(rotateRight(_occupied[level], first))) & SLOT_MASK;
+    for (const Timer* t = _slots[level][slot]; t; t = t->_next) {
+      int32_t rel = (int32_t)(t->_expiresMs - _nowMs);
+      if (rel < earliest) earliest = rel;
+    }
+  }
+
+  int32_t remaining = earliest - (int32_t)(_clock() - _nowMs);
+  if (remaining <= 0) return 0;
+  return (uint32_t)remaining < maxMs ? (uint32_t)remaining : maxMs;
+}
+
+/**
+ * @brief Links a timer into the slot matching its expiry relative to the current tick.
+ * Delays beyond the top level's range are parked at its far end and re-linked on cascade.
+ * @param timer The timer to link.
+ */
+void TimerWheel::_link(Timer& timer) {
+  uint32_t delta = timer._expiresMs - _nowMs;
+  if ((int32_t)delta < 0) delta = 0; // Overdue after a cascade: fire in the current tick.
+
+  uint8_t level = 0;
+  while (level < LEVELS - 1 && delta >= (1UL << (SLOT_BITS * (level + 1)))) {
+    level++;
+  }
+  const uint32_t span = 1UL << (SLOT_BITS * LEVELS);
+  uint32_t due = (delta < span) ? timer._expiresMs : _nowMs + span - 1;
+  uint8_t slot = (due >> (SLOT_BITS * level)) & SLOT_MASK;
+
+  timer._level = level;
+  timer._slot = slot;
+  timer._prev = nullptr;
+  timer._next = _slots[level][slot];
+  if (timer._next) timer._next->_prev = &timer;
+  _slots[level][slot] = &timer;
+  _occupied[level] |= (1ULL << slot);
+}
+
+/**
+ * @brief Removes a timer from its slot list.
+ * @param timer The timer to unlink.
+ */
+void TimerWheel::_unlink(Timer& timer) {
+  if (timer._prev) {
+    timer._prev->_next = timer._next;
+  } else {
+    _slots[timer._level][timer._slot] = timer._next;
+    if (!timer._next) _occupied[timer._level] &= ~(1ULL << timer._slot);
+  }
+  if (timer._next) timer._next->_prev = timer._prev;
+  timer._prev = timer._next = nullptr;
+}
+
+/**
+ * @brief Re-links every timer of the current slot of `level` into the levels below it.
+ * @param level The wheel level to cascade (1..LEVELS-1).
+ */
+void TimerWheel::_cascade(uint8_t level) {
+  const uint8_t slot = (_nowMs >> (SLOT_BITS * level)) & SLOT_MASK;
+  Timer* t = _slots[level][slot];
+  _slots[level][slot] = nullptr;
+  _occupied[level] &= ~(1ULL << slot);
+  while (t) {
+    Timer* next = t->_next;
+    _link(*t);
+    t = next;
+  }
+}
+
+/**
+ * @brief Runs every timer in a level-0 slot. Periodic timers are re-linked before their
+ * callback runs, so the callback can cancel or restart them. A callback must not destroy
+ * its own timer.
+ * @param slot The level-0 slot that is due.
+ */
+void TimerWheel::_fireSlot(uint8_t slot) {
+  while (Timer* t = _slots[0][slot]) {
+    _unlink(*t);
+    if (t->_periodMs) {
+      // Keep the phase of the original schedule; skip periods missed while the loop was stalled.
+      do {
+        t->_expiresMs += t->_periodMs;
+      } while ((int32_t)(t->_expiresMs - _nowMs) <= 0);
+      _link(*t);
+    } else {
+      t->_wheel = nullptr;
+      _activeCount--;
+    }
+    if (t->_callback) t->_callback();
+  }
+}
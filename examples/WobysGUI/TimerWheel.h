@@ -0,0 +1,167 @@
+/**
+ * @file TimerWheel.h
+ * @brief Defines the TimerWheel class, a hierarchical timing wheel for the main loop's periodic work.
+ *
+ * Managers used to keep their own `millis()` timestamps and compare them on every pass of
+ * the Arduino loop. With the wheel they register a one-shot or periodic timer once and are
+ * called back when it expires. Starting and cancelling a timer is O(1), and the wheel can
+ * tell how long it is until the next deadline, so the main loop can sleep until then instead
+ * of waking up at a fixed rate.
+ *
+ * The wheel has four levels of 64 slots with a 1 ms tick, which covers delays of up to
+ * 2^24 ms (about 4.6 hours) directly; longer delays are parked in the last level and
+ * re-inserted when they come around. Timers are intrusive (the caller owns the storage),
+ * so the wheel itself never allocates.
+ *
+ * @version 1.0.0
+ * @date 2025-08-31
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <Arduino.h>
+#include <functional>
+#include <stdint.h>
+
+/**
+ * @brief A hierarchical timing wheel driven from the main loop.
+ *
+ * All methods must be called from the same task (the Arduino loop task); callbacks run
+ * synchronously inside `advance()`. A callback may start or cancel any timer, including
+ * its own.
+ */
+class TimerWheel {
+public:
+    /**
+     * @brief A timer that can be scheduled on a TimerWheel.
+     * The owner keeps the object alive while it is scheduled; destroying it cancels it.
+     */
+    class Timer {
+    public:
+        Timer() = default;
+
+        /**
+         * @brief Constructs a timer with its callback.
+         * @param callback The function to run when the timer expires.
+         */
+        explicit Timer(std::function<void()> callback) : _callback(std::move(callback)) {}
+
+        ~Timer();
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        /**
+         * @brief Sets the function to run when the timer expires.
+         * @param callback The callback function.
+         */
+        void setCallback(std::function<void()> callback) { _callback = std::move(callback); }
+
+        /**
+         * @brief Checks whether the timer is currently scheduled.
+         * @return True if the timer is linked into a wheel, false otherwise.
+         */
+        bool isActive() const { return _wheel != nullptr; }
+
+    private:
+        friend class TimerWheel;
+
+        Timer* _prev = nullptr;             ///< Previous timer in the slot list.
+        Timer* _next = nullptr;             ///< Next timer in the slot list.
+        TimerWheel* _wheel = nullptr;       ///< Wheel the timer is scheduled on, nullptr if idle.
+        uint32_t _expiresMs = 0;            ///< Absolute expiry time on the wheel's clock.
+        uint32_t _periodMs = 0;             ///< Reload period in milliseconds, 0 for one-shot timers.
+        uint8_t _level = 0;                 ///< Wheel level the timer is linked into.
+        uint8_t _slot = 0;                  ///< Slot index within the level.
+        std::function<void()> _callback;    ///< Function run on expiry.
+    };
+
+    /**
+     * @brief Constructor for TimerWheel.
+     * @param clock Millisecond time source used to anchor new timers. Defaults to `millis()`.
+     */
+    explicit TimerWheel(uint32_t (*clock)() = _defaultClock);
+
+    /**
+     * @brief Schedules a timer, replacing any earlier schedule of the same timer.
+     * @param timer The timer to schedule.
+     * @param delayMs Delay in milliseconds until the first expiry.
+     * @param periodMs Reload period in milliseconds after each expiry, or 0 for a one-shot timer.
+     */
+    void start(Timer& timer, uint32_t delayMs, uint32_t periodMs = 0);
+
+    /**
+     * @brief Cancels a timer. Does nothing if the timer is not scheduled.
+     * @param timer The timer to cancel.
+     */
+    void cancel(Timer& timer);
+
+    /**
+     * @brief Moves the wheel forward to the given time and runs every expired timer.
+     * @param nowMs The current time in milliseconds (usually `millis()`).
+     */
+    void advance(uint32_t nowMs);
+
+    /**
+     * @brief Computes how long the caller may sleep before the next timer expires.
+     * @param maxMs Upper bound for the result, returned when nothing expires sooner.
+     * @return Milliseconds until the earliest deadline, clamped to [0, maxMs].
+     */
+    uint32_t msUntilNextDeadline(uint32_t maxMs) const;
+
+    /**
+     * @brief Returns the number of timers currently scheduled.
+     * @return The number of scheduled timers.
+     */
+    size_t activeCount() const { return _activeCount; }
+
+private:
+    static constexpr uint8_t LEVELS = 4;          ///< Number of wheel levels.
+    static constexpr uint8_t SLOT_BITS = 6;       ///< log2 of slots per level.
+    static constexpr uint8_t SLOTS = 1 << SLOT_BITS; ///< Slots per level.
+    static constexpr uint32_t SLOT_MASK = SLOTS - 1;
+
+    static uint32_t _defaultClock() { return millis(); }
+
+    void _link(Timer& timer);
+    void _unlink(Timer& timer);
+    void _cascade(uint8_t level);
+    void _fireSlot(uint8_t slot);
+
+    uint32_t (*_clock)();                   ///< Time source used by start().
+    uint32_t _nowMs;                        ///< Time of the last processed tick.
+    size_t _activeCount = 0;                ///< Number of scheduled timers.
+    Timer* _slots[LEVELS][SLOTS] = {};      ///< Heads of the per-slot doubly linked lists.
+    uint64_t _occupied[LEVELS] = {};        ///< One bit per non-empty slot, per level.
+};
+
+/**
+ * @brief The timer wheel shared by the main loop and the managers running on it.
+ * It is advanced at the top of `loop()` in the main sketch.
+ */
+extern TimerWheel g_timerWheel;
+
+#endif // TIMER_WHEEL_H
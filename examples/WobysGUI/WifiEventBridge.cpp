@@ -0,0 +1,266 @@
+/**
+ * @file WifiEventBridge.cpp
+ * @brief Implements the WifiEventBridge class, which runs the WifiManager on its own FreeRTOS task.
+ *
+ * @version 1.0.0
+ * @date 2025-08-23
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "WifiEventBridge.h"
+#include "SystemInitializer.h" // For WifiEventBridgeConfig
+
+/**
+ * @brief Constructor for the WifiEventBridge class.
+ * @param wifiManager Pointer to the WifiManager instance driven by the bridge.
+ */
+WifiEventBridge::WifiEventBridge(WifiManager* wifiManager)
+  : _wifiManager(wifiManager),
+    _config(nullptr),
+    _taskHandle(nullptr),
+    _driverEventQueue(nullptr),
+    _taskShouldRun(false),
+    _wifiEventHandlerId(0),
+    _driverEventCount(0),
+    _droppedEventCount(0) {
+  _managerMutex = xSemaphoreCreateRecursiveMutex();
+  _uiEventMutex = xSemaphoreCreateMutex();
+  _taskDoneSignal = xSemaphoreCreateBinary();
+
+  if (!_managerMutex || !_uiEventMutex || !_taskDoneSignal) {
+    DEBUG_ERROR_PRINTLN("WifiEventBridge: ERROR - Failed to create semaphores!");
+  }
+}
+
+/**
+ * @brief Destructor. Stops the Wi-Fi task and releases FreeRTOS resources.
+ */
+WifiEventBridge::~WifiEventBridge() {
+  _stopTask();
+  if (_wifiEventHandlerId) WiFi.removeEvent(_wifiEventHandlerId);
+  if (_driverEventQueue) vQueueDelete(_driverEventQueue);
+  if (_managerMutex) vSemaphoreDelete(_managerMutex);
+  if (_uiEventMutex) vSemaphoreDelete(_uiEventMutex);
+  if (_taskDoneSignal) vSemaphoreDelete(_taskDoneSignal);
+}
+
+/**
+ * @brief Registers for driver events, hooks the manager callbacks and starts the Wi-Fi task.
+ * @param config Task and queue parameters.
+ * @return True if the task is running, false if the bridge fell back to inline mode.
+ */
+bool WifiEventBridge::init(const WifiEventBridgeConfig& config) {
+  DEBUG_INFO_PRINTLN("WifiEventBridge: init() starting...");
+  _config = &config;
+
+  if (!_wifiManager) {
+    DEBUG_ERROR_PRINTLN("WifiEventBridge: WifiManager pointer is null. Initialization aborted.");
+    return false;
+  }
+
+  // Manager callbacks may fire on the Wi-Fi task; only copy the data here and let loop()
+  // deliver it on the UI task.
+  _wifiManager->setOnConnectionStateChangedCallback(
+    [this](WifiMgr_State_t newState, const std::string& ssid, const std::string& ip) {
+      UiEvent event;
+      event.type = UiEvent::Type::STATE;
+      event.state = newState;
+      event.ssid = ssid;
+      event.ip = ip;
+      this->_postUiEvent(std::move(event));
+    });
+  _wifiManager->setOnScanCompleteCallback(
+    [this](bool success, const std::vector<WifiListItemData>& networks) {
+      UiEvent event;
+      event.type = UiEvent::Type::SCAN_COMPLETE;
+      event.success = success;
+      event.networks = networks;
+      this->_postUiEvent(std::move(event));
+    });
+  _wifiManager->setOnRssiChangeCallback([this](int32_t newRssi) {
+    UiEvent event;
+    event.type = UiEvent::Type::RSSI;
+    event.rssi = newRssi;
+    this->_postUiEvent(std::move(event));
+  });
+
+  if (!_managerMutex || !_uiEventMutex || !_taskDoneSignal) {
+    DEBUG_WARN_PRINTLN("WifiEventBridge: Semaphores missing. Running WifiManager inline.");
+    return false;
+  }
+
+  if (!_driverEventQueue) {
+    _driverEventQueue = xQueueCreate(_config->eventQueueLength, sizeof(arduino_event_id_t));
+  }
+  if (!_driverEventQueue) {
+    DEBUG_WARN_PRINTLN("WifiEventBridge: Failed to create driver event queue. Running WifiManager inline.");
+    return false;
+  }
+
+  // Runs on the Arduino event task: never block here, just wake the Wi-Fi task.
+  if (!_wifiEventHandlerId) {
+    _wifiEventHandlerId = WiFi.onEvent([this](arduino_event_id_t event, arduino_event_info_t info) {
+      switch (event) {
+        case ARDUINO_EVENT_WIFI_STA_START:
+        case ARDUINO_EVENT_WIFI_STA_STOP:
+        case ARDUINO_EVENT_WIFI_STA_CONNECTED:
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+        case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+        case ARDUINO_EVENT_WIFI_SCAN_DONE:
+          _driverEventCount++;
+          if (xQueueSend(_driverEventQueue, &event, 0) != pdTRUE) {
+            _droppedEventCount++; // The task is awake anyway; it polls the driver state itself.
+          }
+          break;
+        default:
+          break;
+      }
+    });
+  }
+
+  _taskShouldRun = true;
+  BaseType_t rc = xTaskCreatePinnedToCore(
+    _wifiTask,
+    "WifiMgrTask",
+    _config->taskStackSize,
+    this,
+    _config->taskPriority,
+    &_taskHandle,
+    _config->taskCore);
+  if (rc != pdPASS) {
+    _taskHandle = nullptr;
+    _taskShouldRun = false;
+    DEBUG_WARN_PRINTLN("WifiEventBridge: Failed to create Wi-Fi task. Running WifiManager inline.");
+    return false;
+  }
+
+  DEBUG_INFO_PRINTLN("WifiEventBridge: Wi-Fi task started.");
+  return true;
+}
+
+/**
+ * @brief UI-task side of the bridge. Delivers queued manager events to the UI callbacks.
+ */
+void WifiEventBridge::loop() {
+  if (!_wifiManager) return;
+
+  if (!_taskHandle) {
+    lock();
+    _wifiManager->loop(); // Fallback: drive the manager from the UI task as before.
+    unlock();
+  }
+
+  // Swap the pending events out so callbacks run without holding the event mutex.
+  std::deque<UiEvent> pending;
+  if (_uiEventMutex) xSemaphoreTake(_uiEventMutex, portMAX_DELAY);
+  pending.swap(_uiEvents);
+  if (_uiEventMutex) xSemaphoreGive(_uiEventMutex);
+
+  for (const UiEvent& event : pending) {
+    switch (event.type) {
+      case UiEvent::Type::STATE:
+        if (_uiStateCb) _uiStateCb(event.state, event.ssid, event.ip);
+        break;
+      case UiEvent::Type::SCAN_COMPLETE:
+        if (_uiScanCompleteCb) _uiScanCompleteCb(event.success, event.networks);
+        break;
+      case UiEvent::Type::RSSI:
+        if (_uiRssiCb) _uiRssiCb(event.rssi);
+        break;
+    }
+  }
+}
+
+/**
+ * @brief Acquires the lock that serializes access to the WifiManager (recursive).
+ */
+void WifiEventBridge::lock() {
+  if (_managerMutex) xSemaphoreTakeRecursive(_managerMutex, portMAX_DELAY);
+}
+
+/**
+ * @brief Releases the lock acquired with `lock()`.
+ */
+void WifiEventBridge::unlock() {
+  if (_managerMutex) xSemaphoreGiveRecursive(_managerMutex);
+}
+
+/**
+ * @brief Queues a manager event for delivery on the UI task. RSSI events are coalesced.
+ * @param event The event to queue.
+ */
+void WifiEventBridge::_postUiEvent(UiEvent&& event) {
+  if (_uiEventMutex) xSemaphoreTake(_uiEventMutex, portMAX_DELAY);
+  if (event.type == UiEvent::Type::RSSI && !_uiEvents.empty() &&
+      _uiEvents.back().type == UiEvent::Type::RSSI) {
+    _uiEvents.back().rssi = event.rssi; // Only the latest reading matters to the UI.
+  } else {
+    _uiEvents.push_back(std::move(event));
+  }
+  if (_uiEventMutex) xSemaphoreGive(_uiEventMutex);
+}
+
+/**
+ * @brief Asks the Wi-Fi task to exit and waits for it.
+ */
+void WifiEventBridge::_stopTask() {
+  if (!_taskHandle) return;
+  _taskShouldRun = false;
+  arduino_event_id_t wake = ARDUINO_EVENT_MAX;
+  xQueueSend(_driverEventQueue, &wake, 0);
+
+  if (xSemaphoreTake(_taskDoneSignal, pdMS_TO_TICKS(1000)) != pdTRUE) {
+    DEBUG_WARN_PRINTLN("WifiEventBridge: Timeout waiting for Wi-Fi task termination. Forcibly deleting.");
+    vTaskDelete(_taskHandle);
+  }
+  _taskHandle = nullptr;
+}
+
+/**
+ * @brief Entry point of the Wi-Fi task. Runs the manager whenever a driver event arrives,
+ * and at the idle interval otherwise.
+ * @param pvParameters Pointer to the WifiEventBridge instance.
+ */
+void WifiEventBridge::_wifiTask(void* pvParameters) {
+  WifiEventBridge* self = static_cast<WifiEventBridge*>(pvParameters);
+  const TickType_t idleTicks = pdMS_TO_TICKS(self->_config->idlePollMs);
+  DEBUG_INFO_PRINTLN("WifiMgrTask: Started.");
+
+  arduino_event_id_t event;
+  while (self->_taskShouldRun) {
+    if (xQueueReceive(self->_driverEventQueue, &event, idleTicks) == pdTRUE) {
+      // One manager pass handles any burst (e.g. CONNECTED followed by GOT_IP).
+      while (xQueueReceive(self->_driverEventQueue, &event, 0) == pdTRUE) {}
+    }
+    if (!self->_taskShouldRun) break;
+
+    self->lock();
+    self->_wifiManager->loop();
+    self->unlock();
+  }
+
+  DEBUG_INFO_PRINTLN("WifiMgrTask: Exiting.");
+  xSemaphoreGive(self->_taskDoneSignal);
+  vTaskDelete(NULL);
+}
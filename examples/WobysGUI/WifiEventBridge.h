@@ -0,0 +1,228 @@
+/**
+ * @file WifiEventBridge.h
+ * @brief Defines the WifiEventBridge class, which runs the WifiManager on its own FreeRTOS task.
+ *
+ * The bridge subscribes to the ESP-IDF Wi-Fi driver events (through the Arduino `WiFi.onEvent`
+ * wrapper), posts them to a queue and runs the `WifiManager` state machine on a dedicated task
+ * that wakes up as soon as a driver event arrives. Manager callbacks are copied into UI events
+ * and delivered on the UI task from `loop()`, so UI code never runs on the Wi-Fi task.
+ *
+ * @version 1.0.0
+ * @date 2025-08-23
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef WIFI_EVENT_BRIDGE_H
+#define WIFI_EVENT_BRIDGE_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+
+#include "Config.h"
+#include "WifiManager.h"
+
+// Forward declaration for configuration struct (defined in SystemInitializer.h)
+struct WifiEventBridgeConfig;
+
+/**
+ * @brief Moves the WifiManager state machine onto a dedicated, event-driven FreeRTOS task.
+ *
+ * Driver events (connected, got IP, disconnected, scan done, ...) wake the Wi-Fi task
+ * immediately; between events the task only runs the manager at a slow idle interval so
+ * its connect/scan timeouts and RSSI tracking keep working.
+ *
+ * Because `WifiManager` is not thread-safe, every access to it from the UI task must hold
+ * the bridge lock (see `ScopedLock`). The manager also touches the UI from the Wi-Fi task: it
+ * sets the status-bar icon, posts messages and resumes BLE scans whose callbacks update BLEUI.
+ * The main loop therefore holds the lock for its whole UI section, rendering included, and
+ * the task runs the manager while the loop sleeps. WifiUI and BLEUI take the (recursive) lock
+ * in their handlers as well, so they do not depend on being called from that section.
+ *
+ * If the task cannot be created, the bridge falls back to running `WifiManager::loop()`
+ * inline from `loop()`, which keeps the previous behaviour.
+ */
+class WifiEventBridge {
+public:
+  /**
+   * @brief RAII helper that holds the bridge lock for the lifetime of the object.
+   */
+  class ScopedLock {
+  public:
+    /**
+     * @brief Acquires the bridge lock.
+     * @param bridge The bridge whose lock should be held.
+     */
+    explicit ScopedLock(WifiEventBridge& bridge) : _bridge(&bridge) { _bridge->lock(); }
+    /**
+     * @brief Acquires the bridge lock if a bridge is set.
+     * @param bridge The bridge whose lock should be held (nullptr = no bridge, nothing to lock).
+     */
+    explicit ScopedLock(WifiEventBridge* bridge) : _bridge(bridge) { if (_bridge) _bridge->lock(); }
+    /**
+     * @brief Releases the bridge lock.
+     */
+    ~ScopedLock() { if (_bridge) _bridge->unlock(); }
+    ScopedLock(const ScopedLock&) = delete;
+    ScopedLock& operator=(const ScopedLock&) = delete;
+  private:
+    WifiEventBridge* _bridge; ///< The bridge whose lock is held (nullptr = none).
+  };
+
+  /**
+   * @brief Constructor for the WifiEventBridge class.
+   * @param wifiManager Pointer to the WifiManager instance driven by the bridge.
+   */
+  WifiEventBridge(WifiManager* wifiManager);
+
+  /**
+   * @brief Destructor. Stops the Wi-Fi task and releases FreeRTOS resources.
+   */
+  ~WifiEventBridge();
+
+  /**
+   * @brief Registers for driver events, hooks the manager callbacks and starts the Wi-Fi task.
+   * Must be called after `WifiManager::init()`.
+   * @param config Task and queue parameters.
+   * @return True if the task is running, false if the bridge fell back to inline mode.
+   */
+  bool init(const WifiEventBridgeConfig& config);
+
+  /**
+   * @brief UI-task side of the bridge. Delivers queued manager events to the UI callbacks.
+   * In fallback mode it also runs `WifiManager::loop()`. Call from the main loop while
+   * holding the bridge lock.
+   */
+  void loop();
+
+  /**
+   * @brief Acquires the lock that serializes access to the WifiManager (recursive).
+   */
+  void lock();
+
+  /**
+   * @brief Releases the lock acquired with `lock()`.
+   */
+  void unlock();
+
+  /**
+   * @brief Checks if the dedicated Wi-Fi task is running.
+   * @return True if the manager runs on its own task, false in inline fallback mode.
+   */
+  bool isTaskRunning() const { return _taskHandle != nullptr; }
+
+  /**
+   * @brief Returns the number of driver events received since init.
+   * @return The event count.
+   */
+  uint32_t getDriverEventCount() const { return _driverEventCount.load(); }
+
+  /**
+   * @brief Returns the number of driver events dropped because the queue was full.
+   * @return The dropped event count.
+   */
+  uint32_t getDroppedEventCount() const { return _droppedEventCount.load(); }
+
+  /**
+   * @brief Sets the UI-task callback for scan completion (same signature as WifiManager's).
+   * @param cb The callback function.
+   */
+  void setOnScanCompleteCallback(WifiManager::ScanCompleteCallback cb) { _uiScanCompleteCb = cb; }
+
+  /**
+   * @brief Sets the UI-task callback for connection state changes (same signature as WifiManager's).
+   * @param cb The callback function.
+   */
+  void setOnConnectionStateChangedCallback(WifiManager::ConnectionStateCallback cb) { _uiStateCb = cb; }
+
+  /**
+   * @brief Sets the UI-task callback for RSSI changes (same signature as WifiManager's).
+   * @param cb The callback function.
+   */
+  void setOnRssiChangeCallback(WifiManager::RssiChangeCallback cb) { _uiRssiCb = cb; }
+
+private:
+  /**
+   * @brief A manager callback captured on the Wi-Fi task, waiting to be delivered on the UI task.
+   */
+  struct UiEvent {
+    /**
+     * @brief Kind of manager callback that produced the event.
+     */
+    enum class Type { STATE, SCAN_COMPLETE, RSSI } type; ///< Event kind.
+    WifiMgr_State_t state = WifiMgr_State_t::DISCONNECTED; ///< New state (STATE).
+    std::string ssid;                                      ///< SSID (STATE).
+    std::string ip;                                        ///< IP address (STATE).
+    bool success = false;                                  ///< Scan result (SCAN_COMPLETE).
+    std::vector<WifiListItemData> networks;                ///< Scan results (SCAN_COMPLETE).
+    int32_t rssi = 0;                                      ///< New RSSI (RSSI).
+  };
+
+  WifiManager* _wifiManager;                 ///< Pointer to the WifiManager (not owned).
+  const WifiEventBridgeConfig* _config;      ///< Pointer to the configuration (owned by SystemInitializer).
+
+  TaskHandle_t _taskHandle;                  ///< Handle of the Wi-Fi task (nullptr in fallback mode).
+  QueueHandle_t _driverEventQueue;           ///< Queue of raw driver event IDs from the event loop.
+  SemaphoreHandle_t _managerMutex;           ///< Recursive mutex serializing WifiManager access.
+  SemaphoreHandle_t _uiEventMutex;           ///< Protects `_uiEvents`.
+  SemaphoreHandle_t _taskDoneSignal;         ///< Given by the Wi-Fi task when it exits.
+  std::atomic<bool> _taskShouldRun;          ///< Cleared to ask the Wi-Fi task to exit.
+  wifi_event_id_t _wifiEventHandlerId;       ///< ID returned by `WiFi.onEvent()`, used for removal.
+
+  std::deque<UiEvent> _uiEvents;             ///< Manager events waiting for the UI task.
+  std::atomic<uint32_t> _driverEventCount;   ///< Driver events received.
+  std::atomic<uint32_t> _droppedEventCount;  ///< Driver events dropped due to a full queue.
+
+  WifiManager::ScanCompleteCallback _uiScanCompleteCb;   ///< UI callback for scan completion.
+  WifiManager::ConnectionStateCallback _uiStateCb;       ///< UI callback for state changes.
+  WifiManager::RssiChangeCallback _uiRssiCb;             ///< UI callback for RSSI changes.
+
+  /**
+   * @brief Queues a manager event for delivery on the UI task. RSSI events are coalesced.
+   * @param event The event to queue.
+   */
+  void _postUiEvent(UiEvent&& event);
+
+  /**
+   * @brief Asks the Wi-Fi task to exit and waits for it.
+   */
+  void _stopTask();
+
+  /**
+   * @brief Entry point of the Wi-Fi task.
+   * @param pvParameters Pointer to the WifiEventBridge instance.
+   */
+  static void _wifiTask(void* pvParameters);
+};
+
+#endif // WIFI_EVENT_BRIDGE_H
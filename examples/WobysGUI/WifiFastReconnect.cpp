@@ -0,0 +1,269 @@
+/**
+ * @file WifiFastReconnect.cpp
+ * @brief Implements the WifiFastReconnect class for directed reconnects to a cached access point.
+ *
+ * @version 1.0.0
+ * @date 2025-08-22
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "WifiFastReconnect.h"
+#include <WiFi.h>
+#include <esp_wifi.h>
+
+/**
+ * @brief Constructor for the WifiFastReconnect class.
+ * @param wifiManager Pointer to the WifiManager instance.
+ * @param settingsManager Pointer to the SettingsManager instance.
+ * @param timeoutMs Time allowed for a directed attempt before falling back to a scan.
+ */
+WifiFastReconnect::WifiFastReconnect(WifiManager* wifiManager,
+                                     SettingsManager* settingsManager,
+                                     unsigned long timeoutMs)
+  : _wifiManager(wifiManager),
+    _settingsManager(settingsManager),
+    _timeoutMs(timeoutMs),
+    _phase(Phase::IDLE),
+    _attemptStartMs(0),
+    _lastState(WifiMgr_State_t::WIFI_MGR_DISABLED) {
+}
+
+/**
+ * @brief Checks whether a saved network with a usable cached access point exists.
+ * @return True if a directed reconnect can be attempted.
+ */
+bool WifiFastReconnect::hasCandidate() const {
+  return _pickCandidate() != nullptr;
+}
+
+/**
+ * @brief Requests a directed reconnect; the attempt starts from `loop()` once the manager is idle.
+ */
+void WifiFastReconnect::requestReconnect() {
+  if (!_wifiManager || !_settingsManager) {
+    DEBUG_ERROR_PRINTLN("WifiFastReconnect: WifiManager or SettingsManager pointer is null. Cannot reconnect.");
+    return;
+  }
+  if (_phase == Phase::DIRECTED || _phase == Phase::FALLBACK) return; // Already working on it.
+  _phase = Phase::PENDING;
+  DEBUG_INFO_PRINTLN("WifiFastReconnect: Reconnect requested.");
+}
+
+/**
+ * @brief Advances the reconnect logic and observes WifiManager state transitions.
+ */
+void WifiFastReconnect::loop() {
+  if (!_wifiManager || !_settingsManager) return;
+
+  WifiMgr_State_t state = _wifiManager->getCurrentState();
+  bool stateChanged = (state != _lastState);
+  WifiMgr_State_t previous = _lastState;
+  _lastState = state;
+
+  if (stateChanged) {
+    if (state == WifiMgr_State_t::CONNECTING && _phase == Phase::IDLE) {
+      _attemptStartMs = millis(); // Connect started by the manager or the UI.
+    } else if (state == WifiMgr_State_t::CONNECTED) {
+      _onConnected();
+    } else if (state == WifiMgr_State_t::WIFI_MGR_DISABLED) {
+      _phase = Phase::IDLE;
+    } else if (state == WifiMgr_State_t::DISCONNECTED && previous == WifiMgr_State_t::CONNECTED &&
+               _settingsManager->isWifiAutoConnectEnabled(true)) {
+      // Link lost: try the cached AP first instead of waiting for the next scan-based retry.
+      requestReconnect();
+    }
+  }
+
+  switch (_phase) {
+    case Phase::PENDING:
+      if (!_wifiManager->isWifiLogicEnabled()) {
+        _phase = Phase::IDLE;
+      } else if (state == WifiMgr_State_t::DISCONNECTED || state == WifiMgr_State_t::CONNECTION_FAILED) {
+        if (!_startDirectedAttempt()) {
+          _fallBackToScan();
+        }
+      } else if (state == WifiMgr_State_t::CONNECTED) {
+        _phase = Phase::IDLE; // Someone else already connected.
+      }
+      break;
+
+    case Phase::DIRECTED:
+      if (state == WifiMgr_State_t::CONNECTION_FAILED ||
+          (state != WifiMgr_State_t::CONNECTED && millis() - _attemptStartMs > _timeoutMs)) {
+        DEBUG_WARN_PRINTF("WifiFastReconnect: Directed connect to '%s' failed after %lu ms.\n",
+                          _targetSsid.c_str(), millis() - _attemptStartMs);
+        _settingsManager->invalidateWifiApHint(_targetSsid);
+        _fallBackToScan();
+      }
+      break;
+
+    case Phase::FALLBACK:
+      // The manager finished its scan without connecting; its own retry interval takes over.
+      if (stateChanged &&
+          (state == WifiMgr_State_t::DISCONNECTED || state == WifiMgr_State_t::CONNECTION_FAILED)) {
+        _phase = Phase::IDLE;
+      }
+      break;
+
+    case Phase::IDLE:
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Picks the saved network to reconnect to.
+ * @return The chosen hint, or nullptr if none is usable.
+ */
+const WifiApHint* WifiFastReconnect::_pickCandidate() const {
+  if (!_settingsManager) return nullptr;
+
+  const std::string lastSsid = _settingsManager->getLastConnectedSsid();
+  const WifiApHint* lastHint = _settingsManager->findWifiApHint(lastSsid);
+  if (lastHint && lastHint->isValid() && _settingsManager->findSavedNetwork(lastSsid)) {
+    return lastHint;
+  }
+
+  const WifiApHint* best = nullptr;
+  for (const auto& net : _settingsManager->getSavedNetworks()) {
+    const WifiApHint* hint = _settingsManager->findWifiApHint(net.ssid);
+    if (hint && hint->isValid() && (!best || hint->averageRssi() > best->averageRssi())) {
+      best = hint;
+    }
+  }
+  return best;
+}
+
+/**
+ * @brief Starts the directed connect to the chosen candidate.
+ * @return True if the attempt was started.
+ */
+bool WifiFastReconnect::_startDirectedAttempt() {
+  const WifiApHint* hint = _pickCandidate();
+  if (!hint) {
+    DEBUG_INFO_PRINTLN("WifiFastReconnect: No cached access point available.");
+    return false;
+  }
+  const SavedWifiNetwork* saved = _settingsManager->findSavedNetwork(hint->ssid);
+  if (!saved) return false;
+
+  _targetSsid = hint->ssid;
+  uint8_t bssid[6];
+  memcpy(bssid, hint->bssid, sizeof(bssid));
+  uint8_t channel = hint->channel;
+  std::string password = saved->password;
+
+  // The manager keeps owning the attempt, its timeout and the state machine; its full-scan begin
+  // is then replaced by one on the cached AP for the same SSID.
+  if (!_wifiManager->connectToNetwork(_targetSsid, password)) {
+    DEBUG_WARN_PRINTF("WifiFastReconnect: WifiManager refused connect to '%s'.\n", _targetSsid.c_str());
+    return false;
+  }
+  if (!_beginDirected(password, channel, bssid)) {
+    return false;
+  }
+
+  _attemptStartMs = millis();
+  _phase = Phase::DIRECTED;
+  _metrics.directedAttempts++;
+  DEBUG_INFO_PRINTF("WifiFastReconnect: Directed connect to '%s' (%02X:%02X:%02X:%02X:%02X:%02X, ch %u).\n",
+                    _targetSsid.c_str(), bssid[0], bssid[1], bssid[2], bssid[3], bssid[4], bssid[5], channel);
+  return true;
+}
+
+/**
+ * @brief Restarts the connect to `_targetSsid` on the cached AP.
+ *
+ * `WifiManager::connectToNetwork()` has already called `WiFi.begin(ssid, pass)`, which leaves the
+ * channel and BSSID of the station config empty. Beginning again with the cached channel and BSSID
+ * makes the driver drop that attempt and join the cached AP after a single-channel probe; the
+ * manager still sees a connect to the same SSID and keeps its timeout running.
+ * @param password The password of the target network.
+ * @param channel The cached channel.
+ * @param bssid The cached BSSID.
+ * @return True if the station config targets the cached AP.
+ */
+bool WifiFastReconnect::_beginDirected(const std::string& password, uint8_t channel, const uint8_t* bssid) {
+  WiFi.begin(_targetSsid.c_str(), password.c_str(), channel, bssid);
+
+  wifi_config_t config = {};
+  if (esp_wifi_get_config(WIFI_IF_STA, &config) != ESP_OK) {
+    DEBUG_WARN_PRINTLN("WifiFastReconnect: Station config not available (Wi-Fi driver not started).");
+    return false;
+  }
+  DEBUG_INFO_PRINTF("WifiFastReconnect: Station config ch %u, BSSID %s %02X:%02X:%02X:%02X:%02X:%02X.\n",
+                    config.sta.channel, config.sta.bssid_set ? "set" : "not set", config.sta.bssid[0],
+                    config.sta.bssid[1], config.sta.bssid[2], config.sta.bssid[3], config.sta.bssid[4],
+                    config.sta.bssid[5]);
+  if (config.sta.channel != channel || !config.sta.bssid_set || memcmp(config.sta.bssid, bssid, 6) != 0) {
+    DEBUG_WARN_PRINTLN("WifiFastReconnect: The cached AP did not reach the station config.");
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Abandons the directed attempt and hands over to the scan-based auto-connect.
+ */
+void WifiFastReconnect::_fallBackToScan() {
+  _metrics.scanFallbacks++;
+  _phase = Phase::FALLBACK;
+  if (_wifiManager->getCurrentState() == WifiMgr_State_t::CONNECTING) {
+    _wifiManager->disconnectFromNetwork();
+  }
+  _attemptStartMs = millis();
+  if (!_wifiManager->startScanAndAttemptAutoConnect()) {
+    DEBUG_WARN_PRINTLN("WifiFastReconnect: Scan-based auto-connect could not be started.");
+    _phase = Phase::IDLE;
+  }
+}
+
+/**
+ * @brief Records metrics and refreshes the cached access point after a connect.
+ */
+void WifiFastReconnect::_onConnected() {
+  uint32_t elapsed = _attemptStartMs ? static_cast<uint32_t>(millis() - _attemptStartMs) : 0;
+  bool directed = (_phase == Phase::DIRECTED);
+
+  _metrics.lastConnectMs = elapsed;
+  _metrics.lastWasDirected = directed;
+  if (directed) {
+    _metrics.directedSuccesses++;
+    if (_metrics.bestDirectedMs == 0 || elapsed < _metrics.bestDirectedMs) _metrics.bestDirectedMs = elapsed;
+  } else {
+    _metrics.lastScanPathMs = elapsed;
+  }
+  DEBUG_INFO_PRINTF("WifiFastReconnect: Connected in %lu ms (%s). Directed %lu/%lu, fallbacks %lu.\n",
+                    (unsigned long)elapsed, directed ? "directed" : "regular",
+                    (unsigned long)_metrics.directedSuccesses, (unsigned long)_metrics.directedAttempts,
+                    (unsigned long)_metrics.scanFallbacks);
+
+  const uint8_t* bssid = WiFi.BSSID();
+  if (bssid) {
+    _settingsManager->updateWifiApHint(_wifiManager->getConnectedSsid(), bssid,
+                                       static_cast<uint8_t>(WiFi.channel()),
+                                       static_cast<int8_t>(WiFi.RSSI()), elapsed);
+  }
+  _phase = Phase::IDLE;
+  _attemptStartMs = 0;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file WifiFastReconnect.h
+ * @brief Defines the WifiFastReconnect class for directed reconnects to a cached access point.
+ *
+ * This class remembers the BSSID and channel of the access point used for each saved
+ * network (via `SettingsManager`) and, on boot or after a link loss, reconnects directly
+ * to that access point on a single channel. A full scan is only performed if the directed
+ * attempt fails. Connect-time metrics are collected for both paths.
+ *
+ * @version 1.0.0
+ * @date 2025-08-22
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef WIFI_FAST_RECONNECT_H
+#define WIFI_FAST_RECONNECT_H
+
+#include <Arduino.h>
+#include <string>
+
+#include "Config.h"
+#include "WifiManager.h"
+#include "SettingsManager.h"
+
+/**
+ * @brief Performs directed Wi-Fi reconnects using the cached BSSID/channel of saved networks.
+ *
+ * The connect is started through `WifiManager::connectToNetwork()`, so the manager stays the owner
+ * of the attempt, its timeout and the connection state. The manager's `WiFi.begin(ssid, pass)`
+ * joins any AP of the network after a full scan, so the attempt is then restarted on the same SSID
+ * with `WiFi.begin(ssid, pass, channel, bssid)`, which joins the cached AP on its channel. If no connection is established within `WIFI_FAST_RECONNECT_TIMEOUT_MS`, the cached
+ * hint is invalidated and the regular scan-and-auto-connect path of the manager is used.
+ *
+ * The class also observes every transition into `CONNECTED` (regardless of who initiated it)
+ * to refresh the cached access point and record connect-time metrics.
+ */
+class WifiFastReconnect {
+public:
+  /**
+   * @brief Connect-time statistics collected since boot.
+   */
+  struct Metrics {
+    uint32_t directedAttempts = 0;     ///< Number of directed (cached AP) attempts started.
+    uint32_t directedSuccesses = 0;    ///< Number of directed attempts that connected.
+    uint32_t scanFallbacks = 0;        ///< Number of times the scan-based path had to be used.
+    uint32_t lastConnectMs = 0;        ///< Duration of the most recent successful connect.
+    uint32_t bestDirectedMs = 0;       ///< Fastest directed connect observed (0 if none).
+    uint32_t lastScanPathMs = 0;       ///< Duration of the most recent connect via the regular path.
+    bool lastWasDirected = false;      ///< True if the most recent connect used the cached AP.
+  };
+
+  /**
+   * @brief Constructor for the WifiFastReconnect class.
+   * @param wifiManager Pointer to the WifiManager instance.
+   * @param settingsManager Pointer to the SettingsManager instance holding saved networks and AP hints.
+   * @param timeoutMs Time allowed for a directed attempt before falling back to a scan.
+   */
+  WifiFastReconnect(WifiManager* wifiManager,
+                    SettingsManager* settingsManager,
+                    unsigned long timeoutMs = WIFI_FAST_RECONNECT_TIMEOUT_MS);
+
+  /**
+   * @brief Checks whether a saved network with a usable cached access point exists.
+   * @return True if a directed reconnect can be attempted.
+   */
+  bool hasCandidate() const;
+
+  /**
+   * @brief Requests a directed reconnect. The attempt starts from `loop()` as soon as the
+   * WifiManager is enabled and idle (e.g. right after `enableWifi()` at boot or after wake).
+   */
+  void requestReconnect();
+
+  /**
+   * @brief Advances the reconnect logic and observes WifiManager state transitions.
+   * Must be called regularly from the main loop, after `WifiManager::loop()`.
+   */
+  void loop();
+
+  /**
+   * @brief Checks if a directed attempt is currently in progress.
+   * @return True while the directed attempt is running.
+   */
+  bool isAttempting() const { return _phase == Phase::DIRECTED; }
+
+  /**
+   * @brief Returns the collected connect-time metrics.
+   * @return A const reference to the metrics structure.
+   */
+  const Metrics& getMetrics() const { return _metrics; }
+
+private:
+  /**
+   * @brief Internal phases of a reconnect.
+   */
+  enum class Phase {
+    IDLE,      ///< No reconnect in progress.
+    PENDING,   ///< Reconnect requested, waiting for the manager to become idle.
+    DIRECTED,  ///< Directed connect to the cached access point in progress.
+    FALLBACK   ///< Scan-based auto-connect in progress after a failed directed attempt.
+  };
+
+  WifiManager* _wifiManager;            ///< Pointer to the WifiManager (not owned).
+  SettingsManager* _settingsManager;    ///< Pointer to the SettingsManager (not owned).
+  unsigned long _timeoutMs;             ///< Directed attempt timeout in milliseconds.
+
+  Phase _phase;                         ///< Current reconnect phase.
+  std::string _targetSsid;              ///< SSID targeted by the current directed attempt.
+  unsigned long _attemptStartMs;        ///< millis() when the current connect (any path) started.
+  WifiMgr_State_t _lastState;           ///< Last observed WifiManager state.
+  Metrics _metrics;                     ///< Collected connect-time metrics.
+
+  /**
+   * @brief Picks the saved network to reconnect to: the last connected SSID if it has a
+   * valid hint, otherwise the hint with the best average RSSI.
+   * @return The chosen hint, or nullptr if none is usable.
+   */
+  const WifiApHint* _pickCandidate() const;
+
+  /**
+   * @brief Starts the directed connect to the chosen candidate.
+   * @return True if the attempt was started.
+   */
+  bool _startDirectedAttempt();
+
+  /**
+   * @brief Restarts the manager's connect to `_targetSsid` on the cached AP and checks that the
+   * driver's station config carries it.
+   * @param password The password of the target network.
+   * @param channel The cached channel.
+   * @param bssid The cached BSSID.
+   * @return True if the station config targets the cached AP.
+   */
+  bool _beginDirected(const std::string& password, uint8_t channel, const uint8_t* bssid);
+
+  /**
+   * @brief Abandons the directed attempt and hands over to the scan-based auto-connect.
+   */
+  void _fallBackToScan();
+
+  /**
+   * @brief Records metrics and refreshes the cached access point after a connect.
+   */
+  void _onConnected();
+};
+
+#endif // WIFI_FAST_RECONNECT_H
@@ -0,0 +1,258 @@
+/**
+ * @file WifiPowerPolicy.cpp
+ * @brief Implements the WifiPowerPolicy class, which selects the Wi-Fi modem power-save mode.
+ *
+ * @version 1.0.0
+ * @date 2025-08-27
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "WifiPowerPolicy.h"
+#include "SystemInitializer.h" // For WifiPowerPolicyConfig
+#include "WifiManager.h"
+#include "BLEManager.h"
+#include "PowerManager.h"
+#include "ScreenSaverManager.h"
+#include <esp_wifi.h>
+
+/**
+ * @brief Constructor for the WifiPowerPolicy class.
+ * @param wifiManager Pointer to the WifiManager (connection state).
+ * @param btManager Pointer to the BLEManager (coexistence constraint).
+ * @param powerManager Pointer to the PowerManager (battery voltage).
+ * @param screenSaverManager Pointer to the ScreenSaverManager (user presence).
+ */
+WifiPowerPolicy::WifiPowerPolicy(WifiManager* wifiManager, BLEManager* btManager,
+                                 PowerManager* powerManager, ScreenSaverManager* screenSaverManager)
+  : _wifiManager(wifiManager),
+    _btManager(btManager),
+    _powerManager(powerManager),
+    _screenSaverManager(screenSaverManager),
+    _config(nullptr),
+    _mode(WifiPowerMode::NONE),
+    _applied(false),
+    _lowBattery(false),
+    _wasScreenSaverActive(false),
+    _idleSinceMs(0),
+    _lastTrafficMs(0),
+    _modeSinceMs(0),
+    _lastAccountMs(0),
+    _wakeTriggerMs(0),
+    _lastBatteryCheckMs(0) {
+  memset(_stats, 0, sizeof(_stats));
+}
+
+/**
+ * @brief Initializes the policy with its configuration.
+ * @param config Thresholds, timings and nominal currents.
+ * @return True if the policy is ready.
+ */
+bool WifiPowerPolicy::init(const WifiPowerPolicyConfig& config) {
+  DEBUG_INFO_PRINTLN("WifiPowerPolicy: init() starting...");
+  _config = &config;
+  if (!_wifiManager) {
+    DEBUG_ERROR_PRINTLN("WifiPowerPolicy: WifiManager pointer is null. Initialization aborted.");
+    return false;
+  }
+  if (!_screenSaverManager || !_powerManager) {
+    DEBUG_WARN_PRINTLN("WifiPowerPolicy: ScreenSaverManager or PowerManager missing; the modem is treated as attended on mains power.");
+  }
+  unsigned long now = millis();
+  _modeSinceMs = now;
+  _lastAccountMs = now;
+  DEBUG_INFO_PRINTLN("WifiPowerPolicy: Initialized.");
+  return true;
+}
+
+/**
+ * @brief Evaluates the inputs and applies a new mode if needed. Call from the main loop.
+ */
+void WifiPowerPolicy::loop() {
+  if (!_config || !_wifiManager) return;
+  unsigned long now = millis();
+
+  // --- User presence ---
+  bool idle = _screenSaverManager && _screenSaverManager->isActive();
+  if (idle && !_wasScreenSaverActive) {
+    _idleSinceMs = now;
+  } else if (!idle && _wasScreenSaverActive && _mode != WifiPowerMode::NONE && !_wakeTriggerMs) {
+    _wakeTriggerMs = now; // The user is back; measure how long the modem takes to follow.
+  }
+  _wasScreenSaverActive = idle;
+
+  // --- Battery (with hysteresis; readings below 1 V mean no battery is attached) ---
+  if (_powerManager && now - _lastBatteryCheckMs >= _config->batteryCheckIntervalMs) {
+    _lastBatteryCheckMs = now;
+    float volts = _powerManager->getCurrentVoltage();
+    if (volts >= 1.0f) {
+      if (!_lowBattery && volts < _config->lowBatteryVolts) {
+        _lowBattery = true;
+      } else if (_lowBattery && volts > _config->lowBatteryVolts + _config->batteryHysteresisVolts) {
+        _lowBattery = false;
+      }
+    }
+  }
+
+  if (_wifiManager->getCurrentState() != WifiMgr_State_t::CONNECTED) {
+    if (_applied) {
+      _account(now);
+      _applied = false;
+    }
+    return;
+  }
+
+  WifiPowerMode desired = _selectMode(now);
+  if (!_applied) {
+    // New connection: the driver may have reset its power-save mode.
+    _lastAccountMs = now;
+    _apply(desired, now);
+    _applied = true;
+    return;
+  }
+
+  _account(now);
+  if (desired == _mode) {
+    _wakeTriggerMs = 0;
+    return;
+  }
+  // Wake immediately; only go to a more economical mode after the minimum dwell time.
+  if (desired > _mode && now - _modeSinceMs < _config->minDwellMs) return;
+  _apply(desired, now);
+}
+
+/**
+ * @brief Reports network traffic. Keeps the modem awake for `trafficHoldMs`.
+ * Must be called from the main loop task.
+ */
+void WifiPowerPolicy::noteTraffic() {
+  _lastTrafficMs = millis();
+  if (_mode != WifiPowerMode::NONE && !_wakeTriggerMs) {
+    _wakeTriggerMs = _lastTrafficMs;
+  }
+}
+
+/**
+ * @brief Returns the statistics of a mode.
+ * @param mode The mode.
+ * @return A const reference to the statistics.
+ */
+const WifiPowerModeStats& WifiPowerPolicy::getStats(WifiPowerMode mode) const {
+  size_t index = (size_t)mode;
+  if (index >= (size_t)WifiPowerMode::COUNT) index = 0;
+  return _stats[index];
+}
+
+/**
+ * @brief Returns a short name for a mode.
+ * @param mode The mode.
+ * @return The mode name.
+ */
+const char* WifiPowerPolicy::modeName(WifiPowerMode mode) {
+  switch (mode) {
+    case WifiPowerMode::NONE: return "none";
+    case WifiPowerMode::MIN_MODEM: return "min-modem";
+    case WifiPowerMode::MAX_MODEM: return "max-modem";
+    default: return "?";
+  }
+}
+
+/**
+ * @brief Chooses the mode for the current inputs.
+ * @param now Current millis().
+ * @return The desired mode.
+ */
+WifiPowerMode WifiPowerPolicy::_selectMode(unsigned long now) const {
+  bool trafficRecent = _lastTrafficMs != 0 && now - _lastTrafficMs < _config->trafficHoldMs;
+
+  WifiPowerMode mode;
+  if (!_wasScreenSaverActive || trafficRecent) {
+    mode = WifiPowerMode::NONE;
+  } else if (_lowBattery || now - _idleSinceMs >= _config->deepIdleAfterMs) {
+    mode = WifiPowerMode::MAX_MODEM;
+  } else {
+    mode = WifiPowerMode::MIN_MODEM;
+  }
+
+  // Wi-Fi/BLE coexistence requires modem sleep while Bluetooth is enabled.
+  if (mode == WifiPowerMode::NONE && _btManager && _btManager->isEnabled()) {
+    mode = WifiPowerMode::MIN_MODEM;
+  }
+  return mode;
+}
+
+/**
+ * @brief Applies a mode to the Wi-Fi driver and updates the statistics.
+ * @param mode The mode to apply.
+ * @param now Current millis().
+ * @return True if the driver accepted the mode.
+ */
+bool WifiPowerPolicy::_apply(WifiPowerMode mode, unsigned long now) {
+  wifi_ps_type_t psType = WIFI_PS_NONE;
+  if (mode == WifiPowerMode::MIN_MODEM) psType = WIFI_PS_MIN_MODEM;
+  else if (mode == WifiPowerMode::MAX_MODEM) psType = WIFI_PS_MAX_MODEM;
+
+  esp_err_t err = esp_wifi_set_ps(psType);
+  if (err != ESP_OK) {
+    DEBUG_WARN_PRINTF("WifiPowerPolicy: esp_wifi_set_ps(%s) failed (%d).\n", modeName(mode), (int)err);
+    return false;
+  }
+
+  WifiPowerModeStats& stats = _stats[(size_t)mode];
+  if (_wakeTriggerMs && mode < _mode) {
+    stats.lastWakeLatencyMs = now - _wakeTriggerMs;
+    if (stats.lastWakeLatencyMs > stats.maxWakeLatencyMs) stats.maxWakeLatencyMs = stats.lastWakeLatencyMs;
+  }
+  _wakeTriggerMs = 0;
+  stats.entries++;
+
+  DEBUG_INFO_PRINTF("WifiPowerPolicy: %s -> %s (idle: %d, low battery: %d).\n",
+                    modeName(_mode), modeName(mode), _wasScreenSaverActive, _lowBattery);
+  _mode = mode;
+  _modeSinceMs = now;
+  return true;
+}
+
+/**
+ * @brief Adds the time since the last accounting to the current mode's statistics.
+ * @param now Current millis().
+ */
+void WifiPowerPolicy::_account(unsigned long now) {
+  unsigned long elapsed = now - _lastAccountMs;
+  _lastAccountMs = now;
+  WifiPowerModeStats& stats = _stats[(size_t)_mode];
+  stats.residentMs += elapsed;
+  stats.estimatedMah += _nominalCurrentMa(_mode) * (float)elapsed / 3600000.0f;
+}
+
+/**
+ * @brief Returns the nominal modem current of a mode.
+ * @param mode The mode.
+ * @return The current in mA.
+ */
+float WifiPowerPolicy::_nominalCurrentMa(WifiPowerMode mode) const {
+  switch (mode) {
+    case WifiPowerMode::MIN_MODEM: return _config->currentMinModemMa;
+    case WifiPowerMode::MAX_MODEM: return _config->currentMaxModemMa;
+    default: return _config->currentNoneMa;
+  }
+}
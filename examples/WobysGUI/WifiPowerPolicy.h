@@ -0,0 +1,179 @@
+/**
+ * @file WifiPowerPolicy.h
+ * @brief Defines the WifiPowerPolicy class, which selects the Wi-Fi modem power-save mode.
+ *
+ * The policy follows the user's presence (screensaver), recent network traffic and the battery
+ * voltage: the modem stays awake while the UI is in use or data is flowing, sleeps between DTIM
+ * beacons while the device is unattended, and listens to fewer beacons when it has been idle
+ * for long or the battery is low. Time spent in each mode, an estimated charge per mode and the
+ * wake-up reaction time are recorded for tuning.
+ *
+ * @version 1.0.0
+ * @date 2025-08-27
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef WIFI_POWER_POLICY_H
+#define WIFI_POWER_POLICY_H
+
+#include <Arduino.h>
+
+// Forward declarations
+class WifiManager;
+class BLEManager;
+class PowerManager;
+class ScreenSaverManager;
+struct WifiPowerPolicyConfig; // Defined in SystemInitializer.h
+
+/**
+ * @brief Wi-Fi modem power-save modes, from the most responsive to the most economical.
+ */
+enum class WifiPowerMode : uint8_t {
+  NONE = 0,      ///< Modem always awake (lowest latency, highest current).
+  MIN_MODEM = 1, ///< Modem wakes for every DTIM beacon.
+  MAX_MODEM = 2, ///< Modem wakes every few beacons (the driver's listen interval).
+  COUNT          ///< Number of modes (not a mode).
+};
+
+/**
+ * @brief Statistics collected for one power-save mode.
+ */
+struct WifiPowerModeStats {
+  uint32_t entries;            ///< Number of times the mode was entered.
+  uint64_t residentMs;         ///< Total time spent in the mode while connected.
+  float estimatedMah;          ///< Charge estimated from `residentMs` and the nominal mode current.
+  uint32_t lastWakeLatencyMs;  ///< Trigger-to-applied time of the last entry caused by user input or traffic.
+  uint32_t maxWakeLatencyMs;   ///< Largest such time.
+};
+
+/**
+ * @brief Selects and applies the Wi-Fi modem power-save mode.
+ *
+ * The mode is only applied while the station is connected and is re-applied after every
+ * (re)connection. Switching towards a more responsive mode happens immediately; switching
+ * towards a more economical one only after `minDwellMs` in the current mode, so short pauses
+ * do not make the modem flap. `MAX_MODEM` uses the listen interval the driver announced at
+ * association; the AP only learns it then, and `WiFi.begin()` sets it on every connect. While
+ * Bluetooth LE is enabled the modem must keep sleeping between beacons for coexistence, so
+ * `NONE` is replaced by `MIN_MODEM`.
+ */
+class WifiPowerPolicy {
+public:
+  /**
+   * @brief Constructor for the WifiPowerPolicy class.
+   * @param wifiManager Pointer to the WifiManager (connection state).
+   * @param btManager Pointer to the BLEManager (coexistence constraint).
+   * @param powerManager Pointer to the PowerManager (battery voltage).
+   * @param screenSaverManager Pointer to the ScreenSaverManager (user presence).
+   */
+  WifiPowerPolicy(WifiManager* wifiManager, BLEManager* btManager,
+                  PowerManager* powerManager, ScreenSaverManager* screenSaverManager);
+
+  /**
+   * @brief Initializes the policy with its configuration.
+   * @param config Thresholds, timings and nominal currents.
+   * @return True if the policy is ready.
+   */
+  bool init(const WifiPowerPolicyConfig& config);
+
+  /**
+   * @brief Evaluates the inputs and applies a new mode if needed. Call from the main loop.
+   */
+  void loop();
+
+  /**
+   * @brief Reports network traffic. Keeps the modem awake for `trafficHoldMs`.
+   * Must be called from the main loop task.
+   */
+  void noteTraffic();
+
+  /**
+   * @brief Returns the mode currently applied.
+   * @return The current power-save mode.
+   */
+  WifiPowerMode getMode() const { return _mode; }
+
+  /**
+   * @brief Returns the statistics of a mode (the current mode's residence is included up to the last `loop()`).
+   * @param mode The mode.
+   * @return A const reference to the statistics.
+   */
+  const WifiPowerModeStats& getStats(WifiPowerMode mode) const;
+
+  /**
+   * @brief Returns a short name for a mode (for logs and diagnostics).
+   * @param mode The mode.
+   * @return The mode name.
+   */
+  static const char* modeName(WifiPowerMode mode);
+
+private:
+  WifiManager* _wifiManager;                 ///< Pointer to the WifiManager (not owned).
+  BLEManager* _btManager;                    ///< Pointer to the BLEManager (not owned).
+  PowerManager* _powerManager;               ///< Pointer to the PowerManager (not owned).
+  ScreenSaverManager* _screenSaverManager;   ///< Pointer to the ScreenSaverManager (not owned).
+  const WifiPowerPolicyConfig* _config;      ///< Pointer to the configuration (owned by SystemInitializer).
+
+  WifiPowerMode _mode;                       ///< Mode currently applied.
+  bool _applied;                             ///< True if `_mode` has been applied to the current connection.
+  bool _lowBattery;                          ///< Low-battery state (with hysteresis).
+  bool _wasScreenSaverActive;                ///< Screensaver state seen by the previous `loop()`.
+  unsigned long _idleSinceMs;                ///< millis() when the screensaver last became active.
+  unsigned long _lastTrafficMs;              ///< millis() of the last reported traffic.
+  unsigned long _modeSinceMs;                ///< millis() when `_mode` was entered.
+  unsigned long _lastAccountMs;              ///< millis() up to which residence time has been accounted.
+  unsigned long _wakeTriggerMs;              ///< millis() of a pending wake trigger (0 = none).
+  unsigned long _lastBatteryCheckMs;         ///< millis() of the last battery evaluation.
+  WifiPowerModeStats _stats[(size_t)WifiPowerMode::COUNT]; ///< Per-mode statistics.
+
+  /**
+   * @brief Chooses the mode for the current inputs.
+   * @param now Current millis().
+   * @return The desired mode.
+   */
+  WifiPowerMode _selectMode(unsigned long now) const;
+
+  /**
+   * @brief Applies a mode to the Wi-Fi driver and updates the statistics.
+   * @param mode The mode to apply.
+   * @param now Current millis().
+   * @return True if the driver accepted the mode.
+   */
+  bool _apply(WifiPowerMode mode, unsigned long now);
+
+  /**
+   * @brief Adds the time since the last accounting to the current mode's statistics.
+   * @param now Current millis().
+   */
+  void _account(unsigned long now);
+
+  /**
+   * @brief Returns the nominal modem current of a mode.
+   * @param mode The mode.
+   * @return The current in mA.
+   */
+  float _nominalCurrentMa(WifiPowerMode mode) const;
+};
+
+#endif // WIFI_POWER_POLICY_H
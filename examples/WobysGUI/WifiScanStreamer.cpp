@@ -0,0 +1,318 @@
+/**
+ * @file WifiScanStreamer.cpp
+ * @brief Implements the WifiScanStreamer class for incremental, per-channel Wi-Fi scanning.
+ *
+ * @version 1.0.0
+ * @date 2025-08-22
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#include "WifiScanStreamer.h"
+#include "GlobalSystemEvents.h" // For g_displayLocalizedMessage (demo limit)
+#include <WiFi.h>
+#include <esp_wifi.h>
+
+namespace {
+/**
+ * @brief Channel visiting order. The common non-overlapping channels come first so the
+ * first batch is likely to contain most of the nearby access points.
+ */
+constexpr uint8_t CHANNEL_ORDER[] = { 1, 6, 11, 2, 3, 4, 5, 7, 8, 9, 10, 12, 13 };
+constexpr size_t CHANNEL_ORDER_COUNT = sizeof(CHANNEL_ORDER) / sizeof(CHANNEL_ORDER[0]);
+}
+
+/**
+ * @brief Constructor for the WifiScanStreamer class.
+ * @param wifiManager Pointer to the WifiManager, used to check whether the radio is free.
+ * @param maxMsPerChannel Active scan dwell time per channel in milliseconds.
+ */
+WifiScanStreamer::WifiScanStreamer(WifiManager* wifiManager, uint32_t maxMsPerChannel)
+  : _wifiManager(wifiManager),
+    _maxMsPerChannel(maxMsPerChannel),
+    _isScanning(false),
+    _channelIndex(0),
+    _successfulChannels(0),
+    _channelStartMs(0),
+    _waitingForDriver(false),
+    _radioScheduler(nullptr),
+    _radioRequestId(0),
+    _awaitingRadio(false),
+    _networksIndex(_networks),
+    _batchIndex(_batch) {
+}
+
+/**
+ * @brief Starts a new channel sweep, discarding any previous results.
+ * @return True if the sweep was started, false otherwise.
+ */
+bool WifiScanStreamer::start() {
+  if (!_isRadioAvailable()) {
+    DEBUG_WARN_PRINTLN("WifiScanStreamer: Radio not available (Wi-Fi disabled or manager busy).");
+    return false;
+  }
+
+#ifdef DEMO_MODE
+  if (_demoSweepCount >= MAX_WIFI_SCANS_DEMO) {
+    DEBUG_WARN_PRINTLN("WifiScanStreamer: Demo scan limit reached.");
+    if (g_displayLocalizedMessage) {
+      g_displayLocalizedMessage("DEMO_WIFI_SCAN_LIMIT_REACHED", 3000, true);
+    }
+    return false;
+  }
+  _demoSweepCount++;
+#endif
+
+  cancel(); // Drop any sweep (and driver-side results) left over from a previous run.
+  _networks.clear();
+  _networksIndex.clear();
+  _channelIndex = 0;
+  _successfulChannels = 0;
+  _isScanning = true;
+
+  DEBUG_INFO_PRINTF("WifiScanStreamer: Sweep started (%u channels, %lu ms/channel).\n",
+                    (unsigned)CHANNEL_ORDER_COUNT, (unsigned long)_maxMsPerChannel);
+
+  if (_radioScheduler) {
+    RadioRequest request;
+    request.owner = RadioOwner::WIFI;
+    request.kind = RadioOpKind::SCAN;
+    request.priority = RadioPriority::INTERACTIVE;
+    request.onStart = [this](RadioRequestId) {
+      _awaitingRadio = false;
+      if (!_isRadioAvailable()) {
+        _finish(false); // The manager took the radio while the request was queued.
+        return;
+      }
+      _beginChannels();
+    };
+    request.onExpired = [this](RadioRequestId) {
+      _radioRequestId = 0;
+      _awaitingRadio = false;
+      _finish(false);
+    };
+    _awaitingRadio = true;
+    _radioRequestId = _radioScheduler->submit(request);
+    return true;
+  }
+  return _beginChannels();
+}
+
+/**
+ * @brief Cancels an ongoing sweep. No further callbacks are invoked for it.
+ */
+void WifiScanStreamer::cancel() {
+  if (!_isScanning) return;
+  if (!_awaitingRadio) _stopChannelScan();
+  if (_radioScheduler && _radioRequestId) _radioScheduler->cancel(_radioRequestId);
+  _radioRequestId = 0;
+  _awaitingRadio = false;
+  _isScanning = false;
+  DEBUG_INFO_PRINTLN("WifiScanStreamer: Sweep cancelled.");
+}
+
+/**
+ * @brief Advances the sweep. Must be called regularly (e.g. from a layer loop callback).
+ */
+void WifiScanStreamer::loop() {
+  if (!_isScanning || _awaitingRadio) return;
+
+  // Stop immediately if Wi-Fi was switched off or the manager took over the radio.
+  if (!_isRadioAvailable()) {
+    _stopChannelScan();
+    _finish(_successfulChannels > 0);
+    return;
+  }
+
+  int16_t result = WiFi.scanComplete();
+  const bool overdue = millis() - _channelStartMs > _maxMsPerChannel * 4 + WIFI_STREAM_SCAN_CHANNEL_GUARD_MS;
+  if (_waitingForDriver) {
+    if (result != WIFI_SCAN_RUNNING) {
+      if (!_startCurrentChannel()) _advance();
+    } else if (overdue) {
+      DEBUG_WARN_PRINTLN("WifiScanStreamer: Driver still busy with another scan. Sweep stopped.");
+      _finish(_successfulChannels > 0);
+    }
+    return;
+  }
+  if (result == WIFI_SCAN_RUNNING) {
+    // Guard against a driver scan that never reports completion.
+    if (overdue) {
+      DEBUG_WARN_PRINTF("WifiScanStreamer: Channel %u timed out.\n", CHANNEL_ORDER[_channelIndex]);
+      _stopChannelScan();
+      _advance();
+    }
+    return;
+  }
+
+  if (result >= 0) {
+    _successfulChannels++;
+    _collectResults(result);
+    if (!_batch.empty() && _onBatch) {
+      _onBatch(_batch);
+    }
+  } else {
+    DEBUG_WARN_PRINTF("WifiScanStreamer: Scan failed on channel %u.\n", CHANNEL_ORDER[_channelIndex]);
+  }
+  WiFi.scanDelete();
+  _advance();
+}
+
+/**
+ * @brief Checks whether the WifiManager state allows the streamer to use the radio.
+ * @return True if Wi-Fi is enabled and the manager is idle.
+ */
+bool WifiScanStreamer::_isRadioAvailable() const {
+  if (!_wifiManager || !_wifiManager->isWifiLogicEnabled()) return false;
+  switch (_wifiManager->getCurrentState()) {
+    case WifiMgr_State_t::DISCONNECTED:
+    case WifiMgr_State_t::CONNECTED:
+    case WifiMgr_State_t::CONNECTION_FAILED:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/**
+ * @brief Starts scanning from the first channel that accepts a scan.
+ * @return True if a channel scan was started; otherwise the sweep is finished as failed.
+ */
+bool WifiScanStreamer::_beginChannels() {
+  while (_channelIndex < CHANNEL_ORDER_COUNT && !_startCurrentChannel()) {
+    _channelIndex++;
+  }
+  if (_channelIndex >= CHANNEL_ORDER_COUNT) {
+    _finish(false);
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Starts the asynchronous scan for the channel at `_channelIndex`.
+ *
+ * An asynchronous `WiFi.scanNetworks()` reports `WIFI_SCAN_RUNNING` both when it starts a scan
+ * and when it refuses to because one is still running, so the driver is checked first. A scan
+ * still running here (a stopped one the driver has not reported done yet, or one that is not
+ * ours) would otherwise be read as this channel's; the channel waits for it in `loop()` instead.
+ * @return True if the scan was started or is waiting for the driver.
+ */
+bool WifiScanStreamer::_startCurrentChannel() {
+  uint8_t channel = CHANNEL_ORDER[_channelIndex];
+  if (WiFi.scanComplete() == WIFI_SCAN_RUNNING) {
+    if (!_waitingForDriver) _channelStartMs = millis();
+    _waitingForDriver = true;
+    DEBUG_TRACE_PRINTF("WifiScanStreamer: Channel %u waits for a running scan.\n", channel);
+    return true;
+  }
+  _waitingForDriver = false;
+  WiFi.scanDelete(); // Results left by an earlier scan must not be read as this channel's.
+  _channelStartMs = millis();
+  int16_t rc = WiFi.scanNetworks(true, false, false, _maxMsPerChannel, channel);
+  if (rc == WIFI_SCAN_FAILED) {
+    DEBUG_WARN_PRINTF("WifiScanStreamer: Could not start scan on channel %u.\n", channel);
+    return false;
+  }
+  DEBUG_TRACE_PRINTF("WifiScanStreamer: Scanning channel %u.\n", channel);
+  return true;
+}
+
+/**
+ * @brief Stops the channel scan of this sweep in the driver and discards its results.
+ * `WiFi.scanDelete()` alone only frees the results and leaves a running scan going. A scan
+ * this sweep is only waiting for is not ours and is left alone.
+ */
+void WifiScanStreamer::_stopChannelScan() {
+  if (_waitingForDriver) {
+    _waitingForDriver = false;
+    return;
+  }
+  if (WiFi.scanComplete() == WIFI_SCAN_RUNNING) esp_wifi_scan_stop();
+  WiFi.scanDelete();
+}
+
+/**
+ * @brief Reads the finished scan results and merges them into `_networks`, filling `_batch`.
+ * Hidden networks are skipped. Each SSID is kept once with its strongest RSSI.
+ * @param count The number of results reported by `WiFi.scanComplete()`.
+ */
+void WifiScanStreamer::_collectResults(int16_t count) {
+  _batch.clear();
+  _batchIndex.clear();
+  for (int16_t i = 0; i < count; ++i) {
+    String ssid = WiFi.SSID(i);
+    if (ssid.length() == 0) continue;
+
+    WifiListItemData item;
+    item.ssid = ssid.c_str();
+    item.rssi = WiFi.RSSI(i);
+    item.encryptionType = WiFi.encryptionType(i);
+
+    int known = _networksIndex.find(item.ssid);
+    if (known < 0) {
+      _networks.push_back(item);
+      _networksIndex.add(_networks.size() - 1);
+    } else if (item.rssi > _networks[known].rssi) {
+      _networks[known] = item;
+    } else {
+      continue; // Already published with an equal or better signal.
+    }
+
+    // Collapse duplicates inside the same batch (several BSSIDs of one SSID on a channel).
+    int queued = _batchIndex.find(item.ssid);
+    if (queued < 0) {
+      _batch.push_back(item);
+      _batchIndex.add(_batch.size() - 1);
+    } else if (item.rssi > _batch[queued].rssi) {
+      _batch[queued] = item;
+    }
+  }
+}
+
+/**
+ * @brief Moves on to the next channel, or finishes the sweep if all channels are done.
+ */
+void WifiScanStreamer::_advance() {
+  _channelIndex++;
+  while (_channelIndex < CHANNEL_ORDER_COUNT) {
+    if (_startCurrentChannel()) return;
+    _channelIndex++;
+  }
+  _finish(_successfulChannels > 0);
+}
+
+/**
+ * @brief Ends the sweep and invokes the sweep-complete callback.
+ * @param success True if the sweep produced usable results.
+ */
+void WifiScanStreamer::_finish(bool success) {
+  _isScanning = false;
+  _waitingForDriver = false;
+  if (_radioScheduler && _radioRequestId) _radioScheduler->complete(_radioRequestId);
+  _radioRequestId = 0;
+  DEBUG_INFO_PRINTF("WifiScanStreamer: Sweep finished (%s, %u networks).\n",
+                    success ? "ok" : "failed", (unsigned)_networks.size());
+  if (_onSweepComplete) {
+    _onSweepComplete(success, _networks);
+  }
+}
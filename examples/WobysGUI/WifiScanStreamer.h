@@ -0,0 +1,202 @@
+/**
+ * @file WifiScanStreamer.h
+ * @brief Defines the WifiScanStreamer class for incremental, per-channel Wi-Fi scanning.
+ *
+ * This class sweeps the 2.4 GHz channels one at a time using asynchronous scans and
+ * publishes the networks found on each channel as soon as that channel finishes.
+ * It allows the Wi-Fi settings screen to populate its list progressively instead of
+ * waiting for a full `WifiManager` scan to complete.
+ *
+ * @version 1.0.0
+ * @date 2025-08-22
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * IMPORTANT NOTE ON THIRD-PARTY LICENSES:
+ * This product incorporates software components licensed under various open-source licenses.
+ * Your use of this product is subject to the terms of these licenses.
+ * Please refer to the accompanying "LICENSES.txt" file for detailed information
+ * on these components, their copyrights, and the obligations required for compliance.
+ */
+#pragma once
+#ifndef WIFI_SCAN_STREAMER_H
+#define WIFI_SCAN_STREAMER_H
+
+#include <Arduino.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Config.h"
+#include "ListItem.h"     // For WifiListItemData
+#include "WifiManager.h"  // For WifiManager and WifiMgr_State_t
+#include "RadioScheduler.h"
+#include "SsidIndex.h"
+
+/**
+ * @brief Performs a channel-by-channel asynchronous Wi-Fi scan and streams partial results.
+ *
+ * A sweep is started with `start()` and advanced from the main loop via `loop()`. Each
+ * channel is scanned with a short dwell time; when it completes, the networks that are
+ * new to this sweep (or whose signal improved) are delivered through the batch callback.
+ * When all channels are done the sweep-complete callback receives the merged result set.
+ *
+ * The streamer only uses the radio while the `WifiManager` is idle (disconnected or
+ * connected) so it never competes with a connection attempt or a manager-driven scan.
+ * When a `RadioScheduler` is set, each sweep is submitted as an interactive Wi-Fi scan
+ * request and only begins once the scheduler grants it.
+ */
+class WifiScanStreamer {
+public:
+  /**
+   * @brief Callback type for a batch of networks discovered or updated on the last scanned channel.
+   * @param batch The networks that are new to the current sweep or whose RSSI improved.
+   */
+  using BatchCallback = std::function<void(const std::vector<WifiListItemData>& batch)>;
+
+  /**
+   * @brief Callback type for the end of a full channel sweep.
+   * @param success True if at least one channel was scanned successfully.
+   * @param networks All networks seen during the sweep (one entry per SSID, strongest RSSI).
+   */
+  using SweepCompleteCallback = std::function<void(bool success, const std::vector<WifiListItemData>& networks)>;
+
+  /**
+   * @brief Constructor for the WifiScanStreamer class.
+   * @param wifiManager Pointer to the WifiManager, used to check whether the radio is free.
+   * @param maxMsPerChannel Active scan dwell time per channel in milliseconds.
+   */
+  WifiScanStreamer(WifiManager* wifiManager,
+                   uint32_t maxMsPerChannel = WIFI_STREAM_SCAN_MS_PER_CHANNEL);
+
+  /**
+   * @brief Starts a new channel sweep, discarding any previous results.
+   * @return True if the sweep was started, false if Wi-Fi is disabled, the manager is busy,
+   *         or the demo scan limit has been reached.
+   */
+  bool start();
+
+  /**
+   * @brief Cancels an ongoing sweep. No further callbacks are invoked for it.
+   */
+  void cancel();
+
+  /**
+   * @brief Advances the sweep. Must be called regularly (e.g. from a layer loop callback).
+   * Collects finished channel scans, publishes batches and starts the next channel.
+   */
+  void loop();
+
+  /**
+   * @brief Checks if a sweep is currently in progress.
+   * @return True if scanning, false otherwise.
+   */
+  bool isScanning() const { return _isScanning; }
+
+  /**
+   * @brief Returns the networks merged so far in the current (or last) sweep.
+   * @return A const reference to the merged network list.
+   */
+  const std::vector<WifiListItemData>& getNetworks() const { return _networks; }
+
+  /**
+   * @brief Sets the callback invoked with each per-channel batch.
+   * @param cb The callback function.
+   */
+  void setOnBatchCallback(BatchCallback cb) { _onBatch = cb; }
+
+  /**
+   * @brief Sets the callback invoked when a sweep finishes.
+   * @param cb The callback function.
+   */
+  void setOnSweepCompleteCallback(SweepCompleteCallback cb) { _onSweepComplete = cb; }
+
+  /**
+   * @brief Routes sweeps through the radio scheduler.
+   * @param scheduler Pointer to the RadioScheduler, or nullptr to scan immediately.
+   */
+  void setRadioScheduler(RadioScheduler* scheduler) { _radioScheduler = scheduler; }
+
+private:
+  WifiManager* _wifiManager;         ///< Pointer to the WifiManager (not owned).
+  uint32_t _maxMsPerChannel;         ///< Active scan dwell time per channel in milliseconds.
+
+  bool _isScanning;                  ///< True while a sweep is in progress.
+  size_t _channelIndex;              ///< Index into the channel order table of the channel being scanned.
+  uint8_t _successfulChannels;       ///< Number of channels that completed without error in this sweep.
+  unsigned long _channelStartMs;     ///< millis() timestamp when the current channel scan was started.
+  bool _waitingForDriver;            ///< True while the current channel waits for a scan that is not ours to end.
+
+  RadioScheduler* _radioScheduler;   ///< Optional radio scheduler (not owned).
+  RadioRequestId _radioRequestId;    ///< Scheduler request of the current sweep (0 if none).
+  bool _awaitingRadio;               ///< True while the sweep waits for the scheduler to grant the radio.
+
+  std::vector<WifiListItemData> _networks; ///< Networks merged over the current sweep.
+  std::vector<WifiListItemData> _batch;    ///< Scratch buffer for the batch being published.
+  SsidIndex<WifiListItemData> _networksIndex; ///< SSID index over `_networks`.
+  SsidIndex<WifiListItemData> _batchIndex;    ///< SSID index over `_batch`.
+
+  BatchCallback _onBatch;                  ///< Callback for per-channel batches.
+  SweepCompleteCallback _onSweepComplete;  ///< Callback for sweep completion.
+
+#ifdef DEMO_MODE
+  int _demoSweepCount = 0;           ///< Number of sweeps started in demo mode.
+#endif
+
+  /**
+   * @brief Checks whether the WifiManager state allows the streamer to use the radio.
+   * @return True if Wi-Fi is enabled and the manager is idle.
+   */
+  bool _isRadioAvailable() const;
+
+  /**
+   * @brief Starts scanning from the first channel that accepts a scan.
+   * @return True if a channel scan was started; otherwise the sweep is finished as failed.
+   */
+  bool _beginChannels();
+
+  /**
+   * @brief Starts the asynchronous scan for the channel at `_channelIndex`, or waits for the
+   * driver if a scan is still running there.
+   * @return True if the scan was started or is waiting for the driver.
+   */
+  bool _startCurrentChannel();
+
+  /**
+   * @brief Stops the channel scan of this sweep in the driver and discards its results.
+   */
+  void _stopChannelScan();
+
+  /**
+   * @brief Reads the finished scan results and merges them into `_networks`, filling `_batch`.
+   * @param count The number of results reported by `WiFi.scanComplete()`.
+   */
+  void _collectResults(int16_t count);
+
+  /**
+   * @brief Moves on to the next channel, or finishes the sweep if all channels are done.
+   */
+  void _advance();
+
+  /**
+   * @brief Ends the sweep and invokes the sweep-complete callback.
+   * @param success True if the sweep produced usable results.
+   */
+  void _finish(bool success);
+};
+
+#endif // WIFI_SCAN_STREAMER_H
@@ -36,7 +36,6 @@
 #include <algorithm>   // For std::min, std::find_if
 #include <cstdio>      // For snprintf
 #include <string>      // For std::string, std::to_string
-#include <set>
 
 // --- Constructor ---
 /**
@@ -62,6 +61,7 @@ WifiUI::WifiUI(LGFX* lcd,
     _settingsManager(settingsManager),
     _statusbarPtr(statusbar),
     _languageManager(languageManager), // Initialize new member variable
+    _wifiEventBridge(nullptr),
     _backButton(lcd, "", 0, 0, 0, 0, &iconic_all2x), // Label set to empty, will be set by _retranslateUI
     _titleText(lcd, "", 0, 0),
     _wifiToggle(lcd, "", "", 0, 0, 0, 0, &helvB12, false),
@@ -69,6 +69,11 @@ WifiUI::WifiUI(LGFX* lcd,
     _statusText(lcd, "", 0, 0),
     _networkList(lcd, 0, 0, 0, 0, 1),
     _passwordKeyboard(lcd, ""), // Title will be set by _retranslateUI
+    _scanStreamer(wifiManager),
+    _lastNetworksMs(0),
+    _lastNetworksValid(false),
+    _refreshingCache(false),
+    _lastNetworksIndex(_lastNetworks),
     _dialogBackground(lcd, "", 0, 0),
     _dialogQuestion(lcd, "", 0, 0),
     _dialogSsid(lcd, "", 0, 0),
@@ -96,19 +101,36 @@ void WifiUI::init() {
   // Register for language change notifications
   _languageManager->registerForUpdate("WifiUI", [this]() { this->_retranslateUI(); });
 
-  // Setup manager callbacks
-  _wifiManager->setOnScanCompleteCallback(
+  // Setup manager callbacks (through the event bridge when the manager runs on its own task)
+  WifiManager::ScanCompleteCallback onScanComplete =
     [this](bool success, const std::vector<WifiListItemData>& networks) {
       this->_handleScanComplete(success, networks);
-    });
-  _wifiManager->setOnConnectionStateChangedCallback(
+    };
+  WifiManager::ConnectionStateCallback onStateChanged =
     [this](WifiMgr_State_t state,
            const std::string& ssid,
            const std::string& ip) {
       this->_handleWifiStateChange(state, ssid, ip);
+    };
+  WifiManager::RssiChangeCallback onRssiChanged = [this](int32_t rssi) {
+  };
+  if (_wifiEventBridge) {
+    _wifiEventBridge->setOnScanCompleteCallback(onScanComplete);
+    _wifiEventBridge->setOnConnectionStateChangedCallback(onStateChanged);
+    _wifiEventBridge->setOnRssiChangeCallback(onRssiChanged);
+  } else {
+    _wifiManager->setOnScanCompleteCallback(onScanComplete);
+    _wifiManager->setOnConnectionStateChangedCallback(onStateChanged);
+    _wifiManager->setOnRssiChangeCallback(onRssiChanged);
+  }
+  _scanStreamer.setOnBatchCallback(
+    [this](const std::vector<WifiListItemData>& batch) {
+      this->_handleScanBatch(batch);
+    });
+  _scanStreamer.setOnSweepCompleteCallback(
+    [this](bool success, const std::vector<WifiListItemData>& networks) {
+      this->_handleScanSweepComplete(success, networks);
     });
-  _wifiManager->setOnRssiChangeCallback([this](int32_t rssi) {
-  });
 
   // --- Wi-Fi Settings Layer ("wifi_settings_layer") ---
   _screenManager->defineLayer("wifi_settings_layer",
@@ -122,6 +144,12 @@ void WifiUI::init() {
     DEBUG_ERROR_PRINTLN("WifiUI: Failed to create or retrieve 'wifi_settings_layer'. Initialization aborted.");
     return;
   }
+  // The streamed scan is advanced from the layer loop, so it only runs while the panel is shown.
+  // It takes the bridge lock itself, like the touch handlers, instead of relying on the main loop holding it.
+  layer->setOnLoopCallback([this]() {
+    WifiEventBridge::ScopedLock wifiLock(_wifiEventBridge);
+    this->_scanStreamer.loop();
+  });
 
   uint16_t layerWidth = TFT_HEIGHT; // Consider using _lcd->width() / _lcd->height()
   uint16_t layerHeight = TFT_WIDTH - STATUSBAR_HEIGHT;
@@ -311,6 +339,7 @@ void WifiUI::_retranslateUI() {
         DEBUG_ERROR_PRINTLN("WifiUI: LanguageManager pointer is null. Cannot retranslate UI.");
         return;
     }
+    WifiEventBridge::ScopedLock wifiLock(_wifiEventBridge);
     _passwordKeyboard.setTitle(_languageManager->getString("KEYBOARD_PASSWORD_TITLE", "Password:"));
     _backButton.setLabel(_languageManager->getString("PANEL_BUTTON_BACK", "\xC3\xBA")); // Back arrow character
     _titleText.setText(_languageManager->getString("WIFI_SETTINGS_TITLE", "Wi-Fi Settings"));
@@ -319,6 +348,9 @@ void WifiUI::_retranslateUI() {
     _dialogQuestion.setText(_languageManager->getString("WIFI_DELETE_DIALOG_QUESTION", "Are you sure you want to delete password for?"));
     _dialogYesButton.setLabel(_languageManager->getString("WIFI_DELETE_DIALOG_YES", "Yes"));
     _dialogNoButton.setLabel(_languageManager->getString("WIFI_DELETE_DIALOG_NO", "No"));
+    _iconLockOpen = _languageManager->getString("ICON_LOCK_OPEN", "\u00CB");
+    _iconLockClosed = _languageManager->getString("ICON_LOCK_CLOSED", "\u00CA");
+    _textDeleteAction = _languageManager->getString("TEXT_DELETE_ACTION", "X");
 
     // Retrieve the actual last scanned networks from WifiManager to repopulate the list with the new language.
     //const std::vector<WifiListItemData>& lastNetworks = _wifiManager->getLastScannedNetworks();
@@ -375,14 +407,27 @@ void WifiUI::proceedToOpenPanel() {
       DEBUG_ERROR_PRINTLN("WifiUI: ScreenManager, WifiManager, or LanguageManager pointer is null. Cannot proceed to open panel.");
       return;
   }
+  WifiEventBridge::ScopedLock wifiLock(_wifiEventBridge);
 
   bool actualWifiLogicState = _wifiManager->isWifiLogicEnabled();
   _wifiToggle.setState(actualWifiLogicState, false);
   _screenManager->pushLayer("wifi_settings_layer");
 
   if (actualWifiLogicState) {
+    // Show the last results right away; the radio is only used again once they are stale.
+    if (_lastNetworksValid && !_lastNetworks.empty()) {
+      _handleScanComplete(true, _lastNetworks);
+      if (millis() - _lastNetworksMs < WIFI_SCAN_CACHE_TTL_MS) {
+        DEBUG_INFO_PRINTLN("WifiUI::proceedToOpenPanel: Showing cached scan results.");
+        return;
+      }
+      if (!_startNetworkScan(true)) {
+        DEBUG_INFO_PRINTLN("WifiUI::proceedToOpenPanel: Cached results are stale, but no refresh scan can be started now.");
+      }
+      return;
+    }
     // If scanning cannot be started, indicate in status text.
-    if (!_wifiManager->startScan()) {
+    if (!_startNetworkScan()) {
         DEBUG_WARN_PRINTLN("WifiUI::proceedToOpenPanel: Scan cannot be started.");
         _statusText.setText(_languageManager->getString("STATUS_SCAN_NOT_POSSIBLE", "Scan not possible.")); // Feedback to user
     }
@@ -403,6 +448,7 @@ void WifiUI::_closePanel() {
       DEBUG_ERROR_PRINTLN("WifiUI: ScreenManager pointer is null. Cannot close panel.");
       return;
   }
+  _scanStreamer.cancel(); // Release the radio; a new sweep starts when the panel is reopened.
   _screenManager->popLayer();
 }
 
@@ -416,10 +462,12 @@ void WifiUI::_onToggleChanged(bool newState) {
       DEBUG_ERROR_PRINTLN("WifiUI: WifiManager or SettingsManager pointer is null. Cannot change Wi-Fi toggle state.");
       return;
   }
+  WifiEventBridge::ScopedLock wifiLock(_wifiEventBridge);
   if (newState) {
     _wifiManager->enableWifi(true);
   } else {
     _wifiManager->disableWifi();
+    _lastNetworksValid = false; // Results from before the radio was off are not reused.
   }
   _settingsManager->setWifiEnabledLastState(newState); // UI saves the state
 }
@@ -433,10 +481,11 @@ void WifiUI::_onScanButtonPressed() {
       DEBUG_ERROR_PRINTLN("WifiUI: WifiManager or LanguageManager pointer is null. Cannot start scan.");
       return;
   }
+  WifiEventBridge::ScopedLock wifiLock(_wifiEventBridge);
 
   if (_wifiManager->isWifiLogicEnabled()) {
-    // If startScan returns false, indicate this in the status text.
-    if (!_wifiManager->startScan()) {
+    // If no scan could be started, indicate this in the status text.
+    if (!_startNetworkScan()) {
         _statusText.setText(_languageManager->getString("STATUS_SCAN_NOT_POSSIBLE", "Scan not possible."));
     }
   } else {
@@ -459,6 +508,7 @@ void WifiUI::_onNetworkSelected(int index,
       DEBUG_ERROR_PRINTLN("WifiUI: One or more essential pointers are null. Cannot handle network selection.");
       return;
   }
+  WifiEventBridge::ScopedLock wifiLock(_wifiEventBridge);
 
   if (data.columns.empty()) {
     _statusText.setText(_languageManager->getString("STATUS_AMBIGUOUS_DATA", "Error: Ambiguous data."));
@@ -547,6 +597,7 @@ void WifiUI::_onPasswordEntered(const std::string& textFromKeyboard) {
       DEBUG_ERROR_PRINTLN("WifiUI: One or more essential pointers are null. Cannot handle password entry.");
       return;
   }
+  WifiEventBridge::ScopedLock wifiLock(_wifiEventBridge);
 
   // Handle escape (cancel) from keyboard
   if (textFromKeyboard == KEYBOARD_ESCAPE_BUTTON_ACTION_STRING) {
@@ -639,6 +690,7 @@ void WifiUI::_onConfirmYes() {
       DEBUG_ERROR_PRINTLN("WifiUI: One or more essential pointers are null. Cannot confirm network deletion.");
       return;
   }
+  WifiEventBridge::ScopedLock wifiLock(_wifiEventBridge);
 
   std::string ssidToForget = _ssidToForget;
   _screenManager->popLayer(); // Close dialog layer
@@ -659,47 +711,25 @@ void WifiUI::_onConfirmYes() {
         _wifiManager->disconnectFromNetwork(); // Disconnect if it was the active network
       }
 
-      // This section duplicates logic found in _handleScanComplete() or a dedicated list builder.
       std::vector<ListItem> uiListItems;
-      const auto& lastScannedNetworks = _wifiManager->getLastScannedNetworks(); // Get the last scan results
-      auto currentSavedNetworks = _settingsManager->getSavedNetworks(); // Get the *current* saved networks (after deletion)
-      std::set<std::string> addedSsids; // To avoid duplicate entries if a network is both scanned and saved
-
-      // 1. Add all networks from the last scanned list
-      for (const auto& netMgrData : lastScannedNetworks) {
-          ListItem uiItem;
-          uiItem.columns.push_back(ColumnData(netMgrData.ssid));
-          std::string encryptionChar =
-              (netMgrData.encryptionType == WIFI_AUTH_OPEN) ? _languageManager->getString("ICON_LOCK_OPEN", "\u00CB") : _languageManager->getString("ICON_LOCK_CLOSED", "\u00CA");
-          uiItem.columns.push_back(ColumnData(encryptionChar));
-          char signalStrengthChar = _mapRssiToIcon(netMgrData.rssi);
-          uiItem.columns.push_back(ColumnData(std::string(1, signalStrengthChar)));
-
-          std::string deleteActionText = "";
-          // Check if this scanned network has a currently saved password (after deletion)
-          for (const auto& savedNet : currentSavedNetworks) {
-              if (savedNet.ssid == netMgrData.ssid && !savedNet.password.empty()) {
-                  deleteActionText = _languageManager->getString("TEXT_DELETE_ACTION", "X");
-                  break;
-              }
-          }
-          uiItem.columns.push_back(ColumnData(deleteActionText));
-          uiListItems.push_back(uiItem);
-          addedSsids.insert(netMgrData.ssid); // Mark this SSID as added
+      const auto& currentSavedNetworks = _settingsManager->getSavedNetworks(); // The *current* saved networks (after deletion)
+      SsidIndex<SavedWifiNetwork> savedIndex(currentSavedNetworks);
+      savedIndex.rebuild();
+      uiListItems.reserve(_lastNetworks.size() + currentSavedNetworks.size());
+
+      // 1. Add all networks from the last scanned list (streamed or from WifiManager)
+      for (const auto& netMgrData : _lastNetworks) {
+          int saved = savedIndex.find(netMgrData.ssid);
+          uiListItems.push_back(_buildNetworkListItem(
+              netMgrData, saved >= 0 && !currentSavedNetworks[saved].password.empty()));
       }
 
       // 2. Add any saved networks that were *not* present in the last scanned list (e.g., out of range)
       //    This is important to ensure saved but currently unseen networks also show up.
       for (const auto& savedNet : currentSavedNetworks) {
-          if (addedSsids.find(savedNet.ssid) == addedSsids.end()) { // If not already added from scanned list
-              ListItem uiItem;
-              uiItem.columns.push_back(ColumnData(savedNet.ssid));
-              uiItem.columns.push_back(ColumnData(_languageManager->getString("ICON_LOCK_CLOSED", "\u00CA")));
-              uiItem.columns.push_back(ColumnData(" ")); // No RSSI for unseen saved networks
+          if (_lastNetworksIndex.find(savedNet.ssid) < 0) {
               // Only show 'X' for saved networks if they actually have a password
-              uiItem.columns.push_back(ColumnData(savedNet.password.empty() ? "" : _languageManager->getString("TEXT_DELETE_ACTION", "X")));
-              uiListItems.push_back(uiItem);
-              // No need to insert into addedSsids here, as this is the last step for list building for this function.
+              uiListItems.push_back(_buildSavedNetworkListItem(savedNet, !savedNet.password.empty()));
           }
       }
 
@@ -857,7 +887,7 @@ void WifiUI::_handleWifiStateChange(WifiMgr_State_t newState,
         _settingsManager->addOrUpdateSavedNetwork(
           _g_ssidToConnectAfterScan, _g_passwordForConnectionAfterScan);
         if (wifiPanelIsActive) {
-          _handleScanComplete(true, _wifiManager->getLastScannedNetworks());
+          _handleScanComplete(true, _lastNetworks);
         }
       }
       // Reset pending connection flags
@@ -946,47 +976,162 @@ void WifiUI::_handleScanComplete(
       return;
   }
 
-  WifiMgr_State_t currentState = _wifiManager->getCurrentState(); // Get current state for conditional logic.
-
   std::vector<ListItem> uiListItems;
-  auto savedNetworks = _settingsManager->getSavedNetworks(); // Retrieve saved networks
+  const auto& savedNetworks = _settingsManager->getSavedNetworks(); // Retrieve saved networks
 
   if (success) {
-    for (const auto& netMgrData : networksFromManager) {
-      ListItem uiItem;
-      uiItem.columns.push_back(ColumnData(netMgrData.ssid));
-      // Determine encryption icon
-      std::string encryptionChar =
-        (netMgrData.encryptionType == WIFI_AUTH_OPEN) ? _languageManager->getString("ICON_LOCK_OPEN", "\u00CB") : _languageManager->getString("ICON_LOCK_CLOSED", "\u00CA");
-      uiItem.columns.push_back(ColumnData(encryptionChar));
-      // Map RSSI to signal strength icon
-      char signalStrengthChar = _mapRssiToIcon(netMgrData.rssi);
-      uiItem.columns.push_back(ColumnData(std::string(1, signalStrengthChar)));
-      std::string deleteActionText = "";
-      // Check if network is saved and has a password (for "X" delete icon)
-      for (const auto& savedNet : savedNetworks) {
-        if (savedNet.ssid == netMgrData.ssid && !savedNet.password.empty()) {
-          deleteActionText = _languageManager->getString("TEXT_DELETE_ACTION", "X");
-          break;
-        }
-      }
-      uiItem.columns.push_back(ColumnData(deleteActionText));
-      uiListItems.push_back(uiItem);
+    if (&networksFromManager != &_lastNetworks) {
+      _setLastNetworks(networksFromManager); // Remember what the list is built from (one row per SSID)
+      _lastNetworksMs = millis();
+      _lastNetworksValid = true;
+    }
+    SsidIndex<SavedWifiNetwork> savedIndex(savedNetworks);
+    savedIndex.rebuild();
+    uiListItems.reserve(_lastNetworks.size());
+    for (const auto& netMgrData : _lastNetworks) {
+      int saved = savedIndex.find(netMgrData.ssid);
+      uiListItems.push_back(_buildNetworkListItem(netMgrData, saved >= 0 && !savedNetworks[saved].password.empty()));
     }
   } else { // Scan failed
       if (_wifiManager->isWifiLogicEnabled()) {
+        uiListItems.reserve(savedNetworks.size());
         for (const auto& savedNet : savedNetworks) {
-            ListItem uiItem;
-            uiItem.columns.push_back(ColumnData(savedNet.ssid));
-            uiItem.columns.push_back(ColumnData(_languageManager->getString("ICON_LOCK_CLOSED", "\u00CA")));
-            uiItem.columns.push_back(ColumnData(" ")); // No RSSI, so empty.
-            uiItem.columns.push_back(ColumnData(_languageManager->getString("TEXT_DELETE_ACTION", "X"))); // Saved, so 'X'.
-            uiListItems.push_back(uiItem);
+            uiListItems.push_back(_buildSavedNetworkListItem(savedNet, true)); // Saved, so 'X'.
         }
       }
   }
 
   _networkList.setItems(uiListItems); // Update UI list - this will likely clear selection internally
+  _finalizeScanPresentation(success, success ? _lastNetworks.size() : networksFromManager.size(), uiListItems.size());
+}
+
+/**
+ * @brief Handles a batch of networks streamed by `WifiScanStreamer` after a channel completes.
+ * Rows are matched by SSID and updated in place; unknown SSIDs are appended, so the list
+ * grows while the sweep is still running instead of appearing all at once at the end.
+ * @param batch Networks that are new to the current sweep or whose signal improved.
+ */
+void WifiUI::_handleScanBatch(const std::vector<WifiListItemData>& batch) {
+  if (!_settingsManager || !_languageManager || !_wifiManager) { // Null pointer checks
+      DEBUG_ERROR_PRINTLN("WifiUI: One or more essential pointers are null. Cannot handle scan batch.");
+      return;
+  }
+
+  const auto& savedNetworks = _settingsManager->getSavedNetworks();
+  SsidIndex<SavedWifiNetwork> savedIndex(savedNetworks);
+  savedIndex.rebuild();
+  const std::string connectedSsid =
+    (_wifiManager->getCurrentState() == WifiMgr_State_t::CONNECTED) ? _wifiManager->getConnectedSsid() : "";
+
+  for (const auto& net : batch) {
+    int saved = savedIndex.find(net.ssid);
+    ListItem row = _buildNetworkListItem(net, saved >= 0 && !savedNetworks[saved].password.empty());
+
+    // Rows are normally built in `_lastNetworks` order, so the index gives the row directly;
+    // fall back to a search if the list was built from something else (e.g. saved networks).
+    const auto& items = _networkList.getItems();
+    int known = _lastNetworksIndex.find(net.ssid);
+    int rowIndex = -1;
+    if (known >= 0 && known < static_cast<int>(items.size()) &&
+        !items[known].columns.empty() && items[known].columns[0].text == net.ssid) {
+      rowIndex = known;
+    } else {
+      for (int i = 0; i < static_cast<int>(items.size()); ++i) {
+        if (!items[i].columns.empty() && items[i].columns[0].text == net.ssid) {
+          rowIndex = i;
+          break;
+        }
+      }
+    }
+
+    if (rowIndex >= 0) {
+      _networkList.updateItem(rowIndex, row);
+    } else {
+      _networkList.addItem(row);
+      rowIndex = static_cast<int>(_networkList.getItems().size()) - 1;
+    }
+
+    if (known >= 0) {
+      _lastNetworks[known] = net;
+    } else {
+      _lastNetworks.push_back(net);
+      _lastNetworksIndex.add(_lastNetworks.size() - 1);
+    }
+
+    // Keep the connected network highlighted as soon as its row appears.
+    if (!connectedSsid.empty() && net.ssid == connectedSsid) {
+      _networkList.setSelectedItemIndex(rowIndex, true);
+    }
+  }
+  DEBUG_TRACE_PRINTF("WifiUI: Scan batch merged (%u networks, %u rows).\n",
+                     (unsigned)batch.size(), (unsigned)_networkList.getItems().size());
+}
+
+/**
+ * @brief Handles the end of a `WifiScanStreamer` sweep.
+ * The rows are already in place from the batches, so only the status and any pending
+ * connect-after-scan request need to be handled here.
+ * @param success True if the sweep produced results.
+ * @param networks All networks found during the sweep.
+ */
+void WifiUI::_handleScanSweepComplete(bool success,
+                                      const std::vector<WifiListItemData>& networks) {
+  bool refreshedCache = _refreshingCache;
+  _refreshingCache = false;
+  if (!success) {
+    if (refreshedCache) { // Keep showing the cached rows.
+      _finalizeScanPresentation(true, _lastNetworks.size(), _networkList.getItems().size());
+      return;
+    }
+    _handleScanComplete(false, networks); // Falls back to listing saved networks.
+    return;
+  }
+  _setLastNetworks(networks);
+  _lastNetworksMs = millis();
+  _lastNetworksValid = true;
+  if (refreshedCache) {
+    // Cached rows of networks that are no longer visible were kept during the sweep; rebuild.
+    _handleScanComplete(true, _lastNetworks);
+    return;
+  }
+  _finalizeScanPresentation(true, networks.size(), _networkList.getItems().size());
+}
+
+/**
+ * @brief Starts a network scan, preferring the incremental streamer and falling back
+ * to a regular `WifiManager` scan if the radio is busy.
+ * @param keepRows True to keep the rows currently shown (cached results) until the sweep completes.
+ * @return True if either scan could be started.
+ */
+bool WifiUI::_startNetworkScan(bool keepRows) {
+  if (!_wifiManager || !_languageManager) { // Null pointer checks
+      DEBUG_ERROR_PRINTLN("WifiUI: WifiManager or LanguageManager pointer is null. Cannot start network scan.");
+      return false;
+  }
+
+  if (_scanStreamer.start()) {
+    _refreshingCache = keepRows;
+    if (!keepRows) {
+      _lastNetworks.clear();
+      _lastNetworksIndex.clear();
+      _lastNetworksValid = false; // Until this sweep completes.
+      _networkList.clearItems();
+    }
+    _statusText.setText(_languageManager->getString("STATUS_SCANNING", "Scanning networks..."));
+    return true;
+  }
+  // Streamer unavailable (manager busy or demo limit); let the manager run its regular scan.
+  return _wifiManager->startScan();
+}
+
+/**
+ * @brief Updates the status text, selection and any pending connect-after-scan once a scan has finished.
+ * @param success True if the scan was successful.
+ * @param scannedCount Number of networks reported by the scan.
+ * @param itemCount Number of rows currently in the list.
+ */
+void WifiUI::_finalizeScanPresentation(bool success, size_t scannedCount, size_t itemCount) {
+  WifiMgr_State_t currentState = _wifiManager->getCurrentState(); // Get current state for conditional logic.
 
   // Update status message based on scan success and results
   if (!success) {
@@ -996,7 +1141,7 @@ void WifiUI::_handleScanComplete(
     if (currentState != WifiMgr_State_t::CONNECTING && currentState != WifiMgr_State_t::CONNECTED) {
         _networkList.setSelectedItemIndex(-1, true); // Deselect items only if not connecting/connected
     }
-  } else if (networksFromManager.empty() && uiListItems.empty()) { // If no items from scan, nor from saved list.
+  } else if (scannedCount == 0 && itemCount == 0) { // If no items from scan, nor from saved list.
     _statusText.setText(_wifiManager->isWifiLogicEnabled()
                           ? _languageManager->getString("STATUS_NO_NETWORKS_FOUND", "No networks found.")
                           : _languageManager->getString("STATUS_DISABLED", "Wi-Fi disabled."));
@@ -1008,7 +1153,7 @@ void WifiUI::_handleScanComplete(
     // If connected or connecting, do not overwrite connection status message
     if (currentState != WifiMgr_State_t::CONNECTED &&
         currentState != WifiMgr_State_t::CONNECTING) {
-      _statusText.setText(std::to_string(uiListItems.size()) +
+      _statusText.setText(std::to_string(itemCount) +
                           _languageManager->getString("TEXT_NETWORKS_FOUND_COUNT", " networks found."));
     }
   }
@@ -1026,14 +1171,56 @@ void WifiUI::_handleScanComplete(
 }
 
 /**
- * @brief Maps an RSSI (Received Signal Strength Indication) value to a character icon.
- * @param rssi The RSSI value.
- * @return A character representing the signal strength icon.
+ * @brief Builds the list row for a scanned network.
+ * @param net The scanned network data.
+ * @param hasSavedPassword True if a password is saved for the network (shows the delete action).
+ * @return The populated ListItem.
+ */
+ListItem WifiUI::_buildNetworkListItem(const WifiListItemData& net, bool hasSavedPassword) {
+  ListItem uiItem;
+  uiItem.columns.reserve(4);
+  uiItem.columns.push_back(ColumnData(net.ssid));
+  // Encryption icon
+  uiItem.columns.push_back(ColumnData(net.encryptionType == WIFI_AUTH_OPEN ? _iconLockOpen : _iconLockClosed));
+  // Map RSSI to signal strength icon
+  char signalStrengthChar = mapRssiToSignalIcon(net.rssi);
+  uiItem.columns.push_back(ColumnData(std::string(1, signalStrengthChar)));
+  // "X" delete icon for networks with a saved password
+  uiItem.columns.push_back(ColumnData(hasSavedPassword ? _textDeleteAction : std::string()));
+  return uiItem;
+}
+
+/**
+ * @brief Builds the list row for a saved network that was not seen by the last scan.
+ * @param savedNet The saved network.
+ * @param showDeleteAction True to show the delete action.
+ * @return The populated ListItem.
  */
-char WifiUI::_mapRssiToIcon(int32_t rssi) {
-  if (rssi >= -55) return 'f'; // Strongest signal
-  if (rssi >= -65) return 'e';
-  if (rssi >= -75) return 'd';
-  if (rssi >= -85) return 'c';
-  return 'b'; // Weakest signal
+ListItem WifiUI::_buildSavedNetworkListItem(const SavedWifiNetwork& savedNet, bool showDeleteAction) {
+  ListItem uiItem;
+  uiItem.columns.reserve(4);
+  uiItem.columns.push_back(ColumnData(savedNet.ssid));
+  uiItem.columns.push_back(ColumnData(_iconLockClosed));
+  uiItem.columns.push_back(ColumnData(" ")); // No RSSI for unseen saved networks
+  uiItem.columns.push_back(ColumnData(showDeleteAction ? _textDeleteAction : std::string()));
+  return uiItem;
+}
+
+/**
+ * @brief Replaces `_lastNetworks` with scan results, keeping one entry (the strongest BSSID) per SSID.
+ * @param networks The scan results, possibly with several entries per SSID.
+ */
+void WifiUI::_setLastNetworks(const std::vector<WifiListItemData>& networks) {
+  _lastNetworks.clear();
+  _lastNetworksIndex.clear();
+  _lastNetworks.reserve(networks.size());
+  for (const auto& net : networks) {
+    int known = _lastNetworksIndex.find(net.ssid);
+    if (known < 0) {
+      _lastNetworks.push_back(net);
+      _lastNetworksIndex.add(_lastNetworks.size() - 1);
+    } else if (net.rssi > _lastNetworks[known].rssi) {
+      _lastNetworks[known] = net;
+    }
+  }
 }
\ No newline at end of file
@@ -43,6 +43,9 @@
 #include "SettingsManager.h"
 #include "StatusbarUI.h"
 #include "LanguageManager.h"
+#include "WifiScanStreamer.h"
+#include "WifiEventBridge.h"
+#include "SsidIndex.h"
 
 // UI elements includes
 #include "ButtonUI.h"
@@ -68,6 +71,7 @@ private:
   SettingsManager* _settingsManager;     ///< Pointer to the SettingsManager for persistent settings.
   StatusbarUI* _statusbarPtr;           ///< Pointer to the StatusbarUI for status bar interaction.
   LanguageManager* _languageManager;     ///< Pointer to the LanguageManager for UI internationalization.
+  WifiEventBridge* _wifiEventBridge;     ///< Optional bridge delivering WifiManager events on the UI task (nullptr = register on the manager).
 
   // --- UI Elements ---
   ButtonUI _backButton;      ///< Button to navigate back from the Wi-Fi settings screen.
@@ -78,6 +82,19 @@ private:
   ClickableListUI _networkList; ///< List to display available and saved Wi-Fi networks.
   KeyboardUI _passwordKeyboard; ///< Virtual keyboard for entering Wi-Fi passwords.
 
+  // --- Incremental Scanning ---
+  WifiScanStreamer _scanStreamer;                ///< Per-channel scanner that streams results into the list while the panel is open.
+  std::vector<WifiListItemData> _lastNetworks;   ///< Most recent scan results shown in the list (streamed or from WifiManager).
+  unsigned long _lastNetworksMs;                 ///< millis() timestamp of the scan that completed `_lastNetworks`.
+  bool _lastNetworksValid;                       ///< True if `_lastNetworks` holds a completed scan that may be reused.
+  bool _refreshingCache;                         ///< True while a sweep refreshes rows that were shown from the cache.
+  SsidIndex<WifiListItemData> _lastNetworksIndex; ///< SSID index over `_lastNetworks` (one entry per SSID).
+
+  // --- Translated Row Icons (refreshed by _retranslateUI, not looked up per row) ---
+  std::string _iconLockOpen;                     ///< Encryption column text for open networks.
+  std::string _iconLockClosed;                   ///< Encryption column text for protected networks.
+  std::string _textDeleteAction;                 ///< Action column text for networks with a saved password.
+
   // --- Confirmation Dialog Elements ---
   TextUI _dialogBackground;   ///< Background panel for the confirmation dialog.
   TextUI _dialogQuestion;     ///< Text label for the question in the dialog.
@@ -183,11 +200,58 @@ private:
                            const std::vector<WifiListItemData>& networks);
 
   /**
-   * @brief Maps an RSSI (Received Signal Strength Indication) value to a character icon.
-   * @param rssi The RSSI value.
-   * @return A character representing the signal strength icon.
+   * @brief Handles a batch of networks streamed by `WifiScanStreamer` after a channel completes.
+   * Adds new rows or updates existing ones in place without rebuilding the whole list.
+   * @param batch Networks that are new to the current sweep or whose signal improved.
+   */
+  void _handleScanBatch(const std::vector<WifiListItemData>& batch);
+
+  /**
+   * @brief Handles the end of a `WifiScanStreamer` sweep.
+   * @param success True if the sweep produced results.
+   * @param networks All networks found during the sweep.
+   */
+  void _handleScanSweepComplete(bool success,
+                                const std::vector<WifiListItemData>& networks);
+
+  /**
+   * @brief Starts a network scan, preferring the incremental streamer and falling back
+   * to a regular `WifiManager` scan if the radio is busy.
+   * @param keepRows True to keep the rows currently shown (cached results) until the sweep completes.
+   * @return True if either scan could be started.
+   */
+  bool _startNetworkScan(bool keepRows = false);
+
+  /**
+   * @brief Updates the status text, selection and any pending connect-after-scan once a scan has finished.
+   * @param success True if the scan was successful.
+   * @param scannedCount Number of networks reported by the scan.
+   * @param itemCount Number of rows currently in the list.
+   */
+  void _finalizeScanPresentation(bool success, size_t scannedCount, size_t itemCount);
+
+  /**
+   * @brief Builds the list row for a scanned network.
+   * @param net The scanned network data.
+   * @param hasSavedPassword True if a password is saved for the network (shows the delete action).
+   * @return The populated ListItem.
    */
-  static char _mapRssiToIcon(int32_t rssi);
+  ListItem _buildNetworkListItem(const WifiListItemData& net, bool hasSavedPassword);
+
+  /**
+   * @brief Builds the list row for a saved network that was not seen by the last scan.
+   * @param savedNet The saved network.
+   * @param showDeleteAction True to show the delete action.
+   * @return The populated ListItem.
+   */
+  ListItem _buildSavedNetworkListItem(const SavedWifiNetwork& savedNet, bool showDeleteAction);
+
+  /**
+   * @brief Replaces `_lastNetworks` with scan results, keeping one entry (the strongest BSSID) per SSID.
+   * @param networks The scan results, possibly with several entries per SSID.
+   */
+  void _setLastNetworks(const std::vector<WifiListItemData>& networks);
+
 
 public:
   /**
@@ -214,6 +278,20 @@ public:
    */
   void init();
 
+  /**
+   * @brief Routes the WifiManager callbacks through the given event bridge.
+   * Must be called before `init()` when the manager runs on its own task, because the
+   * bridge owns the manager callbacks in that case.
+   * @param bridge Pointer to the WifiEventBridge instance.
+   */
+  void setWifiEventBridge(WifiEventBridge* bridge) { _wifiEventBridge = bridge; }
+
+  /**
+   * @brief Routes the streamed network scans through the radio scheduler.
+   * @param scheduler Pointer to the RadioScheduler instance.
+   */
+  void setRadioScheduler(RadioScheduler* scheduler) { _scanStreamer.setRadioScheduler(scheduler); }
+
   /**
    * @brief Opens the Wi-Fi settings panel.
    * This method handles the transition to the Wi-Fi screen, ensuring proper status bar panel closure
@@ -66,6 +66,22 @@
 #include "LanguageManager.h"
 #include "AudioManager.h"
 #include "SDManager.h"
+#include "WifiFastReconnect.h"
+#include "WifiEventBridge.h"
+#include "RadioScheduler.h"
+#include "BleNotifyPipeline.h"
+#include "WifiPowerPolicy.h"
+#include "RemoteUiMirror.h"
+#include "OtaUpdater.h"
+#include "TelemetryPublisher.h"
+#include "TimerWheel.h"
+#include "ManagerTaskHost.h"
+#include "LoopBudgetMonitor.h"
+#include "CpuFrequencyGovernor.h"
+#include "IdleSleepController.h"
+#include "DisplaySleepController.h"
+#include "Coroutine.h"
+#include "ShutdownOrchestrator.h"
 
 // Specific UI Element Classes (headers are needed here for global object instantiation)
 #include "ClockLabelUI.h"
@@ -103,10 +119,24 @@ RFIDManager rfidManager;                                                     ///
 LanguageManager languageManager;                                             ///< Manages multi-language support
 AudioManager audioManager(&settingsManager);                                 ///< Manages audio output
 SDManager sdManager(&settingsManager);                                       ///< Manages SD card operations
+WifiFastReconnect wifiFastReconnect(&wifiManager, &settingsManager);         ///< Directed reconnect to the cached access point of saved networks
+WifiEventBridge wifiEventBridge(&wifiManager);                               ///< Runs the WifiManager on its own event-driven task
+RadioScheduler radioScheduler;                                               ///< Time-slices the shared 2.4 GHz radio between Wi-Fi and BLE
+BleNotifyPipeline bleNotifyPipeline(&btManager);                             ///< Streams GATT notifications of the connected BLE device
 
 // Screen Saver Components
 ClockLabelUI screenSaverClock(&lcd, "00:00", 0, 0, &helvB24, UI_COLOR_TEXT_DEFAULT, MC_DATUM, 150, 40); ///< Clock UI element for screensaver
 ScreenSaverManager screenSaverManager(&lcd, &screenManager, &statusbar, &timeManager, &screenSaverClock); ///< Manages screen saver activation and animations
+WifiPowerPolicy wifiPowerPolicy(&wifiManager, &btManager, &powerManager, &screenSaverManager); ///< Selects the Wi-Fi modem power-save mode from presence, traffic and battery
+RemoteUiMirror remoteUiMirror(&lcd, &wifiManager);                           ///< Streams the UI over WebSocket and injects remote touches
+OtaUpdater otaUpdater(&wifiManager, &languageManager);                       ///< Installs firmware images into the inactive app slot
+TelemetryPublisher telemetryPublisher(&wifiManager, &powerManager);          ///< Publishes batched device health over MQTT
+ManagerTaskHost managerTaskHost(&powerManager, &rfidManager);                ///< Runs battery sampling and RFID polling on their own tasks
+LoopBudgetMonitor loopBudget;                                                ///< Times every subsystem tick of loop() against its budget
+CpuFrequencyGovernor cpuGovernor(&screenSaverManager, &audioManager);        ///< Lowers the CPU clock while the UI is idle
+IdleSleepController idleSleep(&lcd, &screenSaverManager, &audioManager, &cpuGovernor, &wifiManager, &btManager); ///< Waits for the touch interrupt (in light sleep) while the screensaver idles
+DisplaySleepController displaySleep(&lcd, &screenSaverManager);              ///< Backlight off and panel sleep after a longer screensaver period
+ShutdownOrchestrator shutdownOrchestrator;                                   ///< Runs the shutdown steps of the subsystems in dependency order
 
 // High-Level UI Controllers (Screens)
 BLEUI btUI(&lcd, &screenManager, &btManager, &statusbar, &languageManager, &settingsManager); ///< Bluetooth UI screen controller
@@ -121,7 +151,10 @@ SystemInitializer initializer(
     &lcd, &screenManager, &statusbar, &settingsManager, &wifiManager, &timeManager,
     &btManager, &powerManager, &rfidManager, &screenSaverManager, &screenSaverClock,
     &btUI, &wifiUI, &mainUI, &languageManager, &settingsUI, &audioManager,
-    &sdManager
+    &sdManager, &wifiFastReconnect, &wifiEventBridge, &radioScheduler,
+    &bleNotifyPipeline, &wifiPowerPolicy, &remoteUiMirror,
+    &otaUpdater, &telemetryPublisher, &managerTaskHost,
+    &loopBudget, &cpuGovernor, &idleSleep, &displaySleep
 );
 
 
@@ -174,6 +207,16 @@ void openSettingsScreen() {
   settingsUI.openPanel();
 }
 
+/**
+ * @brief Tells the Arduino core not to confirm a freshly installed firmware image at boot.
+ * The OtaUpdater confirms it once the system has been operational for a while; until then
+ * a reset makes the bootloader roll back to the previous image.
+ * @return Always true.
+ */
+extern "C" bool verifyRollbackLater() {
+  return true;
+}
+
 /**
  * @brief Handles a low battery shutdown warning message.
  * Displays a localized warning on the message board.
@@ -190,107 +233,148 @@ void handleShutdownWarning(const std::string& messageKey) {
 }
 
 /**
- * @brief Performs final tasks before the system powers off.
- * This function is called just before the actual power-off sequence.
- * Examples include saving critical data, stopping ongoing processes, closing connections.
+ * @brief Shows the status of a shutdown step on the message board.
+ * Steps do not wait for the text to be drawn; the main loop shows the latest one.
+ * @param key Localization key of the status text.
+ * @param fallback Text used if the key is missing.
  */
-void handlePerformShutdownTasks() {
-  DEBUG_INFO_PRINTLN("Global Callback: Performing final tasks before shutdown...");
+void showShutdownStatus(const char* key, const char* fallback) {
+  if (initializer._messageBoard) {
+    initializer._messageBoard->setText(languageManager.getString(key, fallback), 0);
+  }
+}
 
-  // 1. Stop network/radio managers.
-  if (wifiManager.isWifiLogicEnabled()) {
-      if (initializer._messageBoard) {
-          initializer._messageBoard->setText(languageManager.getString("SHUTDOWN_STATUS_STOP_WIFI", "Stopping Wi-Fi..."), 0);
-          delay(50);
-      }
-      wifiManager.disableWifi(); // This also saves the last state.
-      DEBUG_INFO_PRINTLN("Global Callback: Wi-Fi stopped.");
-      delay(100);
-  } else {
-      DEBUG_TRACE_PRINTLN("Global Callback: Wi-Fi not enabled, skipping stop.");
+/**
+ * @brief Waits on the main loop until a worker task has exited.
+ * @param isStopped Returns true once the task has ended.
+ * @return The coroutine to await.
+ */
+CoTask awaitTaskStopped(bool (*isStopped)()) {
+  while (!isStopped()) {
+    co_await coSleep(SHUTDOWN_POLL_INTERVAL_MS);
   }
+}
 
-  if (btManager.isEnabled()) {
-      if (initializer._messageBoard) {
-          initializer._messageBoard->setText(languageManager.getString("SHUTDOWN_STATUS_STOP_BT", "Stopping Bluetooth..."), 0);
-          delay(50);
-      }
+/**
+ * @brief Registers the final tasks of every subsystem with the shutdown orchestrator.
+ * The telemetry publisher and the OTA download are asked to stop first; their tasks end on their
+ * own, so those steps overlap with the rest and are bounded by a deadline. Every other step is
+ * synchronous and runs to completion when it starts. The network clients are closed before Wi-Fi
+ * goes down, the settings flush waits for every step that persists its last state, and the
+ * internal filesystem is unmounted last.
+ */
+void registerShutdownSteps() {
+  // The publisher task writes its queue to LittleFS (/tlm); it ends after its current iteration.
+  shutdownOrchestrator.addStep("telemetry", []() -> CoTask {
+    telemetryPublisher.stop();
+    co_await awaitTaskStopped([]() { return telemetryPublisher.isStopped(); });
+    DEBUG_INFO_PRINTLN("Global Callback: Telemetry publisher stopped.");
+  }, {}, SHUTDOWN_TASK_STOP_DEADLINE_MS);
+
+  // A download is aborted between two chunks; the checkpoint lets it resume after the next boot.
+  shutdownOrchestrator.addStep("ota", []() -> CoTask {
+    otaUpdater.stop();
+    co_await awaitTaskStopped([]() { return otaUpdater.isStopped(); });
+    DEBUG_INFO_PRINTLN("Global Callback: OTA updater stopped.");
+  }, {}, SHUTDOWN_TASK_STOP_DEADLINE_MS);
+
+  shutdownOrchestrator.addStep("remote_ui", []() -> CoTask {
+    remoteUiMirror.stop(); // Closes the client and waits for the server task.
+    co_return;
+  });
+
+  shutdownOrchestrator.addStep("wifi", []() -> CoTask {
+    WifiEventBridge::ScopedLock wifiLock(wifiEventBridge); // Recursive: held by loop() already, kept so the step does not rely on it
+    if (wifiManager.isWifiLogicEnabled()) {
+      showShutdownStatus("SHUTDOWN_STATUS_STOP_WIFI", "Stopping Wi-Fi...");
+      wifiManager.disableWifi(); // This also saves the last state.
+      DEBUG_INFO_PRINTLN("Global Callback: Wi-Fi stopped.");
+    }
+    co_return;
+  }, {"remote_ui", "telemetry"});
+
+  shutdownOrchestrator.addStep("bluetooth", []() -> CoTask {
+    WifiEventBridge::ScopedLock wifiLock(wifiEventBridge); // BLEManager reaches the WifiManager for coexistence
+    if (btManager.isEnabled()) {
+      showShutdownStatus("SHUTDOWN_STATUS_STOP_BT", "Stopping Bluetooth...");
       btManager.disableBluetooth(); // This also saves the last state.
       DEBUG_INFO_PRINTLN("Global Callback: Bluetooth stopped.");
-      delay(100);
-  } else {
-      DEBUG_TRACE_PRINTLN("Global Callback: Bluetooth not enabled, skipping stop.");
-  }
+    }
+    co_return;
+  });
 
-  // 2. Stop audio and RFID.
-  if (audioManager.isEnabled()) {
-      if (initializer._messageBoard) {
-          initializer._messageBoard->setText(languageManager.getString("SHUTDOWN_STATUS_STOP_AUDIO", "Stopping Audio..."), 0);
-          delay(50);
-      }
+  shutdownOrchestrator.addStep("audio", []() -> CoTask {
+    if (audioManager.isEnabled()) {
+      showShutdownStatus("SHUTDOWN_STATUS_STOP_AUDIO", "Stopping Audio...");
       audioManager.stop();
       audioManager.setEnabled(false); // This also saves the last state.
       DEBUG_INFO_PRINTLN("Global Callback: Audio stopped.");
-      delay(100);
-  } else {
-      DEBUG_TRACE_PRINTLN("Global Callback: Audio not enabled, skipping stop.");
-  }
+    }
+    co_return;
+  });
 
-  if (rfidManager.isEnabled()) {
-      if (initializer._messageBoard) {
-          initializer._messageBoard->setText(languageManager.getString("SHUTDOWN_STATUS_STOP_RFID", "Stopping RFID..."), 0);
-          delay(50);
-      }
+  shutdownOrchestrator.addStep("rfid", []() -> CoTask {
+    if (rfidManager.isEnabled()) {
+      showShutdownStatus("SHUTDOWN_STATUS_STOP_RFID", "Stopping RFID...");
       rfidManager.setEnabled(false); // This saves state and powers down MFRC522.
       DEBUG_INFO_PRINTLN("Global Callback: RFID stopped.");
-      delay(100);
-  } else {
-      DEBUG_TRACE_PRINTLN("Global Callback: RFID not enabled, skipping stop.");
-  }
+    }
+    co_return;
+  });
 
-  // 3. Deactivate screensaver (if active, might still be in a transition).
-  if (screenSaverManager.isActive()) {
-      if (initializer._messageBoard) {
-          initializer._messageBoard->setText(languageManager.getString("SHUTDOWN_STATUS_STOP_SSAVER", "Stopping Screensaver..."), 0);
-          delay(50);
-      }
+  shutdownOrchestrator.addStep("screensaver", []() -> CoTask {
+    if (screenSaverManager.isActive()) {
+      showShutdownStatus("SHUTDOWN_STATUS_STOP_SSAVER", "Stopping Screensaver...");
       screenSaverManager.setEnabled(false); // Deactivates fully.
       DEBUG_INFO_PRINTLN("Global Callback: Screensaver deactivated.");
-      delay(50);
-  } else {
-      DEBUG_TRACE_PRINTLN("Global Callback: Screensaver not active, skipping deactivation.");
-  }
-
-
-  // 4. Unmount filesystems to prevent data corruption.
-  // LittleFS: Normally, LittleFS will handle unmounting automatically on restart/deep sleep.
-  // However, explicit `end()` is safer before a hard power-off if there's any doubt about pending writes.
-  if (LittleFS.begin()) { // Check if LittleFS is mounted
-      if (initializer._messageBoard) {
-          initializer._messageBoard->setText(languageManager.getString("SHUTDOWN_STATUS_UNMOUNT_FS", "Unmounting FS..."), 0);
-          delay(50);
-      }
+    }
+    co_return;
+  });
+
+  // SD Card: CRITICAL to unmount to prevent data corruption.
+  shutdownOrchestrator.addStep("sd_card", []() -> CoTask {
+    if (sdManager.isCardPresent()) {
+      showShutdownStatus("SHUTDOWN_STATUS_UNMOUNT_SD", "Unmounting SD card...");
+      SD.end(); // Explicitly unmount SD.
+      DEBUG_INFO_PRINTLN("Global Callback: SD card unmounted.");
+    }
+    co_return;
+  });
+
+  // Settings must reach flash: no deadline, and it waits for every step that saves its last state.
+  shutdownOrchestrator.addStep("settings", []() -> CoTask {
+    if (!settingsManager.forceSave()) {
+      DEBUG_ERROR_PRINTLN("Global Callback: Settings could not be saved before shutdown!");
+    }
+    co_return;
+  }, {"wifi", "bluetooth", "audio", "rfid", "screensaver"});
+
+  // LittleFS: explicit `end()` is safer before a hard power-off if there's any doubt about pending writes.
+  // A publisher task that missed its deadline may still be writing: LittleFS survives the power cut,
+  // but not an unmount under a writer, so it then stays mounted.
+  shutdownOrchestrator.addStep("littlefs", []() -> CoTask {
+    if (!telemetryPublisher.isStopped()) {
+      DEBUG_WARN_PRINTLN("Global Callback: Telemetry task still running, LittleFS left mounted.");
+    } else if (LittleFS.begin()) { // Check if LittleFS is mounted
+      showShutdownStatus("SHUTDOWN_STATUS_UNMOUNT_FS", "Unmounting FS...");
       LittleFS.end();
       DEBUG_INFO_PRINTLN("Global Callback: LittleFS unmounted.");
-      delay(100);
-  } else {
-      DEBUG_TRACE_PRINTLN("Global Callback: LittleFS not mounted, skipping unmount.");
-  }
+    }
+    co_return;
+  }, {"settings", "telemetry", "ota", "remote_ui"});
+}
 
-  // 5. SD Card: CRITICAL to unmount to prevent data corruption.
-  if (sdManager.isCardPresent()) { // Check if SD is actually present/mounted
-      if (initializer._messageBoard) {
-          initializer._messageBoard->setText(languageManager.getString("SHUTDOWN_STATUS_UNMOUNT_SD", "Unmounting SD card..."), 0);
-          delay(50);
-      }
-      SD.end(); // Explicitly unmount SD.
-      DEBUG_INFO_PRINTLN("Global Callback: SD card unmounted.");
-      delay(100);
-  } else {
-      DEBUG_TRACE_PRINTLN("Global Callback: SD card not present, skipping unmount.");
-  }
-  
-  // 6. Final UI feedback before power-off.
+/**
+ * @brief Performs final tasks before the system powers off, as a coroutine on the main loop.
+ * Runs the registered shutdown steps, shows the goodbye screen and cuts the power.
+ * @param powerOff Function that performs the actual power-off, called at the end.
+ */
+CoTask shutdownSequence(std::function<void()> powerOff) {
+  DEBUG_INFO_PRINTLN("Global Callback: Performing final tasks before shutdown...");
+  displaySleep.wake(); // The shutdown messages must be visible.
+  co_await shutdownOrchestrator.run();
+
+  // Final UI feedback before power-off.
   // Clear screen completely and display a goodbye message.
   if (initializer._lcd) {
       initializer._lcd->fillScreen(TFT_BLACK);
@@ -300,7 +384,20 @@ void handlePerformShutdownTasks() {
       initializer._lcd->drawString(languageManager.getString("SHUTDOWN_MESSAGE_GOODBYE", "Goodbye!").c_str(), initializer._lcd->width()/2, initializer._lcd->height()/2);
   }
   DEBUG_INFO_PRINTLN("Global Callback: All final shutdown tasks completed.");
-  delay(3000);
+  // The goodbye screen is the last frame: block here so the main loop does not draw over it.
+  delay(SHUTDOWN_GOODBYE_HOLD_MS);
+  powerOff();
+}
+
+/**
+ * @brief Starts the shutdown sequence when the PowerManager requests a power-off.
+ * @param powerOff Function that performs the actual power-off once the final tasks are done.
+ */
+void handlePerformShutdownTasks(std::function<void()> powerOff) {
+  if (!g_coScheduler.spawn(shutdownSequence(powerOff))) {
+    DEBUG_ERROR_PRINTLN("Global Callback: Could not start the shutdown sequence, powering off directly.");
+    powerOff();
+  }
 }
 
 /**
@@ -310,6 +407,7 @@ void handlePerformShutdownTasks() {
  */
 void handleCardScanned(const RFIDCardData& cardData) {
   DEBUG_INFO_PRINTF("Global Callback: Card detected - UID: %s\n", cardData.uid_string.c_str());
+  telemetryPublisher.recordRfidScan(cardData.uid_string);
   mainUI.showRfidConfirmationDialog(cardData);
 }
 
@@ -335,6 +433,9 @@ void setup() {
   // Perform all system and UI initialization via the initializer object
   initializer.init();
 
+  // Register the final tasks run by the shutdown orchestrator
+  registerShutdownSteps();
+
   // Set the initial active screen
   screenManager.switchToLayer("main_L_demo");
 
@@ -358,28 +459,90 @@ void setup() {
  */
 void loop() {
 
+  loopBudget.startFrame(); // Each lap() below charges the time since the previous one to the named subsystem
+
   // Get Raw Touch Coordinates and Pressure State
   int32_t tx, ty;
   bool isPressed = lcd.getTouch(&tx, &ty);
+  remoteUiMirror.pollTouch(&tx, &ty, &isPressed); // A remote client's touch replaces the local reading
+  cpuGovernor.onTouch(isPressed);                 // Full clock before the touch is handled
+  displaySleep.onTouch(isPressed);                // Wakes a sleeping panel before the touch is handled
+  loopBudget.lap("touch");
 
   // Update System Managers
   // NOTE: The order of updates can matter due to dependencies or processing priorities.
   screenSaverManager.onTouch(tx, ty, isPressed); // Screensaver gets first dibs on touch
-  screenSaverManager.loop();                     // Updates screensaver state, brightness, clock
+  if (!displaySleep.isPanelAsleep()) {
+    screenSaverManager.loop();                   // Updates screensaver state, brightness, clock
+  }
+  displaySleep.loop();                           // Backlight off and panel sleep after the second timeout
+  loopBudget.lap("screensaver");
+  // The WifiManager runs on its own task and, from there, still updates the Wi-Fi icon, posts
+  // messages and resumes BLE scans (whose callbacks update BLEUI). Hold the bridge lock for
+  // everything that reads or writes the UI, rendering included; the task gets its turn while
+  // the loop sleeps below.
+  wifiEventBridge.lock();
+  loopBudget.lap("wifi_lock", 5000);
   timeManager.loop();                            // Updates internal time, NTP sync
-  powerManager.loop();                           // Monitors battery, handles shutdown
-  rfidManager.loop();                            // Scans for RFID tags
-  btManager.loop();                              // Updates Bluetooth state, connections
-  wifiManager.loop();                            // Updates Wi-Fi state, connections, RSSI
+  loopBudget.lap("time");
+  g_timerWheel.advance(millis());                // Runs due timers: battery checks, RFID polling, settings refresh
+  loopBudget.lap("timers");
+  g_coScheduler.loop();                          // Resumes coroutines woken by timers and events (e.g. the shutdown sequence)
+  loopBudget.lap("coroutines");
+  managerTaskHost.loop();                        // Applies battery samples and card reads from the manager tasks
+  loopBudget.lap("manager_tasks");
+  btManager.loop();                              // Updates Bluetooth state, connections (reaches the WifiManager for coexistence)
+  loopBudget.lap("ble");
+  wifiEventBridge.loop();                        // Delivers Wi-Fi state/scan/RSSI events from the Wi-Fi task
+  loopBudget.lap("wifi_events");
+  wifiFastReconnect.loop();                      // Directed reconnect to cached AP, connect-time metrics
+  loopBudget.lap("wifi_reconnect");
+  radioScheduler.loop();                         // Grants queued radio requests, Wi-Fi/BLE coexistence slices
+  loopBudget.lap("radio");
+  bleNotifyPipeline.loop();                      // Applies GATT subscriptions, delivers queued notifications
+  loopBudget.lap("ble_notify");
+  wifiPowerPolicy.loop();                        // Selects the Wi-Fi modem power-save mode
+  loopBudget.lap("wifi_power");
+  otaUpdater.loop();                             // Firmware update progress, image confirmation/rollback
+  loopBudget.lap("ota");
   mainUI.loop();                                 // Updates main UI specific elements (e.g., status label, seekbars)
+  loopBudget.lap("main_ui");
   audioManager.loop();                           // Updates audio manager (e.g., timed sound playback)
+  loopBudget.lap("audio");
   //sdManager.loop();                            // NOTE: SD card loop commented out as requested.
 
   // Update Main UI (ScreenManager and Statusbar)
   // Statusbar processes its own touch events first (e.g., panel drag, button presses)
-  bool touchHandledByStatusbar = statusbar.loop();
-  // ScreenManager updates the active UI layer, passing touch events if statusbar didn't handle them.
-  screenManager.loop(touchHandledByStatusbar);
+  // Nothing is drawn while the panel sleeps.
+  if (!displaySleep.isPanelAsleep()) {
+    const uint32_t renderStartUs = micros();
+    bool touchHandledByStatusbar = statusbar.loop();
+    loopBudget.lap("statusbar", 8000);
+    // ScreenManager updates the active UI layer, passing touch events if statusbar didn't handle them.
+    screenManager.loop(touchHandledByStatusbar);
+    loopBudget.lap("screen", 16000);
+    cpuGovernor.onFrame(micros() - renderStartUs);  // Heavy frames (animations, full redraws) keep the clock up
+    idleSleep.onFrame();                            // Completes the wake-to-first-frame measurement after a touch wake
+    displaySleep.onFrame();                         // Same after a panel wake
+  }
 
-  delay(10); // Short delay to prevent busy-waiting and allow other tasks to run (e.g., FreeRTOS tasks)
+  remoteUiMirror.loop();                         // Streams the tiles drawn in this iteration to the remote client
+  loopBudget.lap("remote_ui");
+  telemetryPublisher.loop();                     // Samples battery, RSSI and loop period for the telemetry batches
+  loopBudget.lap("telemetry");
+  wifiEventBridge.unlock();
+  cpuGovernor.loop();                            // Drops the CPU clock once touch, animations and audio are idle
+  loopBudget.lap("cpu_governor");
+  idleSleep.loop();                              // Idle once the screensaver runs and touch, animations and audio are quiet
+  loopBudget.lap("idle_sleep");
+
+  // Sleep until the next timer deadline. Touch and the managers that still poll keep the upper bound,
+  // and at least one tick lets other FreeRTOS tasks (e.g. the WifiManager task) run. While idle, the
+  // wait ends on the touch interrupt instead and may be a light sleep.
+  uint32_t sleepCapMs = MAIN_LOOP_MAX_SLEEP_MS;
+  if (idleSleep.isIdle()) {
+    sleepCapMs = displaySleep.isPanelAsleep() ? displaySleep.getMaxSleepMs() : idleSleep.getMaxSleepMs();
+  }
+  const uint32_t sleepMs = g_coScheduler.hasReady() ? 0 : g_timerWheel.msUntilNextDeadline(sleepCapMs);
+  idleSleep.sleep(std::max<uint32_t>(MAIN_LOOP_MIN_SLEEP_MS, sleepMs));
 }
\ No newline at end of file
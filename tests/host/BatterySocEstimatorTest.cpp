@@ -0,0 +1,253 @@
+/**
+ * @file BatterySocEstimatorTest.cpp
+ * @brief Replays the battery traces in `data/battery` through the BatterySocEstimator with the
+ * device's battery model: state of charge against the reference, step size, the remaining runtime
+ * against the charge the trace still drew, and the charging state, time to full and learning
+ * across a charge.
+ *
+ * The traces are synthetic (`tools/battery_traces.py`): a cell model that differs from
+ * ConfigHardwareUser.h in its OCV curve, capacity, resistance, load and charge currents.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "HostTest.h"
+#include "BatterySocEstimator.h"
+#include "ConfigHardwareUser.h"
+#include "SystemInitializer.h"
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief One battery check of a trace.
+ */
+struct TraceRow {
+  uint32_t timeMs;
+  float voltage;
+  BatteryLoadState load;
+  bool charger;       ///< Charger connected.
+  float loadMilliAmps;///< Real current of the device.
+  float socPercent;   ///< Reference state of charge.
+};
+
+std::vector<TraceRow> loadTrace(const char* name) {
+  std::vector<TraceRow> rows;
+  std::ifstream in(std::string(WOBYS_BATTERY_TRACE_DIR) + "/" + name);
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#' || line[0] == 't') continue; // Comments and the column names.
+    std::istringstream fields(line);
+    std::string field[9];
+    for (auto& f : field) std::getline(fields, f, ',');
+    TraceRow row;
+    row.timeMs = (uint32_t)std::stoul(field[0]) * 1000;
+    row.voltage = std::stof(field[1]) / 1000.0f;
+    row.load.backlight = (uint8_t)std::stoi(field[2]);
+    row.load.wifiEnabled = field[3] == "1";
+    row.load.bluetoothEnabled = field[4] == "1";
+    row.load.audioEnabled = field[5] == "1";
+    row.charger = field[6] == "1";
+    row.loadMilliAmps = std::stof(field[7]);
+    row.socPercent = std::stof(field[8]);
+    rows.push_back(row);
+  }
+  return rows;
+}
+
+/**
+ * @brief The estimator configured as SystemInitializer configures it on the device.
+ */
+void initDeviceModel(BatterySocEstimator& estimator) {
+  const BatterySocConfig config = {
+    .ocvTable = BATT_OCV_TABLE, .ocvTableSize = sizeof(BATT_OCV_TABLE) / sizeof(BATT_OCV_TABLE[0]),
+    .nominalCapacityMah = BATT_NOMINAL_CAPACITY_MAH, .internalResistanceOhm = BATT_INTERNAL_RESISTANCE_OHM,
+    .loadBaseMilliAmps = BATT_LOAD_BASE_MA, .loadBacklightMaxMilliAmps = BATT_LOAD_BACKLIGHT_MAX_MA,
+    .loadWifiMilliAmps = BATT_LOAD_WIFI_MA, .loadBluetoothMilliAmps = BATT_LOAD_BLUETOOTH_MA,
+    .loadAudioMilliAmps = BATT_LOAD_AUDIO_MA,
+    .chargeCurrentMilliAmps = BATT_CHARGE_CURRENT_MA, .chargeVoltage = BATT_CHARGE_VOLTAGE,
+    .chargeTerminationMilliAmps = BATT_CHARGE_TERMINATION_MA
+  };
+  estimator.init(config);
+}
+
+/**
+ * @brief Feeds one row the way PowerManager::updateStateOfCharge() does.
+ */
+void feed(BatterySocEstimator& estimator, const TraceRow& row) {
+  estimator.update(row.voltage, estimator.estimateLoadMilliAmps(row.load), row.timeMs);
+}
+
+/**
+ * @brief State of charge error and largest step over a replay.
+ */
+struct SocStats {
+  float maxErrorPercent = 0.0f;
+  int maxStepPercent = 0;
+
+  void add(int previousPercent, int percent, float referencePercent) {
+    maxErrorPercent = std::max(maxErrorPercent, std::fabs(percent - referencePercent));
+    if (previousPercent >= 0) maxStepPercent = std::max(maxStepPercent, std::abs(percent - previousPercent));
+  }
+};
+
+constexpr float kMaxSocErrorPercent = 6.0f;
+constexpr float kMaxRuntimeError = 0.15f;     // Relative to the reference runtime.
+constexpr float kMaxTimeToFullError = 0.20f;  // Relative to the time the charge still took,
+constexpr float kTimeToFullSlackMinutes = 8;  // or this much, near the end of the charge.
+constexpr size_t kDetectSamples = 2;          // Battery checks a plug or unplug may take to show.
+
+} // namespace
+
+HOST_TEST(dischargeTracesFollowTheReferenceSoc) {
+  for (const char* name : { "discharge_mixed.csv", "discharge_radios.csv" }) {
+    const std::vector<TraceRow> trace = loadTrace(name);
+    REQUIRE(trace.size() > 1000);
+    BatterySocEstimator estimator;
+    initDeviceModel(estimator);
+    CHECK_EQ(estimator.getPercent(), BatterySocEstimator::UNKNOWN);
+
+    SocStats stats;
+    bool everCharging = false;
+    int previous = -1;
+    for (const TraceRow& row : trace) {
+      feed(estimator, row);
+      stats.add(previous, estimator.getPercent(), row.socPercent);
+      previous = estimator.getPercent();
+      everCharging |= estimator.isCharging();
+    }
+    std::printf("  %s: %zu samples, max SoC error %.1f%%, max step %d%%, learned %.0f mAh\n", name, trace.size(),
+                stats.maxErrorPercent, stats.maxStepPercent, estimator.getLearnedCapacityMah());
+    CHECK(stats.maxErrorPercent <= kMaxSocErrorPercent);
+    CHECK(stats.maxStepPercent <= 1);
+    CHECK(!everCharging); // Load changes must not look like a charger.
+    CHECK_EQ(estimator.getMinutesToFull(), BatterySocEstimator::UNKNOWN);
+  }
+}
+
+HOST_TEST(remainingRuntimeMatchesTheChargeLeftAtTheAveragedLoad) {
+  for (const char* name : { "discharge_mixed.csv", "discharge_radios.csv" }) {
+    const std::vector<TraceRow> trace = loadTrace(name);
+    REQUIRE(trace.size() > 1000);
+    BatterySocEstimator estimator;
+    initDeviceModel(estimator);
+
+    // The charge the device still drew before the shutdown, in real mAh.
+    std::vector<float> remainingMah(trace.size(), 0.0f);
+    for (size_t i = trace.size() - 1; i > 0; --i) {
+      remainingMah[i - 1] = remainingMah[i] + trace[i].loadMilliAmps * (trace[i].timeMs - trace[i - 1].timeMs) / 3600000.0f;
+    }
+
+    // The estimator predicts at its averaged load, not at the load still to come: the reference
+    // divides the charge left by the real current averaged the same way.
+    float averageMilliAmps = trace[0].loadMilliAmps;
+    const float checkpoints[] = { 90.0f, 70.0f, 50.0f, 30.0f, 10.0f };
+    size_t next = 0;
+    for (size_t i = 0; i < trace.size(); ++i) {
+      const TraceRow& row = trace[i];
+      feed(estimator, row);
+      if (i > 0) {
+        const float elapsedMs = (float)(row.timeMs - trace[i - 1].timeMs);
+        averageMilliAmps += elapsedMs / (BATTERY_SOC_LOAD_AVERAGE_MS + elapsedMs) * (row.loadMilliAmps - averageMilliAmps);
+      }
+      if (next < 5 && row.socPercent <= checkpoints[next]) {
+        const float referenceMinutes = remainingMah[i] / averageMilliAmps * 60.0f;
+        const int predicted = estimator.getRemainingMinutes();
+        const float error = (predicted - referenceMinutes) / referenceMinutes;
+        std::printf("  %s at %.0f%%: predicted %d min, reference %.0f min (%+.0f%%)\n", name, checkpoints[next],
+                    predicted, referenceMinutes, error * 100.0f);
+        CHECK(predicted >= 0);
+        // 90 % comes before the first learning windows, with the rated capacity.
+        if (next > 0) CHECK(std::fabs(error) <= kMaxRuntimeError);
+        next++;
+      }
+    }
+    CHECK_EQ(next, size_t(5));
+  }
+}
+
+HOST_TEST(chargeIsDetectedAndTrackedWithoutDisturbingTheLearning) {
+  const std::vector<TraceRow> trace = loadTrace("charge_cycle.csv");
+  REQUIRE(trace.size() > 1000);
+  BatterySocEstimator estimator;
+  initDeviceModel(estimator);
+
+  // The charge ends (the cell current reaches the termination current) where the reference stops rising.
+  size_t fullChargeStart = 0, fullChargeEnd = 0;
+  for (size_t i = 1; i < trace.size(); ++i) {
+    if (trace[i].charger && !trace[i - 1].charger) fullChargeStart = i; // The last plug-in is the full charge.
+  }
+  for (size_t i = fullChargeStart; i < trace.size() && trace[i].charger; ++i) {
+    if (trace[i].socPercent > trace[i - 1].socPercent) fullChargeEnd = i;
+  }
+  REQUIRE(fullChargeStart > 0 && fullChargeEnd > fullChargeStart);
+
+  SocStats stats;
+  size_t lateSamples = 0, edges = 0, sinceEdge = 0;
+  int previous = -1;
+  float capacityBeforeCharge = 0.0f;
+  for (size_t i = 0; i < trace.size(); ++i) {
+    const TraceRow& row = trace[i];
+    if (i > 0 && row.charger != trace[i - 1].charger) {
+      edges++;
+      sinceEdge = 0;
+      capacityBeforeCharge = estimator.getLearnedCapacityMah();
+    }
+    feed(estimator, row);
+    stats.add(previous, estimator.getPercent(), row.socPercent);
+    previous = estimator.getPercent();
+
+    if (estimator.isCharging() != row.charger) {
+      CHECK(sinceEdge < kDetectSamples);
+      lateSamples++;
+    }
+    sinceEdge++;
+
+    if (estimator.isCharging()) {
+      CHECK_EQ(estimator.getRemainingMinutes(), BatterySocEstimator::UNKNOWN);
+      CHECK(estimator.getMinutesToFull() >= 0);
+      CHECK(estimator.getLearnedCapacityMah() == capacityBeforeCharge); // A charge is not a discharge window.
+    } else if (estimator.getPercent() >= 0) {
+      CHECK(estimator.getRemainingMinutes() >= 0);
+      CHECK_EQ(estimator.getMinutesToFull(), BatterySocEstimator::UNKNOWN);
+    }
+
+    // Time to full in constant current (after the load average settled) and in constant voltage.
+    if (i == fullChargeStart + 120 || i == fullChargeEnd - 120 || i == fullChargeEnd - 360) {
+      const float actualMinutes = (trace[fullChargeEnd].timeMs - row.timeMs) / 60000.0f;
+      const int predicted = estimator.getMinutesToFull();
+      const float error = (predicted - actualMinutes) / actualMinutes;
+      std::printf("  time to full at %.0f%%: predicted %d min, took %.0f min (%+.0f%%)\n", row.socPercent,
+                  predicted, actualMinutes, error * 100.0f);
+      CHECK(std::fabs(predicted - actualMinutes) <= std::max(kMaxTimeToFullError * actualMinutes, kTimeToFullSlackMinutes));
+    }
+  }
+  std::printf("  charge_cycle.csv: %zu samples, %zu charger edges, max SoC error %.1f%%, max step %d%%\n",
+              trace.size(), edges, stats.maxErrorPercent, stats.maxStepPercent);
+  CHECK_EQ(edges, size_t(4));
+  CHECK(lateSamples <= edges * kDetectSamples);
+  CHECK(stats.maxErrorPercent <= kMaxSocErrorPercent);
+  CHECK(stats.maxStepPercent <= 1);
+  CHECK(!estimator.isCharging());
+}
@@ -0,0 +1,168 @@
+/**
+ * @file BleDeviceRegistryTest.cpp
+ * @brief Checks the BleDeviceRegistry string pool (interning, the deferred compaction and the
+ * references that survive it) and the removal events of evicted devices.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "HostTest.h"
+#include "BleDeviceRegistry.h"
+#include <map>
+#include <string>
+
+namespace {
+
+void addressOf(uint32_t n, uint8_t out[6]) {
+  const uint8_t address[6] = { 0xAA, 0xBB, (uint8_t)(n >> 24), (uint8_t)(n >> 16), (uint8_t)(n >> 8), (uint8_t)n };
+  memcpy(out, address, 6);
+}
+
+std::map<std::string, std::string> namesByAddress(const BleDeviceRegistry& registry) {
+  std::map<std::string, std::string> names;
+  registry.forEach([&names](const BleDeviceSnapshot& snap) {
+    char address[18];
+    BleDeviceRegistry::formatAddress(snap.address, address);
+    names[address] = snap.name;
+  });
+  return names;
+}
+
+} // namespace
+
+HOST_TEST(identicalNamesAreInternedOnce) {
+  static BleDeviceRegistry registry;
+  registry.clear();
+  uint8_t a[6], b[6];
+  addressOf(1, a);
+  addressOf(2, b);
+  CHECK(registry.update(a, 0, -60, "Sensor", nullptr, 0));
+  CHECK(registry.update(b, 0, -70, "Sensor", "0000180d-0000-1000-8000-00805f9b34fb", 0));
+  CHECK(!registry.compactPool()); // Far from full: nothing requested.
+
+  std::map<std::string, std::string> names = namesByAddress(registry);
+  CHECK_EQ(names.size(), size_t(2));
+  CHECK(names["aa:bb:00:00:00:01"] == "Sensor");
+  CHECK(names["aa:bb:00:00:00:02"] == "Sensor");
+}
+
+HOST_TEST(fullPoolIsCompactedLaterAndKeepsLiveNames) {
+  static BleDeviceRegistry registry;
+  registry.clear();
+
+  // 400 devices with unique 12-character names: the 128 records evict the older ones, so most
+  // pool entries die, and the pool (2048 bytes, 14 bytes per entry) would run full repeatedly.
+  char name[32];
+  uint8_t address[6];
+  uint32_t missingNames = 0;
+  for (uint32_t n = 0; n < 400; ++n) {
+    addressOf(n, address);
+    snprintf(name, sizeof(name), "Device-%05u", (unsigned)n);
+    registry.update(address, 0, -50, name, nullptr, n);
+    registry.forEach([&](const BleDeviceSnapshot& snap) {
+      if (memcmp(snap.address, address, 6) == 0 && !snap.name[0]) missingNames++;
+    });
+    registry.compactPool(); // The reader task's turn.
+  }
+  CHECK_EQ(registry.size(), size_t(BLE_DEVICE_REGISTRY_CAPACITY));
+  CHECK(registry.getEvictionCount() == 400 - BLE_DEVICE_REGISTRY_CAPACITY);
+  // Compaction ran before the pool filled up, so no device lost its name.
+  CHECK_EQ(missingNames, uint32_t(0));
+
+  std::map<std::string, std::string> names = namesByAddress(registry);
+  REQUIRE(names.size() == BLE_DEVICE_REGISTRY_CAPACITY);
+  for (uint32_t n = 400 - BLE_DEVICE_REGISTRY_CAPACITY; n < 400; ++n) {
+    char key[18];
+    addressOf(n, address);
+    BleDeviceRegistry::formatAddress(address, key);
+    snprintf(name, sizeof(name), "Device-%05u", (unsigned)n);
+    CHECK(names[key] == name);
+  }
+}
+
+HOST_TEST(nameDroppedOnAFullPoolIsPickedUpAfterCompaction) {
+  static BleDeviceRegistry registry;
+  registry.clear();
+
+  // Without the reader's turn, the pool fills up with the names of evicted devices.
+  char name[32];
+  uint8_t address[6];
+  bool dropped = false;
+  uint32_t n = 0;
+  for (; n < 400 && !dropped; ++n) {
+    addressOf(n, address);
+    snprintf(name, sizeof(name), "Device-%05u", (unsigned)n);
+    registry.update(address, 0, -50, name, nullptr, n);
+    registry.forEach([&](const BleDeviceSnapshot& snap) {
+      if (memcmp(snap.address, address, 6) == 0 && !snap.name[0]) dropped = true;
+    });
+  }
+  REQUIRE(dropped);
+  CHECK_EQ(n, uint32_t(BLE_DEVICE_REGISTRY_POOL_BYTES / 14 + 1));
+
+  // The next advert of that device after the compaction carries the name in.
+  CHECK(registry.compactPool());
+  registry.update(address, 0, -50, name, nullptr, n);
+  std::map<std::string, std::string> names = namesByAddress(registry);
+  char key[18];
+  BleDeviceRegistry::formatAddress(address, key);
+  CHECK(names[key] == name);
+  CHECK_EQ(names.size(), size_t(BLE_DEVICE_REGISTRY_CAPACITY));
+}
+
+HOST_TEST(evictedReportedDevicesAreReportedAsRemoved) {
+  static BleDeviceRegistry registry;
+  static BleDeviceSnapshot changes[BLE_DEVICE_REGISTRY_CAPACITY + BLE_DEVICE_REGISTRY_EVICTED_QUEUE];
+  registry.clear();
+
+  uint8_t address[6];
+  for (uint32_t n = 0; n < BLE_DEVICE_REGISTRY_CAPACITY; ++n) {
+    addressOf(n, address);
+    registry.update(address, 0, -50, nullptr, nullptr, n);
+  }
+  CHECK_EQ(registry.collectChanges(changes, BLE_DEVICE_REGISTRY_CAPACITY), size_t(BLE_DEVICE_REGISTRY_CAPACITY));
+
+  // Every eviction of a reported device is queued; once the queue is full, new devices wait.
+  const uint32_t first = BLE_DEVICE_REGISTRY_CAPACITY;
+  for (uint32_t n = first; n < first + BLE_DEVICE_REGISTRY_EVICTED_QUEUE; ++n) {
+    addressOf(n, address);
+    CHECK(registry.update(address, 0, -50, nullptr, nullptr, n));
+  }
+  const uint32_t waiting = first + BLE_DEVICE_REGISTRY_EVICTED_QUEUE;
+  addressOf(waiting, address);
+  CHECK(!registry.update(address, 0, -50, nullptr, nullptr, waiting));
+  CHECK(!registry.contains(address));
+  CHECK(registry.getEvictionCount() == BLE_DEVICE_REGISTRY_EVICTED_QUEUE);
+
+  // The removals come first, oldest first, followed by the devices that replaced them.
+  size_t count = registry.collectChanges(changes, BLE_DEVICE_REGISTRY_CAPACITY + BLE_DEVICE_REGISTRY_EVICTED_QUEUE);
+  REQUIRE(count == 2 * BLE_DEVICE_REGISTRY_EVICTED_QUEUE);
+  for (uint32_t k = 0; k < BLE_DEVICE_REGISTRY_EVICTED_QUEUE; ++k) {
+    addressOf(k, address);
+    CHECK(changes[k].isRemoved);
+    CHECK(memcmp(changes[k].address, address, 6) == 0);
+    CHECK(!changes[BLE_DEVICE_REGISTRY_EVICTED_QUEUE + k].isRemoved);
+    CHECK(changes[BLE_DEVICE_REGISTRY_EVICTED_QUEUE + k].isNew);
+  }
+
+  // With the queue drained, the waiting device gets a record on its next advert.
+  addressOf(waiting, address);
+  CHECK(registry.update(address, 0, -50, nullptr, nullptr, waiting));
+  CHECK(registry.contains(address));
+}
@@ -0,0 +1,229 @@
+/**
+ * @file CoroutineTest.cpp
+ * @brief Runs the coroutine runtime on simulated time: sleeps, yields, awaited child tasks,
+ * events with timeouts and the frame pool, driven the way the main loop drives them.
+ *
+ * `g_timerWheel` reads its time through `millis()`, which the host stub serves from `hostclock`,
+ * so the wheel, the scheduler and the tests all see the same simulated milliseconds.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "HostTest.h"
+#include "Coroutine.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief The main loop on simulated time.
+ *
+ * `hostclock` restarts at 0 before every test case, but `g_timerWheel` is shared by all of them
+ * and must not see time go backwards, so each case continues where the previous one stopped.
+ */
+struct SimLoop {
+  static uint64_t& endOfLastCaseUs() {
+    static uint64_t us = 0;
+    return us;
+  }
+
+  SimLoop() { hostclock::advanceUs(endOfLastCaseUs()); }
+
+  ~SimLoop() {
+    endOfLastCaseUs() = hostclock::nowUs();
+    CHECK_EQ(g_coScheduler.getLiveCount(), size_t(0));
+    CHECK_EQ(g_timerWheel.activeCount(), size_t(0));
+  }
+
+  /**
+   * @brief Runs the loop for `ms` simulated milliseconds, sleeping until the next deadline
+   * between iterations as WobysGUI.ino does.
+   */
+  void runFor(uint32_t ms) {
+    const uint32_t end = millis() + ms;
+    while ((int32_t)(end - millis()) > 0) {
+      g_timerWheel.advance(millis());
+      g_coScheduler.loop();
+      const uint32_t remaining = end - millis();
+      const uint32_t sleepMs = g_coScheduler.hasReady() ? 0 : g_timerWheel.msUntilNextDeadline(remaining);
+      hostclock::advanceMs(sleepMs);
+      iterations++;
+    }
+    g_timerWheel.advance(millis());
+    g_coScheduler.loop();
+  }
+
+  uint32_t iterations = 0; ///< Loop iterations run so far.
+};
+
+CoTask sleeper(std::vector<uint32_t>& wakeups, uint32_t first, uint32_t second) {
+  co_await coSleep(first);
+  wakeups.push_back(millis());
+  co_await coSleep(second);
+  wakeups.push_back(millis());
+}
+
+CoTask yielder(std::string& trace, char id, int rounds) {
+  for (int i = 0; i < rounds; ++i) {
+    trace.push_back(id);
+    co_await coYield();
+  }
+}
+
+CoTask child(std::string& trace, uint32_t sleepMs) {
+  trace += "child-start ";
+  co_await coSleep(sleepMs);
+  trace += "child-end ";
+}
+
+CoTask parent(std::string& trace, uint32_t& resumedAt) {
+  trace += "parent-start ";
+  co_await child(trace, 40);
+  trace += "parent-end";
+  resumedAt = millis();
+}
+
+CoTask waiter(CoEvent& event, uint32_t timeoutMs, bool& result, uint32_t& resumedAt) {
+  result = co_await event.waitFor(timeoutMs);
+  resumedAt = millis();
+}
+
+CoTask foreverWaiter(CoEvent& event, uint32_t& resumedAt) {
+  co_await event;
+  resumedAt = millis();
+}
+
+} // namespace
+
+HOST_TEST(sleepsResumeOnTheirDeadline) {
+  SimLoop sim;
+  const uint32_t t0 = millis();
+  std::vector<uint32_t> wakeups;
+  REQUIRE(g_coScheduler.spawn(sleeper(wakeups, 250, 1000)));
+  CHECK_EQ(g_coScheduler.getLiveCount(), size_t(1));
+
+  sim.runFor(2000);
+  REQUIRE(wakeups.size() == 2);
+  CHECK_EQ(wakeups[0] - t0, uint32_t(250));
+  CHECK_EQ(wakeups[1] - t0, uint32_t(1250));
+  // The loop slept through the waits instead of spinning once per millisecond.
+  CHECK(sim.iterations < 10);
+}
+
+HOST_TEST(yieldingCoroutinesTakeTurns) {
+  SimLoop sim;
+  std::string trace;
+  REQUIRE(g_coScheduler.spawn(yielder(trace, 'a', 3)));
+  REQUIRE(g_coScheduler.spawn(yielder(trace, 'b', 3)));
+
+  // Each loop() resumes only what was ready when it started, so the two interleave.
+  g_coScheduler.loop();
+  CHECK(trace == "ab");
+  sim.runFor(10);
+  CHECK(trace == "ababab");
+}
+
+HOST_TEST(awaitedChildResumesItsParent) {
+  SimLoop sim;
+  const uint32_t t0 = millis();
+  std::string trace;
+  uint32_t resumedAt = 0;
+
+  // start() runs the parent and the child up to the child's first suspension.
+  REQUIRE(g_coScheduler.start(parent(trace, resumedAt)));
+  CHECK(trace == "parent-start child-start ");
+
+  sim.runFor(100);
+  CHECK(trace == "parent-start child-start child-end parent-end");
+  CHECK_EQ(resumedAt - t0, uint32_t(40));
+}
+
+HOST_TEST(eventWakesItsWaitersAndCancelsTheirTimeouts) {
+  SimLoop sim;
+  const uint32_t t0 = millis();
+  CoEvent event;
+  bool first = false, second = false;
+  uint32_t firstAt = 0, secondAt = 0, foreverAt = 0;
+  REQUIRE(g_coScheduler.start(waiter(event, 1000, first, firstAt)));
+  REQUIRE(g_coScheduler.start(waiter(event, 5000, second, secondAt)));
+  REQUIRE(g_coScheduler.start(foreverWaiter(event, foreverAt)));
+  CHECK_EQ(g_timerWheel.activeCount(), size_t(2)); // The waiter without a timeout has no timer.
+
+  sim.runFor(300);
+  CHECK_EQ(firstAt, uint32_t(0));
+  event.set();
+  CHECK_EQ(g_timerWheel.activeCount(), size_t(0));
+  sim.runFor(1);
+  CHECK(first);
+  CHECK(second);
+  CHECK_EQ(firstAt - t0, uint32_t(300));
+  CHECK_EQ(secondAt - t0, uint32_t(300));
+  CHECK_EQ(foreverAt - t0, uint32_t(300));
+
+  // A set event does not suspend at all until it is reset.
+  bool again = false;
+  uint32_t againAt = 0;
+  REQUIRE(g_coScheduler.start(waiter(event, 1000, again, againAt)));
+  CHECK(again);
+  event.reset();
+}
+
+HOST_TEST(eventWaitTimesOut) {
+  SimLoop sim;
+  const uint32_t t0 = millis();
+  CoEvent event;
+  bool result = true;
+  uint32_t resumedAt = 0;
+  REQUIRE(g_coScheduler.start(waiter(event, 500, result, resumedAt)));
+
+  sim.runFor(499);
+  CHECK_EQ(resumedAt, uint32_t(0));
+  sim.runFor(1);
+  CHECK(!result);
+  CHECK_EQ(resumedAt - t0, uint32_t(500));
+
+  // The timed-out waiter left the event; a later set() has nobody to wake.
+  event.set();
+  CHECK(!g_coScheduler.hasReady());
+}
+
+HOST_TEST(framesComeFromThePoolUntilItRunsOut) {
+  SimLoop sim;
+  const uint32_t heapBefore = g_coScheduler.getHeapFrameCount();
+  constexpr size_t extra = 3;
+  std::vector<uint32_t> wakeups[CO_FRAME_POOL_BLOCKS + extra];
+  for (size_t i = 0; i < CO_FRAME_POOL_BLOCKS + extra; ++i) {
+    REQUIRE(g_coScheduler.spawn(sleeper(wakeups[i], 10 + i, 10)));
+  }
+  CHECK_EQ(g_coScheduler.getLiveCount(), size_t(CO_FRAME_POOL_BLOCKS + extra));
+  CHECK_EQ(g_coScheduler.getHeapFrameCount() - heapBefore, uint32_t(extra));
+
+  sim.runFor(100);
+  for (size_t i = 0; i < CO_FRAME_POOL_BLOCKS + extra; ++i) CHECK_EQ(wakeups[i].size(), size_t(2));
+
+  // Freed blocks are reused: a second round fits in the pool.
+  for (size_t i = 0; i < CO_FRAME_POOL_BLOCKS; ++i) {
+    wakeups[i].clear();
+    REQUIRE(g_coScheduler.spawn(sleeper(wakeups[i], 5, 5)));
+  }
+  CHECK_EQ(g_coScheduler.getHeapFrameCount() - heapBefore, uint32_t(extra));
+  sim.runFor(20);
+}
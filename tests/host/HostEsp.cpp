@@ -0,0 +1,145 @@
+/**
+ * @file HostEsp.cpp
+ * @brief RAM-backed flash with two OTA app slots behind `stubs/esp_partition.h` and `stubs/esp_ota_ops.h`.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "esp_partition.h"
+#include "esp_ota_ops.h"
+#include <cstring>
+
+namespace {
+constexpr uint32_t SECTOR_BYTES = 4096;
+constexpr uint32_t SLOT_BYTES = 256 * 1024;
+
+esp_partition_t g_slots[2] = {
+  { 0x010000, SLOT_BYTES, "ota_0" },
+  { 0x110000, SLOT_BYTES, "ota_1" }
+};
+std::vector<uint8_t> g_flash[2];         ///< Contents of the slots.
+std::vector<size_t> g_eraseLog;          ///< Sizes of the erases.
+int g_running = 0;                       ///< Index of the running slot.
+int g_boot = -1;                         ///< Slot selected for the next boot, or -1.
+esp_ota_img_states_t g_runningState = ESP_OTA_IMG_VALID;
+
+std::vector<uint8_t>* flashOf(const esp_partition_t* partition) {
+  if (partition == &g_slots[0]) return &g_flash[0];
+  if (partition == &g_slots[1]) return &g_flash[1];
+  return nullptr;
+}
+
+bool inRange(const esp_partition_t* partition, size_t offset, size_t size) {
+  return partition && offset <= partition->size && size <= partition->size - offset;
+}
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size) {
+  std::vector<uint8_t>* flash = flashOf(partition);
+  if (!flash || !inRange(partition, offset, size) || offset % SECTOR_BYTES || size % SECTOR_BYTES) return ESP_ERR_INVALID_ARG;
+  if (flash->empty()) flash->assign(partition->size, 0x00);
+  memset(flash->data() + offset, 0xFF, size);
+  g_eraseLog.push_back(size);
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t offset, const void* src, size_t size) {
+  std::vector<uint8_t>* flash = flashOf(partition);
+  if (!flash || !inRange(partition, offset, size)) return ESP_ERR_INVALID_ARG;
+  if (flash->empty()) flash->assign(partition->size, 0x00);
+  for (size_t i = 0; i < size; ++i) {
+    if ((*flash)[offset + i] != 0xFF) return ESP_FAIL;
+  }
+  memcpy(flash->data() + offset, src, size);
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t offset, void* dst, size_t size) {
+  std::vector<uint8_t>* flash = flashOf(partition);
+  if (!flash || !inRange(partition, offset, size)) return ESP_ERR_INVALID_ARG;
+  if (flash->empty()) flash->assign(partition->size, 0x00);
+  memcpy(dst, flash->data() + offset, size);
+  return ESP_OK;
+}
+
+const esp_partition_t* esp_ota_get_running_partition() { return &g_slots[g_running]; }
+
+const esp_partition_t* esp_ota_get_next_update_partition(const esp_partition_t* startFrom) {
+  return &g_slots[1 - g_running];
+}
+
+esp_err_t esp_ota_get_state_partition(const esp_partition_t* partition, esp_ota_img_states_t* state) {
+  if (partition != &g_slots[g_running]) return ESP_FAIL;
+  *state = g_runningState;
+  return ESP_OK;
+}
+
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t* partition) {
+  if (!flashOf(partition)) return ESP_ERR_INVALID_ARG;
+  g_boot = partition == &g_slots[0] ? 0 : 1;
+  return ESP_OK;
+}
+
+esp_err_t esp_ota_mark_app_valid_cancel_rollback() {
+  g_runningState = ESP_OTA_IMG_VALID;
+  return ESP_OK;
+}
+
+esp_err_t esp_ota_mark_app_invalid_rollback_and_reboot() {
+  g_runningState = ESP_OTA_IMG_INVALID;
+  return ESP_FAIL;
+}
+
+namespace hostflash {
+
+const std::vector<uint8_t>& contents(const esp_partition_t* partition) {
+  static const std::vector<uint8_t> none;
+  std::vector<uint8_t>* flash = flashOf(partition);
+  return flash ? *flash : none;
+}
+
+const std::vector<size_t>& eraseLog() { return g_eraseLog; }
+
+void reset() {
+  g_flash[0].assign(SLOT_BYTES, 0x00);
+  g_flash[1].assign(SLOT_BYTES, 0x00);
+  g_eraseLog.clear();
+}
+
+} // namespace hostflash
+
+namespace hostota {
+
+const esp_partition_t* bootPartition() { return g_boot < 0 ? nullptr : &g_slots[g_boot]; }
+
+void reboot() {
+  if (g_boot >= 0 && g_boot != g_running) {
+    g_running = g_boot;
+    g_runningState = ESP_OTA_IMG_PENDING_VERIFY;
+  }
+  g_boot = -1;
+}
+
+void reset() {
+  g_running = 0;
+  g_boot = -1;
+  g_runningState = ESP_OTA_IMG_VALID;
+}
+
+} // namespace hostota
@@ -0,0 +1,188 @@
+/**
+ * @file HostHttpClient.cpp
+ * @brief Plain HTTP/1.1 client over POSIX sockets behind `stubs/esp_http_client.h`.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "esp_http_client.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <strings.h>
+
+/**
+ * @brief Client state.
+ */
+struct esp_http_client {
+  esp_http_client_config_t config;            ///< Copy of the configuration.
+  std::string host;                           ///< Host from the URL (IPv4 literal).
+  uint16_t port = 80;                         ///< Port from the URL.
+  std::string path;                           ///< Path from the URL.
+  std::map<std::string, std::string> headers; ///< Request headers.
+  int fd = -1;                                ///< Socket, or -1.
+  std::string pending;                        ///< Received bytes not yet consumed.
+  int status = 0;                             ///< Status code of the response.
+  int64_t contentLength = -1;                 ///< Content-Length of the response, or -1.
+  int64_t bodyRead = 0;                       ///< Body bytes returned by read().
+};
+
+namespace {
+bool parseUrl(esp_http_client* client, const char* url) {
+  const char* prefix = "http://";
+  if (!url || strncmp(url, prefix, strlen(prefix)) != 0) return false;
+  const std::string rest(url + strlen(prefix));
+  const size_t slash = rest.find('/');
+  const std::string authority = rest.substr(0, slash);
+  client->path = slash == std::string::npos ? "/" : rest.substr(slash);
+  const size_t colon = authority.find(':');
+  client->host = authority.substr(0, colon);
+  if (colon != std::string::npos) client->port = (uint16_t)atoi(authority.c_str() + colon + 1);
+  return true;
+}
+
+/// Receives more bytes into `pending`. Returns false on error or when the peer closed.
+bool receiveMore(esp_http_client* client) {
+  char buffer[4096];
+  const ssize_t n = recv(client->fd, buffer, sizeof(buffer), 0);
+  if (n <= 0) return false;
+  client->pending.append(buffer, (size_t)n);
+  return true;
+}
+}
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t* config) {
+  esp_http_client* client = new esp_http_client();
+  client->config = *config;
+  if (!parseUrl(client, config->url)) {
+    delete client;
+    return nullptr;
+  }
+  return client;
+}
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char* key, const char* value) {
+  client->headers[key] = value;
+  return ESP_OK;
+}
+
+esp_err_t esp_http_client_delete_header(esp_http_client_handle_t client, const char* key) {
+  client->headers.erase(key);
+  return ESP_OK;
+}
+
+esp_err_t esp_http_client_open(esp_http_client_handle_t client, int writeLength) {
+  esp_http_client_close(client);
+  client->fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (client->fd < 0) return ESP_FAIL;
+  timeval timeout = { client->config.timeout_ms / 1000, (client->config.timeout_ms % 1000) * 1000 };
+  setsockopt(client->fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(client->port);
+  if (inet_pton(AF_INET, client->host.c_str(), &address.sin_addr) != 1 ||
+      connect(client->fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+    esp_http_client_close(client);
+    return ESP_FAIL;
+  }
+  std::string request = "GET " + client->path + " HTTP/1.1\r\nHost: " + client->host + "\r\nConnection: close\r\n";
+  for (const auto& header : client->headers) request += header.first + ": " + header.second + "\r\n";
+  request += "\r\n";
+  if (send(client->fd, request.data(), request.size(), MSG_NOSIGNAL) != (ssize_t)request.size()) {
+    esp_http_client_close(client);
+    return ESP_FAIL;
+  }
+  return ESP_OK;
+}
+
+int64_t esp_http_client_fetch_headers(esp_http_client_handle_t client) {
+  size_t end;
+  while ((end = client->pending.find("\r\n\r\n")) == std::string::npos) {
+    if (client->fd < 0 || !receiveMore(client)) return -1;
+  }
+  const std::string head = client->pending.substr(0, end);
+  client->pending.erase(0, end + 4);
+
+  size_t lineEnd = head.find("\r\n");
+  const std::string statusLine = head.substr(0, lineEnd);
+  const size_t space = statusLine.find(' ');
+  client->status = space == std::string::npos ? 0 : atoi(statusLine.c_str() + space + 1);
+  while (lineEnd != std::string::npos) {
+    const size_t start = lineEnd + 2;
+    lineEnd = head.find("\r\n", start);
+    const std::string line = head.substr(start, lineEnd == std::string::npos ? std::string::npos : lineEnd - start);
+    const size_t colon = line.find(':');
+    if (colon == std::string::npos) continue;
+    std::string key = line.substr(0, colon);
+    std::string value = line.substr(line.find_first_not_of(' ', colon + 1));
+    if (strcasecmp(key.c_str(), "Content-Length") == 0) client->contentLength = atoll(value.c_str());
+    if (client->config.event_handler) {
+      esp_http_client_event_t event = {};
+      event.event_id = HTTP_EVENT_ON_HEADER;
+      event.client = client;
+      event.user_data = client->config.user_data;
+      event.header_key = key.data();
+      event.header_value = value.data();
+      client->config.event_handler(&event);
+    }
+  }
+  return client->contentLength;
+}
+
+int esp_http_client_get_status_code(esp_http_client_handle_t client) { return client->status; }
+
+int esp_http_client_read(esp_http_client_handle_t client, char* buffer, int length) {
+  if (client->contentLength >= 0) {
+    length = (int)std::min<int64_t>(length, client->contentLength - client->bodyRead);
+  }
+  if (length <= 0) return 0;
+  if (client->pending.empty() && (client->fd < 0 || !receiveMore(client))) return 0;
+  const int n = std::min<int>(length, (int)client->pending.size());
+  memcpy(buffer, client->pending.data(), n);
+  client->pending.erase(0, n);
+  client->bodyRead += n;
+  return n;
+}
+
+bool esp_http_client_is_complete_data_received(esp_http_client_handle_t client) {
+  return client->contentLength >= 0 && client->bodyRead == client->contentLength;
+}
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t client) {
+  if (client->fd >= 0) close(client->fd);
+  client->fd = -1;
+  client->pending.clear();
+  client->status = 0;
+  client->contentLength = -1;
+  client->bodyRead = 0;
+  return ESP_OK;
+}
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client) {
+  esp_http_client_close(client);
+  delete client;
+  return ESP_OK;
+}
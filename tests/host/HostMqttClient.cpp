@@ -0,0 +1,236 @@
+/**
+ * @file HostMqttClient.cpp
+ * @brief MQTT 3.1.1 client over POSIX sockets behind `stubs/mqtt_client.h`.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "mqtt_client.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Client state.
+ */
+struct esp_mqtt_client {
+  std::string host;                     ///< Broker address (IPv4 literal).
+  uint16_t port = 1883;                 ///< Broker port.
+  std::string clientId;                 ///< Client id.
+  std::string username;                 ///< User name, or empty.
+  std::string password;                 ///< Password, or empty.
+  esp_event_handler_t handler = nullptr; ///< Event handler.
+  void* handlerArgs = nullptr;          ///< Passed to the handler.
+  std::thread thread;                   ///< Network thread.
+  std::atomic<bool> stop{false};        ///< Asks the network thread to end.
+  std::mutex sendMutex;                 ///< Serializes writes to `fd`.
+  int fd = -1;                          ///< Socket while connected, else -1 (guarded by `sendMutex`).
+  uint16_t nextMsgId = 0;               ///< Last packet identifier used.
+};
+
+namespace {
+void putString(std::vector<uint8_t>& out, const std::string& text) {
+  out.push_back((uint8_t)(text.size() >> 8));
+  out.push_back((uint8_t)text.size());
+  out.insert(out.end(), text.begin(), text.end());
+}
+
+/// Prefixes `body` with the fixed header (packet type and remaining length).
+std::vector<uint8_t> packet(uint8_t type, const std::vector<uint8_t>& body) {
+  std::vector<uint8_t> out = { type };
+  size_t length = body.size();
+  do {
+    uint8_t b = length & 0x7F;
+    length >>= 7;
+    out.push_back(length ? (b | 0x80) : b);
+  } while (length);
+  out.insert(out.end(), body.begin(), body.end());
+  return out;
+}
+
+bool readExact(int fd, uint8_t* data, size_t length) {
+  while (length) {
+    const ssize_t n = recv(fd, data, length, 0);
+    if (n <= 0) return false;
+    data += n;
+    length -= (size_t)n;
+  }
+  return true;
+}
+
+/// Reads one packet. Returns false when the connection ended.
+bool readPacket(int fd, uint8_t* type, std::vector<uint8_t>& body) {
+  if (!readExact(fd, type, 1)) return false;
+  size_t length = 0;
+  for (int shift = 0; ; shift += 7) {
+    uint8_t b;
+    if (shift > 21 || !readExact(fd, &b, 1)) return false;
+    length |= (size_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) break;
+  }
+  body.resize(length);
+  return readExact(fd, body.data(), length);
+}
+
+void emit(esp_mqtt_client* client, esp_mqtt_event_id_t id, int msgId) {
+  if (!client->handler) return;
+  esp_mqtt_event_t event = { id, client, msgId };
+  client->handler(client->handlerArgs, "MQTT_EVENTS", id, &event);
+}
+
+/// Connects and completes the CONNECT handshake. Returns the socket, or -1.
+int connectBroker(esp_mqtt_client* client) {
+  const int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(client->port);
+  if (inet_pton(AF_INET, client->host.c_str(), &address.sin_addr) != 1 ||
+      connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+    close(fd);
+    return -1;
+  }
+  const int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // Small packets, sent at once (as lwIP does).
+  std::vector<uint8_t> body;
+  putString(body, "MQTT");
+  body.push_back(4); // Protocol level 3.1.1.
+  uint8_t flags = 0x02; // Clean session.
+  if (!client->username.empty()) flags |= 0x80;
+  if (!client->password.empty()) flags |= 0x40;
+  body.push_back(flags);
+  body.push_back(0);
+  body.push_back(60); // Keep alive (s); the tests never idle that long.
+  putString(body, client->clientId);
+  if (!client->username.empty()) putString(body, client->username);
+  if (!client->password.empty()) putString(body, client->password);
+  const std::vector<uint8_t> connectPacket = packet(0x10, body);
+  uint8_t type;
+  std::vector<uint8_t> reply;
+  if (send(fd, connectPacket.data(), connectPacket.size(), MSG_NOSIGNAL) != (ssize_t)connectPacket.size() ||
+      !readPacket(fd, &type, reply) || type != 0x20 || reply.size() != 2 || reply[1] != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+void networkThread(esp_mqtt_client* client) {
+  while (!client->stop.load()) {
+    const int fd = connectBroker(client);
+    if (fd < 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      continue;
+    }
+    {
+      std::lock_guard<std::mutex> lock(client->sendMutex);
+      client->fd = fd;
+    }
+    emit(client, MQTT_EVENT_CONNECTED, 0);
+    uint8_t type;
+    std::vector<uint8_t> body;
+    while (readPacket(fd, &type, body)) {
+      if ((type & 0xF0) == 0x40 && body.size() == 2) { // PUBACK
+        emit(client, MQTT_EVENT_PUBLISHED, (body[0] << 8) | body[1]);
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(client->sendMutex);
+      client->fd = -1;
+    }
+    close(fd);
+    emit(client, MQTT_EVENT_DISCONNECTED, 0);
+    if (!client->stop.load()) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+}
+}
+
+esp_mqtt_client_handle_t esp_mqtt_client_init(const esp_mqtt_client_config_t* config) {
+  const char* prefix = "mqtt://";
+  const char* uri = config->broker.address.uri;
+  if (!uri || strncmp(uri, prefix, strlen(prefix)) != 0) return nullptr;
+  esp_mqtt_client* client = new esp_mqtt_client();
+  const std::string authority(uri + strlen(prefix));
+  const size_t colon = authority.find(':');
+  client->host = authority.substr(0, colon);
+  if (colon != std::string::npos) client->port = (uint16_t)atoi(authority.c_str() + colon + 1);
+  if (config->credentials.client_id) client->clientId = config->credentials.client_id;
+  if (config->credentials.username) client->username = config->credentials.username;
+  if (config->credentials.authentication.password) client->password = config->credentials.authentication.password;
+  return client;
+}
+
+esp_err_t esp_mqtt_client_register_event(esp_mqtt_client_handle_t client, esp_mqtt_event_id_t event,
+                                         esp_event_handler_t handler, void* handlerArgs) {
+  client->handler = handler;
+  client->handlerArgs = handlerArgs;
+  return ESP_OK;
+}
+
+esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t client) {
+  if (client->thread.joinable()) return ESP_FAIL;
+  client->stop = false;
+  client->thread = std::thread(networkThread, client);
+  return ESP_OK;
+}
+
+int esp_mqtt_client_publish(esp_mqtt_client_handle_t client, const char* topic, const char* data, int length,
+                            int qos, int retain) {
+  std::lock_guard<std::mutex> lock(client->sendMutex);
+  if (client->fd < 0) return -1;
+  std::vector<uint8_t> body;
+  putString(body, topic);
+  int msgId = 0;
+  if (qos > 0) {
+    if (++client->nextMsgId == 0) client->nextMsgId = 1;
+    msgId = client->nextMsgId;
+    body.push_back((uint8_t)(msgId >> 8));
+    body.push_back((uint8_t)msgId);
+  }
+  body.insert(body.end(), data, data + length);
+  const std::vector<uint8_t> out = packet((uint8_t)(0x30 | (qos > 0 ? 0x02 : 0) | (retain ? 0x01 : 0)), body);
+  if (send(client->fd, out.data(), out.size(), MSG_NOSIGNAL) != (ssize_t)out.size()) return -1;
+  return msgId;
+}
+
+esp_err_t esp_mqtt_client_stop(esp_mqtt_client_handle_t client) {
+  client->stop = true;
+  {
+    std::lock_guard<std::mutex> lock(client->sendMutex);
+    if (client->fd >= 0) shutdown(client->fd, SHUT_RDWR); // Ends the read loop.
+  }
+  if (client->thread.joinable()) client->thread.join();
+  return ESP_OK;
+}
+
+esp_err_t esp_mqtt_client_destroy(esp_mqtt_client_handle_t client) {
+  esp_mqtt_client_stop(client);
+  delete client;
+  return ESP_OK;
+}
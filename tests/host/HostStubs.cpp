@@ -0,0 +1,82 @@
+/**
+ * @file HostStubs.cpp
+ * @brief Storage for the host stand-ins declared in `stubs/`.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "Arduino.h"
+#include "freertos/task.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+HostSerial Serial;
+HostEspClass ESP;
+
+namespace hostclock {
+
+namespace {
+std::atomic<uint64_t> g_nowUs{0}; ///< Simulated time since boot.
+}
+
+uint64_t nowUs() { return g_nowUs.load(); }
+void advanceUs(uint64_t us) { g_nowUs += us; }
+void reset() { g_nowUs = 0; }
+
+} // namespace hostclock
+
+void esp_restart() {
+  std::fprintf(stderr, "esp_restart() called\n");
+  std::abort();
+}
+
+namespace hosttask {
+
+namespace {
+std::atomic<bool> g_threaded{false}; ///< New tasks get their own thread.
+thread_local bool t_onTaskThread = false;
+}
+
+void setThreaded(bool threaded) { g_threaded = threaded; }
+bool onTaskThread() { return t_onTaskThread; }
+
+} // namespace hosttask
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* arg,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core) {
+  static int taskCount = 0;
+  if (handle) *handle = &taskCount; // Set before the task starts, as on the device.
+  taskCount++;
+  if (!hosttask::g_threaded.load()) {
+    fn(arg);
+    return pdPASS;
+  }
+  std::thread([fn, arg]() {
+    hosttask::t_onTaskThread = true;
+    fn(arg);
+  }).detach();
+  return pdPASS;
+}
+
+void vTaskDelay(TickType_t ticks) {
+  if (!hosttask::onTaskThread()) hostclock::advanceMs(ticks * portTICK_PERIOD_MS);
+  if (hosttask::g_threaded.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
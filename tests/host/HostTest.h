@@ -0,0 +1,109 @@
+/**
+ * @file HostTest.h
+ * @brief Minimal test registry and check macros for the host tests.
+ *
+ * Each test executable links `HostTestMain.cpp`, which runs every `HOST_TEST` of the
+ * executable and returns non-zero if a check failed, so ctest reports it.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace hosttest {
+
+/**
+ * @brief A registered test case.
+ */
+struct TestCase {
+  const char* name;            ///< Name printed in the report.
+  std::function<void()> body;  ///< The test body.
+};
+
+/**
+ * @brief Returns the registry of the test cases in this executable.
+ * @return The registry.
+ */
+inline std::vector<TestCase>& registry() {
+  static std::vector<TestCase> tests;
+  return tests;
+}
+
+/**
+ * @brief Returns the number of failed checks in the current executable.
+ * @return The failure counter.
+ */
+inline int& failures() {
+  static int count = 0;
+  return count;
+}
+
+/**
+ * @brief Registers a test case at static initialization time.
+ */
+struct Registrar {
+  Registrar(const char* name, std::function<void()> body) { registry().push_back({ name, std::move(body) }); }
+};
+
+/**
+ * @brief Records a failed check.
+ * @param file Source file of the check.
+ * @param line Source line of the check.
+ * @param what Text of the failed expression.
+ */
+inline void fail(const char* file, int line, const std::string& what) {
+  failures()++;
+  std::printf("  FAILED %s:%d: %s\n", file, line, what.c_str());
+}
+
+} // namespace hosttest
+
+#define HOST_TEST_CONCAT_INNER(a, b) a##b
+#define HOST_TEST_CONCAT(a, b) HOST_TEST_CONCAT_INNER(a, b)
+
+/// Defines and registers a test case.
+#define HOST_TEST(name)                                                              \
+  static void name();                                                                \
+  static hosttest::Registrar HOST_TEST_CONCAT(name, _registrar)(#name, name);        \
+  static void name()
+
+/// Fails the current test (and continues) if the condition is false.
+#define CHECK(cond)                                                                  \
+  do { if (!(cond)) hosttest::fail(__FILE__, __LINE__, #cond); } while (0)
+
+/// Fails the current test (and continues) if the two values differ.
+#define CHECK_EQ(a, b)                                                               \
+  do {                                                                               \
+    const auto& _a = (a); const auto& _b = (b);                                      \
+    if (!(_a == _b)) hosttest::fail(__FILE__, __LINE__,                              \
+        std::string(#a " == " #b " (") + std::to_string(_a) + " vs " + std::to_string(_b) + ")"); \
+  } while (0)
+
+/// Fails the current test and returns from it if the condition is false.
+#define REQUIRE(cond)                                                                \
+  do { if (!(cond)) { hosttest::fail(__FILE__, __LINE__, #cond); return; } } while (0)
+
+#endif // HOST_TEST_H
@@ -0,0 +1,39 @@
+/**
+ * @file HostTestMain.cpp
+ * @brief Runs every test case registered in a host test executable.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "HostTest.h"
+#include "Arduino.h"
+
+int main() {
+  int failedTests = 0;
+  for (const hosttest::TestCase& test : hosttest::registry()) {
+    const int before = hosttest::failures();
+    hostclock::reset();
+    test.body();
+    const bool ok = hosttest::failures() == before;
+    if (!ok) failedTests++;
+    std::printf("[%s] %s\n", ok ? "PASS" : "FAIL", test.name);
+  }
+  std::printf("%d of %zu tests failed.\n", failedTests, hosttest::registry().size());
+  return failedTests ? 1 : 0;
+}
@@ -0,0 +1,370 @@
+/**
+ * @file OtaUpdaterTest.cpp
+ * @brief Checks the OtaUpdater against a local HTTP server: sector-sized erases, resume with If-Range, restart when the image changed, and manifest-driven updates across a simulated restart.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "HostTest.h"
+#include "OtaUpdater.h"
+#include "SystemInitializer.h"
+#include "WifiManager.h"
+#include <Preferences.h>
+#include <esp_ota_ops.h>
+#include <mbedtls/sha256.h>
+#include <arpa/inet.h>
+#include <mutex>
+#include <netinet/in.h>
+#include <string>
+#include <strings.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+SystemStatus g_systemStatus = SystemStatus::BOOTING;
+
+namespace {
+
+/**
+ * @brief One request as seen by the server.
+ */
+struct Request {
+  std::string path;    ///< Request path.
+  std::string range;   ///< Range header, or empty.
+  std::string ifRange; ///< If-Range header, or empty.
+  int status;          ///< Status code of the response.
+};
+
+/**
+ * @brief HTTP server on the loopback interface serving "/image" (with Range, If-Range and ETag)
+ * and "/manifest". One request per connection.
+ */
+class ImageServer {
+public:
+  ImageServer() {
+    _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    const int one = 1;
+    setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    socklen_t length = sizeof(address);
+    getsockname(_listenFd, reinterpret_cast<sockaddr*>(&address), &length);
+    _port = ntohs(address.sin_port);
+    listen(_listenFd, 4);
+    _thread = std::thread([this]() { _serve(); });
+  }
+
+  ~ImageServer() {
+    shutdown(_listenFd, SHUT_RDWR); // Wakes up accept().
+    _thread.join();
+    close(_listenFd);
+  }
+
+  std::string url(const char* path) const { return "http://127.0.0.1:" + std::to_string(_port) + path; }
+
+  void setImage(std::vector<uint8_t> image, std::string etag) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _image = std::move(image);
+    _etag = std::move(etag);
+  }
+
+  void setManifest(std::string manifest) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _manifest = std::move(manifest);
+  }
+
+  /// Closes the connection of the next image response after `bytes` body bytes.
+  void dropNextAfter(long bytes) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _dropAfter = bytes;
+  }
+
+  std::vector<Request> requests() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _requests;
+  }
+
+private:
+  int _listenFd;
+  uint16_t _port;
+  std::thread _thread;
+  std::mutex _mutex;
+  std::vector<uint8_t> _image;
+  std::string _etag;
+  std::string _manifest;
+  long _dropAfter = -1;
+  std::vector<Request> _requests;
+
+  void _serve() {
+    for (;;) {
+      const int fd = accept(_listenFd, nullptr, nullptr);
+      if (fd < 0) return;
+      _handle(fd);
+      close(fd);
+    }
+  }
+
+  void _handle(int fd) {
+    std::string head;
+    char c;
+    while (head.find("\r\n\r\n") == std::string::npos && recv(fd, &c, 1, 0) == 1) head += c;
+
+    Request request = {};
+    const size_t pathStart = head.find(' ') + 1;
+    request.path = head.substr(pathStart, head.find(' ', pathStart) - pathStart);
+    for (size_t pos = head.find("\r\n"); pos != std::string::npos && pos + 2 < head.size(); ) {
+      const size_t end = head.find("\r\n", pos + 2);
+      const std::string line = head.substr(pos + 2, end - pos - 2);
+      const size_t colon = line.find(':');
+      if (colon != std::string::npos) {
+        const std::string value = line.substr(line.find_first_not_of(' ', colon + 1));
+        if (strncasecmp(line.c_str(), "Range:", 6) == 0) request.range = value;
+        if (strncasecmp(line.c_str(), "If-Range:", 9) == 0) request.ifRange = value;
+      }
+      pos = end;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::string headers;
+    std::string body;
+    long dropAfter = -1;
+    if (request.path == "/manifest" && !_manifest.empty()) {
+      request.status = 200;
+      body = _manifest;
+    } else if (request.path == "/image") {
+      size_t first = 0;
+      const bool rangeValid = sscanf(request.range.c_str(), "bytes=%zu-", &first) == 1 && first < _image.size();
+      // If-Range: the range only applies if the validator still matches the image.
+      if (rangeValid && (request.ifRange.empty() || request.ifRange == _etag)) {
+        request.status = 206;
+        headers += "Content-Range: bytes " + std::to_string(first) + "-" + std::to_string(_image.size() - 1) +
+                   "/" + std::to_string(_image.size()) + "\r\n";
+      } else {
+        request.status = 200;
+        first = 0;
+      }
+      if (!_etag.empty()) headers += "ETag: " + _etag + "\r\n";
+      body.assign(_image.begin() + first, _image.end());
+      dropAfter = _dropAfter;
+      _dropAfter = -1;
+    } else {
+      request.status = 404;
+    }
+    _requests.push_back(request);
+
+    std::string response = "HTTP/1.1 " + std::to_string(request.status) + (request.status == 404 ? " Not Found" : " OK") +
+                           "\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n" +
+                           headers + "\r\n";
+    response += dropAfter >= 0 ? body.substr(0, dropAfter) : body;
+    send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+  }
+};
+
+std::vector<uint8_t> makeImage(size_t size, uint32_t seed) {
+  std::vector<uint8_t> image(size);
+  for (uint8_t& b : image) {
+    seed = seed * 1664525u + 1013904223u;
+    b = (uint8_t)(seed >> 24);
+  }
+  return image;
+}
+
+std::string sha256Hex(const std::vector<uint8_t>& data) {
+  mbedtls_sha256_context ctx;
+  mbedtls_sha256_init(&ctx);
+  mbedtls_sha256_starts(&ctx, 0);
+  mbedtls_sha256_update(&ctx, data.data(), data.size());
+  uint8_t digest[32];
+  mbedtls_sha256_finish(&ctx, digest);
+  char hex[65];
+  for (int i = 0; i < 32; ++i) snprintf(hex + i * 2, 3, "%02x", digest[i]);
+  return hex;
+}
+
+OtaUpdaterConfig makeConfig(const char* manifestUrl) {
+  return OtaUpdaterConfig{
+    .chunkBytes = 1024, .checkpointBytes = 4096, .httpTimeoutMs = 2000,
+    .progressIntervalMs = 500, .confirmAfterMs = 30000, .restartDelayMs = 0xFFFFFFFFu,
+    .autoResume = false, .manifestUrl = manifestUrl, .checkIntervalMs = 3600000,
+    .taskStackSize = 8192, .taskPriority = 1, .taskCore = 0
+  };
+}
+
+/// True if the update slot starts with `image`.
+bool flashHolds(const std::vector<uint8_t>& image) {
+  const std::vector<uint8_t>& flash = hostflash::contents(esp_ota_get_next_update_partition(nullptr));
+  return flash.size() >= image.size() && std::equal(image.begin(), image.end(), flash.begin());
+}
+
+std::string pref(const char* key) {
+  auto it = hostprefs::store().find(std::string("ota/") + key);
+  return it == hostprefs::store().end() ? std::string() : it->second;
+}
+
+void resetDevice() {
+  hostprefs::clear();
+  hostflash::reset();
+  hostota::reset();
+  g_systemStatus = SystemStatus::OPERATIONAL;
+}
+
+constexpr size_t IMAGE_BYTES = 5 * 4096 + 123;
+constexpr long DROP_AFTER = 2 * 4096 + 100;
+
+} // namespace
+
+HOST_TEST(fullDownloadErasesOneSectorAtATime) {
+  resetDevice();
+  ImageServer server;
+  const std::vector<uint8_t> image = makeImage(IMAGE_BYTES, 1);
+  server.setImage(image, "\"v1\"");
+  const OtaUpdaterConfig config = makeConfig("");
+  WifiManager wifi;
+  OtaUpdater updater(&wifi, nullptr);
+  REQUIRE(updater.init(config));
+
+  REQUIRE(updater.startUpdate(server.url("/image"), sha256Hex(image)));
+  CHECK(updater.getState() == OtaState::READY_TO_REBOOT);
+  CHECK(updater.getLastError() == OtaError::NONE);
+  CHECK(flashHolds(image));
+  CHECK(hostota::bootPartition() == esp_ota_get_next_update_partition(nullptr));
+  CHECK_EQ(hostflash::eraseLog().size(), (size_t)6);
+  for (size_t bytes : hostflash::eraseLog()) CHECK_EQ(bytes, (size_t)4096);
+  CHECK_EQ(server.requests().size(), (size_t)1);
+  CHECK(server.requests()[0].range.empty());
+  CHECK(pref("url").empty()); // Checkpoint cleared.
+  CHECK(pref("nextsha") == sha256Hex(image));
+}
+
+HOST_TEST(interruptedDownloadResumesWithIfRange) {
+  resetDevice();
+  ImageServer server;
+  const std::vector<uint8_t> image = makeImage(IMAGE_BYTES, 2);
+  server.setImage(image, "\"v1\"");
+  server.dropNextAfter(DROP_AFTER);
+  const OtaUpdaterConfig config = makeConfig("");
+  WifiManager wifi;
+  OtaUpdater updater(&wifi, nullptr);
+  REQUIRE(updater.init(config));
+
+  REQUIRE(updater.startUpdate(server.url("/image"), sha256Hex(image)));
+  CHECK(updater.getState() == OtaState::FAILED);
+  CHECK(updater.getLastError() == OtaError::HTTP);
+  CHECK(pref("bytes") == "8192"); // Last sector boundary before the drop.
+  CHECK(pref("etag") == "\"v1\"");
+  CHECK(pref("len") == std::to_string(IMAGE_BYTES));
+
+  const size_t erasesBefore = hostflash::eraseLog().size();
+  REQUIRE(updater.startUpdate(server.url("/image"), sha256Hex(image)));
+  CHECK(updater.getState() == OtaState::READY_TO_REBOOT);
+  const std::vector<Request> requests = server.requests();
+  REQUIRE(requests.size() == 2);
+  CHECK(requests[1].range == "bytes=8192-");
+  CHECK(requests[1].ifRange == "\"v1\"");
+  CHECK_EQ(requests[1].status, 206);
+  CHECK_EQ(hostflash::eraseLog().size() - erasesBefore, (size_t)4); // Sectors 2..5 only.
+  CHECK(flashHolds(image));
+}
+
+HOST_TEST(changedImageRestartsFromZero) {
+  resetDevice();
+  ImageServer server;
+  server.setImage(makeImage(IMAGE_BYTES, 3), "\"v1\"");
+  server.dropNextAfter(DROP_AFTER);
+  const OtaUpdaterConfig config = makeConfig("");
+  WifiManager wifi;
+  OtaUpdater updater(&wifi, nullptr);
+  REQUIRE(updater.init(config));
+  REQUIRE(updater.startUpdate(server.url("/image"), ""));
+  CHECK(updater.getState() == OtaState::FAILED);
+
+  const std::vector<uint8_t> newImage = makeImage(IMAGE_BYTES, 4); // Same size, new content.
+  server.setImage(newImage, "\"v2\"");
+  REQUIRE(updater.startUpdate(server.url("/image"), ""));
+  CHECK(updater.getState() == OtaState::READY_TO_REBOOT);
+  const std::vector<Request> requests = server.requests();
+  REQUIRE(requests.size() == 2);
+  CHECK(requests[1].ifRange == "\"v1\"");
+  CHECK_EQ(requests[1].status, 200); // If-Range did not match: whole image.
+  CHECK(flashHolds(newImage));
+}
+
+HOST_TEST(withoutEtagAChangedLengthRestartsFromZero) {
+  resetDevice();
+  ImageServer server;
+  server.setImage(makeImage(IMAGE_BYTES, 5), "");
+  server.dropNextAfter(DROP_AFTER);
+  const OtaUpdaterConfig config = makeConfig("");
+  WifiManager wifi;
+  OtaUpdater updater(&wifi, nullptr);
+  REQUIRE(updater.init(config));
+  REQUIRE(updater.startUpdate(server.url("/image"), ""));
+  CHECK(updater.getState() == OtaState::FAILED);
+
+  const std::vector<uint8_t> newImage = makeImage(IMAGE_BYTES + 4096, 6);
+  server.setImage(newImage, "");
+  REQUIRE(updater.startUpdate(server.url("/image"), ""));
+  CHECK(updater.getState() == OtaState::READY_TO_REBOOT);
+  const std::vector<Request> requests = server.requests();
+  REQUIRE(requests.size() == 3);
+  CHECK(requests[1].range == "bytes=8192-");
+  CHECK(requests[1].ifRange.empty());
+  CHECK_EQ(requests[1].status, 206); // Served, but the Content-Range total no longer matches...
+  CHECK(requests[2].range.empty());  // ...so the updater asks for the whole image.
+  CHECK(flashHolds(newImage));
+}
+
+HOST_TEST(manifestInstallsOnceAndSkipsTheRunningImage) {
+  resetDevice();
+  ImageServer server;
+  const std::vector<uint8_t> image = makeImage(IMAGE_BYTES, 7);
+  server.setImage(image, "\"v1\"");
+  server.setManifest(server.url("/image") + " " + sha256Hex(image) + "\n");
+  const std::string manifestUrl = server.url("/manifest");
+  const OtaUpdaterConfig config = makeConfig(manifestUrl.c_str());
+  WifiManager wifi;
+  {
+    OtaUpdater updater(&wifi, nullptr);
+    REQUIRE(updater.init(config));
+    updater.loop(); // Not connected: no check.
+    CHECK(server.requests().empty());
+    wifi.setState(WifiMgr_State_t::CONNECTED);
+    updater.loop();
+    CHECK(updater.getState() == OtaState::READY_TO_REBOOT);
+    CHECK_EQ(server.requests().size(), (size_t)2);
+  }
+
+  hostota::reboot();
+  OtaUpdater updater(&wifi, nullptr);
+  REQUIRE(updater.init(config));
+  CHECK(updater.isPendingVerify());
+  updater.loop(); // No check before the new image is confirmed.
+  CHECK_EQ(server.requests().size(), (size_t)2);
+
+  hostclock::advanceMs(config.confirmAfterMs);
+  updater.loop();
+  CHECK(!updater.isPendingVerify());
+  CHECK(updater.getState() == OtaState::IDLE);
+  const std::vector<Request> requests = server.requests();
+  REQUIRE(requests.size() == 3);
+  CHECK(requests[2].path == "/manifest"); // Same hash as the running image: nothing downloaded.
+}
@@ -0,0 +1,245 @@
+/**
+ * @file RadioSchedulerTest.cpp
+ * @brief Steps the RadioScheduler with a SimulatedRadioClock: priority ordering, deadline
+ * expiry and coexistence switching.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "HostTest.h"
+#include "RadioScheduler.h"
+#include "SystemInitializer.h" // For RadioSchedulerConfig
+
+namespace {
+
+const RadioSchedulerConfig kConfig = {
+  .slicePeriodMs = 100,
+  .minSliceMs = 30,
+  .defaultDeadlineMs = 500,
+  .timelineCapacity = 16,
+  .applyCoexPreference = false,
+};
+
+/**
+ * @brief Scheduler on a simulated clock that records start order, expiries and coexistence changes.
+ */
+struct Harness {
+  SimulatedRadioClock clock;
+  RadioScheduler scheduler{ &clock };
+  std::vector<RadioRequestId> started;
+  std::vector<RadioRequestId> expired;
+  std::vector<RadioCoexMode> coexChanges;
+
+  Harness() {
+    clock.setMs(1000);
+    scheduler.setCoexHandler([this](RadioCoexMode mode) { coexChanges.push_back(mode); });
+    scheduler.init(kConfig);
+  }
+
+  RadioRequestId submit(RadioOwner owner, RadioOpKind kind, RadioPriority priority,
+                        uint32_t deadlineMs = 0, uint32_t durationMs = 0) {
+    RadioRequest request;
+    request.owner = owner;
+    request.kind = kind;
+    request.priority = priority;
+    request.deadlineMs = deadlineMs;
+    request.durationMs = durationMs;
+    request.onStart = [this](RadioRequestId id) { started.push_back(id); };
+    request.onExpired = [this](RadioRequestId id) { expired.push_back(id); };
+    return scheduler.submit(request);
+  }
+
+  void step(uint32_t ms) {
+    clock.advanceMs(ms);
+    scheduler.loop();
+  }
+};
+
+int coexValue(RadioCoexMode mode) { return static_cast<int>(mode); }
+
+} // namespace
+
+HOST_TEST(exclusiveRequestsStartByPriorityThenDeadline) {
+  Harness h;
+  RadioRequestId normal = h.submit(RadioOwner::WIFI, RadioOpKind::SCAN, RadioPriority::NORMAL, 400);
+  RadioRequestId interactiveLate = h.submit(RadioOwner::WIFI, RadioOpKind::SCAN, RadioPriority::INTERACTIVE, 400);
+  RadioRequestId interactiveSoon = h.submit(RadioOwner::WIFI, RadioOpKind::CONNECT, RadioPriority::INTERACTIVE, 200);
+  RadioRequestId critical = h.submit(RadioOwner::WIFI, RadioOpKind::CONNECT, RadioPriority::CRITICAL, 400);
+
+  h.step(1);
+  REQUIRE(h.started.size() == 1);
+  CHECK_EQ(h.started[0], critical);
+  CHECK_EQ(h.scheduler.getPendingCount(), size_t(3));
+
+  // Nothing else starts while the connect holds the radio.
+  h.step(10);
+  CHECK_EQ(h.started.size(), size_t(1));
+
+  h.scheduler.complete(critical);
+  h.step(1);
+  REQUIRE(h.started.size() == 2);
+  CHECK_EQ(h.started[1], interactiveSoon); // Same priority: the earlier deadline wins.
+
+  h.scheduler.complete(interactiveSoon);
+  h.step(1);
+  h.scheduler.complete(h.started.back());
+  h.step(1);
+  REQUIRE(h.started.size() == 4);
+  CHECK_EQ(h.started[2], interactiveLate);
+  CHECK_EQ(h.started[3], normal);
+  CHECK(h.expired.empty());
+}
+
+HOST_TEST(radiosAreScheduledIndependentlyAndDataRunsAlongside) {
+  Harness h;
+  RadioRequestId wifiScan = h.submit(RadioOwner::WIFI, RadioOpKind::SCAN, RadioPriority::NORMAL);
+  RadioRequestId bleScan = h.submit(RadioOwner::BLE, RadioOpKind::SCAN, RadioPriority::NORMAL);
+  RadioRequestId wifiData = h.submit(RadioOwner::WIFI, RadioOpKind::DATA, RadioPriority::BACKGROUND);
+
+  h.step(1);
+  CHECK_EQ(h.started.size(), size_t(3));
+  CHECK(h.scheduler.isBusy(RadioOwner::WIFI));
+  CHECK(h.scheduler.isBusy(RadioOwner::BLE));
+
+  h.scheduler.complete(wifiScan);
+  h.scheduler.complete(bleScan);
+  h.scheduler.complete(wifiData);
+  h.step(1);
+  CHECK(!h.scheduler.isBusy(RadioOwner::WIFI));
+  CHECK(!h.scheduler.isBusy(RadioOwner::BLE));
+}
+
+HOST_TEST(pendingRequestsExpireAtTheirDeadline) {
+  Harness h;
+  RadioRequestId blocker = h.submit(RadioOwner::WIFI, RadioOpKind::CONNECT, RadioPriority::CRITICAL);
+  h.step(1);
+  REQUIRE(h.started.size() == 1);
+
+  RadioRequestId shortDeadline = h.submit(RadioOwner::WIFI, RadioOpKind::SCAN, RadioPriority::NORMAL, 100);
+  RadioRequestId defaultDeadline = h.submit(RadioOwner::WIFI, RadioOpKind::SCAN, RadioPriority::NORMAL);
+
+  h.step(100); // Exactly at the deadline: still pending.
+  CHECK(h.expired.empty());
+  h.step(1);
+  REQUIRE(h.expired.size() == 1);
+  CHECK_EQ(h.expired[0], shortDeadline);
+  CHECK_EQ(h.scheduler.getExpiredCount(), uint32_t(1));
+
+  h.step(399); // Exactly at the default deadline (500 ms).
+  CHECK_EQ(h.expired.size(), size_t(1));
+  h.step(1);
+  REQUIRE(h.expired.size() == 2);
+  CHECK_EQ(h.expired[1], defaultDeadline);
+  CHECK_EQ(h.scheduler.getPendingCount(), size_t(0));
+
+  // An expired request never starts, even after the radio frees up.
+  h.scheduler.complete(blocker);
+  h.step(1);
+  CHECK_EQ(h.started.size(), size_t(1));
+}
+
+HOST_TEST(timedSlotsReleaseTheRadio) {
+  Harness h;
+  h.submit(RadioOwner::BLE, RadioOpKind::SCAN, RadioPriority::NORMAL, 0, 50);
+  RadioRequestId next = h.submit(RadioOwner::BLE, RadioOpKind::SCAN, RadioPriority::NORMAL);
+  h.step(1);
+  CHECK_EQ(h.started.size(), size_t(1));
+  h.step(49);
+  CHECK_EQ(h.started.size(), size_t(1));
+  h.step(1);
+  REQUIRE(h.started.size() == 2);
+  CHECK_EQ(h.started[1], next);
+
+  std::vector<RadioTimelineEntry> timeline = h.scheduler.getTimeline();
+  REQUIRE(timeline.size() == 2);
+  CHECK_EQ(timeline[0].endMs - timeline[0].startMs, uint32_t(50));
+}
+
+HOST_TEST(coexistenceFollowsTheBusyRadios) {
+  Harness h;
+  RadioRequestId wifi = h.submit(RadioOwner::WIFI, RadioOpKind::DATA, RadioPriority::NORMAL);
+  h.step(1);
+  CHECK_EQ(coexValue(h.scheduler.getCoexMode()), coexValue(RadioCoexMode::PREFER_WIFI));
+
+  // Equal priorities split each 100 ms period in half.
+  RadioRequestId ble = h.submit(RadioOwner::BLE, RadioOpKind::DATA, RadioPriority::NORMAL);
+  h.step(1);
+  CHECK_EQ(coexValue(h.scheduler.getCoexMode()), coexValue(RadioCoexMode::PREFER_WIFI));
+  h.step(49);
+  CHECK_EQ(coexValue(h.scheduler.getCoexMode()), coexValue(RadioCoexMode::PREFER_WIFI));
+  h.step(1);
+  CHECK_EQ(coexValue(h.scheduler.getCoexMode()), coexValue(RadioCoexMode::PREFER_BLE));
+  h.step(50);
+  CHECK_EQ(coexValue(h.scheduler.getCoexMode()), coexValue(RadioCoexMode::PREFER_WIFI));
+
+  h.scheduler.complete(wifi);
+  h.step(1);
+  CHECK_EQ(coexValue(h.scheduler.getCoexMode()), coexValue(RadioCoexMode::PREFER_BLE));
+  h.scheduler.complete(ble);
+  h.step(1);
+  CHECK_EQ(coexValue(h.scheduler.getCoexMode()), coexValue(RadioCoexMode::BALANCE));
+
+  // Every switch reached the handler exactly once.
+  const std::vector<RadioCoexMode> expected = {
+    RadioCoexMode::PREFER_WIFI, RadioCoexMode::PREFER_BLE, RadioCoexMode::PREFER_WIFI,
+    RadioCoexMode::PREFER_BLE, RadioCoexMode::BALANCE,
+  };
+  REQUIRE(h.coexChanges.size() == expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    CHECK_EQ(coexValue(h.coexChanges[i]), coexValue(expected[i]));
+  }
+}
+
+HOST_TEST(coexistenceSliceIsWeightedByPriorityWithAMinimum) {
+  Harness h;
+  h.submit(RadioOwner::WIFI, RadioOpKind::DATA, RadioPriority::CRITICAL);
+  h.submit(RadioOwner::BLE, RadioOpKind::DATA, RadioPriority::BACKGROUND);
+  h.step(1);
+
+  // Weights 4:1 would give Wi-Fi 80 ms, but BLE keeps the 30 ms minimum slice.
+  uint32_t wifiMs = 0;
+  uint32_t bleMs = 0;
+  for (int i = 0; i < 100; ++i) {
+    if (h.scheduler.getCoexMode() == RadioCoexMode::PREFER_WIFI) wifiMs++;
+    else if (h.scheduler.getCoexMode() == RadioCoexMode::PREFER_BLE) bleMs++;
+    h.step(1);
+  }
+  CHECK_EQ(wifiMs, uint32_t(70));
+  CHECK_EQ(bleMs, uint32_t(30));
+}
+
+HOST_TEST(probedManagerActivityBlocksExclusiveRequests) {
+  Harness h;
+  bool managerScanning = true;
+  h.scheduler.addActivityProbe(RadioOwner::WIFI, RadioOpKind::SCAN, RadioPriority::NORMAL,
+                               [&managerScanning]() { return managerScanning; });
+  RadioRequestId connect = h.submit(RadioOwner::WIFI, RadioOpKind::CONNECT, RadioPriority::INTERACTIVE);
+  h.step(1);
+  CHECK(h.started.empty());
+  CHECK(h.scheduler.isBusy(RadioOwner::WIFI));
+
+  managerScanning = false;
+  h.step(20);
+  REQUIRE(h.started.size() == 1);
+  CHECK_EQ(h.started[0], connect);
+
+  std::vector<RadioTimelineEntry> timeline = h.scheduler.getTimeline();
+  REQUIRE(!timeline.empty());
+  CHECK(timeline[0].external);
+}
@@ -0,0 +1,403 @@
+/**
+ * @file RemoteUiTest.cpp
+ * @brief Checks the remote UI protocol: token comparison, touch clamping, the acknowledgement-based
+ * frame budget, and a loopback session with the desktop client in `tools/remote_ui_client.py`.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "HostTest.h"
+#include "MirrorCodec.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <netinet/in.h>
+#include <poll.h>
+#include <spawn.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+extern char** environ;
+
+namespace {
+
+int64_t steadyUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// --- WebSocket server side, just enough for one client on the loopback interface ---
+
+std::string sha1Base64(const std::string& text) {
+  uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+  std::string msg = text;
+  const uint64_t bits = (uint64_t)text.size() * 8;
+  msg += (char)0x80;
+  while (msg.size() % 64 != 56) msg += (char)0;
+  for (int i = 7; i >= 0; --i) msg += (char)(bits >> (i * 8));
+  auto rol = [](uint32_t v, int n) { return (v << n) | (v >> (32 - n)); };
+  for (size_t chunk = 0; chunk < msg.size(); chunk += 64) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; ++i) {
+      const uint8_t* p = reinterpret_cast<const uint8_t*>(&msg[chunk + i * 4]);
+      w[i] = (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+    }
+    for (int i = 16; i < 80; ++i) w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; ++i) {
+      uint32_t f, k;
+      if (i < 20) { f = (b & c) | (~b & d); k = 0x5A827999; }
+      else if (i < 40) { f = b ^ c ^ d; k = 0x6ED9EBA1; }
+      else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+      else { f = b ^ c ^ d; k = 0xCA62C1D6; }
+      const uint32_t t = rol(a, 5) + f + e + k + w[i];
+      e = d; d = c; c = rol(b, 30); b = a; a = t;
+    }
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+  }
+  uint8_t digest[20];
+  for (int i = 0; i < 20; ++i) digest[i] = (uint8_t)(h[i / 4] >> (24 - (i % 4) * 8));
+
+  static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (int i = 0; i < 20; i += 3) {
+    const uint32_t v = (uint32_t)digest[i] << 16 | (i + 1 < 20 ? digest[i + 1] << 8 : 0) | (i + 2 < 20 ? digest[i + 2] : 0);
+    out += alphabet[(v >> 18) & 63];
+    out += alphabet[(v >> 12) & 63];
+    out += i + 1 < 20 ? alphabet[(v >> 6) & 63] : '=';
+    out += i + 2 < 20 ? alphabet[v & 63] : '=';
+  }
+  return out;
+}
+
+bool readExact(int fd, void* out, size_t len) {
+  return recv(fd, out, len, MSG_WAITALL) == (ssize_t)len;
+}
+
+bool writeAll(int fd, const void* data, size_t len) {
+  return send(fd, data, len, MSG_NOSIGNAL) == (ssize_t)len;
+}
+
+/**
+ * @brief Reads the upgrade request, checks the token like RemoteUiMirror and answers it.
+ */
+bool acceptUpgrade(int fd, const char* expectedToken) {
+  std::string request;
+  char c;
+  while (request.find("\r\n\r\n") == std::string::npos && recv(fd, &c, 1, 0) == 1) request += c;
+  const size_t tokenPos = request.find("/mirror?token=");
+  const size_t keyPos = request.find("Sec-WebSocket-Key: ");
+  if (tokenPos == std::string::npos || keyPos == std::string::npos) return false;
+  const std::string token = request.substr(tokenPos + 14, request.find_first_of(" &", tokenPos + 14) - tokenPos - 14);
+  if (!MirrorCodec::tokenEquals(token.c_str(), expectedToken)) return false;
+  const std::string key = request.substr(keyPos + 19, request.find("\r\n", keyPos) - keyPos - 19);
+  const std::string response = "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                               "Sec-WebSocket-Accept: " + sha1Base64(key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11") + "\r\n\r\n";
+  return writeAll(fd, response.data(), response.size());
+}
+
+bool sendMessage(int fd, uint8_t opcode, const uint8_t* payload, size_t len) {
+  std::vector<uint8_t> out = { (uint8_t)(0x80 | opcode) };
+  if (len < 126) {
+    out.push_back((uint8_t)len);
+  } else {
+    out.push_back(126);
+    out.push_back((uint8_t)(len >> 8));
+    out.push_back((uint8_t)len);
+  }
+  out.insert(out.end(), payload, payload + len);
+  return writeAll(fd, out.data(), out.size());
+}
+
+/**
+ * @brief Reads one (masked) client message.
+ * @return The opcode, or -1 on error.
+ */
+int readMessage(int fd, std::vector<uint8_t>* payload) {
+  uint8_t head[2];
+  if (!readExact(fd, head, 2)) return -1;
+  uint64_t len = head[1] & 0x7F;
+  if (len == 126) {
+    uint8_t ext[2];
+    if (!readExact(fd, ext, 2)) return -1;
+    len = (uint64_t)ext[0] << 8 | ext[1];
+  } else if (len == 127) {
+    return -1; // Clients of this protocol never send that much.
+  }
+  uint8_t mask[4] = {};
+  if ((head[1] & 0x80) && !readExact(fd, mask, 4)) return -1;
+  payload->resize(len);
+  if (len && !readExact(fd, payload->data(), len)) return -1;
+  for (size_t i = 0; i < len; ++i) (*payload)[i] ^= mask[i & 3];
+  return head[0] & 0x0F;
+}
+
+// --- A small stand-in for the panel shadow with dirty tiles, encoded like RemoteUiMirror ---
+
+struct Screen {
+  static constexpr uint16_t TILE = 16;
+  uint16_t width, height, tilesX, tilesY;
+  std::vector<uint16_t> shadow, sent;
+  std::vector<bool> dirty;
+  uint32_t cursor = 0;
+
+  Screen(uint16_t w, uint16_t h)
+    : width(w), height(h), tilesX((w + TILE - 1) / TILE), tilesY((h + TILE - 1) / TILE),
+      shadow((size_t)w * h), sent((size_t)w * h), dirty((size_t)tilesX * tilesY, false) {}
+
+  void fill(uint16_t x0, uint16_t y0, uint16_t w, uint16_t h, uint16_t (*color)(uint16_t, uint16_t)) {
+    for (uint16_t y = y0; y < y0 + h; ++y) {
+      for (uint16_t x = x0; x < x0 + w; ++x) {
+        shadow[(size_t)y * width + x] = color(x, y);
+        dirty[(y / TILE) * tilesX + x / TILE] = true;
+      }
+    }
+  }
+
+  bool hasDirty() const {
+    for (bool d : dirty) if (d) return true;
+    return false;
+  }
+
+  size_t encode(std::vector<uint8_t>& frame, size_t budget, bool keyframe, uint32_t seq) {
+    const uint32_t tiles = dirty.size();
+    size_t len = MirrorCodec::FRAME_HEADER_BYTES;
+    uint16_t rects = 0;
+    uint32_t i = 0;
+    for (; i < tiles && hasDirty(); ++i) {
+      const uint32_t index = (cursor + i) % tiles;
+      if (!dirty[index]) continue;
+      if (len + MirrorCodec::WORST_TILE_BYTES > budget) break;
+      const uint16_t x = (index % tilesX) * TILE;
+      const uint16_t y = (index / tilesX) * TILE;
+      len += MirrorCodec::encodeTile(frame.data() + len, shadow.data(), sent.data(), width, x, y,
+                                     (uint8_t)std::min<uint16_t>(TILE, width - x),
+                                     (uint8_t)std::min<uint16_t>(TILE, height - y));
+      dirty[index] = false;
+      rects++;
+    }
+    cursor = (cursor + i) % tiles;
+    if (!rects) return 0;
+    MirrorCodec::writeFrameHeader(frame.data(), keyframe, width, height, seq, rects);
+    return len;
+  }
+};
+
+uint16_t gradient(uint16_t x, uint16_t y) { return (uint16_t)((x * 7 + y * 13) ^ (x * y)); }
+uint16_t solid(uint16_t, uint16_t) { return 0xF800; }
+uint16_t stripes(uint16_t x, uint16_t) { return (x / 3) % 2 ? 0x07E0 : 0x001F; }
+
+} // namespace
+
+HOST_TEST(tokenComparisonCoversTheWholeToken) {
+  CHECK(MirrorCodec::tokenEquals("secret", "secret"));
+  CHECK(!MirrorCodec::tokenEquals("secre", "secret"));
+  CHECK(!MirrorCodec::tokenEquals("secret1", "secret"));
+  CHECK(!MirrorCodec::tokenEquals("Secret", "secret"));
+  CHECK(!MirrorCodec::tokenEquals("", "secret"));
+  CHECK(!MirrorCodec::tokenEquals(nullptr, "secret"));
+}
+
+HOST_TEST(touchIsClampedToTheFramebuffer) {
+  const uint8_t outside[] = { 'T', 1, 0x0F, 0x27, 0xCE, 0xFF }; // x = 9999, y = -50
+  int16_t x, y;
+  bool pressed;
+  REQUIRE(MirrorCodec::parseTouch(outside, sizeof(outside), 480, 320, &x, &y, &pressed));
+  CHECK_EQ(x, int16_t(479));
+  CHECK_EQ(y, int16_t(0));
+  CHECK(pressed);
+
+  const uint8_t inside[] = { 'T', 0, 10, 0, 20, 0 };
+  REQUIRE(MirrorCodec::parseTouch(inside, sizeof(inside), 480, 320, &x, &y, &pressed));
+  CHECK_EQ(x, int16_t(10));
+  CHECK_EQ(y, int16_t(20));
+  CHECK(!pressed);
+
+  CHECK(!MirrorCodec::parseTouch(inside, 5, 480, 320, &x, &y, &pressed));
+  CHECK(!MirrorCodec::parseTouch(inside, sizeof(inside), 0, 0, &x, &y, &pressed));
+}
+
+HOST_TEST(acknowledgementsDriveTheBudget) {
+  MirrorLinkEstimator link;
+  link.reset(10000);
+  link.onFrameSent(0, 1000, 0);
+  link.onFrameSent(1, 1000, 10000);
+  CHECK_EQ(link.getBytesInFlight(), uint32_t(2000));
+  CHECK_EQ(link.getThroughputBps(), uint32_t(10000)); // Handing frames to the socket proves nothing.
+
+  uint32_t latencyUs = 0;
+  CHECK(link.onAck(1, 20000, &latencyUs)); // Both frames: 2000 bytes in 20 ms = 100000 B/s.
+  CHECK_EQ(latencyUs, uint32_t(10000));
+  CHECK_EQ(link.getThroughputBps(), uint32_t((10000 * 3 + 100000) / 4));
+  CHECK_EQ(link.getBytesInFlight(), uint32_t(0));
+  CHECK_EQ(link.getBytesAcked(), uint32_t(2000));
+  CHECK(!link.onAck(1, 30000)); // Duplicate.
+
+  CHECK_EQ(link.budget(100, 100, 100000), size_t(3250));
+  CHECK_EQ(link.budget(100, 5000, 100000), size_t(5000));
+  CHECK_EQ(link.budget(100, 100, 1000), size_t(1000));
+}
+
+HOST_TEST(unacknowledgedFramesBlockAndExpire) {
+  MirrorLinkEstimator link;
+  link.reset(8000);
+  for (uint32_t seq = 0; seq < MirrorLinkEstimator::MAX_IN_FLIGHT; ++seq) {
+    REQUIRE(link.canSend());
+    link.onFrameSent(seq, 500, seq * 1000);
+  }
+  CHECK(!link.canSend());
+  CHECK(!link.expire(1999999, 2000000));
+  CHECK(link.expire(2000000, 2000000));
+  CHECK(link.canSend());
+  CHECK_EQ(link.getBytesInFlight(), uint32_t(0));
+  CHECK_EQ(link.getThroughputBps(), uint32_t(4000));
+}
+
+HOST_TEST(acknowledgementsHandleSequenceWrap) {
+  MirrorLinkEstimator link;
+  link.reset(1000);
+  link.onFrameSent(0xFFFFFFFFu, 100, 0);
+  link.onFrameSent(0, 100, 0);
+  CHECK(!link.onAck(0xFFFFFFFEu, 1000));
+  CHECK(link.onAck(0, 1000));
+  CHECK_EQ(link.getBytesInFlight(), uint32_t(0));
+}
+
+HOST_TEST(desktopClientMirrorsTheScreenOverLoopback) {
+#if defined(WOBYS_PYTHON3) && defined(WOBYS_REMOTE_UI_CLIENT)
+  const char* token = "loopback-secret";
+  const int listener = socket(AF_INET, SOCK_STREAM, 0);
+  REQUIRE(listener >= 0);
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  REQUIRE(bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+  REQUIRE(listen(listener, 1) == 0);
+  socklen_t addrLen = sizeof(addr);
+  REQUIRE(getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &addrLen) == 0);
+  const std::string port = std::to_string(ntohs(addr.sin_port));
+
+  char rawPath[] = "/tmp/remote_ui_loopback_XXXXXX";
+  const int rawFd = mkstemp(rawPath);
+  REQUIRE(rawFd >= 0);
+  close(rawFd);
+
+  std::vector<std::string> args = { WOBYS_PYTHON3, WOBYS_REMOTE_UI_CLIENT, "127.0.0.1", "--port", port,
+                                    "--token", token, "--headless", "--touch", "9999,-50", "--raw-out", rawPath };
+  std::vector<char*> argv;
+  for (std::string& arg : args) argv.push_back(arg.data());
+  argv.push_back(nullptr);
+  pid_t pid;
+  REQUIRE(posix_spawn(&pid, argv[0], nullptr, nullptr, argv.data(), environ) == 0);
+
+  pollfd pending = { listener, POLLIN, 0 };
+  REQUIRE(poll(&pending, 1, 10000) == 1);
+  const int fd = accept(listener, nullptr, nullptr);
+  close(listener);
+  REQUIRE(fd >= 0);
+  REQUIRE(acceptUpgrade(fd, token));
+
+  // 100x52 leaves partial tiles at the right and bottom edges.
+  Screen screen(100, 52);
+  screen.fill(0, 0, 100, 26, solid);
+  screen.fill(0, 26, 100, 26, gradient);
+
+  const uint32_t intervalMs = 20;
+  const size_t minBytes = 1024;
+  std::vector<uint8_t> frame(8192);
+  MirrorLinkEstimator link;
+  link.reset(minBytes * 2 * 1000 / intervalMs);
+  uint32_t seq = 0;
+  uint32_t bytesSent = 0;
+  std::vector<std::pair<int16_t, bool>> touches;
+  int16_t touchY = -1;
+
+  // Stream until everything is acknowledged; `phase` 1 repaints a region after the keyframe.
+  bool keyframe = true;
+  int phase = 0;
+  const int64_t deadlineUs = steadyUs() + 15000000;
+  while (steadyUs() < deadlineUs) {
+    if (!screen.hasDirty() && link.getBytesInFlight() == 0) {
+      if (phase == 0) {
+        screen.fill(30, 20, 40, 20, stripes);
+        phase = 1;
+      } else if (touches.size() >= 2) {
+        break;
+      }
+    }
+    const size_t budget = link.budget(intervalMs, minBytes, frame.size());
+    if (screen.hasDirty() && link.canSend() && link.getBytesInFlight() < budget) {
+      const size_t len = screen.encode(frame, budget, keyframe, seq);
+      REQUIRE(len > 0 && len <= budget);
+      REQUIRE(sendMessage(fd, 0x2, frame.data(), len));
+      link.onFrameSent(seq++, (uint32_t)len, steadyUs());
+      bytesSent += len;
+      keyframe = false;
+    }
+
+    pollfd readable = { fd, POLLIN, 0 };
+    if (poll(&readable, 1, 5) != 1) continue;
+    std::vector<uint8_t> message;
+    REQUIRE(readMessage(fd, &message) == 0x2);
+    uint32_t ackSeq;
+    int16_t x, y;
+    bool pressed;
+    if (MirrorCodec::parseAck(message.data(), message.size(), &ackSeq)) {
+      CHECK(link.onAck(ackSeq, steadyUs()));
+    } else if (MirrorCodec::parseTouch(message.data(), message.size(), screen.width, screen.height, &x, &y, &pressed)) {
+      touches.push_back({ x, pressed });
+      touchY = y;
+    }
+  }
+  const uint8_t closeCode[] = { 0x03, 0xE8 };
+  sendMessage(fd, 0x8, closeCode, sizeof(closeCode));
+
+  int status = -1;
+  waitpid(pid, &status, 0);
+  close(fd);
+  CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+  // The budget split the keyframe over several frames, and every byte came back acknowledged.
+  CHECK(seq > 2);
+  CHECK_EQ(link.getBytesAcked(), bytesSent);
+  CHECK(link.getThroughputBps() > 0);
+
+  REQUIRE(touches.size() == 2);
+  CHECK_EQ(touches[0].first, int16_t(99));
+  CHECK_EQ(touchY, int16_t(0));
+  CHECK(touches[0].second && !touches[1].second);
+
+  FILE* raw = fopen(rawPath, "rb");
+  REQUIRE(raw);
+  uint16_t size[2] = {};
+  std::vector<uint16_t> pixels(screen.shadow.size());
+  const bool complete = fread(size, sizeof(uint16_t), 2, raw) == 2 &&
+                        fread(pixels.data(), sizeof(uint16_t), pixels.size(), raw) == pixels.size();
+  fclose(raw);
+  unlink(rawPath);
+  REQUIRE(complete);
+  CHECK_EQ(size[0], screen.width);
+  CHECK_EQ(size[1], screen.height);
+  CHECK(pixels == screen.shadow);
+#else
+  std::printf("  (skipped: no Python 3 interpreter found at configure time)\n");
+#endif
+}
@@ -0,0 +1,393 @@
+/**
+ * @file TelemetryPublisherTest.cpp
+ * @brief Checks the TelemetryPublisher against an MQTT broker on the loopback interface: batch format, store-and-forward during a broker outage, the queue across a restart, and unacknowledged batches.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "HostTest.h"
+#include "TelemetryPublisher.h"
+#include "SystemInitializer.h"
+#include "PowerManager.h"
+#include "WifiManager.h"
+#include <LittleFS.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include <mutex>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief A PUBLISH as received by the broker.
+ */
+struct Message {
+  std::string topic;            ///< Topic.
+  std::vector<uint8_t> payload; ///< Payload.
+};
+
+/**
+ * @brief MQTT 3.1.1 broker for one client at a time: accepts CONNECT, records PUBLISH and
+ * acknowledges QoS 1. Can go offline (drop the client and refuse new ones) and stop acknowledging.
+ */
+class MqttBroker {
+public:
+  MqttBroker() {
+    _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    const int one = 1;
+    setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    socklen_t length = sizeof(address);
+    getsockname(_listenFd, reinterpret_cast<sockaddr*>(&address), &length);
+    _uri = "mqtt://127.0.0.1:" + std::to_string(ntohs(address.sin_port));
+    listen(_listenFd, 4);
+    _thread = std::thread([this]() { _serve(); });
+  }
+
+  ~MqttBroker() {
+    setOnline(false);
+    shutdown(_listenFd, SHUT_RDWR);
+    _thread.join();
+    close(_listenFd);
+  }
+
+  const char* uri() const { return _uri.c_str(); }
+
+  void setOnline(bool online) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _online = online;
+    if (!online && _clientFd >= 0) shutdown(_clientFd, SHUT_RDWR);
+  }
+
+  void setAcking(bool acking) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _acking = acking;
+  }
+
+  std::vector<Message> messages() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _messages;
+  }
+
+  std::string clientId() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _clientId;
+  }
+
+private:
+  int _listenFd;
+  std::string _uri;
+  std::thread _thread;
+  std::mutex _mutex;
+  bool _online = true;
+  bool _acking = true;
+  int _clientFd = -1;
+  std::string _clientId;
+  std::vector<Message> _messages;
+
+  static bool _readExact(int fd, uint8_t* data, size_t length) {
+    while (length) {
+      const ssize_t n = recv(fd, data, length, 0);
+      if (n <= 0) return false;
+      data += n;
+      length -= (size_t)n;
+    }
+    return true;
+  }
+
+  static bool _readPacket(int fd, uint8_t* type, std::vector<uint8_t>& body) {
+    if (!_readExact(fd, type, 1)) return false;
+    size_t length = 0;
+    for (int shift = 0; ; shift += 7) {
+      uint8_t b;
+      if (shift > 21 || !_readExact(fd, &b, 1)) return false;
+      length |= (size_t)(b & 0x7F) << shift;
+      if (!(b & 0x80)) break;
+    }
+    body.resize(length);
+    return _readExact(fd, body.data(), length);
+  }
+
+  void _serve() {
+    for (;;) {
+      const int fd = accept(_listenFd, nullptr, nullptr);
+      if (fd < 0) return;
+      const int one = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_online) _clientFd = fd;
+      }
+      if (_clientFd == fd) _session(fd);
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _clientFd = -1;
+      }
+      close(fd);
+    }
+  }
+
+  void _session(int fd) {
+    uint8_t type;
+    std::vector<uint8_t> body;
+    if (!_readPacket(fd, &type, body) || type != 0x10 || body.size() < 12) return;
+    {
+      // Variable header: protocol name (6), level, flags, keep alive (2); then the client id.
+      const size_t idLength = (body[10] << 8) | body[11];
+      std::lock_guard<std::mutex> lock(_mutex);
+      _clientId.assign(body.begin() + 12, body.begin() + 12 + std::min(idLength, body.size() - 12));
+    }
+    const uint8_t connack[] = { 0x20, 0x02, 0x00, 0x00 };
+    send(fd, connack, sizeof(connack), MSG_NOSIGNAL);
+    while (_readPacket(fd, &type, body)) {
+      if ((type & 0xF0) == 0x30) { // PUBLISH
+        const size_t topicLength = (body[0] << 8) | body[1];
+        const bool qos1 = (type & 0x06) == 0x02;
+        const size_t payloadStart = 2 + topicLength + (qos1 ? 2 : 0);
+        Message message;
+        message.topic.assign(body.begin() + 2, body.begin() + 2 + topicLength);
+        message.payload.assign(body.begin() + payloadStart, body.end());
+        bool ack;
+        {
+          std::lock_guard<std::mutex> lock(_mutex);
+          _messages.push_back(message);
+          ack = _acking;
+        }
+        if (qos1 && ack) {
+          const uint8_t puback[] = { 0x40, 0x02, body[2 + topicLength], body[3 + topicLength] };
+          send(fd, puback, sizeof(puback), MSG_NOSIGNAL);
+        }
+      } else if (type == 0xC0) { // PINGREQ
+        const uint8_t pingresp[] = { 0xD0, 0x00 };
+        send(fd, pingresp, sizeof(pingresp), MSG_NOSIGNAL);
+      } else if (type == 0xE0) { // DISCONNECT
+        return;
+      }
+    }
+  }
+};
+
+/**
+ * @brief A decoded batch.
+ */
+struct Batch {
+  uint32_t bootId = 0;
+  uint32_t baseUptimeMs = 0;
+  std::vector<uint8_t> kinds;
+  std::vector<int32_t> values;
+  std::vector<uint32_t> uptimesMs;
+};
+
+bool readVarint(const std::vector<uint8_t>& data, size_t& pos, uint32_t& value) {
+  value = 0;
+  for (int shift = 0; pos < data.size() && shift < 35; shift += 7) {
+    const uint8_t b = data[pos++];
+    value |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) return true;
+  }
+  return false;
+}
+
+/// Decodes the batch format documented in TelemetryPublisher.h.
+bool decode(const std::vector<uint8_t>& data, Batch& batch) {
+  if (data.size() < 17 || data[0] != 'T' || data[1] != 'B' || data[2] != 1) return false;
+  auto u32 = [&](size_t p) { return (uint32_t)data[p] | (uint32_t)data[p + 1] << 8 | (uint32_t)data[p + 2] << 16 | (uint32_t)data[p + 3] << 24; };
+  const uint16_t count = (uint16_t)(data[3] | data[4] << 8);
+  batch.bootId = u32(5);
+  batch.baseUptimeMs = u32(13);
+  int32_t previous[8] = {0};
+  uint32_t uptimeMs = batch.baseUptimeMs;
+  size_t pos = 17;
+  for (uint16_t i = 0; i < count; ++i) {
+    if (pos >= data.size()) return false;
+    const uint8_t kind = data[pos++];
+    uint32_t delta, zz;
+    if (kind == 0 || kind > 7 || !readVarint(data, pos, delta) || !readVarint(data, pos, zz)) return false;
+    uptimeMs += delta;
+    const int32_t value = (int32_t)((uint32_t)previous[kind] + ((zz >> 1) ^ (0u - (zz & 1))));
+    previous[kind] = value;
+    batch.kinds.push_back(kind);
+    batch.values.push_back(value);
+    batch.uptimesMs.push_back(uptimeMs);
+  }
+  return pos == data.size();
+}
+
+TelemetryPublisherConfig makeConfig(const char* brokerUri) {
+  return TelemetryPublisherConfig{
+    .brokerUri = brokerUri, .username = "", .password = "", .topicPrefix = "wobys",
+    .sampleIntervalMs = 1000, .batchMaxSamples = 12, .batchIntervalMs = 4000, .ringCapacity = 64,
+    .queueDir = "/tlm", .maxQueuedBatches = 16, .drainIntervalMs = 250, .ackTimeoutMs = 3000,
+    .serviceIntervalMs = 1, .taskStackSize = 6144, .taskPriority = 1, .taskCore = 0
+  };
+}
+
+/// Runs the main loop (250 ms of simulated time per step) until `done` holds or 5 s of real time passed.
+template <typename Predicate>
+bool runUntil(TelemetryPublisher& publisher, Predicate done) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (std::chrono::steady_clock::now() < deadline) {
+    if (done()) return true;
+    hostclock::advanceMs(250);
+    publisher.loop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+  return done();
+}
+
+size_t queueFiles() {
+  size_t count = 0;
+  for (const auto& file : hostfs::files()) count += file.first.rfind("/tlm/", 0) == 0;
+  return count;
+}
+
+void resetDevice() {
+  hostfs::clear();
+  hosttask::setThreaded(true);
+}
+
+} // namespace
+
+HOST_TEST(batchesReachTheBrokerAndDecode) {
+  resetDevice();
+  MqttBroker broker;
+  const TelemetryPublisherConfig config = makeConfig(broker.uri());
+  WifiManager wifi;
+  PowerManager power;
+  wifi.setState(WifiMgr_State_t::CONNECTED);
+  TelemetryPublisher publisher(&wifi, &power);
+  REQUIRE(publisher.init(config));
+  publisher.recordRfidScan("04:A2:19:5C");
+
+  REQUIRE(runUntil(publisher, [&]() { return publisher.getBatchesPublished() >= 2; }));
+  const std::vector<Message> messages = broker.messages();
+  REQUIRE(messages.size() >= 2);
+  CHECK(broker.clientId() == "wobys-a1b2c3d4e5f6");
+  CHECK(messages[0].topic == "wobys/a1b2c3d4e5f6/telemetry");
+
+  Batch batch;
+  REQUIRE(decode(messages[0].payload, batch));
+  CHECK_EQ(batch.kinds.size(), (size_t)12);
+  CHECK_EQ((int)batch.kinds[0], (int)TelemetryKind::RFID_SCAN);
+  bool sawBattery = false, sawRssi = false, sawHeap = false;
+  for (size_t i = 0; i < batch.kinds.size(); ++i) {
+    if (i) CHECK(batch.uptimesMs[i] >= batch.uptimesMs[i - 1]);
+    switch ((TelemetryKind)batch.kinds[i]) {
+      case TelemetryKind::BATTERY_MV: sawBattery = true; CHECK_EQ(batch.values[i], 3900); break;
+      case TelemetryKind::WIFI_RSSI_DBM: sawRssi = true; CHECK_EQ(batch.values[i], -60); break;
+      case TelemetryKind::FREE_HEAP_KB: sawHeap = true; CHECK_EQ(batch.values[i], 200); break;
+      default: break;
+    }
+  }
+  CHECK(sawBattery && sawRssi && sawHeap);
+  CHECK_EQ(publisher.getQueuedBatches(), 0u);
+}
+
+HOST_TEST(brokerOutageQueuesOnFlashAndDrainsInOrder) {
+  resetDevice();
+  MqttBroker broker;
+  const TelemetryPublisherConfig config = makeConfig(broker.uri());
+  WifiManager wifi;
+  PowerManager power;
+  wifi.setState(WifiMgr_State_t::CONNECTED);
+  TelemetryPublisher publisher(&wifi, &power);
+  REQUIRE(publisher.init(config));
+  REQUIRE(runUntil(publisher, [&]() { return publisher.getBatchesPublished() >= 1; }));
+
+  broker.setOnline(false);
+  REQUIRE(runUntil(publisher, [&]() { return publisher.getQueuedBatches() >= 3; }));
+  CHECK(queueFiles() >= 3);
+
+  broker.setOnline(true);
+  const uint32_t published = publisher.getBatchesPublished();
+  REQUIRE(runUntil(publisher, [&]() { return publisher.getQueuedBatches() == 0 && publisher.getBatchesPublished() >= published + 3; }));
+  CHECK_EQ(queueFiles(), (size_t)0);
+
+  // Queued batches never overtake each other or newer ones (a batch may repeat after a lost acknowledgement).
+  uint32_t previousBase = 0;
+  for (const Message& message : broker.messages()) {
+    Batch batch;
+    REQUIRE(decode(message.payload, batch));
+    CHECK(batch.baseUptimeMs >= previousBase);
+    previousBase = batch.baseUptimeMs;
+  }
+  CHECK_EQ(publisher.getBatchesDropped(), 0u);
+}
+
+HOST_TEST(queuedBatchesSurviveARestart) {
+  resetDevice();
+  MqttBroker broker;
+  const TelemetryPublisherConfig config = makeConfig(broker.uri());
+  WifiManager wifi;
+  PowerManager power;
+  uint32_t queued = 0;
+  {
+    TelemetryPublisher publisher(&wifi, &power); // Wi-Fi down: everything goes to the queue.
+    REQUIRE(publisher.init(config));
+    REQUIRE(runUntil(publisher, [&]() { return publisher.getQueuedBatches() >= 2; }));
+    queued = publisher.getQueuedBatches();
+  }
+  CHECK(broker.messages().empty());
+  CHECK_EQ(queueFiles(), (size_t)queued);
+
+  TelemetryPublisher publisher(&wifi, &power);
+  REQUIRE(publisher.init(config));
+  CHECK_EQ(publisher.getQueuedBatches(), queued);
+  wifi.setState(WifiMgr_State_t::CONNECTED);
+  REQUIRE(runUntil(publisher, [&]() { return publisher.getBatchesPublished() > queued && publisher.getQueuedBatches() == 0; }));
+
+  const std::vector<Message> messages = broker.messages();
+  REQUIRE(messages.size() > queued);
+  Batch first, fromThisBoot;
+  REQUIRE(decode(messages[0].payload, first));
+  REQUIRE(decode(messages.back().payload, fromThisBoot));
+  CHECK(first.bootId != fromThisBoot.bootId); // The queued batches came from the previous run.
+}
+
+HOST_TEST(unacknowledgedBatchIsPublishedAgain) {
+  resetDevice();
+  MqttBroker broker;
+  broker.setAcking(false);
+  const TelemetryPublisherConfig config = makeConfig(broker.uri());
+  WifiManager wifi;
+  PowerManager power;
+  wifi.setState(WifiMgr_State_t::CONNECTED);
+  TelemetryPublisher publisher(&wifi, &power);
+  REQUIRE(publisher.init(config));
+  REQUIRE(runUntil(publisher, [&]() { return !broker.messages().empty(); }));
+  const std::vector<uint8_t> firstPayload = broker.messages()[0].payload;
+  hostclock::advanceMs(config.ackTimeoutMs);
+  REQUIRE(runUntil(publisher, [&]() { return publisher.getQueuedBatches() >= 1; }));
+  CHECK_EQ(publisher.getBatchesPublished(), 0u);
+
+  broker.setAcking(true);
+  REQUIRE(runUntil(publisher, [&]() { return publisher.getQueuedBatches() == 0 && publisher.getBatchesPublished() >= 2; }));
+  size_t copies = 0;
+  for (const Message& message : broker.messages()) copies += message.payload == firstPayload;
+  CHECK(copies >= 2); // At least once: the unacknowledged batch went to the queue and was sent again.
+}
@@ -0,0 +1,221 @@
+/**
+ * @file TimerWheelTest.cpp
+ * @brief Runs the TimerWheel on a simulated clock: expiry times across the wheel levels,
+ * periodic reloads, sleep hints, and a benchmark with thousands of timers checked against a
+ * binary-heap reference.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "HostTest.h"
+#include "TimerWheel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <queue>
+#include <random>
+
+namespace {
+
+uint32_t g_simMs = 0; ///< Simulated time of the wheels under test.
+
+uint32_t simClock() { return g_simMs; }
+
+/**
+ * @brief Wall-clock stopwatch for the benchmark figures.
+ */
+struct Stopwatch {
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  double elapsedNs() const {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  }
+};
+
+/**
+ * @brief One scheduled timer of the benchmark, with the time it has to fire next.
+ */
+struct BenchTimer {
+  TimerWheel::Timer timer;
+  uint32_t periodMs = 0;
+  uint32_t expectedMs = 0;
+  uint32_t fired = 0;
+};
+
+constexpr size_t kBenchTimers = 5000;
+constexpr uint32_t kBenchDurationMs = 300000;  // Beyond the level-2 range (2^18 ms) after the starts.
+constexpr uint32_t kBenchMaxDelayMs = 100000;
+
+} // namespace
+
+HOST_TEST(oneShotTimersFireAtTheirDeadlineOnEveryLevel) {
+  g_simMs = 5000;
+  TimerWheel wheel(simClock);
+
+  // Delays at the edges of the 64-slot levels, and one beyond the top level's range.
+  const uint32_t delays[] = { 1, 63, 64, 65, 4095, 4096, 262143, 262144, 17000000, 16777300 };
+  constexpr size_t n = sizeof(delays) / sizeof(delays[0]);
+  TimerWheel::Timer timers[n];
+  uint32_t firedAt[n] = {};
+  for (size_t i = 0; i < n; ++i) {
+    timers[i].setCallback([&firedAt, i]() { firedAt[i] = g_simMs; });
+    wheel.start(timers[i], delays[i]);
+  }
+  CHECK_EQ(wheel.activeCount(), n);
+
+  const uint32_t end = 5000 + 17000001;
+  while (g_simMs != end) {
+    // Sleep as the main loop does, never beyond the next deadline.
+    g_simMs += std::clamp<uint32_t>(wheel.msUntilNextDeadline(1000000), 1, end - g_simMs);
+    wheel.advance(g_simMs);
+  }
+  for (size_t i = 0; i < n; ++i) {
+    CHECK_EQ(firedAt[i], 5000 + delays[i]);
+  }
+  CHECK_EQ(wheel.activeCount(), size_t(0));
+}
+
+HOST_TEST(periodicTimerKeepsItsPhase) {
+  g_simMs = 100;
+  TimerWheel wheel(simClock);
+  std::vector<uint32_t> firedAt;
+  TimerWheel::Timer timer([&]() { firedAt.push_back(g_simMs); });
+  wheel.start(timer, 10, 25);
+
+  for (g_simMs = 101; g_simMs <= 160; ++g_simMs) wheel.advance(g_simMs);
+  REQUIRE(firedAt.size() == 3);
+  CHECK_EQ(firedAt[0], uint32_t(110));
+  CHECK_EQ(firedAt[1], uint32_t(135));
+  CHECK_EQ(firedAt[2], uint32_t(160));
+
+  // A stalled loop catches up on the missed expiries and stays on the original 25 ms grid.
+  firedAt.clear();
+  g_simMs = 290;
+  wheel.advance(g_simMs);
+  CHECK_EQ(firedAt.size(), size_t(5)); // 185, 210, 235, 260, 285 tick by during advance().
+  CHECK_EQ(wheel.msUntilNextDeadline(1000), uint32_t(20));
+
+  wheel.cancel(timer);
+  CHECK(!timer.isActive());
+  CHECK_EQ(wheel.msUntilNextDeadline(1000), uint32_t(1000));
+}
+
+HOST_TEST(callbackCanCancelAndRestartTimers) {
+  g_simMs = 0;
+  TimerWheel wheel(simClock);
+  TimerWheel::Timer victim;
+  TimerWheel::Timer restarted;
+  uint32_t victimFired = 0;
+  uint32_t restartedFired = 0;
+  victim.setCallback([&]() { victimFired++; });
+  restarted.setCallback([&]() {
+    if (++restartedFired < 3) wheel.start(restarted, 7);
+  });
+  TimerWheel::Timer canceller([&]() { wheel.cancel(victim); });
+  wheel.start(canceller, 5);
+  wheel.start(victim, 10);
+  wheel.start(restarted, 7);
+
+  for (g_simMs = 1; g_simMs <= 100; ++g_simMs) wheel.advance(g_simMs);
+  CHECK_EQ(victimFired, uint32_t(0));
+  CHECK_EQ(restartedFired, uint32_t(3));
+  CHECK_EQ(wheel.activeCount(), size_t(0));
+}
+
+HOST_TEST(benchmarkThousandsOfTimersAgainstAHeap) {
+  g_simMs = 0;
+  TimerWheel wheel(simClock);
+  std::mt19937 rng(0x5eed);
+  std::uniform_int_distribution<uint32_t> delay(1, kBenchMaxDelayMs);
+  std::uniform_int_distribution<uint32_t> period(50, 20000);
+  std::uniform_int_distribution<uint32_t> kind(0, 4);
+
+  // 1 in 5 timers is periodic; every callback checks it runs exactly on its deadline.
+  std::unique_ptr<BenchTimer[]> timers(new BenchTimer[kBenchTimers]);
+  uint32_t lateOrEarly = 0;
+  uint64_t wheelFired = 0;
+  for (size_t i = 0; i < kBenchTimers; ++i) {
+    BenchTimer& b = timers[i];
+    b.periodMs = kind(rng) == 0 ? period(rng) : 0;
+    b.timer.setCallback([&b, &lateOrEarly, &wheelFired]() {
+      if (g_simMs != b.expectedMs) lateOrEarly++;
+      b.expectedMs += b.periodMs;
+      b.fired++;
+      wheelFired++;
+    });
+  }
+
+  // Reference: the same schedule on a binary min-heap.
+  using Entry = std::pair<uint32_t, size_t>; // (deadline, timer index)
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+  std::vector<uint32_t> heapFired(kBenchTimers, 0);
+
+  Stopwatch startClock;
+  for (size_t i = 0; i < kBenchTimers; ++i) {
+    const uint32_t d = delay(rng);
+    timers[i].expectedMs = d;
+    wheel.start(timers[i].timer, d, timers[i].periodMs);
+  }
+  const double startNs = startClock.elapsedNs();
+  for (size_t i = 0; i < kBenchTimers; ++i) heap.push({ timers[i].expectedMs, i });
+  CHECK_EQ(wheel.activeCount(), kBenchTimers);
+
+  // Tick every millisecond, as a loop that never sleeps would.
+  Stopwatch wheelClock;
+  for (g_simMs = 1; g_simMs <= kBenchDurationMs; ++g_simMs) wheel.advance(g_simMs);
+  const double wheelNs = wheelClock.elapsedNs();
+
+  Stopwatch heapClock;
+  uint64_t heapTotal = 0;
+  for (uint32_t now = 1; now <= kBenchDurationMs; ++now) {
+    while (!heap.empty() && heap.top().first <= now) {
+      const size_t i = heap.top().second;
+      heap.pop();
+      heapFired[i]++;
+      heapTotal++;
+      if (timers[i].periodMs) heap.push({ now + timers[i].periodMs, i });
+    }
+  }
+  const double heapNs = heapClock.elapsedNs();
+
+  CHECK_EQ(lateOrEarly, uint32_t(0));
+  CHECK_EQ(wheelFired, heapTotal);
+  uint32_t mismatches = 0;
+  for (size_t i = 0; i < kBenchTimers; ++i) {
+    if (timers[i].fired != heapFired[i]) mismatches++;
+  }
+  CHECK_EQ(mismatches, uint32_t(0));
+  CHECK(wheelFired > kBenchTimers); // The periodic ones ran many times.
+
+  // Churn: re-arm every timer (the common timeout pattern), then cancel them all.
+  Stopwatch churnClock;
+  for (int round = 0; round < 20; ++round) {
+    for (size_t i = 0; i < kBenchTimers; ++i) wheel.start(timers[i].timer, delay(rng));
+  }
+  for (size_t i = 0; i < kBenchTimers; ++i) wheel.cancel(timers[i].timer);
+  const double churnNs = churnClock.elapsedNs();
+  CHECK_EQ(wheel.activeCount(), size_t(0));
+
+  std::printf("  %zu timers, %u ms simulated, %llu expiries\n", kBenchTimers, (unsigned)kBenchDurationMs,
+              (unsigned long long)wheelFired);
+  std::printf("  start:          %8.1f ns/timer\n", startNs / kBenchTimers);
+  std::printf("  advance (wheel): %7.1f ns/tick\n", wheelNs / kBenchDurationMs);
+  std::printf("  advance (heap):  %7.1f ns/tick\n", heapNs / kBenchDurationMs);
+  std::printf("  re-arm/cancel:  %8.1f ns/op\n", churnNs / (kBenchTimers * 21.0));
+}
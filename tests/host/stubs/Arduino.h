@@ -0,0 +1,90 @@
+/**
+ * @file Arduino.h
+ * @brief Host stand-in for the parts of the Arduino core used by the units under test.
+ *
+ * Time comes from `hostclock`, which tests advance explicitly; `delay()` advances it too.
+ * `Serial` swallows all output.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include "freertos/FreeRTOS.h"
+#include "esp_system.h"
+
+namespace hostclock {
+/**
+ * @brief Returns the simulated time since boot.
+ * @return Microseconds.
+ */
+uint64_t nowUs();
+/**
+ * @brief Advances the simulated time.
+ * @param us Microseconds to advance.
+ */
+void advanceUs(uint64_t us);
+/**
+ * @brief Advances the simulated time.
+ * @param ms Milliseconds to advance.
+ */
+inline void advanceMs(uint32_t ms) { advanceUs(static_cast<uint64_t>(ms) * 1000); }
+/**
+ * @brief Resets the simulated time to boot. Called before every test case.
+ */
+void reset();
+} // namespace hostclock
+
+inline unsigned long millis() { return static_cast<unsigned long>(hostclock::nowUs() / 1000); }
+inline unsigned long micros() { return static_cast<unsigned long>(hostclock::nowUs()); }
+inline void delay(uint32_t ms) { hostclock::advanceMs(ms); }
+inline void yield() {}
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+/**
+ * @brief Serial port stand-in that discards everything.
+ */
+class HostSerial {
+public:
+  explicit operator bool() const { return false; }
+  template <typename... Args> int printf(const char*, Args...) { return 0; }
+  template <typename T> size_t print(const T&) { return 0; }
+  template <typename T> size_t println(const T&) { return 0; }
+  size_t println() { return 0; }
+};
+extern HostSerial Serial;
+
+/**
+ * @brief Chip information stand-in.
+ */
+class HostEspClass {
+public:
+  uint64_t getEfuseMac() const { return 0x0000A1B2C3D4E5F6ULL; }
+};
+extern HostEspClass ESP;
+
+#endif // HOST_ARDUINO_H
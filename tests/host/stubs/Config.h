@@ -0,0 +1,62 @@
+/**
+ * @file Config.h
+ * @brief Host stand-in for the example's Config.h: debug output is compiled out, and only the
+ * tunables the units under test need are defined.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <Arduino.h>
+
+#define DEBUG_ERROR_PRINT(...)
+#define DEBUG_ERROR_PRINTLN(...)
+#define DEBUG_ERROR_PRINTF(...)
+#define DEBUG_WARN_PRINT(...)
+#define DEBUG_WARN_PRINTLN(...)
+#define DEBUG_WARN_PRINTF(...)
+#define DEBUG_INFO_PRINT(...)
+#define DEBUG_INFO_PRINTLN(...)
+#define DEBUG_INFO_PRINTF(...)
+#define DEBUG_TRACE_PRINT(...)
+#define DEBUG_TRACE_PRINTLN(...)
+#define DEBUG_TRACE_PRINTF(...)
+
+// --- Tunables (same values as the example's Config.h) ---
+#define BLE_DEVICE_REGISTRY_CAPACITY 128
+#define BLE_DEVICE_REGISTRY_POOL_BYTES 2048
+#define BLE_DEVICE_REGISTRY_EVICTED_QUEUE 16
+#define BLE_ADVERT_RSSI_EWMA_SHIFT 2
+#define BLE_ADVERT_RSSI_REPORT_DELTA_DBM 4
+#define CO_FRAME_POOL_BLOCKS 16
+#define CO_FRAME_BLOCK_SIZE 384
+#define BATTERY_SOC_FILTER_WEIGHT 0.2f
+#define BATTERY_SOC_LOAD_AVERAGE_MS 1200000
+#define BATTERY_SOC_LEARN_MIN_DROP_PERCENT 2.0f
+#define BATTERY_SOC_LEARN_WEIGHT 0.25f
+#define BATTERY_SOC_FLAT_SLOPE_MV 5.0f
+#define BATTERY_SOC_FLAT_FILTER_WEIGHT 0.001f
+#define BATTERY_SOC_CHARGE_DETECT_PERCENT 3.0f
+#define BATTERY_SOC_CHARGE_DETECT_MV 40.0f
+#define BATTERY_SOC_CHARGE_CV_MARGIN_MV 15.0f
+
+#endif // CONFIG_H
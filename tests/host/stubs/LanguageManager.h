@@ -0,0 +1,35 @@
+/**
+ * @file LanguageManager.h
+ * @brief Host stand-in for the LanguageManager: every lookup returns the default text.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef HOST_LANGUAGE_MANAGER_H
+#define HOST_LANGUAGE_MANAGER_H
+
+#include <string>
+
+class LanguageManager {
+public:
+  std::string getString(const std::string& key, const std::string& defaultValue = "") { return defaultValue; }
+};
+
+#endif // HOST_LANGUAGE_MANAGER_H
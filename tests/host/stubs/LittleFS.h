@@ -0,0 +1,171 @@
+/**
+ * @file LittleFS.h
+ * @brief Host stand-in for LittleFS: an in-memory file system that survives simulated restarts.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef HOST_LITTLEFS_H
+#define HOST_LITTLEFS_H
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace hostfs {
+/**
+ * @brief The file system state, guarded by `mutex`.
+ */
+struct State {
+  std::mutex mutex;                                      ///< Guards the maps (tasks share the file system).
+  std::map<std::string, std::vector<uint8_t>> files;     ///< File contents by path.
+  std::set<std::string> dirs;                            ///< Directories.
+};
+inline State& state() {
+  static State s;
+  return s;
+}
+/**
+ * @brief Removes all files and directories.
+ */
+inline void clear() {
+  std::lock_guard<std::mutex> lock(state().mutex);
+  state().files.clear();
+  state().dirs.clear();
+}
+/**
+ * @brief Returns a copy of the files.
+ * @return Contents by path.
+ */
+inline std::map<std::string, std::vector<uint8_t>> files() {
+  std::lock_guard<std::mutex> lock(state().mutex);
+  return state().files;
+}
+} // namespace hostfs
+
+/**
+ * @brief An open file or directory.
+ */
+class File {
+public:
+  File() = default;
+
+  explicit operator bool() const { return _open; }
+  const char* name() const { return _name.c_str(); }
+  size_t size() const { return _data.size(); }
+
+  size_t write(const uint8_t* data, size_t length) {
+    if (!_open || !_writable) return 0;
+    std::lock_guard<std::mutex> lock(hostfs::state().mutex);
+    std::vector<uint8_t>& file = hostfs::state().files[_path];
+    file.insert(file.end(), data, data + length);
+    return length;
+  }
+
+  size_t read(uint8_t* data, size_t length) {
+    if (!_open || _writable) return 0;
+    const size_t n = std::min(length, _data.size() - _position);
+    memcpy(data, _data.data() + _position, n);
+    _position += n;
+    return n;
+  }
+
+  File openNextFile() {
+    File next;
+    if (!_open || _entry >= _entries.size()) return next;
+    const std::string path = _path + "/" + _entries[_entry++];
+    std::lock_guard<std::mutex> lock(hostfs::state().mutex);
+    auto it = hostfs::state().files.find(path);
+    if (it == hostfs::state().files.end()) return next;
+    next._open = true;
+    next._path = path;
+    next._name = path.substr(path.rfind('/') + 1);
+    next._data = it->second;
+    return next;
+  }
+
+  void close() { _open = false; }
+
+private:
+  friend class HostLittleFS;
+  bool _open = false;
+  bool _writable = false;
+  std::string _path;
+  std::string _name;
+  std::vector<uint8_t> _data;        ///< Contents at open time (read mode).
+  size_t _position = 0;
+  std::vector<std::string> _entries; ///< File names (directory).
+  size_t _entry = 0;
+};
+
+/**
+ * @brief The file system API the units under test use.
+ */
+class HostLittleFS {
+public:
+  bool exists(const char* path) {
+    std::lock_guard<std::mutex> lock(hostfs::state().mutex);
+    return hostfs::state().dirs.count(path) || hostfs::state().files.count(path);
+  }
+
+  bool mkdir(const char* path) {
+    std::lock_guard<std::mutex> lock(hostfs::state().mutex);
+    hostfs::state().dirs.insert(path);
+    return true;
+  }
+
+  bool remove(const char* path) {
+    std::lock_guard<std::mutex> lock(hostfs::state().mutex);
+    return hostfs::state().files.erase(path) > 0;
+  }
+
+  File open(const char* path, const char* mode = "r") {
+    File file;
+    std::lock_guard<std::mutex> lock(hostfs::state().mutex);
+    hostfs::State& fs = hostfs::state();
+    file._path = path;
+    file._name = file._path.substr(file._path.rfind('/') + 1);
+    if (fs.dirs.count(path)) {
+      const std::string prefix = file._path + "/";
+      for (const auto& entry : fs.files) {
+        if (entry.first.compare(0, prefix.size(), prefix) == 0 && entry.first.find('/', prefix.size()) == std::string::npos) {
+          file._entries.push_back(entry.first.substr(prefix.size()));
+        }
+      }
+      file._open = true;
+    } else if (strchr(mode, 'w')) {
+      fs.files[path].clear();
+      file._open = file._writable = true;
+    } else if (fs.files.count(path)) {
+      file._data = fs.files[path];
+      file._open = true;
+    }
+    return file;
+  }
+};
+
+inline HostLittleFS LittleFS;
+
+#endif // HOST_LITTLEFS_H
@@ -0,0 +1,39 @@
+/**
+ * @file MessageBoardElement.h
+ * @brief Host stand-in for the MessageBoardElement: remembers the last text.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef HOST_MESSAGE_BOARD_ELEMENT_H
+#define HOST_MESSAGE_BOARD_ELEMENT_H
+
+#include <cstdint>
+#include <string>
+
+class MessageBoardElement {
+public:
+  void setText(const std::string& message, unsigned long durationMs = 0) { lastText = message; }
+  void pushMessage(const std::string& message, unsigned long durationMs = 0, uint32_t messageColor = 0) { lastText = message; }
+
+  std::string lastText; ///< Host only.
+};
+
+#endif // HOST_MESSAGE_BOARD_ELEMENT_H
@@ -0,0 +1,37 @@
+/**
+ * @file PowerManager.h
+ * @brief Host stand-in for the PowerManager: a battery voltage set by the test.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef HOST_POWER_MANAGER_H
+#define HOST_POWER_MANAGER_H
+
+class PowerManager {
+public:
+  float getCurrentVoltage() const { return _voltage; }
+  void setVoltage(float voltage) { _voltage = voltage; } ///< Host only.
+
+private:
+  float _voltage = 3.9f;
+};
+
+#endif // HOST_POWER_MANAGER_H
@@ -0,0 +1,86 @@
+/**
+ * @file Preferences.h
+ * @brief Host stand-in for the Arduino NVS wrapper. All namespaces share one in-memory store that survives simulated restarts.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+
+namespace hostprefs {
+/**
+ * @brief Returns the store, keyed by "<namespace>/<key>".
+ * @return The store.
+ */
+inline std::map<std::string, std::string>& store() {
+  static std::map<std::string, std::string> values;
+  return values;
+}
+/**
+ * @brief Erases the whole store.
+ */
+inline void clear() { store().clear(); }
+} // namespace hostprefs
+
+/**
+ * @brief Key-value access to one namespace. Strings are returned as std::string (String on the device).
+ */
+class Preferences {
+public:
+  bool begin(const char* name, bool readOnly = false, const char* partitionLabel = nullptr) {
+    _prefix = std::string(name) + "/";
+    _readOnly = readOnly;
+    return true;
+  }
+  void end() { _prefix.clear(); }
+
+  uint32_t getUInt(const char* key, uint32_t defaultValue = 0) {
+    auto it = hostprefs::store().find(_prefix + key);
+    return it == hostprefs::store().end() ? defaultValue : (uint32_t)std::stoul(it->second);
+  }
+  size_t putUInt(const char* key, uint32_t value) { return _put(key, std::to_string(value)) ? 4 : 0; }
+
+  std::string getString(const char* key, const std::string& defaultValue = std::string()) {
+    auto it = hostprefs::store().find(_prefix + key);
+    return it == hostprefs::store().end() ? defaultValue : it->second;
+  }
+  size_t putString(const char* key, const char* value) { return _put(key, value) ? strlen(value) : 0; }
+  size_t putString(const char* key, const std::string& value) { return _put(key, value) ? value.size() : 0; }
+
+  bool remove(const char* key) { return !_readOnly && hostprefs::store().erase(_prefix + key) > 0; }
+
+private:
+  std::string _prefix;
+  bool _readOnly = false;
+
+  bool _put(const char* key, const std::string& value) {
+    if (_readOnly || _prefix.empty()) return false;
+    hostprefs::store()[_prefix + key] = value;
+    return true;
+  }
+};
+
+#endif // HOST_PREFERENCES_H
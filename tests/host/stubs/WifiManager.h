@@ -0,0 +1,54 @@
+/**
+ * @file WifiManager.h
+ * @brief Host stand-in for the WifiManager: only the connection state, set by the test.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef HOST_WIFI_MANAGER_H
+#define HOST_WIFI_MANAGER_H
+
+#include <atomic>
+#include <cstdint>
+
+enum class WifiMgr_State_t {
+  WIFI_MGR_DISABLED,
+  DISCONNECTED,
+  ENABLING,
+  SCANNING,
+  CONNECTING,
+  CONNECTED,
+  CONNECTION_FAILED,
+  DISABLING
+};
+
+class WifiManager {
+public:
+  WifiMgr_State_t getCurrentState() const { return _state; }
+  int8_t getRssi() const { return _rssi; }
+  void setState(WifiMgr_State_t state) { _state = state; } ///< Host only.
+  void setRssi(int8_t rssi) { _rssi = rssi; }             ///< Host only.
+
+private:
+  std::atomic<WifiMgr_State_t> _state{WifiMgr_State_t::DISCONNECTED};
+  int8_t _rssi = -60;
+};
+
+#endif // HOST_WIFI_MANAGER_H
@@ -0,0 +1,85 @@
+/**
+ * @file esp_http_client.h
+ * @brief Host stand-in for the ESP-IDF HTTP client: plain HTTP/1.1 over POSIX sockets, one request per connection (implemented in HostHttpClient.cpp).
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef HOST_ESP_HTTP_CLIENT_H
+#define HOST_ESP_HTTP_CLIENT_H
+
+#include <cstdint>
+#include "esp_err.h"
+
+typedef struct esp_http_client* esp_http_client_handle_t;
+
+typedef enum {
+  HTTP_EVENT_ERROR = 0,
+  HTTP_EVENT_ON_CONNECTED,
+  HTTP_EVENT_HEADERS_SENT,
+  HTTP_EVENT_ON_HEADER,
+  HTTP_EVENT_ON_DATA,
+  HTTP_EVENT_ON_FINISH,
+  HTTP_EVENT_DISCONNECTED
+} esp_http_client_event_id_t;
+
+/**
+ * @brief Event passed to the event handler. Only HTTP_EVENT_ON_HEADER is raised.
+ */
+typedef struct esp_http_client_event {
+  esp_http_client_event_id_t event_id; ///< Event type.
+  esp_http_client_handle_t client;     ///< The client.
+  void* data;                          ///< Unused.
+  int data_len;                        ///< Unused.
+  void* user_data;                     ///< `user_data` of the configuration.
+  char* header_key;                    ///< Header name.
+  char* header_value;                  ///< Header value.
+} esp_http_client_event_t;
+
+typedef esp_err_t (*http_event_handle_cb)(esp_http_client_event_t* event);
+
+/**
+ * @brief The configuration fields the units under test use.
+ */
+typedef struct {
+  const char* url;                          ///< "http://host:port/path".
+  int timeout_ms;                           ///< Connect and receive timeout.
+  int buffer_size;                          ///< Unused.
+  bool keep_alive_enable;                   ///< Unused; every request opens a connection.
+  esp_err_t (*crt_bundle_attach)(void* conf); ///< Unused.
+  http_event_handle_cb event_handler;       ///< Receives the response headers.
+  void* user_data;                          ///< Passed to the event handler.
+} esp_http_client_config_t;
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t* config);
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char* key, const char* value);
+esp_err_t esp_http_client_delete_header(esp_http_client_handle_t client, const char* key);
+/// Connects and sends a GET request with the headers set so far.
+esp_err_t esp_http_client_open(esp_http_client_handle_t client, int writeLength);
+/// Reads the status line and headers. Returns the Content-Length, or -1 on error.
+int64_t esp_http_client_fetch_headers(esp_http_client_handle_t client);
+int esp_http_client_get_status_code(esp_http_client_handle_t client);
+/// Reads body bytes. Returns 0 at the end of the body or when the server closed the connection.
+int esp_http_client_read(esp_http_client_handle_t client, char* buffer, int length);
+bool esp_http_client_is_complete_data_received(esp_http_client_handle_t client);
+esp_err_t esp_http_client_close(esp_http_client_handle_t client);
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client);
+
+#endif // HOST_ESP_HTTP_CLIENT_H
@@ -0,0 +1,66 @@
+/**
+ * @file esp_partition.h
+ * @brief Host stand-in for the partition API over RAM-backed flash (implemented in HostEsp.cpp).
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef HOST_ESP_PARTITION_H
+#define HOST_ESP_PARTITION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "esp_err.h"
+
+/**
+ * @brief A partition.
+ */
+typedef struct {
+  uint32_t address; ///< Flash offset.
+  uint32_t size;    ///< Size in bytes.
+  char label[17];   ///< Partition label.
+} esp_partition_t;
+
+/// Erases whole 4 KB sectors; `offset` and `size` must be sector-aligned.
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size);
+/// Writes erased flash only: fails if a target byte is not 0xFF, as NOR flash cannot set bits.
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t offset, const void* src, size_t size);
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t offset, void* dst, size_t size);
+
+namespace hostflash {
+/**
+ * @brief Returns the contents of a partition.
+ * @param partition The partition.
+ * @return Its bytes (0xFF where erased).
+ */
+const std::vector<uint8_t>& contents(const esp_partition_t* partition);
+/**
+ * @brief Returns the size of every erase since the last `reset()`.
+ * @return Erase sizes in call order.
+ */
+const std::vector<size_t>& eraseLog();
+/**
+ * @brief Fills the flash with 0x00 (unerased) and clears the erase log.
+ */
+void reset();
+} // namespace hostflash
+
+#endif // HOST_ESP_PARTITION_H
@@ -0,0 +1,38 @@
+/**
+ * @file esp_system.h
+ * @brief Host stand-in for the system API.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef HOST_ESP_SYSTEM_H
+#define HOST_ESP_SYSTEM_H
+
+/**
+ * @brief Aborts the test executable; no test is expected to restart the device.
+ */
+[[noreturn]] void esp_restart();
+
+#include <cstdint>
+
+inline uint32_t esp_get_free_heap_size() { return 200 * 1024; }
+inline uint32_t esp_get_minimum_free_heap_size() { return 150 * 1024; }
+
+#endif // HOST_ESP_SYSTEM_H
@@ -0,0 +1,79 @@
+/**
+ * @file FreeRTOS.h
+ * @brief Host stand-in for the FreeRTOS types and spinlocks used by the units under test.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <atomic>
+#include <cstdint>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS pdTRUE
+#define portMAX_DELAY 0xFFFFFFFFu
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+/**
+ * @brief Spinlock stand-in. Recursive per thread like the ESP32 spinlock, so critical sections
+ * also exclude the task threads some tests run (see `freertos/task.h`).
+ */
+typedef struct { int depth; int owner; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED { 0, 0 }
+
+/**
+ * @brief Returns a non-zero token unique to the calling thread.
+ */
+inline int hostThreadToken() {
+  static std::atomic<int> next{1};
+  thread_local int token = next++;
+  return token;
+}
+
+inline void hostEnterCritical(portMUX_TYPE* mux) {
+  const int self = hostThreadToken();
+  if (__atomic_load_n(&mux->owner, __ATOMIC_ACQUIRE) != self) {
+    int expected = 0;
+    while (!__atomic_compare_exchange_n(&mux->owner, &expected, self, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+      expected = 0;
+    }
+  }
+  mux->depth++;
+}
+
+inline void hostExitCritical(portMUX_TYPE* mux) {
+  if (--mux->depth == 0) __atomic_store_n(&mux->owner, 0, __ATOMIC_RELEASE);
+}
+
+#define taskENTER_CRITICAL(mux) hostEnterCritical(mux)
+#define taskEXIT_CRITICAL(mux) hostExitCritical(mux)
+#define portENTER_CRITICAL(mux) hostEnterCritical(mux)
+#define portEXIT_CRITICAL(mux) hostExitCritical(mux)
+
+#endif // HOST_FREERTOS_H
@@ -0,0 +1,53 @@
+/**
+ * @file freertos/task.h
+ * @brief Host stand-in for the FreeRTOS task API. By default a task runs to completion inside `xTaskCreatePinnedToCore()`, so a test observes its result when the call returns; tests of long-running tasks switch to one thread per task.
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include <Arduino.h>
+
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+namespace hosttask {
+/**
+ * @brief Selects how tasks created from now on run.
+ * @param threaded True: on their own thread, where `vTaskDelay()` sleeps 1 ms of real time and
+ * leaves the simulated clock to the test. False (default): to completion on the calling thread.
+ */
+void setThreaded(bool threaded);
+/**
+ * @brief Checks whether the caller runs on a task thread.
+ * @return True on a thread started by `xTaskCreatePinnedToCore()`.
+ */
+bool onTaskThread();
+} // namespace hosttask
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* arg,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core);
+inline void vTaskDelete(TaskHandle_t) {}
+/// On the test thread: advances the simulated clock (and yields 1 ms to task threads if any).
+void vTaskDelay(TickType_t ticks);
+
+#endif // HOST_FREERTOS_TASK_H
@@ -0,0 +1,88 @@
+/**
+ * @file mqtt_client.h
+ * @brief Host stand-in for the ESP-IDF MQTT client: MQTT 3.1.1 over POSIX sockets with its own network thread, QoS 0/1 publish only (implemented in HostMqttClient.cpp).
+ *
+ * @version 1.0.0
+ * @date 2025-09-09
+ * @author György Oberländer
+ * @contact support@wobys.com
+ *
+ * @copyright (c) 2025 György Oberländer. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+#ifndef HOST_MQTT_CLIENT_H
+#define HOST_MQTT_CLIENT_H
+
+#include <cstdint>
+#include "esp_err.h"
+
+typedef const char* esp_event_base_t;
+typedef void (*esp_event_handler_t)(void* handlerArgs, esp_event_base_t base, int32_t eventId, void* eventData);
+
+typedef struct esp_mqtt_client* esp_mqtt_client_handle_t;
+
+typedef enum {
+  MQTT_EVENT_ANY = -1,
+  MQTT_EVENT_ERROR = 0,
+  MQTT_EVENT_CONNECTED,
+  MQTT_EVENT_DISCONNECTED,
+  MQTT_EVENT_SUBSCRIBED,
+  MQTT_EVENT_UNSUBSCRIBED,
+  MQTT_EVENT_PUBLISHED,
+  MQTT_EVENT_DATA,
+  MQTT_EVENT_BEFORE_CONNECT,
+  MQTT_EVENT_DELETED
+} esp_mqtt_event_id_t;
+
+/**
+ * @brief Event passed to the handler.
+ */
+typedef struct {
+  esp_mqtt_event_id_t event_id;    ///< Event type.
+  esp_mqtt_client_handle_t client; ///< The client.
+  int msg_id;                      ///< Acknowledged message id (MQTT_EVENT_PUBLISHED).
+} esp_mqtt_event_t;
+typedef esp_mqtt_event_t* esp_mqtt_event_handle_t;
+
+/**
+ * @brief The configuration fields the units under test use.
+ */
+typedef struct {
+  struct {
+    struct {
+      const char* uri; ///< "mqtt://host:port".
+    } address;
+  } broker;
+  struct {
+    const char* username;
+    const char* client_id;
+    struct {
+      const char* password;
+    } authentication;
+  } credentials;
+} esp_mqtt_client_config_t;
+
+esp_mqtt_client_handle_t esp_mqtt_client_init(const esp_mqtt_client_config_t* config);
+esp_err_t esp_mqtt_client_register_event(esp_mqtt_client_handle_t client, esp_mqtt_event_id_t event,
+                                         esp_event_handler_t handler, void* handlerArgs);
+/// Starts the network thread; it connects, and reconnects every 100 ms after a disconnect.
+esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t client);
+/// Returns the message id, or -1 while disconnected.
+int esp_mqtt_client_publish(esp_mqtt_client_handle_t client, const char* topic, const char* data, int length,
+                            int qos, int retain);
+esp_err_t esp_mqtt_client_stop(esp_mqtt_client_handle_t client);
+esp_err_t esp_mqtt_client_destroy(esp_mqtt_client_handle_t client);
+
+#endif // HOST_MQTT_CLIENT_H
@@ -0,0 +1,191 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 György Oberländer. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""Generates the battery traces the BatterySocEstimator host test replays.
+
+The traces are synthetic: a Li-ion cell model sampled the way PowerManager samples the battery
+(every BATTERY_CHECK_INTERVAL_MS), with the subsystem states the load state provider reports.
+The model deliberately differs from the firmware's battery model in ConfigHardwareUser.h, so the
+test sees the errors the estimator has to absorb on a real device:
+
+  * the open-circuit voltage curve is offset from BATT_OCV_TABLE by up to 15 mV,
+  * the usable capacity is 1750 mAh against the rated 2000 mAh,
+  * the ohmic resistance is 0.17 Ohm against 0.20, plus a 30 mOhm / 60 s polarisation,
+  * the real load currents differ from the load model by a constant factor (per trace),
+    with per-sample jitter, and
+  * the charger delivers 480 mA against the configured 500 mA. It supplies the load first
+    (power path), holds 4.20 V and ends the charge when the cell current falls to 50 mA.
+
+The voltage column includes 4 mV (rms) of ADC noise. The reference state of charge is counted
+in the model, 0 % at the open-circuit voltage the firmware table maps to 0 %.
+
+    python3 tools/battery_traces.py [--out tests/host/data/battery]
+
+Columns: time_s, voltage_mv, backlight, wifi, bluetooth, audio, charger, load_ma, soc_percent.
+`charger` is 1 while the charger is connected, also after it has ended the charge; `load_ma` is
+the real current of the device (what the load model estimates).
+Standard library only.
+"""
+
+import argparse
+import math
+import os
+import random
+
+SAMPLE_S = 5
+CAPACITY_MAH = 1750.0
+R_OHMIC = 0.17
+R_POLARISATION = 0.03
+TAU_POLARISATION_S = 60.0
+CHARGE_MA = 480.0
+CHARGE_MV = 4200.0
+TERMINATION_MA = 50.0
+NOISE_MV = 4.0
+SHUTDOWN_MV = 3300.0
+
+# {percent: mV}, the "real" cell.
+OCV_CURVE = [
+    (100, 4190), (92, 4108), (85, 4036), (78, 3978), (71, 3921), (63, 3869),
+    (54, 3826), (46, 3794), (38, 3772), (30, 3754), (22, 3725), (15, 3684),
+    (9, 3632), (5, 3562), (2, 3446), (0, 3300),
+]
+
+# The firmware's load model (ConfigHardwareUser.h), scaled per trace to the "real" load.
+LOAD_BASE_MA, LOAD_BACKLIGHT_MA, LOAD_WIFI_MA, LOAD_BT_MA, LOAD_AUDIO_MA = 85.0, 110.0, 70.0, 20.0, 30.0
+
+
+def ocv_mv(soc):
+    soc = min(max(soc, 0.0), 100.0)
+    for (p_hi, v_hi), (p_lo, v_lo) in zip(OCV_CURVE, OCV_CURVE[1:]):
+        if soc >= p_lo:
+            return v_lo + (soc - p_lo) / (p_hi - p_lo) * (v_hi - v_lo)
+    return OCV_CURVE[-1][1]
+
+
+def model_load_ma(state):
+    backlight, wifi, bt, audio = state
+    return (LOAD_BASE_MA + LOAD_BACKLIGHT_MA * backlight / 255.0 + LOAD_WIFI_MA * wifi
+            + LOAD_BT_MA * bt + LOAD_AUDIO_MA * audio)
+
+
+class UsagePattern:
+    """Alternates active sessions and screensaver periods, and toggles the radios."""
+
+    def __init__(self, rng, wifi_share, bt_share, always_radios=False):
+        self.rng = rng
+        self.wifi_share, self.bt_share, self.always_radios = wifi_share, bt_share, always_radios
+        self.backlight, self.audio, self.wifi, self.bt = 255, 0, 1, 0
+        self.session_left = self.wifi_left = self.bt_left = 0
+
+    def step(self):
+        rng = self.rng
+        if self.session_left <= 0:
+            if self.backlight >= 128:  # Active -> screensaver (dimmed or dark).
+                self.backlight, self.audio = rng.choice((0, 25)), 0
+                self.session_left = rng.randint(5, 30) * 60
+            else:
+                self.backlight = rng.randint(150, 255)
+                self.audio = 1 if rng.random() < 0.2 else 0
+                self.session_left = rng.randint(3, 15) * 60
+        if self.wifi_left <= 0:
+            self.wifi = 1 if self.always_radios or rng.random() < self.wifi_share else 0
+            self.wifi_left = rng.randint(10, 40) * 60
+        if self.bt_left <= 0:
+            self.bt = 1 if self.always_radios or rng.random() < self.bt_share else 0
+            self.bt_left = rng.randint(5, 60) * 60
+        self.session_left -= SAMPLE_S
+        self.wifi_left -= SAMPLE_S
+        self.bt_left -= SAMPLE_S
+        return (self.backlight, self.wifi, self.bt, self.audio)
+
+
+class Cell:
+    def __init__(self, soc):
+        self.soc = soc
+        self.v_pol = 0.0
+
+    def step(self, cell_ma):
+        """Applies a cell current (positive charges) for one sample and returns the terminal mV."""
+        self.soc = min(self.soc + cell_ma * SAMPLE_S / 3600.0 / CAPACITY_MAH * 100.0, 100.0)
+        target = cell_ma * R_POLARISATION
+        self.v_pol += (target - self.v_pol) * (1.0 - math.exp(-SAMPLE_S / TAU_POLARISATION_S))
+        return ocv_mv(self.soc) + self.v_pol + cell_ma * R_OHMIC
+
+
+def simulate(rng, pattern, load_factor, cell, segments):
+    """segments: list of (plugged, duration_s or None for "until shutdown")."""
+    rows, t = [], 0
+    for plugged, duration in segments:
+        end = t + duration if duration is not None else None
+        terminated = False
+        while end is None or t < end:
+            state = pattern.step()
+            load = max(model_load_ma(state) * load_factor + rng.gauss(0.0, 8.0), 20.0)
+            charging = plugged and not terminated
+            if charging:
+                cell_ma = CHARGE_MA - load
+                # Constant voltage: the current that holds the terminal at the charge voltage.
+                headroom = CHARGE_MV - ocv_mv(cell.soc) - cell.v_pol
+                cell_ma = min(cell_ma, headroom / R_OHMIC)
+                if cell_ma < TERMINATION_MA:
+                    terminated, charging = True, False
+            if plugged and not charging:
+                cell_ma = 0.0  # Ended: the charger still supplies the load.
+            elif not plugged:
+                cell_ma = -load
+            mv = cell.step(cell_ma) + rng.gauss(0.0, NOISE_MV)
+            rows.append((t, round(mv), *state, int(plugged), round(load), round(cell.soc, 2)))
+            t += SAMPLE_S
+            if not plugged and mv < SHUTDOWN_MV:
+                return rows
+    return rows
+
+
+def write(path, title, rows):
+    with open(path, "w") as f:
+        f.write(f"# {title}\n# Synthetic, generated by tools/battery_traces.py; see its docstring for the model.\n")
+        f.write("time_s,voltage_mv,backlight,wifi,bluetooth,audio,charger,load_ma,soc_percent\n")
+        for row in rows:
+            f.write(",".join(str(v) for v in row) + "\n")
+
+
+def main(argv=None):
+    here = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--out", default=os.path.join(here, "..", "tests", "host", "data", "battery"))
+    args = parser.parse_args(argv)
+    os.makedirs(args.out, exist_ok=True)
+
+    rng = random.Random(72001)
+    rows = simulate(rng, UsagePattern(rng, 0.6, 0.3), 1.2, Cell(100.0), [(False, None)])
+    write(os.path.join(args.out, "discharge_mixed.csv"),
+          "Full discharge, screensaver cycles and toggling radios, real load 20 % above the load model.", rows)
+
+    rng = random.Random(72002)
+    rows = simulate(rng, UsagePattern(rng, 1.0, 1.0, always_radios=True), 0.85, Cell(100.0), [(False, None)])
+    write(os.path.join(args.out, "discharge_radios.csv"),
+          "Full discharge, both radios always on, real load 15 % below the load model.", rows)
+
+    rng = random.Random(72003)
+    segments = [(False, 20 * 60), (True, 10 * 60), (False, 30 * 60), (True, 5 * 3600), (False, 60 * 60)]
+    rows = simulate(rng, UsagePattern(rng, 0.6, 0.3), 1.2, Cell(45.0), segments)
+    write(os.path.join(args.out, "charge_cycle.csv"),
+          "From 45 %: 10 min top-up unplugged in constant current, then a full charge left plugged "
+          "after it ended, then 1 h discharge.", rows)
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
@@ -0,0 +1,295 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 György Oberländer. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""Desktop client for the WobysGUI remote UI mirror (RemoteUiMirror).
+
+Connects to ws://<host>:<port>/mirror?token=<token>, applies the frames to a local
+framebuffer, acknowledges every applied frame and forwards mouse input as touch events.
+The wire format is described in examples/WobysGUI/MirrorCodec.h. Standard library only.
+
+    python3 tools/remote_ui_client.py 192.168.1.50 --token secret
+
+--headless runs without a window until the device closes the connection and can write the
+final framebuffer (--raw-out: RGB565 big-endian, --ppm-out: binary PPM); --touch X,Y sends one
+tap after the first frame. The host loopback test uses both.
+"""
+
+import argparse
+import base64
+import hashlib
+import os
+import socket
+import struct
+import sys
+import threading
+
+WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+OP_TEXT, OP_BINARY, OP_CLOSE, OP_PING, OP_PONG = 0x1, 0x2, 0x8, 0x9, 0xA
+FLAG_KEYFRAME = 0x01
+
+
+class WebSocket:
+    """Minimal RFC 6455 client: binary messages, ping/pong and close."""
+
+    def __init__(self, host, port, path, timeout=10.0):
+        self.sock = socket.create_connection((host, port), timeout=timeout)
+        self.sock.settimeout(None)
+        self._send_lock = threading.Lock()
+        key = base64.b64encode(os.urandom(16)).decode()
+        request = (f"GET {path} HTTP/1.1\r\nHost: {host}:{port}\r\nUpgrade: websocket\r\n"
+                   f"Connection: Upgrade\r\nSec-WebSocket-Key: {key}\r\nSec-WebSocket-Version: 13\r\n\r\n")
+        self.sock.sendall(request.encode())
+        response = b""
+        while b"\r\n\r\n" not in response:
+            chunk = self.sock.recv(1024)
+            if not chunk:
+                raise ConnectionError("connection closed during the handshake (wrong token?)")
+            response += chunk
+        head, self._pending = response.split(b"\r\n\r\n", 1)
+        lines = head.decode(errors="replace").split("\r\n")
+        if " 101 " not in lines[0] + " ":
+            raise ConnectionError(f"handshake rejected: {lines[0]}")
+        headers = {k.strip().lower(): v.strip() for k, _, v in (l.partition(":") for l in lines[1:])}
+        expected = base64.b64encode(hashlib.sha1((key + WS_GUID).encode()).digest()).decode()
+        if headers.get("sec-websocket-accept") != expected:
+            raise ConnectionError("invalid Sec-WebSocket-Accept")
+
+    def _read_exact(self, n):
+        while len(self._pending) < n:
+            chunk = self.sock.recv(max(65536, n - len(self._pending)))
+            if not chunk:
+                raise ConnectionError("connection closed")
+            self._pending += chunk
+        data, self._pending = self._pending[:n], self._pending[n:]
+        return data
+
+    def send(self, payload, opcode=OP_BINARY):
+        mask = os.urandom(4)
+        length = len(payload)
+        if length < 126:
+            header = struct.pack("!BB", 0x80 | opcode, 0x80 | length)
+        elif length < 65536:
+            header = struct.pack("!BBH", 0x80 | opcode, 0x80 | 126, length)
+        else:
+            header = struct.pack("!BBQ", 0x80 | opcode, 0x80 | 127, length)
+        masked = bytes(b ^ mask[i & 3] for i, b in enumerate(payload))
+        with self._send_lock:
+            self.sock.sendall(header + mask + masked)
+
+    def recv(self):
+        """Returns the next binary message, or None once the peer closed the connection."""
+        message = b""
+        while True:
+            b0, b1 = self._read_exact(2)
+            opcode, length = b0 & 0x0F, b1 & 0x7F
+            if length == 126:
+                length = struct.unpack("!H", self._read_exact(2))[0]
+            elif length == 127:
+                length = struct.unpack("!Q", self._read_exact(8))[0]
+            mask = self._read_exact(4) if b1 & 0x80 else None
+            payload = self._read_exact(length)
+            if mask:
+                payload = bytes(b ^ mask[i & 3] for i, b in enumerate(payload))
+            if opcode == OP_CLOSE:
+                try:
+                    self.send(payload[:2], OP_CLOSE)
+                except OSError:
+                    pass
+                return None
+            if opcode == OP_PING:
+                self.send(payload, OP_PONG)
+                continue
+            if opcode in (OP_PONG, OP_TEXT):
+                continue
+            message += payload
+            if b0 & 0x80:
+                return message
+
+    def close(self):
+        try:
+            self.sock.close()
+        except OSError:
+            pass
+
+
+class MirrorDecoder:
+    """Applies frames to an RGB565 (big-endian) framebuffer."""
+
+    def __init__(self):
+        self.width = 0
+        self.height = 0
+        self.pixels = bytearray()
+
+    def apply(self, frame):
+        """Applies one frame and returns its sequence number."""
+        if len(frame) < 14 or frame[0:2] != b"WM" or frame[2] != 1:
+            raise ValueError("not a mirror frame")
+        flags = frame[3]
+        width, height, seq, rects = struct.unpack_from("<HHIH", frame, 4)
+        if (width, height) != (self.width, self.height) or flags & FLAG_KEYFRAME:
+            self.width, self.height = width, height
+            self.pixels = bytearray(width * height * 2)
+        pos = 14
+        for _ in range(rects):
+            x, y, w, h = struct.unpack_from("<HHBB", frame, pos)
+            pos += 6
+            if x + w > width or y + h > height:
+                raise ValueError("rectangle outside the framebuffer")
+            k, n = 0, w * h
+            while k < n:
+                op = frame[pos]
+                pos += 1
+                count = (op & 0x3F) + 1
+                if op & 0x80:  # Unchanged pixels.
+                    k += count
+                    continue
+                if op & 0x40:  # Literal pixels.
+                    data = frame[pos:pos + count * 2]
+                    pos += count * 2
+                else:  # Run of one pixel.
+                    data = frame[pos:pos + 2] * count
+                    pos += 2
+                for i in range(count):
+                    px = x + (k + i) % w
+                    py = y + (k + i) // w
+                    offset = (py * width + px) * 2
+                    self.pixels[offset:offset + 2] = data[i * 2:i * 2 + 2]
+                k += count
+        if pos != len(frame):
+            raise ValueError("trailing bytes in frame")
+        return seq
+
+    def to_ppm(self):
+        rgb = bytearray(self.width * self.height * 3)
+        for i in range(self.width * self.height):
+            v = (self.pixels[i * 2] << 8) | self.pixels[i * 2 + 1]
+            rgb[i * 3] = ((v >> 11) & 0x1F) * 255 // 31
+            rgb[i * 3 + 1] = ((v >> 5) & 0x3F) * 255 // 63
+            rgb[i * 3 + 2] = (v & 0x1F) * 255 // 31
+        return b"P6\n%d %d\n255\n" % (self.width, self.height) + bytes(rgb)
+
+
+def touch_message(x, y, pressed):
+    return struct.pack("<BBhh", ord("T"), 1 if pressed else 0, x, y)
+
+
+def ack_message(seq):
+    return struct.pack("<BI", ord("A"), seq)
+
+
+def run_headless(ws, args):
+    decoder = MirrorDecoder()
+    frames = 0
+    while True:
+        frame = ws.recv()
+        if frame is None:
+            break
+        seq = decoder.apply(frame)
+        ws.send(ack_message(seq))
+        frames += 1
+        if frames == 1 and args.touch:
+            x, y = (int(v) for v in args.touch.split(","))
+            ws.send(touch_message(x, y, True))
+            ws.send(touch_message(x, y, False))
+    if args.raw_out:
+        with open(args.raw_out, "wb") as f:
+            f.write(struct.pack("<HH", decoder.width, decoder.height) + bytes(decoder.pixels))
+    if args.ppm_out:
+        with open(args.ppm_out, "wb") as f:
+            f.write(decoder.to_ppm())
+    print(f"remote_ui_client: {frames} frames, {decoder.width}x{decoder.height}")
+    return 0
+
+
+def run_window(ws, args):
+    import tkinter as tk
+
+    decoder = MirrorDecoder()
+    lock = threading.Lock()
+    state = {"dirty": False, "closed": False}
+
+    def receive():
+        while True:
+            try:
+                frame = ws.recv()
+            except (OSError, ConnectionError):
+                frame = None
+            if frame is None:
+                state["closed"] = True
+                return
+            with lock:
+                seq = decoder.apply(frame)
+                state["dirty"] = True
+            ws.send(ack_message(seq))
+
+    root = tk.Tk()
+    root.title(f"WobysGUI {args.host}")
+    image = tk.PhotoImage(width=1, height=1)
+    label = tk.Label(root, image=image, borderwidth=0)
+    label.pack()
+
+    def refresh():
+        nonlocal image
+        with lock:
+            if state["dirty"]:
+                state["dirty"] = False
+                image = tk.PhotoImage(data=decoder.to_ppm(), format="PPM")
+                label.configure(image=image)
+        if state["closed"]:
+            root.title(f"WobysGUI {args.host} (disconnected)")
+        else:
+            root.after(15, refresh)
+
+    def send_touch(event, pressed):
+        try:
+            ws.send(touch_message(event.x, event.y, pressed))
+        except OSError:
+            pass
+
+    label.bind("<ButtonPress-1>", lambda e: send_touch(e, True))
+    label.bind("<B1-Motion>", lambda e: send_touch(e, True))
+    label.bind("<ButtonRelease-1>", lambda e: send_touch(e, False))
+    root.bind("<F5>", lambda e: ws.send(b"K"))
+
+    threading.Thread(target=receive, daemon=True).start()
+    refresh()
+    root.mainloop()
+    return 0
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("host")
+    parser.add_argument("--port", type=int, default=8081)
+    parser.add_argument("--token", required=True)
+    parser.add_argument("--headless", action="store_true", help="run without a window until the device disconnects")
+    parser.add_argument("--touch", help="headless: tap X,Y after the first frame")
+    parser.add_argument("--raw-out", help="headless: write the final framebuffer (u16 width, u16 height, RGB565 BE)")
+    parser.add_argument("--ppm-out", help="headless: write the final framebuffer as PPM")
+    args = parser.parse_args(argv)
+
+    try:
+        ws = WebSocket(args.host, args.port, f"/mirror?token={args.token}")
+    except (OSError, ConnectionError) as e:
+        print(f"remote_ui_client: {e}", file=sys.stderr)
+        return 1
+    try:
+        return run_headless(ws, args) if args.headless else run_window(ws, args)
+    finally:
+        ws.close()
+
+
+if __name__ == "__main__":
+    sys.exit(main())